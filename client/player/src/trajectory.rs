@@ -35,7 +35,7 @@ use veldera_geo::{
     coords::RadialFrame,
     floating_origin::{FloatingOriginCamera, WorldPosition},
 };
-use veldera_physics::{GameLayer, PhysicsConfig};
+use veldera_physics::{BatchedCast, GameLayer, PhysicsConfig, cast_shapes_batched};
 
 use crate::{
     FpsController, LogicalPlayer,
@@ -230,7 +230,8 @@ impl FromWorld for LeapArcViz {
 
 /// While the player is charging a leap, simulate its trajectory and rebuild the
 /// arc mesh to match; otherwise hide it. Runs every frame so the arc tracks the
-/// growing charge and the live aim.
+/// growing charge and the live aim, but re-simulates only when the launch
+/// changed — a held full charge with a steady aim reuses the last path.
 #[allow(clippy::too_many_arguments)]
 fn update_leap_arc(
     config: Res<LeapArcConfig>,
@@ -240,6 +241,7 @@ fn update_leap_arc(
     yeet_state: Res<YeetState>,
     time: Res<Time>,
     move_and_slide: MoveAndSlide,
+    spatial_query: SpatialQuery,
     viz: Res<LeapArcViz>,
     camera_query: Query<&FloatingOriginCamera>,
     player_query: Query<
@@ -256,6 +258,7 @@ fn update_leap_arc(
     mut viz_query: Query<(&mut Visibility, &mut WorldPosition), Without<LogicalPlayer>>,
     mut flow_offset: Local<f32>,
     mut log_timer: Local<f32>,
+    mut last_path: Local<Option<(LeapLaunch, LeapPath)>>,
 ) {
     let Ok((mut visibility, mut anchor)) = viz_query.get_mut(viz.entity) else {
         return;
@@ -271,6 +274,7 @@ fn update_leap_arc(
     };
     if !charging {
         *visibility = Visibility::Hidden;
+        *last_path = None;
         return;
     }
 
@@ -290,48 +294,85 @@ fn update_leap_arc(
         max_range_m: config.max_range_m,
     };
 
-    // The collide-and-slide step: Avian's `MoveAndSlide`, the same primitive and
-    // contact classification `fps_controller_slide` uses, so the predicted path
-    // resolves collisions exactly like the real leap (slides off walls and all),
-    // restricted to the same ground/vehicle layers and excluding the player.
-    let filter = SpatialQueryFilter::from_excluded_entities([player_entity])
-        .with_mask([GameLayer::Ground, GameLayer::Vehicle]);
-    let slide_config = MoveAndSlideConfig::default();
-    let traction_cutoff = fps_config.traction_normal_cutoff;
-    let step = |position: Vec3, velocity: Vec3, dt: Duration, up: Vec3| {
-        let mut ground_hit = false;
-        let mut wall_normal = None;
-        let output = move_and_slide.move_and_slide(
-            collider,
-            position,
-            Quat::IDENTITY,
-            velocity,
-            dt,
-            &slide_config,
-            &filter,
-            |hit| {
-                if hit.normal.dot(up) > traction_cutoff {
-                    ground_hit = true;
-                } else if wall_normal.is_none() {
-                    wall_normal = Some(Vec3::from(*hit.normal));
-                }
-                MoveAndSlideHitResponse::Accept
-            },
+    let launch = LeapLaunch {
+        start: world_pos.position,
+        velocity: velocity.0 + impulse,
+        params,
+    };
+    if last_path.as_ref().is_none_or(|(last, _)| *last != launch) {
+        // The collide-and-slide step: Avian's `MoveAndSlide`, the same
+        // primitive and contact classification `fps_controller_slide` uses, so
+        // the predicted path resolves collisions exactly like the real leap
+        // (slides off walls and all), restricted to the same ground/vehicle
+        // layers and excluding the player.
+        let filter = SpatialQueryFilter::from_excluded_entities([player_entity])
+            .with_mask([GameLayer::Ground, GameLayer::Vehicle]);
+        let slide_config = MoveAndSlideConfig::default();
+        let traction_cutoff = fps_config.traction_normal_cutoff;
+        let step = |position: Vec3, velocity: Vec3, dt: Duration, up: Vec3| {
+            let mut contact = false;
+            let mut ground_hit = false;
+            let mut wall_normal = None;
+            let output = move_and_slide.move_and_slide(
+                collider,
+                position,
+                Quat::IDENTITY,
+                velocity,
+                dt,
+                &slide_config,
+                &filter,
+                |hit| {
+                    contact = true;
+                    if hit.normal.dot(up) > traction_cutoff {
+                        ground_hit = true;
+                    } else if wall_normal.is_none() {
+                        wall_normal = Some(Vec3::from(*hit.normal));
+                    }
+                    MoveAndSlideHitResponse::Accept
+                },
+            );
+            SlideStep {
+                position: output.position,
+                velocity: output.projected_velocity,
+                contact,
+                ground_hit,
+                wall_normal,
+            }
+        };
+        // Free-flight stretches sweep the player's own collider along every
+        // segment as one batch; the first segment that comes within the
+        // margin of anything hands back to the slide steps.
+        let first_contact = |segments: &[FlightSegment]| {
+            let casts: Vec<BatchedCast> = segments
+                .iter()
+                .map(|segment| {
+                    let delta = segment.to - segment.from;
+                    BatchedCast {
+                        shape: collider,
+                        origin: segment.from,
+                        rotation: Quat::IDENTITY,
+                        direction: Dir3::new(delta).unwrap_or(Dir3::NEG_Y),
+                        max_distance: delta.length() + FREE_FLIGHT_SWEEP_MARGIN_M,
+                    }
+                })
+                .collect();
+            cast_shapes_batched(&spatial_query, &casts, &filter)
+                .iter()
+                .position(Option::is_some)
+        };
+        let path = simulate_leap(
+            launch.start,
+            launch.velocity,
+            &launch.params,
+            camera.position,
+            step,
+            first_contact,
         );
-        SlideStep {
-            position: output.position,
-            velocity: output.projected_velocity,
-            ground_hit,
-            wall_normal,
-        }
+        *last_path = Some((launch, path));
+    }
+    let Some((_, path)) = last_path.as_ref() else {
+        return;
     };
-    let path = simulate_leap(
-        world_pos.position,
-        velocity.0 + impulse,
-        &params,
-        camera.position,
-        step,
-    );
 
     if path.points.len() < 2 {
         *visibility = Visibility::Hidden;
@@ -381,6 +422,7 @@ fn update_leap_arc(
 // ============================================================================
 
 /// Inputs to [`simulate_leap`], gathered from the live configs once per frame.
+#[derive(Clone, Copy, PartialEq)]
 struct LeapSimParams {
     gravity: f32,
     drag_quadratic: f32,
@@ -390,6 +432,34 @@ struct LeapSimParams {
     max_range_m: f32,
 }
 
+/// Everything a simulated path depends on; an unchanged launch reuses the last
+/// path rather than re-simulating it.
+#[derive(PartialEq)]
+struct LeapLaunch {
+    start: DVec3,
+    velocity: Vec3,
+    params: LeapSimParams,
+}
+
+/// Free-flight steps [`simulate_leap`] integrates ahead and sweeps as one
+/// batch.
+const FREE_FLIGHT_BATCH: usize = 64;
+
+/// Contact-free slide steps after which [`simulate_leap`] goes back to batched
+/// free flight. More than one, so a path grazing a surface does not alternate
+/// between a wasted batch and a single slide step.
+const FREE_STEPS_BEFORE_BATCH: usize = 2;
+
+/// Slack (m) added to each free-flight sweep, so a segment that passes within
+/// the slide's skin of a surface counts as a contact and is re-run as a slide.
+const FREE_FLIGHT_SWEEP_MARGIN_M: f32 = 0.1;
+
+/// One free-flight step of the leap, camera-relative, for a batched sweep.
+struct FlightSegment {
+    from: Vec3,
+    to: Vec3,
+}
+
 /// One collide-and-slide step's outcome — the shared shape of a `MoveAndSlide`
 /// move, classified into a walkable landing or a wall to slide off.
 struct SlideStep {
@@ -397,6 +467,8 @@ struct SlideStep {
     position: Vec3,
     /// Velocity with the into-surface components removed.
     velocity: Vec3,
+    /// The move touched anything at all.
+    contact: bool,
     /// A contact was walkable (`normal·up` above the traction cutoff).
     ground_hit: bool,
     /// A non-walkable contact normal, when the move grazed a wall without also
@@ -433,6 +505,13 @@ struct LeapPath {
 /// contact. Local up is recomputed each step so the arc curves around the globe
 /// (radial gravity).
 ///
+/// Once a few slide steps in a row touch nothing, the leap is in free flight,
+/// where a slide is just `position + velocity·dt`: the next stretch is
+/// integrated ahead without collision, and `first_contact` sweeps all of its
+/// segments at once, returning the first that touches anything. The path
+/// takes the clear prefix and resumes sliding from there, so the batched
+/// stretch lands exactly where the step-by-step slide would have.
+///
 /// The one thing it can't know is future air-control input, so it previews the
 /// un-steered leap.
 fn simulate_leap(
@@ -441,6 +520,7 @@ fn simulate_leap(
     params: &LeapSimParams,
     camera_ecef: DVec3,
     mut step: impl FnMut(Vec3, Vec3, Duration, Vec3) -> SlideStep,
+    mut first_contact: impl FnMut(&[FlightSegment]) -> Option<usize>,
 ) -> LeapPath {
     let dt = Duration::from_secs_f32(params.step_dt_s);
     let start_up = start.normalize_or_zero().as_vec3();
@@ -453,8 +533,47 @@ fn simulate_leap(
     // The last slide surface, so a sustained slide along one wall logs a single
     // marker rather than one per step.
     let mut last_normal: Option<Vec3> = None;
+    let mut steps = 0;
+    // The launch starts on the ground, so the first steps always slide.
+    let mut free_steps = 0;
+
+    'flight: while steps < params.max_samples {
+        if free_steps >= FREE_STEPS_BEFORE_BATCH {
+            let mut ahead = Vec::new();
+            let mut segments = Vec::new();
+            let (mut ahead_pos, mut ahead_vel) = (pos, vel);
+            while ahead.len() < FREE_FLIGHT_BATCH.min(params.max_samples - steps) {
+                ahead_vel = airborne_velocity_step(
+                    ahead_vel,
+                    ahead_pos.normalize_or_zero().as_vec3(),
+                    params.gravity,
+                    params.drag_quadratic,
+                    params.drag_linear,
+                    params.step_dt_s,
+                );
+                let from = (ahead_pos - camera_ecef).as_vec3();
+                let to = from + ahead_vel * params.step_dt_s;
+                ahead_pos = camera_ecef + to.as_dvec3();
+                segments.push(FlightSegment { from, to });
+                ahead.push((ahead_pos, ahead_vel));
+            }
+
+            let clear = first_contact(&segments).unwrap_or(segments.len());
+            for &(ahead_pos, ahead_vel) in &ahead[..clear] {
+                pos = ahead_pos;
+                vel = ahead_vel;
+                points.push(pos);
+                steps += 1;
+                if (pos - start).length() as f32 > params.max_range_m {
+                    break 'flight;
+                }
+            }
+            if clear < segments.len() {
+                free_steps = 0;
+            }
+            continue;
+        }
 
-    for _ in 0..params.max_samples {
         let up = pos.normalize_or_zero().as_vec3();
         vel = airborne_velocity_step(
             vel,
@@ -469,6 +588,8 @@ fn simulate_leap(
         pos = camera_ecef + outcome.position.as_dvec3();
         vel = outcome.velocity;
         points.push(pos);
+        steps += 1;
+        free_steps = if outcome.contact { 0 } else { free_steps + 1 };
 
         if outcome.ground_hit {
             landed = true;
@@ -741,3 +862,129 @@ fn lerp_color(a: [f32; 4], b: [f32; 4], t: f32) -> [f32; 4] {
         lerp(a[3], b[3], t),
     ]
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Camera-relative height of a flat ground plane below the launch point;
+    /// world up at the launch is +X.
+    const GROUND_X: f32 = -0.5;
+
+    fn params(max_range_m: f32) -> LeapSimParams {
+        LeapSimParams {
+            gravity: 9.81,
+            drag_quadratic: 0.001,
+            drag_linear: 0.05,
+            // A power of two, so the slide's `Duration` step is exactly the
+            // batch's `f32` one.
+            step_dt_s: 1.0 / 64.0,
+            max_samples: 1024,
+            max_range_m,
+        }
+    }
+
+    /// A move-and-slide over the ground plane: a move ending below it stops
+    /// on it and lands.
+    fn slide_on_plane(position: Vec3, velocity: Vec3, dt: Duration, _up: Vec3) -> SlideStep {
+        let target = position + velocity * dt.as_secs_f32();
+        let contact = target.x < GROUND_X;
+        SlideStep {
+            position: if contact {
+                Vec3::new(GROUND_X, target.y, target.z)
+            } else {
+                target
+            },
+            velocity: if contact {
+                Vec3::new(velocity.x.max(0.0), velocity.y, velocity.z)
+            } else {
+                velocity
+            },
+            contact,
+            ground_hit: contact,
+            wall_normal: None,
+        }
+    }
+
+    /// The first segment that reaches within the sweep margin of the plane.
+    fn sweep_plane(segments: &[FlightSegment]) -> Option<usize> {
+        segments
+            .iter()
+            .position(|segment| segment.to.x < GROUND_X + FREE_FLIGHT_SWEEP_MARGIN_M)
+    }
+
+    /// The leap from just above the plane, batched as the preview runs it,
+    /// along with every `(contact, batch length)` the sweep returned; and the
+    /// same leap slid one step at a time.
+    fn batched_and_stepped(
+        velocity: Vec3,
+        max_range_m: f32,
+    ) -> (LeapPath, Vec<(Option<usize>, usize)>, LeapPath) {
+        let start = DVec3::new(6_371_000.5, 0.0, 0.0);
+        let params = params(max_range_m);
+        let mut sweeps = Vec::new();
+        let batched = simulate_leap(
+            start,
+            velocity,
+            &params,
+            start,
+            slide_on_plane,
+            |segments| {
+                let contact = sweep_plane(segments);
+                sweeps.push((contact, segments.len()));
+                contact
+            },
+        );
+        let stepped = simulate_leap(start, velocity, &params, start, slide_on_plane, |_| Some(0));
+        (batched, sweeps, stepped)
+    }
+
+    fn assert_same_path(batched: &LeapPath, stepped: &LeapPath) {
+        assert_eq!(batched.points, stepped.points);
+        assert_eq!(batched.landed, stepped.landed);
+        assert_eq!(batched.horizontal_distance_m, stepped.horizontal_distance_m);
+    }
+
+    #[test]
+    fn batched_flight_lands_where_stepped_flight_does() {
+        // Under a second aloft: the first batch runs into the ground partway.
+        let (batched, sweeps, stepped) = batched_and_stepped(Vec3::new(3.0, 8.0, 0.0), 1000.0);
+        assert_same_path(&batched, &stepped);
+        assert!(stepped.landed);
+        assert!(
+            sweeps
+                .iter()
+                .any(|&(contact, len)| contact.is_some_and(|i| i > 0 && i < len)),
+            "no sweep found contact mid-batch: {sweeps:?}"
+        );
+    }
+
+    #[test]
+    fn batched_flight_stops_at_the_range_inside_a_batch() {
+        // Fast and lofted, so the range runs out mid-batch and the batch never
+        // comes near the ground.
+        let max_range_m = 10.0;
+        let (batched, sweeps, stepped) =
+            batched_and_stepped(Vec3::new(6.0, 30.0, 0.0), max_range_m);
+        assert_same_path(&batched, &stepped);
+        assert!(!stepped.landed);
+        assert!(sweeps.iter().all(|&(contact, _)| contact.is_none()));
+        assert!(
+            sweeps
+                .first()
+                .is_some_and(|&(_, len)| len == FREE_FLIGHT_BATCH)
+        );
+
+        // The path ends on the first point past the range.
+        let start = batched.points[0];
+        let distances: Vec<f32> = batched
+            .points
+            .iter()
+            .map(|point| (point - start).length() as f32)
+            .collect();
+        let (last, rest) = distances.split_last().unwrap();
+        assert!(*last > max_range_m);
+        assert!(rest.iter().all(|&distance| distance <= max_range_m));
+        assert!(batched.points.len() < FREE_STEPS_BEFORE_BATCH + FREE_FLIGHT_BATCH);
+    }
+}
@@ -25,6 +25,7 @@ use veldera_geo::{
     floating_origin::FloatingOriginCamera,
 };
 use veldera_places::{HttpClient, fetch_elevation};
+use veldera_terrain::prefetch::{PrefetchHints, PrefetchTarget};
 
 /// Plugin for the cinematic fly-to-location teleport.
 ///
@@ -54,6 +55,7 @@ impl Plugin for TeleportPlugin {
                     play_departure_woosh,
                     poll_teleport,
                     update_teleport_animation,
+                    publish_teleport_prefetch,
                 ),
             );
     }
@@ -238,6 +240,13 @@ pub struct GeoConfig {
     /// Height above the detected ground (m) at which the player respawns after a
     /// teleport.
     pub spawn_height_above_ground_m: f32,
+    /// Radius around the destination (m) whose terrain is prefetched as soon
+    /// as the flight starts, so the player lands on loaded ground instead of
+    /// waiting for physics.
+    pub prefetch_radius_m: f64,
+    /// Points along the descent (normalized animation time) whose view is
+    /// prefetched after the destination, closest to arrival first.
+    pub prefetch_descent_t: Vec<f64>,
 }
 
 /// Tuning for the teleport flight arc.
@@ -486,6 +495,45 @@ impl ArcTrajectory {
     }
 }
 
+/// Prefetch hint source for the teleport destination.
+const PREFETCH_SOURCE: &str = "teleport";
+
+/// Publish the destination and the final descent as prefetch targets while a
+/// flight is active, so the terrain streams in during the flight rather than
+/// after arrival. A no-op when the terrain plugins aren't present.
+fn publish_teleport_prefetch(
+    config: Res<GeoConfig>,
+    animation: Res<TeleportAnimation>,
+    hints: Option<ResMut<PrefetchHints>>,
+) {
+    let Some(mut hints) = hints else {
+        return;
+    };
+    let Some(phase) = &animation.phase else {
+        hints.clear(PREFETCH_SOURCE);
+        return;
+    };
+
+    let destination = PrefetchTarget {
+        position: phase.target_position,
+        radius: config.prefetch_radius_m,
+    };
+    // Higher on the descent the camera sees further, but only coarse tiles,
+    // so the radius grows with altitude while the node count stays bounded.
+    let descent = config.prefetch_descent_t.iter().map(|&t| PrefetchTarget {
+        position: phase
+            .trajectory
+            .position_at_t(t, phase.start_position, phase.target_position),
+        radius: config
+            .prefetch_radius_m
+            .max(phase.trajectory.altitude_at_t(t)),
+    });
+    hints.set(
+        PREFETCH_SOURCE,
+        std::iter::once(destination).chain(descent).collect(),
+    );
+}
+
 /// Compute the great-circle tangent direction at `position` toward `target`.
 ///
 /// Returns the unit tangent vector in the plane of the great circle,
@@ -8,6 +8,7 @@ use bevy::{ecs::system::SystemParam, prelude::*};
 use bevy_egui::egui;
 use veldera_clouds::{
     CloudDebugMode, CloudLayerKind, CloudLayers, CloudQuality, CloudShadowBakeDiag, CloudWorldTime,
+    PoissonSolver,
 };
 
 #[derive(SystemParam)]
@@ -190,6 +191,12 @@ fn render_overview(ui: &mut egui::Ui, cloud: &mut CloudLayers, world_time: f64)
          enabling both stacks too much per-frame variance for the neighbourhood clamp to absorb \
          and visible noise *increases*.",
     );
+    ui.checkbox(&mut cloud.empty_space_skipping, "Empty-space skipping")
+        .on_hover_text(
+            "After an empty sample, look up the occupancy volume against the local coverage and \
+             leap the run of steps that can't hold cloud. Same image, fewer density samples in \
+             clear sky. Compare with the Steps debug view.",
+        );
 
     ui.checkbox(&mut cloud.denoise, "Denoise (A-Trous wavelet)")
         .on_hover_text(
@@ -266,6 +273,7 @@ fn render_overview(ui: &mut egui::Ui, cloud: &mut CloudLayers, world_time: f64)
                 CloudDebugMode::Topography,
                 CloudDebugMode::KFirst,
                 CloudDebugMode::ShadowUv,
+                CloudDebugMode::Steps,
             ] {
                 if ui
                     .selectable_label(matches_mode(cloud.debug_mode, mode), label_for(mode))
@@ -496,6 +504,43 @@ fn render_climate(ui: &mut egui::Ui, cloud: &mut CloudLayers, image_ids: &Atmosp
             {
                 sim_state.vorticity_damping_seconds = damping_hours * 3600.0;
             }
+            ui.horizontal(|ui| {
+                ui.label("Poisson solver:");
+                for (solver, label) in [
+                    (PoissonSolver::Jacobi, "Jacobi"),
+                    (PoissonSolver::Multigrid, "Multigrid"),
+                ] {
+                    ui.selectable_value(&mut sim_state.poisson_solver, solver, label);
+                }
+            })
+            .response
+            .on_hover_text(
+                "How the streamfunction is solved from vorticity each \
+                 frame. Jacobi: one sweep per frame, cheapest, but \
+                 planet-scale flow takes minutes to catch up. \
+                 Multigrid: V-cycles over the climate grid and its \
+                 halvings, about nine sweeps' cost each, converged \
+                 within a frame or two.",
+            );
+            ui.add_enabled(
+                sim_state.poisson_solver == PoissonSolver::Multigrid,
+                egui::Slider::new(&mut sim_state.multigrid_cycles, 1..=4).text("V-cycles / frame"),
+            )
+            .on_hover_text(
+                "Multigrid V-cycles per frame. Each cuts the residual \
+                 about eightfold; one keeps pace with the sim.",
+            );
+            ui.add(
+                egui::Slider::new(&mut sim_state.deformation_radius_km, 100.0..=6400.0)
+                    .logarithmic(true)
+                    .text("deformation radius (km)"),
+            )
+            .on_hover_text(
+                "Rossby radius of deformation: how far a vorticity \
+                 anomaly steers the flow around it. Earth's \
+                 mid-latitudes sit near 1000 km; larger reaches \
+                 further, up to the whole planet.",
+            );
         });
     });
 
@@ -672,6 +717,7 @@ fn label_for(mode: CloudDebugMode) -> &'static str {
         CloudDebugMode::Topography => "Topography",
         CloudDebugMode::KFirst => "First-cell index k_first",
         CloudDebugMode::ShadowUv => "Shadow UV (R=u, G=v, B=t)",
+        CloudDebugMode::Steps => "Raymarch steps",
     }
 }
 
@@ -715,6 +761,10 @@ fn help_for(mode: CloudDebugMode) -> &'static str {
              transmittance. Red = outside footprint. Pair with the Shadows tab's bake-diagnostic \
              pattern to see which bake content each pixel reads."
         }
+        CloudDebugMode::Steps => {
+            "Primary-march work per pixel: R = density samples evaluated, G = samples leapt as \
+             empty, both as a fraction of 128. Toggle empty-space skipping to compare."
+        }
     }
 }
 
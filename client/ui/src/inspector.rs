@@ -58,6 +58,7 @@ pub(super) fn render_inspector_tab(ui: &mut egui::Ui, params: &mut InspectorPara
             row(ui, "k_last", data.k_last.to_string());
             row(ui, "max_iter", data.max_iter.to_string());
             row(ui, "iter_count", data.iter_count.to_string());
+            row(ui, "skipped_count", data.skipped_count.to_string());
             row(ui, "transmittance", format!("{:.4}", data.transmittance));
             row(ui, "opacity", format!("{:.4}", data.opacity));
             row(ui, "first_hit_t", format!("{:.2} m", data.first_hit_t));
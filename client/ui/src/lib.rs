@@ -209,7 +209,7 @@ fn debug_ui_system(
     mut vehicle_params: vehicle::VehicleParams,
     mut inspector_params: inspector::InspectorParams,
     mut shadow_diag_params: shadow_diag::ShadowDiagParams,
-    profiler_params: profiler::ProfilerParams,
+    mut profiler_params: profiler::ProfilerParams,
     climate_assets: Res<veldera_sky::clouds::CloudClimateAssets>,
 ) -> Result {
     // Resolve egui image ids BEFORE taking `ctx_mut` (same borrow on
@@ -294,7 +294,7 @@ fn debug_ui_system(
             rendering::render_rendering_tab(ui, &mut rendering_params);
         }
         DebugTab::Profiler => {
-            profiler::render_profiler_tab(ui, &profiler_params, profiler_subtab);
+            profiler::render_profiler_tab(ui, &mut profiler_params, profiler_subtab);
         }
     };
 
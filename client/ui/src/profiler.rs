@@ -1,23 +1,26 @@
 //! Profiler tab for the debug UI.
 //!
-//! Two sub-tabs:
+//! Three sub-tabs:
 //! - **Logic** — per-Bevy-system CPU times, sourced from the
 //!   [`crate::profiler::CpuProfile`] resource (populated by our
 //!   custom `tracing-subscriber::Layer`).
 //! - **Render** — per-render-pass GPU + CPU times, sourced from
 //!   [`bevy::diagnostic::DiagnosticsStore`] (populated by
 //!   [`bevy::render::diagnostic::RenderDiagnosticsPlugin`]).
+//! - **Tiles** — tile streaming stage latency percentiles, sourced from
+//!   [`veldera_engine::profiler::StageProfile`] (populated by the same
+//!   layer), and the Chrome trace capture controls.
 
 use std::collections::BTreeMap;
 
 use bevy::{
     diagnostic::DiagnosticsStore,
-    ecs::system::{Res, SystemParam},
+    ecs::system::{Res, ResMut, SystemParam},
 };
 use bevy_egui::egui;
 use egui_extras::{Column, TableBuilder};
 
-use veldera_engine::profiler::CpuProfile;
+use veldera_engine::profiler::{CpuProfile, StageProfile, TraceCapture};
 
 /// Selected sub-tab in the Profiler tab.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
@@ -25,6 +28,7 @@ pub enum ProfilerSubTab {
     #[default]
     Logic,
     Render,
+    Tiles,
 }
 
 impl ProfilerSubTab {
@@ -32,6 +36,7 @@ impl ProfilerSubTab {
         match self {
             Self::Logic => "Logic",
             Self::Render => "Render",
+            Self::Tiles => "Tiles",
         }
     }
 }
@@ -40,16 +45,22 @@ impl ProfilerSubTab {
 pub(super) struct ProfilerParams<'w> {
     pub cpu_profile: Res<'w, CpuProfile>,
     pub render_diagnostics: Res<'w, DiagnosticsStore>,
+    pub stage_profile: ResMut<'w, StageProfile>,
+    pub trace_capture: ResMut<'w, TraceCapture>,
 }
 
 pub(super) fn render_profiler_tab(
     ui: &mut egui::Ui,
-    params: &ProfilerParams,
+    params: &mut ProfilerParams,
     subtab: &mut ProfilerSubTab,
 ) {
     // Sub-tab bar.
     ui.horizontal(|ui| {
-        for tab in [ProfilerSubTab::Logic, ProfilerSubTab::Render] {
+        for tab in [
+            ProfilerSubTab::Logic,
+            ProfilerSubTab::Render,
+            ProfilerSubTab::Tiles,
+        ] {
             if ui.selectable_label(*subtab == tab, tab.label()).clicked() {
                 *subtab = tab;
             }
@@ -60,7 +71,89 @@ pub(super) fn render_profiler_tab(
     match *subtab {
         ProfilerSubTab::Logic => render_logic(ui, &params.cpu_profile),
         ProfilerSubTab::Render => render_render(ui, &params.render_diagnostics),
+        ProfilerSubTab::Tiles => {
+            render_tiles(ui, &mut params.stage_profile, &mut params.trace_capture);
+        }
+    }
+}
+
+fn render_tiles(ui: &mut egui::Ui, profile: &mut StageProfile, capture: &mut TraceCapture) {
+    // Trace capture: record, stop, then save for chrome://tracing or
+    // ui.perfetto.dev.
+    ui.horizontal(|ui| {
+        if capture.is_recording() {
+            if ui.button("Stop trace").clicked() {
+                capture.stop();
+            }
+            ui.label(format!("Recording: {} events", capture.event_count()));
+        } else {
+            if ui.button("Record trace").clicked() {
+                capture.start();
+            }
+            if capture.event_count() > 0 && ui.button("Save trace").clicked() {
+                match capture.save() {
+                    Ok(path) => bevy::log::info!("Saved trace to {}", path.display()),
+                    Err(e) => bevy::log::warn!("Failed to save trace: {e}"),
+                }
+            }
+            if let Some(path) = capture.last_saved() {
+                ui.weak(format!("Last saved: {}", path.display()));
+            }
+        }
+    });
+    ui.separator();
+
+    let summaries = profile.summaries();
+    if summaries.is_empty() {
+        ui.label(
+            "No tile stage timings yet — they arrive as tiles stream in \
+             (native only; empty on WASM).",
+        );
+        return;
     }
+
+    ui.horizontal(|ui| {
+        ui.label("Tile lifecycle stage latencies since startup or reset.");
+        if ui.button("Reset").clicked() {
+            profile.reset();
+        }
+    });
+    ui.label(
+        "Percentiles round up to a histogram bucket (within 25%). Cache and HTTP \
+         include bulk metadata requests; decode and later stages are per tile, \
+         visible per tile mesh.",
+    );
+    ui.add_space(2.0);
+
+    let ms = |d: std::time::Duration| format!("{:.2}", d.as_secs_f64() * 1000.0);
+    TableBuilder::new(ui)
+        .id_salt("tile_stages_table")
+        .column(Column::remainder().resizable(true))
+        .columns(Column::exact(64.0), 5)
+        .header(18.0, |mut row| {
+            for title in ["Stage", "count", "mean ms", "p50 ms", "p95 ms", "p99 ms"] {
+                row.col(|ui| {
+                    ui.strong(title);
+                });
+            }
+        })
+        .body(|mut body| {
+            for summary in &summaries {
+                body.row(16.0, |mut row| {
+                    row.col(|ui| {
+                        ui.label(summary.stage.name());
+                    });
+                    row.col(|ui| {
+                        ui.label(format!("{}", summary.count));
+                    });
+                    for value in [summary.mean, summary.p50, summary.p95, summary.p99] {
+                        row.col(|ui| {
+                            ui.label(ms(value));
+                        });
+                    }
+                });
+            }
+        });
 }
 
 fn render_logic(ui: &mut egui::Ui, profile: &CpuProfile) {
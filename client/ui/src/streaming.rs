@@ -112,7 +112,8 @@ pub(super) fn render_streaming_tab(ui: &mut egui::Ui, params: &mut StreamingPara
         )
         .on_hover_text(
             "Seconds a tile stays loaded after dropping out of \
-             every BFS. Longer = less churn on quick view shifts.",
+             every BFS, whatever the residency budgets. Longer = \
+             less churn on quick view shifts.",
         );
     });
 
@@ -475,6 +476,58 @@ fn draw_counters_panel(ui: &mut egui::Ui, snapshot: &LodSnapshot, mesh_count: us
         "Bulks        cached {:>4}   loading {:>4}   failed {:>4}",
         c.bulks_cached, c.bulks_loading, c.bulks_failed
     ));
+    ui.monospace(format!(
+        "Nodes        failed {:>4}   retrying {:>4}",
+        c.nodes_failed, c.nodes_retrying
+    ));
+    let f = &c.fetch;
+    ui.monospace(format!(
+        "Fetches      pending {:>4}   in flight {:>4}/{:<4} cancelled {:>6}",
+        f.pending, f.in_flight, f.concurrency_limit, f.cancelled_total
+    ));
+    ui.monospace(format!(
+        "Network      latency {} (baseline {})   bandwidth {}",
+        format_latency(f.recent_latency_secs),
+        format_latency(f.baseline_latency_secs),
+        f.bandwidth_bytes_per_sec
+            .map_or("—".to_string(), |b| format!("{:.2} MB/s", b / 1e6)),
+    ));
+    let p = &snapshot.counters.prefetch;
+    ui.monospace(format!(
+        "Prefetch     queued {:>4}  in-flight {:>2}  warmed {:>5} ({:.1} MB)  hit {}  budget {:.2} MB/s",
+        p.queued,
+        p.in_flight,
+        p.warmed,
+        p.warmed_bytes as f64 / 1e6,
+        p.hit_rate()
+            .map_or("—".to_string(), |r| format!("{:.0}%", r * 100.0)),
+        p.budget_bytes_per_sec / 1e6,
+    ));
+    let r = &snapshot.counters.residency;
+    let mib = |bytes: u64| bytes as f64 / (1024.0 * 1024.0);
+    ui.monospace(format!(
+        "Residency    CPU {:>6.0}/{:<6.0} MiB   GPU {:>6.0}/{:<6.0} MiB   optional {:>4}   evicted {:>6}",
+        mib(r.used.cpu),
+        mib(r.budget.cpu),
+        mib(r.used.gpu),
+        mib(r.budget.gpu),
+        r.optional,
+        r.evicted_total,
+    ));
+    let w = &snapshot.counters.walk;
+    let walk_time = snapshot.counters.walk_time;
+    ui.monospace(format!(
+        "Walk         evaluated {:>5}   reused {:>5} in {:>4} subtree(s)   {}{}",
+        w.evaluated,
+        w.reused_calls,
+        w.reused_subtrees,
+        if walk_time.is_zero() {
+            "skipped".to_string()
+        } else {
+            format!("{:.2} ms", walk_time.as_secs_f64() * 1e3)
+        },
+        if w.full { "   (full)" } else { "" },
+    ));
     let speed = snapshot.velocity.length();
     let lead = snapshot.lead.length();
     ui.monospace(format!(
@@ -483,6 +536,10 @@ fn draw_counters_panel(ui: &mut egui::Ui, snapshot: &LodSnapshot, mesh_count: us
     ));
 }
 
+fn format_latency(secs: Option<f64>) -> String {
+    secs.map_or("—".to_string(), |s| format!("{:.0} ms", s * 1e3))
+}
+
 fn collider_depth_range(snapshot: &LodSnapshot) -> (Option<usize>, Option<usize>) {
     let mut min = None;
     let mut max = None;
@@ -1,7 +1,8 @@
 //! Vehicle physics: the Bevy/Avian layer over the pure car model.
 //!
-//! Casts one suspension ray per wheel, hands the results to
-//! [`core::step_car`], and writes the resulting velocities back to Avian.
+//! Casts one suspension sphere per wheel — every vehicle's together, as one
+//! batch — hands the results to [`core::step_car`], and writes the resulting
+//! velocities back to Avian.
 //! Runs in `FixedPreUpdate` after the floating-origin shift so the rays and
 //! the terrain colliders agree on the frame.
 
@@ -12,7 +13,7 @@ use leafwing_input_manager::prelude::*;
 use veldera_game_camera::FollowEntityTarget;
 use veldera_game_camera_state::CameraModeState;
 use veldera_geo::{coords::RadialFrame, floating_origin::WorldPosition};
-use veldera_physics::GameLayer;
+use veldera_physics::{BatchedCast, GameLayer, cast_shapes_batched};
 
 use super::{
     VehicleConfig, VehicleRightRequest,
@@ -150,69 +151,92 @@ pub fn vehicle_physics_system(
     let elapsed = time.elapsed_secs();
     let followed = follow_query.iter().next().map(|follow| follow.target);
 
-    for (
-        entity,
-        (chassis, suspension, engine, transmission, steering, tire),
-        wheels,
-        input,
-        mut sim,
-        mut state,
-        position,
-        rotation,
-        mut linear_velocity,
-        mut angular_velocity,
-        computed_mass,
-        computed_inertia,
-        computed_com,
-    ) in &mut query
-    {
+    // Suspension casts: a wheel-radius sphere along chassis-down, against
+    // ground only (not vehicles, not ragdolls). The sphere footprint rolls
+    // over sub-radius terrain lumps and bridges hairline tile cracks that a
+    // zero-width ray reads at full amplitude.
+    //
+    // The cast starts a full radius plus travel *above* the hardpoint:
+    // terrain colliders are surfaces, not volumes, so a cast that begins
+    // below the ground sails down for ever and reports the wheel airborne. A
+    // hard landing that briefly shoved the chassis into the surface then
+    // killed all suspension force permanently — the car belly-slid on its
+    // hull at speed with free-spinning wheels until something snagged.
+    // Starting high, contact above the wheel's range maps to negative
+    // suspension length, which the core clamps to full compression — actively
+    // pushing the chassis back out instead.
+    //
+    // Every vehicle's wheels are gathered first and cast as one batch, so a
+    // fleet of AI cars costs one spatially sorted, parallel pass rather than
+    // four serial queries per car.
+    let filter = SpatialQueryFilter::default().with_mask([GameLayer::Ground]);
+    let mut pending = Vec::new();
+    for (entity, configs, wheels, _, _, _, position, rotation, ..) in &query {
+        let (chassis, suspension, engine, transmission, steering, tire) = configs;
         let params = build_car_params(chassis, suspension, engine, transmission, steering, tire);
         let wheel_params = wheel_params(wheels);
+        let Ok(down) = Dir3::new(rotation.0 * Vec3::NEG_Y) else {
+            continue;
+        };
+        let raises = wheel_params.map(|wheel| wheel.radius + params.suspension_travel);
+        let origins = std::array::from_fn::<_, 4, _>(|i| {
+            position.0
+                + rotation.0
+                    * (core::wheel_hardpoint(&wheel_params[i], &params) + Vec3::Y * raises[i])
+        });
+        pending.push(PendingVehicle {
+            entity,
+            spheres: wheel_params.map(|wheel| Collider::sphere(wheel.radius)),
+            max_distance: raises.map(|raise| raise + core::wheel_cast_length(&params)),
+            params,
+            wheel_params,
+            down,
+            raises,
+            origins,
+        });
+    }
+    let casts: Vec<BatchedCast> = pending
+        .iter()
+        .flat_map(|vehicle| {
+            (0..4).map(move |i| BatchedCast {
+                shape: &vehicle.spheres[i],
+                origin: vehicle.origins[i],
+                rotation: Quat::IDENTITY,
+                direction: vehicle.down,
+                max_distance: vehicle.max_distance[i],
+            })
+        })
+        .collect();
+    let cast_hits = cast_shapes_batched(&spatial_query, &casts, &filter);
 
-        // Suspension casts: a wheel-radius sphere along chassis-down,
-        // against ground only (not vehicles, not ragdolls). The sphere
-        // footprint rolls over sub-radius terrain lumps and bridges
-        // hairline tile cracks that a zero-width ray reads at full
-        // amplitude.
-        //
-        // The cast starts a full radius plus travel *above* the hardpoint:
-        // terrain colliders are surfaces, not volumes, so a cast that
-        // begins below the ground sails down for ever and reports the wheel
-        // airborne. A hard landing that briefly shoved the chassis into the
-        // surface then killed all suspension force permanently — the car
-        // belly-slid on its hull at speed with free-spinning wheels until
-        // something snagged. Starting high, contact above the wheel's range
-        // maps to negative suspension length, which the core clamps to full
-        // compression — actively pushing the chassis back out instead.
-        let filter = SpatialQueryFilter::default().with_mask([GameLayer::Ground]);
-        let down = rotation.0 * Vec3::NEG_Y;
-        let Ok(down_dir) = Dir3::new(down) else {
+    for (vehicle, vehicle_hits) in pending.iter().zip(cast_hits.chunks_exact(4)) {
+        let Ok((
+            entity,
+            _,
+            _,
+            input,
+            mut sim,
+            mut state,
+            position,
+            rotation,
+            mut linear_velocity,
+            mut angular_velocity,
+            computed_mass,
+            computed_inertia,
+            computed_com,
+        )) = query.get_mut(vehicle.entity)
+        else {
             continue;
         };
-        let mut hits: [Option<WheelCastHit>; 4] = [None; 4];
-        for (i, wheel) in wheel_params.iter().enumerate() {
-            let raise = wheel.radius + params.suspension_travel;
-            let cast_config = ShapeCastConfig {
-                max_distance: raise + core::wheel_cast_length(&params),
-                ..Default::default()
-            };
-            let origin =
-                position.0 + rotation.0 * (core::wheel_hardpoint(wheel, &params) + Vec3::Y * raise);
-            hits[i] = spatial_query
-                .cast_shape(
-                    &Collider::sphere(wheel.radius),
-                    origin,
-                    Quat::IDENTITY,
-                    down_dir,
-                    &cast_config,
-                    &filter,
-                )
-                .map(|hit| WheelCastHit {
-                    distance: hit.distance - raise,
-                    normal: hit.normal1,
-                    point: hit.point1,
-                });
-        }
+        let params = &vehicle.params;
+        let wheel_params = vehicle.wheel_params;
+        let hits: [Option<WheelCastHit>; 4] = std::array::from_fn(|i| {
+            vehicle_hits[i].map(|hit| WheelCastHit {
+                distance: hit.distance - vehicle.raises[i],
+                normal: hit.normal1,
+                point: hit.point1,
+            })
+        });
 
         // World-space inverse inertia from the principal moments.
         let (principal, local_frame) =
@@ -238,7 +262,7 @@ pub fn vehicle_physics_system(
             steer: input.steer,
             handbrake: input.handbrake,
         };
-        let output = core::step_car(&params, &wheel_params, &mut sim.0, &car_input, &hits, &ctx);
+        let output = core::step_car(params, &wheel_params, &mut sim.0, &car_input, &hits, &ctx);
 
         linear_velocity.0 = output.linear_velocity;
         angular_velocity.0 = output.angular_velocity;
@@ -294,6 +318,21 @@ pub fn vehicle_physics_system(
     }
 }
 
+/// One vehicle's step inputs, gathered before the fleet's wheel casts run as a
+/// batch.
+struct PendingVehicle {
+    entity: Entity,
+    params: CarParams,
+    wheel_params: [WheelParams; 4],
+    down: Dir3,
+    /// Per wheel: the cast's sphere, how far above the hardpoint it starts,
+    /// where it starts, and how far it reaches.
+    spheres: [Collider; 4],
+    raises: [f32; 4],
+    origins: [Vec3; 4],
+    max_distance: [f32; 4],
+}
+
 /// Build per-wheel core parameters from the discovered geometry.
 fn wheel_params(wheels: &VehicleWheels) -> [WheelParams; 4] {
     wheels.wheels.map(|w| WheelParams {
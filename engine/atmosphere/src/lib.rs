@@ -59,7 +59,7 @@ pub use resources::{
     AtmosphereTransformsOffset, ExtractedAtmosphereLights, GpuAtmosphere, GpuAtmosphereLight,
     GpuAtmosphereLights, MAX_ATMOSPHERE_LIGHTS, RenderSkyBindGroupLayouts,
 };
-pub use sun_transmittance::compute_sun_transmittance;
+pub use sun_transmittance::{SunTransmittanceTable, compute_sun_transmittance};
 
 use environment::{
     EnvironmentNode, init_atmosphere_probe_layout, init_atmosphere_probe_pipeline,
@@ -69,9 +69,10 @@ use environment::{
 pub use node::AtmosphereNode;
 use node::{AtmosphereLutsNode, RenderSkyNode};
 use resources::{
-    AtmosphereBindGroupLayouts, AtmosphereLutPipelines, AtmosphereSampler,
+    AtmosphereBindGroupLayouts, AtmosphereLutPipelines, AtmosphereLutPolicy, AtmosphereSampler,
     prepare_atmosphere_bind_groups, prepare_atmosphere_lights_buffer, prepare_atmosphere_textures,
     prepare_atmosphere_transforms, prepare_atmosphere_uniforms, queue_render_sky_pipelines,
+    schedule_atmosphere_lut_updates,
 };
 
 /// Plugin that enables atmospheric scattering for spherical planets.
@@ -94,6 +95,7 @@ impl Plugin for SphericalAtmospherePlugin {
         app.add_plugins((
             ExtractComponentPlugin::<SphericalAtmosphere>::default(),
             ExtractComponentPlugin::<GpuAtmosphereSettings>::default(),
+            ExtractComponentPlugin::<AtmosphereLutPolicy>::default(),
             ExtractComponentPlugin::<SphericalAtmosphereCamera>::default(),
             ExtractComponentPlugin::<SphericalAtmosphereEnvironmentMapLight>::default(),
             ExtractComponentPlugin::<AtmosphereEnvironmentMap>::default(),
@@ -166,6 +168,11 @@ impl Plugin for SphericalAtmospherePlugin {
                     prepare_atmosphere_uniforms
                         .before(RenderSystems::PrepareResources)
                         .after(RenderSystems::PrepareAssets),
+                    // Writes the LUT row offsets into `GpuAtmosphereSettings`
+                    // ahead of its uniform upload.
+                    schedule_atmosphere_lut_updates
+                        .before(RenderSystems::PrepareResources)
+                        .after(RenderSystems::PrepareAssets),
                     prepare_atmosphere_transforms.in_set(RenderSystems::PrepareResources),
                     prepare_atmosphere_bind_groups.in_set(RenderSystems::PrepareBindGroups),
                     prepare_atmosphere_probe_bind_groups.in_set(RenderSystems::PrepareBindGroups),
@@ -475,6 +482,27 @@ pub struct AtmosphereSettings {
     /// Debug view: block the scene and show only the atmosphere in-scatter
     /// (aerial perspective) in isolation. Disabled by default.
     pub isolate_inscatter: bool,
+
+    /// How far the sun (or moon) may move across the sky, in degrees, before
+    /// the sky-view LUT is regenerated. The LUT lives in the camera's
+    /// horizontal frame, so turning the camera as far regenerates it too,
+    /// whole rather than over [`Self::sky_view_lut_update_frames`].
+    pub sky_view_lut_sun_tolerance_deg: f32,
+
+    /// How far the camera may climb or descend, in metres, before the
+    /// sky-view LUT is regenerated.
+    pub sky_view_lut_altitude_tolerance_m: f32,
+
+    /// Frames a multiscattering LUT regeneration is spread over, a band of
+    /// rows each. The transmittance LUT it reads is redone on the first. 0 or
+    /// 1 means all at once.
+    pub multiscattering_lut_update_frames: u32,
+
+    /// Frames a sky-view LUT regeneration for a sun or altitude change is
+    /// spread over, as above. While the sun keeps moving (a time-of-day
+    /// scrub) this divides the LUT's cost by as much, at the price of bands
+    /// up to that many frames apart. Camera turns always render it whole.
+    pub sky_view_lut_update_frames: u32,
 }
 
 /// Default for the feature toggles, which are on unless the config turns them
@@ -486,7 +514,7 @@ fn default_true() -> bool {
 }
 
 /// GPU-compatible version of [`AtmosphereSettings`].
-#[derive(Clone, Component, Reflect, ShaderType)]
+#[derive(Clone, Component, Reflect, ShaderType, PartialEq)]
 #[reflect(Default)]
 pub struct GpuAtmosphereSettings {
     pub transmittance_lut_size: UVec2,
@@ -508,6 +536,11 @@ pub struct GpuAtmosphereSettings {
     /// transmittance, anisotropic phase, multiscattering, and environment-map
     /// enables.
     pub feature_flags: u32,
+    /// First row of this frame's multiscattering LUT band. Zero as
+    /// extracted; set by `schedule_atmosphere_lut_updates`.
+    pub multiscattering_lut_row_offset: u32,
+    /// First row of this frame's sky-view LUT band, as above.
+    pub sky_view_lut_row_offset: u32,
 }
 
 impl Default for GpuAtmosphereSettings {
@@ -542,6 +575,8 @@ impl From<AtmosphereSettings> for GpuAtmosphereSettings {
             rendering_method: s.rendering_method as u32,
             raymarch_midpoint_ratio: s.raymarch_midpoint_ratio,
             feature_flags,
+            multiscattering_lut_row_offset: 0,
+            sky_view_lut_row_offset: 0,
         }
     }
 }
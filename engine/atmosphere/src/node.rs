@@ -24,8 +24,8 @@ use bevy::camera::MainPassResolutionOverride;
 use crate::{
     GpuAtmosphereSettings,
     resources::{
-        AtmosphereBindGroups, AtmosphereLutPipelines, AtmosphereTransformsOffset, GpuAtmosphere,
-        RenderSkyPipelineId,
+        AtmosphereBindGroups, AtmosphereLutPipelines, AtmosphereLutUpdates,
+        AtmosphereTransformsOffset, GpuAtmosphere, RenderSkyPipelineId,
     },
 };
 
@@ -42,6 +42,7 @@ pub(super) struct AtmosphereLutsNode {}
 impl ViewNode for AtmosphereLutsNode {
     type ViewQuery = (
         Read<GpuAtmosphereSettings>,
+        Read<AtmosphereLutUpdates>,
         Read<AtmosphereBindGroups>,
         Read<DynamicUniformIndex<GpuAtmosphere>>,
         Read<DynamicUniformIndex<GpuAtmosphereSettings>>,
@@ -56,6 +57,7 @@ impl ViewNode for AtmosphereLutsNode {
         render_context: &mut RenderContext,
         (
             settings,
+            updates,
             bind_groups,
             atmosphere_uniforms_offset,
             settings_uniforms_offset,
@@ -99,51 +101,64 @@ impl ViewNode for AtmosphereLutsNode {
             compute_pass.dispatch_workgroups(workgroups_x, workgroups_y, 1);
         }
 
+        // The transmittance, multiscattering and sky-view LUTs keep their
+        // contents between frames; `AtmosphereLutUpdates` says which of them
+        // (and which rows) are out of date. See `resources/lut_updates.rs`.
+
         // Transmittance LUT.
-        luts_pass.set_pipeline(transmittance_lut_pipeline);
-        luts_pass.set_bind_group(
-            0,
-            &bind_groups.transmittance_lut,
-            &[
-                atmosphere_uniforms_offset.index(),
-                settings_uniforms_offset.index(),
-            ],
-        );
+        if updates.transmittance {
+            luts_pass.set_pipeline(transmittance_lut_pipeline);
+            luts_pass.set_bind_group(
+                0,
+                &bind_groups.transmittance_lut,
+                &[
+                    atmosphere_uniforms_offset.index(),
+                    settings_uniforms_offset.index(),
+                ],
+            );
 
-        dispatch_2d(&mut luts_pass, settings.transmittance_lut_size);
+            dispatch_2d(&mut luts_pass, settings.transmittance_lut_size);
+        }
 
-        // Multiscattering LUT.
-        luts_pass.set_pipeline(multiscattering_lut_pipeline);
-        luts_pass.set_bind_group(
-            0,
-            &bind_groups.multiscattering_lut,
-            &[
-                atmosphere_uniforms_offset.index(),
-                settings_uniforms_offset.index(),
-            ],
-        );
+        // Multiscattering LUT, one band of rows.
+        if let Some(rows) = &updates.multiscattering_rows {
+            luts_pass.set_pipeline(multiscattering_lut_pipeline);
+            luts_pass.set_bind_group(
+                0,
+                &bind_groups.multiscattering_lut,
+                &[
+                    atmosphere_uniforms_offset.index(),
+                    settings_uniforms_offset.index(),
+                ],
+            );
 
-        luts_pass.dispatch_workgroups(
-            settings.multiscattering_lut_size.x,
-            settings.multiscattering_lut_size.y,
-            1,
-        );
+            luts_pass.dispatch_workgroups(
+                settings.multiscattering_lut_size.x,
+                rows.len() as u32,
+                1,
+            );
+        }
 
-        // Sky View LUT.
-        luts_pass.set_pipeline(sky_view_lut_pipeline);
-        luts_pass.set_bind_group(
-            0,
-            &bind_groups.sky_view_lut,
-            &[
-                atmosphere_uniforms_offset.index(),
-                settings_uniforms_offset.index(),
-                atmosphere_transforms_offset.index(),
-                view_uniforms_offset.offset,
-                lights_uniforms_offset.offset,
-            ],
-        );
+        // Sky View LUT, one band of rows.
+        if let Some(rows) = &updates.sky_view_rows {
+            luts_pass.set_pipeline(sky_view_lut_pipeline);
+            luts_pass.set_bind_group(
+                0,
+                &bind_groups.sky_view_lut,
+                &[
+                    atmosphere_uniforms_offset.index(),
+                    settings_uniforms_offset.index(),
+                    atmosphere_transforms_offset.index(),
+                    view_uniforms_offset.offset,
+                    lights_uniforms_offset.offset,
+                ],
+            );
 
-        dispatch_2d(&mut luts_pass, settings.sky_view_lut_size);
+            dispatch_2d(
+                &mut luts_pass,
+                UVec2::new(settings.sky_view_lut_size.x, rows.len() as u32),
+            );
+        }
 
         // Aerial View LUT.
         luts_pass.set_pipeline(aerial_view_lut_pipeline);
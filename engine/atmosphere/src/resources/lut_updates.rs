@@ -0,0 +1,476 @@
+//! Change tracking and time slicing for the per-view LUT passes.
+//!
+//! The transmittance and multiscattering LUTs depend only on the atmosphere,
+//! its scattering medium and the LUT settings; the sky-view LUT adds the
+//! camera's altitude and the lights' directions in atmosphere space. None of
+//! those move on most frames, so [`schedule_atmosphere_lut_updates`] keeps the
+//! inputs each LUT was last generated from and re-runs a pass only once they
+//! drift past the [`AtmosphereSettings`] tolerances. The aerial-view LUT is
+//! fitted to the view frustum and is still rendered every frame.
+//!
+//! A regeneration that isn't forced by freshly allocated textures is spread
+//! over a few frames, one band of rows per frame, via the row offsets in
+//! [`GpuAtmosphereSettings`]. The exception is the sky-view LUT after the
+//! camera turns: it lives in the camera's horizontal frame, so bands rendered
+//! for different headings would meet in a seam across the whole sky, and it
+//! is rendered whole instead.
+
+use std::ops::Range;
+
+use bevy::{
+    ecs::{
+        component::Component,
+        entity::Entity,
+        query::{QueryItem, With},
+        system::{Commands, Query, Res, lifetimeless::Read},
+    },
+    math::{Vec3, Vec3A},
+    pbr::GpuScatteringMedium,
+    prelude::Camera3d,
+    render::{
+        extract_component::ExtractComponent,
+        render_asset::RenderAssets,
+        render_resource::{PipelineCache, TextureViewId},
+        view::ExtractedView,
+    },
+};
+
+use crate::{
+    AtmosphereSettings, ExtractedAtmosphere, GpuAtmosphereSettings, SphericalAtmosphere,
+    SphericalAtmosphereCamera,
+};
+
+use super::{
+    gpu_types::{GpuAtmosphereLight, MAX_ATMOSPHERE_LIGHTS},
+    lights::ExtractedAtmosphereLights,
+    pipelines::AtmosphereLutPipelines,
+    transforms::atmosphere_frame,
+};
+
+/// Rows per workgroup of `sky_view_lut.wgsl`; its bands start on a multiple.
+const SKY_VIEW_WORKGROUP_ROWS: u32 = 16;
+
+/// Relative change in a light's emission that regenerates the sky-view LUT.
+const LIGHT_COLOR_TOLERANCE: f32 = 1e-3;
+
+/// The CPU-only update knobs of [`AtmosphereSettings`], extracted per view.
+#[derive(Clone, Component)]
+pub struct AtmosphereLutPolicy {
+    /// Cosine of `sky_view_lut_sun_tolerance_deg`.
+    sun_tolerance_cos: f32,
+    altitude_tolerance_m: f32,
+    multiscattering_frames: u32,
+    sky_view_frames: u32,
+}
+
+impl From<&AtmosphereSettings> for AtmosphereLutPolicy {
+    fn from(s: &AtmosphereSettings) -> Self {
+        Self {
+            sun_tolerance_cos: s.sky_view_lut_sun_tolerance_deg.max(0.0).to_radians().cos(),
+            altitude_tolerance_m: s.sky_view_lut_altitude_tolerance_m.max(0.0),
+            multiscattering_frames: s.multiscattering_lut_update_frames.max(1),
+            sky_view_frames: s.sky_view_lut_update_frames.max(1),
+        }
+    }
+}
+
+impl ExtractComponent for AtmosphereLutPolicy {
+    type QueryData = Read<AtmosphereSettings>;
+    type QueryFilter = (With<Camera3d>, With<SphericalAtmosphere>);
+    type Out = AtmosphereLutPolicy;
+
+    fn extract_component(item: QueryItem<'_, '_, Self::QueryData>) -> Option<Self::Out> {
+        Some(item.into())
+    }
+}
+
+/// What the LUT node renders for a view this frame.
+#[derive(Clone, Component, Debug, Default, PartialEq)]
+pub struct AtmosphereLutUpdates {
+    pub transmittance: bool,
+    pub multiscattering_rows: Option<Range<u32>>,
+    pub sky_view_rows: Option<Range<u32>>,
+}
+
+/// Everything the transmittance and multiscattering LUTs are a function of.
+#[derive(Clone, PartialEq)]
+struct StaticLutInputs {
+    bottom_radius: f32,
+    top_radius: f32,
+    ground_albedo: Vec3,
+    /// The medium's density and scattering LUTs, which are replaced when the
+    /// asset changes.
+    medium: Option<[TextureViewId; 2]>,
+    /// With the row offsets zeroed.
+    settings: GpuAtmosphereSettings,
+}
+
+impl StaticLutInputs {
+    /// Whether the LUT textures for `self` have other sizes than for
+    /// `other`, i.e. were just reallocated.
+    fn resized(&self, other: &Self) -> bool {
+        let (a, b) = (&self.settings, &other.settings);
+        a.transmittance_lut_size != b.transmittance_lut_size
+            || a.multiscattering_lut_size != b.multiscattering_lut_size
+            || a.sky_view_lut_size != b.sky_view_lut_size
+            || a.aerial_view_lut_size != b.aerial_view_lut_size
+    }
+}
+
+/// The view-dependent inputs of the sky-view LUT.
+#[derive(Clone)]
+struct SkyViewInputs {
+    camera_radius: f32,
+    /// The atmosphere-space forward axis (the camera's heading), in world
+    /// space.
+    heading: Vec3,
+    /// As [`GpuAtmosphereLight`]s, but with directions in atmosphere space.
+    lights: Vec<GpuAtmosphereLight>,
+}
+
+impl SkyViewInputs {
+    /// Whether the camera turned past the sun tolerance since `self`, which
+    /// rotates the whole LUT at once.
+    fn turned(&self, other: &Self, policy: &AtmosphereLutPolicy) -> bool {
+        self.heading.dot(other.heading) < policy.sun_tolerance_cos
+    }
+
+    fn within_tolerance(&self, other: &Self, policy: &AtmosphereLutPolicy) -> bool {
+        (self.camera_radius - other.camera_radius).abs() <= policy.altitude_tolerance_m
+            && self.lights.len() == other.lights.len()
+            && self.lights.iter().zip(&other.lights).all(|(a, b)| {
+                a.direction_to_light.dot(b.direction_to_light) >= policy.sun_tolerance_cos
+                    && (a.color - b.color).abs().max_element()
+                        <= LIGHT_COLOR_TOLERANCE * a.color.max_element()
+                    && a.sun_disk_angular_size == b.sun_disk_angular_size
+                    && a.sun_disk_intensity == b.sun_disk_intensity
+            })
+    }
+}
+
+/// Per-view record of what the LUTs currently hold, kept across frames.
+#[derive(Component)]
+pub struct AtmosphereLutState {
+    static_inputs: StaticLutInputs,
+    sky_view_inputs: SkyViewInputs,
+    /// Next multiscattering row to write while a regeneration is under way.
+    multiscattering_sweep: Option<u32>,
+    /// Next sky-view row to write while a regeneration is under way.
+    sky_view_sweep: Option<u32>,
+    /// The multiscattering LUT finished regenerating, so the sky-view LUT
+    /// that reads it is stale whatever its own inputs say.
+    sky_view_stale: bool,
+}
+
+impl AtmosphereLutState {
+    /// State for LUTs just rendered from scratch.
+    fn fresh(static_inputs: StaticLutInputs, sky_view_inputs: SkyViewInputs) -> Self {
+        Self {
+            static_inputs,
+            sky_view_inputs,
+            multiscattering_sweep: None,
+            sky_view_sweep: None,
+            sky_view_stale: false,
+        }
+    }
+
+    /// Advances the sweeps and returns this frame's work.
+    fn plan(
+        &mut self,
+        static_inputs: StaticLutInputs,
+        sky_view_inputs: SkyViewInputs,
+        policy: &AtmosphereLutPolicy,
+    ) -> AtmosphereLutUpdates {
+        let mut updates = AtmosphereLutUpdates::default();
+
+        // A sweep runs to completion against the inputs it started from; any
+        // drift meanwhile is caught by the comparison once it ends.
+        if self.multiscattering_sweep.is_none() && self.static_inputs != static_inputs {
+            self.static_inputs = static_inputs;
+            self.multiscattering_sweep = Some(0);
+            updates.transmittance = true;
+        }
+        if let Some(start) = self.multiscattering_sweep {
+            let height = self.static_inputs.settings.multiscattering_lut_size.y;
+            let rows = band(start, height, policy.multiscattering_frames, 1);
+            self.multiscattering_sweep = (rows.end < height).then_some(rows.end);
+            self.sky_view_stale |= rows.end >= height;
+            updates.multiscattering_rows = Some(rows);
+        }
+
+        let height = self.static_inputs.settings.sky_view_lut_size.y;
+        if self.sky_view_inputs.turned(&sky_view_inputs, policy) {
+            // Render it whole, abandoning any sweep for the old heading.
+            self.sky_view_inputs = sky_view_inputs;
+            self.sky_view_sweep = None;
+            self.sky_view_stale = false;
+            updates.sky_view_rows = Some(0..height);
+            return updates;
+        }
+        if self.sky_view_sweep.is_none()
+            && (self.sky_view_stale
+                || !self
+                    .sky_view_inputs
+                    .within_tolerance(&sky_view_inputs, policy))
+        {
+            self.sky_view_inputs = sky_view_inputs;
+            self.sky_view_sweep = Some(0);
+            self.sky_view_stale = false;
+        }
+        if let Some(start) = self.sky_view_sweep {
+            let rows = band(
+                start,
+                height,
+                policy.sky_view_frames,
+                SKY_VIEW_WORKGROUP_ROWS,
+            );
+            self.sky_view_sweep = (rows.end < height).then_some(rows.end);
+            updates.sky_view_rows = Some(rows);
+        }
+
+        updates
+    }
+}
+
+/// The band of rows starting at `start` when `height` rows are split over
+/// `frames` frames, with every band a multiple of `align` rows tall.
+fn band(start: u32, height: u32, frames: u32, align: u32) -> Range<u32> {
+    let rows = height
+        .div_ceil(frames.max(1))
+        .next_multiple_of(align)
+        .max(1);
+    start..(start + rows).min(height)
+}
+
+/// Decides which LUTs each view renders this frame and writes the row offsets
+/// of the sliced ones into its [`GpuAtmosphereSettings`]. Runs before the
+/// settings uniform is uploaded.
+#[allow(clippy::type_complexity)]
+pub fn schedule_atmosphere_lut_updates(
+    mut views: Query<
+        (
+            Entity,
+            &ExtractedAtmosphere,
+            &ExtractedView,
+            &SphericalAtmosphereCamera,
+            &AtmosphereLutPolicy,
+            &mut GpuAtmosphereSettings,
+            Option<&mut AtmosphereLutState>,
+        ),
+        With<Camera3d>,
+    >,
+    lights: Res<ExtractedAtmosphereLights>,
+    gpu_media: Res<RenderAssets<GpuScatteringMedium>>,
+    pipelines: Res<AtmosphereLutPipelines>,
+    pipeline_cache: Res<PipelineCache>,
+    mut commands: Commands,
+) {
+    for (entity, atmosphere, view, camera, policy, mut settings, state) in &mut views {
+        let static_inputs = StaticLutInputs {
+            bottom_radius: atmosphere.bottom_radius,
+            top_radius: atmosphere.top_radius,
+            ground_albedo: atmosphere.ground_albedo,
+            medium: gpu_media.get(atmosphere.medium).map(|medium| {
+                [
+                    medium.density_lut_view.id(),
+                    medium.scattering_lut_view.id(),
+                ]
+            }),
+            settings: GpuAtmosphereSettings {
+                multiscattering_lut_row_offset: 0,
+                sky_view_lut_row_offset: 0,
+                ..settings.clone()
+            },
+        };
+
+        let world_from_view = view.world_from_view.affine();
+        let (x, y, z) = atmosphere_frame(
+            world_from_view.matrix3.z_axis,
+            world_from_view.matrix3.y_axis,
+            Vec3A::from(camera.local_up),
+        );
+        let count = (lights.0.count as usize).min(MAX_ATMOSPHERE_LIGHTS);
+        let sky_view_inputs = SkyViewInputs {
+            camera_radius: camera.camera_radius,
+            heading: z.into(),
+            lights: lights.0.lights[..count]
+                .iter()
+                .map(|light| {
+                    let d = Vec3A::from(light.direction_to_light);
+                    GpuAtmosphereLight {
+                        direction_to_light: Vec3::new(x.dot(d), y.dot(d), z.dot(d)),
+                        ..*light
+                    }
+                })
+                .collect(),
+        };
+
+        // Until the LUT pipelines and the medium are ready the node renders
+        // nothing, so nothing may be assumed about the LUTs either.
+        let ready = static_inputs.medium.is_some()
+            && [
+                pipelines.transmittance_lut,
+                pipelines.multiscattering_lut,
+                pipelines.sky_view_lut,
+                pipelines.aerial_view_lut,
+            ]
+            .into_iter()
+            .all(|id| pipeline_cache.get_compute_pipeline(id).is_some());
+
+        let updates = match state {
+            Some(mut state) if ready && !state.static_inputs.resized(&static_inputs) => {
+                state.plan(static_inputs, sky_view_inputs, policy)
+            }
+            // New or reallocated textures hold nothing yet: render them whole.
+            _ => {
+                if ready {
+                    commands
+                        .entity(entity)
+                        .insert(AtmosphereLutState::fresh(static_inputs, sky_view_inputs));
+                } else {
+                    commands.entity(entity).remove::<AtmosphereLutState>();
+                }
+                AtmosphereLutUpdates {
+                    transmittance: true,
+                    multiscattering_rows: Some(0..settings.multiscattering_lut_size.y),
+                    sky_view_rows: Some(0..settings.sky_view_lut_size.y),
+                }
+            }
+        };
+
+        settings.multiscattering_lut_row_offset = updates
+            .multiscattering_rows
+            .as_ref()
+            .map_or(0, |rows| rows.start);
+        settings.sky_view_lut_row_offset =
+            updates.sky_view_rows.as_ref().map_or(0, |rows| rows.start);
+        commands.entity(entity).insert(updates);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use bevy::math::UVec2;
+
+    use super::*;
+
+    fn policy(multiscattering_frames: u32, sky_view_frames: u32) -> AtmosphereLutPolicy {
+        AtmosphereLutPolicy {
+            sun_tolerance_cos: 0.1f32.to_radians().cos(),
+            altitude_tolerance_m: 10.0,
+            multiscattering_frames,
+            sky_view_frames,
+        }
+    }
+
+    fn static_inputs(ground_albedo: f32) -> StaticLutInputs {
+        StaticLutInputs {
+            bottom_radius: 6.36e6,
+            top_radius: 6.46e6,
+            ground_albedo: Vec3::splat(ground_albedo),
+            medium: None,
+            settings: GpuAtmosphereSettings {
+                multiscattering_lut_size: UVec2::new(32, 32),
+                sky_view_lut_size: UVec2::new(400, 200),
+                ..Default::default()
+            },
+        }
+    }
+
+    fn sky_view_inputs(sun: Vec3, camera_radius: f32) -> SkyViewInputs {
+        SkyViewInputs {
+            camera_radius,
+            heading: Vec3::Z,
+            lights: vec![GpuAtmosphereLight {
+                direction_to_light: sun.normalize(),
+                color: Vec3::ONE,
+                ..Default::default()
+            }],
+        }
+    }
+
+    #[test]
+    fn bands_tile_the_lut() {
+        assert_eq!(band(0, 200, 2, 16), 0..112);
+        assert_eq!(band(112, 200, 2, 16), 112..200);
+        assert_eq!(band(0, 32, 4, 1), 0..8);
+        assert_eq!(band(24, 32, 4, 1), 24..32);
+        assert_eq!(band(0, 32, 1, 1), 0..32);
+    }
+
+    #[test]
+    fn unchanged_inputs_render_nothing() {
+        let sun = Vec3::new(0.3, 0.5, 0.2);
+        let mut state = AtmosphereLutState::fresh(static_inputs(0.3), sky_view_inputs(sun, 6.37e6));
+        let updates = state.plan(
+            static_inputs(0.3),
+            // Within both tolerances.
+            sky_view_inputs(sun + Vec3::new(1e-5, 0.0, 0.0), 6.37e6 + 5.0),
+            &policy(4, 2),
+        );
+        assert_eq!(updates, AtmosphereLutUpdates::default());
+    }
+
+    #[test]
+    fn sun_motion_sweeps_the_sky_view_lut() {
+        let policy = policy(4, 2);
+        let mut state = AtmosphereLutState::fresh(
+            static_inputs(0.3),
+            sky_view_inputs(Vec3::new(0.3, 0.5, 0.2), 6.37e6),
+        );
+        let moved = sky_view_inputs(Vec3::new(0.3, 0.45, 0.2), 6.37e6);
+        let first = state.plan(static_inputs(0.3), moved.clone(), &policy);
+        assert!(!first.transmittance && first.multiscattering_rows.is_none());
+        assert_eq!(first.sky_view_rows, Some(0..112));
+        let second = state.plan(static_inputs(0.3), moved.clone(), &policy);
+        assert_eq!(second.sky_view_rows, Some(112..200));
+        let third = state.plan(static_inputs(0.3), moved, &policy);
+        assert_eq!(third, AtmosphereLutUpdates::default());
+    }
+
+    #[test]
+    fn turning_renders_the_sky_view_lut_whole() {
+        let policy = policy(4, 2);
+        let sun = Vec3::new(0.3, 0.5, 0.2);
+        let mut state = AtmosphereLutState::fresh(static_inputs(0.3), sky_view_inputs(sun, 6.37e6));
+        // A sweep for a sun move is under way when the camera turns.
+        let moved = sky_view_inputs(Vec3::new(0.3, 0.45, 0.2), 6.37e6);
+        let first = state.plan(static_inputs(0.3), moved.clone(), &policy);
+        assert_eq!(first.sky_view_rows, Some(0..112));
+        let turned = SkyViewInputs {
+            heading: Vec3::new(1.0, 0.0, 1.0).normalize(),
+            lights: sky_view_inputs(Vec3::new(-0.1, 0.45, 0.35), 6.37e6).lights,
+            ..moved
+        };
+        let second = state.plan(static_inputs(0.3), turned.clone(), &policy);
+        assert_eq!(second.sky_view_rows, Some(0..200));
+        let third = state.plan(static_inputs(0.3), turned, &policy);
+        assert_eq!(third, AtmosphereLutUpdates::default());
+    }
+
+    #[test]
+    fn medium_change_resweeps_then_refreshes_the_sky() {
+        let policy = policy(4, 1);
+        let sky = sky_view_inputs(Vec3::Y, 6.37e6);
+        let mut state = AtmosphereLutState::fresh(static_inputs(0.3), sky.clone());
+        let mut rows = Vec::new();
+        for frame in 0..5 {
+            let updates = state.plan(static_inputs(0.4), sky.clone(), &policy);
+            assert_eq!(updates.transmittance, frame == 0);
+            if frame < 3 {
+                assert_eq!(updates.sky_view_rows, None);
+            }
+            if let Some(r) = updates.multiscattering_rows {
+                rows.push(r);
+            }
+            if frame == 3 {
+                // The last band lands, and the sky-view LUT reads it.
+                assert_eq!(updates.sky_view_rows, Some(0..200));
+            }
+            if frame == 4 {
+                assert_eq!(updates, AtmosphereLutUpdates::default());
+            }
+        }
+        assert_eq!(rows, vec![0..8, 8..16, 16..24, 24..32]);
+    }
+}
@@ -8,6 +8,7 @@
 //! - [`layouts`] — bind-group layout descriptors.
 //! - [`pipelines`] — LUT compute pipelines and the sky render pipeline.
 //! - [`textures`] — per-view LUT textures.
+//! - [`lut_updates`] — which LUTs each view regenerates, and how much of them.
 //! - [`transforms`] — per-view uniform/transform preparation.
 //! - [`buffer`] — the global single-atmosphere storage buffer.
 //! - [`bind_groups`] — per-view bind-group assembly.
@@ -17,6 +18,7 @@ mod buffer;
 mod gpu_types;
 mod layouts;
 mod lights;
+mod lut_updates;
 mod pipelines;
 mod sampler;
 mod textures;
@@ -35,6 +37,9 @@ pub(crate) use bind_groups::{AtmosphereBindGroups, prepare_atmosphere_bind_group
 pub(crate) use buffer::{init_atmosphere_buffer, write_atmosphere_buffer};
 pub(crate) use layouts::AtmosphereBindGroupLayouts;
 pub(crate) use lights::prepare_atmosphere_lights_buffer;
+pub(crate) use lut_updates::{
+    AtmosphereLutPolicy, AtmosphereLutUpdates, schedule_atmosphere_lut_updates,
+};
 pub(crate) use pipelines::{
     AtmosphereLutPipelines, RenderSkyPipelineId, queue_render_sky_pipelines,
 };
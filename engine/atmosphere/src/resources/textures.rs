@@ -5,14 +5,11 @@ use bevy::{
         component::Component,
         entity::Entity,
         query::With,
-        system::{Commands, Query, Res, ResMut},
+        system::{Commands, Query, Res},
     },
     image::ToExtents,
-    render::{
-        render_resource::*,
-        renderer::RenderDevice,
-        texture::{CachedTexture, TextureCache},
-    },
+    math::{UVec2, UVec3},
+    render::{render_resource::*, renderer::RenderDevice, texture::CachedTexture},
 };
 
 use crate::{ExtractedAtmosphere, GpuAtmosphereSettings};
@@ -25,76 +22,80 @@ pub struct AtmosphereTextures {
     pub aerial_view_lut: CachedTexture,
 }
 
+impl AtmosphereTextures {
+    /// Whether these textures have the sizes `lut_settings` asks for.
+    fn fit(&self, lut_settings: &GpuAtmosphereSettings) -> bool {
+        let size_2d = |lut: &CachedTexture| UVec2::new(lut.texture.width(), lut.texture.height());
+        let aerial = &self.aerial_view_lut.texture;
+        size_2d(&self.transmittance_lut) == lut_settings.transmittance_lut_size
+            && size_2d(&self.multiscattering_lut) == lut_settings.multiscattering_lut_size
+            && size_2d(&self.sky_view_lut) == lut_settings.sky_view_lut_size
+            && UVec3::new(
+                aerial.width(),
+                aerial.height(),
+                aerial.depth_or_array_layers(),
+            ) == lut_settings.aerial_view_lut_size
+    }
+}
+
+/// Allocates each view's LUTs, keeping them for as long as their sizes hold.
+///
+/// The LUTs carry their contents across frames (`lut_updates.rs` only
+/// re-renders them when their inputs change), so they come straight from the
+/// device rather than the `TextureCache`, which may hand a view a different
+/// texture of the same descriptor from one frame to the next.
 pub fn prepare_atmosphere_textures(
-    views: Query<(Entity, &GpuAtmosphereSettings), With<ExtractedAtmosphere>>,
+    views: Query<
+        (Entity, &GpuAtmosphereSettings, Option<&AtmosphereTextures>),
+        With<ExtractedAtmosphere>,
+    >,
     render_device: Res<RenderDevice>,
-    mut texture_cache: ResMut<TextureCache>,
     mut commands: Commands,
 ) {
-    for (entity, lut_settings) in &views {
-        let transmittance_lut = texture_cache.get(
-            &render_device,
-            TextureDescriptor {
-                label: Some("transmittance_lut"),
-                size: lut_settings.transmittance_lut_size.to_extents(),
-                mip_level_count: 1,
-                sample_count: 1,
-                dimension: TextureDimension::D2,
-                format: TextureFormat::Rgba16Float,
-                usage: TextureUsages::STORAGE_BINDING | TextureUsages::TEXTURE_BINDING,
-                view_formats: &[],
-            },
-        );
+    for (entity, lut_settings, textures) in &views {
+        if textures.is_some_and(|textures| textures.fit(lut_settings)) {
+            continue;
+        }
 
-        let multiscattering_lut = texture_cache.get(
-            &render_device,
-            TextureDescriptor {
-                label: Some("multiscattering_lut"),
-                size: lut_settings.multiscattering_lut_size.to_extents(),
+        let lut = |label: &'static str, size: Extent3d, dimension: TextureDimension| {
+            let texture = render_device.create_texture(&TextureDescriptor {
+                label: Some(label),
+                size,
                 mip_level_count: 1,
                 sample_count: 1,
-                dimension: TextureDimension::D2,
+                dimension,
                 format: TextureFormat::Rgba16Float,
                 usage: TextureUsages::STORAGE_BINDING | TextureUsages::TEXTURE_BINDING,
                 view_formats: &[],
-            },
-        );
-
-        let sky_view_lut = texture_cache.get(
-            &render_device,
-            TextureDescriptor {
-                label: Some("sky_view_lut"),
-                size: lut_settings.sky_view_lut_size.to_extents(),
-                mip_level_count: 1,
-                sample_count: 1,
-                dimension: TextureDimension::D2,
-                format: TextureFormat::Rgba16Float,
-                usage: TextureUsages::STORAGE_BINDING | TextureUsages::TEXTURE_BINDING,
-                view_formats: &[],
-            },
-        );
-
-        let aerial_view_lut = texture_cache.get(
-            &render_device,
-            TextureDescriptor {
-                label: Some("aerial_view_lut"),
-                size: lut_settings.aerial_view_lut_size.to_extents(),
-                mip_level_count: 1,
-                sample_count: 1,
-                dimension: TextureDimension::D3,
-                format: TextureFormat::Rgba16Float,
-                usage: TextureUsages::STORAGE_BINDING | TextureUsages::TEXTURE_BINDING,
-                view_formats: &[],
-            },
-        );
-
-        commands.entity(entity).insert({
-            AtmosphereTextures {
-                transmittance_lut,
-                multiscattering_lut,
-                sky_view_lut,
-                aerial_view_lut,
+            });
+            let default_view = texture.create_view(&TextureViewDescriptor::default());
+            CachedTexture {
+                texture,
+                default_view,
             }
+        };
+
+        commands.entity(entity).insert(AtmosphereTextures {
+            transmittance_lut: lut(
+                "transmittance_lut",
+                lut_settings.transmittance_lut_size.to_extents(),
+                TextureDimension::D2,
+            ),
+            multiscattering_lut: lut(
+                "multiscattering_lut",
+                lut_settings.multiscattering_lut_size.to_extents(),
+                TextureDimension::D2,
+            ),
+            sky_view_lut: lut(
+                "sky_view_lut",
+                lut_settings.sky_view_lut_size.to_extents(),
+                TextureDimension::D2,
+            ),
+            aerial_view_lut: lut(
+                "aerial_view_lut",
+                lut_settings.aerial_view_lut_size.to_extents(),
+                TextureDimension::D3,
+            ),
         });
     }
 }
@@ -135,7 +135,11 @@ const MIN_TANGENTIAL_LENGTH_SQUARED: f32 = 1e-4;
 /// threshold and fall back to the camera's Y axis, which is exactly tangent
 /// whenever the forward axis is radial (the two are orthonormal, so at least
 /// one of them always projects onto the tangent plane with near-unit length).
-fn atmosphere_frame(camera_z: Vec3A, camera_y: Vec3A, local_up: Vec3A) -> (Vec3A, Vec3A, Vec3A) {
+pub(super) fn atmosphere_frame(
+    camera_z: Vec3A,
+    camera_y: Vec3A,
+    local_up: Vec3A,
+) -> (Vec3A, Vec3A, Vec3A) {
     let atmo_y = local_up;
     let z_tangential = camera_z.reject_from(local_up);
     let atmo_z = if z_tangential.length_squared() > MIN_TANGENTIAL_LENGTH_SQUARED {
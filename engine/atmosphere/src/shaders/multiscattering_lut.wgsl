@@ -38,7 +38,9 @@ var<workgroup> l_shared_mem: array<vec3<f32>, 64>;
 @compute
 @workgroup_size(1, 1, 64)
 fn main(@builtin(global_invocation_id) global_id: vec3<u32>) {
-    var uv = (vec2<f32>(global_id.xy) + 0.5) / vec2<f32>(settings.multiscattering_lut_size);
+    // The dispatch covers one band of rows; see `multiscattering_lut_row_offset`.
+    let texel = global_id.xy + vec2(0u, settings.multiscattering_lut_row_offset);
+    var uv = (vec2<f32>(texel) + 0.5) / vec2<f32>(settings.multiscattering_lut_size);
 
     let r_mu = multiscattering_lut_uv_to_r_mu(uv);
     let light_dir = normalize(vec3(0.0, r_mu.y, -1.0));
@@ -73,7 +75,7 @@ fn main(@builtin(global_invocation_id) global_id: vec3<u32>) {
 
     // Equation 10 from the paper: Geometric series for infinite scattering.
     let psi_ms = l_2 / (1.0 - f_ms);
-    textureStore(multiscattering_lut_out, global_id.xy, vec4<f32>(psi_ms, 1.0));
+    textureStore(multiscattering_lut_out, texel, vec4<f32>(psi_ms, 1.0));
 }
 
 struct MultiscatteringSample {
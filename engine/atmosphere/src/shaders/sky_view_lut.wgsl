@@ -21,7 +21,9 @@
 @compute
 @workgroup_size(16, 16, 1)
 fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
-    let uv = vec2<f32>(idx.xy) / vec2<f32>(settings.sky_view_lut_size);
+    // The dispatch covers one band of rows; see `sky_view_lut_row_offset`.
+    let texel = idx.xy + vec2(0u, settings.sky_view_lut_row_offset);
+    let uv = vec2<f32>(texel) / vec2<f32>(settings.sky_view_lut_size);
 
     let cam_pos = get_view_position();
     let r = length(cam_pos);
@@ -39,5 +41,5 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
     // Raymarch in atmosphere space (position and ray direction both in atmosphere space).
     let result = raymarch_atmosphere(atmo_pos, ray_dir_as, t_max, settings.sky_view_lut_samples, uv, true);
 
-    textureStore(sky_view_lut_out, idx.xy, vec4(result.inscattering, 1.0));
+    textureStore(sky_view_lut_out, texel, vec4(result.inscattering, 1.0));
 }
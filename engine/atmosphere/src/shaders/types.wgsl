@@ -27,6 +27,11 @@ struct AtmosphereSettings {
     rendering_method: u32,
     raymarch_midpoint_ratio: f32,
     feature_flags: u32,
+    // First row of the band the multiscattering / sky-view LUT passes write
+    // this frame; they are regenerated a few rows per frame (see
+    // `resources/lut_updates.rs`).
+    multiscattering_lut_row_offset: u32,
+    sky_view_lut_row_offset: u32,
 }
 
 // "Atmosphere space" is centered at the camera position, with Y pointing in the local "up"
@@ -10,8 +10,13 @@
 //! returned value matches what the rendered atmosphere would see for the same
 //! `(r, mu)`. Doing it CPU-side avoids a GPU→CPU readback for what is a tiny
 //! piece of data needed in the main world (the directional light's `color`).
+//!
+//! Per-frame callers should go through [`SunTransmittanceTable`], which
+//! tabulates the same integral over the transmittance LUT's `(r, mu)`
+//! parametrisation once per atmosphere and interpolates it afterwards.
 
 use bevy::{
+    asset::AssetId,
     math::Vec3,
     pbr::{Falloff, ScatteringMedium},
 };
@@ -22,6 +27,15 @@ use crate::SphericalAtmosphere;
 /// [`crate::AtmosphereSettings::transmittance_lut_samples`].
 const SAMPLES: u32 = 40;
 
+/// Columns (view-zenith axis) of [`SunTransmittanceTable`]. Matches the
+/// default transmittance LUT width.
+const TABLE_MU_SIZE: usize = 256;
+
+/// Rows (altitude axis) of [`SunTransmittanceTable`]. Matches the default
+/// transmittance LUT height; 256×128 keeps the interpolation within about
+/// 1.5e-3 of the direct integral, grazing rays included.
+const TABLE_R_SIZE: usize = 128;
+
 /// Returns the spectral transmittance along the ray `(r, mu)`.
 ///
 /// `r`: distance from the planet center, in meters.
@@ -41,17 +55,155 @@ pub fn compute_sun_transmittance(
     mu: f32,
     midpoint_ratio: f32,
 ) -> Vec3 {
-    if ray_intersects_ground(r, mu, atmosphere.bottom_radius) {
+    integrate(
+        atmosphere.bottom_radius,
+        atmosphere.top_radius,
+        medium,
+        r,
+        mu,
+        midpoint_ratio,
+    )
+}
+
+/// [`compute_sun_transmittance`] precomputed over every `(r, mu)` inside the
+/// atmosphere and bilinearly interpolated, so lighting can query it every
+/// frame for a few tens of nanoseconds instead of a 40-sample integration.
+///
+/// Built for one atmosphere, medium and midpoint ratio; rebuild it when
+/// [`Self::matches`] fails or the medium asset is modified.
+pub struct SunTransmittanceTable {
+    bottom_radius: f32,
+    top_radius: f32,
+    medium: AssetId<ScatteringMedium>,
+    midpoint_ratio: f32,
+    /// Row-major, `TABLE_R_SIZE` rows of `TABLE_MU_SIZE`.
+    texels: Vec<Vec3>,
+}
+
+impl SunTransmittanceTable {
+    /// Integrates the table for `atmosphere`, whose medium is `medium`.
+    pub fn new(
+        atmosphere: &SphericalAtmosphere,
+        medium: &ScatteringMedium,
+        midpoint_ratio: f32,
+    ) -> Self {
+        let (bottom, top) = (atmosphere.bottom_radius, atmosphere.top_radius);
+        let mut texels = Vec::with_capacity(TABLE_MU_SIZE * TABLE_R_SIZE);
+        for y in 0..TABLE_R_SIZE {
+            for x in 0..TABLE_MU_SIZE {
+                let u = x as f32 / (TABLE_MU_SIZE - 1) as f32;
+                let v = y as f32 / (TABLE_R_SIZE - 1) as f32;
+                let (r, mu) = uv_to_r_mu(bottom, top, u, v);
+                // `u == 1` is the grazing ray itself, which rounding would
+                // otherwise send into the ground test.
+                texels.push(integrate_to_top(bottom, top, medium, r, mu, midpoint_ratio));
+            }
+        }
+        Self {
+            bottom_radius: bottom,
+            top_radius: top,
+            medium: atmosphere.medium.id(),
+            midpoint_ratio,
+            texels,
+        }
+    }
+
+    /// Whether the table was built for this atmosphere and midpoint ratio.
+    /// Edits to the medium asset itself aren't visible here.
+    pub fn matches(&self, atmosphere: &SphericalAtmosphere, midpoint_ratio: f32) -> bool {
+        self.bottom_radius == atmosphere.bottom_radius
+            && self.top_radius == atmosphere.top_radius
+            && self.medium == atmosphere.medium.id()
+            && self.midpoint_ratio == midpoint_ratio
+    }
+
+    /// [`compute_sun_transmittance`] for `(r, mu)`. Points outside the
+    /// atmosphere shell fall back to integrating along the ray in `medium`.
+    pub fn sample(&self, medium: &ScatteringMedium, r: f32, mu: f32) -> Vec3 {
+        let (bottom, top) = (self.bottom_radius, self.top_radius);
+        if ray_intersects_ground(r, mu, bottom) {
+            return Vec3::ZERO;
+        }
+        if !(bottom..=top).contains(&r) {
+            return integrate(bottom, top, medium, r, mu, self.midpoint_ratio);
+        }
+
+        let (u, v) = r_mu_to_uv(bottom, top, r, mu);
+        let x = u * (TABLE_MU_SIZE - 1) as f32;
+        let y = v * (TABLE_R_SIZE - 1) as f32;
+        let (x0, y0) = (
+            (x as usize).min(TABLE_MU_SIZE - 2),
+            (y as usize).min(TABLE_R_SIZE - 2),
+        );
+        let (tx, ty) = (x - x0 as f32, y - y0 as f32);
+        let texel = |x: usize, y: usize| self.texels[y * TABLE_MU_SIZE + x];
+        let near = texel(x0, y0).lerp(texel(x0 + 1, y0), tx);
+        let far = texel(x0, y0 + 1).lerp(texel(x0 + 1, y0 + 1), tx);
+        near.lerp(far, ty)
+    }
+}
+
+/// The transmittance LUT's `(r, mu) → uv` mapping
+/// (`transmittance_lut_r_mu_to_uv` in `bruneton_functions.wgsl`), for `r`
+/// inside the atmosphere and rays that miss the ground.
+fn r_mu_to_uv(bottom: f32, top: f32, r: f32, mu: f32) -> (f32, f32) {
+    let h = (top * top - bottom * bottom).sqrt();
+    let rho = (r * r - bottom * bottom).max(0.0).sqrt();
+    let d = distance_to_top_atmosphere_boundary(r, mu, top);
+    let (d_min, d_max) = (top - r, rho + h);
+    let u = if d_max > d_min {
+        (d - d_min) / (d_max - d_min)
+    } else {
+        0.0
+    };
+    (u.clamp(0.0, 1.0), (rho / h).clamp(0.0, 1.0))
+}
+
+/// Inverse of [`r_mu_to_uv`] (`transmittance_lut_uv_to_r_mu`).
+fn uv_to_r_mu(bottom: f32, top: f32, u: f32, v: f32) -> (f32, f32) {
+    let h = (top * top - bottom * bottom).sqrt();
+    let rho = h * v;
+    let r = (rho * rho + bottom * bottom).sqrt();
+    let d = (top - r) + u * (rho + h - (top - r));
+    let mu = if d == 0.0 {
+        1.0
+    } else {
+        (h * h - rho * rho - d * d) / (2.0 * r * d)
+    };
+    (r, mu.clamp(-1.0, 1.0))
+}
+
+fn integrate(
+    bottom_radius: f32,
+    top_radius: f32,
+    medium: &ScatteringMedium,
+    r: f32,
+    mu: f32,
+    midpoint_ratio: f32,
+) -> Vec3 {
+    if ray_intersects_ground(r, mu, bottom_radius) {
         return Vec3::ZERO;
     }
+    integrate_to_top(bottom_radius, top_radius, medium, r, mu, midpoint_ratio)
+}
 
-    let t_max = distance_to_top_atmosphere_boundary(r, mu, atmosphere.top_radius);
+/// Transmittance from `(r, mu)` to the top of the atmosphere, ignoring the
+/// ground.
+fn integrate_to_top(
+    bottom_radius: f32,
+    top_radius: f32,
+    medium: &ScatteringMedium,
+    r: f32,
+    mu: f32,
+    midpoint_ratio: f32,
+) -> Vec3 {
+    let t_max = distance_to_top_atmosphere_boundary(r, mu, top_radius);
     if t_max <= 0.0 {
         // Camera above the atmosphere looking outward — no extinction.
         return Vec3::ONE;
     }
 
-    let atm_height = atmosphere.top_radius - atmosphere.bottom_radius;
+    let atm_height = top_radius - bottom_radius;
     let inv_samples = 1.0 / SAMPLES as f32;
 
     let mut optical_depth = Vec3::ZERO;
@@ -62,7 +214,7 @@ pub fn compute_sun_transmittance(
         prev_t = t_i;
 
         let r_i = (t_i * t_i + 2.0 * r * mu * t_i + r * r).sqrt();
-        let altitude = (r_i - atmosphere.bottom_radius).max(0.0);
+        let altitude = (r_i - bottom_radius).max(0.0);
         // Bevy's `Falloff::sample` is parameterised by *depth from the top*
         // (`p = 0` → top of atmosphere → low density; `p = 1` → ground →
         // peak density). The GPU shader's `sample_density_lut` does the
@@ -123,3 +275,43 @@ fn sample_falloff(falloff: &Falloff, p: f32) -> f32 {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use bevy::{asset::Handle, math::Vec3, pbr::ScatteringMedium};
+
+    use super::{SunTransmittanceTable, compute_sun_transmittance};
+    use crate::SphericalAtmosphere;
+
+    #[test]
+    fn table_matches_direct_integration() {
+        let atmosphere = SphericalAtmosphere::earthlike(Handle::default());
+        let medium = ScatteringMedium::default();
+        let table = SunTransmittanceTable::new(&atmosphere, &medium, 0.5);
+        let height = atmosphere.top_radius - atmosphere.bottom_radius;
+        for altitude in [0.0, 2.0, 50.0, 1_000.0, 12_000.0, 0.4 * height, height] {
+            let r = atmosphere.bottom_radius + altitude;
+            // Densest just above the horizon, where sunsets are coloured.
+            for i in 0..=2000 {
+                let mu = -0.3 + 1.3 * (i as f32 / 2000.0).powi(2);
+                let direct = compute_sun_transmittance(&atmosphere, &medium, r, mu, 0.5);
+                let cached = table.sample(&medium, r, mu);
+                let error = (cached - direct).abs().max_element();
+                assert!(error < 2e-3, "{error} at altitude {altitude}, mu {mu}");
+            }
+        }
+    }
+
+    #[test]
+    fn table_keeps_the_geometric_cases_exact() {
+        let atmosphere = SphericalAtmosphere::earthlike(Handle::default());
+        let medium = ScatteringMedium::default();
+        let table = SunTransmittanceTable::new(&atmosphere, &medium, 0.5);
+        let r = atmosphere.bottom_radius + 100.0;
+        assert_eq!(table.sample(&medium, r, -0.5), Vec3::ZERO);
+        let above = atmosphere.top_radius + 1_000.0;
+        assert_eq!(table.sample(&medium, above, 0.5), Vec3::ONE);
+        assert!(table.matches(&atmosphere, 0.5));
+        assert!(!table.matches(&atmosphere, 0.3));
+    }
+}
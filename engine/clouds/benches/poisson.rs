@@ -0,0 +1,100 @@
+//! Residual against time for the climate sim's streamfunction solvers.
+//!
+//! Runs the CPU mirror of both solvers (see `veldera_clouds::poisson`) over
+//! the full climate grid on a planet-scale vorticity pattern, first printing
+//! the residual each reaches after a growing amount of work and the
+//! milliseconds it took, then timing one Jacobi sweep against one V-cycle.
+//! The GPU passes do the same work per texel; in a running client their
+//! timings show under the `cloud_poisson_jacobi` and `cloud_poisson_multigrid`
+//! render diagnostics.
+//!
+//! ```text
+//! cargo bench -p veldera_clouds --bench poisson
+//! ```
+
+use std::{hint::black_box, time::Instant};
+
+use criterion::{Criterion, criterion_group, criterion_main};
+use veldera_clouds::{
+    CLIMATE_MAP_HEIGHT, CLIMATE_MAP_WIDTH,
+    constants::POISSON_MULTIGRID_LEVELS,
+    poisson::{PoissonGrid, jacobi_sweep, residual_rms, v_cycle},
+};
+
+/// The default 1000 km deformation radius on Earth's 39 km climate texels.
+const SCREENING: f32 = (39.1 / 1000.0) * (39.1 / 1000.0);
+
+/// Smooth large-scale vorticity with a little texel-scale noise on top.
+fn vorticity() -> PoissonGrid {
+    let (width, height) = (CLIMATE_MAP_WIDTH as usize, CLIMATE_MAP_HEIGHT as usize);
+    let mut grid = PoissonGrid::zeros(width, height);
+    for y in 0..height {
+        for x in 0..width {
+            let u = x as f32 / width as f32 * std::f32::consts::TAU;
+            let v = (y as f32 + 0.5) / height as f32 * std::f32::consts::PI;
+            let noise = ((x * 7919 + y * 104_729) % 97) as f32 / 97.0 - 0.5;
+            grid.data[y * width + x] =
+                (2.0 * u).sin() * v.sin() + 0.3 * (5.0 * u).cos() * (3.0 * v).cos() + 0.1 * noise;
+        }
+    }
+    grid
+}
+
+/// Print the residual against `rhs` after every `report_every` of `steps`
+/// applications of `step`, with the time spent so far.
+fn convergence(
+    name: &str,
+    rhs: &PoissonGrid,
+    steps: usize,
+    report_every: usize,
+    step: impl Fn(&mut PoissonGrid),
+) {
+    let mut psi = PoissonGrid::zeros(rhs.width, rhs.height);
+    eprintln!(
+        "{name}: start residual {:.3e}",
+        residual_rms(&psi, rhs, SCREENING)
+    );
+    let mut spent = 0.0;
+    for i in 1..=steps {
+        let batch = Instant::now();
+        step(&mut psi);
+        spent += batch.elapsed().as_secs_f64() * 1e3;
+        if i % report_every == 0 {
+            eprintln!(
+                "{name}: {i:>4} → residual {:.3e} after {spent:>8.1} ms",
+                residual_rms(&psi, rhs, SCREENING)
+            );
+        }
+    }
+}
+
+fn bench_solvers(c: &mut Criterion) {
+    let rhs = vorticity();
+    convergence("jacobi sweeps", &rhs, 400, 100, |psi| {
+        jacobi_sweep(psi, &rhs, SCREENING);
+    });
+    convergence("multigrid V-cycles", &rhs, 4, 1, |psi| {
+        v_cycle(psi, &rhs, SCREENING, POISSON_MULTIGRID_LEVELS);
+    });
+
+    let mut group = c.benchmark_group("poisson");
+    group.sample_size(10);
+    let mut psi = PoissonGrid::zeros(rhs.width, rhs.height);
+    group.bench_function("jacobi_sweep", |b| {
+        b.iter(|| jacobi_sweep(black_box(&mut psi), &rhs, SCREENING));
+    });
+    group.bench_function("v_cycle", |b| {
+        b.iter(|| {
+            v_cycle(
+                black_box(&mut psi),
+                &rhs,
+                SCREENING,
+                POISSON_MULTIGRID_LEVELS,
+            )
+        });
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_solvers);
+criterion_main!(benches);
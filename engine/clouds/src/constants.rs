@@ -4,7 +4,8 @@
 //! WGSL shader or sizes an allocate-once GPU texture / array:
 //!
 //! - **Texture dimensions** ([`NOISE_RES`], [`CLIMATE_MAP_WIDTH`],
-//!   [`CLIMATE_MAP_HEIGHT`], [`SHADOW_MAP_SIZE`], [`NOISE_MIP_COUNT`]) size
+//!   [`CLIMATE_MAP_HEIGHT`], [`SHADOW_MAP_SIZE`], [`NOISE_MIP_COUNT`],
+//!   [`OCCUPANCY_RES`], [`OCCUPANCY_MIP_COUNT`], [`POISSON_MULTIGRID_LEVELS`]) size
 //!   textures allocated at `RenderStartup` / first-frame prepare. They are
 //!   not exposed as runtime config: the textures are created once before
 //!   any host config could load, and [`NOISE_RES`] in particular is also
@@ -37,6 +38,17 @@ pub const CLIMATE_MAP_WIDTH: u32 = 1024;
 /// Height of the climate-propensity map (latitude axis).
 pub const CLIMATE_MAP_HEIGHT: u32 = 512;
 
+/// Grids in the climate sim's multigrid Poisson solve, the climate map's
+/// own included: 1024×512 halving down to 8×4. The coarsest level is solved
+/// by a single 8×4 workgroup in `shaders/poisson_multigrid.wgsl`, so its
+/// size must stay there.
+pub const POISSON_MULTIGRID_LEVELS: u32 = 8;
+
+const _: () = assert!(
+    CLIMATE_MAP_WIDTH >> (POISSON_MULTIGRID_LEVELS - 1) == 8
+        && CLIMATE_MAP_HEIGHT >> (POISSON_MULTIGRID_LEVELS - 1) == 4
+);
+
 // ---- Noise texture -------------------------------------------------
 
 /// 3D noise texture resolution per axis. Schneider's reference uses
@@ -55,6 +67,16 @@ pub const NOISE_RES: u32 = 256;
 /// aliasing under camera motion.
 pub const NOISE_MIP_COUNT: u32 = 8;
 
+/// Occupancy volume resolution per axis at mip 0: one texel per 8³ block
+/// of noise texels. The volume bounds the cloud-shape inputs per block so
+/// the raymarch can leap samples that can't hold cloud (see
+/// `shaders/noise_occupancy.wgsl`). 32³ at `Rgba8Unorm` is 128 KB.
+pub const OCCUPANCY_RES: u32 = NOISE_RES / 8;
+
+/// Mip levels of the occupancy volume: 32, 16, 8, 4, 2. The coarsest level,
+/// dilated by a texel on every side, bounds the whole tile.
+pub const OCCUPANCY_MIP_COUNT: u32 = 5;
+
 // ---- Cloud shadow map ----------------------------------------------
 
 /// Side length of the square cloud-shadow texture, in texels.
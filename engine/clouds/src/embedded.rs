@@ -22,12 +22,14 @@ macro_rules! shader_loader {
 
 shader_loader!(noise_bake, "shaders/noise_bake.wgsl");
 shader_loader!(noise_downsample, "shaders/noise_downsample.wgsl");
+shader_loader!(noise_occupancy, "shaders/noise_occupancy.wgsl");
 shader_loader!(cloud_raymarch, "shaders/cloud_raymarch.wgsl");
 shader_loader!(cloud_temporal, "shaders/cloud_temporal.wgsl");
 shader_loader!(cloud_denoise, "shaders/cloud_denoise.wgsl");
 shader_loader!(climate_bake, "shaders/climate_bake.wgsl");
 shader_loader!(sim_step, "shaders/sim_step.wgsl");
 shader_loader!(poisson_jacobi, "shaders/poisson_jacobi.wgsl");
+shader_loader!(poisson_multigrid, "shaders/poisson_multigrid.wgsl");
 shader_loader!(cloud_shadow_bake, "shaders/cloud_shadow_bake.wgsl");
 shader_loader!(cloud_composite, "shaders/cloud_composite.wgsl");
 shader_loader!(cloud_shadow_apply, "shaders/cloud_shadow_apply.wgsl");
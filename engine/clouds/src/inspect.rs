@@ -113,7 +113,10 @@ pub struct CloudInspectData {
     /// different the inspect re-computation is bugged, or the wrong
     /// layer was picked.
     pub fh_density_recheck: f32,
-    pub _pad: [f32; 2],
+    /// Samples the march leapt over as provably empty, without
+    /// evaluating density. Counted separately from `iter_count`.
+    pub skipped_count: u32,
+    pub _pad: f32,
 }
 
 /// Inspect-cursor input, set by the client UI from egui's pointer
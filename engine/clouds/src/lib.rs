@@ -12,9 +12,12 @@
 //! and the transparent pass:
 //!
 //! - [`CloudNode::NoiseBake`]: one-shot 3D Perlin-Worley + Worley noise
-//!   bake. Becomes a no-op after the first frame.
+//!   bake, plus the coarse occupancy volume that bounds it. Becomes a no-op
+//!   after the first frame.
 //! - [`CloudNode::Raymarch`]: half-resolution multi-layer raymarch with
-//!   Wrenninge multi-scatter octaves and a 6-tap cone-shadow march.
+//!   Wrenninge multi-scatter octaves and a 6-tap cone-shadow march. Empty
+//!   samples look up the occupancy volume against the local coverage and
+//!   leap the run of steps that provably stays clear.
 //! - [`CloudNode::Temporal`]: reprojects the previous frame's history into
 //!   the current frame, neighbourhood-clamps to suppress ghosting, and
 //!   blends current with history.
@@ -31,6 +34,7 @@ mod embedded;
 pub mod inspect;
 mod node;
 mod noise;
+pub mod poisson;
 mod resources;
 mod settings;
 
@@ -72,7 +76,7 @@ use node::{
 };
 use noise::{
     NoiseBakeState, NoiseBindGroupLayout, NoiseDownsampleBindGroupLayout, NoiseDownsamplePipeline,
-    NoisePipeline, NoiseTextures,
+    NoiseOccupancyPipelines, NoisePipeline, NoiseTextures,
 };
 use resources::{
     CloudShadowBakePipeline, GpuCloudUniform, prepare_cloud_bind_groups,
@@ -107,6 +111,7 @@ impl Plugin for CloudsPlanetPlugin {
 
         embedded_asset!(app, "shaders/noise_bake.wgsl");
         embedded_asset!(app, "shaders/noise_downsample.wgsl");
+        embedded_asset!(app, "shaders/noise_occupancy.wgsl");
         embedded_asset!(app, "shaders/cloud_raymarch.wgsl");
         embedded_asset!(app, "shaders/cloud_denoise.wgsl");
         embedded_asset!(app, "shaders/cloud_temporal.wgsl");
@@ -117,6 +122,7 @@ impl Plugin for CloudsPlanetPlugin {
         embedded_asset!(app, "shaders/climate_bake.wgsl");
         embedded_asset!(app, "shaders/sim_step.wgsl");
         embedded_asset!(app, "shaders/poisson_jacobi.wgsl");
+        embedded_asset!(app, "shaders/poisson_multigrid.wgsl");
 
         app.insert_resource(self.settings)
             .init_resource::<CloudWorldTime>()
@@ -172,6 +178,7 @@ impl Plugin for CloudsPlanetPlugin {
             .init_resource::<NoiseTextures>()
             .init_resource::<NoisePipeline>()
             .init_resource::<NoiseDownsamplePipeline>()
+            .init_resource::<NoiseOccupancyPipelines>()
             .init_resource::<CloudBindGroupLayouts>()
             .init_resource::<CloudPipelines>()
             .init_resource::<CloudShadowBakePipeline>()
@@ -220,9 +227,9 @@ impl Plugin for CloudsPlanetPlugin {
                 Core3d,
                 CloudNode::SimStep,
             )
-            .add_render_graph_node::<ViewNodeRunner<node::CloudPoissonJacobiNode>>(
+            .add_render_graph_node::<ViewNodeRunner<node::CloudPoissonNode>>(
                 Core3d,
-                CloudNode::PoissonJacobi,
+                CloudNode::Poisson,
             )
             .add_render_graph_edges(
                 Core3d,
@@ -241,13 +248,14 @@ impl Plugin for CloudsPlanetPlugin {
                     // ShadowBake / Raymarch (which sample the sim
                     // state).
                     CloudNode::SimStep,
-                    // Poisson Jacobi iteration on the vorticity-
-                    // derived streamfunction. Reads the sim's
-                    // just-updated ω (G channel), writes ψ for the
-                    // NEXT frame's sim step. Runs after SimStep so
-                    // it sees the freshest ω; the streamfunction's
-                    // one-frame lag is invisible at sim time scales.
-                    CloudNode::PoissonJacobi,
+                    // Poisson solve (Jacobi sweep or multigrid
+                    // V-cycle) for the vorticity-derived
+                    // streamfunction. Reads the sim's just-updated ω
+                    // (G channel), writes ψ for the NEXT frame's sim
+                    // step. Runs after SimStep so it sees the
+                    // freshest ω; the streamfunction's one-frame lag
+                    // is invisible at sim time scales.
+                    CloudNode::Poisson,
                     // Shadow bake runs before the main opaque pass so
                     // its result is ready when shadow apply samples
                     // it later.
@@ -648,6 +656,13 @@ pub struct CloudLayers {
     /// history blend and visible noise *increases*. Pick one source
     /// of per-frame decorrelation, not both.
     pub raymarch_jitter_temporal_rotation: bool,
+    /// Leap runs of primary-march samples that the occupancy volume and
+    /// the local coverage show can't hold cloud, instead of evaluating
+    /// density at each. Same image up to
+    /// [`CloudPlanetSettings::empty_space_coverage_margin`]; fewer samples
+    /// wherever the sky is clear. Enabled by default.
+    #[cfg_attr(feature = "serde", serde(default = "default_true"))]
+    pub empty_space_skipping: bool,
     /// Edge-avoiding A-Trous wavelet denoise pass. Spatial counterpart
     /// to the temporal pass — smooths the per-pixel stochastic noise
     /// from the raymarch's `t_first` jitter.
@@ -797,6 +812,35 @@ pub struct ClimateSimSettings {
     /// accumulated forcing would drive ω to infinity. Real GCMs use
     /// ~1 day for momentum damping; we use a similar default.
     pub vorticity_damping_seconds: f32,
+    /// How the streamfunction ψ is solved from ω each frame. See
+    /// [`PoissonSolver`].
+    pub poisson_solver: PoissonSolver,
+    /// V-cycles per frame for [`PoissonSolver::Multigrid`], at least
+    /// one. Each cuts the residual about eightfold; one a frame keeps
+    /// pace with the sim, more catch up faster after a reinit.
+    pub multigrid_cycles: u32,
+    /// Rossby radius of deformation, km: the range over which a
+    /// vorticity anomaly steers the flow around it. Screens the
+    /// Poisson solve (see [`crate::poisson`]) so a lone anomaly's
+    /// influence falls off past it instead of reaching round the
+    /// planet. Earth's mid-latitudes sit near 1000 km; 0 (or anything
+    /// past the planet's radius) means the planet's radius.
+    pub deformation_radius_km: f32,
+}
+
+/// Solver for the climate sim's streamfunction Poisson equation.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+pub enum PoissonSolver {
+    /// One Jacobi sweep per frame. Cheapest per frame, but planet-scale
+    /// flow takes minutes of real time to converge, so ψ lags ω.
+    Jacobi,
+    /// [`ClimateSimSettings::multigrid_cycles`] multigrid V-cycles per
+    /// frame: smooth, restrict and prolong over the climate grid and
+    /// seven halvings of it. About nine Jacobi sweeps' worth of GPU
+    /// time per cycle; converges every scale within a frame or two.
+    #[default]
+    Multigrid,
 }
 
 /// Tunable knobs for the additive volumetric god-rays pass.
@@ -853,6 +897,7 @@ impl CloudLayers {
             primary_step_world_m: 800.0,
             density_band_half_width: 0.1,
             raymarch_jitter_temporal_rotation: true,
+            empty_space_skipping: true,
             denoise: true,
             denoise_iterations: 1,
             denoise_sigma_transmittance: 0.1,
@@ -880,6 +925,7 @@ impl CloudLayers {
             primary_step_world_m: 800.0,
             density_band_half_width: 0.1,
             raymarch_jitter_temporal_rotation: true,
+            empty_space_skipping: true,
             denoise: true,
             denoise_iterations: 1,
             denoise_sigma_transmittance: 0.1,
@@ -913,6 +959,7 @@ impl CloudLayers {
             primary_step_world_m: 800.0,
             density_band_half_width: 0.1,
             raymarch_jitter_temporal_rotation: true,
+            empty_space_skipping: true,
             denoise: true,
             denoise_iterations: 1,
             denoise_sigma_transmittance: 0.1,
@@ -989,6 +1036,10 @@ pub enum CloudDebugMode {
     /// [`CloudShadowBakeDiag::HashGrid`] to see exactly which bake
     /// content each pixel reads.
     ShadowUv = 12,
+    /// Primary-march work per pixel: R = density samples evaluated, G =
+    /// samples leapt by empty-space skipping, each as a fraction of 128.
+    /// Shows where the occupancy volume pays off and where it can't.
+    Steps = 13,
 }
 
 /// Diagnostic override for the cloud-shadow bake pass. When set to
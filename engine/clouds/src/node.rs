@@ -8,7 +8,10 @@ use bevy::{
         diagnostic::RecordDiagnostics,
         extract_component::DynamicUniformIndex,
         render_graph::{NodeRunError, RenderGraphContext, RenderLabel, ViewNode},
-        render_resource::{ComputePassDescriptor, PipelineCache, RenderPassDescriptor},
+        render_resource::{
+            BindGroup, ComputePass, ComputePassDescriptor, ComputePipeline, PipelineCache,
+            RenderPassDescriptor,
+        },
         renderer::RenderContext,
         view::{ViewTarget, ViewUniformOffset},
     },
@@ -18,7 +21,7 @@ use tracing::info;
 use veldera_atmosphere::AtmosphereTransformsOffset;
 
 use crate::{
-    CloudLayers,
+    CloudLayers, PoissonSolver,
     constants::SHADOW_MAP_SIZE,
     resources::{
         CloudBindGroups, CloudPipelines, CloudRenderPipelineIds, CloudShadowBakePipeline,
@@ -64,12 +67,13 @@ pub enum CloudNode {
     /// forcing target, before ShadowBake/Raymarch so they sample the
     /// updated sim state.
     SimStep,
-    /// One Jacobi iteration of the Poisson solve for the streamfunction
-    /// ψ that backs the vorticity-driven wind perturbation. Runs
-    /// AFTER SimStep — reads the just-updated vorticity in sim state
-    /// G channel, writes the new ψ for the next frame's sim step to
-    /// sample.
-    PoissonJacobi,
+    /// Poisson solve for the streamfunction ψ that backs the
+    /// vorticity-driven wind perturbation: one Jacobi iteration or
+    /// multigrid V-cycles, per [`crate::ClimateSimSettings::poisson_solver`].
+    /// Runs AFTER SimStep — reads the just-updated vorticity in sim
+    /// state G channel, writes the new ψ for the next frame's sim step
+    /// to sample.
+    Poisson,
 }
 
 #[derive(Default)]
@@ -662,13 +666,16 @@ impl ViewNode for CloudSimStepNode {
 }
 
 static POISSON_LOGGED: AtomicBool = AtomicBool::new(false);
+static MULTIGRID_LOGGED: AtomicBool = AtomicBool::new(false);
 
-/// One Jacobi iteration of the streamfunction Poisson solve. Skipped
-/// silently if the sim's bind groups aren't ready.
+/// The streamfunction Poisson solve, with whichever solver the sim
+/// settings pick. Skipped silently if its bind groups or pipelines
+/// aren't ready; the multigrid solve's are missing for the frame it's
+/// first selected, while its scratch textures are allocated.
 #[derive(Default)]
-pub(super) struct CloudPoissonJacobiNode;
+pub(super) struct CloudPoissonNode;
 
-impl ViewNode for CloudPoissonJacobiNode {
+impl ViewNode for CloudPoissonNode {
     type ViewQuery = (
         Read<CloudLayers>,
         Read<CloudBindGroups>,
@@ -679,41 +686,162 @@ impl ViewNode for CloudPoissonJacobiNode {
         &self,
         _graph: &mut RenderGraphContext,
         render_context: &mut RenderContext,
-        (_layer, bind_groups, cloud_offset): QueryItem<Self::ViewQuery>,
+        (layer, bind_groups, cloud_offset): QueryItem<Self::ViewQuery>,
         world: &World,
     ) -> Result<(), NodeRunError> {
-        let Some(bind_group) = bind_groups.poisson_jacobi.as_ref() else {
-            return Ok(());
-        };
-        let pipelines = world.resource::<CloudPipelines>();
-        let pipeline_cache = world.resource::<PipelineCache>();
-        let Some(pipeline) = pipeline_cache.get_compute_pipeline(pipelines.poisson_jacobi) else {
-            return Ok(());
-        };
+        match layer.sim.poisson_solver {
+            PoissonSolver::Jacobi => {
+                run_poisson_jacobi(render_context, bind_groups, cloud_offset, world)
+            }
+            PoissonSolver::Multigrid => run_poisson_multigrid(
+                render_context,
+                bind_groups,
+                cloud_offset,
+                layer.sim.multigrid_cycles.max(1),
+                world,
+            ),
+        }
+        Ok(())
+    }
+}
 
-        let diagnostics = render_context.diagnostic_recorder();
-        let mut pass =
-            render_context
-                .command_encoder()
-                .begin_compute_pass(&ComputePassDescriptor {
-                    label: Some("cloud_poisson_jacobi"),
-                    timestamp_writes: None,
-                });
-        let span = diagnostics.pass_span(&mut pass, "cloud_poisson_jacobi");
-        pass.set_pipeline(pipeline);
-        pass.set_bind_group(0, bind_group, &[cloud_offset.index()]);
+const POISSON_WORKGROUP_SIZE: u32 = 8;
+
+/// One Jacobi iteration over the climate grid.
+fn run_poisson_jacobi(
+    render_context: &mut RenderContext,
+    bind_groups: &CloudBindGroups,
+    cloud_offset: &DynamicUniformIndex<GpuCloudUniform>,
+    world: &World,
+) {
+    let Some(bind_group) = bind_groups.poisson_jacobi.as_ref() else {
+        return;
+    };
+    let pipelines = world.resource::<CloudPipelines>();
+    let pipeline_cache = world.resource::<PipelineCache>();
+    let Some(pipeline) = pipeline_cache.get_compute_pipeline(pipelines.poisson_jacobi) else {
+        return;
+    };
+
+    let diagnostics = render_context.diagnostic_recorder();
+    let mut pass = render_context
+        .command_encoder()
+        .begin_compute_pass(&ComputePassDescriptor {
+            label: Some("cloud_poisson_jacobi"),
+            timestamp_writes: None,
+        });
+    let span = diagnostics.pass_span(&mut pass, "cloud_poisson_jacobi");
+    pass.set_pipeline(pipeline);
+    pass.set_bind_group(0, bind_group, &[cloud_offset.index()]);
+
+    let groups_x = crate::CLIMATE_MAP_WIDTH.div_ceil(POISSON_WORKGROUP_SIZE);
+    let groups_y = crate::CLIMATE_MAP_HEIGHT.div_ceil(POISSON_WORKGROUP_SIZE);
+    pass.dispatch_workgroups(groups_x, groups_y, 1);
+    if !POISSON_LOGGED.swap(true, Ordering::Relaxed) {
+        info!(
+            "cloud poisson jacobi first dispatch ({}×{} workgroups)",
+            groups_x, groups_y
+        );
+    }
+    span.end(&mut pass);
+}
 
-        const WORKGROUP_SIZE: u32 = 8;
-        let groups_x = crate::CLIMATE_MAP_WIDTH.div_ceil(WORKGROUP_SIZE);
-        let groups_y = crate::CLIMATE_MAP_HEIGHT.div_ceil(WORKGROUP_SIZE);
-        pass.dispatch_workgroups(groups_x, groups_y, 1);
-        if !POISSON_LOGGED.swap(true, Ordering::Relaxed) {
-            info!(
-                "cloud poisson jacobi first dispatch ({}×{} workgroups)",
-                groups_x, groups_y
-            );
+/// `cycles` multigrid V-cycles, warm-started from last frame's ψ. The
+/// dispatch order is laid out in `shaders/poisson_multigrid.wgsl`.
+fn run_poisson_multigrid(
+    render_context: &mut RenderContext,
+    bind_groups: &CloudBindGroups,
+    cloud_offset: &DynamicUniformIndex<GpuCloudUniform>,
+    cycles: u32,
+    world: &World,
+) {
+    let Some(groups) = bind_groups.poisson_multigrid.as_ref() else {
+        return;
+    };
+    let ids = &world.resource::<CloudPipelines>().poisson_multigrid;
+    let pipeline_cache = world.resource::<PipelineCache>();
+    let get = |id| pipeline_cache.get_compute_pipeline(id);
+    let (
+        Some(load_fine),
+        Some(smooth),
+        Some(smooth_from_zero),
+        Some(restrict),
+        Some(prolong),
+        Some(coarse_solve),
+        Some(store_fine),
+    ) = (
+        get(ids.load_fine),
+        get(ids.smooth_level),
+        get(ids.smooth_level_from_zero),
+        get(ids.restrict_residual),
+        get(ids.prolong_correct),
+        get(ids.coarse_solve),
+        get(ids.store_fine),
+    )
+    else {
+        return;
+    };
+
+    let diagnostics = render_context.diagnostic_recorder();
+    let mut pass = render_context
+        .command_encoder()
+        .begin_compute_pass(&ComputePassDescriptor {
+            label: Some("cloud_poisson_multigrid"),
+            timestamp_writes: None,
+        });
+    let span = diagnostics.pass_span(&mut pass, "cloud_poisson_multigrid");
+    let offsets = [cloud_offset.index()];
+    let mut dispatches = 0;
+    let mut dispatch = |pass: &mut ComputePass,
+                        pipeline: &ComputePipeline,
+                        bind_group: &BindGroup,
+                        level: usize| {
+        let (width, height) = (
+            crate::CLIMATE_MAP_WIDTH >> level,
+            crate::CLIMATE_MAP_HEIGHT >> level,
+        );
+        pass.set_pipeline(pipeline);
+        pass.set_bind_group(0, bind_group, &offsets);
+        pass.dispatch_workgroups(
+            width.div_ceil(POISSON_WORKGROUP_SIZE),
+            height.div_ceil(POISSON_WORKGROUP_SIZE),
+            1,
+        );
+        dispatches += 1;
+    };
+
+    dispatch(&mut pass, load_fine, &groups.load, 0);
+    let coarsest = groups.levels.len() - 1;
+    for _ in 0..cycles {
+        for (l, level) in groups.levels[..coarsest].iter().enumerate() {
+            if l == 0 {
+                dispatch(&mut pass, smooth, &level.smooth_to_psi_0, l);
+            } else {
+                dispatch(&mut pass, smooth_from_zero, &level.smooth_to_psi_0, l);
+            }
+            dispatch(&mut pass, smooth, &level.smooth_to_psi_1, l);
+            if let Some(restrict_group) = &level.restrict {
+                dispatch(&mut pass, restrict, restrict_group, l + 1);
+            }
         }
-        span.end(&mut pass);
-        Ok(())
+        // The coarsest level is a single workgroup.
+        pass.set_pipeline(coarse_solve);
+        pass.set_bind_group(0, &groups.levels[coarsest].smooth_to_psi_1, &offsets);
+        pass.dispatch_workgroups(1, 1, 1);
+        for (l, level) in groups.levels[..coarsest].iter().enumerate().rev() {
+            if let Some(prolong_group) = &level.prolong {
+                dispatch(&mut pass, prolong, prolong_group, l);
+            }
+            dispatch(&mut pass, smooth, &level.smooth_to_psi_1, l);
+        }
+    }
+    dispatch(&mut pass, store_fine, &groups.store, 0);
+    if !MULTIGRID_LOGGED.swap(true, Ordering::Relaxed) {
+        info!(
+            "cloud poisson multigrid first solve ({cycles} V-cycle(s), {} levels, {} dispatches)",
+            groups.levels.len(),
+            dispatches + cycles,
+        );
     }
+    span.end(&mut pass);
 }
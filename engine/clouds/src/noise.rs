@@ -15,6 +15,12 @@
 //! representation of the cloud field instead of point-sampling and
 //! aliasing under camera motion.
 //!
+//! Last, two reduction passes build the occupancy volume: an
+//! [`OCCUPANCY_RES`]³ texture with [`OCCUPANCY_MIP_COUNT`] mips bounding
+//! the cloud-shape inputs per block of noise (see
+//! `shaders/noise_occupancy.wgsl`). The raymarch reads it to leap runs of
+//! samples that can't hold cloud at the local coverage.
+//!
 //! The bake is one-shot: [`NoiseBakeState::done`] flips to `true` after
 //! the first dispatch chain and the node becomes a no-op on subsequent
 //! frames.
@@ -36,31 +42,39 @@ use bevy::{
 };
 use tracing::info;
 
-pub use crate::constants::{NOISE_MIP_COUNT, NOISE_RES};
+pub use crate::constants::{NOISE_MIP_COUNT, NOISE_RES, OCCUPANCY_MIP_COUNT, OCCUPANCY_RES};
 
 /// Workgroup size for the noise compute shaders. Total invocations
 /// per dispatch are `(NOISE_RES / WORKGROUP_SIZE)^3`. 4×4×4 = 64
 /// threads/group is a safe portable choice across desktop and
-/// WebGPU. Must match `@workgroup_size` in `noise_bake.wgsl` and
-/// `noise_downsample.wgsl`.
+/// WebGPU. Must match `@workgroup_size` in `noise_bake.wgsl`,
+/// `noise_downsample.wgsl` and `noise_occupancy.wgsl`.
 pub const NOISE_WORKGROUP_SIZE: u32 = 4;
 
 /// Resource that owns the baked 3D noise texture and its views.
 ///
 /// `view` is the all-mips sampled view bound by the runtime cloud
 /// shaders; `mip_views` are per-mip storage views used by the bake
-/// (mip 0) and downsample (mip 1..N) compute dispatches.
+/// (mip 0) and downsample (mip 1..N) compute dispatches. The
+/// `occupancy_*` fields are the same for the occupancy volume.
 #[derive(Resource, Default)]
 pub struct NoiseTextures {
     pub texture: Option<Texture>,
     pub view: Option<TextureView>,
     pub mip_views: Vec<TextureView>,
+    pub occupancy_texture: Option<Texture>,
+    pub occupancy_view: Option<TextureView>,
+    pub occupancy_mip_views: Vec<TextureView>,
 }
 
 impl NoiseTextures {
     pub fn view(&self) -> Option<&TextureView> {
         self.view.as_ref()
     }
+
+    pub fn occupancy_view(&self) -> Option<&TextureView> {
+        self.occupancy_view.as_ref()
+    }
 }
 
 /// Tracks whether the one-shot noise bake has run. Uses an atomic flag so
@@ -181,17 +195,54 @@ impl FromWorld for NoiseDownsamplePipeline {
     }
 }
 
-/// Allocates the `NOISE_RES`³ `Rgba8Unorm` storage texture with
-/// [`NOISE_MIP_COUNT`] mip levels and the per-mip + all-mips views.
-pub fn create_noise_textures(
-    mut textures: ResMut<NoiseTextures>,
-    render_device: Res<RenderDevice>,
-) {
-    let size = UVec3::splat(NOISE_RES).to_extents();
+/// Cached occupancy-volume compute pipelines: `reduce_noise` fills mip 0
+/// from the noise, `reduce_mip` each coarser mip from the one below. Both
+/// share the downsample bind-group layout (read one level, write another).
+#[derive(Resource)]
+pub struct NoiseOccupancyPipelines {
+    pub reduce_noise: CachedComputePipelineId,
+    pub reduce_mip: CachedComputePipelineId,
+}
+
+impl FromWorld for NoiseOccupancyPipelines {
+    fn from_world(world: &mut World) -> Self {
+        let pipeline_cache = world.resource::<PipelineCache>();
+        let layout = world
+            .resource::<NoiseDownsampleBindGroupLayout>()
+            .layout
+            .clone();
+        let shader = crate::embedded::noise_occupancy(world.resource());
+        let queue = |label: &'static str, entry_point: &'static str| {
+            pipeline_cache.queue_compute_pipeline(ComputePipelineDescriptor {
+                label: Some(label.into()),
+                layout: vec![layout.clone()],
+                shader: shader.clone(),
+                entry_point: Some(entry_point.into()),
+                ..Default::default()
+            })
+        };
+        Self {
+            reduce_noise: queue(
+                "cloud_noise_occupancy_reduce_noise_pipeline",
+                "reduce_noise",
+            ),
+            reduce_mip: queue("cloud_noise_occupancy_reduce_mip_pipeline", "reduce_mip"),
+        }
+    }
+}
+
+/// A 3D `Rgba8Unorm` storage texture with `mip_count` mips, plus its
+/// all-mips sampled view and per-mip storage views.
+fn create_mipped_volume(
+    render_device: &RenderDevice,
+    label: &'static str,
+    res: u32,
+    mip_count: u32,
+) -> (Texture, TextureView, Vec<TextureView>) {
     let texture = render_device.create_texture(&TextureDescriptor {
-        label: Some("cloud_noise_3d"),
-        size,
-        mip_level_count: NOISE_MIP_COUNT,
+        label: Some(label),
+        size: UVec3::splat(res).to_extents(),
+        mip_level_count: mip_count,
         sample_count: 1,
         dimension: TextureDimension::D3,
         format: TextureFormat::Rgba8Unorm,
@@ -199,28 +250,54 @@ pub fn create_noise_textures(
         view_formats: &[],
     });
     let view = texture.create_view(&TextureViewDescriptor {
-        label: Some("cloud_noise_3d_view"),
+        label: Some(&format!("{label}_view")),
         format: Some(TextureFormat::Rgba8Unorm),
         dimension: Some(TextureViewDimension::D3),
         base_mip_level: 0,
-        mip_level_count: Some(NOISE_MIP_COUNT),
+        mip_level_count: Some(mip_count),
         ..Default::default()
     });
-    let mut mip_views = Vec::with_capacity(NOISE_MIP_COUNT as usize);
-    for mip in 0..NOISE_MIP_COUNT {
-        mip_views.push(texture.create_view(&TextureViewDescriptor {
-            label: Some("cloud_noise_3d_mip_view"),
-            format: Some(TextureFormat::Rgba8Unorm),
-            dimension: Some(TextureViewDimension::D3),
-            base_mip_level: mip,
-            mip_level_count: Some(1),
-            ..Default::default()
-        }));
-    }
+    let mip_views = (0..mip_count)
+        .map(|mip| {
+            texture.create_view(&TextureViewDescriptor {
+                label: Some(&format!("{label}_mip_view")),
+                format: Some(TextureFormat::Rgba8Unorm),
+                dimension: Some(TextureViewDimension::D3),
+                base_mip_level: mip,
+                mip_level_count: Some(1),
+                ..Default::default()
+            })
+        })
+        .collect();
+    (texture, view, mip_views)
+}
+
+/// Allocates the `NOISE_RES`³ `Rgba8Unorm` storage texture with
+/// [`NOISE_MIP_COUNT`] mip levels and the per-mip + all-mips views, and the
+/// `OCCUPANCY_RES`³ occupancy volume alongside it.
+pub fn create_noise_textures(
+    mut textures: ResMut<NoiseTextures>,
+    render_device: Res<RenderDevice>,
+) {
+    let (texture, view, mip_views) =
+        create_mipped_volume(&render_device, "cloud_noise_3d", NOISE_RES, NOISE_MIP_COUNT);
     textures.texture = Some(texture);
     textures.view = Some(view);
     textures.mip_views = mip_views;
-    info!("cloud noise 3D texture allocated ({NOISE_RES}³, {NOISE_MIP_COUNT} mips)");
+
+    let (texture, view, mip_views) = create_mipped_volume(
+        &render_device,
+        "cloud_noise_occupancy",
+        OCCUPANCY_RES,
+        OCCUPANCY_MIP_COUNT,
+    );
+    textures.occupancy_texture = Some(texture);
+    textures.occupancy_view = Some(view);
+    textures.occupancy_mip_views = mip_views;
+    info!(
+        "cloud noise 3D texture allocated ({NOISE_RES}³, {NOISE_MIP_COUNT} mips; \
+         occupancy {OCCUPANCY_RES}³, {OCCUPANCY_MIP_COUNT} mips)"
+    );
 }
 
 /// Render-graph node that runs the one-shot noise bake + mip downsample chain.
@@ -229,6 +306,8 @@ pub fn create_noise_textures(
 /// 1. Dispatches `noise_bake.wgsl` to write mip 0 at full resolution.
 /// 2. For each subsequent mip 1..N-1, dispatches `noise_downsample.wgsl`
 ///    reading mip i-1 and writing mip i (2×2×2 box filter).
+/// 3. Dispatches `noise_occupancy.wgsl` to reduce noise mip 0 into
+///    occupancy mip 0, then each occupancy mip into the next.
 ///
 /// Subsequent frames are a cheap no-op via [`NoiseBakeState::done`].
 #[derive(Default)]
@@ -248,18 +327,23 @@ impl Node for NoiseBakeNode {
 
         let bake_pipeline = world.resource::<NoisePipeline>();
         let downsample_pipeline = world.resource::<NoiseDownsamplePipeline>();
+        let occupancy_pipelines = world.resource::<NoiseOccupancyPipelines>();
         let pipeline_cache = world.resource::<PipelineCache>();
         let bake_layout = world.resource::<NoiseBindGroupLayout>();
         let downsample_layout = world.resource::<NoiseDownsampleBindGroupLayout>();
         let textures = world.resource::<NoiseTextures>();
 
-        let (Some(bake_compute), Some(downsample_compute)) = (
+        let (Some(bake_compute), Some(downsample_compute), Some(reduce_noise), Some(reduce_mip)) = (
             pipeline_cache.get_compute_pipeline(bake_pipeline.pipeline),
             pipeline_cache.get_compute_pipeline(downsample_pipeline.pipeline),
+            pipeline_cache.get_compute_pipeline(occupancy_pipelines.reduce_noise),
+            pipeline_cache.get_compute_pipeline(occupancy_pipelines.reduce_mip),
         ) else {
             return Ok(());
         };
-        if textures.mip_views.len() != NOISE_MIP_COUNT as usize {
+        if textures.mip_views.len() != NOISE_MIP_COUNT as usize
+            || textures.occupancy_mip_views.len() != OCCUPANCY_MIP_COUNT as usize
+        {
             return Ok(());
         }
 
@@ -315,6 +399,41 @@ impl Node for NoiseBakeNode {
             span.end(&mut pass);
         }
 
+        // Occupancy mip 0 reduces noise mip 0; each coarser mip reduces the
+        // occupancy mip below it.
+        for mip in 0..OCCUPANCY_MIP_COUNT {
+            let (source, pipeline) = if mip == 0 {
+                (&textures.mip_views[0], reduce_noise)
+            } else {
+                (
+                    &textures.occupancy_mip_views[(mip - 1) as usize],
+                    reduce_mip,
+                )
+            };
+            let bind_group = render_device.create_bind_group(
+                "cloud_noise_occupancy_bind_group",
+                &pipeline_cache.get_bind_group_layout(&downsample_layout.layout),
+                &BindGroupEntries::with_indices((
+                    (0, source),
+                    (1, &textures.occupancy_mip_views[mip as usize]),
+                )),
+            );
+            let mut pass =
+                render_context
+                    .command_encoder()
+                    .begin_compute_pass(&ComputePassDescriptor {
+                        label: Some("cloud_noise_occupancy"),
+                        timestamp_writes: None,
+                    });
+            let span = diagnostics.pass_span(&mut pass, "cloud_noise_occupancy");
+            pass.set_pipeline(pipeline);
+            pass.set_bind_group(0, &bind_group, &[]);
+            let mip_res = (OCCUPANCY_RES >> mip).max(1);
+            let groups = mip_res.div_ceil(NOISE_WORKGROUP_SIZE).max(1);
+            pass.dispatch_workgroups(groups, groups, groups);
+            span.end(&mut pass);
+        }
+
         bake_state.mark_done();
         info!("cloud noise bake + mip chain dispatched ({NOISE_MIP_COUNT} mips)");
         Ok(())
@@ -0,0 +1,225 @@
+//! CPU mirror of the climate sim's streamfunction solve.
+//!
+//! Every frame the sim inverts its vorticity ω into a streamfunction ψ by
+//! solving the screened Poisson equation
+//!
+//! ```text
+//! (4 + ε)·ψ[i,j] − ψ[i−1,j] − ψ[i+1,j] − ψ[i,j−1] − ψ[i,j+1] = ω[i,j]
+//! ```
+//!
+//! on the climate grid, in texel units, wrapping in longitude and reflecting
+//! at the poles. ε is `(texel / deformation radius)²`: it screens ω's
+//! influence beyond the Rossby radius and keeps the problem well posed (the
+//! unscreened operator has every constant ψ in its null space).
+//!
+//! Two solvers run it on the GPU, picked by
+//! [`ClimateSimSettings::poisson_solver`](crate::ClimateSimSettings::poisson_solver):
+//! one Jacobi sweep per frame (`shaders/poisson_jacobi.wgsl`), or a multigrid
+//! V-cycle (`shaders/poisson_multigrid.wgsl`). Jacobi damps an error mode by
+//! a factor set by its wavelength in texels, so the planet-scale modes that
+//! carry most of the flow take thousands of sweeps; the V-cycle smooths each
+//! wavelength on the grid where it is a few texels long, and costs about
+//! seven fine-grid passes.
+//!
+//! This module runs the same discretisation, smoother and transfer operators
+//! on the CPU, so the solvers' convergence can be tested and benchmarked
+//! without a GPU (`benches/poisson.rs`). Keep it in step with the shaders.
+
+/// Weight of the damped-Jacobi smoother inside the V-cycle. 4/5 damps the
+/// upper half of the spectrum fastest for the 5-point stencil.
+pub const SMOOTH_WEIGHT: f32 = 0.8;
+
+/// Smoothing sweeps per level on the way down the V-cycle.
+pub const PRE_SMOOTH_SWEEPS: u32 = 2;
+
+/// Smoothing sweeps per level on the way back up.
+pub const POST_SMOOTH_SWEEPS: u32 = 1;
+
+/// Damped-Jacobi sweeps of the coarsest level's direct-enough solve. The
+/// coarse operator is strongly diagonal (ε grows 4× per level), so this
+/// converges far past what the finer levels can resolve.
+pub const COARSE_SWEEPS: u32 = 32;
+
+/// ε for texels `texel_m` wide on a planet `circumference_m` around. The
+/// deformation radius is capped at the planet's radius, which a radius of 0
+/// or less also stands for: the largest modes always stay a little screened,
+/// so the solve stays well posed.
+#[must_use]
+pub fn screening(texel_m: f32, circumference_m: f32, deformation_radius_km: f32) -> f32 {
+    let planet_radius_m = circumference_m / std::f32::consts::TAU;
+    let radius_m = if deformation_radius_km > 0.0 {
+        (deformation_radius_km * 1000.0).min(planet_radius_m)
+    } else {
+        planet_radius_m
+    };
+    (texel_m / radius_m.max(texel_m)).powi(2)
+}
+
+/// A scalar field over the climate grid (or one of its coarser levels).
+#[derive(Clone, Debug, PartialEq)]
+pub struct PoissonGrid {
+    pub width: usize,
+    pub height: usize,
+    pub data: Vec<f32>,
+}
+
+impl PoissonGrid {
+    #[must_use]
+    pub fn zeros(width: usize, height: usize) -> Self {
+        Self {
+            width,
+            height,
+            data: vec![0.0; width * height],
+        }
+    }
+
+    /// Value at `(x, y)`, wrapping `x` and clamping `y` like the shaders.
+    #[must_use]
+    pub fn at(&self, x: isize, y: isize) -> f32 {
+        let x = x.rem_euclid(self.width as isize) as usize;
+        let y = y.clamp(0, self.height as isize - 1) as usize;
+        self.data[y * self.width + x]
+    }
+
+    fn neighbours(&self, x: isize, y: isize) -> f32 {
+        self.at(x - 1, y) + self.at(x + 1, y) + self.at(x, y - 1) + self.at(x, y + 1)
+    }
+
+    fn map(&self, f: impl Fn(isize, isize) -> f32) -> Self {
+        let mut data = Vec::with_capacity(self.data.len());
+        for y in 0..self.height as isize {
+            for x in 0..self.width as isize {
+                data.push(f(x, y));
+            }
+        }
+        Self { data, ..*self }
+    }
+}
+
+/// Root-mean-square residual `ω − Aψ` of `psi` against `rhs`.
+#[must_use]
+pub fn residual_rms(psi: &PoissonGrid, rhs: &PoissonGrid, screening: f32) -> f32 {
+    let residual = residual(psi, rhs, screening);
+    let sum: f64 = residual.data.iter().map(|r| f64::from(*r).powi(2)).sum();
+    (sum / residual.data.len() as f64).sqrt() as f32
+}
+
+fn residual(psi: &PoissonGrid, rhs: &PoissonGrid, screening: f32) -> PoissonGrid {
+    psi.map(|x, y| rhs.at(x, y) - ((4.0 + screening) * psi.at(x, y) - psi.neighbours(x, y)))
+}
+
+/// One sweep of `poisson_jacobi.wgsl`.
+pub fn jacobi_sweep(psi: &mut PoissonGrid, rhs: &PoissonGrid, screening: f32) {
+    *psi = psi.map(|x, y| (psi.neighbours(x, y) + rhs.at(x, y)) / (4.0 + screening));
+}
+
+/// One damped-Jacobi sweep of the V-cycle (`smooth_level`).
+fn smooth(psi: &mut PoissonGrid, rhs: &PoissonGrid, screening: f32) {
+    *psi = psi.map(|x, y| {
+        let jacobi = (psi.neighbours(x, y) + rhs.at(x, y)) / (4.0 + screening);
+        psi.at(x, y) + SMOOTH_WEIGHT * (jacobi - psi.at(x, y))
+    });
+}
+
+/// The next level's right-hand side: the 2×2-averaged residual, times 4 to
+/// rescale the stencil to the coarse texel spacing (`restrict_residual`).
+fn restrict(psi: &PoissonGrid, rhs: &PoissonGrid, screening: f32) -> PoissonGrid {
+    let residual = residual(psi, rhs, screening);
+    PoissonGrid::zeros(psi.width / 2, psi.height / 2).map(|x, y| {
+        residual.at(2 * x, 2 * y)
+            + residual.at(2 * x + 1, 2 * y)
+            + residual.at(2 * x, 2 * y + 1)
+            + residual.at(2 * x + 1, 2 * y + 1)
+    })
+}
+
+/// `psi` plus the bilinearly interpolated coarse correction
+/// (`prolong_correct`).
+fn prolong(psi: &mut PoissonGrid, coarse: &PoissonGrid) {
+    *psi = psi.map(|x, y| {
+        // A fine texel's centre sits a quarter coarse texel off the centre
+        // of the coarse texel holding it, towards its nearest neighbour.
+        let (cx, cy) = (x.div_euclid(2), y.div_euclid(2));
+        let (nx, ny) = (cx + 2 * x.rem_euclid(2) - 1, cy + 2 * y.rem_euclid(2) - 1);
+        let near = 0.75 * coarse.at(cx, cy) + 0.25 * coarse.at(nx, cy);
+        let far = 0.75 * coarse.at(cx, ny) + 0.25 * coarse.at(nx, ny);
+        psi.at(x, y) + 0.75 * near + 0.25 * far
+    });
+}
+
+/// One multigrid V-cycle over `levels` grids, the finest `psi`'s own, on
+/// `psi` in place. Each level halves both sides, so the finest side lengths
+/// must divide by `2^(levels − 1)`.
+pub fn v_cycle(psi: &mut PoissonGrid, rhs: &PoissonGrid, screening: f32, levels: u32) {
+    if levels <= 1 {
+        for _ in 0..COARSE_SWEEPS {
+            smooth(psi, rhs, screening);
+        }
+        return;
+    }
+    for _ in 0..PRE_SMOOTH_SWEEPS {
+        smooth(psi, rhs, screening);
+    }
+    let coarse_rhs = restrict(psi, rhs, screening);
+    let mut correction = PoissonGrid::zeros(coarse_rhs.width, coarse_rhs.height);
+    v_cycle(&mut correction, &coarse_rhs, screening * 4.0, levels - 1);
+    prolong(psi, &correction);
+    for _ in 0..POST_SMOOTH_SWEEPS {
+        smooth(psi, rhs, screening);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A smooth, planet-scale vorticity pattern: the hard case for Jacobi.
+    fn planetary_rhs(width: usize, height: usize) -> PoissonGrid {
+        PoissonGrid::zeros(width, height).map(|x, y| {
+            let u = x as f32 / width as f32 * std::f32::consts::TAU;
+            let v = (y as f32 + 0.5) / height as f32 * std::f32::consts::PI;
+            (2.0 * u).sin() * v.sin() + 0.3 * (5.0 * u).cos() * (3.0 * v).cos()
+        })
+    }
+
+    #[test]
+    fn v_cycle_outpaces_jacobi_per_fine_pass() {
+        let (width, height, screening) = (128, 64, 1e-3);
+        let rhs = planetary_rhs(width, height);
+        let start = residual_rms(&PoissonGrid::zeros(width, height), &rhs, screening);
+
+        // Three V-cycles cost about as much as twenty fine-grid sweeps.
+        let mut multigrid = PoissonGrid::zeros(width, height);
+        for _ in 0..3 {
+            v_cycle(&mut multigrid, &rhs, screening, 5);
+        }
+        let mut jacobi = PoissonGrid::zeros(width, height);
+        for _ in 0..20 {
+            jacobi_sweep(&mut jacobi, &rhs, screening);
+        }
+        let multigrid = residual_rms(&multigrid, &rhs, screening);
+        let jacobi = residual_rms(&jacobi, &rhs, screening);
+        assert!(multigrid < start * 1e-2, "{multigrid} vs {start}");
+        assert!(multigrid * 10.0 < jacobi, "{multigrid} vs {jacobi}");
+    }
+
+    #[test]
+    fn screening_is_capped_at_the_planet_radius() {
+        let (texel, circumference) = (40_000.0, 40_000_000.0);
+        assert!((screening(texel, circumference, 1000.0) - 0.04f32.powi(2)).abs() < 1e-7);
+        let planet = screening(texel, circumference, 0.0);
+        assert!(planet > 0.0);
+        assert_eq!(screening(texel, circumference, 1e9), planet);
+    }
+
+    #[test]
+    fn prolonging_a_constant_adds_it_everywhere() {
+        let mut psi = PoissonGrid::zeros(8, 4);
+        let coarse = PoissonGrid {
+            data: vec![2.0; 8],
+            ..PoissonGrid::zeros(4, 2)
+        };
+        prolong(&mut psi, &coarse);
+        assert!(psi.data.iter().all(|v| (v - 2.0).abs() < 1e-6));
+    }
+}
@@ -21,15 +21,15 @@ use veldera_atmosphere::{
     SphericalAtmosphereCamera,
 };
 
-use crate::{CloudLayers, noise::NoiseTextures};
+use crate::{CloudLayers, PoissonSolver, noise::NoiseTextures};
 
 use super::{
     gpu_types::GpuCloudUniform,
     layouts::CloudBindGroupLayouts,
     sampler::CloudSampler,
     textures::{
-        CloudHistoryTextures, CloudShadowTexture, CloudSimState, CloudSimTextures,
-        CloudStreamfunctionTextures, CloudTextures,
+        CloudHistoryTextures, CloudPoissonMultigridTextures, CloudShadowTexture, CloudSimState,
+        CloudSimTextures, CloudStreamfunctionTextures, CloudTextures,
     },
 };
 
@@ -58,6 +58,33 @@ pub(crate) struct CloudBindGroups {
     /// when both sim and streamfunction ping-pong textures are
     /// available.
     pub poisson_jacobi: Option<BindGroup>,
+    /// Optional: the multigrid Poisson solve. Built when the sim and
+    /// streamfunction textures are available and the multigrid scratch
+    /// has been allocated (only once that solver is selected).
+    pub poisson_multigrid: Option<PoissonMultigridBindGroups>,
+}
+
+/// Bind groups of one V-cycle (see `shaders/poisson_multigrid.wgsl`).
+/// Each level ends its part of the cycle with its ψ in `psi` 1.
+pub(crate) struct PoissonMultigridBindGroups {
+    /// ω and last frame's ψ into the finest level.
+    pub load: BindGroup,
+    /// The finest ψ out to this frame's streamfunction slot.
+    pub store: BindGroup,
+    /// Finest first.
+    pub levels: Vec<PoissonLevelBindGroups>,
+}
+
+pub(crate) struct PoissonLevelBindGroups {
+    /// Smooths `psi` 0 into `psi` 1, and the reverse. Smoothing from zero
+    /// uses `to_psi_0`, ignoring the ψ it reads.
+    pub smooth_to_psi_1: BindGroup,
+    pub smooth_to_psi_0: BindGroup,
+    /// `psi` 1's residual into the next level's right-hand side, and the
+    /// next level's `psi` 1 corrections into `psi` 0. `None` on the
+    /// coarsest level, whose `smooth_to_psi_1` binds its solve.
+    pub restrict: Option<BindGroup>,
+    pub prolong: Option<BindGroup>,
 }
 
 #[derive(Copy, Clone, Debug)]
@@ -106,6 +133,7 @@ pub(crate) fn prepare_cloud_bind_groups(
         Option<&CloudSimState>,
         Option<&crate::CloudSimStatePreview>,
         Option<&CloudStreamfunctionTextures>,
+        Option<&CloudPoissonMultigridTextures>,
     )>,
     render_device: Res<RenderDevice>,
     layouts: Res<CloudBindGroupLayouts>,
@@ -149,7 +177,9 @@ pub(crate) fn prepare_cloud_bind_groups(
         .binding()
         .ok_or(CloudBindGroupError::AtmosphereLights)?;
 
-    let Some(noise_view) = noise_textures.view() else {
+    let (Some(noise_view), Some(occupancy_view)) =
+        (noise_textures.view(), noise_textures.occupancy_view())
+    else {
         // Noise hasn't been baked yet (first frame). The bake node will run
         // before raymarch on the next frame.
         return Ok(());
@@ -171,6 +201,7 @@ pub(crate) fn prepare_cloud_bind_groups(
         sim_state,
         sim_preview_handle,
         streamfunction_textures,
+        multigrid_textures,
     ) in &layers
     {
         // Resolve topography texture view: if the camera has the
@@ -233,6 +264,7 @@ pub(crate) fn prepare_cloud_bind_groups(
                 (7, &atmo_tex.aerial_view_lut.default_view),
                 (12, &atmo_tex.sky_view_lut.default_view),
                 (8, noise_view),
+                (16, occupancy_view),
                 (9, &sampler.noise),
                 (13, &sampler.clamp),
                 (10, &cloud_tex.raymarch.default_view),
@@ -453,6 +485,95 @@ pub(crate) fn prepare_cloud_bind_groups(
             ))
         });
 
+        // Multigrid bind groups, while that solver is selected. Load and
+        // store follow the same ping-pong slots as the Jacobi sweep; the
+        // levels only bind scratch.
+        let multigrid_selected = cloud_layer.sim.poisson_solver == PoissonSolver::Multigrid;
+        let poisson_multigrid = sim_textures
+            .filter(|_| multigrid_selected)
+            .and_then(|sim_tex| {
+                let sf_tex = streamfunction_textures?;
+                let mg = multigrid_textures?;
+                let frame_idx = sim_state.map_or(0, |s| s.frame_index);
+                let level_layout =
+                    pipeline_cache.get_bind_group_layout(&layouts.poisson_multigrid_level);
+                let level_bind_group = |label: &'static str,
+                                        psi: &TextureView,
+                                        src: &TextureView,
+                                        dst: &TextureView| {
+                    render_device.create_bind_group(
+                        label,
+                        &level_layout,
+                        &BindGroupEntries::with_indices((
+                            (0, cloud_binding.clone()),
+                            (3, psi),
+                            (4, src),
+                            (5, dst),
+                        )),
+                    )
+                };
+                let [psi_0, psi_1] = &mg.psi;
+                let level_count = mg.rhs.len();
+                let levels = (0..level_count)
+                    .map(|l| {
+                        let coarser = (l + 1 < level_count).then_some(l + 1);
+                        PoissonLevelBindGroups {
+                            smooth_to_psi_1: level_bind_group(
+                                "cloud_poisson_multigrid_smooth_bind_group",
+                                &psi_0[l],
+                                &mg.rhs[l],
+                                &psi_1[l],
+                            ),
+                            smooth_to_psi_0: level_bind_group(
+                                "cloud_poisson_multigrid_smooth_bind_group",
+                                &psi_1[l],
+                                &mg.rhs[l],
+                                &psi_0[l],
+                            ),
+                            restrict: coarser.map(|c| {
+                                level_bind_group(
+                                    "cloud_poisson_multigrid_restrict_bind_group",
+                                    &psi_1[l],
+                                    &mg.rhs[l],
+                                    &mg.rhs[c],
+                                )
+                            }),
+                            prolong: coarser.map(|c| {
+                                level_bind_group(
+                                    "cloud_poisson_multigrid_prolong_bind_group",
+                                    &psi_1[l],
+                                    &psi_1[c],
+                                    &psi_0[l],
+                                )
+                            }),
+                        }
+                    })
+                    .collect();
+                Some(PoissonMultigridBindGroups {
+                    load: render_device.create_bind_group(
+                        "cloud_poisson_multigrid_load_bind_group",
+                        &pipeline_cache.get_bind_group_layout(&layouts.poisson_multigrid_load),
+                        &BindGroupEntries::with_indices((
+                            (0, cloud_binding.clone()),
+                            // Sim state slot the sim_step JUST WROTE.
+                            (1, sim_tex.write_view(frame_idx)),
+                            (2, sf_tex.read_view(frame_idx)),
+                            (5, &psi_1[0]),
+                            (6, &mg.rhs[0]),
+                        )),
+                    ),
+                    store: render_device.create_bind_group(
+                        "cloud_poisson_multigrid_store_bind_group",
+                        &pipeline_cache.get_bind_group_layout(&layouts.poisson_multigrid_store),
+                        &BindGroupEntries::with_indices((
+                            (3, &psi_1[0]),
+                            (7, sf_tex.write_view(frame_idx)),
+                        )),
+                    ),
+                    levels,
+                })
+            });
+
         commands.entity(entity).insert(CloudBindGroups {
             raymarch,
             denoise,
@@ -464,6 +585,7 @@ pub(crate) fn prepare_cloud_bind_groups(
             climate_bake,
             sim_step,
             poisson_jacobi,
+            poisson_multigrid,
         });
     }
     Ok(())
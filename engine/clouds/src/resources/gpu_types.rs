@@ -258,7 +258,9 @@ pub struct GpuCloudUniform {
     /// Rayleigh damping timescale for vorticity, seconds. Without
     /// this, accumulated forcing would push ω → ∞ over time.
     pub sim_vorticity_damping_seconds: f32,
-    pub pad_sim_0: u32,
+    /// ε of the streamfunction solve on the climate grid, `(texel /
+    /// deformation radius)²`. See [`crate::poisson`].
+    pub sim_poisson_screening: f32,
     pub pad_sim_1: u32,
 
     // Raymarch feel constants (formerly `shaders/constants.wgsl`), sourced from
@@ -289,6 +291,12 @@ pub struct GpuCloudUniform {
     pub equatorial_circumference_m: f32,
     pub meridional_circumference_m: f32,
 
+    // Empty-space skipping: the switch from `CloudLayers`, the tuning from
+    // `CloudPlanetSettings`. Keep in lockstep with `CloudUniform`.
+    pub empty_space_skipping: u32,
+    pub empty_space_max_leap_steps: u32,
+    pub empty_space_coverage_margin: f32,
+
     // Climate-model tuning, sourced from `CloudClimateSettings` and consumed by
     // the bake-side functions in `climate.wgsl`. See that struct for docs. Keep
     // in lockstep with `CloudUniform`; the `vec3` is last so it aligns cleanly.
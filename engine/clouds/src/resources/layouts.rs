@@ -29,6 +29,11 @@ pub struct CloudBindGroupLayouts {
     pub climate_bake: BindGroupLayoutDescriptor,
     pub sim_step: BindGroupLayoutDescriptor,
     pub poisson_jacobi: BindGroupLayoutDescriptor,
+    /// The multigrid solve's passes, by what they bind: the fine-grid
+    /// load and store at either end, and the passes within the levels.
+    pub poisson_multigrid_load: BindGroupLayoutDescriptor,
+    pub poisson_multigrid_level: BindGroupLayoutDescriptor,
+    pub poisson_multigrid_store: BindGroupLayoutDescriptor,
     pub shadow_apply: BindGroupLayoutDescriptor,
     pub god_rays: BindGroupLayoutDescriptor,
     pub fullscreen_shader: FullscreenShader,
@@ -64,6 +69,9 @@ impl FromWorld for CloudBindGroupLayouts {
                     (12, texture_2d(TextureSampleType::default())),
                     // Cloud noise (single packed 3D texture).
                     (8, texture_3d(TextureSampleType::default())),
+                    // Occupancy volume bounding the noise, read with
+                    // `textureLoad` for empty-space skipping.
+                    (16, texture_3d(TextureSampleType::default())),
                     // Linear, repeat sampler for the noise.
                     (9, sampler(SamplerBindingType::Filtering)),
                     // Linear, clamp-to-edge sampler for the atmosphere LUTs.
@@ -379,6 +387,59 @@ impl FromWorld for CloudBindGroupLayouts {
             ),
         );
 
+        // Multigrid bindings are numbered across the one shader so each
+        // layout only names its own (see `shaders/poisson_multigrid.wgsl`).
+        let r32_read = || texture_2d(TextureSampleType::Float { filterable: false });
+        let r32_write =
+            || texture_storage_2d(TextureFormat::R32Float, StorageTextureAccess::WriteOnly);
+        let poisson_multigrid_load = BindGroupLayoutDescriptor::new(
+            "cloud_poisson_multigrid_load_bind_group_layout",
+            &BindGroupLayoutEntries::with_indices(
+                ShaderStages::COMPUTE,
+                (
+                    (0, uniform_buffer::<GpuCloudUniform>(true)),
+                    // Sim state — read ω (G channel).
+                    (1, texture_2d(TextureSampleType::default())),
+                    // Last frame's ψ, the warm start (read).
+                    (2, texture_2d(TextureSampleType::default())),
+                    // Finest ψ and right-hand side (write).
+                    (5, r32_write()),
+                    (6, r32_write()),
+                ),
+            ),
+        );
+        let poisson_multigrid_level = BindGroupLayoutDescriptor::new(
+            "cloud_poisson_multigrid_level_bind_group_layout",
+            &BindGroupLayoutEntries::with_indices(
+                ShaderStages::COMPUTE,
+                (
+                    (0, uniform_buffer::<GpuCloudUniform>(true)),
+                    // ψ, then the right-hand side or coarse correction.
+                    (3, r32_read()),
+                    (4, r32_read()),
+                    (5, r32_write()),
+                ),
+            ),
+        );
+        let poisson_multigrid_store = BindGroupLayoutDescriptor::new(
+            "cloud_poisson_multigrid_store_bind_group_layout",
+            &BindGroupLayoutEntries::with_indices(
+                ShaderStages::COMPUTE,
+                (
+                    // Finest ψ (read).
+                    (3, r32_read()),
+                    // This frame's streamfunction slot (write).
+                    (
+                        7,
+                        texture_storage_2d(
+                            TextureFormat::Rgba16Float,
+                            StorageTextureAccess::WriteOnly,
+                        ),
+                    ),
+                ),
+            ),
+        );
+
         Self {
             raymarch,
             denoise,
@@ -390,6 +451,9 @@ impl FromWorld for CloudBindGroupLayouts {
             climate_bake,
             sim_step,
             poisson_jacobi,
+            poisson_multigrid_load,
+            poisson_multigrid_level,
+            poisson_multigrid_store,
             fullscreen_shader: world.resource::<FullscreenShader>().clone(),
             composite_fragment: crate::embedded::cloud_composite(world.resource()),
             shadow_apply_fragment: crate::embedded::cloud_shadow_apply(world.resource()),
@@ -28,6 +28,18 @@ pub struct CloudPipelines {
     pub climate_bake: CachedComputePipelineId,
     pub sim_step: CachedComputePipelineId,
     pub poisson_jacobi: CachedComputePipelineId,
+    pub poisson_multigrid: PoissonMultigridPipelines,
+}
+
+/// One pipeline per entry point of `shaders/poisson_multigrid.wgsl`.
+pub struct PoissonMultigridPipelines {
+    pub load_fine: CachedComputePipelineId,
+    pub smooth_level: CachedComputePipelineId,
+    pub smooth_level_from_zero: CachedComputePipelineId,
+    pub restrict_residual: CachedComputePipelineId,
+    pub prolong_correct: CachedComputePipelineId,
+    pub coarse_solve: CachedComputePipelineId,
+    pub store_fine: CachedComputePipelineId,
 }
 
 /// Shader-defs every cloud pipeline whose shader (transitively) imports
@@ -106,6 +118,33 @@ impl FromWorld for CloudPipelines {
             ..Default::default()
         });
 
+        let multigrid_shader = crate::embedded::poisson_multigrid(world.resource());
+        let multigrid = |entry_point: &'static str, layout: &BindGroupLayoutDescriptor| {
+            let mut shader_defs = layer_shader_defs();
+            shader_defs.push(bevy::shader::ShaderDefVal::UInt(
+                "CLIMATE_MAP_WIDTH".into(),
+                crate::CLIMATE_MAP_WIDTH,
+            ));
+            pipeline_cache.queue_compute_pipeline(ComputePipelineDescriptor {
+                label: Some(format!("cloud_poisson_multigrid_pipeline_{entry_point}").into()),
+                layout: vec![layout.clone()],
+                shader: multigrid_shader.clone(),
+                entry_point: Some(entry_point.into()),
+                shader_defs,
+                ..Default::default()
+            })
+        };
+        let level = &layouts.poisson_multigrid_level;
+        let poisson_multigrid = PoissonMultigridPipelines {
+            load_fine: multigrid("load_fine", &layouts.poisson_multigrid_load),
+            smooth_level: multigrid("smooth_level", level),
+            smooth_level_from_zero: multigrid("smooth_level_from_zero", level),
+            restrict_residual: multigrid("restrict_residual", level),
+            prolong_correct: multigrid("prolong_correct", level),
+            coarse_solve: multigrid("coarse_solve", level),
+            store_fine: multigrid("store_fine", &layouts.poisson_multigrid_store),
+        };
+
         Self {
             raymarch,
             denoise,
@@ -113,6 +152,7 @@ impl FromWorld for CloudPipelines {
             climate_bake,
             sim_step,
             poisson_jacobi,
+            poisson_multigrid,
         }
     }
 }
@@ -21,7 +21,10 @@ use bevy::{
     },
 };
 
-use crate::{CloudLayers, constants::SHADOW_MAP_SIZE};
+use crate::{
+    CloudLayers, PoissonSolver,
+    constants::{POISSON_MULTIGRID_LEVELS, SHADOW_MAP_SIZE},
+};
 
 use super::gpu_types::GpuCloudUniform;
 
@@ -112,6 +115,22 @@ impl CloudStreamfunctionTextures {
     }
 }
 
+/// Scratch grids for the multigrid streamfunction solve: three `R32Float`
+/// chains at the climate-map size, one mip per multigrid level (see
+/// `shaders/poisson_multigrid.wgsl`). ψ ping-pongs between `psi` 0 and 1;
+/// `rhs` holds each level's right-hand side. Nothing in them outlives a
+/// frame, but they're allocated once, when the multigrid solver is first
+/// selected, rather than per frame.
+#[derive(Component)]
+pub struct CloudPoissonMultigridTextures {
+    #[allow(dead_code)]
+    pub textures: [Texture; 3],
+    /// Per-mip views of `psi` 0, `psi` 1 and `rhs`, each
+    /// [`crate::constants::POISSON_MULTIGRID_LEVELS`] long.
+    pub psi: [Vec<TextureView>; 2],
+    pub rhs: Vec<TextureView>,
+}
+
 /// Per-camera bookkeeping for the climate sim. Lives in the render
 /// world and persists across frames so the sim can decide when to
 /// reinit / catch up.
@@ -292,20 +311,20 @@ pub fn prepare_cloud_history_textures(
 }
 
 /// Allocates the per-view climate-sim ping-pong textures at the
-/// climate-map resolution. One-shot: once allocated, the textures
-/// persist for the camera's lifetime (sim state must carry over
-/// frame-to-frame for the simulation to be stateful).
+/// climate-map resolution, plus the multigrid scratch once that solver
+/// is selected. One-shot: once allocated, the textures persist for the
+/// camera's lifetime (sim state must carry over frame-to-frame for the
+/// simulation to be stateful).
 #[allow(clippy::type_complexity)]
 pub fn prepare_cloud_sim_textures(
     mut commands: Commands,
-    layers: Query<
-        (
-            Entity,
-            Option<&CloudSimTextures>,
-            Option<&CloudStreamfunctionTextures>,
-        ),
-        With<CloudLayers>,
-    >,
+    layers: Query<(
+        Entity,
+        &CloudLayers,
+        Option<&CloudSimTextures>,
+        Option<&CloudStreamfunctionTextures>,
+        Option<&CloudPoissonMultigridTextures>,
+    )>,
     render_device: Res<RenderDevice>,
 ) {
     let size = UVec2::new(crate::CLIMATE_MAP_WIDTH, crate::CLIMATE_MAP_HEIGHT);
@@ -327,7 +346,31 @@ pub fn prepare_cloud_sim_textures(
         (texture, view)
     };
 
-    for (entity, existing_sim, existing_sf) in &layers {
+    let make_r32f_chain = |label: &'static str| {
+        let texture = render_device.create_texture(&TextureDescriptor {
+            label: Some(label),
+            size: size.to_extents(),
+            mip_level_count: POISSON_MULTIGRID_LEVELS,
+            sample_count: 1,
+            dimension: TextureDimension::D2,
+            format: TextureFormat::R32Float,
+            usage: TextureUsages::STORAGE_BINDING | TextureUsages::TEXTURE_BINDING,
+            view_formats: &[],
+        });
+        let views = (0..POISSON_MULTIGRID_LEVELS)
+            .map(|mip| {
+                texture.create_view(&TextureViewDescriptor {
+                    label: Some(label),
+                    base_mip_level: mip,
+                    mip_level_count: Some(1),
+                    ..Default::default()
+                })
+            })
+            .collect();
+        (texture, views)
+    };
+
+    for (entity, layer, existing_sim, existing_sf, existing_multigrid) in &layers {
         if existing_sim.is_none() {
             let (tex0, view0) = make_rgba16f("cloud_sim_state_0");
             let (tex1, view1) = make_rgba16f("cloud_sim_state_1");
@@ -346,5 +389,17 @@ pub fn prepare_cloud_sim_textures(
                 size,
             });
         }
+        if existing_multigrid.is_none() && layer.sim.poisson_solver == PoissonSolver::Multigrid {
+            let (psi0, psi0_views) = make_r32f_chain("cloud_poisson_multigrid_psi_0");
+            let (psi1, psi1_views) = make_r32f_chain("cloud_poisson_multigrid_psi_1");
+            let (rhs, rhs_views) = make_r32f_chain("cloud_poisson_multigrid_rhs");
+            commands
+                .entity(entity)
+                .insert(CloudPoissonMultigridTextures {
+                    textures: [psi0, psi1, rhs],
+                    psi: [psi0_views, psi1_views],
+                    rhs: rhs_views,
+                });
+        }
     }
 }
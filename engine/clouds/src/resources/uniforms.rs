@@ -505,7 +505,11 @@ pub fn prepare_cloud_uniforms(
                 0.0
             },
             sim_vorticity_damping_seconds: cloud.sim.vorticity_damping_seconds.max(60.0),
-            pad_sim_0: 0,
+            sim_poisson_screening: crate::poisson::screening(
+                settings.equatorial_circumference_m / crate::CLIMATE_MAP_WIDTH as f32,
+                settings.equatorial_circumference_m,
+                cloud.sim.deformation_radius_km,
+            ),
             pad_sim_1: 0,
             cloud_march_max_distance: settings.cloud_march_max_distance,
             aerial_lut_max_distance: settings.aerial_lut_max_distance,
@@ -527,6 +531,9 @@ pub fn prepare_cloud_uniforms(
             jitter_period: settings.jitter_period,
             equatorial_circumference_m: settings.equatorial_circumference_m,
             meridional_circumference_m: settings.meridional_circumference_m,
+            empty_space_skipping: u32::from(cloud.empty_space_skipping),
+            empty_space_max_leap_steps: settings.empty_space_max_leap_steps,
+            empty_space_coverage_margin: settings.empty_space_coverage_margin.max(0.0),
             climate_subtropical_offset_deg: climate_settings.subtropical_offset_deg,
             climate_storm_track_offset_deg: climate_settings.storm_track_offset_deg,
             climate_itcz_band_sigma: climate_settings.itcz_band_sigma,
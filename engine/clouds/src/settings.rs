@@ -110,6 +110,15 @@ pub struct CloudPlanetSettings {
     /// Planet pole-to-pole circumference (m), used by the weather sim to convert
     /// meridional wind (m/s) to latitude-V/s. Earth = 20_004_000.
     pub meridional_circumference_m: f32,
+
+    /// Most primary-march steps one empty-space leap may clear. The noise
+    /// bound gets no tighter past the occupancy volume's coarsest level, so
+    /// the cap really limits how far the coverage is trusted to hold.
+    pub empty_space_max_leap_steps: u32,
+    /// Coverage slack for empty-space leaps. A leap takes the coverage
+    /// threshold at its first sample as holding over the whole run; it only
+    /// leaps where the shape bound clears that threshold less this much.
+    pub empty_space_coverage_margin: f32,
 }
 
 // `CloudPlanetSettings` derives a zeroed `Default`: the host supplies real
@@ -17,6 +17,9 @@
 @group(0) @binding(6) var transmittance_lut: texture_2d<f32>;
 @group(0) @binding(7) var aerial_view_lut: texture_3d<f32>;
 @group(0) @binding(8) var noise_3d: texture_3d<f32>;
+// Occupancy volume: per-block bounds on the noise's shape inputs (see
+// `noise_occupancy.wgsl`). Read with `textureLoad` only.
+@group(0) @binding(16) var noise_occupancy: texture_3d<f32>;
 // Linear, repeat sampler — for the tileable 3D noise.
 @group(0) @binding(9) var cloud_sampler: sampler;
 @group(0) @binding(10) var cloud_raymarch_out: texture_storage_2d<rgba16float, write>;
@@ -74,7 +77,8 @@ struct CloudInspectData {
     fh_cov_lo: f32,
     fh_cov_hi: f32,
     fh_density_recheck: f32,
+    // Samples the march leapt without evaluating density.
+    skipped_count: u32,
     _pad0: f32,
-    _pad1: f32,
 }
 @group(0) @binding(15) var<storage, read_write> cloud_inspect_buffer: CloudInspectData;
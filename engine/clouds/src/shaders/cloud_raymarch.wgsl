@@ -37,6 +37,7 @@ fn depth_to_camera_dist(uv: vec2<f32>, depth: f32) -> f32 {
     sample_transmittance, sample_aerial_inscattering, sample_sky_view,
     dual_henyey_greenstein_layer, dual_henyey_greenstein_layer_eccentric,
     sample_cloud_density, sample_layer_density, sample_light_optical_depth,
+    sample_cloud_density_and_leap,
     cloud_shell_segment, sample_layer_density_breakdown, LayerDensityBreakdown,
 };
 
@@ -221,6 +222,7 @@ const DBG_NOISE: u32 = 2u;
 const DBG_DENSITY: u32 = 3u;
 const DBG_OPACITY: u32 = 4u;
 const DBG_K_FIRST: u32 = 11u;
+const DBG_STEPS: u32 = 13u;
 
 @compute @workgroup_size(8, 8, 1)
 fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
@@ -337,7 +339,10 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
             }
         }
         // For DBG_OPACITY we still need to run the loop. Handle below.
-        if cloud.debug_mode != DBG_OPACITY && cloud.debug_mode != DBG_K_FIRST {
+        if cloud.debug_mode != DBG_OPACITY
+            && cloud.debug_mode != DBG_K_FIRST
+            && cloud.debug_mode != DBG_STEPS
+        {
             textureStore(cloud_raymarch_out, vec2<i32>(idx.xy), vec4(dbg, 0.0));
             return;
         }
@@ -435,6 +440,13 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
     var first_hit_density: f32 = 0.0;
     var first_hit_pos: vec3<f32> = vec3<f32>(0.0);
     var iter_count: u32 = 0u;
+    // Empty-space skipping: after an empty sample, up to
+    // `empty_space_max_leap_steps` following grid samples that
+    // `sample_cloud_density_and_leap` proves empty are leapt without
+    // evaluating them. They stay on the world-snapped grid, and would have
+    // added nothing, so the image is unchanged.
+    let skip_empty = cloud.empty_space_skipping != 0u;
+    var skipped_count: u32 = 0u;
 
     loop {
         if iter >= max_iter {
@@ -467,7 +479,18 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
 
         let sample_pos_local = ray_dir_ws * t;
         let sample_pos = cam_world + sample_pos_local;
-        let density = sample_cloud_density(sample_pos, sample_pos_local, dt);
+        var density: f32;
+        var empty_steps = 0u;
+        let max_leap = min(max_iter - iter - 1u, cloud.empty_space_max_leap_steps);
+        if skip_empty && max_leap > 0u {
+            let s = sample_cloud_density_and_leap(
+                sample_pos, sample_pos_local, ray_dir_ws, dt, max_leap,
+            );
+            density = s.density;
+            empty_steps = s.empty_steps;
+        } else {
+            density = sample_cloud_density(sample_pos, sample_pos_local, dt);
+        }
         // Skip empty space. Threshold is in absolute extinction units (1/m);
         // 1e-7 is safely below any realistic density_scale × normalised
         // density so we don't accidentally drop visible clouds.
@@ -522,7 +545,8 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
         }
 
         iter_count = iter_count + 1u;
-        iter = iter + 1u;
+        skipped_count = skipped_count + empty_steps;
+        iter = iter + 1u + empty_steps;
     }
 
     // Inspector write. One pixel per frame; gated on the cursor
@@ -538,6 +562,7 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
         cloud_inspect_buffer.k_first = k_first;
         cloud_inspect_buffer.k_last = k_last;
         cloud_inspect_buffer.iter_count = iter_count;
+        cloud_inspect_buffer.skipped_count = skipped_count;
         cloud_inspect_buffer.max_iter = max_iter;
         cloud_inspect_buffer.transmittance = transmittance;
         cloud_inspect_buffer.opacity = 1.0 - transmittance;
@@ -577,6 +602,13 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
         cloud_inspect_buffer.fh_density_recheck = best_breakdown.density;
     }
 
+    if cloud.debug_mode == DBG_STEPS {
+        let evaluated = saturate(f32(iter_count) / 128.0);
+        let skipped = saturate(f32(skipped_count) / 128.0);
+        textureStore(cloud_raymarch_out, vec2<i32>(idx.xy), vec4(evaluated, skipped, 0.0, 0.0));
+        return;
+    }
+
     if cloud.debug_mode == DBG_OPACITY {
         let opacity = 1.0 - transmittance;
         textureStore(
@@ -5,7 +5,7 @@
 #import veldera_clouds::bindings::{
     cloud, atmosphere, atmosphere_transforms, view,
     transmittance_lut, aerial_view_lut, sky_view_lut,
-    noise_3d, cloud_sampler, lut_sampler, climate_map,
+    noise_3d, noise_occupancy, cloud_sampler, lut_sampler, climate_map,
 };
 #import veldera_clouds::climate::climate_coverage_at;
 #import veldera_clouds::types::CONE_OFFSETS;
@@ -160,6 +160,10 @@ struct LayerDensityBreakdown {
     cov_lo: f32,
     cov_hi: f32,
     density: f32,
+    // Unwrapped main-octave noise UV and its mip LOD, kept for the
+    // empty-space bound in `layer_empty_steps`.
+    noise_uv: vec3<f32>,
+    lod: f32,
 }
 
 fn sample_layer_density_breakdown(
@@ -246,6 +250,8 @@ fn sample_layer_density_breakdown(
         b.shell_h * vertical_cycles,
         layer.noise_uv_offset.z + sample_pos_local.z / tile + layer.wind_offset.y / tile + warp.y,
     );
+    b.noise_uv = noise_uv;
+    b.lod = lod;
     let n_lo = textureSampleLevel(noise_3d, cloud_sampler, fract(noise_uv), lod);
     // Higher-frequency octave at different position so it doesn't
     // align. 2.13× tighter spatial frequency means it represents
@@ -341,6 +347,172 @@ fn sample_cloud_density(world_pos: vec3<f32>, sample_pos_local: vec3<f32>, dt: f
     return total;
 }
 
+// ---- Empty-space skipping -------------------------------------------
+//
+// After an empty sample the primary march asks how many of the following
+// grid steps provably stay empty too, and leaps them without evaluating
+// density. Per layer the answer comes from the shell altitudes when the
+// sample is outside the layer, and otherwise from `noise_occupancy` —
+// bounds on the shape inputs within a texel of the sample, see
+// `noise_occupancy.wgsl` — against the sample's own coverage threshold.
+// That threshold is taken to hold over the leap, less
+// `cloud.empty_space_coverage_margin`: climate and weather vary over tens
+// of kilometres, a leap covers a few.
+
+// Most the domain warp can move the main noise UV per metre the sample
+// moves, in tiles. The warp is ±0.2 tile of Worley fBm on a tile 4× the
+// noise tile; the fBm (8 base cells, see `noise_bake.wgsl`) changes by at
+// most about 13 per unit of its UV, so 0.4 × 13 / 4.
+const WARP_DRIFT_PER_TILE: f32 = 1.3;
+
+struct CloudDensitySample {
+    density: f32,
+    // Grid steps after this one that provably hold no density.
+    empty_steps: u32,
+}
+
+// Largest `v_profile` over shell heights `[lo, hi]`. The profile rises to
+// a plateau over [0.2, 0.6] and falls after, so its maximum sits at the
+// plateau point nearest the interval.
+fn v_profile_max(lo: f32, hi: f32) -> f32 {
+    let h = clamp(0.4, lo, hi);
+    return smoothstep(0.0, 0.2, h) * (1.0 - smoothstep(0.6, 1.0, h));
+}
+
+// Steps, up to `max_steps`, before a ray at `radius` outside layer
+// `layer_i`'s shell, with `radial` = dot(ray, up), can reach the shell.
+fn layer_gap_steps(layer_i: u32, radius: f32, radial: f32, dt: f32, max_steps: u32) -> u32 {
+    let layer = cloud.layers[layer_i];
+    let above = radius > layer.outer_radius;
+    if above && radial >= 0.0 {
+        // Climbing away from the shell: the radius only grows from here.
+        return max_steps;
+    }
+    let gap = select(layer.inner_radius - radius, radius - layer.outer_radius, above);
+    // The radius changes by at most a metre per metre of ray; the sample
+    // `j` steps on is within `j + jitter` steps of this one.
+    let steps = gap / dt - cloud.raymarch_jitter_magnitude;
+    return u32(clamp(steps, 0.0, f32(max_steps)));
+}
+
+// Steps, up to `max_steps`, after an empty sample of layer `layer_i`
+// (breakdown `b`) over which the layer provably stays empty. Tries the
+// occupancy levels coarse to fine: a coarse texel bounds a longer leap,
+// a fine one bounds it tighter.
+fn layer_empty_steps(
+    layer_i: u32,
+    b: LayerDensityBreakdown,
+    ray_dir: vec3<f32>,
+    up: vec3<f32>,
+    dt: f32,
+    max_steps: u32,
+) -> u32 {
+    let layer = cloud.layers[layer_i];
+    let threshold = b.cov_lo - cloud.empty_space_coverage_margin;
+    if threshold <= 0.0 || max_steps == 0u {
+        return 0u;
+    }
+    let tile = layer.noise_tile;
+    let shell_thickness = max(layer.outer_radius - layer.inner_radius, 1.0);
+    let jitter = cloud.raymarch_jitter_magnitude;
+    let max_reach = (f32(max_steps) + jitter) * dt;
+    // Main-octave noise UV moved per metre of reach, per axis. Vertically
+    // the UV runs 2.5 cycles over the shell, and the planet curves the ray
+    // away from its start by up to `reach² / 2r`.
+    let uv_per_m = vec3<f32>(
+        (abs(ray_dir.x) + WARP_DRIFT_PER_TILE) / tile,
+        2.5 * (abs(dot(ray_dir, up)) + 0.5 * max_reach / b.radius) / shell_thickness,
+        (abs(ray_dir.z) + WARP_DRIFT_PER_TILE) / tile,
+    );
+    let uv_per_step = max(uv_per_m.x, max(uv_per_m.y, uv_per_m.z)) * dt;
+    // Filtered taps read texels up to `2^(ceil(lod) + 1)` mip-0 texels
+    // from the sample point; the hi octave samples 1.09 LODs up.
+    let footprint_lo = exp2(ceil(b.lod) + 1.0) / 256.0;
+    let footprint_hi = exp2(ceil(min(b.lod + 1.09, 7.0)) + 1.0) / 256.0;
+    let lo_uv = fract(b.noise_uv);
+    let hi_uv = fract(b.noise_uv * 2.13 + vec3(0.37, 0.19, 0.71));
+
+    // The coarsest level bounds the whole tile, so it needs no budget.
+    let top = i32(textureNumLevels(noise_occupancy)) - 1;
+    for (var level = top; level >= 1; level = level - 1) {
+        let hi_level = min(level + 1, top);
+        let lo_res = vec3<i32>(textureDimensions(noise_occupancy, level));
+        let hi_res = vec3<i32>(textureDimensions(noise_occupancy, hi_level));
+        var steps = max_steps;
+        if level < top {
+            // A dilated texel holds within one texel of anywhere inside
+            // it, less the filter footprint; the hi octave moves 2.13×
+            // as fast through its UV.
+            var budget = 1.0 / f32(lo_res.x) - footprint_lo;
+            if hi_level < top {
+                budget = min(budget, (1.0 / f32(hi_res.x) - footprint_hi) / 2.13);
+            }
+            let reach = budget / uv_per_step - jitter;
+            if reach < 1.0 {
+                // Finer levels reach less still.
+                break;
+            }
+            steps = min(u32(reach), max_steps);
+        }
+        let lo_texel = min(vec3<i32>(lo_uv * vec3<f32>(lo_res)), lo_res - 1);
+        let hi_texel = min(vec3<i32>(hi_uv * vec3<f32>(hi_res)), hi_res - 1);
+        let lo = textureLoad(noise_occupancy, lo_texel, level).ba;
+        let hi = textureLoad(noise_occupancy, hi_texel, hi_level).ba;
+        // Shape grows with base and shrinks with erosion, and both mix
+        // the octaves linearly, as in `sample_layer_density_breakdown`.
+        let base_max = mix(lo.x, hi.x, 0.35);
+        let erosion_min = mix(lo.y, hi.y, 0.35);
+        let shape_max = saturate(remap(base_max, erosion_min - 1.0, 1.0, 0.0, 1.0));
+        let reach_h = (f32(steps) + jitter) * dt * uv_per_m.y / 2.5;
+        let v_max = v_profile_max(b.shell_h - reach_h, b.shell_h + reach_h);
+        if shape_max * v_max <= threshold {
+            return steps;
+        }
+    }
+    return 0u;
+}
+
+// `sample_cloud_density` for the primary march. When the sample is empty
+// it also reports how many of the next `max_steps` grid steps along
+// `ray_dir` (spaced `dt`) provably are too, across every enabled layer.
+fn sample_cloud_density_and_leap(
+    world_pos: vec3<f32>,
+    sample_pos_local: vec3<f32>,
+    ray_dir: vec3<f32>,
+    dt: f32,
+    max_steps: u32,
+) -> CloudDensitySample {
+    var result: CloudDensitySample;
+    result.density = 0.0;
+    result.empty_steps = max_steps;
+    let radius = length(world_pos);
+    let up = world_pos / radius;
+    for (var i: u32 = 0u; i < cloud.layer_count; i = i + 1u) {
+        let layer = cloud.layers[i];
+        if layer.enabled == 0u {
+            continue;
+        }
+        if radius < layer.inner_radius || radius > layer.outer_radius {
+            result.empty_steps = min(
+                result.empty_steps,
+                layer_gap_steps(i, radius, dot(ray_dir, up), dt, result.empty_steps),
+            );
+            continue;
+        }
+        let b = sample_layer_density_breakdown(i, world_pos, sample_pos_local, dt);
+        result.density = result.density + b.density;
+        if b.density > 0.0 {
+            result.empty_steps = 0u;
+        } else if result.empty_steps > 0u {
+            result.empty_steps = layer_empty_steps(i, b, ray_dir, up, dt, result.empty_steps);
+        }
+    }
+    if result.density > 1e-7 {
+        result.empty_steps = 0u;
+    }
+    return result;
+}
+
 // Helper: linear remap from [a, b] to [c, d].
 fn remap(x: f32, a: f32, b: f32, c: f32, d: f32) -> f32 {
     return c + (x - a) * (d - c) / max(b - a, 1e-6);
@@ -0,0 +1,76 @@
+// Coarse occupancy volume for the raymarch's empty-space skipping.
+//
+// Each texel bounds the inputs of the cloud-shape formula in
+// `sample_layer_density_breakdown` over a block of the noise texture:
+// R = max of the base channel, G = min of the erosion term
+// `g * 0.625 + b * 0.25`. Shape only grows with base and only shrinks with
+// erosion, so the pair bounds shape from above. B and A hold the same
+// bounds dilated by one texel on every side (wrapping, like the noise), so
+// from mip 1 up a texel's B/A hold for everything within one texel of any
+// point inside it — enough to clear a run of march steps on one lookup.
+//
+// `reduce_noise` fills mip 0 from 8³ blocks of noise mip 0; its B/A are
+// undilated copies, since the raymarch never leaps on mip 0.
+// `reduce_mip` fills each coarser mip from the one below. Both run once,
+// straight after the noise bake.
+
+@group(0) @binding(0) var src: texture_3d<f32>;
+@group(0) @binding(1) var dst: texture_storage_3d<rgba8unorm, write>;
+
+fn erosion(n: vec4<f32>) -> f32 {
+    return n.g * 0.625 + n.b * 0.25;
+}
+
+@compute @workgroup_size(4, 4, 4)
+fn reduce_noise(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let dst_size = textureDimensions(dst);
+    if any(idx >= dst_size) {
+        return;
+    }
+    let block = vec3<i32>(textureDimensions(src) / dst_size);
+    let src_base = vec3<i32>(idx) * block;
+    var base_max = 0.0;
+    var erosion_min = 1.0;
+    for (var z: i32 = 0; z < block.z; z = z + 1) {
+        for (var y: i32 = 0; y < block.y; y = y + 1) {
+            for (var x: i32 = 0; x < block.x; x = x + 1) {
+                let n = textureLoad(src, src_base + vec3<i32>(x, y, z), 0);
+                base_max = max(base_max, n.r);
+                erosion_min = min(erosion_min, erosion(n));
+            }
+        }
+    }
+    // Base is read from `Rgba8Unorm` and stores back exactly; erosion is a
+    // blend, so step it down half a unorm step to keep the stored value a
+    // lower bound after rounding.
+    erosion_min = max(erosion_min - 0.5 / 255.0, 0.0);
+    textureStore(dst, vec3<i32>(idx), vec4(base_max, erosion_min, base_max, erosion_min));
+}
+
+@compute @workgroup_size(4, 4, 4)
+fn reduce_mip(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let dst_size = textureDimensions(dst);
+    if any(idx >= dst_size) {
+        return;
+    }
+    let src_size = vec3<i32>(textureDimensions(src));
+    let src_base = vec3<i32>(idx * 2u);
+    var own = vec2<f32>(0.0, 1.0);
+    var dilated = vec2<f32>(0.0, 1.0);
+    // One destination texel is two source texels wide, so dilating it by a
+    // texel takes in two source texels on every side of its own 2³.
+    for (var z: i32 = -2; z < 4; z = z + 1) {
+        for (var y: i32 = -2; y < 4; y = y + 1) {
+            for (var x: i32 = -2; x < 4; x = x + 1) {
+                let offset = vec3<i32>(x, y, z);
+                let coord = (src_base + offset + src_size) % src_size;
+                let n = textureLoad(src, coord, 0);
+                dilated = vec2(max(dilated.x, n.r), min(dilated.y, n.g));
+                if all(offset >= vec3<i32>(0)) && all(offset < vec3<i32>(2)) {
+                    own = vec2(max(own.x, n.r), min(own.y, n.g));
+                }
+            }
+        }
+    }
+    textureStore(dst, vec3<i32>(idx), vec4(own, dilated));
+}
@@ -1,19 +1,23 @@
-// One Jacobi iteration of the Poisson equation ∇²ψ = −ω on the
-// climate-sim streamfunction texture.
+// One Jacobi iteration of the screened Poisson equation ∇²ψ − εψ = −ω
+// on the climate-sim streamfunction texture. The alternative to the
+// multigrid solve in `poisson_multigrid.wgsl`, selected by
+// `ClimateSimSettings::poisson_solver`.
 //
 // We dispatch this ONCE per real frame (not multiple iterations per
 // frame), trading per-frame compute for slower convergence. At 60 fps
-// that's 60 iters per second of real time, which is enough for the
-// streamfunction to track the slowly-evolving vorticity field — full
-// convergence (~30 iters) lands in 0.5 s.
+// that's 60 iters per second of real time — enough to track vorticity
+// features a few texels across, but a mode λ texels long takes on the
+// order of λ² sweeps to settle, so planet-scale flow lags by minutes.
+// The multigrid solve settles every scale within a frame or two.
 //
 // The discrete Jacobi update on a uniform grid:
 //   ψ_new[i,j] = (ψ[i−1,j] + ψ[i+1,j] + ψ[i,j−1] + ψ[i,j+1]
-//                 + dx² · ω[i,j]) / 4
+//                 + dx² · ω[i,j]) / (4 + ε)
 //
 // We use texel-spacing dx = 1 (working in texel-index space rather
 // than physical metres). The resulting ψ has arbitrary scale; the
-// sim step's `vorticity_strength` knob compensates.
+// sim step's `vorticity_strength` knob compensates. ε is
+// `(texel / deformation radius)²` (see `src/poisson.rs`).
 
 #import veldera_clouds::types::CloudUniform;
 
@@ -54,7 +58,7 @@ fn main(@builtin(global_invocation_id) idx: vec3<u32>) {
     let psi_s = textureSampleLevel(psi_prev, clamp_sampler, u_s, 0.0).r;
 
     // dx in TEXEL units = 1. Standard 5-point Jacobi.
-    let psi_new = 0.25 * (psi_e + psi_w + psi_n + psi_s + omega);
+    let psi_new = (psi_e + psi_w + psi_n + psi_s + omega) / (4.0 + cloud.sim_poisson_screening);
 
     textureStore(psi_curr, vec2<i32>(idx.xy), vec4(psi_new, 0.0, 0.0, 1.0));
 }
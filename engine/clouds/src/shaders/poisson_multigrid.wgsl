@@ -0,0 +1,187 @@
+// Multigrid V-cycle for the climate-sim streamfunction: solves
+//   (4 + ε)·ψ − Σ neighbours ψ = ω
+// (texel units, u wrapping, v reflecting at the poles; see
+// `poisson_jacobi.wgsl` for the one-sweep-per-frame alternative and
+// `src/poisson.rs` for the CPU mirror both are checked against).
+//
+// Every grid lives in a mip of three `R32Float` chains: ψ ping-pongs
+// between `psi_a` and `psi_b`, the right-hand side sits in `rhs`. Level l
+// is mip l; its stencil is rescaled to its own texel spacing, which turns
+// ε into ε·4^l and the restricted residual into 4× its 2×2 average.
+//
+// The node runs, per V-cycle, with each level's result left in `psi_b`:
+//   load_fine              ω → rhs 0, last frame's ψ → psi_b 0
+//   each level, going down: smooth_level ×2 (the first from zero below
+//                           the finest), restrict_residual to rhs l+1
+//   coarsest (8×4):         coarse_solve, one workgroup
+//   each level, going up:   prolong_correct into psi_a, smooth_level ×1
+//   store_fine              psi_b 0 → the streamfunction ping-pong
+// Bindings are numbered apart so each entry point's layout binds only its
+// own.
+
+#import veldera_clouds::types::CloudUniform;
+
+const CLIMATE_MAP_WIDTH: u32 = #{CLIMATE_MAP_WIDTH}u;
+
+// Damped-Jacobi weight; `SMOOTH_WEIGHT` in poisson.rs.
+const SMOOTH_WEIGHT: f32 = 0.8;
+// `COARSE_SWEEPS` in poisson.rs.
+const COARSE_SWEEPS: u32 = 32u;
+
+@group(0) @binding(0) var<uniform> cloud: CloudUniform;
+// `load_fine` only.
+@group(0) @binding(1) var sim_state: texture_2d<f32>;
+@group(0) @binding(2) var psi_prev: texture_2d<f32>;
+// Level passes: `src_a` is ψ (unused when smoothing from zero), `src_b`
+// the right-hand side, or the coarse correction for `prolong_correct`.
+@group(0) @binding(3) var src_a: texture_2d<f32>;
+@group(0) @binding(4) var src_b: texture_2d<f32>;
+@group(0) @binding(5) var dst: texture_storage_2d<r32float, write>;
+// `load_fine` writes ω here.
+@group(0) @binding(6) var dst_rhs: texture_storage_2d<r32float, write>;
+// `store_fine` only.
+@group(0) @binding(7) var psi_out: texture_storage_2d<rgba16float, write>;
+
+// ε on a grid `width` texels wide.
+fn level_screening(width: u32) -> f32 {
+    let scale = f32(CLIMATE_MAP_WIDTH / width);
+    return cloud.sim_poisson_screening * scale * scale;
+}
+
+fn wrap_clamp(p: vec2<i32>, size: vec2<i32>) -> vec2<i32> {
+    return vec2((p.x + size.x) % size.x, clamp(p.y, 0, size.y - 1));
+}
+
+fn load_r(tex: texture_2d<f32>, p: vec2<i32>, size: vec2<i32>) -> f32 {
+    return textureLoad(tex, wrap_clamp(p, size), 0).r;
+}
+
+fn neighbour_sum(tex: texture_2d<f32>, p: vec2<i32>, size: vec2<i32>) -> f32 {
+    return load_r(tex, p + vec2(1, 0), size) + load_r(tex, p - vec2(1, 0), size)
+        + load_r(tex, p + vec2(0, 1), size) + load_r(tex, p - vec2(0, 1), size);
+}
+
+@compute @workgroup_size(8, 8, 1)
+fn load_fine(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(dst);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let p = vec2<i32>(idx.xy);
+    // Vorticity is zero at reinit too, so ψ starts from zero with it.
+    var psi = 0.0;
+    if cloud.sim_reinit == 0u {
+        psi = textureLoad(psi_prev, p, 0).r;
+    }
+    textureStore(dst, p, vec4(psi, 0.0, 0.0, 0.0));
+    textureStore(dst_rhs, p, vec4(textureLoad(sim_state, p, 0).g, 0.0, 0.0, 0.0));
+}
+
+@compute @workgroup_size(8, 8, 1)
+fn smooth_level(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(dst);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let p = vec2<i32>(idx.xy);
+    let psi = textureLoad(src_a, p, 0).r;
+    let jacobi = (neighbour_sum(src_a, p, vec2<i32>(size)) + textureLoad(src_b, p, 0).r)
+        / (4.0 + level_screening(size.x));
+    textureStore(dst, p, vec4(psi + SMOOTH_WEIGHT * (jacobi - psi), 0.0, 0.0, 0.0));
+}
+
+// `smooth_level` of a zero ψ, which is where every coarse level's correction
+// starts.
+@compute @workgroup_size(8, 8, 1)
+fn smooth_level_from_zero(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(dst);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let p = vec2<i32>(idx.xy);
+    let psi = SMOOTH_WEIGHT * textureLoad(src_b, p, 0).r / (4.0 + level_screening(size.x));
+    textureStore(dst, p, vec4(psi, 0.0, 0.0, 0.0));
+}
+
+// One texel per coarse texel: the residual of its 2×2 fine texels, summed
+// (4 × their average).
+@compute @workgroup_size(8, 8, 1)
+fn restrict_residual(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(dst);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let fine_size = vec2<i32>(textureDimensions(src_a));
+    let screening = level_screening(u32(fine_size.x));
+    var sum = 0.0;
+    for (var i: i32 = 0; i < 4; i = i + 1) {
+        let p = vec2<i32>(idx.xy) * 2 + vec2(i & 1, i >> 1);
+        let psi = textureLoad(src_a, p, 0).r;
+        let a_psi = (4.0 + screening) * psi - neighbour_sum(src_a, p, fine_size);
+        sum += textureLoad(src_b, p, 0).r - a_psi;
+    }
+    textureStore(dst, vec2<i32>(idx.xy), vec4(sum, 0.0, 0.0, 0.0));
+}
+
+// ψ plus the bilinearly interpolated coarse correction.
+@compute @workgroup_size(8, 8, 1)
+fn prolong_correct(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(dst);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let p = vec2<i32>(idx.xy);
+    let coarse_size = vec2<i32>(textureDimensions(src_b));
+    // A fine texel's centre sits a quarter coarse texel off the centre of
+    // the coarse texel holding it, towards its nearest neighbour.
+    let c = p / 2;
+    let n = c + (p % 2) * 2 - 1;
+    let row_near = 0.75 * load_r(src_b, c, coarse_size)
+        + 0.25 * load_r(src_b, vec2(n.x, c.y), coarse_size);
+    let row_far = 0.75 * load_r(src_b, vec2(c.x, n.y), coarse_size)
+        + 0.25 * load_r(src_b, n, coarse_size);
+    let psi = textureLoad(src_a, p, 0).r + 0.75 * row_near + 0.25 * row_far;
+    textureStore(dst, p, vec4(psi, 0.0, 0.0, 0.0));
+}
+
+const COARSE_WIDTH: i32 = 8;
+const COARSE_HEIGHT: i32 = 4;
+var<workgroup> coarse_psi: array<f32, 32>;
+
+fn coarse_at(p: vec2<i32>) -> f32 {
+    let q = wrap_clamp(p, vec2(COARSE_WIDTH, COARSE_HEIGHT));
+    return coarse_psi[q.y * COARSE_WIDTH + q.x];
+}
+
+// The coarsest grid, solved in one workgroup's memory from a zero start.
+// Dispatched as a single 8×4 workgroup; POISSON_MULTIGRID_LEVELS keeps the
+// coarsest level this size.
+@compute @workgroup_size(8, 4, 1)
+fn coarse_solve(@builtin(local_invocation_id) idx: vec3<u32>) {
+    let p = vec2<i32>(idx.xy);
+    let rhs = textureLoad(src_b, p, 0).r;
+    let centre = 4.0 + level_screening(u32(COARSE_WIDTH));
+    let i = p.y * COARSE_WIDTH + p.x;
+    coarse_psi[i] = 0.0;
+    workgroupBarrier();
+    for (var sweep = 0u; sweep < COARSE_SWEEPS; sweep = sweep + 1u) {
+        let psi = coarse_psi[i];
+        let sum = coarse_at(p + vec2(1, 0)) + coarse_at(p - vec2(1, 0))
+            + coarse_at(p + vec2(0, 1)) + coarse_at(p - vec2(0, 1));
+        let next = psi + SMOOTH_WEIGHT * ((sum + rhs) / centre - psi);
+        workgroupBarrier();
+        coarse_psi[i] = next;
+        workgroupBarrier();
+    }
+    textureStore(dst, p, vec4(coarse_psi[i], 0.0, 0.0, 0.0));
+}
+
+@compute @workgroup_size(8, 8, 1)
+fn store_fine(@builtin(global_invocation_id) idx: vec3<u32>) {
+    let size = textureDimensions(psi_out);
+    if any(idx.xy >= size) {
+        return;
+    }
+    let p = vec2<i32>(idx.xy);
+    textureStore(psi_out, p, vec4(textureLoad(src_a, p, 0).r, 0.0, 0.0, 1.0));
+}
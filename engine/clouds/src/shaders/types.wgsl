@@ -172,7 +172,7 @@ struct CloudUniform {
     sim_vorticity_strength: f32,
     sim_vorticity_forcing: f32,
     sim_vorticity_damping_seconds: f32,
-    pad_sim_0: u32,
+    sim_poisson_screening: f32,
     pad_sim_1: u32,
     // Raymarch feel constants (formerly module-level `const`s in constants.wgsl).
     // Keep this order in lockstep with `GpuCloudUniform` in resources.rs.
@@ -198,6 +198,10 @@ struct CloudUniform {
     jitter_period: u32,
     equatorial_circumference_m: f32,
     meridional_circumference_m: f32,
+    // Empty-space skipping. Keep in lockstep with `GpuCloudUniform`.
+    empty_space_skipping: u32,
+    empty_space_max_leap_steps: u32,
+    empty_space_coverage_margin: f32,
     // Climate-model tuning (consumed by climate.wgsl's bake functions). Keep in
     // lockstep with `GpuCloudUniform`; the vec3 is last so it aligns cleanly.
     climate_subtropical_offset_deg: f32,
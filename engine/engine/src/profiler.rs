@@ -1,12 +1,20 @@
-//! In-game per-system CPU profiler.
+//! In-game per-system CPU profiler and tile-streaming stage latencies.
 //!
 //! Bevy emits `tracing` spans for every system when the `trace` feature
 //! is enabled (`info_span!("system", name = ...)` from
 //! `bevy_ecs::system::function_system`). We attach a custom
 //! [`tracing_subscriber::Layer`] via [`bevy::log::LogPlugin::custom_layer`]
-//! that times each span, accumulates per-system totals into a shared
-//! `Mutex<HashMap>`, and a Bevy system in the `Last` schedule drains the
-//! map into a snapshot resource for the egui UI to display.
+//! that times each span into an accumulator owned by the thread it ran
+//! on, and a Bevy system in the `Last` schedule merges the threads'
+//! accumulators into snapshot resources for the egui UI to display.
+//!
+//! The same layer times the tile lifecycle spans of
+//! [`rocktree::stage`] (queue wait, cache, HTTP, decode, conversion,
+//! upload, first visible frame) into per-stage [`LatencyHistogram`]s,
+//! published as [`StageProfile`]. While a [`TraceCapture`] is recording,
+//! every timed span is also kept as a Chrome trace event, saved as JSON
+//! that `chrome://tracing` and Perfetto open. Tile stages go on one async
+//! track per tile rather than on the thread that ran them.
 //!
 //! Native-only: `tracing-subscriber` is in our native-only dep block
 //! and the rest of the WASM debug-UI surface degrades gracefully (the
@@ -17,12 +25,169 @@
 //! viewable in-process. This module keeps profiling visible in the
 //! same debug overlay as the rest of the diagnostics.
 
+use std::time::Duration;
+
+use bevy::ecs::resource::Resource;
+use rocktree::stage::Stage;
+
+/// Log2 of the buckets per power of two in a [`LatencyHistogram`].
+const SUB_BUCKET_BITS: u32 = 2;
+/// Powers of two a [`LatencyHistogram`] covers from 1 µs: up to 2^27 µs,
+/// a little over two minutes. Longer samples land in the last bucket.
+const OCTAVES: u32 = 27;
+const BUCKETS: usize = (OCTAVES << SUB_BUCKET_BITS) as usize;
+
+/// Latencies bucketed four to a power of two from 1 µs, so percentiles
+/// read to within a quarter of their value without keeping samples, and
+/// histograms from different threads merge by adding counts.
+#[derive(Clone)]
+pub struct LatencyHistogram {
+    counts: [u32; BUCKETS],
+    total: u64,
+    sum_micros: u64,
+}
+
+impl Default for LatencyHistogram {
+    fn default() -> Self {
+        Self {
+            counts: [0; BUCKETS],
+            total: 0,
+            sum_micros: 0,
+        }
+    }
+}
+
+impl LatencyHistogram {
+    pub fn record(&mut self, elapsed: Duration) {
+        let micros = u64::try_from(elapsed.as_micros()).unwrap_or(u64::MAX);
+        self.counts[bucket_of(micros)] += 1;
+        self.total += 1;
+        self.sum_micros = self.sum_micros.saturating_add(micros);
+    }
+
+    /// Add `other`'s samples to these.
+    pub fn merge(&mut self, other: &Self) {
+        for (count, more) in self.counts.iter_mut().zip(&other.counts) {
+            *count += more;
+        }
+        self.total += other.total;
+        self.sum_micros = self.sum_micros.saturating_add(other.sum_micros);
+    }
+
+    pub fn clear(&mut self) {
+        *self = Self::default();
+    }
+
+    /// Samples recorded.
+    #[must_use]
+    pub fn count(&self) -> u64 {
+        self.total
+    }
+
+    /// The exact mean, or `None` with no samples.
+    #[must_use]
+    pub fn mean(&self) -> Option<Duration> {
+        (self.total > 0).then(|| Duration::from_micros(self.sum_micros / self.total))
+    }
+
+    /// The `q` quantile (`0.5` for the median), rounded up to its bucket's
+    /// upper bound, or `None` with no samples.
+    #[must_use]
+    pub fn quantile(&self, q: f64) -> Option<Duration> {
+        if self.total == 0 {
+            return None;
+        }
+        let rank = ((q.clamp(0.0, 1.0) * self.total as f64).ceil() as u64).max(1);
+        let mut seen = 0;
+        let index = self
+            .counts
+            .iter()
+            .position(|&count| {
+                seen += u64::from(count);
+                seen >= rank
+            })
+            .unwrap_or(BUCKETS - 1);
+        Some(Duration::from_micros(bucket_floor(
+            (index + 1).min(BUCKETS - 1),
+        )))
+    }
+}
+
+/// The bucket holding `micros`: its power of two, then which quarter of it.
+fn bucket_of(micros: u64) -> usize {
+    let micros = micros.max(1);
+    let octave = micros.ilog2();
+    let shifted = if octave >= SUB_BUCKET_BITS {
+        micros >> (octave - SUB_BUCKET_BITS)
+    } else {
+        micros << (SUB_BUCKET_BITS - octave)
+    };
+    let sub = shifted & ((1 << SUB_BUCKET_BITS) - 1);
+    (((octave << SUB_BUCKET_BITS) as u64 + sub) as usize).min(BUCKETS - 1)
+}
+
+/// The smallest latency (µs) in bucket `index`.
+fn bucket_floor(index: usize) -> u64 {
+    let octave = (index >> SUB_BUCKET_BITS) as u32;
+    let sub = (index & ((1 << SUB_BUCKET_BITS) - 1)) as u64;
+    ((1u64 << octave) * ((1 << SUB_BUCKET_BITS) + sub)) >> SUB_BUCKET_BITS
+}
+
+/// One stage's latencies, as the Profiler UI shows them.
+#[derive(Clone, Copy, Debug)]
+pub struct StageSummary {
+    pub stage: Stage,
+    pub count: u64,
+    pub mean: Duration,
+    pub p50: Duration,
+    pub p95: Duration,
+    pub p99: Duration,
+}
+
+/// Tile lifecycle stage latencies since startup or the last
+/// [`reset`](Self::reset), one [`LatencyHistogram`] per [`Stage`]. Filled by
+/// the profiler layer on native; always empty on WASM.
+#[derive(Resource, Default)]
+pub struct StageProfile {
+    histograms: [LatencyHistogram; Stage::ALL.len()],
+}
+
+impl StageProfile {
+    /// The stages with samples, in lifecycle order.
+    #[must_use]
+    pub fn summaries(&self) -> Vec<StageSummary> {
+        Stage::ALL
+            .into_iter()
+            .zip(&self.histograms)
+            .filter_map(|(stage, histogram)| {
+                Some(StageSummary {
+                    stage,
+                    count: histogram.count(),
+                    mean: histogram.mean()?,
+                    p50: histogram.quantile(0.5)?,
+                    p95: histogram.quantile(0.95)?,
+                    p99: histogram.quantile(0.99)?,
+                })
+            })
+            .collect()
+    }
+
+    pub fn reset(&mut self) {
+        self.histograms.iter_mut().for_each(LatencyHistogram::clear);
+    }
+}
+
 #[cfg(not(target_family = "wasm"))]
 mod native {
     use std::{
         collections::HashMap,
-        sync::{Mutex, OnceLock},
-        time::{Duration, Instant},
+        io::{self, BufWriter},
+        path::{Path, PathBuf},
+        sync::{
+            Arc, Mutex, OnceLock,
+            atomic::{AtomicBool, AtomicU32, Ordering},
+        },
+        time::{Duration, Instant, SystemTime, UNIX_EPOCH},
     };
 
     use bevy::{
@@ -30,13 +195,21 @@ mod native {
         ecs::{resource::Resource, system::ResMut},
         log::BoxedLayer,
     };
+    use rocktree::stage::{STAGE_SPAN, Stage};
+    use serde::Serialize;
     use tracing::{
         Subscriber,
         field::{Field, Visit},
-        span::{Attributes, Id},
+        span::{Attributes, Id, Record},
     };
     use tracing_subscriber::{Layer, layer::Context, registry::LookupSpan};
 
+    use super::{LatencyHistogram, StageProfile};
+
+    /// Trace events a capture holds before it stops recording by itself,
+    /// a few minutes of a busy frame loop.
+    const MAX_TRACE_EVENTS: usize = 4_000_000;
+
     /// Per-system accumulated timing for one frame.
     #[derive(Clone, Default)]
     pub(crate) struct SystemStats {
@@ -44,14 +217,161 @@ mod native {
         pub count: u32,
     }
 
-    /// Global accumulator the [`ProfilerLayer`] writes into and the
-    /// drain system reads / clears each frame. A static is the
-    /// simplest path given that [`bevy::log::LogPlugin::custom_layer`]
-    /// is a function pointer, not a closure (can't capture state).
-    static ACCUMULATOR: OnceLock<Mutex<HashMap<String, SystemStats>>> = OnceLock::new();
+    /// What the layer has timed on one thread since the last drain.
+    #[derive(Default)]
+    struct Shard {
+        systems: HashMap<String, SystemStats>,
+        stages: [LatencyHistogram; Stage::ALL.len()],
+        /// Trace events, while a capture is recording.
+        trace: Vec<TraceEvent>,
+    }
+
+    /// A thread's [`Shard`], registered in [`SHARDS`] for the drain.
+    struct ThreadShard {
+        /// The thread's id in saved traces.
+        tid: u32,
+        name: Option<String>,
+        /// Locked by its own thread for every write, and by the drain once
+        /// a frame, so it is all but uncontended; threads never wait on
+        /// each other the way they did on one shared map.
+        shard: Mutex<Shard>,
+    }
+
+    /// Every thread's shard. Locked only when a thread first records and
+    /// by the drain. A static is the simplest path given that
+    /// [`bevy::log::LogPlugin::custom_layer`] is a function pointer, not a
+    /// closure (can't capture state).
+    static SHARDS: Mutex<Vec<Arc<ThreadShard>>> = Mutex::new(Vec::new());
+
+    /// Whether a [`TraceCapture`] is recording.
+    static RECORDING: AtomicBool = AtomicBool::new(false);
+
+    thread_local! {
+        static LOCAL: Arc<ThreadShard> = register_thread();
+    }
+
+    fn register_thread() -> Arc<ThreadShard> {
+        static NEXT_TID: AtomicU32 = AtomicU32::new(1);
+        let local = Arc::new(ThreadShard {
+            tid: NEXT_TID.fetch_add(1, Ordering::Relaxed),
+            name: std::thread::current().name().map(str::to_owned),
+            shard: Mutex::default(),
+        });
+        if let Ok(mut shards) = SHARDS.lock() {
+            shards.push(Arc::clone(&local));
+        }
+        local
+    }
+
+    /// Run `f` on the calling thread's shard. Does nothing while the
+    /// thread is tearing down its thread-locals.
+    fn with_shard(f: impl FnOnce(u32, &mut Shard)) {
+        let _ = LOCAL.try_with(|local| {
+            if let Ok(mut shard) = local.shard.lock() {
+                f(local.tid, &mut shard);
+            }
+        });
+    }
+
+    /// Trace timestamps count from here, the moment the layer installed.
+    fn trace_epoch() -> Instant {
+        static EPOCH: OnceLock<Instant> = OnceLock::new();
+        *EPOCH.get_or_init(Instant::now)
+    }
+
+    /// One Chrome trace event: a complete (`"X"`) span, the begin (`"b"`)
+    /// or end (`"e"`) of an async span, or thread-name metadata (`"M"`).
+    /// Times are in microseconds.
+    #[derive(Serialize)]
+    struct TraceEvent {
+        name: String,
+        cat: &'static str,
+        ph: &'static str,
+        ts: f64,
+        #[serde(skip_serializing_if = "Option::is_none")]
+        dur: Option<f64>,
+        pid: u32,
+        tid: u32,
+        /// Async spans with one id share a track, nesting by time.
+        #[serde(skip_serializing_if = "Option::is_none")]
+        id: Option<String>,
+        #[serde(skip_serializing_if = "Option::is_none")]
+        args: Option<TraceArgs>,
+    }
 
-    fn accumulator() -> &'static Mutex<HashMap<String, SystemStats>> {
-        ACCUMULATOR.get_or_init(|| Mutex::new(HashMap::new()))
+    #[derive(Serialize)]
+    enum TraceArgs {
+        #[serde(rename = "name")]
+        ThreadName(String),
+        #[serde(rename = "tile")]
+        Tile(String),
+    }
+
+    /// A saved trace, in the Chrome trace JSON object format.
+    #[derive(Serialize)]
+    struct TraceFile {
+        #[serde(rename = "traceEvents")]
+        trace_events: Vec<TraceEvent>,
+    }
+
+    impl TraceEvent {
+        fn complete(
+            name: String,
+            cat: &'static str,
+            start: Instant,
+            dur: Duration,
+            tid: u32,
+        ) -> Self {
+            let ts = start.saturating_duration_since(trace_epoch());
+            Self {
+                name,
+                cat,
+                ph: "X",
+                ts: ts.as_secs_f64() * 1e6,
+                dur: Some(dur.as_secs_f64() * 1e6),
+                pid: 1,
+                tid,
+                id: None,
+                args: None,
+            }
+        }
+
+        /// The begin and end events of `name`, on the track of `tile`.
+        fn tile_async(
+            name: &'static str,
+            tile: &str,
+            start: Instant,
+            end: Instant,
+            tid: u32,
+        ) -> [Self; 2] {
+            let epoch = trace_epoch();
+            let event = |ph, at: Instant| Self {
+                name: name.to_string(),
+                cat: "tile",
+                ph,
+                ts: at.saturating_duration_since(epoch).as_secs_f64() * 1e6,
+                dur: None,
+                pid: 1,
+                tid,
+                id: Some(tile.to_string()),
+                args: Some(TraceArgs::Tile(tile.to_string())),
+            };
+            [event("b", start), event("e", end)]
+        }
+
+        fn thread_name(tid: u32, name: String) -> Self {
+            Self {
+                name: "thread_name".to_string(),
+                cat: "__metadata",
+                ph: "M",
+                ts: 0.0,
+                dur: None,
+                pid: 1,
+                tid,
+                id: None,
+                args: Some(TraceArgs::ThreadName(name)),
+            }
+        }
     }
 
     /// Per-frame snapshot. Updated by [`drain_accumulator`]; consumed
@@ -65,6 +385,96 @@ mod native {
         pub total: Duration,
     }
 
+    /// A Chrome trace recording of every timed span: systems and tile
+    /// stages, each on the thread it ran on. [`Self::start`] it, then
+    /// [`Self::stop`] and [`Self::save`].
+    #[derive(Resource, Default)]
+    pub struct TraceCapture {
+        events: Vec<TraceEvent>,
+        /// Names of the threads seen, by trace thread id.
+        threads: HashMap<u32, String>,
+        last_saved: Option<PathBuf>,
+    }
+
+    impl TraceCapture {
+        #[must_use]
+        pub fn is_recording(&self) -> bool {
+            RECORDING.load(Ordering::Relaxed)
+        }
+
+        /// Start recording, discarding any unsaved events.
+        pub fn start(&mut self) {
+            self.events.clear();
+            self.threads.clear();
+            RECORDING.store(true, Ordering::Relaxed);
+        }
+
+        pub fn stop(&mut self) {
+            RECORDING.store(false, Ordering::Relaxed);
+        }
+
+        /// Events recorded and not yet saved.
+        #[must_use]
+        pub fn event_count(&self) -> usize {
+            self.events.len()
+        }
+
+        /// Where the last [`Self::save`] wrote.
+        #[must_use]
+        pub fn last_saved(&self) -> Option<&Path> {
+            self.last_saved.as_deref()
+        }
+
+        /// Write the recorded events to `traces/trace-<unix secs>.json` in
+        /// the Chrome trace format, and forget them.
+        pub fn save(&mut self) -> io::Result<PathBuf> {
+            let path = PathBuf::from(format!(
+                "traces/trace-{}.json",
+                SystemTime::now()
+                    .duration_since(UNIX_EPOCH)
+                    .map_or(0, |d| d.as_secs())
+            ));
+            let mut events: Vec<TraceEvent> = self
+                .threads
+                .drain()
+                .map(|(tid, name)| TraceEvent::thread_name(tid, name))
+                .collect();
+            events.append(&mut self.events);
+            std::fs::create_dir_all("traces")?;
+            let file = std::fs::File::create(&path)?;
+            serde_json::to_writer(
+                BufWriter::new(file),
+                &TraceFile {
+                    trace_events: events,
+                },
+            )
+            .map_err(io::Error::other)?;
+            self.last_saved = Some(path.clone());
+            Ok(path)
+        }
+
+        /// Take a thread's events from its shard.
+        fn append(&mut self, local: &ThreadShard, events: &mut Vec<TraceEvent>) {
+            if !self.is_recording() {
+                events.clear();
+                return;
+            }
+            if let Some(name) = &local.name {
+                self.threads
+                    .entry(local.tid)
+                    .or_insert_with(|| name.clone());
+            }
+            self.events.append(events);
+            if self.events.len() >= MAX_TRACE_EVENTS {
+                self.stop();
+                tracing::warn!(
+                    "Trace capture stopped at {} events; save it to keep them",
+                    self.events.len()
+                );
+            }
+        }
+    }
+
     /// Visitor that extracts the `name` field from a `system` span's
     /// recorded attributes — Bevy stores the system's name there.
     #[derive(Default)]
@@ -91,6 +501,35 @@ mod native {
         }
     }
 
+    /// Visitor for a tile stage span's `stage`, `tile` and, for one
+    /// reported after the fact, `micros` fields.
+    #[derive(Default)]
+    struct StageExtractor {
+        stage: Option<Stage>,
+        tile: Option<String>,
+        micros: Option<u64>,
+    }
+
+    impl Visit for StageExtractor {
+        fn record_str(&mut self, field: &Field, value: &str) {
+            if field.name() == "stage" {
+                self.stage = Stage::from_name(value);
+            }
+        }
+        fn record_u64(&mut self, field: &Field, value: u64) {
+            if field.name() == "micros" {
+                self.micros = Some(value);
+            }
+        }
+        fn record_debug(&mut self, field: &Field, value: &dyn std::fmt::Debug) {
+            // `tile` is recorded with `display`, whose `Debug` forwards to
+            // `Display`: no quotes to strip.
+            if field.name() == "tile" {
+                self.tile = Some(format!("{value:?}"));
+            }
+        }
+    }
+
     /// Per-span data we stash via `tracing`'s extensions:
     /// the system name (from `on_new_span`) and the latest enter
     /// timestamp (from `on_enter`).
@@ -99,8 +538,41 @@ mod native {
         entered_at: Option<Instant>,
     }
 
-    /// Tracing layer that times Bevy system spans and accumulates
-    /// per-name totals into the global [`accumulator`].
+    /// A tile stage span in progress, timed from creation to close.
+    struct StageSpan {
+        stage: Stage,
+        tile: Option<String>,
+        created_at: Instant,
+    }
+
+    /// Record a stage that took `elapsed` until `end`. Stages of many tiles
+    /// interleave on one thread without nesting, so a stage of a known tile
+    /// goes on that tile's async track rather than the thread's.
+    fn record_stage(stage: Stage, tile: Option<&str>, elapsed: Duration, end: Instant) {
+        let recording = RECORDING.load(Ordering::Relaxed);
+        with_shard(|tid, shard| {
+            shard.stages[stage as usize].record(elapsed);
+            if recording {
+                let start = end.checked_sub(elapsed).unwrap_or(end);
+                if let Some(tile) = tile {
+                    shard
+                        .trace
+                        .extend(TraceEvent::tile_async(stage.name(), tile, start, end, tid));
+                } else {
+                    shard.trace.push(TraceEvent::complete(
+                        stage.name().to_string(),
+                        "tile",
+                        start,
+                        elapsed,
+                        tid,
+                    ));
+                }
+            }
+        });
+    }
+
+    /// Tracing layer that times Bevy system spans and tile stage spans
+    /// into the calling thread's shard.
     pub struct ProfilerLayer;
 
     impl<S> Layer<S> for ProfilerLayer
@@ -112,19 +584,58 @@ mod native {
             // separate `"system_commands"` span for command flushes.
             // We track only `"system"` — `system_commands` would
             // double-count and pollute the table.
-            if attrs.metadata().name() != "system" {
-                return;
+            match attrs.metadata().name() {
+                "system" => {
+                    let mut extractor = NameExtractor::default();
+                    attrs.record(&mut extractor);
+                    let Some(name) = extractor.name else {
+                        return;
+                    };
+                    if let Some(span) = ctx.span(id) {
+                        span.extensions_mut().insert(SpanData {
+                            name,
+                            entered_at: None,
+                        });
+                    }
+                }
+                STAGE_SPAN => {
+                    let mut extractor = StageExtractor::default();
+                    attrs.record(&mut extractor);
+                    let Some(stage) = extractor.stage else {
+                        return;
+                    };
+                    let now = Instant::now();
+                    if let Some(micros) = extractor.micros {
+                        record_stage(
+                            stage,
+                            extractor.tile.as_deref(),
+                            Duration::from_micros(micros),
+                            now,
+                        );
+                    } else if let Some(span) = ctx.span(id) {
+                        span.extensions_mut().insert(StageSpan {
+                            stage,
+                            tile: extractor.tile,
+                            created_at: now,
+                        });
+                    }
+                }
+                _ => {}
             }
-            let mut extractor = NameExtractor::default();
-            attrs.record(&mut extractor);
-            let Some(name) = extractor.name else {
+        }
+
+        fn on_record(&self, id: &Id, values: &Record<'_>, ctx: Context<'_, S>) {
+            let Some(span) = ctx.span(id) else {
                 return;
             };
-            if let Some(span) = ctx.span(id) {
-                span.extensions_mut().insert(SpanData {
-                    name,
-                    entered_at: None,
-                });
+            let mut extensions = span.extensions_mut();
+            let Some(data) = extensions.get_mut::<StageSpan>() else {
+                return;
+            };
+            let mut extractor = StageExtractor::default();
+            values.record(&mut extractor);
+            if let Some(stage) = extractor.stage {
+                data.stage = stage;
             }
         }
 
@@ -153,10 +664,43 @@ mod native {
                 return;
             };
             let elapsed = entered_at.elapsed();
-            if let Ok(mut acc) = accumulator().lock() {
-                let entry = acc.entry(data.name.clone()).or_default();
-                entry.total += elapsed;
-                entry.count += 1;
+            let recording = RECORDING.load(Ordering::Relaxed);
+            with_shard(|tid, shard| {
+                if let Some(entry) = shard.systems.get_mut(&data.name) {
+                    entry.total += elapsed;
+                    entry.count += 1;
+                } else {
+                    shard.systems.insert(
+                        data.name.clone(),
+                        SystemStats {
+                            total: elapsed,
+                            count: 1,
+                        },
+                    );
+                }
+                if recording {
+                    shard.trace.push(TraceEvent::complete(
+                        data.name.clone(),
+                        "system",
+                        entered_at,
+                        elapsed,
+                        tid,
+                    ));
+                }
+            });
+        }
+
+        fn on_close(&self, id: Id, ctx: Context<'_, S>) {
+            let Some(span) = ctx.span(&id) else {
+                return;
+            };
+            if let Some(data) = span.extensions_mut().remove::<StageSpan>() {
+                record_stage(
+                    data.stage,
+                    data.tile.as_deref(),
+                    data.created_at.elapsed(),
+                    Instant::now(),
+                );
             }
         }
     }
@@ -164,10 +708,11 @@ mod native {
     /// `LogPlugin::custom_layer` callback. Returns the profiler layer
     /// so it gets composed into the global tracing subscriber.
     pub fn install_layer(_app: &mut App) -> Option<BoxedLayer> {
+        trace_epoch();
         Some(Box::new(ProfilerLayer))
     }
 
-    /// Plugin: registers the snapshot resource and the drain system.
+    /// Plugin: registers the snapshot resources and the drain system.
     /// The `LogPlugin`-installed layer is set up separately via
     /// [`install_layer`] passed to [`LogPlugin::custom_layer`].
     pub struct ProfilerPlugin;
@@ -176,6 +721,8 @@ mod native {
         fn build(&self, app: &mut App) {
             app.insert_resource(CpuProfile::default())
                 .insert_resource(ProfilerSmoothing::default())
+                .init_resource::<StageProfile>()
+                .init_resource::<TraceCapture>()
                 .add_systems(Last, drain_accumulator);
         }
     }
@@ -204,16 +751,39 @@ mod native {
     fn drain_accumulator(
         mut profile: ResMut<CpuProfile>,
         mut smoothing: ResMut<ProfilerSmoothing>,
+        mut stages: ResMut<StageProfile>,
+        mut capture: ResMut<TraceCapture>,
     ) {
-        let Ok(mut acc) = accumulator().lock() else {
+        let Ok(mut shards) = SHARDS.lock() else {
             return;
         };
 
-        // Move out, replace with an empty map so the next frame starts
-        // clean and the layer can keep writing concurrently after we
-        // drop the lock.
-        let frame: HashMap<String, SystemStats> = std::mem::take(&mut *acc);
-        drop(acc);
+        // Empty every thread's shard so the next frame starts clean; each
+        // thread's layer keeps writing as soon as its shard is unlocked.
+        let mut frame: HashMap<String, SystemStats> = HashMap::new();
+        for local in shards.iter() {
+            let Ok(mut shard) = local.shard.lock() else {
+                continue;
+            };
+            for (name, stats) in shard.systems.drain() {
+                let entry = frame.entry(name).or_default();
+                entry.total += stats.total;
+                entry.count += stats.count;
+            }
+            for (merged, histogram) in stages.histograms.iter_mut().zip(&mut shard.stages) {
+                if histogram.count() > 0 {
+                    merged.merge(histogram);
+                    histogram.clear();
+                }
+            }
+            if !shard.trace.is_empty() {
+                capture.append(local, &mut shard.trace);
+            }
+        }
+        // A thread that has exited holds no reference to its shard any
+        // more, and what it recorded was drained above.
+        shards.retain(|local| Arc::strong_count(local) > 1);
+        drop(shards);
 
         let alpha = smoothing.alpha;
         // Decay everything not seen this frame toward zero.
@@ -246,7 +816,7 @@ mod native {
 }
 
 #[cfg(not(target_family = "wasm"))]
-pub use native::{CpuProfile, ProfilerPlugin, install_layer};
+pub use native::{CpuProfile, ProfilerPlugin, TraceCapture, install_layer};
 
 #[cfg(target_family = "wasm")]
 mod wasm_stub {
@@ -255,7 +825,13 @@ mod wasm_stub {
         ecs::resource::Resource,
         log::BoxedLayer,
     };
-    use std::time::Duration;
+    use std::{
+        io,
+        path::{Path, PathBuf},
+        time::Duration,
+    };
+
+    use super::StageProfile;
 
     /// Stub matching the native API; always empty on WASM since
     /// `tracing-subscriber` isn't compiled in.
@@ -265,10 +841,44 @@ mod wasm_stub {
         pub total: Duration,
     }
 
+    /// Stub matching the native API; never records on WASM.
+    #[derive(Resource, Default)]
+    pub struct TraceCapture;
+
+    impl TraceCapture {
+        #[must_use]
+        pub fn is_recording(&self) -> bool {
+            false
+        }
+
+        pub fn start(&mut self) {}
+
+        pub fn stop(&mut self) {}
+
+        #[must_use]
+        pub fn event_count(&self) -> usize {
+            0
+        }
+
+        #[must_use]
+        pub fn last_saved(&self) -> Option<&Path> {
+            None
+        }
+
+        pub fn save(&mut self) -> io::Result<PathBuf> {
+            Err(io::Error::new(
+                io::ErrorKind::Unsupported,
+                "trace capture is native-only",
+            ))
+        }
+    }
+
     pub struct ProfilerPlugin;
     impl Plugin for ProfilerPlugin {
         fn build(&self, app: &mut App) {
-            app.insert_resource(CpuProfile::default());
+            app.insert_resource(CpuProfile::default())
+                .init_resource::<StageProfile>()
+                .init_resource::<TraceCapture>();
         }
     }
 
@@ -278,4 +888,39 @@ mod wasm_stub {
 }
 
 #[cfg(target_family = "wasm")]
-pub use wasm_stub::{CpuProfile, ProfilerPlugin, install_layer};
+pub use wasm_stub::{CpuProfile, ProfilerPlugin, TraceCapture, install_layer};
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn quantiles_land_within_a_bucket_of_the_truth() {
+        let mut histogram = LatencyHistogram::default();
+        assert_eq!(histogram.quantile(0.5), None);
+        for micros in 1..=1000 {
+            histogram.record(Duration::from_micros(micros));
+        }
+        let within = |q: f64, truth: u64| {
+            let got = histogram.quantile(q).unwrap().as_micros() as u64;
+            assert!(
+                got >= truth && got <= truth * 5 / 4,
+                "q{q}: {got} vs {truth}"
+            );
+        };
+        within(0.5, 500);
+        within(0.95, 950);
+        within(0.99, 990);
+        assert_eq!(histogram.mean(), Some(Duration::from_micros(500)));
+
+        // Merging per-thread halves gives the same histogram.
+        let (mut low, mut high) = (LatencyHistogram::default(), LatencyHistogram::default());
+        for micros in 1..=1000 {
+            let half = if micros <= 500 { &mut low } else { &mut high };
+            half.record(Duration::from_micros(micros));
+        }
+        low.merge(&high);
+        assert_eq!(low.counts, histogram.counts);
+        assert_eq!(low.quantile(0.99), histogram.quantile(0.99));
+    }
+}
@@ -44,20 +44,41 @@ impl WorldPosition {
     }
 }
 
-/// Update all entity transforms to be relative to the floating origin.
+/// Update entity transforms to be relative to the floating origin.
 ///
 /// This system runs in `PostUpdate` to ensure camera movement is processed first.
-#[allow(clippy::type_complexity)]
+///
+/// Only entities whose translation can have gone stale are rewritten: all of
+/// them when the origin has moved since the last run, otherwise just those
+/// whose `WorldPosition` or `Transform` changed (a `Transform` written by
+/// something else, such as the physics position copy, is re-derived). A write
+/// is skipped when the translation already matches, so with the camera at rest
+/// the resident terrain tiles never trip change detection or transform
+/// propagation. The render frame itself stays camera-centred: the cloud,
+/// atmosphere and overlay passes all rely on the camera sitting at its origin.
 fn update_transforms_relative_to_origin(
     origin: Res<FloatingOrigin>,
-    mut query: Query<(&WorldPosition, &mut Transform), Without<FloatingOriginCamera>>,
+    mut last_origin: Local<Option<DVec3>>,
+    mut query: Query<(Ref<WorldPosition>, &mut Transform), Without<FloatingOriginCamera>>,
 ) {
+    // The origin resource is rewritten every frame, so compare its value
+    // rather than its change tick.
+    let origin_moved = *last_origin != Some(origin.position);
+    *last_origin = Some(origin.position);
+
     for (world_pos, mut transform) in &mut query {
+        if !(origin_moved || world_pos.is_changed() || transform.is_changed()) {
+            continue;
+        }
+
         // Compute position relative to origin.
         let relative = world_pos.position - origin.position;
 
         // Convert to f32 for rendering (safe because relative coords are small).
-        transform.translation = Vec3::new(relative.x as f32, relative.y as f32, relative.z as f32);
+        let translation = Vec3::new(relative.x as f32, relative.y as f32, relative.z as f32);
+        if transform.translation != translation {
+            transform.translation = translation;
+        }
     }
 }
 
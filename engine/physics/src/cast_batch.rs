@@ -0,0 +1,144 @@
+//! Batched shape casts against the physics world.
+//!
+//! Gameplay that sweeps many shapes per fixed step — every wheel of every
+//! vehicle, every free-flight stretch of the leap preview — submits them here
+//! together instead of one [`SpatialQuery::cast_shape`] call at a time. The
+//! batch is ordered along a Morton curve of the cast origins, so sweeps that
+//! start near each other run back-to-back and walk the same BVH nodes while
+//! they are still in cache, and is split into contiguous runs across the
+//! [`ComputeTaskPool`]. Results come back in submission order.
+
+use avian3d::prelude::*;
+use bevy::{prelude::*, tasks::ComputeTaskPool};
+
+/// Casts per task below which the batch runs inline: spawning is not free, and
+/// a handful of sweeps finishes before a task would be picked up.
+const MIN_CASTS_PER_TASK: usize = 8;
+
+/// Edge of the grid cell cast origins are bucketed into for ordering; about a
+/// vehicle's length, so one car's wheels share a cell.
+const ORDER_CELL_M: f32 = 4.0;
+
+/// One sweep in a batch: `shape` at `origin` and `rotation`, moved along
+/// `direction` for at most `max_distance`.
+#[derive(Clone, Copy)]
+pub struct BatchedCast<'a> {
+    pub shape: &'a Collider,
+    pub origin: Vec3,
+    pub rotation: Quat,
+    pub direction: Dir3,
+    pub max_distance: f32,
+}
+
+/// Cast every sweep in `casts` through `filter`, returning each first hit (or
+/// `None`) at its index in `casts`.
+#[must_use]
+pub fn cast_shapes_batched(
+    spatial_query: &SpatialQuery,
+    casts: &[BatchedCast],
+    filter: &SpatialQueryFilter,
+) -> Vec<Option<ShapeHitData>> {
+    let cast = |c: &BatchedCast| {
+        let config = ShapeCastConfig {
+            max_distance: c.max_distance,
+            ..Default::default()
+        };
+        spatial_query.cast_shape(c.shape, c.origin, c.rotation, c.direction, &config, filter)
+    };
+
+    let order = spatial_order(casts.iter().map(|c| c.origin));
+    let pool = ComputeTaskPool::get();
+    let tasks = pool
+        .thread_num()
+        .min(casts.len() / MIN_CASTS_PER_TASK)
+        .max(1);
+    let mut results = vec![None; casts.len()];
+    if tasks == 1 {
+        for &index in &order {
+            results[index] = cast(&casts[index]);
+        }
+        return results;
+    }
+
+    let runs = pool.scope(|scope| {
+        for run in order.chunks(order.len().div_ceil(tasks)) {
+            let cast = &cast;
+            scope.spawn(async move {
+                run.iter()
+                    .map(|&index| (index, cast(&casts[index])))
+                    .collect::<Vec<_>>()
+            });
+        }
+    });
+    for (index, hit) in runs.into_iter().flatten() {
+        results[index] = hit;
+    }
+    results
+}
+
+/// Indices of `origins` sorted along a Morton curve of their
+/// [`ORDER_CELL_M`] grid cells, ties kept in submission order.
+fn spatial_order(origins: impl Iterator<Item = Vec3>) -> Vec<usize> {
+    let mut keyed: Vec<(u64, usize)> = origins
+        .enumerate()
+        .map(|(index, origin)| (morton_key(origin), index))
+        .collect();
+    keyed.sort_unstable();
+    keyed.into_iter().map(|(_, index)| index).collect()
+}
+
+/// Interleave the bits of an origin's grid cell (21 bits per axis, biased so
+/// the camera-relative range around zero stays contiguous).
+fn morton_key(origin: Vec3) -> u64 {
+    const BIAS: i64 = 1 << 20;
+    let spread = |value: f32| {
+        let cell = ((value / ORDER_CELL_M).floor() as i64 + BIAS).clamp(0, (1 << 21) - 1) as u64;
+        let mut bits = cell;
+        bits = (bits | bits << 32) & 0x001f_0000_0000_ffff;
+        bits = (bits | bits << 16) & 0x001f_0000_ff00_00ff;
+        bits = (bits | bits << 8) & 0x100f_00f0_0f00_f00f;
+        bits = (bits | bits << 4) & 0x10c3_0c30_c30c_30c3;
+        (bits | bits << 2) & 0x1249_2492_4924_9249
+    };
+    spread(origin.x) | spread(origin.y) << 1 | spread(origin.z) << 2
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn nearby_origins_sort_together() {
+        // Two clusters far apart, submitted interleaved.
+        let origins = [
+            Vec3::new(0.5, 0.5, 0.5),
+            Vec3::new(900.0, -40.0, 3.0),
+            Vec3::new(1.0, 0.2, 0.9),
+            Vec3::new(901.0, -39.0, 2.0),
+            Vec3::new(0.1, 1.5, 0.3),
+        ];
+        let order = spatial_order(origins.into_iter());
+        let cluster = |index: usize| origins[index].x > 100.0;
+        let switches = order
+            .windows(2)
+            .filter(|pair| cluster(pair[0]) != cluster(pair[1]))
+            .count();
+        assert_eq!(switches, 1, "{order:?}");
+
+        // Origins in one cell keep their submission order.
+        assert_eq!(
+            order.iter().filter(|&&i| !cluster(i)).collect::<Vec<_>>(),
+            [&0, &2, &4]
+        );
+    }
+
+    #[test]
+    fn morton_keys_interleave_axes() {
+        let base = morton_key(Vec3::ZERO);
+        let step = |axis: Vec3| morton_key(axis * ORDER_CELL_M) ^ base;
+        // One cell along x, y or z flips the lowest bit of that axis's lane.
+        assert_eq!(step(Vec3::X), 0b001);
+        assert_eq!(step(Vec3::Y), 0b010);
+        assert_eq!(step(Vec3::Z), 0b100);
+    }
+}
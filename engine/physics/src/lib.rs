@@ -20,11 +20,13 @@
 //! correct relative positions.
 //!
 //! The crate is gameplay-agnostic: it owns radial gravity, origin shifting,
-//! and terrain colliders, but knows nothing about projectiles, vehicles, or
-//! camera modes. Entities that integrate gravity themselves opt out with
-//! [`ManualGravity`]; entities that should be cleaned up beyond
-//! [`PhysicsStreamingConfig::range`] carry [`DespawnOutsidePhysicsRange`].
+//! terrain colliders, and batched shape casts ([`cast_shapes_batched`]), but
+//! knows nothing about projectiles, vehicles, or camera modes. Entities that
+//! integrate gravity themselves opt out with [`ManualGravity`]; entities that
+//! should be cleaned up beyond [`PhysicsStreamingConfig::range`] carry
+//! [`DespawnOutsidePhysicsRange`].
 
+mod cast_batch;
 mod gravity;
 mod layers;
 pub mod terrain;
@@ -49,6 +51,7 @@ use serde::Deserialize;
 use veldera_config::ConfigPlugin;
 use veldera_geo::floating_origin::{FloatingOriginCamera, WorldPosition};
 
+pub use cast_batch::{BatchedCast, cast_shapes_batched};
 pub use layers::GameLayer;
 pub use terrain::TerrainCollider;
 
@@ -248,6 +251,40 @@ pub struct PhysicsStreamingConfig {
     /// borders (per-tile coupling; superseded by v4 clipmaps). Off keeps the halo
     /// overlap, which is bumpier but never holed.
     pub wrap_cell_clip: bool,
+    /// Side (m) of a camera-centred (v4) collider chunk. Small enough that a
+    /// move dirties only a thin leading edge and that one leaf size per chunk
+    /// still follows the rings closely; large enough that the reach stays a
+    /// couple of hundred chunks. Zero pauses the camera-centred reconcile.
+    pub chunk_size: f32,
+    /// How far (m) past its square a chunk gathers tiles, so the soup the
+    /// extractor crops reaches [`Self::chunk_soup_margin`] on every side.
+    pub chunk_tile_margin: f32,
+    /// How far (m) past its square a chunk keeps the gathered soup, so the
+    /// extractors see the geometry just outside it (building footprints
+    /// straddling it, the background fill) the same way a neighbouring chunk
+    /// does.
+    pub chunk_soup_margin: f32,
+    /// Slack (m) before a chunk changes ring, so a camera idling on a ring
+    /// boundary doesn't rebuild the chunks along it every frame.
+    pub chunk_ring_hysteresis: f32,
+    /// Chunk builds in flight at once. The nearest dirty chunks go first, so
+    /// the ground underfoot never queues behind the far field.
+    pub max_chunk_builds: usize,
+    /// Re-anchor the chunk grid once the camera is this far (m) from its
+    /// anchor. The grid lies in the anchor's tangent plane, so it drifts off
+    /// the curved ground with distance; re-anchoring rebuilds every chunk, so
+    /// it should stay rare.
+    pub chunk_reanchor_distance: f64,
+    /// Lattice (m) the chunk grid's anchor snaps to, so a revisit lays the
+    /// grid out exactly as before and finds its chunks in the geometry cache.
+    /// The lattice runs along the surface (rows of latitude, columns of
+    /// longitude spaced this far apart) with shells this far apart in radius.
+    pub chunk_anchor_snap: f64,
+    /// Size limit (bytes) of the on-disk cache of settled chunk surfaces,
+    /// which lets a revisit read its chunks back instead of re-extracting
+    /// them. The least recently used go first past it. Zero disables the
+    /// cache.
+    pub chunk_geometry_cache_max_size: u64,
     /// Lookahead time for the lead vector (s); colliders ahead of the player
     /// load at the next-finer band before the player arrives.
     pub lead_time: f64,
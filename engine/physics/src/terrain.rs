@@ -9,6 +9,7 @@ use std::collections::HashMap;
 use avian3d::prelude::*;
 use bevy::prelude::*;
 use rocktree::Mesh as RocktreeMesh;
+use rocktree_decode::strip_to_triangle_list;
 
 /// Marker component for terrain colliders.
 ///
@@ -105,7 +106,7 @@ fn merge_meshes(
             transform.rotation * (transform.scale * local)
         }));
         triangles.extend(
-            strip_to_triangles(&mesh.indices)
+            strip_to_triangle_list(&mesh.indices)
                 .into_iter()
                 .map(|[a, b, c]| [a + base, b + base, c + base])
                 .filter(|&[a, b, c]| {
@@ -177,37 +178,6 @@ fn is_sliver(a: Vec3, b: Vec3, c: Vec3, min_height: f32) -> bool {
     double_area / longest < min_height
 }
 
-/// Convert a triangle strip to a list of triangle index tuples.
-///
-/// Handles degenerate triangles (where two or more indices are the same).
-fn strip_to_triangles(strip: &[u16]) -> Vec<[u32; 3]> {
-    if strip.len() < 3 {
-        return Vec::new();
-    }
-
-    let mut triangles = Vec::with_capacity(strip.len());
-
-    for i in 0..strip.len() - 2 {
-        let a = u32::from(strip[i]);
-        let b = u32::from(strip[i + 1]);
-        let c = u32::from(strip[i + 2]);
-
-        // Skip degenerate triangles.
-        if a == b || b == c || a == c {
-            continue;
-        }
-
-        // Alternate winding order for triangle strips.
-        if i % 2 == 0 {
-            triangles.push([a, b, c]);
-        } else {
-            triangles.push([a, c, b]);
-        }
-    }
-
-    triangles
-}
-
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -252,6 +222,7 @@ mod tests {
             texture_format: TextureFormat::Rgb,
             texture_width: 0,
             texture_height: 0,
+            texture_mip_levels: 1,
             has_octant_data,
         }
     }
@@ -408,14 +379,14 @@ mod tests {
 
     #[test]
     fn test_strip_to_triangles_empty() {
-        assert!(strip_to_triangles(&[]).is_empty());
-        assert!(strip_to_triangles(&[0, 1]).is_empty());
+        assert!(strip_to_triangle_list(&[]).is_empty());
+        assert!(strip_to_triangle_list(&[0, 1]).is_empty());
     }
 
     #[test]
     fn test_strip_to_triangles_simple() {
         let strip = vec![0, 1, 2, 3];
-        let triangles = strip_to_triangles(&strip);
+        let triangles = strip_to_triangle_list(&strip);
         // First triangle: [0, 1, 2].
         // Second triangle: [1, 3, 2] (reversed winding).
         assert_eq!(triangles, vec![[0, 1, 2], [1, 3, 2]]);
@@ -425,7 +396,7 @@ mod tests {
     fn test_strip_to_triangles_degenerate() {
         // Degenerate: indices 0,1,1 and 1,1,2.
         let strip = vec![0, 1, 1, 2];
-        let triangles = strip_to_triangles(&strip);
+        let triangles = strip_to_triangle_list(&strip);
         assert!(triangles.is_empty());
     }
 }
@@ -14,7 +14,7 @@ use avian3d::prelude::*;
 use bevy::prelude::*;
 
 pub use veldera_terrain_collider::{
-    BuildSettings, BuildStats, BuiltGeometry, TileMeshes,
+    BuildSettings, BuildStats, BuiltGeometry, NeighbourSurface, SurfaceProbe, TileMeshes,
     roads::{CarveSettings, RoadRibbon},
 };
 
@@ -27,13 +27,14 @@ pub use veldera_terrain_collider::{
 /// emitted where this tile owns it (empty `roads` is the plain build). Returns
 /// the collider (or `None` for an empty build — a mask that removed all
 /// geometry, which callers should record as a live empty commit) along with
-/// the build statistics either way.
+/// the build statistics either way. `neighbours` are the adjacent tiles'
+/// probed surfaces; keep one [`SurfaceProbe`] per tile across builds.
 #[allow(clippy::too_many_arguments)]
 pub fn create_terrain_collider(
     tile: &TileMeshes,
     octant_mask: u8,
     sub_cut: u64,
-    neighbours: &[TileMeshes],
+    neighbours: &[NeighbourSurface],
     down: Vec3,
     settings: &BuildSettings,
     roads: &[RoadRibbon],
@@ -15,6 +15,8 @@
 //! wrap's curtains are gone. 2.5D is the accepted scope; true 3D (tunnels, stacked
 //! freeways) is a later layer via OSM-carved passages, not a 3D extractor.
 
+use std::hash::Hasher;
+
 use avian3d::prelude::*;
 use bevy::prelude::*;
 
@@ -23,17 +25,22 @@ pub use veldera_terrain_collider::{
 };
 use veldera_terrain_collider::{
     build_tile_geometry,
+    geometry_cache::StableHasher,
     heightfield::build_height_quadtree,
-    octree3d::{Octree3d, smooth_mesh},
+    octree3d::{Frame, Octree3d, smooth_mesh},
 };
 
 /// Settings for the experimental 3D octree extractor: the octree build knobs plus
-/// the collapse error bound, the skirt depth (cells), and an optional Laplacian
-/// smoothing pass. Distinct from [`HeightfieldSettings`] — the octree is full 3D
-/// (real building walls, threshold-free), where the height field is 2.5D.
+/// the reach, the collapse error bound, the skirt depth (cells), and an optional
+/// Laplacian smoothing pass. Distinct from [`HeightfieldSettings`] — the octree is
+/// full 3D (real building walls, threshold-free), where the height field is 2.5D.
 #[derive(Debug, Clone, Copy)]
 pub struct OctreeColliderSettings {
     pub octree: Octree3dSettings,
+    /// Horizontal half-extent (m) of the square around the origin the surface is
+    /// kept within. The octree root isn't aligned to anything outside the soup, so
+    /// surfaces built side by side overlap by a cell rather than meeting exactly.
+    pub reach: f32,
     /// QEF residual bound for coplanar-cell collapse (0 disables).
     pub collapse_error: f32,
     /// Skirt depth (cells) plugging LOD-boundary cracks on thin sheets.
@@ -44,6 +51,26 @@ pub struct OctreeColliderSettings {
     pub smooth_lambda: f32,
 }
 
+impl OctreeColliderSettings {
+    /// Feed every knob into a geometry-cache key (see
+    /// [`veldera_terrain_collider::geometry_cache`]).
+    pub fn hash_into(&self, hasher: &mut StableHasher) {
+        let Self {
+            octree,
+            reach,
+            collapse_error,
+            skirt_cells,
+            smooth_iters,
+            smooth_lambda,
+        } = *self;
+        octree.hash_into(hasher);
+        for value in [reach, collapse_error, skirt_cells, smooth_lambda] {
+            hasher.write_f32(value);
+        }
+        hasher.write_u32(smooth_iters);
+    }
+}
+
 /// Base-soup settings for the gather: octant clipping only, none of the seam
 /// treatment or density reduction (the height extractor reconstructs its own
 /// surface). Identical to the v3 base settings.
@@ -56,17 +83,34 @@ const BASE_SETTINGS: BuildSettings = BuildSettings {
 };
 
 /// Build the camera-centred collider by combining the displayed composite tiles
-/// into one soup and extracting a 2.5D drivable-height surface from it. `tiles` are
-/// the tiles around the camera, each `TileMeshes` already offset into the
-/// camera-centred frame (its `offset = (tile.world_position − centre)`), paired with
-/// its octant mask. `down` is the radial down. Returns `None` if nothing extracts
-/// (e.g. no loaded geometry).
+/// into one soup and extracting a 2.5D drivable-height surface from it; see
+/// [`build_height_surface`].
 pub fn create_height_collider(
     tiles: &[(TileMeshes, u8)],
     down: Vec3,
     settings: &HeightfieldSettings,
+    soup_margin: f32,
 ) -> Option<Collider> {
-    let (soup_vertices, soup_triangles) = combine_soup(tiles, down)?;
+    let (vertices, triangles) = build_height_surface(tiles, down, settings, soup_margin)?;
+    Collider::try_trimesh(vertices, triangles).ok()
+}
+
+/// Combine the displayed composite tiles into one soup and extract a 2.5D
+/// drivable-height surface from it. `tiles` are the tiles around the camera, each
+/// `TileMeshes` already offset into the camera-centred frame (its
+/// `offset = (tile.world_position − centre)`), paired with its octant mask. `down`
+/// is the radial down. The surface covers the square of half-extent
+/// `settings.radius` around the origin; the soup is kept `soup_margin` m past
+/// it, so the extractor sees the geometry just outside its square (building
+/// footprints straddling it, the background fill) the same way a neighbouring
+/// square does. Returns `None` if nothing extracts (e.g. no loaded geometry).
+pub fn build_height_surface(
+    tiles: &[(TileMeshes, u8)],
+    down: Vec3,
+    settings: &HeightfieldSettings,
+    soup_margin: f32,
+) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+    let (soup_vertices, soup_triangles) = combine_soup(tiles, down, settings.radius + soup_margin)?;
     let soup_tris = soup_triangles.len();
 
     let up = -down.normalize_or_zero();
@@ -82,20 +126,35 @@ pub fn create_height_collider(
         tiles.len(),
         triangles.len()
     );
+    Some((vertices, triangles))
+}
+
+/// Build the camera-centred collider with the experimental 3D octree extractor;
+/// see [`build_octree_surface`].
+pub fn create_octree_collider(
+    tiles: &[(TileMeshes, u8)],
+    down: Vec3,
+    settings: &OctreeColliderSettings,
+    soup_margin: f32,
+) -> Option<Collider> {
+    let (vertices, triangles) = build_octree_surface(tiles, down, settings, soup_margin)?;
     Collider::try_trimesh(vertices, triangles).ok()
 }
 
-/// Build the camera-centred collider with the experimental 3D octree extractor:
+/// Extract the camera-centred surface with the experimental 3D octree extractor:
 /// combine the tile soup, build + sky-flood the sparse octree, dual-contour with
 /// coplanar-cell collapse, and (optionally) Laplacian-smooth. Full 3D — real
 /// building walls, no clutter classification — at higher cost than the height
-/// field. `tiles`/`down` as for [`create_height_collider`].
-pub fn create_octree_collider(
+/// field. `tiles`/`down`/`soup_margin` as for [`build_height_surface`]; the
+/// surface covers the square of half-extent `settings.reach`, plus a cell of
+/// overlap.
+pub fn build_octree_surface(
     tiles: &[(TileMeshes, u8)],
     down: Vec3,
     settings: &OctreeColliderSettings,
-) -> Option<Collider> {
-    let (soup_vertices, soup_triangles) = combine_soup(tiles, down)?;
+    soup_margin: f32,
+) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+    let (soup_vertices, soup_triangles) = combine_soup(tiles, down, settings.reach + soup_margin)?;
     let soup_tris = soup_triangles.len();
 
     let up = -down.normalize_or_zero();
@@ -115,6 +174,11 @@ pub fn create_octree_collider(
     } else {
         vertices
     };
+    let keep = settings.reach + settings.octree.far_voxel;
+    let triangles = crop_triangles(&vertices, triangles, Frame::new(up), keep);
+    if triangles.is_empty() {
+        return None;
+    }
 
     info!(
         target: "collider_v4",
@@ -122,13 +186,19 @@ pub fn create_octree_collider(
         tiles.len(),
         triangles.len()
     );
-    Collider::try_trimesh(vertices, triangles).ok()
+    Some((vertices, triangles))
 }
 
-/// Combine every tile's octant-clipped soup into one camera-centred soup. The tile
-/// offsets already place each in the frame, so concatenation needs no further
-/// shift. `None` when nothing survives.
-fn combine_soup(tiles: &[(TileMeshes, u8)], down: Vec3) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+/// Combine every tile's octant-clipped soup into one camera-centred soup, keeping
+/// only triangles that reach into the square of half-extent `keep` around the
+/// origin (in the up-aligned frame). The tile offsets already place each in the
+/// frame, so concatenation needs no further shift. `None` when nothing survives.
+fn combine_soup(
+    tiles: &[(TileMeshes, u8)],
+    down: Vec3,
+    keep: f32,
+) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+    let frame = Frame::new(-down.normalize_or_zero());
     let mut soup_vertices: Vec<Vec3> = Vec::new();
     let mut soup_triangles: Vec<[u32; 3]> = Vec::new();
     for (tile, mask) in tiles {
@@ -136,12 +206,23 @@ fn combine_soup(tiles: &[(TileMeshes, u8)], down: Vec3) -> Option<(Vec<Vec3>, Ve
             continue;
         };
         let base_index = soup_vertices.len() as u32;
-        soup_vertices.extend(soup.vertices);
+        let reaches_in = |&[a, b, c]: &[u32; 3]| {
+            let (lo, hi) =
+                [a, b, c]
+                    .iter()
+                    .fold((Vec2::INFINITY, Vec2::NEG_INFINITY), |(lo, hi), &i| {
+                        let p = frame.to_frame(soup.vertices[i as usize]).truncate();
+                        (lo.min(p), hi.max(p))
+                    });
+            lo.cmple(Vec2::splat(keep)).all() && hi.cmpge(Vec2::splat(-keep)).all()
+        };
         soup_triangles.extend(
             soup.triangles
                 .iter()
+                .filter(|t| reaches_in(t))
                 .map(|&[a, b, c]| [a + base_index, b + base_index, c + base_index]),
         );
+        soup_vertices.extend(soup.vertices);
     }
     if soup_triangles.is_empty() {
         None
@@ -149,3 +230,22 @@ fn combine_soup(tiles: &[(TileMeshes, u8)], down: Vec3) -> Option<(Vec<Vec3>, Ve
         Some((soup_vertices, soup_triangles))
     }
 }
+
+/// Drop the triangles whose centroid lies outside the square of half-extent
+/// `keep` around the origin, in `frame`.
+fn crop_triangles(
+    vertices: &[Vec3],
+    triangles: Vec<[u32; 3]>,
+    frame: Frame,
+    keep: f32,
+) -> Vec<[u32; 3]> {
+    triangles
+        .into_iter()
+        .filter(|&[a, b, c]| {
+            let centroid =
+                (vertices[a as usize] + vertices[b as usize] + vertices[c as usize]) / 3.0;
+            let p = frame.to_frame(centroid).truncate();
+            p.x.abs() <= keep && p.y.abs() <= keep
+        })
+        .collect()
+}
@@ -16,7 +16,7 @@ use serde::Deserialize;
 use veldera_atmosphere::{
     AtmosphereSettings, ExtractedAtmosphereLights, GpuAtmosphereLight, MAX_ATMOSPHERE_LIGHTS,
     SphericalAtmosphere, SphericalAtmosphereCamera, SphericalAtmosphereEnvironmentMapLight,
-    compute_sun_transmittance,
+    SunTransmittanceTable,
 };
 
 use veldera_config::ConfigPlugin;
@@ -39,9 +39,9 @@ pub struct AtmosphereConfig {
     /// Ground albedo (linear RGB, 0–1) the sky bounces light off. Higher =
     /// brighter horizon and more multiple-scattering fill.
     pub ground_albedo: [f32; 3],
-    /// LUT sizes, sample counts, aerial-view range, and render method. All
-    /// fields hot-reload (the LUT textures are descriptor-cached, so a size
-    /// change reallocates them).
+    /// LUT sizes, sample counts, aerial-view range, render method, and LUT
+    /// regeneration tolerances. All fields hot-reload (a size change
+    /// reallocates the LUT textures; any other change re-renders the LUTs).
     pub settings: AtmosphereSettings,
 }
 
@@ -194,6 +194,10 @@ fn sync_atmosphere_camera(
 /// twilight transmittance and is geometrically occluded below the local
 /// horizon.
 ///
+/// The transmittance comes from a [`SunTransmittanceTable`], rebuilt only when
+/// the atmosphere, its medium asset or the midpoint ratio change, so a
+/// time-of-day scrub costs two table lookups a frame.
+///
 /// Note: because the atmosphere LUT reads the same `DirectionalLight.color`,
 /// this introduces a small double-application of extinction in scattered
 /// sky brightness near the horizon. In practice the daytime effect is
@@ -204,6 +208,8 @@ fn update_atmospheric_light_extinction(
     camera: Query<&FloatingOriginCamera>,
     atmospheres: Query<(&SphericalAtmosphere, &AtmosphereSettings), With<Camera3d>>,
     media: Res<Assets<ScatteringMedium>>,
+    mut medium_events: MessageReader<AssetEvent<ScatteringMedium>>,
+    mut table: Local<Option<SunTransmittanceTable>>,
     mut lights: Query<(&Transform, &mut DirectionalLight, &AtmosphericLight)>,
 ) {
     let Ok(camera) = camera.single() else {
@@ -216,6 +222,19 @@ fn update_atmospheric_light_extinction(
         return;
     };
 
+    let medium_edited = medium_events
+        .read()
+        .any(|event| event.is_modified(&atmosphere.medium));
+    let table = if settings.light_extinction {
+        let ratio = settings.sun_transmittance_midpoint_ratio;
+        if medium_edited || !table.as_ref().is_some_and(|t| t.matches(atmosphere, ratio)) {
+            *table = None;
+        }
+        Some(table.get_or_insert_with(|| SunTransmittanceTable::new(atmosphere, medium, ratio)))
+    } else {
+        None
+    };
+
     let r = camera.position.length() as f32;
     let local_up = camera.position.normalize().as_vec3();
 
@@ -225,16 +244,9 @@ fn update_atmospheric_light_extinction(
         let dir = transform.back().as_vec3();
         let mu = dir.dot(local_up);
 
-        let transmittance = if settings.light_extinction {
-            compute_sun_transmittance(
-                atmosphere,
-                medium,
-                r,
-                mu,
-                settings.sun_transmittance_midpoint_ratio,
-            )
-        } else {
-            Vec3::ONE
+        let transmittance = match &table {
+            Some(table) => table.sample(medium, r, mu),
+            None => Vec3::ONE,
         };
         let base = atmo_light.base_color;
         light.color = Color::LinearRgba(LinearRgba::new(
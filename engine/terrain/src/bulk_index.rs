@@ -0,0 +1,199 @@
+//! Dense child lookup for the nodes of a cached bulk.
+//!
+//! The LoD walk visits every child octant of every node it refines, so
+//! finding a child's metadata is its innermost operation. A per-bulk
+//! `HashMap` from relative path to node index hashed a 16-byte path per
+//! octant and scattered the lookups across the heap. [`BulkNodeIndex`]
+//! instead sorts a bulk's nodes into level order — each node's children
+//! are one contiguous run, in octant order — and stores per node where
+//! that run starts and which octants it holds. A child lookup is a bit test
+//! and a popcount, and the eight children of a node sit next to each other
+//! in memory.
+
+use std::collections::HashMap;
+
+use rocktree::BulkMetadata;
+use rocktree_decode::OctreePath;
+
+/// One node's children: a run of the bulk's nodes starting at `first`, one
+/// per set bit of `mask`, in octant order.
+#[derive(Clone, Copy, Debug, Default)]
+struct Children {
+    first: u32,
+    mask: u8,
+}
+
+/// A position in a [`BulkNodeIndex`]: the bulk's root (which lives in the
+/// parent bulk) or one of its nodes.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) struct NodeSlot(u32);
+
+impl NodeSlot {
+    /// The bulk's root, whose children are the bulk's first level.
+    pub(crate) const BULK_ROOT: Self = Self(0);
+
+    /// Index of this slot's node in the bulk's `nodes`, or `None` for the
+    /// bulk root.
+    pub(crate) fn node(self) -> Option<usize> {
+        (self.0 as usize).checked_sub(1)
+    }
+}
+
+/// Child links for one bulk's nodes, built by [`Self::build`].
+#[derive(Debug, Default)]
+pub(crate) struct BulkNodeIndex {
+    /// `children[0]` for the bulk root, `children[i + 1]` for node `i`.
+    children: Vec<Children>,
+}
+
+impl BulkNodeIndex {
+    /// Sort `bulk`'s nodes into level order (dropping duplicate paths) and
+    /// index them. `bulk_key` is the bulk's full path, the key it is cached
+    /// under; nodes outside it are kept but unreachable.
+    pub(crate) fn build(bulk_key: OctreePath, bulk: &mut BulkMetadata) -> Self {
+        bulk.nodes
+            .sort_by_cached_key(|node| level_order_key(node.path.strip_prefix(bulk_key)));
+        bulk.nodes.dedup_by_key(|node| node.path);
+
+        let mut children = vec![Children::default(); bulk.nodes.len() + 1];
+        // Only used while building: the walk never hashes a path.
+        let mut slots: HashMap<OctreePath, u32> = HashMap::with_capacity(bulk.nodes.len());
+        slots.insert(OctreePath::ROOT, 0);
+        for (i, node) in bulk.nodes.iter().enumerate() {
+            let Some(rel) = node
+                .path
+                .strip_prefix(bulk_key)
+                .filter(|rel| !rel.is_root())
+            else {
+                continue;
+            };
+            let (Some(parent), Some(octant)) = (rel.parent(), rel.octant_at(rel.depth() - 1))
+            else {
+                continue;
+            };
+            // An orphan: the walk can't reach it through its parent either.
+            let Some(&parent_slot) = slots.get(&parent) else {
+                continue;
+            };
+            let run = &mut children[parent_slot as usize];
+            if run.mask == 0 {
+                run.first = i as u32;
+            }
+            run.mask |= 1 << octant;
+            slots.insert(rel, i as u32 + 1);
+        }
+        Self { children }
+    }
+
+    /// The slot of `parent`'s child in `octant`, if the bulk lists one.
+    #[inline]
+    pub(crate) fn child(&self, parent: NodeSlot, octant: u8) -> Option<NodeSlot> {
+        let run = self.children.get(parent.0 as usize)?;
+        let bit = 1u8 << octant;
+        (run.mask & bit != 0).then(|| NodeSlot(run.first + (run.mask & (bit - 1)).count_ones() + 1))
+    }
+
+    /// The slot of the node at `rel`, a path relative to the bulk.
+    pub(crate) fn slot(&self, rel: OctreePath) -> Option<NodeSlot> {
+        rel.octants()
+            .try_fold(NodeSlot::BULK_ROOT, |slot, octant| self.child(slot, octant))
+    }
+
+    /// Index into the bulk's `nodes` of the node at `rel`, a path relative
+    /// to the bulk.
+    pub(crate) fn get(&self, rel: OctreePath) -> Option<usize> {
+        self.slot(rel)?.node()
+    }
+}
+
+/// Sort key putting shallower paths first and, within a depth, ordering by
+/// octants from the first: siblings end up adjacent and in octant order.
+/// Paths outside the bulk sort last.
+fn level_order_key(rel: Option<OctreePath>) -> (usize, u128) {
+    rel.map_or((usize::MAX, 0), |rel| {
+        let digits = rel
+            .octants()
+            .fold(0u128, |key, octant| key << 3 | u128::from(octant));
+        (rel.depth(), digits)
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use glam::{DMat3, DVec3, Vec3};
+    use rocktree::NodeMetadata;
+    use rocktree_decode::OrientedBoundingBox;
+
+    use super::*;
+
+    fn bulk(key: OctreePath, rels: &[&str]) -> BulkMetadata {
+        let nodes = rels
+            .iter()
+            .map(|rel| NodeMetadata {
+                path: key.extend(OctreePath::parse(rel).unwrap()),
+                meters_per_texel: 1.0,
+                obb: OrientedBoundingBox {
+                    center: DVec3::ZERO,
+                    extents: DVec3::ONE,
+                    orientation: DMat3::IDENTITY,
+                },
+                has_data: true,
+                epoch: 0,
+                texture_format: 0,
+                imagery_epoch: None,
+            })
+            .collect();
+        BulkMetadata {
+            path: key,
+            head_node_center: Vec3::ZERO,
+            meters_per_texel: Vec::new(),
+            nodes,
+            child_bulk_paths: HashMap::new(),
+            epoch: 0,
+        }
+    }
+
+    #[test]
+    fn lookups_find_every_node_whatever_the_input_order() {
+        let key = OctreePath::parse("3052").unwrap();
+        let rels = ["7", "05", "0", "3", "0517", "051", "37", "30", "001", "00"];
+        let mut bulk = bulk(key, &rels);
+        let index = BulkNodeIndex::build(key, &mut bulk);
+
+        for rel in rels {
+            let rel = OctreePath::parse(rel).unwrap();
+            let i = index.get(rel).expect("listed node is found");
+            assert_eq!(bulk.nodes[i].path, key.extend(rel));
+        }
+        assert_eq!(index.get(OctreePath::parse("1").unwrap()), None);
+        assert_eq!(index.get(OctreePath::parse("052").unwrap()), None);
+        assert_eq!(index.get(OctreePath::ROOT), None);
+    }
+
+    #[test]
+    fn siblings_are_contiguous_in_octant_order() {
+        let key = OctreePath::ROOT;
+        let mut bulk = bulk(key, &["2", "06", "0", "01", "5", "07"]);
+        let index = BulkNodeIndex::build(key, &mut bulk);
+
+        let zero = index.slot(OctreePath::parse("0").unwrap()).unwrap();
+        let kids: Vec<usize> = (0..8)
+            .filter_map(|o| index.child(zero, o)?.node())
+            .collect();
+        assert_eq!(kids.len(), 3);
+        assert!(kids.windows(2).all(|w| w[1] == w[0] + 1));
+        assert_eq!(bulk.nodes[kids[0]].path, OctreePath::parse("01").unwrap());
+    }
+
+    #[test]
+    fn orphans_and_duplicates_are_unreachable() {
+        let key = OctreePath::ROOT;
+        let mut bulk = bulk(key, &["4", "4", "61", "45"]);
+        let index = BulkNodeIndex::build(key, &mut bulk);
+
+        assert_eq!(bulk.nodes.len(), 3);
+        assert_eq!(index.get(OctreePath::parse("61").unwrap()), None);
+        let i = index.get(OctreePath::parse("45").unwrap()).unwrap();
+        assert_eq!(bulk.nodes[i].path, OctreePath::parse("45").unwrap());
+    }
+}
@@ -1,5 +1,5 @@
-//! The camera-centred terrain-collider reconcile: one camera-centred
-//! drivable-surface collider whose resolution coarsens with distance.
+//! The camera-centred terrain-collider reconcile: a drivable-surface collider
+//! around the camera whose resolution coarsens with distance.
 //!
 //! Used by both camera-centred algorithms (see [`crate::collider::COLLIDER`]):
 //! [`HeightField`](crate::collider::ColliderAlgorithm::HeightField) extracts a
@@ -9,100 +9,86 @@
 //! octree surface ([`veldera_physics::terrain_v4::create_octree_collider`]); the
 //! reconcile is otherwise identical, so the extractor is chosen from [`COLLIDER`]
 //! at the dispatch site. Unlike the voxel wrap (one collider per displayed tile,
-//! fighting to make adjacent tiles' borders agree), this maintains a *single*
-//! camera-centred collider, rebuilt off-thread as the camera moves. It is built
-//! by gathering the displayed composite tiles around the camera
+//! fighting to make adjacent tiles' borders agree), the surface is cut along a
+//! fixed grid of world-space chunks that knows nothing of tiles. Each chunk is
+//! built off-thread by gathering the displayed composite tiles overlapping it
 //! ([`LodState::physics_target_paths`] — the same non-overlapping WYSIWYG set the
-//! voxel wrap builds per tile) into one soup and extracting the surface from it.
-//! The new collider replaces the old in one frame (double buffer), so there is
-//! never a frame without coverage.
+//! voxel wrap builds per tile) into one soup and extracting its square of the
+//! surface, at one resolution set by its distance (ring) from the camera.
+//!
+//! A chunk is rebuilt only when the tiles it gathers or its ring change, so a
+//! move re-extracts the leading edge instead of the whole reach; each chunk is
+//! its own static collider. A rebuilt chunk replaces its old collider in one
+//! frame (double buffer), so there is never a frame without coverage.
+//!
+//! Settled surfaces — no finer tiles on their way — also go to an on-disk
+//! geometry cache beside the tile cache ([`ChunkGeometryCache`]), keyed by the
+//! gathered tiles' paths, epochs and masks, the extractor settings, and the
+//! chunk's place in its grid. The grid's anchor snaps to a lattice along the
+//! surface, so coming back to an area — in this session or a later one — reads
+//! its chunks back instead of re-extracting them.
 
-use std::sync::Arc;
+use std::{
+    collections::HashMap,
+    hash::{DefaultHasher, Hash, Hasher},
+    sync::Arc,
+};
 
 use avian3d::prelude::*;
 use bevy::prelude::*;
-use glam::{DVec3, Quat, Vec3};
-use rocktree::Mesh as RocktreeMesh;
+use glam::{DVec3, IVec2, Quat, Vec3};
+use rocktree::{Cache, Mesh as RocktreeMesh};
+use rocktree_decode::OctreePath;
 
 use veldera_async::TaskSpawner;
+use veldera_constants::EARTH_RADIUS_M_F64;
 use veldera_geo::floating_origin::{FloatingOriginCamera, WorldPosition};
 use veldera_physics::{
     DebugRender, GameLayer, PhysicsState, PhysicsStreamingConfig,
     terrain_v4::{
         HeightfieldSettings, Octree3dSettings, OctreeColliderSettings, TileMeshes,
-        create_height_collider, create_octree_collider,
+        build_height_surface, build_octree_surface,
+    },
+};
+use veldera_terrain_collider::{
+    camera_centred::{
+        self, HEIGHTFIELD, OCTREE_COLLAPSE_ERROR, OCTREE_SKIRT_CELLS, OCTREE_SMOOTH_ITERS,
+        OCTREE_SMOOTH_LAMBDA,
     },
+    geometry_cache::{GeometryKey, StableHasher, TileKey, decode_soup, encode_soup},
+    octree3d::Frame,
 };
 
 use crate::{
     collider::{COLLIDER, ColliderAlgorithm},
     lod::{ColliderReconcile, LodState, poll_lod_node_tasks},
-};
-
-/// Settings for the single camera-centred 2.5D drivable-height surface: a quadtree
-/// over the ground, `near_voxel` fine near the camera, coarsening to `far_voxel`
-/// (one doubling per `ring_m`) out to `radius`. The reach is sized toward the
-/// leap-arc's `max_range_m` — a fully-charged yeet launches at 150 m/s and the
-/// leap-preview arc collide-and-slides against this collider to find its landing,
-/// so it predicts (and the player lands) wrong past wherever the collider stops.
-/// `percentile` is the overhead-clutter-rejection dial (low keeps the road under a
-/// sign). A compile-time table for now; a follow-up lifts it into the
-/// hot-reloadable streaming config.
-const HEIGHTFIELD: HeightfieldSettings = HeightfieldSettings {
-    near_voxel: 0.3,
-    radius: 500.0,
-    // Resolution coarsens one step per 40 m out, capped at 8 m. Kept relatively
-    // fine far out (a doubling every 40 m, not 30, and an 8 m floor, not 18) so
-    // distant buildings aren't staircased — the flatness merge keeps that
-    // affordable by collapsing the far *flat* ground regardless. ~580 ms / 350k
-    // tris over 700 m of dense urban; coarsen these if the build cost bites.
-    ring_m: 40.0,
-    far_voxel: 8.0,
-    percentile: 0.3,
-    // Building footprints (tall regions ≥ 150 m²) take the roof height for a solid
-    // plateau; smaller tall regions (signs, poles, lone trees) stay ground.
-    building_percentile: 0.9,
-    building_min_area_m2: 150.0,
-    skirt_depth: 2.0,
-    // Flat ground collapses to large cells; surfaces deviating > 20 cm keep
-    // refining (curbs, bumps, building edges).
-    flatness_tolerance: 0.2,
+    residency::ColliderBytes,
 };
 
 /// Settings for the 3D octree extractor (used when [`COLLIDER`] is
-/// [`Octree`](ColliderAlgorithm::Octree)). Near voxel 0.5 m
-/// (cubic cell-count → ~9× cheaper than 0.3 m, and 0.5 m is fine collider detail for
-/// driving), coarsening to 8 m by `ring_m`, out to the same reach. `collapse_error`
-/// merges coplanar cells; `seal_cells` opens thin air pockets; a light smooth takes
-/// the per-cell jitter off.
+/// [`Octree`](ColliderAlgorithm::Octree)): the shared
+/// [`camera_centred`](veldera_terrain_collider::camera_centred) octree knobs,
+/// out to the same reach as [`HEIGHTFIELD`]. Each chunk builds with its own
+/// copy, like [`HEIGHTFIELD`] (see [`chunk_octree`] and [`chunk_heightfield`]).
 const OCTREE: OctreeColliderSettings = OctreeColliderSettings {
-    octree: Octree3dSettings {
-        near_voxel: 0.5,
-        ring_m: 40.0,
-        far_voxel: 8.0,
-        band_cells: 0.0,
-        seal_cells: 0,
-    },
-    collapse_error: 0.05,
-    skirt_cells: 2.0,
-    smooth_iters: 1,
-    smooth_lambda: 0.5,
+    octree: camera_centred::OCTREE,
+    reach: HEIGHTFIELD.radius,
+    collapse_error: OCTREE_COLLAPSE_ERROR,
+    skirt_cells: OCTREE_SKIRT_CELLS,
+    smooth_iters: OCTREE_SMOOTH_ITERS,
+    smooth_lambda: OCTREE_SMOOTH_LAMBDA,
 };
 
-/// The collider's reach — the radius tiles are gathered within. The height field
-/// also takes it as its `radius`; the octree builds over whatever soup it's handed.
+/// The collider's reach — chunks whose nearest point is within it of the camera
+/// are built.
 const MAX_RADIUS: f32 = HEIGHTFIELD.radius;
 
 /// Debug-wireframe colour, shown only while the physics debug visualisation is
 /// enabled.
 const COLLIDER_COLOUR: Color = Color::srgb(0.4, 0.9, 0.45);
 
-/// Rebuild once the camera has moved this far (m) from the build centre. Tied to
-/// the fine near-field scale, *not* the full reach: the fine cells are the precise
-/// surface the player actually stands on, so the whole collider must re-centre on
-/// that cadence to keep them inside it, even though the coarse far field reaches
-/// far past it.
-const REBUILD_DISTANCE: f32 = 18.0;
+/// Half the extent of a tile's mesh-local 0-255 lattice, per axis.
+const TILE_HALF_LATTICE: f32 = 127.5;
 
 /// Register the camera-centred collider reconcile and its state/build channel.
 /// Called from [`crate::lod::LodPlugin::build`] when [`COLLIDER`] selects either
@@ -111,6 +97,7 @@ const REBUILD_DISTANCE: f32 = 18.0;
 pub(crate) fn register(app: &mut App) {
     app.init_resource::<ColliderV4State>()
         .init_resource::<ColliderV4BuildChannel>()
+        .init_resource::<ChunkGeometryCache>()
         .add_systems(
             Update,
             update_physics_colliders_v4
@@ -126,29 +113,194 @@ pub(crate) fn register(app: &mut App) {
     app.add_systems(Update, crate::collider::shared::process_tile_dump_requests);
 }
 
-/// v4 reconcile state: the single live collider's entity, the world centre it was
-/// built at, and whether a rebuild is in flight.
+/// v4 reconcile state: the chunk grid's anchor, every chunk in reach, and the
+/// colliders of the grid before the last re-anchor.
 #[derive(Resource, Default)]
 struct ColliderV4State {
+    anchor: Option<ChunkAnchor>,
+    chunks: HashMap<IVec2, ChunkState>,
+    /// Colliders of the previous grids, each kept until the chunks of the
+    /// current one covering it have built, so re-anchoring never opens a gap.
+    retired: Vec<RetiredCollider>,
+    /// Chunk builds dispatched and not yet received.
+    in_flight: usize,
+    /// Generation of the last chunk build dispatched.
+    generation: u64,
+}
+
+/// A collider of an earlier grid, still standing in for the current grid's
+/// chunks over its square.
+struct RetiredCollider {
+    entity: Entity,
+    /// World centre of its chunk.
+    centre: DVec3,
+    /// Side (m) of its chunk.
+    side: f64,
+    bytes: u64,
+}
+
+/// Where the chunk grid lies: chunk `(i, j)` covers `[i, i + 1] × [j, j + 1]`
+/// chunk sides along `frame.e1` and `frame.e2` from `origin`. Every chunk builds
+/// in `frame`, so the extractors' grids line up across chunk borders. The side
+/// and lattice are the configured ones at anchoring time; a change to either
+/// re-anchors.
+struct ChunkAnchor {
+    /// The lattice point's direction, at the radius the grid was anchored from.
+    origin: DVec3,
+    frame: Frame,
+    /// The lattice point on the nearest shell, which chunks build relative to:
+    /// a revisit at a slightly different height builds the same surfaces.
+    reference: DVec3,
+    /// The lattice point's latitude row, longitude column and shell, which
+    /// key the [`ChunkGeometryCache`].
+    cell: [i64; 3],
+    /// Side (m) of a chunk.
+    side: f64,
+    /// Spacing (m) of the lattice `cell` indexes.
+    snap: f64,
+    /// Counts re-anchors, for the log.
+    epoch: u32,
+}
+
+impl ChunkAnchor {
+    /// A grid of `side` m chunks anchored at the lattice point, `snap` m
+    /// apart, nearest `near`, at `near`'s radius.
+    fn new(near: DVec3, epoch: u32, side: f64, snap: f64) -> Self {
+        use std::f64::consts::{FRAC_PI_2, TAU};
+
+        let radius = near.length();
+        let dir = near / radius;
+        let step = snap / EARTH_RADIUS_M_F64;
+        let row = (dir.z.clamp(-1.0, 1.0).asin() / step).round();
+        let lat = (row * step).clamp(-FRAC_PI_2, FRAC_PI_2);
+        // Fewer columns toward the poles keep them `snap` apart.
+        let columns = (TAU * lat.cos() / step).round().max(1.0);
+        let column = (dir.y.atan2(dir.x) / TAU * columns)
+            .round()
+            .rem_euclid(columns);
+        let lon = column / columns * TAU;
+        let snapped = DVec3::new(lat.cos() * lon.cos(), lat.cos() * lon.sin(), lat.sin());
+        let shell = (radius / snap).round();
+        Self {
+            origin: snapped * radius,
+            frame: Frame::new(snapped.as_vec3()),
+            reference: snapped * (shell * snap),
+            cell: [row as i64, column as i64, shell as i64],
+            side,
+            snap,
+            epoch,
+        }
+    }
+
+    /// A world point's coordinates in the grid plane, in metres.
+    fn plane(&self, world: DVec3) -> glam::DVec2 {
+        let rel = world - self.origin;
+        glam::DVec2::new(
+            rel.dot(self.frame.e1.as_dvec3()),
+            rel.dot(self.frame.e2.as_dvec3()),
+        )
+    }
+
+    /// The chunks whose squares may overlap a square of side `other_side` of
+    /// another grid centred at `world`. The grids' frames differ by a small
+    /// rotation, so the square is widened to its circumscribed circle.
+    fn chunks_covering(&self, world: DVec3, other_side: f64) -> impl Iterator<Item = IVec2> {
+        let side = self.side;
+        let spread = other_side * std::f64::consts::FRAC_1_SQRT_2;
+        let p = self.plane(world);
+        let lo = ((p - spread) / side).floor().as_ivec2();
+        let hi = ((p + spread) / side).floor().as_ivec2();
+        (lo.y..=hi.y).flat_map(move |y| (lo.x..=hi.x).map(move |x| IVec2::new(x, y)))
+    }
+
+    /// World position of a chunk's centre on the reference shell, the origin
+    /// it is built relative to.
+    fn centre(&self, chunk: IVec2) -> DVec3 {
+        let side = self.side;
+        let (x, y) = (
+            (f64::from(chunk.x) + 0.5) * side,
+            (f64::from(chunk.y) + 0.5) * side,
+        );
+        self.reference + self.frame.e1.as_dvec3() * x + self.frame.e2.as_dvec3() * y
+    }
+}
+
+/// One chunk: its live collider and what it was last built from.
+#[derive(Default)]
+struct ChunkState {
     entity: Option<Entity>,
-    centre: Option<DVec3>,
-    building: bool,
+    built: Option<ChunkInputs>,
+    /// Generation of the build in flight, if any. Only its result commits: a
+    /// chunk that left reach and came back, or a chunk of an old grid at the
+    /// same coordinates, may still have an older one on the way.
+    building: Option<u64>,
+    /// Bytes of the live collider's geometry.
+    bytes: u64,
+}
+
+/// What a chunk's collider depends on: the tiles it gathered and its ring.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+struct ChunkInputs {
+    /// Hash of the gathered tiles' paths and octant masks.
+    tiles: u64,
+    /// Leaf-size doublings over the extractor's near voxel.
+    ring: u8,
 }
 
-/// Tags the v4 collider entity, so it is identifiable in the world (for
-/// inspection and any future teardown). The live entity is tracked in
+/// Tags the v4 chunk collider entities, so they are identifiable in the world
+/// (for inspection and any future teardown). The live entities are tracked in
 /// [`ColliderV4State`]; this is a marker, not the source of truth.
 #[derive(Component)]
 struct ColliderV4;
 
-/// A finished off-thread build, awaiting commit.
+/// A finished off-thread chunk build, awaiting commit.
 struct ColliderV4BuildResult {
-    /// World centre the collider was built relative to (the camera position at
-    /// dispatch), so the commit can place it in the current origin frame.
+    /// See [`ChunkState::building`].
+    generation: u64,
+    chunk: IVec2,
+    inputs: ChunkInputs,
+    /// World centre the collider was built relative to, so the commit can
+    /// place it in the current origin frame.
     centre: DVec3,
-    /// `None` means nothing wrapped (e.g. no loaded geometry); the previous
-    /// collider is kept rather than leaving a gap.
+    /// `None` means nothing wrapped (e.g. no loaded geometry); the chunk's
+    /// previous collider is kept rather than leaving a gap.
     collider: Option<Collider>,
+    /// Bytes of the collider's vertices and triangles, for the residency
+    /// budget (see [`ColliderBytes`]).
+    bytes: u64,
+}
+
+/// Where finished chunk surfaces are kept between visits: a
+/// [`rocktree::FilesystemCache`] under `<OS cache dir>/veldera/colliders` on
+/// native (up to the configured
+/// [`chunk_geometry_cache_max_size`](PhysicsStreamingConfig::chunk_geometry_cache_max_size),
+/// least recently used out first), nothing on the web. Entries are
+/// [`encode_soup`]s under a [`chunk_cache_key`]; an empty build is stored as an
+/// empty soup, so it isn't re-extracted either.
+#[derive(Resource, Default)]
+struct ChunkGeometryCache {
+    store: Option<Arc<dyn Cache>>,
+    /// The size limit `store` was opened with; zero before the streaming
+    /// config has loaded.
+    max_size: u64,
+}
+
+impl ChunkGeometryCache {
+    /// The store limited to `max_size` bytes, reopened if the limit changed
+    /// (the config loaded, or was edited). Zero means no store.
+    fn store(&mut self, max_size: u64) -> Option<Arc<dyn Cache>> {
+        if max_size != self.max_size {
+            self.max_size = max_size;
+            #[cfg(not(target_family = "wasm"))]
+            {
+                self.store = (max_size > 0)
+                    .then(|| rocktree::FilesystemCache::veldera_subdir("colliders", max_size))
+                    .flatten()
+                    .map(|cache| Arc::new(cache) as Arc<dyn Cache>);
+            }
+        }
+        self.store.clone()
+    }
 }
 
 /// Channel for receiving finished v4 builds from background tasks.
@@ -165,8 +317,8 @@ impl Default for ColliderV4BuildChannel {
     }
 }
 
-/// Commit a finished build, then dispatch a rebuild off the main thread once the
-/// camera has moved past the threshold.
+/// Commit finished chunk builds, then dispatch the nearest chunks whose tiles or
+/// ring changed off the main thread.
 #[allow(clippy::too_many_arguments)]
 fn update_physics_colliders_v4(
     mut commands: Commands,
@@ -176,6 +328,8 @@ fn update_physics_colliders_v4(
     streaming: Res<PhysicsStreamingConfig>,
     camera_query: Query<&FloatingOriginCamera>,
     channel: Res<ColliderV4BuildChannel>,
+    mut cache: ResMut<ChunkGeometryCache>,
+    mut collider_bytes: ResMut<ColliderBytes>,
     spawner: TaskSpawner,
 ) {
     let Ok(camera) = camera_query.single() else {
@@ -186,114 +340,436 @@ fn update_physics_colliders_v4(
     let camera_pos = physics_state
         .origin_camera_position()
         .unwrap_or(camera.position);
+    if camera_pos == DVec3::ZERO {
+        return;
+    }
 
     while let Ok(result) = channel.rx.try_recv() {
         commit_build(&mut commands, &mut v4, camera_pos, result);
     }
-
-    if v4.building {
-        return;
-    }
-    let threshold = REBUILD_DISTANCE.max(2.0);
-    let moved = v4
-        .centre
-        .map_or(f64::INFINITY, |c| (camera_pos - c).length());
-    if moved <= f64::from(threshold) {
+    // No grid to lay out until the streaming config has loaded.
+    if streaming.chunk_size <= 0.0 || streaming.chunk_anchor_snap <= 0.0 {
         return;
     }
 
-    let down = (-camera_pos.normalize_or_zero()).as_vec3();
-    if down == Vec3::ZERO {
-        return;
+    let v4 = &mut *v4;
+    let side = f64::from(streaming.chunk_size);
+    if v4.anchor.as_ref().is_none_or(|anchor| {
+        (camera_pos - anchor.origin).length() > streaming.chunk_reanchor_distance
+            || anchor.side != side
+            || anchor.snap != streaming.chunk_anchor_snap
+    }) {
+        reanchor(v4, camera_pos, side, streaming.chunk_anchor_snap);
     }
-
-    let tiles = gather_tiles(&lod_state, &streaming, camera_pos);
-    if tiles.is_empty() {
-        debug!(target: "collider_v4", "no tiles in range, deferring");
+    let Some(anchor) = &v4.anchor else {
         return;
-    }
-    info!(
-        target: "collider_v4",
-        "dispatch: {} tiles, camera moved {moved:.1} m (threshold {threshold:.1} m)",
-        tiles.len()
-    );
-
-    let tx = channel.tx.clone();
-    spawner.spawn(async move {
-        let tile_refs: Vec<(TileMeshes, u8)> = tiles
+    };
+
+    let camera_plane = anchor.plane(camera_pos);
+    let tiles = chunk_tiles(&lod_state, &streaming, anchor, camera_plane);
+
+    // Drop the chunks that fell out of reach (with a chunk of slack, so one
+    // straddling the edge doesn't flicker).
+    let keep = f64::from(MAX_RADIUS) + side;
+    v4.chunks.retain(|&chunk, state| {
+        let kept = chunk_distance(chunk, camera_plane, side) <= keep;
+        if !kept && let Some(entity) = state.entity {
+            commands.entity(entity).despawn();
+        }
+        kept
+    });
+
+    // Every chunk in reach that has tiles and isn't built from them at its ring.
+    let mut dirty: Vec<(f64, IVec2, ChunkInputs)> = tiles
+        .iter()
+        .filter_map(|(&chunk, paths)| {
+            let distance = chunk_distance(chunk, camera_plane, side);
+            if distance > f64::from(MAX_RADIUS) {
+                return None;
+            }
+            let state = v4.chunks.entry(chunk).or_default();
+            let inputs = ChunkInputs {
+                tiles: tiles_hash(paths),
+                ring: chunk_ring(
+                    distance as f32,
+                    state.built.map(|b| b.ring),
+                    streaming.chunk_ring_hysteresis,
+                ),
+            };
+            (state.building.is_none() && state.built != Some(inputs))
+                .then_some((distance, chunk, inputs))
+        })
+        .collect();
+    dirty.sort_by(|a, b| a.0.total_cmp(&b.0));
+
+    let down = -anchor.frame.up;
+    let slots = streaming.max_chunk_builds.saturating_sub(v4.in_flight);
+    let soup_margin = streaming.chunk_soup_margin;
+    let store = cache.store(streaming.chunk_geometry_cache_max_size);
+    for &(_, chunk, inputs) in dirty.iter().take(slots) {
+        let centre = anchor.centre(chunk);
+        let (owned, tile_keys): (Vec<(OwnedTileMeshes, u8)>, Vec<TileKey>) = tiles[&chunk]
             .iter()
-            .map(|(m, mask)| (m.as_tile_meshes(), *mask))
-            .collect();
-        let collider = match COLLIDER {
-            ColliderAlgorithm::Octree => create_octree_collider(&tile_refs, down, &OCTREE),
-            // The two camera-centred algorithms share this reconcile; everything
-            // that isn't the octree uses the height field (the dispatch only
-            // routes HeightField and Octree here).
-            _ => create_height_collider(&tile_refs, down, &HEIGHTFIELD),
-        };
-        let _ = tx
-            .send(ColliderV4BuildResult {
-                centre: camera_pos,
-                collider,
+            .filter_map(|&(path, mask)| {
+                let node_data = lod_state.node_data.get(&path)?;
+                let owned = OwnedTileMeshes {
+                    meshes: Arc::clone(&node_data.meshes),
+                    rotation: node_data.transform.rotation,
+                    scale: node_data.transform.scale,
+                    offset: (node_data.world_position - centre).as_vec3(),
+                };
+                let key = TileKey {
+                    path,
+                    epoch: node_data.epoch,
+                    octant_mask: mask,
+                };
+                Some(((owned, mask), key))
             })
+            .unzip();
+        let key = chunk_cache_key(anchor, chunk, inputs.ring, soup_margin, tile_keys);
+        // While finer tiles under a chunk are on their way it rebuilds from
+        // them soon, and the in-between set of tiles seldom comes back, so only
+        // a settled chunk's surface is worth keeping.
+        let settled = lod_state.fetches.count_requested(|requested| {
+            tiles[&chunk]
+                .iter()
+                .any(|&(path, _)| requested.depth() > path.depth() && requested.starts_with(path))
+        }) == 0;
+        debug!(
+            target: "collider_v4",
+            "dispatch chunk {chunk}: {} tiles, ring {}",
+            owned.len(),
+            inputs.ring
+        );
+
+        let tx = channel.tx.clone();
+        let store = store.clone();
+        v4.generation += 1;
+        let generation = v4.generation;
+        spawner.spawn(async move {
+            let surface = chunk_surface(
+                store.as_deref(),
+                &key,
+                settled,
+                &owned,
+                down,
+                inputs.ring,
+                side as f32,
+                soup_margin,
+            )
             .await;
+            let bytes = surface.as_ref().map_or(0, |(vertices, triangles)| {
+                (size_of_val(vertices.as_slice()) + size_of_val(triangles.as_slice())) as u64
+            });
+            let collider = surface
+                .and_then(|(vertices, triangles)| Collider::try_trimesh(vertices, triangles).ok());
+            let _ = tx
+                .send(ColliderV4BuildResult {
+                    generation,
+                    chunk,
+                    inputs,
+                    centre,
+                    collider,
+                    bytes,
+                })
+                .await;
+        });
+        if let Some(state) = v4.chunks.get_mut(&chunk) {
+            state.building = Some(generation);
+        }
+        v4.in_flight += 1;
+    }
+
+    // A collider of the previous grid goes once the chunks of this one over
+    // its square have built. Chunks without a state have no tiles in reach,
+    // so nothing will build there.
+    let chunks = &v4.chunks;
+    v4.retired.retain(|retired| {
+        let covered = anchor
+            .chunks_covering(retired.centre, retired.side)
+            .all(|chunk| chunks.get(&chunk).is_none_or(|state| state.built.is_some()));
+        if covered {
+            commands.entity(retired.entity).despawn();
+        }
+        !covered
     });
-    v4.building = true;
+
+    collider_bytes.0 = v4.chunks.values().map(|state| state.bytes).sum::<u64>()
+        + v4.retired.iter().map(|retired| retired.bytes).sum::<u64>();
+}
+
+/// A chunk's surface: read back from `store` when it holds one under `key`,
+/// otherwise extracted from `owned` by the live extractor for a `side` m chunk
+/// at `ring`, and stored if `keep`. `None` when nothing extracts.
+#[allow(clippy::too_many_arguments)]
+async fn chunk_surface(
+    store: Option<&dyn Cache>,
+    key: &str,
+    keep: bool,
+    owned: &[(OwnedTileMeshes, u8)],
+    down: Vec3,
+    ring: u8,
+    side: f32,
+    soup_margin: f32,
+) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+    if let Some(store) = store {
+        match store.get(key).await {
+            Ok(Some(blob)) => {
+                if let Some(soup) = decode_soup(&blob) {
+                    debug!(target: "collider_v4", "chunk surface read from the geometry cache");
+                    return (!soup.1.is_empty()).then_some(soup);
+                }
+            }
+            Ok(None) => {}
+            Err(e) => warn!(target: "collider_v4", "geometry cache read failed: {e}"),
+        }
+    }
+
+    let tile_refs: Vec<(TileMeshes, u8)> = owned
+        .iter()
+        .map(|(m, mask)| (m.as_tile_meshes(), *mask))
+        .collect();
+    let surface = match COLLIDER {
+        ColliderAlgorithm::Octree => {
+            build_octree_surface(&tile_refs, down, &chunk_octree(ring, side), soup_margin)
+        }
+        // The two camera-centred algorithms share this reconcile; everything
+        // that isn't the octree uses the height field (the dispatch only
+        // routes HeightField and Octree here).
+        _ => build_height_surface(
+            &tile_refs,
+            down,
+            &chunk_heightfield(ring, side),
+            soup_margin,
+        ),
+    };
+
+    if let Some(store) = store.filter(|_| keep) {
+        let (vertices, triangles) = surface
+            .as_ref()
+            .map_or((&[][..], &[][..]), |(v, t)| (v.as_slice(), t.as_slice()));
+        if let Err(e) = store
+            .put(key, encode_soup(vertices, triangles).into())
+            .await
+        {
+            warn!(target: "collider_v4", "geometry cache write failed: {e}");
+        }
+    }
+    surface
 }
 
-/// Gather the displayed composite tiles within the collider's reach of the
-/// camera, as owned, `Arc`-shared snapshots offset into the camera-centred frame.
-/// Skips tiles below the configured minimum collider depth (too coarse to be
-/// useful collision).
-fn gather_tiles(
+/// The geometry-cache key of a chunk's build: the tiles it gathered, the live
+/// extractor's settings at its ring with the soup margin they see, and where
+/// the chunk lies. The anchor is on the configured lattice, so the same ground
+/// keys the same way on every visit at about the same height.
+fn chunk_cache_key(
+    anchor: &ChunkAnchor,
+    chunk: IVec2,
+    ring: u8,
+    soup_margin: f32,
+    tiles: Vec<TileKey>,
+) -> String {
+    let mut hasher = StableHasher::new();
+    let side = anchor.side as f32;
+    let extractor = match COLLIDER {
+        ColliderAlgorithm::Octree => {
+            chunk_octree(ring, side).hash_into(&mut hasher);
+            "octree"
+        }
+        _ => {
+            chunk_heightfield(ring, side).hash_into(&mut hasher);
+            "height"
+        }
+    };
+    hasher.write_f32(soup_margin);
+    hasher.write_u64(anchor.snap.to_bits());
+    for c in anchor.cell {
+        hasher.write_i64(c);
+    }
+    hasher.write_i32(chunk.x);
+    hasher.write_i32(chunk.y);
+    GeometryKey::new(extractor, hasher.finish(), tiles).to_string()
+}
+
+/// Start a new grid of `side` m chunks on the `snap` m lattice near the
+/// camera, retiring the old grid's colliders.
+fn reanchor(v4: &mut ColliderV4State, camera_pos: DVec3, side: f64, snap: f64) {
+    let epoch = v4.anchor.as_ref().map_or(0, |anchor| anchor.epoch + 1);
+    info!(target: "collider_v4", "anchoring chunk grid (epoch {epoch})");
+    let old = v4.anchor.as_ref();
+    for (chunk, state) in v4.chunks.drain() {
+        if let (Some(entity), Some(old)) = (state.entity, old) {
+            v4.retired.push(RetiredCollider {
+                entity,
+                centre: old.centre(chunk),
+                side: old.side,
+                bytes: state.bytes,
+            });
+        }
+    }
+    v4.anchor = Some(ChunkAnchor::new(camera_pos, epoch, side, snap));
+}
+
+/// The displayed composite tiles each chunk near the camera gathers, keyed by
+/// chunk: every tile whose bounding sphere reaches within the configured tile
+/// margin of the chunk's square. Skips tiles below the configured minimum
+/// collider depth (too coarse to be useful collision).
+fn chunk_tiles(
     lod_state: &LodState,
     streaming: &PhysicsStreamingConfig,
-    camera_pos: DVec3,
-) -> Vec<(OwnedTileMeshes, u8)> {
-    // A tile's centre can sit just outside the reach while its geometry reaches
-    // in, so gather a little past it.
-    let reach = f64::from(MAX_RADIUS) + 30.0;
-    lod_state
-        .physics_target_paths
-        .iter()
-        .filter(|(path, _)| path.depth() >= streaming.collider_min_depth)
-        .filter_map(|(path, &mask)| {
-            let node_data = lod_state.node_data.get(path)?;
-            if (node_data.world_position - camera_pos).length() > reach {
-                return None;
+    anchor: &ChunkAnchor,
+    camera_plane: glam::DVec2,
+) -> HashMap<IVec2, Vec<(OctreePath, u8)>> {
+    let side = anchor.side;
+    let margin = f64::from(streaming.chunk_tile_margin);
+    let reach = f64::from(MAX_RADIUS) + side + margin;
+    let mut tiles: HashMap<IVec2, Vec<(OctreePath, u8)>> = HashMap::new();
+    for (&path, &mask) in &lod_state.physics_target_paths {
+        if path.depth() < streaming.collider_min_depth {
+            continue;
+        }
+        let Some(node_data) = lod_state.node_data.get(&path) else {
+            continue;
+        };
+        // The tile's lattice is a box; its bounding sphere is cheap and loose.
+        let half = node_data.transform.scale * TILE_HALF_LATTICE;
+        let centre = node_data.world_position + (node_data.transform.rotation * half).as_dvec3();
+        let radius = f64::from(half.length());
+        let p = anchor.plane(centre);
+        if (p - camera_plane).length() - radius > reach {
+            continue;
+        }
+        let spread = radius + margin;
+        let lo = ((p - spread) / side).floor().as_ivec2();
+        let hi = ((p + spread) / side).floor().as_ivec2();
+        for y in lo.y..=hi.y {
+            for x in lo.x..=hi.x {
+                tiles
+                    .entry(IVec2::new(x, y))
+                    .or_default()
+                    .push((path, mask));
             }
-            Some((
-                OwnedTileMeshes {
-                    meshes: Arc::clone(&node_data.meshes),
-                    rotation: node_data.transform.rotation,
-                    scale: node_data.transform.scale,
-                    offset: (node_data.world_position - camera_pos).as_vec3(),
-                },
-                mask,
-            ))
-        })
-        .collect()
+        }
+    }
+    tiles
 }
 
-/// Spawn a finished collider and atomically retire the previous one (double
-/// buffer). An empty build keeps the previous collider rather than opening a gap.
+/// Horizontal distance (m) from the camera to the nearest point of a `side` m
+/// chunk.
+fn chunk_distance(chunk: IVec2, camera_plane: glam::DVec2, side: f64) -> f64 {
+    let min = chunk.as_dvec2() * side;
+    let nearest = camera_plane.clamp(min, min + side);
+    (nearest - camera_plane).length()
+}
+
+/// Order-independent hash of a chunk's gathered tiles.
+fn tiles_hash(paths: &[(OctreePath, u8)]) -> u64 {
+    let mut sorted = paths.to_vec();
+    sorted.sort_unstable();
+    let mut hasher = DefaultHasher::new();
+    sorted.hash(&mut hasher);
+    hasher.finish()
+}
+
+/// The ring of a chunk `distance` m from the camera: one leaf-size doubling per
+/// `ring_m`, capped where the near voxel reaches the far voxel. A chunk keeps
+/// its `current` ring while it is within `hysteresis` m of it.
+fn chunk_ring(distance: f32, current: Option<u8>, hysteresis: f32) -> u8 {
+    let (near, ring_m, far) = ring_settings();
+    let max = (far / near).log2().ceil().max(0.0) as u8;
+    let ring_at = |d: f32| ((d.max(0.0) / ring_m).floor() as u8).min(max);
+    match current {
+        Some(ring)
+            if (ring_at(distance - hysteresis)..=ring_at(distance + hysteresis))
+                .contains(&ring) =>
+        {
+            ring
+        }
+        _ => ring_at(distance),
+    }
+}
+
+/// The live extractor's near voxel, ring spacing, and far voxel.
+fn ring_settings() -> (f32, f32, f32) {
+    match COLLIDER {
+        ColliderAlgorithm::Octree => (
+            OCTREE.octree.near_voxel,
+            OCTREE.octree.ring_m,
+            OCTREE.octree.far_voxel,
+        ),
+        _ => (
+            HEIGHTFIELD.near_voxel,
+            HEIGHTFIELD.ring_m,
+            HEIGHTFIELD.far_voxel,
+        ),
+    }
+}
+
+/// Leaf size (m) of a ring.
+fn ring_voxel(ring: u8) -> f32 {
+    let (near, _, far) = ring_settings();
+    (near * 2f32.powi(i32::from(ring))).min(far)
+}
+
+/// [`HEIGHTFIELD`] for one `side` m chunk: its square, at its ring's single
+/// leaf size (flat ground still merges coarser).
+fn chunk_heightfield(ring: u8, side: f32) -> HeightfieldSettings {
+    let voxel = ring_voxel(ring);
+    HeightfieldSettings {
+        near_voxel: voxel,
+        radius: side * 0.5,
+        ring_m: f32::INFINITY,
+        far_voxel: voxel,
+        ..HEIGHTFIELD
+    }
+}
+
+/// [`OCTREE`] for one `side` m chunk: its square, at its ring's single cell
+/// size.
+fn chunk_octree(ring: u8, side: f32) -> OctreeColliderSettings {
+    let voxel = ring_voxel(ring);
+    OctreeColliderSettings {
+        octree: Octree3dSettings {
+            near_voxel: voxel,
+            ring_m: f32::INFINITY,
+            far_voxel: voxel,
+            ..OCTREE.octree
+        },
+        reach: side * 0.5,
+        ..OCTREE
+    }
+}
+
+/// Spawn a finished chunk collider and atomically retire the chunk's previous
+/// one (double buffer). An empty build keeps the previous collider rather than
+/// opening a gap; a build the chunk no longer waits on (it has since left
+/// reach, or belongs to an old grid) is dropped.
 fn commit_build(
     commands: &mut Commands,
     v4: &mut ColliderV4State,
     camera_pos: DVec3,
     result: ColliderV4BuildResult,
 ) {
-    v4.building = false;
+    v4.in_flight = v4.in_flight.saturating_sub(1);
+    let Some(state) = v4
+        .chunks
+        .get_mut(&result.chunk)
+        .filter(|state| state.building == Some(result.generation))
+    else {
+        debug!(target: "collider_v4", "dropping stale build for chunk {}", result.chunk);
+        return;
+    };
+    state.building = None;
+    state.built = Some(result.inputs);
 
     let Some(collider) = result.collider else {
-        warn!(
+        debug!(
             target: "collider_v4",
-            "empty build (no geometry wrapped); keeping previous collider"
+            "empty build for chunk {} (no geometry wrapped); keeping previous collider",
+            result.chunk
         );
-        v4.centre = Some(result.centre);
         return;
     };
-    info!(target: "collider_v4", "commit: built");
 
     // Camera-relative position in the commit-time origin frame; the mesh is built
     // relative to its centre, so this places it correctly.
@@ -315,16 +791,15 @@ fn commit_build(
         ))
         .id();
 
-    let old = v4.entity.replace(entity);
-    v4.centre = Some(result.centre);
-    if let Some(old) = old {
+    state.bytes = result.bytes;
+    if let Some(old) = state.entity.replace(entity) {
         commands.entity(old).despawn();
     }
 }
 
 /// Owned snapshot of one tile's build inputs for a background task (the mesh data
 /// is `Arc`'d, so dispatch never copies it). The offset places the tile in the
-/// camera-centred frame.
+/// chunk's frame.
 struct OwnedTileMeshes {
     meshes: Arc<Vec<RocktreeMesh>>,
     rotation: Quat,
@@ -342,3 +817,104 @@ impl OwnedTileMeshes {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// The shipped chunk side, lattice, and ring hysteresis.
+    const SIDE: f64 = 64.0;
+    const SNAP: f64 = 256.0;
+    const HYSTERESIS: f32 = 4.0;
+
+    #[test]
+    fn chunk_ring_holds_within_hysteresis() {
+        let (_, ring_m, _) = ring_settings();
+        assert_eq!(chunk_ring(0.0, None, HYSTERESIS), 0);
+        assert_eq!(chunk_ring(ring_m + 1.0, None, HYSTERESIS), 1);
+        // Just over a boundary keeps the inner ring, well over moves out.
+        assert_eq!(chunk_ring(ring_m + 1.0, Some(0), HYSTERESIS), 0);
+        assert_eq!(
+            chunk_ring(ring_m + HYSTERESIS + 1.0, Some(0), HYSTERESIS),
+            1
+        );
+        // Far out the ring caps at the far voxel.
+        assert_eq!(
+            ring_voxel(chunk_ring(1e6, None, HYSTERESIS)),
+            ring_settings().2
+        );
+    }
+
+    #[test]
+    fn chunk_distance_is_zero_inside_and_edge_distance_outside() {
+        let camera = glam::DVec2::new(10.0, 20.0);
+        assert_eq!(chunk_distance(IVec2::ZERO, camera, SIDE), 0.0);
+        assert_eq!(chunk_distance(IVec2::new(1, 0), camera, SIDE), SIDE - 10.0);
+        assert_eq!(chunk_distance(IVec2::new(-1, 0), camera, SIDE), 10.0);
+    }
+
+    #[test]
+    fn anchors_near_each_other_share_a_lattice_point() {
+        let near = DVec3::new(6_371_010.0, 100.0, -40.0);
+        let a = ChunkAnchor::new(near, 0, SIDE, SNAP);
+        let b = ChunkAnchor::new(DVec3::new(6_371_090.0, 30.0, 60.0), 1, SIDE, SNAP);
+        assert_eq!(a.cell, b.cell);
+        assert_eq!(a.reference, b.reference);
+        assert_eq!(a.reference, DVec3::new(6_371_072.0, 0.0, 0.0));
+        // The grid passes through the anchoring point's height, not the shell's.
+        assert!((a.origin.length() - near.length()).abs() < 1e-6);
+        assert_eq!(a.origin.normalize(), DVec3::X);
+
+        // Far from the axes the lattice point is still within a cell of the
+        // anchoring point along the surface.
+        let near = DVec3::new(2.0e6, -3.0e6, 5.23e6);
+        let c = ChunkAnchor::new(near, 0, SIDE, SNAP);
+        assert!((c.origin.length() - near.length()).abs() < 1e-6);
+        assert!((c.origin - near).length() < SNAP);
+
+        let tiles = || {
+            vec![TileKey {
+                path: OctreePath::parse("0123").unwrap(),
+                epoch: 3,
+                octant_mask: 0,
+            }]
+        };
+        assert_eq!(
+            chunk_cache_key(&a, IVec2::ONE, 0, 16.0, tiles()),
+            chunk_cache_key(&b, IVec2::ONE, 0, 16.0, tiles())
+        );
+        assert_ne!(
+            chunk_cache_key(&a, IVec2::ONE, 0, 16.0, tiles()),
+            chunk_cache_key(&a, IVec2::ONE, 1, 16.0, tiles())
+        );
+        assert_ne!(
+            chunk_cache_key(&a, IVec2::ONE, 0, 16.0, tiles()),
+            chunk_cache_key(&a, IVec2::ONE, 0, 24.0, tiles())
+        );
+    }
+
+    #[test]
+    fn a_retired_chunk_is_covered_by_the_chunks_around_it() {
+        let old = ChunkAnchor::new(DVec3::new(6_371_000.0, 0.0, 0.0), 0, SIDE, SNAP);
+        let new = ChunkAnchor::new(DVec3::new(6_370_800.0, 3_800.0, 0.0), 1, SIDE, SNAP);
+        let centre = old.centre(IVec2::new(2, 3));
+        let covering: Vec<IVec2> = new.chunks_covering(centre, old.side).collect();
+        // Every corner of the old square lies in one of the covering chunks.
+        for corner in [(-0.5, -0.5), (-0.5, 0.5), (0.5, -0.5), (0.5, 0.5)] {
+            let world = centre
+                + old.frame.e1.as_dvec3() * (corner.0 * SIDE)
+                + old.frame.e2.as_dvec3() * (corner.1 * SIDE);
+            let chunk = (new.plane(world) / SIDE).floor().as_ivec2();
+            assert!(covering.contains(&chunk), "{chunk} not in {covering:?}");
+        }
+        assert!(covering.len() <= 9);
+    }
+
+    #[test]
+    fn tiles_hash_ignores_gather_order() {
+        let a = (OctreePath::parse("0123").unwrap(), 0xff);
+        let b = (OctreePath::parse("0124").unwrap(), 0x0f);
+        assert_eq!(tiles_hash(&[a, b]), tiles_hash(&[b, a]));
+        assert_ne!(tiles_hash(&[a, b]), tiles_hash(&[a]));
+    }
+}
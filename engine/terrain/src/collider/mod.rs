@@ -10,9 +10,10 @@
 //!   [`voxel_wrap`] (the per-tile voxel rebuild) each maintain one collider per
 //!   displayed tile and reconcile the set against
 //!   [`LodState::physics_target_paths`](crate::lod::LodState).
-//! - **Camera-centred, single-collider.** [`camera_centred`] maintains a
-//!   *single* collider centred on the camera, rebuilt off-thread as it moves,
-//!   extracted either as a 2.5D height field or a full-3D octree.
+//! - **Camera-centred, chunked.** [`camera_centred`] maintains a collider
+//!   around the camera cut into fixed world-space chunks, each rebuilt
+//!   off-thread when its tiles or ring change, extracted either as a 2.5D
+//!   height field or a full-3D octree.
 //!
 //! Cross-cutting pieces every algorithm shares — the host-filled
 //! [`RoadOverlay`], the [`RoadIndex`]/[`tile_bounding_radius`] that bound it, the
@@ -68,16 +69,16 @@ pub enum ColliderAlgorithm {
     /// camera-centred family (no per-tile boundaries). See
     /// `todo/collider-v4.md`.
     VoxelWrap,
-    /// The camera-centred 2.5D drivable-height surface: a *single* collider
-    /// gathering the displayed composite tiles around the camera into one grid
-    /// and extracting a distance-graded drivable-height surface
+    /// The camera-centred 2.5D drivable-height surface: the displayed composite
+    /// tiles around the camera gathered per fixed world-space chunk, each chunk
+    /// extracting its square of a distance-graded drivable-height surface
     /// ([`veldera_physics::terrain_v4::create_height_collider`]), rebuilt
-    /// off-thread as the camera moves. Decouples colliders from tiles entirely,
+    /// off-thread when its tiles or its ring change. Decouples colliders from tiles entirely,
     /// so there are no per-tile borders to reconcile. The lighter, proven
     /// extractor. See `todo/collider-v4.md`.
     HeightField,
     /// The camera-centred full-3D octree surface: the same camera-centred
-    /// reconcile as [`HeightField`](Self::HeightField), but the single collider
+    /// reconcile as [`HeightField`](Self::HeightField), but each chunk's collider
     /// is extracted by the experimental octree path
     /// ([`veldera_physics::terrain_v4::create_octree_collider`]) — real building
     /// walls with no clutter classification, at higher build cost. See
@@ -96,7 +97,7 @@ impl ColliderAlgorithm {
         matches!(self, Self::VoxelWrap)
     }
 
-    /// The camera-centred single-collider family (height field or octree); both
+    /// The camera-centred chunked-collider family (height field or octree); both
     /// share the [`camera_centred`] reconcile.
     pub const fn is_camera_centred(self) -> bool {
         matches!(self, Self::HeightField | Self::Octree)
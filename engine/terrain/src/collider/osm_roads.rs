@@ -23,7 +23,7 @@
 
 use std::{
     collections::{HashMap, HashSet},
-    sync::Arc,
+    sync::{Arc, OnceLock},
 };
 
 use avian3d::prelude::*;
@@ -37,7 +37,9 @@ use veldera_geo::floating_origin::{FloatingOriginCamera, WorldPosition};
 use veldera_physics::{
     GameLayer, MotionTracker, PHYSICS_FINEST_DEPTH, PhysicsState, PhysicsStreamingConfig,
     TerrainCollider,
-    terrain_v2::{CarveSettings, TileMeshes, create_terrain_collider},
+    terrain_v2::{
+        CarveSettings, NeighbourSurface, SurfaceProbe, TileMeshes, create_terrain_collider,
+    },
 };
 
 use crate::{
@@ -119,6 +121,19 @@ pub struct ColliderV2State {
     /// system, so the reconcile detects a change by comparing against this
     /// snapshot rather than relying on the writer to bump the generation.
     last_target_paths: HashMap<OctreePath, u8>,
+    /// Each loaded tile's surface as border fusion probes it, shared by the
+    /// builds of every tile bordering it instead of re-bucketed per build.
+    /// Filled lazily on the build tasks; pruned as node data unloads.
+    surface_probes: HashMap<OctreePath, TileSurface>,
+}
+
+/// A tile's [`SurfaceProbe`], built once by whichever build task needs it
+/// first, in the tile's own baked space.
+struct TileSurface {
+    /// The meshes the probe is over; a reload replaces the node data's
+    /// `Arc`, which invalidates the probe.
+    meshes: Arc<Vec<RocktreeMesh>>,
+    probe: Arc<OnceLock<SurfaceProbe>>,
 }
 
 impl ColliderV2State {
@@ -166,6 +181,36 @@ impl ColliderV2State {
             self.last_target_paths = lod_state.physics_target_paths.clone();
             self.collider_inputs_generation += 1;
         }
+
+        self.surface_probes.retain(|path, surface| {
+            lod_state
+                .node_data
+                .get(path)
+                .is_some_and(|data| Arc::ptr_eq(&data.meshes, &surface.meshes))
+        });
+    }
+
+    /// The shared probe slot for a loaded tile's surface, opening one when
+    /// the tile has none for its current meshes.
+    fn surface_probe(
+        &mut self,
+        path: OctreePath,
+        data: &LoadedNodeData,
+    ) -> Arc<OnceLock<SurfaceProbe>> {
+        let surface = self
+            .surface_probes
+            .entry(path)
+            .or_insert_with(|| TileSurface {
+                meshes: Arc::clone(&data.meshes),
+                probe: Arc::default(),
+            });
+        if !Arc::ptr_eq(&surface.meshes, &data.meshes) {
+            *surface = TileSurface {
+                meshes: Arc::clone(&data.meshes),
+                probe: Arc::default(),
+            };
+        }
+        Arc::clone(&surface.probe)
     }
 
     /// Commit a live collider, mirroring `(entity, mask)` into the shared
@@ -395,7 +440,7 @@ pub(crate) fn compute_physics_targets(
     depth_offset: usize,
 ) -> HashMap<OctreePath, u8> {
     let mut targets: HashMap<OctreePath, u8> = HashMap::new();
-    for path in &lod_state.loaded_nodes {
+    for path in lod_state.displayed_nodes() {
         if !lod_state.node_data.contains_key(path) {
             continue;
         }
@@ -942,15 +987,22 @@ fn update_physics_colliders(
             scale: node_data.transform.scale,
             offset: Vec3::ZERO,
         };
-        let neighbour_tiles: Vec<OwnedTileMeshes> = laterals
+        // Each neighbour is probed in its own space, so its probe serves
+        // every tile it borders; the offset places it relative to this one.
+        let neighbour_tiles: Vec<NeighbourTile> = laterals
             .iter()
             .filter_map(|n| {
                 let neighbour = lod_state.node_data.get(n)?;
-                Some(OwnedTileMeshes {
-                    meshes: Arc::clone(&neighbour.meshes),
-                    rotation: neighbour.transform.rotation,
-                    scale: neighbour.transform.scale,
+                Some(NeighbourTile {
+                    tile: OwnedTileMeshes {
+                        meshes: Arc::clone(&neighbour.meshes),
+                        rotation: neighbour.transform.rotation,
+                        scale: neighbour.transform.scale,
+                        offset: Vec3::ZERO,
+                    },
+                    down: (-neighbour.world_position.normalize()).as_vec3(),
                     offset: (neighbour.world_position - node_data.world_position).as_vec3(),
+                    probe: v2.surface_probe(*n, neighbour),
                 })
             })
             .collect();
@@ -964,15 +1016,13 @@ fn update_physics_colliders(
         let tx = channel.tx.clone();
         spawner.spawn(async move {
             let tile = build_tile.as_tile_meshes();
-            let neighbour_meshes: Vec<TileMeshes> = neighbour_tiles
-                .iter()
-                .map(OwnedTileMeshes::as_tile_meshes)
-                .collect();
+            let neighbour_surfaces: Vec<NeighbourSurface> =
+                neighbour_tiles.iter().map(NeighbourTile::surface).collect();
             let (collider, stats) = create_terrain_collider(
                 &tile,
                 mask,
                 sub_cut,
-                &neighbour_meshes,
+                &neighbour_surfaces,
                 down,
                 &settings,
                 &road_ribbons,
@@ -1096,6 +1146,28 @@ impl OwnedTileMeshes {
     }
 }
 
+/// A lateral neighbour's build inputs: its meshes in its own baked space,
+/// to probe if no build has yet, and where it sits relative to the build
+/// tile.
+struct NeighbourTile {
+    tile: OwnedTileMeshes,
+    /// Radial down at the neighbour, the probe's vertical.
+    down: Vec3,
+    offset: Vec3,
+    probe: Arc<OnceLock<SurfaceProbe>>,
+}
+
+impl NeighbourTile {
+    fn surface(&self) -> NeighbourSurface<'_> {
+        NeighbourSurface {
+            probe: self
+                .probe
+                .get_or_init(|| SurfaceProbe::from_tile(&self.tile.as_tile_meshes(), self.down)),
+            offset: self.offset,
+        }
+    }
+}
+
 /// Validate and commit a finished off-thread collider build, spawning its
 /// entity and registering it live. Returns `false` when the result is
 /// stale and discarded — the parameters no longer match what the current
@@ -121,10 +121,22 @@ pub struct RoadOverlay {
 /// Without this the reconcile re-walked all stations of all ribbons for every
 /// one of the hundreds of live tiles, every frame the camera moved — tens of
 /// milliseconds at city scale.
+///
+/// The spheres are bulk-loaded into a bounding-box tree, so a tile's query
+/// descends only into the branches near it and costs in proportion to the
+/// roads around the tile rather than to every road in the overlay.
 pub struct RoadIndex {
     bounds: Vec<RoadBound>,
+    /// The tree over `bounds`, root first; empty when `bounds` is.
+    nodes: Vec<RoadNode>,
+    /// Indices into `bounds`, each leaf's a contiguous run.
+    order: Vec<u32>,
 }
 
+/// Ribbons per tree leaf: small enough that a leaf's sphere tests are cheap,
+/// large enough that the tree stays shallow.
+const ROAD_LEAF_SIZE: usize = 8;
+
 /// One ribbon's bound and content signature; parallel to
 /// [`RoadOverlay::ribbons`].
 struct RoadBound {
@@ -137,17 +149,38 @@ struct RoadBound {
     sig: u64,
 }
 
+/// One node of the [`RoadIndex`] tree: the box enclosing every sphere below
+/// it, widened by each ribbon's half-width.
+struct RoadNode {
+    min: DVec3,
+    max: DVec3,
+    /// The node's run of [`RoadIndex::order`].
+    start: u32,
+    len: u32,
+    /// Child node indices, for an inner node (`None` for a leaf).
+    children: Option<[u32; 2]>,
+}
+
 impl RoadIndex {
     /// Precompute the bounds for `overlay`'s ribbons (empty when `enabled` is
     /// false or there are no ribbons).
     #[must_use]
     pub fn build(overlay: &RoadOverlay, enabled: bool) -> Self {
-        let bounds = if enabled {
+        let bounds: Vec<RoadBound> = if enabled {
             overlay.ribbons.iter().map(RoadBound::of).collect()
         } else {
             Vec::new()
         };
-        Self { bounds }
+        let mut order: Vec<u32> = (0..bounds.len() as u32).collect();
+        let mut nodes = Vec::new();
+        if !bounds.is_empty() {
+            RoadNode::build(&mut nodes, &bounds, &mut order, 0);
+        }
+        Self {
+            bounds,
+            nodes,
+            order,
+        }
     }
 
     /// Whether the index holds no ribbons.
@@ -161,15 +194,15 @@ impl RoadIndex {
     /// `0` when none intersect, so an untouched tile never rebuilds for roads.
     #[must_use]
     pub fn fingerprint(&self, world_position: DVec3, tile_radius: f64, margin: f32) -> u64 {
+        let hits = self.intersecting(world_position, tile_radius, margin);
+        if hits.is_empty() {
+            return 0;
+        }
         let mut hasher = std::collections::hash_map::DefaultHasher::new();
-        let mut any = false;
-        for bound in &self.bounds {
-            if bound.intersects(world_position, tile_radius, margin) {
-                hasher.write_u64(bound.sig);
-                any = true;
-            }
+        for index in hits {
+            hasher.write_u64(self.bounds[index].sig);
         }
-        if any { hasher.finish() } else { 0 }
+        hasher.finish()
     }
 
     /// The intersecting ribbons baked into the tile's frame, for a build.
@@ -181,13 +214,89 @@ impl RoadIndex {
         tile_radius: f64,
         margin: f32,
     ) -> Vec<RoadRibbon> {
-        self.bounds
-            .iter()
-            .zip(&overlay.ribbons)
-            .filter(|(bound, _)| bound.intersects(world_position, tile_radius, margin))
-            .map(|(_, ribbon)| ribbon.to_baked(world_position))
+        self.intersecting(world_position, tile_radius, margin)
+            .into_iter()
+            .map(|index| overlay.ribbons[index].to_baked(world_position))
             .collect()
     }
+
+    /// Indices of the ribbons intersecting a tile, in overlay order (so the
+    /// fingerprint and the baked set do not depend on the tree's shape).
+    fn intersecting(&self, world_position: DVec3, tile_radius: f64, margin: f32) -> Vec<usize> {
+        let mut hits = Vec::new();
+        if self.nodes.is_empty() {
+            return hits;
+        }
+        // A sphere that passes `RoadBound::intersects` lies within this much
+        // of the tile's origin, and so does every box enclosing it.
+        let reach = (tile_radius + f64::from(margin)).max(0.0);
+        let mut stack = vec![0u32];
+        while let Some(index) = stack.pop() {
+            let node = &self.nodes[index as usize];
+            let gap = (node.min - world_position)
+                .max(world_position - node.max)
+                .max(DVec3::ZERO);
+            if gap.length_squared() > reach * reach {
+                continue;
+            }
+            match node.children {
+                Some(children) => stack.extend(children),
+                None => {
+                    let run = node.start as usize..(node.start + node.len) as usize;
+                    hits.extend(self.order[run].iter().map(|&i| i as usize).filter(|&i| {
+                        self.bounds[i].intersects(world_position, tile_radius, margin)
+                    }));
+                }
+            }
+        }
+        hits.sort_unstable();
+        hits
+    }
+}
+
+impl RoadNode {
+    /// Build the subtree over `order` (the run of [`RoadIndex::order`] from
+    /// `start`), splitting at the median centre along the widest axis, and
+    /// return its node index.
+    fn build(nodes: &mut Vec<Self>, bounds: &[RoadBound], order: &mut [u32], start: usize) -> u32 {
+        let (min, max) =
+            order
+                .iter()
+                .fold((DVec3::INFINITY, DVec3::NEG_INFINITY), |(min, max), &i| {
+                    let bound = &bounds[i as usize];
+                    let reach = DVec3::splat(bound.radius + f64::from(bound.max_half));
+                    (min.min(bound.center - reach), max.max(bound.center + reach))
+                });
+        let index = nodes.len() as u32;
+        nodes.push(Self {
+            min,
+            max,
+            start: start as u32,
+            len: order.len() as u32,
+            children: None,
+        });
+        if order.len() <= ROAD_LEAF_SIZE {
+            return index;
+        }
+
+        let extent = max - min;
+        let axis = if extent.x >= extent.y && extent.x >= extent.z {
+            0
+        } else if extent.y >= extent.z {
+            1
+        } else {
+            2
+        };
+        let mid = order.len() / 2;
+        order.select_nth_unstable_by(mid, |&a, &b| {
+            bounds[a as usize].center[axis].total_cmp(&bounds[b as usize].center[axis])
+        });
+        let (below, above) = order.split_at_mut(mid);
+        let left = Self::build(nodes, bounds, below, start);
+        let right = Self::build(nodes, bounds, above, start + mid);
+        nodes[index as usize].children = Some([left, right]);
+        index
+    }
 }
 
 impl RoadBound {
@@ -471,3 +580,70 @@ pub(crate) fn write_tile_dump(dump: &veldera_terrain_collider::dump::TileSetDump
         Err(e) => tracing::warn!("failed to write tile dump to {path}: {e}"),
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A city-block lattice of short two-station ribbons, with a few long
+    /// arterials crossing it.
+    fn overlay() -> RoadOverlay {
+        let origin = DVec3::new(1_334_000.0, -4_654_000.0, 4_138_000.0);
+        let ribbon = |from: DVec3, to: DVec3, half_width: f32| EcefRibbon {
+            stations: [from, (from + to) * 0.5, to]
+                .into_iter()
+                .map(|position| EcefStation {
+                    position: origin + position,
+                    half_width,
+                })
+                .collect(),
+            class: 0,
+        };
+        let mut ribbons = Vec::new();
+        for i in 0..40 {
+            for j in 0..40 {
+                let corner = DVec3::new(f64::from(i) * 120.0, f64::from(j) * 120.0, 0.0);
+                ribbons.push(ribbon(corner, corner + DVec3::X * 120.0, 4.0));
+                ribbons.push(ribbon(corner, corner + DVec3::Y * 120.0, 4.0));
+            }
+        }
+        for k in 0..5 {
+            let offset = f64::from(k) * 1000.0;
+            ribbons.push(ribbon(
+                DVec3::new(offset, 0.0, -20.0),
+                DVec3::new(offset, 4800.0, 20.0),
+                12.0,
+            ));
+        }
+        RoadOverlay {
+            ribbons,
+            version: 1,
+        }
+    }
+
+    #[test]
+    fn tree_queries_match_the_linear_scan() {
+        let overlay = overlay();
+        let index = RoadIndex::build(&overlay, true);
+        let origin = overlay.ribbons[0].stations[0].position;
+        for (x, y, tile_radius) in [
+            (0.0, 0.0, 60.0),
+            (2400.0, 2400.0, 150.0),
+            (1000.0, 3000.0, 10.0),
+            (-500.0, -500.0, 100.0),
+            (9000.0, 9000.0, 400.0),
+            (2000.0, 2000.0, 5000.0),
+        ] {
+            let tile = origin + DVec3::new(x, y, 30.0);
+            let expected: Vec<usize> = (0..index.bounds.len())
+                .filter(|&i| index.bounds[i].intersects(tile, tile_radius, 2.0))
+                .collect();
+            assert_eq!(index.intersecting(tile, tile_radius, 2.0), expected);
+        }
+        assert_eq!(
+            index.fingerprint(origin + DVec3::splat(9000.0), 100.0, 2.0),
+            0
+        );
+        assert!(RoadIndex::build(&overlay, false).is_empty());
+    }
+}
@@ -27,7 +27,7 @@ use std::{
 use avian3d::prelude::ColliderAabb;
 use bevy::{
     gizmos::config::GizmoConfigStore,
-    mesh::{Indices, VertexAttributeValues},
+    mesh::{Indices, MeshTag, VertexAttributeValues},
     prelude::*,
 };
 use glam::{DQuat, DVec3};
@@ -39,6 +39,7 @@ use crate::{
     collider::shared::RoadOverlay,
     lod::{LodSnapshot, LodSnapshotRequest, LodState, SnapshotNodeState},
     mesh::RocktreeMeshMarker,
+    terrain_material::{ATTRIBUTE_TERRAIN_POSITION_OCTANT, tile_tag_octant_mask},
 };
 
 /// Filter for terrain-collider wireframe rendering, applied whenever the
@@ -213,7 +214,7 @@ pub(crate) fn draw_lod_viz(
     snapshot: Res<LodSnapshot>,
     mut snapshot_request: ResMut<LodSnapshotRequest>,
     camera_query: Query<&FloatingOriginCamera, With<Camera3d>>,
-    meshes: Query<(&RocktreeMeshMarker, &Visibility)>,
+    meshes: Query<(&RocktreeMeshMarker, &ViewVisibility)>,
     mut gizmos: Gizmos<LodVizGizmos>,
 ) {
     // Keep the snapshot flowing while the loading layer is on; the other
@@ -240,8 +241,9 @@ pub(crate) fn draw_lod_viz(
         // A node spawns one mesh entity per rocktree mesh; dedupe by path so
         // multi-mesh nodes don't double-draw the same OBB.
         let mut seen: HashSet<OctreePath> = HashSet::new();
+        // Bevy's view visibility, so frustum-culled tiles don't draw either.
         for (marker, visibility) in &meshes {
-            if *visibility == Visibility::Hidden || !seen.insert(marker.path) {
+            if !visibility.get() || !seen.insert(marker.path) {
                 continue;
             }
             let depth = marker.path.depth();
@@ -414,11 +416,10 @@ pub(crate) fn draw_render_mesh_wireframes(
     filter: Res<RenderMeshVizFilter>,
     camera_query: Query<&FloatingOriginCamera>,
     meshes: Res<Assets<Mesh>>,
-    materials: Res<Assets<crate::terrain_material::TerrainMaterial>>,
     tiles: Query<(
         &RocktreeMeshMarker,
         &Mesh3d,
-        &MeshMaterial3d<crate::terrain_material::TerrainMaterial>,
+        &MeshTag,
         &GlobalTransform,
         &Visibility,
     )>,
@@ -433,7 +434,7 @@ pub(crate) fn draw_render_mesh_wireframes(
 
     const COLOR: Color = Color::srgb(1.0, 0.55, 0.1);
 
-    for (marker, mesh_handle, material_handle, transform, visibility) in &tiles {
+    for (marker, mesh_handle, tag, transform, visibility) in &tiles {
         if *visibility == Visibility::Hidden {
             continue;
         }
@@ -445,33 +446,25 @@ pub(crate) fn draw_render_mesh_wireframes(
         let Some(mesh) = meshes.get(&mesh_handle.0) else {
             continue;
         };
-        let octant_mask = materials
-            .get(&material_handle.0)
-            .map_or(0, |m| m.extension.octant_mask.x);
+        let octant_mask = tile_tag_octant_mask(tag);
 
-        let Some(VertexAttributeValues::Float32x3(positions)) =
-            mesh.attribute(Mesh::ATTRIBUTE_POSITION)
+        let Some(VertexAttributeValues::Uint8x4(positions)) =
+            mesh.attribute(ATTRIBUTE_TERRAIN_POSITION_OCTANT)
         else {
             continue;
         };
-        // Per-vertex octant index lives in the red channel of vertex color
-        // (sentinel 255 = never masked), exactly as the shader reads it.
-        let octants: Option<&Vec<[f32; 4]>> = match mesh.attribute(Mesh::ATTRIBUTE_COLOR) {
-            Some(VertexAttributeValues::Float32x4(colors)) => Some(colors),
-            _ => None,
-        };
-
+        // Per-vertex octant index lives in the position's `w` (sentinel 255 =
+        // never masked), exactly as the shader reads it.
         let masked = |index: usize| -> bool {
-            octants.is_some_and(|colors| {
-                let octant = (colors[index][0] + 0.5) as u32;
-                octant < 32 && octant_mask >> octant & 1 != 0
-            })
+            let octant = positions[index][3];
+            octant < 8 && octant_mask >> octant & 1 != 0
         };
         let collapsed = |index: usize| -> Vec3 {
             if masked(index) {
                 Vec3::ZERO
             } else {
-                Vec3::from_array(positions[index])
+                let [x, y, z, _] = positions[index];
+                Vec3::new(f32::from(x), f32::from(y), f32::from(z))
             }
         };
 
@@ -0,0 +1,585 @@
+//! Priority-ordered, cancellable node fetch scheduling.
+//!
+//! The LOD traversal in [`lod`](crate::lod) decides *what* should be loaded;
+//! the [`FetchScheduler`] decides *when*. Each traversal replaces the pending
+//! queue wholesale, and every frame the queue is re-prioritised against the
+//! current camera before the free slots are filled, so the tiles under the
+//! camera always go out first even when the traversal itself was skipped.
+//!
+//! In-flight fetches whose paths drop out of every consumer's wanted set are
+//! cancelled after a short delay (see [`LodTuning::fetch_cancel_delay_secs`]),
+//! freeing their slots for tiles that are still needed instead of letting a
+//! fast flight or a teleport fill the pipe with stale requests.
+//!
+//! Concurrency is sized by a [`ConcurrencyLimiter`] from measured latency and
+//! bandwidth rather than a fixed cap: the limit grows while network latency
+//! stays near its uncongested baseline and shrinks as queueing inflates it,
+//! and it never exceeds what the measured bandwidth can actually sustain.
+
+use std::{
+    collections::{BinaryHeap, HashMap, HashSet},
+    time::Duration,
+};
+
+use glam::DVec3;
+use rocktree::{
+    FetchInfo, LodMetrics, NodeMetadata,
+    stage::{Stage, Tile, record_stage},
+};
+use rocktree_decode::OctreePath;
+
+use veldera_async::SpawnedTask;
+
+use crate::lod::{LodTuning, effective_distance};
+
+/// Which consumer asked for a fetch. Each source gets its own share of the
+/// free slots so neither can starve the other: physics requests are the
+/// collision safety net, render requests are what the player sees.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FetchSource {
+    /// Requested by the physics refinement rule.
+    Physics,
+    /// Requested by the render refinement rule.
+    Render,
+}
+
+/// Aggregate scheduler counters for the diagnostics UI.
+#[derive(Debug, Clone, Copy, Default)]
+pub struct FetchStats {
+    /// Fetches waiting for a free slot.
+    pub pending: usize,
+    /// Fetches currently running.
+    pub in_flight: usize,
+    /// Current adaptive concurrency limit.
+    pub concurrency_limit: usize,
+    /// Recent network latency, if any network fetch has completed (s).
+    pub recent_latency_secs: Option<f64>,
+    /// Uncongested baseline network latency (s).
+    pub baseline_latency_secs: Option<f64>,
+    /// Measured network throughput (bytes/s).
+    pub bandwidth_bytes_per_sec: Option<f64>,
+    /// Cumulative number of in-flight fetches cancelled as stale.
+    pub cancelled_total: u64,
+}
+
+/// Scheduler for node data fetches. Owned by [`LodState`](crate::lod::LodState),
+/// which consults [`is_in_flight`](Self::is_in_flight) during the traversal so
+/// running fetches are never requested twice.
+#[derive(Default)]
+pub struct FetchScheduler {
+    /// Requests waiting for a slot, replaced by every traversal run.
+    pending: Vec<PendingFetch>,
+    /// When each pending path was first queued, kept across the
+    /// replacements that still request it, for the queue-wait stage.
+    queued_since: HashMap<OctreePath, f64>,
+    /// Running fetches by path.
+    in_flight: HashMap<OctreePath, InFlightFetch>,
+    limiter: ConcurrencyLimiter,
+    cancelled_total: u64,
+}
+
+impl FetchScheduler {
+    /// Whether a fetch for `path` is currently running.
+    #[must_use]
+    pub fn is_in_flight(&self, path: &OctreePath) -> bool {
+        self.in_flight.contains_key(path)
+    }
+
+    /// Number of running fetches.
+    #[must_use]
+    pub fn in_flight_len(&self) -> usize {
+        self.in_flight.len()
+    }
+
+    /// Number of pending and running fetches whose path matches `filter`.
+    pub(crate) fn count_requested(&self, filter: impl Fn(&OctreePath) -> bool) -> usize {
+        self.pending
+            .iter()
+            .map(|fetch| &fetch.meta.path)
+            .chain(self.in_flight.keys())
+            .filter(|path| filter(path))
+            .count()
+    }
+
+    /// Snapshot of the scheduler counters.
+    #[must_use]
+    pub fn stats(&self) -> FetchStats {
+        FetchStats {
+            pending: self.pending.len(),
+            in_flight: self.in_flight.len(),
+            concurrency_limit: self.limiter.limit(),
+            recent_latency_secs: self.limiter.recent_latency,
+            baseline_latency_secs: self.limiter.baseline_latency,
+            bandwidth_bytes_per_sec: self.limiter.bandwidth,
+            cancelled_total: self.cancelled_total,
+        }
+    }
+
+    /// Replace the pending queue with a traversal's requests. Paths already
+    /// in flight are skipped, and a path requested by both sources is queued
+    /// once, as physics (the more critical consumer). `now` stamps the
+    /// paths queued for the first time.
+    pub(crate) fn replace_pending(
+        &mut self,
+        physics: impl IntoIterator<Item = NodeMetadata>,
+        render: impl IntoIterator<Item = NodeMetadata>,
+        now: f64,
+    ) {
+        self.pending.clear();
+        let mut seen: HashSet<OctreePath> = HashSet::new();
+        let tagged = physics
+            .into_iter()
+            .map(|meta| (meta, FetchSource::Physics))
+            .chain(render.into_iter().map(|meta| (meta, FetchSource::Render)));
+        for (meta, source) in tagged {
+            if self.in_flight.contains_key(&meta.path) || !seen.insert(meta.path) {
+                continue;
+            }
+            self.pending.push(PendingFetch {
+                meta,
+                source,
+                priority: 0.0,
+            });
+        }
+        self.queued_since.retain(|path, _| seen.contains(path));
+        for fetch in &self.pending {
+            self.queued_since.entry(fetch.meta.path).or_insert(now);
+        }
+    }
+
+    /// Cancel in-flight fetches that have been unwanted for longer than the
+    /// configured delay, returning their paths. A fetch that becomes wanted
+    /// again before the delay elapses keeps running, so a brief glance away
+    /// doesn't throw away a nearly finished download.
+    pub(crate) fn cancel_unwanted(
+        &mut self,
+        now: f64,
+        tuning: &LodTuning,
+        is_wanted: impl Fn(&OctreePath) -> bool,
+    ) -> Vec<OctreePath> {
+        let mut cancelled = Vec::new();
+        for (path, fetch) in &mut self.in_flight {
+            if is_wanted(path) {
+                fetch.unwanted_since = None;
+                continue;
+            }
+            let since = *fetch.unwanted_since.get_or_insert(now);
+            if now - since >= tuning.fetch_cancel_delay_secs {
+                cancelled.push(*path);
+            }
+        }
+        for path in &cancelled {
+            if let Some(fetch) = self.in_flight.remove(path) {
+                fetch.task.cancel();
+            }
+        }
+        self.cancelled_total += cancelled.len() as u64;
+        self.pending.retain(|p| is_wanted(&p.meta.path));
+        cancelled
+    }
+
+    /// Re-prioritise the pending queue against the current camera and remove
+    /// the highest-priority requests that fit in the free slots.
+    ///
+    /// The free slots are split between the two sources, with each side's
+    /// unused share rolling over to the other, so a flood of fine render
+    /// meshes can't starve the physics fallback chain and vice versa.
+    pub(crate) fn take_ready(
+        &mut self,
+        tuning: &LodTuning,
+        lod_metrics: &LodMetrics,
+        lead: DVec3,
+    ) -> Vec<(NodeMetadata, FetchSource)> {
+        // `min`/`max` rather than `clamp`, which panics on a mis-ordered
+        // config while it is being edited.
+        let limit = self
+            .limiter
+            .limit()
+            .min(tuning.fetch_max_concurrency)
+            .max(tuning.fetch_min_concurrency);
+        let available = limit.saturating_sub(self.in_flight.len());
+        if available == 0 || self.pending.is_empty() {
+            return Vec::new();
+        }
+
+        let mut physics = BinaryHeap::new();
+        let mut render = BinaryHeap::new();
+        for mut fetch in self.pending.drain(..) {
+            fetch.priority = fetch_priority(&fetch.meta, fetch.source, lod_metrics, lead);
+            match fetch.source {
+                FetchSource::Physics => physics.push(fetch),
+                FetchSource::Render => render.push(fetch),
+            }
+        }
+
+        let physics_take = physics.len().min(available.div_ceil(2));
+        let render_take = render.len().min(available - physics_take);
+        // Roll any unused render share back to physics.
+        let physics_take = physics.len().min(available - render_take);
+
+        let mut ready = Vec::with_capacity(physics_take + render_take);
+        for _ in 0..physics_take {
+            let fetch = physics.pop().expect("take bounded by heap length");
+            ready.push((fetch.meta, fetch.source));
+        }
+        for _ in 0..render_take {
+            let fetch = render.pop().expect("take bounded by heap length");
+            ready.push((fetch.meta, fetch.source));
+        }
+        self.pending.extend(physics.into_vec());
+        self.pending.extend(render.into_vec());
+        ready
+    }
+
+    /// Record a dispatched fetch and its cancellation handle.
+    pub(crate) fn register(&mut self, path: OctreePath, task: SpawnedTask, now: f64) {
+        if let Some(since) = self.queued_since.remove(&path) {
+            record_stage(
+                Stage::Queue,
+                Some(Tile::Node(path)),
+                Duration::from_secs_f64((now - since).max(0.0)),
+            );
+        }
+        self.limiter.on_dispatch(now, self.in_flight.len());
+        self.in_flight.insert(
+            path,
+            InFlightFetch {
+                task,
+                dispatched_at: now,
+                unwanted_since: None,
+            },
+        );
+    }
+
+    /// Record a fetch completion. `info` is `None` for failed fetches, which
+    /// don't feed the latency and bandwidth estimates (a fast error says
+    /// nothing about the link).
+    ///
+    /// Returns `false` when `path` isn't in flight — the result of a fetch
+    /// that was cancelled after it had already sent its result, which the
+    /// caller should drop.
+    pub(crate) fn complete(&mut self, path: OctreePath, now: f64, info: Option<FetchInfo>) -> bool {
+        let Some(fetch) = self.in_flight.remove(&path) else {
+            return false;
+        };
+        if let Some(info) = info {
+            self.limiter.on_complete(now - fetch.dispatched_at, info);
+        }
+        true
+    }
+
+    /// Advance the bandwidth measurement window. Call once per frame.
+    pub(crate) fn tick(&mut self, now: f64, tuning: &LodTuning) {
+        self.limiter
+            .tick(now, self.in_flight.len(), !self.pending.is_empty(), tuning);
+    }
+}
+
+/// Adaptive concurrency limit derived from measured latency and bandwidth.
+///
+/// The update is latency-gradient based: the ratio of the long-window
+/// (baseline) latency to the short-window (recent) latency is `~1` while the
+/// link is uncongested and falls as requests start queueing. Each update
+/// scales the limit by that gradient and adds `sqrt(limit)` of headroom, so
+/// the limit probes upward when latency holds steady and backs off as soon as
+/// it inflates. The result is additionally capped by Little's law — the
+/// concurrency the measured bandwidth sustains at baseline latency, with
+/// [`LodTuning::fetch_bandwidth_headroom`] slack — so a link whose latency
+/// doesn't grow under load (e.g. a server that queues silently) still can't
+/// accumulate an unbounded backlog.
+///
+/// Cache hits are excluded from every estimate: they finish in microseconds
+/// and would drag the baseline towards zero, making every later network fetch
+/// read as congestion.
+#[derive(Debug, Clone)]
+pub(crate) struct ConcurrencyLimiter {
+    limit: f64,
+    recent_latency: Option<f64>,
+    baseline_latency: Option<f64>,
+    /// Mean encoded response size over network fetches (bytes).
+    mean_response_bytes: Option<f64>,
+    bandwidth: Option<f64>,
+    /// Network bytes completed in the current bandwidth window.
+    window_bytes: usize,
+    /// Start of the current bandwidth window, if one is open.
+    window_start: Option<f64>,
+}
+
+impl Default for ConcurrencyLimiter {
+    fn default() -> Self {
+        Self {
+            limit: INITIAL_CONCURRENCY,
+            recent_latency: None,
+            baseline_latency: None,
+            mean_response_bytes: None,
+            bandwidth: None,
+            window_bytes: 0,
+            window_start: None,
+        }
+    }
+}
+
+impl ConcurrencyLimiter {
+    /// The current limit, rounded down to whole fetches.
+    pub(crate) fn limit(&self) -> usize {
+        self.limit as usize
+    }
+
+    fn on_dispatch(&mut self, now: f64, in_flight: usize) {
+        // A window only measures the link while it is busy; keep one open
+        // from the first dispatch onto an idle link.
+        if in_flight == 0 && self.window_start.is_none() {
+            self.window_start = Some(now);
+            self.window_bytes = 0;
+        }
+    }
+
+    fn on_complete(&mut self, latency_secs: f64, info: FetchInfo) {
+        // Neither a cache hit nor a ride on another request's transfer says
+        // anything about the network.
+        if info.cache_hit || info.coalesced {
+            return;
+        }
+        let latency = latency_secs.max(MIN_LATENCY_SECS);
+        self.recent_latency = Some(ewma(self.recent_latency, latency, RECENT_LATENCY_ALPHA));
+        self.baseline_latency = Some(ewma(self.baseline_latency, latency, BASELINE_LATENCY_ALPHA));
+        self.mean_response_bytes = Some(ewma(
+            self.mean_response_bytes,
+            info.bytes as f64,
+            RESPONSE_BYTES_ALPHA,
+        ));
+        self.window_bytes += info.bytes;
+
+        let (Some(recent), Some(baseline)) = (self.recent_latency, self.baseline_latency) else {
+            return;
+        };
+        let gradient = (baseline / recent).clamp(MIN_GRADIENT, 1.0);
+        let target = self.limit * gradient + self.limit.sqrt();
+        self.limit += (target - self.limit) * LIMIT_SMOOTHING;
+    }
+
+    fn tick(&mut self, now: f64, in_flight: usize, has_pending: bool, tuning: &LodTuning) {
+        if let Some(start) = self.window_start {
+            let elapsed = now - start;
+            if elapsed >= BANDWIDTH_WINDOW_SECS {
+                if self.window_bytes > 0 {
+                    let sample = self.window_bytes as f64 / elapsed;
+                    self.bandwidth = Some(ewma(self.bandwidth, sample, BANDWIDTH_ALPHA));
+                }
+                self.window_bytes = 0;
+                self.window_start = (in_flight > 0).then_some(now);
+            }
+        }
+
+        let mut max = tuning.fetch_max_concurrency as f64;
+        if let (Some(bandwidth), Some(baseline), Some(mean_bytes)) = (
+            self.bandwidth,
+            self.baseline_latency,
+            self.mean_response_bytes,
+        ) && mean_bytes > 0.0
+        {
+            let sustainable = bandwidth * baseline / mean_bytes;
+            max = max.min(sustainable * tuning.fetch_bandwidth_headroom);
+        }
+        let min = tuning.fetch_min_concurrency as f64;
+        // An idle link gives no signal either way; hold the limit rather than
+        // letting a stale cap decay it.
+        if in_flight > 0 || has_pending {
+            self.limit = self.limit.min(max).max(min);
+        }
+    }
+}
+
+/// The fixed cap this scheduler replaced; the limiter starts here and adapts.
+const INITIAL_CONCURRENCY: f64 = 64.0;
+/// Floor on measured latency, so a fetch completing within the frame it was
+/// dispatched can't produce a zero baseline (s).
+const MIN_LATENCY_SECS: f64 = 1e-3;
+/// EWMA factor for the short-window latency (a handful of fetches).
+const RECENT_LATENCY_ALPHA: f64 = 0.2;
+/// EWMA factor for the baseline latency (on the order of a hundred fetches).
+const BASELINE_LATENCY_ALPHA: f64 = 0.01;
+/// EWMA factor for the mean response size.
+const RESPONSE_BYTES_ALPHA: f64 = 0.05;
+/// EWMA factor for the bandwidth estimate, per window.
+const BANDWIDTH_ALPHA: f64 = 0.3;
+/// Length of a bandwidth measurement window (s).
+const BANDWIDTH_WINDOW_SECS: f64 = 0.5;
+/// Lower clamp on the latency gradient, bounding how fast the limit halves.
+const MIN_GRADIENT: f64 = 0.5;
+/// Fraction of the way the limit moves towards its target per completion.
+const LIMIT_SMOOTHING: f64 = 0.2;
+
+/// A request waiting for a slot.
+struct PendingFetch {
+    meta: NodeMetadata,
+    source: FetchSource,
+    /// Higher is sooner. Recomputed every frame in [`FetchScheduler::take_ready`].
+    priority: f64,
+}
+
+impl PartialEq for PendingFetch {
+    fn eq(&self, other: &Self) -> bool {
+        self.priority.total_cmp(&other.priority).is_eq()
+    }
+}
+
+impl Eq for PendingFetch {}
+
+impl PartialOrd for PendingFetch {
+    fn partial_cmp(&self, other: &Self) -> Option<std::cmp::Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for PendingFetch {
+    fn cmp(&self, other: &Self) -> std::cmp::Ordering {
+        self.priority.total_cmp(&other.priority)
+    }
+}
+
+/// A running fetch.
+struct InFlightFetch {
+    task: SpawnedTask,
+    /// Elapsed-seconds timestamp of the dispatch, for latency measurement.
+    dispatched_at: f64,
+    /// When the path first dropped out of the wanted set, if it has.
+    unwanted_since: Option<f64>,
+}
+
+/// Priority of a pending fetch; higher is sooner.
+///
+/// Render requests are keyed by screen-space error: the projected size of the
+/// node's texels at its (lead-compressed) nearest distance, so the coarse
+/// nodes covering the view and the fine nodes right under the camera go out
+/// before distant refinements. Physics requests are keyed by distance alone,
+/// matching the distance-banded rule that requested them.
+fn fetch_priority(
+    meta: &NodeMetadata,
+    source: FetchSource,
+    lod_metrics: &LodMetrics,
+    lead: DVec3,
+) -> f64 {
+    let distance = effective_distance(&meta.obb, lod_metrics.camera_position, lead).max(1.0);
+    match source {
+        FetchSource::Render => {
+            f64::from(meta.meters_per_texel) * lod_metrics.pixels_per_meter / distance
+        }
+        FetchSource::Physics => 1.0 / distance,
+    }
+}
+
+/// Exponentially weighted moving average, seeded by the first sample.
+fn ewma(previous: Option<f64>, sample: f64, alpha: f64) -> f64 {
+    previous.map_or(sample, |p| p + (sample - p) * alpha)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn tuning() -> LodTuning {
+        LodTuning {
+            fetch_min_concurrency: 4,
+            fetch_max_concurrency: 256,
+            fetch_bandwidth_headroom: 2.0,
+            fetch_cancel_delay_secs: 0.5,
+            ..Default::default()
+        }
+    }
+
+    fn network(bytes: usize) -> FetchInfo {
+        FetchInfo {
+            bytes,
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn test_limiter_grows_at_steady_latency() {
+        let mut limiter = ConcurrencyLimiter::default();
+        let start = limiter.limit;
+        for _ in 0..50 {
+            limiter.on_complete(0.1, network(10_000));
+        }
+        assert!(limiter.limit > start, "limit {} <= {start}", limiter.limit);
+    }
+
+    #[test]
+    fn test_limiter_backs_off_when_latency_inflates() {
+        let mut limiter = ConcurrencyLimiter::default();
+        for _ in 0..200 {
+            limiter.on_complete(0.1, network(10_000));
+        }
+        let before = limiter.limit;
+        for _ in 0..20 {
+            limiter.on_complete(1.0, network(10_000));
+        }
+        assert!(
+            limiter.limit < before,
+            "limit {} >= {before}",
+            limiter.limit
+        );
+    }
+
+    #[test]
+    fn test_limiter_ignores_cache_hits_and_coalesced_fetches() {
+        let mut limiter = ConcurrencyLimiter::default();
+        limiter.on_complete(
+            0.0,
+            FetchInfo {
+                bytes: 10,
+                cache_hit: true,
+                ..Default::default()
+            },
+        );
+        limiter.on_complete(
+            0.0,
+            FetchInfo {
+                bytes: 10,
+                coalesced: true,
+                ..Default::default()
+            },
+        );
+        assert!(limiter.baseline_latency.is_none());
+        assert!(limiter.mean_response_bytes.is_none());
+    }
+
+    #[test]
+    fn test_limiter_capped_by_bandwidth() {
+        let tuning = tuning();
+        let mut limiter = ConcurrencyLimiter::default();
+        limiter.on_dispatch(0.0, 0);
+        // 10 fetches of 100 kB at 0.2 s each inside a 1 s window: 1 MB/s, so
+        // Little's law sustains 1 MB/s × 0.2 s / 100 kB = 2 fetches.
+        for _ in 0..10 {
+            limiter.on_complete(0.2, network(100_000));
+        }
+        limiter.tick(1.0, 1, true, &tuning);
+        let cap = 2.0 * tuning.fetch_bandwidth_headroom;
+        assert!(
+            (limiter.limit - cap).abs() < 1e-9,
+            "limit {} != bandwidth cap {cap}",
+            limiter.limit
+        );
+    }
+
+    #[test]
+    fn test_limiter_holds_when_idle() {
+        let tuning = LodTuning {
+            fetch_max_concurrency: 8,
+            ..tuning()
+        };
+        let mut limiter = ConcurrencyLimiter::default();
+        limiter.tick(10.0, 0, false, &tuning);
+        assert_eq!(limiter.limit, INITIAL_CONCURRENCY);
+        limiter.tick(10.0, 1, false, &tuning);
+        assert_eq!(limiter.limit, 8.0);
+    }
+
+    #[test]
+    fn test_ewma_seeds_with_first_sample() {
+        assert_eq!(ewma(None, 3.0, 0.1), 3.0);
+        assert!((ewma(Some(1.0), 3.0, 0.5) - 2.0).abs() < 1e-12);
+    }
+}
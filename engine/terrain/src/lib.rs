@@ -1,23 +1,42 @@
 //! Streaming terrain for planet-scale Veldera worlds.
 //!
 //! Owns the rocktree level-of-detail pipeline end to end:
+//! - [`bulk_index`] lays out each cached bulk's nodes for constant-time
+//!   child lookups in the LoD walk.
 //! - [`loader`] bootstraps the planetoid and root bulk metadata.
+//! - [`fetch`] schedules node fetches: a re-prioritised queue, cancellation
+//!   of stale in-flight requests, and concurrency sized from measured latency
+//!   and bandwidth.
 //! - [`lod`] walks the octree each frame to decide which nodes to load, render,
 //!   and give physics colliders, driving both the render and physics refinement
 //!   rules from a single traversal.
+//! - [`walk_cache`] memoises that traversal across frames, so only subtrees
+//!   whose decisions may have changed are re-walked.
+//! - [`residency`] keeps what the walk no longer needs within CPU and GPU
+//!   byte budgets, evicting by worth per byte.
+//! - [`prefetch`] warms the tile cache ahead of the camera's motion and of
+//!   announced destinations such as teleports, within a bandwidth budget.
 //! - [`mesh`] converts rocktree meshes and textures into Bevy assets.
 //! - [`terrain_material`] is the octant-masked material that hides vertices in
 //!   octants whose children have loaded, for seamless LOD transitions.
+//! - [`tile_textures`] pools tile textures into texture arrays, so tiles
+//!   sharing a page share one material and batch into few draws.
 //!
 //! The crate is gameplay-agnostic: it reads the floating-origin camera from
 //! [`veldera_geo`] and produces colliders via [`veldera_physics`], but knows
 //! nothing about players, vehicles, or camera modes.
 
+pub mod bulk_index;
 pub mod collider;
+pub mod fetch;
 pub mod loader;
 pub mod lod;
 pub mod mesh;
+pub mod prefetch;
+pub mod residency;
 pub mod terrain_material;
+pub mod tile_textures;
+pub mod walk_cache;
 
 use bevy::app::{PluginGroup, PluginGroupBuilder};
 
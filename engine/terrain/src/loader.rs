@@ -9,27 +9,108 @@
 
 use std::sync::Arc;
 
-use bevy::prelude::*;
+use bevy::{
+    prelude::*,
+    render::{renderer::RenderDevice, settings::WgpuFeatures},
+};
 use rocktree::{BulkMetadata, BulkRequest, Client, Planetoid};
+#[cfg(not(target_family = "wasm"))]
+use rocktree::{
+    Cache,
+    cache::{CacheFuture, ContainsFuture, GetFuture},
+};
 
 use veldera_async::TaskSpawner;
 
-/// The tile cache backing the rocktree client: a persistent on-disk cache on
-/// native, an in-memory cache in the browser (which has no filesystem and
-/// keeps its own HTTP cache anyway).
-#[cfg(not(target_family = "wasm"))]
-pub type TileCache = rocktree::FilesystemCache;
+/// The tile cache backing the rocktree client: a persistent, memory-mapped
+/// pack cache on native, an in-memory cache in the browser (which has no
+/// filesystem and keeps its own HTTP cache anyway).
 #[cfg(target_family = "wasm")]
 pub type TileCache = rocktree::MemoryCache;
 
+/// The tile cache backing the rocktree client: a persistent, memory-mapped
+/// pack cache, or an in-memory one when no pack can be opened.
+#[cfg(not(target_family = "wasm"))]
+pub enum TileCache {
+    /// The shared pack, or a temp-directory fallback.
+    Pack(rocktree::PackCache),
+    /// Lost on exit, like the browser's.
+    Memory(rocktree::MemoryCache),
+}
+
+#[cfg(not(target_family = "wasm"))]
+impl Cache for TileCache {
+    fn get(&self, url: &str) -> GetFuture<'_> {
+        match self {
+            Self::Pack(cache) => cache.get(url),
+            Self::Memory(cache) => cache.get(url),
+        }
+    }
+
+    fn put(&self, url: &str, data: Arc<[u8]>) -> CacheFuture<'_> {
+        match self {
+            Self::Pack(cache) => cache.put(url, data),
+            Self::Memory(cache) => cache.put(url, data),
+        }
+    }
+
+    fn contains(&self, url: &str) -> ContainsFuture<'_> {
+        match self {
+            Self::Pack(cache) => cache.contains(url),
+            Self::Memory(cache) => cache.contains(url),
+        }
+    }
+
+    fn remove(&self, url: &str) -> CacheFuture<'_> {
+        match self {
+            Self::Pack(cache) => cache.remove(url),
+            Self::Memory(cache) => cache.remove(url),
+        }
+    }
+
+    fn clear(&self) -> CacheFuture<'_> {
+        match self {
+            Self::Pack(cache) => cache.clear(),
+            Self::Memory(cache) => cache.clear(),
+        }
+    }
+}
+
 /// Construct the default tile cache. Native builds persist under the shared
-/// `<OS cache dir>/veldera/rocktree` root, falling back to the OS temp
-/// directory if the cache directory cannot be resolved.
+/// `<OS cache dir>/veldera/rocktree-pack` root, and then delete the
+/// one-file-per-URL cache it replaced. If the root can't be resolved or is
+/// held by another running instance, this one falls back to one of a few
+/// fixed, smaller packs in the OS temp directory, so fallbacks reuse each
+/// other's tiles and never pile up. If none of those open either (a
+/// read-only or full temp directory, say), tiles are cached in memory only.
 #[cfg(not(target_family = "wasm"))]
 fn default_cache() -> TileCache {
-    rocktree::FilesystemCache::veldera().unwrap_or_else(|| {
-        rocktree::FilesystemCache::new(std::env::temp_dir().join("veldera").join("rocktree"))
-    })
+    /// Temp packs to try, for that many instances beside the main one.
+    const FALLBACK_SLOTS: usize = 4;
+    /// Size limit of each temp pack.
+    const FALLBACK_MAX_SIZE: u64 = 1 << 30;
+
+    match rocktree::PackCache::veldera() {
+        Some(Ok(cache)) => {
+            rocktree::PackCache::remove_legacy_veldera_cache();
+            return TileCache::Pack(cache);
+        }
+        Some(Err(e)) => warn!("Failed to open tile cache: {e}"),
+        None => warn!("No OS cache directory; using a temporary tile cache"),
+    }
+    let root = std::env::temp_dir().join("veldera");
+    let mut last_error = None;
+    for slot in 0..FALLBACK_SLOTS {
+        let dir = root.join(format!("rocktree-pack-fallback-{slot}"));
+        match rocktree::PackCache::with_max_size(&dir, FALLBACK_MAX_SIZE) {
+            Ok(cache) => return TileCache::Pack(cache),
+            Err(e) => last_error = Some(e),
+        }
+    }
+    if let Some(e) = last_error {
+        warn!("Failed to open a temporary tile cache: {e}; caching tiles in memory only");
+    }
+    TileCache::Memory(rocktree::MemoryCache::new())
 }
 
 #[cfg(target_family = "wasm")]
@@ -37,11 +118,25 @@ fn default_cache() -> TileCache {
     rocktree::MemoryCache::new()
 }
 
+/// The decode workers' bootstrap script, next to `index.html` in the web
+/// build (see `scripts/web_build.sh`).
+#[cfg(target_family = "wasm")]
+const DECODE_WORKER_SCRIPT: &str = "./decode_worker.js";
+
 /// Plugin for loading Google Earth data.
 pub struct DataLoaderPlugin;
 
 impl Plugin for DataLoaderPlugin {
     fn build(&self, app: &mut App) {
+        // Decode tiles off the page where the worker pool's files are served;
+        // without them, decoding stays on the page.
+        #[cfg(target_family = "wasm")]
+        if let Err(e) =
+            rocktree::workers::start(DECODE_WORKER_SCRIPT, rocktree::workers::default_count())
+        {
+            warn!("Failed to start decode workers: {e}");
+        }
+
         app.init_resource::<LoaderState>()
             .init_resource::<LoaderChannels>()
             .add_systems(Startup, start_initial_load)
@@ -58,6 +153,10 @@ pub struct LoaderState {
     pub planetoid: Option<Planetoid>,
     /// Root bulk metadata (once loaded).
     pub root_bulk: Option<BulkMetadata>,
+    /// Whether the GPU samples BC1 natively, so node fetches can keep CRN
+    /// textures block-compressed (an eighth of the VRAM of RGBA). Set at
+    /// startup from the render device's features.
+    pub block_compressed_textures: bool,
 }
 
 impl Default for LoaderState {
@@ -66,6 +165,7 @@ impl Default for LoaderState {
             client: Arc::new(Client::with_cache(default_cache())),
             planetoid: None,
             root_bulk: None,
+            block_compressed_textures: false,
         }
     }
 }
@@ -94,10 +194,27 @@ impl Default for LoaderChannels {
 
 /// Start loading the initial planetoid data.
 fn start_initial_load(
-    state: Res<LoaderState>,
+    mut state: ResMut<LoaderState>,
     channels: Res<LoaderChannels>,
+    render_device: Option<Res<RenderDevice>>,
     spawner: TaskSpawner,
 ) {
+    // Adapters without BC support (e.g. some WebGPU targets) fall back to
+    // RGBA textures.
+    state.block_compressed_textures = render_device.is_some_and(|device| {
+        device
+            .features()
+            .contains(WgpuFeatures::TEXTURE_COMPRESSION_BC)
+    });
+    tracing::info!(
+        "Terrain textures: {}",
+        if state.block_compressed_textures {
+            "BC1"
+        } else {
+            "RGBA"
+        }
+    );
+
     let client = Arc::clone(&state.client);
     let tx = channels.planetoid_tx.clone();
 
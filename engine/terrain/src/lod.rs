@@ -27,43 +27,67 @@
 //!   in the diagnostics until loads (which prioritise the physics chain)
 //!   close the gap.
 //!
+//! Consecutive walks share their work: [`crate::walk_cache`] replays every
+//! subtree whose inputs haven't changed since the previous walk, so a small
+//! camera move re-evaluates only the nodes near the refinement front.
+//! What does need re-walking is split across the compute pool below
+//! [`LodTuning::bfs_fanout_depth`].
+//!
 //! Both rules share the same bulk + node caches. Retention takes the
 //! union of both rules' potential sets *over a rolling grace window*
 //! (see [`LodTuning::unload_grace_period_secs`]) — a node stays alive
 //! as long as either consumer asked for it within the last few seconds.
 //! The grace window prevents thrash when the view briefly turns away
-//! and back.
+//! and back. Past it, nodes stay resident while the CPU and GPU byte
+//! budgets allow, evicted by worth per byte once they don't (see
+//! [`crate::residency`]).
 //!
 //! Uses platform-agnostic `async_channel` for communication between async tasks
 //! and the main thread. Task spawning is handled by `TaskSpawner` from the
 //! [`veldera_async`] crate.
 
 use std::{
-    collections::{HashMap, HashSet},
+    collections::{HashMap, HashSet, VecDeque},
     sync::Arc,
+    time::Duration,
 };
 
-use bevy::{light::NotShadowCaster, prelude::*, reflect::TypePath};
-use glam::{DMat4, DVec3};
+use bevy::{
+    camera::visibility::VisibilitySystems, core_pipeline::prepass::DepthPrepass,
+    light::NotShadowCaster, mesh::MeshTag, platform::time::Instant, prelude::*, reflect::TypePath,
+    render::experimental::occlusion_culling::OcclusionCulling, tasks::ComputeTaskPool,
+};
+use glam::{DMat4, DQuat, DVec3};
 use rocktree::{
-    BulkMetadata, BulkRequest, Frustum, LodMetrics, Mesh as RocktreeMesh, Node, NodeMetadata,
-    NodeRequest,
+    BulkMetadata, BulkRequest, FetchInfo, FetchPriority, Frustum, LodMetrics, Mesh as RocktreeMesh,
+    NodeMetadata, NodeRequest,
+    stage::{Stage, Tile, record_stage},
 };
 use rocktree_decode::{OctreePath, OrientedBoundingBox};
 use serde::Deserialize;
 
 use crate::{
+    bulk_index::{BulkNodeIndex, NodeSlot},
     collider::{
         self, COLLIDER,
         viz::{
             ColliderVizFilter, LodVizGizmos, LodVizSettings, configure_lod_viz_gizmos, draw_lod_viz,
         },
     },
+    fetch::{FetchScheduler, FetchSource, FetchStats},
     loader::LoaderState,
-    mesh::{
-        RocktreeMeshMarker, convert_mesh, convert_texture, matrix_to_world_position_and_transform,
+    mesh::{PreparedNode, RocktreeMeshMarker, prepare_node},
+    prefetch::{PrefetchHints, PrefetchStats, Prefetcher, update_prefetch},
+    residency::{
+        Candidate, ColliderBytes, Footprint, Residency, ResidencyStats, keep_value, plan_evictions,
+        render_mesh_bytes,
+    },
+    terrain_material::{TerrainMaterial, tile_tag, with_octant_mask},
+    tile_textures::{TileSlot, TileTexturePool},
+    walk_cache::{
+        Slack, WalkArgs, WalkCache, WalkDirty, WalkEvent, WalkGlobals, WalkLog, WalkMemo, WalkPose,
+        WalkStats,
     },
-    terrain_material::{TerrainMaterial, TerrainMaterialExtension},
 };
 
 // The tile-dump request resource lives in the shared collider core but is
@@ -92,18 +116,31 @@ pub struct LodTuning {
     /// doesn't drop tiles you were just looking at (m). Wider = more CPU memory,
     /// less reload pop-in.
     pub keep_loaded_radius: f64,
-    /// Delays eviction of tiles that have left every BFS's potential set (s).
-    /// Longer = transient camera moves don't churn streaming, but stale tiles
-    /// linger in memory.
+    /// Time tiles that have left every BFS's potential set are kept
+    /// regardless of the residency budgets (s). Past it they stay only while
+    /// the budgets have room. Longer = transient camera moves never churn
+    /// streaming, but stale tiles can't make way for new ones as early.
     pub unload_grace_period_secs: f64,
+    /// Budgets for everything the terrain keeps loaded, in MiB (see
+    /// [`crate::residency`]): CPU covers the decoded meshes cached for
+    /// physics, the main-world copies of tile meshes, and colliders; GPU
+    /// covers uploaded tile meshes and texture layers. The free layers of
+    /// allocated tile-texture pages count against the GPU budget too, so
+    /// fragmented pages make room by evicting tiles rather than growing
+    /// past it. Read through
+    /// [`Self::residency_budget`].
+    pub cpu_budget_mib: f64,
+    pub gpu_budget_mib: f64,
+    /// The budgets in the browser, where a tab's memory is far scarcer.
+    pub web_cpu_budget_mib: f64,
+    pub web_gpu_budget_mib: f64,
+    /// Time since a walk last wanted a tile at which its worth to residency
+    /// has halved (s). Shorter = eviction favours what was in view most
+    /// recently; longer = it favours what's coarse or close.
+    pub residency_recency_secs: f64,
     /// Maximum altitude above terrain at which forced proximity loading applies
     /// (m); above this, normal frustum culling is used for all nodes.
     pub proximity_loading_max_altitude: f64,
-    /// Radius around the camera within which loaded nodes are forced visible in
-    /// `cull_meshes`, bypassing frustum culling (m). A safety net for the ground
-    /// right under the player; kept small so nodes behind the camera aren't
-    /// rendered for no benefit.
-    pub force_visible_radius: f64,
     /// BFS-skip tolerance: camera moves below this distance (m) reuse the
     /// previous frame's traversal instead of re-walking the octree.
     pub bfs_pos_epsilon: f64,
@@ -113,6 +150,105 @@ pub struct LodTuning {
     /// BFS-skip tolerance: lead-vector changes below this length (m) are
     /// treated as unchanged.
     pub bfs_lead_epsilon: f64,
+    /// Re-walk only the subtrees whose decisions could have changed since the
+    /// last traversal, replaying the rest (see [`crate::walk_cache`]). `false`
+    /// re-walks the whole tree every time, for comparison.
+    pub bfs_incremental: bool,
+    /// Depth at which the walk fans out across the compute pool, one task
+    /// per call at this depth. Deeper = more, smaller tasks but more of the
+    /// tree walked on one thread first; `0` walks single-threaded.
+    pub bfs_fanout_depth: usize,
+    /// Floor on the adaptive node-fetch concurrency limit. The limit never
+    /// backs off below this, however congested the link looks.
+    pub fetch_min_concurrency: usize,
+    /// Ceiling on the adaptive node-fetch concurrency limit.
+    pub fetch_max_concurrency: usize,
+    /// Slack on the bandwidth-derived concurrency cap: the limit may exceed
+    /// what the measured bandwidth sustains at baseline latency by this
+    /// factor, so the limiter can still probe for more throughput.
+    pub fetch_bandwidth_headroom: f64,
+    /// Delay before an in-flight node fetch that no consumer wants any more
+    /// is cancelled (s). Longer = fewer cancellations on brief glances away,
+    /// but stale fetches hold their slots longer during fast flight.
+    pub fetch_cancel_delay_secs: f64,
+    /// Backoff before the walk requests a node again after its fetch failed
+    /// (s), doubled on each further failure up to
+    /// [`Self::fetch_retry_max_secs`]. The client has already retried
+    /// transient errors by then, so what's left is mostly tiles the server
+    /// doesn't have; re-requesting them every frame would only churn the
+    /// queue and keep streaming from ever settling.
+    pub fetch_retry_secs: f64,
+    /// Longest backoff between requests for a failing node (s).
+    pub fetch_retry_max_secs: f64,
+    /// Maximum concurrent bulk-metadata fetches. Bulks are small and gate
+    /// traversal, so they bypass the adaptive node-fetch limit.
+    pub max_bulk_loads: usize,
+    /// Main-thread time budget for spawning converted nodes each frame (ms).
+    /// Nodes past the budget wait for the next frame; at least one node is
+    /// spawned per frame regardless, so a tiny budget can't stall streaming.
+    pub node_spawn_budget_ms: f64,
+    /// Layers of a full-sized tile-texture page (see
+    /// [`crate::tile_textures`]), at most
+    /// [`MAX_PAGE_LAYERS`](crate::tile_textures::MAX_PAGE_LAYERS). Pages of a
+    /// format grow to this size, and a page is allocated whole, so larger
+    /// pages batch more tiles per draw but hold more unused memory. Read when
+    /// a page opens.
+    pub tile_texture_page_layers: u16,
+    /// Texel size on screen (px) below which a spawning tile leaves its top
+    /// texture mip levels out (see [`crate::tile_textures`]): it keeps as its
+    /// largest level the biggest whose texels are at most this big. Once a
+    /// closer camera makes them twice this, the tile is fetched and spawned
+    /// again with the levels it now needs. `0` keeps every level.
+    pub texture_drop_texel_px: f64,
+    /// Most top mip levels a tile may leave out. Each level left out saves
+    /// three quarters of the texture memory that was left.
+    pub texture_max_dropped_levels: u32,
+    /// Cull tiles hidden behind nearer geometry on the GPU, against a depth
+    /// pyramid of the previous frame. Adds a depth prepass, which pays for
+    /// itself when terrain occludes terrain (cities, mountains); adapters
+    /// without GPU culling (WebGL 2) ignore it and frustum-cull on the CPU.
+    pub occlusion_culling: bool,
+    /// Maximum concurrent speculative prefetches (see [`crate::prefetch`]).
+    /// `0` disables prefetching.
+    pub prefetch_max_concurrency: usize,
+    /// Share of the measured node-fetch bandwidth prefetching may spend.
+    /// Higher = teleports and fast flight land on warmer tiles, at the cost
+    /// of bandwidth the visible set could have used.
+    pub prefetch_bandwidth_fraction: f64,
+    /// Radius around the motion-lead target to warm (m).
+    pub prefetch_radius: f64,
+    /// How many motion leads ahead of the camera the lead target sits.
+    pub prefetch_lead_scale: f64,
+    /// Cap on nodes planned per re-plan, shared across all targets.
+    pub prefetch_max_nodes: usize,
+    /// Interval between prefetch re-plans while the targets are unchanged
+    /// (s), so the plan picks up nodes the traversal has loaded meanwhile.
+    pub prefetch_replan_secs: f64,
+    /// How far the motion-lead target moves before it counts as a new target
+    /// and forces a re-plan (m). Smaller moves wait for the periodic re-plan.
+    pub prefetch_lead_step: f64,
+    /// Bandwidth assumed before any fetch has measured it (bytes/s).
+    pub prefetch_fallback_bandwidth: f64,
+    /// Warmed nodes are forgotten after this long (s); one the traversal
+    /// hasn't asked for by then counts as wasted.
+    pub prefetch_warmed_ttl_secs: f64,
+    /// Cap on bulks decoded for prefetch planning; the oldest go first. They
+    /// are small, but a long flight would otherwise keep every bulk it crossed.
+    pub prefetch_max_bulks: usize,
+}
+
+impl LodTuning {
+    /// The residency budgets for this platform.
+    pub fn residency_budget(&self) -> Footprint {
+        #[cfg(target_family = "wasm")]
+        {
+            Footprint::from_mib(self.web_cpu_budget_mib, self.web_gpu_budget_mib)
+        }
+        #[cfg(not(target_family = "wasm"))]
+        {
+            Footprint::from_mib(self.cpu_budget_mib, self.gpu_budget_mib)
+        }
+    }
 }
 
 /// Plugin for LOD management and frustum culling.
@@ -157,18 +293,27 @@ impl Plugin for LodPlugin {
             .init_resource::<LodSnapshotRequest>()
             .init_resource::<LodScratch>()
             .init_resource::<FreezeLod>()
+            .init_resource::<ColliderBytes>()
+            .init_resource::<PrefetchHints>()
+            .init_resource::<Prefetcher>()
             .add_plugins(ConfigPlugin::<LodTuning>::new(self.config_path))
             .add_systems(
                 Update,
                 (
                     update_frustum,
                     update_lod_requests,
+                    update_prefetch,
                     poll_lod_bulk_tasks,
                     poll_lod_node_tasks,
                     cull_meshes,
                 )
                     .chain(),
             )
+            .add_systems(Update, configure_occlusion_culling)
+            .add_systems(
+                PostUpdate,
+                report_first_visible.after(VisibilitySystems::CheckVisibility),
+            )
             .init_resource::<ColliderVizFilter>()
             .init_resource::<LodVizSettings>()
             .init_gizmo_group::<LodVizGizmos>()
@@ -240,6 +385,27 @@ pub struct SnapshotCounters {
     pub bulks_cached: usize,
     pub bulks_loading: usize,
     pub bulks_failed: usize,
+    /// Nodes whose last fetch failed (see [`LodTuning::fetch_retry_secs`]).
+    pub nodes_failed: usize,
+    /// Queued or running node fetches that retry an earlier failure.
+    pub nodes_retrying: usize,
+    /// Node fetch scheduler counters (queue depth, adaptive limit, latency,
+    /// bandwidth, and cancellations).
+    pub fetch: FetchStats,
+    /// Speculative prefetch counters (see [`crate::prefetch`]).
+    pub prefetch: PrefetchStats,
+    /// How much of the last octree walk was replayed from the one before
+    /// (see [`crate::walk_cache`]).
+    pub walk: WalkStats,
+    /// Time the octree walk took this frame; zero when it was skipped
+    /// because nothing it depends on changed.
+    pub walk_time: Duration,
+    /// Converted nodes waiting for their render entities.
+    pub spawn_queued: usize,
+    /// Bytes of tile-texture pages allocated (see [`crate::tile_textures`]).
+    pub texture_bytes: u64,
+    /// Resident bytes against the budgets (see [`crate::residency`]).
+    pub residency: ResidencyStats,
     /// Per-depth counts across the captured snapshot, indexed by depth.
     pub render_loaded_by_depth: Vec<usize>,
     pub render_loading_by_depth: Vec<usize>,
@@ -292,43 +458,79 @@ pub struct LoadedNodeData {
     pub transform: Transform,
     /// World position of the node.
     pub world_position: DVec3,
-    /// Meters per texel (LOD metric). Stored for debugging/future use.
-    #[allow(dead_code)]
+    /// Meters per texel (LOD metric), from which residency estimates the
+    /// node's screen-space error once no walk wants it.
     pub meters_per_texel: f32,
+    /// The data epoch the meshes were fetched at, so builds from them can be
+    /// cached across visits.
+    pub epoch: u32,
+}
+
+/// A node whose fetch failed, see [`LodState::failed_nodes`].
+struct FailedNode {
+    /// Failures in a row.
+    failures: u32,
+    /// When the backoff after the last failure runs out (elapsed s).
+    retry_at: f64,
+    /// Whether the node is still waiting out that backoff.
+    backed_off: bool,
 }
 
 /// State for LOD management.
 #[derive(Resource, Default)]
 pub struct LodState {
-    /// Paths of nodes that are currently being loaded.
-    loading_nodes: HashSet<OctreePath>,
+    /// Node fetch scheduling: the pending queue and the in-flight fetches,
+    /// whose paths are the nodes currently being loaded.
+    pub(crate) fetches: FetchScheduler,
     /// Paths of nodes that are currently loaded and rendered.
     pub(crate) loaded_nodes: HashSet<OctreePath>,
+    /// Nodes no walk wants any more that stay loaded only because the
+    /// residency budgets have room (see [`retain_within_budget`]). Their
+    /// entities are hidden and left out of their parents' octant masks until
+    /// a walk selects them again, so a stale tile never draws over, or cuts a
+    /// hole in, the terrain the walk chose.
+    pub(crate) budget_retained: HashSet<OctreePath>,
+    /// Fetched and converted nodes waiting for their render entities, in
+    /// arrival order with the instant each arrived. Drained by
+    /// `poll_lod_node_tasks` under [`LodTuning::node_spawn_budget_ms`]; their
+    /// `node_data` is already available to physics.
+    spawn_queue: VecDeque<(PreparedNode, Instant)>,
+    /// Paths in [`Self::spawn_queue`], so the traversal doesn't re-request
+    /// them.
+    queued_spawns: HashSet<OctreePath>,
     /// Paths of bulks that are currently being loaded.
     loading_bulks: HashSet<OctreePath>,
     /// Paths of bulks that failed to load (to avoid retrying).
     failed_bulks: HashSet<OctreePath>,
+    /// Nodes whose last fetch failed, and when the walk may request them
+    /// again (see [`LodTuning::fetch_retry_secs`]).
+    failed_nodes: HashMap<OctreePath, FailedNode>,
     /// Cached bulk metadata by path.
     bulks: HashMap<OctreePath, BulkMetadata>,
     /// Node OBBs from bulk metadata, keyed by node path.
     pub(crate) node_obbs: HashMap<OctreePath, OrientedBoundingBox>,
-    /// Spawned entities per node path, for despawning on unload.
-    node_entities: HashMap<OctreePath, Vec<Entity>>,
+    /// Spawned entities per node path and their texture slots, for
+    /// despawning and releasing on unload.
+    node_entities: HashMap<OctreePath, Vec<(Entity, TileSlot)>>,
+    /// Top mip levels left out of the textures of spawned nodes that left
+    /// any out (see [`promote_textures`]).
+    dropped_texture_levels: HashMap<OctreePath, u32>,
     /// Current view frustum (updated each frame).
     frustum: Option<Frustum>,
     /// Current LOD metrics (updated each frame).
     lod_metrics: Option<LodMetrics>,
     /// Cached node data for physics collider creation.
     pub(crate) node_data: HashMap<OctreePath, LoadedNodeData>,
-    /// Per-bulk node lookup index, keyed by bulk path. Maps a node's
-    /// relative-within-bulk path to its position in `bulks[key].nodes`.
+    /// Per-bulk node lookup index, keyed by bulk path. Finds a node's
+    /// children in `bulks[key].nodes`, which it keeps in level order.
     ///
     /// Built once when each bulk is inserted into [`Self::bulks`], reused
-    /// by every BFS visit instead of rebuilding the same HashMap on every
-    /// frontier expansion. With ~639 bulks × ~150 nodes/bulk and frontier
-    /// sizes in the thousands per frame, this turns tens of thousands of
-    /// per-frame HashMap inserts into amortised zero.
-    bulk_node_indices: HashMap<OctreePath, HashMap<OctreePath, usize>>,
+    /// by every BFS visit instead of rebuilding a lookup on every frontier
+    /// expansion. With ~639 bulks × ~150 nodes/bulk and frontier sizes in
+    /// the thousands per frame, child lookups are the walk's innermost
+    /// operation, so they are a popcount rather than a hash (see
+    /// [`crate::bulk_index`]).
+    bulk_node_indices: HashMap<OctreePath, BulkNodeIndex>,
     /// Physics collider entities keyed by node path, with the octant mask
     /// each entity was built with (so mask changes trigger a rebuild). The
     /// single source of truth for "what collider entities exist", written by
@@ -350,8 +552,11 @@ pub struct LodState {
     pub(crate) physics_target_paths: HashMap<OctreePath, u8>,
     /// Elapsed-seconds timestamp of the last frame each node was in any
     /// BFS's potential set. Drives the unload grace period (see
-    /// [`UNLOAD_GRACE_PERIOD_SECS`]).
+    /// [`LodTuning::unload_grace_period_secs`]); kept past it while the node
+    /// is resident, so residency knows how long it has gone unwanted.
     node_last_seen: HashMap<OctreePath, f64>,
+    /// Bytes held per resident node, for the residency budgets.
+    residency: Residency,
     /// Elapsed-seconds timestamp of the last frame each bulk was in any
     /// BFS's potential set.
     bulk_last_seen: HashMap<OctreePath, f64>,
@@ -363,13 +568,22 @@ pub struct LodState {
     bulks_version: u64,
     /// Monotonic counter incremented on every node load completion
     /// (success or failure). Also drives the BFS skip check: when nodes
-    /// finish loading, the BFS must re-run so any requests previously
-    /// dropped by the concurrency cap get re-queued.
+    /// finish loading, the BFS must re-run so decisions that depend on
+    /// loaded data (the physics fallback chain, the WYSIWYG descent) see
+    /// the new node.
     pub(crate) nodes_completed_version: u64,
     /// Camera forward direction (unit vector) updated each frame by
     /// `update_frustum`. Used as the rotational component of the BFS
     /// skip signature.
     view_direction: Option<Vec3>,
+    /// Full camera rotation, for charging the walk cache's angular slack.
+    view_rotation: Option<DQuat>,
+    /// Perspective field of view, aspect ratio, near and far planes: any
+    /// change reshapes the frustum, so the walk cache starts over.
+    projection: Option<[f32; 4]>,
+    /// Load-state changes since the last traversal, so the next one re-walks
+    /// only the subtrees they touch (see [`crate::walk_cache`]).
+    pub(crate) walk_dirty: WalkDirty,
     /// Uncovered-region count from the last BFS run, for logging coverage
     /// transitions exactly once.
     last_uncovered_regions: usize,
@@ -390,6 +604,85 @@ impl LodState {
         self.loaded_nodes.contains(&path)
     }
 
+    /// Whether a node is loaded and drawn: loaded and not only
+    /// [budget-retained](Self::budget_retained).
+    pub(crate) fn is_node_displayed(&self, path: OctreePath) -> bool {
+        self.loaded_nodes.contains(&path) && !self.budget_retained.contains(&path)
+    }
+
+    /// Paths of the nodes that are [displayed](Self::is_node_displayed).
+    pub(crate) fn displayed_nodes(&self) -> impl Iterator<Item = &OctreePath> {
+        self.loaded_nodes
+            .iter()
+            .filter(|path| !self.budget_retained.contains(*path))
+    }
+
+    /// Whether a node is being fetched or is waiting to be spawned.
+    pub(crate) fn is_node_loading(&self, path: &OctreePath) -> bool {
+        self.fetches.is_in_flight(path) || self.queued_spawns.contains(path)
+    }
+
+    /// Whether a node's fetch failed recently enough that it mustn't be
+    /// requested yet.
+    pub(crate) fn is_node_backed_off(&self, path: &OctreePath) -> bool {
+        self.failed_nodes
+            .get(path)
+            .is_some_and(|failure| failure.backed_off)
+    }
+
+    /// Back a node off after a failed fetch, for longer on each failure in a
+    /// row.
+    fn record_fetch_failure(&mut self, path: OctreePath, now: f64, tuning: &LodTuning) {
+        let failure = self.failed_nodes.entry(path).or_insert(FailedNode {
+            failures: 0,
+            retry_at: now,
+            backed_off: false,
+        });
+        failure.failures += 1;
+        let delay = tuning.fetch_retry_secs * 2f64.powi(failure.failures.min(16) as i32 - 1);
+        failure.retry_at = now + delay.min(tuning.fetch_retry_max_secs);
+        failure.backed_off = true;
+    }
+
+    /// Let nodes whose backoff has run out be requested again, and forget
+    /// failures nothing has retried for a full maximum backoff.
+    fn expire_fetch_backoffs(&mut self, now: f64, tuning: &LodTuning) {
+        let mut expired = false;
+        for (path, failure) in &mut self.failed_nodes {
+            if failure.backed_off && failure.retry_at <= now {
+                failure.backed_off = false;
+                self.walk_dirty.node(*path);
+                expired = true;
+            }
+        }
+        self.failed_nodes.retain(|_, failure| {
+            failure.backed_off || now - failure.retry_at < tuning.fetch_retry_max_secs
+        });
+        if expired {
+            // Make the BFS skip re-walk so the retries go out.
+            self.nodes_completed_version = self.nodes_completed_version.wrapping_add(1);
+        }
+    }
+
+    /// This frame's screen-space error metrics, once the camera is known.
+    pub(crate) fn lod_metrics(&self) -> Option<LodMetrics> {
+        self.lod_metrics
+    }
+
+    /// A cached bulk and its node index.
+    pub(crate) fn bulk_with_index(
+        &self,
+        path: OctreePath,
+    ) -> Option<(&BulkMetadata, &BulkNodeIndex)> {
+        Some((self.bulks.get(&path)?, self.bulk_node_indices.get(&path)?))
+    }
+
+    /// Node fetch scheduler counters, for the diagnostics UI.
+    #[must_use]
+    pub fn fetch_stats(&self) -> FetchStats {
+        self.fetches.stats()
+    }
+
     /// Get the number of active physics colliders.
     #[must_use]
     pub fn physics_collider_count(&self) -> usize {
@@ -466,13 +759,19 @@ impl LodState {
     }
 }
 
+/// A finished node fetch: the converted node and its fetch info, or the error.
+type NodeLoadResult = (
+    OctreePath,
+    Result<(PreparedNode, FetchInfo), rocktree::Error>,
+);
+
 /// Channels for receiving loaded data from background tasks.
 #[derive(Resource)]
 pub struct LodChannels {
     bulk_rx: async_channel::Receiver<(OctreePath, Result<BulkMetadata, rocktree::Error>)>,
     bulk_tx: async_channel::Sender<(OctreePath, Result<BulkMetadata, rocktree::Error>)>,
-    node_rx: async_channel::Receiver<(OctreePath, Result<Node, rocktree::Error>)>,
-    node_tx: async_channel::Sender<(OctreePath, Result<Node, rocktree::Error>)>,
+    node_rx: async_channel::Receiver<NodeLoadResult>,
+    node_tx: async_channel::Sender<NodeLoadResult>,
 }
 
 impl Default for LodChannels {
@@ -576,6 +875,11 @@ pub struct LodScratch {
     /// whether the current frame's BFS can be skipped entirely (camera
     /// hasn't moved, view hasn't rotated, no new bulks loaded, etc.).
     last_bfs_signature: Option<BfsSignature>,
+    /// Memoised walk calls from the last run, so a run that can't be skipped
+    /// outright still only re-walks what changed.
+    walk_cache: WalkCache,
+    /// Time this frame's walk took, zero if it was skipped.
+    walk_time: Duration,
 }
 
 /// Captures the inputs that determine BFS output. If two consecutive
@@ -591,12 +895,11 @@ struct BfsSignature {
     /// Increments on every bulk insert — new data means the BFS may
     /// produce different output even if the camera hasn't moved.
     bulks_version: u64,
-    /// Increments on every node load completion. Without this, requests
-    /// dropped by the per-frame concurrency cap would never be retried
-    /// while the camera was stationary — the BFS would skip, the
-    /// completion would free up a load slot, but no new request would
-    /// be queued. With this in the signature, every completion
-    /// re-runs the BFS to refill the queue from the dropped excess.
+    /// Increments on every node load completion. The physics fallback
+    /// chain requests only its shallowest missing link per run, so without
+    /// this a stationary camera would never request the next link — the
+    /// BFS would skip and the chain would stall half-loaded. With this in
+    /// the signature, every completion re-runs the BFS.
     nodes_completed_version: u64,
     /// Render-BFS retention radius — slider changes invalidate.
     keep_loaded_radius: f64,
@@ -656,7 +959,8 @@ pub(crate) fn effective_distance(obb: &OrientedBoundingBox, camera_pos: DVec3, l
 
 /// Inputs that don't change across recursive calls of [`unified_walk`].
 /// Bundled into a struct so the walker has only one positional parameter
-/// for "context" and one for per-call state.
+/// for "context" and one for per-call state ([`WalkArgs`], which is also
+/// what the walk cache keys its memos on).
 struct UnifiedWalkCtx<'a> {
     lod_state: &'a LodState,
     tuning: &'a LodTuning,
@@ -671,6 +975,47 @@ struct UnifiedWalkCtx<'a> {
     is_low_altitude: bool,
     camera_pos: DVec3,
     lead: DVec3,
+    /// The previous walk, replayed where it still holds.
+    cache: &'a WalkCache,
+    /// Depth of the calls handed to the compute pool (see [`Fanout`]).
+    fanout_depth: usize,
+}
+
+/// Where [`unified_walk`] sends its calls at [`UnifiedWalkCtx::fanout_depth`].
+///
+/// A fanned-out walk runs in three steps: a planning pass walks the top of
+/// the tree and records the calls at the fan-out depth instead of making
+/// them, the compute pool walks those subtrees concurrently into logs of
+/// their own, and a joining pass walks the top of the tree again, splicing
+/// the logs in where the calls were. The top passes take the same path
+/// both times because no decision above a call depends on its result
+/// before the call is made; only the post-recursion commits do, which is
+/// why the planning pass's own outputs are discarded.
+enum Fanout {
+    /// Make them inline: fan-out is off, or this is a fanned-out subtree.
+    Inline,
+    /// Record them for the compute pool instead.
+    Plan(Vec<SubtreeCall>),
+    /// Splice in the compute pool's results, in planning order.
+    Join(std::vec::IntoIter<SubtreeWalk>),
+}
+
+/// A call recorded by the planning pass.
+struct SubtreeCall {
+    path: OctreePath,
+    args: WalkArgs,
+    /// The previous walk's memo for the call.
+    old: Option<Arc<WalkMemo>>,
+}
+
+/// A subtree walked on the compute pool: the call's mask and slack, and
+/// its log.
+type SubtreeWalk = (u8, Slack, WalkLog);
+
+/// The mutable half of a walk: where its outputs go.
+struct WalkOut {
+    log: WalkLog,
+    fanout: Fanout,
 }
 
 /// The pre-branch physics distance bands (m → target depth), used by the
@@ -698,6 +1043,11 @@ const LEGACY_PHYSICS_BANDS: &[(f64, usize)] = &[(50.0, 0), (150.0, 1), (400.0, 2
 /// We descend if either rule wants to. Refining for one consumer
 /// effectively gives the other a free walk through that subtree, which
 /// is exactly the redundancy the unified walker eliminates.
+///
+/// Subtrees whose decisions can't have changed since the last walk (no
+/// load-state change in `dirty`, camera motion within their margins) are
+/// replayed from [`LodScratch::walk_cache`] instead of re-walked; see
+/// [`crate::walk_cache`].
 #[allow(clippy::too_many_arguments)]
 fn unified_bfs_traversal(
     lod_state: &LodState,
@@ -709,13 +1059,41 @@ fn unified_bfs_traversal(
     lod_metrics: LodMetrics,
     camera_pos: DVec3,
     lead: DVec3,
+    rotation: DQuat,
+    projection: [f32; 4],
+    dirty: WalkDirty,
 ) {
-    scratch.render_result.clear();
-    scratch.physics_result.clear();
+    let LodScratch {
+        render_result,
+        physics_result,
+        walk_cache,
+        ..
+    } = scratch;
+    render_result.clear();
+    physics_result.clear();
 
     let camera_altitude = lod_metrics.camera_position.length() - EARTH_RADIUS_M_F64;
     let is_low_altitude = camera_altitude <= tuning.proximity_loading_max_altitude;
 
+    let log = walk_cache.start(
+        WalkPose {
+            camera: camera_pos,
+            rotation,
+            lead,
+        },
+        WalkGlobals {
+            keep_loaded_radius: tuning.keep_loaded_radius,
+            is_low_altitude,
+            pixels_per_meter: lod_metrics.pixels_per_meter,
+            error_threshold: lod_metrics.error_threshold,
+            physics_bands: physics_bands.to_vec(),
+            wysiwyg_radius,
+            projection,
+        },
+        dirty,
+        tuning.bfs_incremental,
+    );
+
     let ctx = UnifiedWalkCtx {
         lod_state,
         tuning,
@@ -726,19 +1104,86 @@ fn unified_bfs_traversal(
         is_low_altitude,
         camera_pos,
         lead,
+        cache: walk_cache,
+        fanout_depth: tuning.bfs_fanout_depth,
     };
 
     // The root bulk is always cached at OctreePath::ROOT by `update_lod_requests`.
-    unified_walk(
-        &ctx,
-        OctreePath::ROOT,
-        OctreePath::ROOT,
-        None,
-        false, // physics_committed_above
-        false, // physics_chain_requested
-        &mut scratch.render_result,
-        &mut scratch.physics_result,
-    );
+    let walk_root = |out: &mut WalkOut| {
+        unified_walk(
+            &ctx,
+            out,
+            ctx.cache.root_memo(),
+            OctreePath::ROOT,
+            WalkArgs {
+                bulk_key: OctreePath::ROOT,
+                physics_best_ancestor: None,
+                physics_committed_above: false,
+                physics_chain_requested: false,
+            },
+        );
+    };
+    let mut out = WalkOut {
+        log,
+        fanout: if tuning.bfs_fanout_depth > 0 {
+            Fanout::Plan(Vec::new())
+        } else {
+            Fanout::Inline
+        },
+    };
+    walk_root(&mut out);
+
+    // With no calls planned the planning pass was the whole walk.
+    if let Fanout::Plan(calls) = std::mem::replace(&mut out.fanout, Fanout::Inline)
+        && !calls.is_empty()
+    {
+        let subtrees = ComputeTaskPool::get().scope(|scope| {
+            for call in &calls {
+                let ctx = &ctx;
+                scope.spawn(async move {
+                    let mut sub = WalkOut {
+                        log: ctx.cache.log(),
+                        fanout: Fanout::Inline,
+                    };
+                    let (mask, slack) =
+                        unified_walk(ctx, &mut sub, call.old.as_ref(), call.path, call.args);
+                    (mask, slack, sub.log)
+                });
+            }
+        });
+        out.log.clear();
+        out.fanout = Fanout::Join(subtrees.into_iter());
+        walk_root(&mut out);
+    }
+
+    // Fold the walk's outputs, replayed and fresh alike, into the results.
+    for event in walk_cache.end(out.log) {
+        match event {
+            WalkEvent::RenderVisible(path, obb) => {
+                render_result.discovered_obbs.push((*path, *obb));
+            }
+            WalkEvent::RenderRefine(path) => {
+                render_result.potential_nodes.insert(*path);
+            }
+            WalkEvent::RenderLoad(node) => render_result.nodes_to_load.push(node.clone()),
+            WalkEvent::PhysicsNode(path, obb) => {
+                physics_result.discovered_obbs.push((*path, *obb));
+                physics_result.potential_nodes.insert(*path);
+            }
+            WalkEvent::PhysicsLoad(node) => physics_result.nodes_to_load.push(node.clone()),
+            WalkEvent::Bulk(path) => {
+                render_result.potential_bulks.insert(*path);
+                physics_result.potential_bulks.insert(*path);
+            }
+            WalkEvent::BulkLoad(path, epoch) => render_result.bulks_to_load.push((*path, *epoch)),
+            WalkEvent::Commit(path, mask) => {
+                merge_commit(&mut physics_result.collider_paths, *path, *mask);
+            }
+            WalkEvent::Uncovered(path) => {
+                physics_result.uncovered_regions.insert(*path);
+            }
+        }
+    }
 }
 
 /// Recursive worker for [`unified_bfs_traversal`].
@@ -758,17 +1203,65 @@ fn unified_bfs_traversal(
 /// overlapping commits when render wants to descend past the physics
 /// target depth: once a node has committed in full, all its descendants
 /// are already covered and must not commit again.
-#[allow(clippy::too_many_arguments)]
+///
+/// `old` is the previous walk's memo for this call, replayed instead of
+/// re-evaluated when it still holds. Outputs go to `out` as
+/// [`WalkEvent`]s; the returned [`Slack`] bounds the camera motion the
+/// subtree's decisions tolerate.
 fn unified_walk(
     ctx: &UnifiedWalkCtx<'_>,
+    out: &mut WalkOut,
+    old: Option<&Arc<WalkMemo>>,
+    path: OctreePath,
+    args: WalkArgs,
+) -> (u8, Slack) {
+    if path.depth() == ctx.fanout_depth {
+        match &mut out.fanout {
+            Fanout::Inline => {}
+            Fanout::Plan(calls) => {
+                calls.push(SubtreeCall {
+                    path,
+                    args,
+                    old: old.cloned(),
+                });
+                return (0, Slack::UNBOUNDED);
+            }
+            Fanout::Join(subtrees) => {
+                let (mask, slack, log) = subtrees
+                    .next()
+                    .expect("the joining pass makes the planned calls");
+                out.log.append(log);
+                return (mask, slack);
+            }
+        }
+    }
+    if let Some(replayed) = ctx.cache.try_replay(&mut out.log, old, path, args) {
+        return replayed;
+    }
+    let slot = out.log.begin(path, args);
+    let mut slack = Slack::UNBOUNDED;
+    let mask = evaluate_walk(ctx, out, old, path, args, &mut slack);
+    out.log.finish(slot, mask, slack);
+    (mask, slack)
+}
+
+/// Evaluate one [`unified_walk`] call, bounding `slack` by the margin of
+/// every camera-dependent decision it makes.
+fn evaluate_walk(
+    ctx: &UnifiedWalkCtx<'_>,
+    out: &mut WalkOut,
+    old: Option<&Arc<WalkMemo>>,
     path: OctreePath,
-    bulk_key: OctreePath,
-    physics_best_ancestor: Option<OctreePath>,
-    physics_committed_above: bool,
-    physics_chain_requested: bool,
-    render_result: &mut BfsResult,
-    physics_result: &mut PhysicsBfsResult,
+    args: WalkArgs,
+    slack: &mut Slack,
 ) -> u8 {
+    let WalkArgs {
+        bulk_key,
+        physics_best_ancestor,
+        physics_committed_above,
+        physics_chain_requested,
+    } = args;
+
     // Bulk boundary handling: every 4 octants we cross into a new bulk.
     // If we're at a boundary, switch the lookup key to `path` and
     // ensure that bulk is loaded.
@@ -782,8 +1275,7 @@ fn unified_walk(
         };
 
         // Either BFS walking through this bulk wants it retained.
-        render_result.potential_bulks.insert(path);
-        physics_result.potential_bulks.insert(path);
+        out.log.push(WalkEvent::Bulk(path));
 
         if !ctx.lod_state.bulks.contains_key(&path) {
             if !ctx.lod_state.loading_bulks.contains(&path)
@@ -792,7 +1284,7 @@ fn unified_walk(
                 // One side issues the load; the call-site dedupes both
                 // sides' load lists via a HashSet, so requesting from
                 // just `render_result` is enough to avoid double-fetch.
-                render_result.bulks_to_load.push((path, child_epoch));
+                out.log.push(WalkEvent::BulkLoad(path, child_epoch));
             }
             return 0;
         }
@@ -807,27 +1299,33 @@ fn unified_walk(
     let Some(node_index) = ctx.lod_state.bulk_node_indices.get(&effective_bulk_key) else {
         return 0;
     };
-    render_result.potential_bulks.insert(effective_bulk_key);
-    physics_result.potential_bulks.insert(effective_bulk_key);
+    let Some(rel) = path.strip_prefix(effective_bulk_key) else {
+        panic!(
+            "BFS invariant violation: effective_bulk_key '{effective_bulk_key}' \
+             (depth {}) is not a prefix of path '{path}' (depth {}). \
+             bulk_key='{bulk_key}' (depth {})",
+            effective_bulk_key.depth(),
+            path.depth(),
+            bulk_key.depth(),
+        );
+    };
+    // The parent listed this node, so it is in the bulk (or is its root).
+    let Some(slot) = node_index.slot(rel) else {
+        return 0;
+    };
+    // Below the root, the crossing into this bulk already retained it.
+    if path.is_root() {
+        out.log.push(WalkEvent::Bulk(effective_bulk_key));
+    }
 
     let mut handled_mask: u8 = 0;
+    let mut memo_cursor = None;
 
     for octant in 0u8..=7 {
         let octant_bit = 1u8 << octant;
         let child_path = path.push(octant);
 
-        let Some(child_rel) = child_path.strip_prefix(effective_bulk_key) else {
-            panic!(
-                "BFS invariant violation: effective_bulk_key '{effective_bulk_key}' \
-                 (depth {}) is not a prefix of child_path '{child_path}' (depth {}). \
-                 path='{path}' (depth {}), bulk_key='{bulk_key}' (depth {}), octant={octant}",
-                effective_bulk_key.depth(),
-                child_path.depth(),
-                path.depth(),
-                bulk_key.depth(),
-            );
-        };
-        let Some(&child_idx) = node_index.get(&child_rel) else {
+        let Some(child_idx) = node_index.child(slot, octant).and_then(NodeSlot::node) else {
             // Empty octant — no finer data exists, but this node's own mesh
             // may still carry geometry here (coastlines, data-sparse areas),
             // so the octant stays unhandled: whichever ancestor commits must
@@ -846,6 +1344,21 @@ fn unified_walk(
                 .lod_metrics
                 .should_refine(child_node.obb.center, child_node.meters_per_texel);
 
+        // How far the camera can move before these decisions flip, for the
+        // walk cache. Rotation moves the box against the frustum by at most
+        // its farthest corner's distance times the angle.
+        slack.bound_view(
+            ctx.frustum.obb_margin(&child_node.obb),
+            centre_dist + child_node.obb.extents.length(),
+        );
+        if ctx.is_low_altitude && !in_frustum {
+            slack.bound_distance((centre_dist - ctx.tuning.keep_loaded_radius).abs());
+        }
+        if render_visible {
+            let refine_distance = ctx.lod_metrics.refine_distance(child_node.meters_per_texel);
+            slack.bound_distance((centre_dist - refine_distance).abs());
+        }
+
         // -------- physics-side decision --------
         let phys_dist = effective_distance(&child_node.obb, ctx.camera_pos, ctx.lead);
         // Within the WYSIWYG radius the near field belongs to the mirror
@@ -860,6 +1373,21 @@ fn unified_walk(
         } else {
             desired_physics_depth(ctx.physics_bands, phys_dist)
         };
+        // Band edges, measured in effective distance: moving the camera by
+        // `d` shifts it by up to `d` plus the turn of the lead compression,
+        // `2·|lead|·d / centre_dist`.
+        let band_margin = ctx
+            .physics_bands
+            .iter()
+            .map(|&(max_d, _)| max_d)
+            .chain(
+                COLLIDER
+                    .uses_streaming_selection()
+                    .then_some(ctx.wysiwyg_radius),
+            )
+            .map(|edge| (phys_dist - edge).abs())
+            .fold(f64::INFINITY, f64::min);
+        slack.bound_distance(band_margin / (1.0 + 2.0 * ctx.lead.length() / centre_dist.max(1.0)));
         let physics_in_range = phys_target.is_some();
         let physics_at_or_past_target =
             physics_in_range && phys_target.is_some_and(|t| child_path.depth() >= t);
@@ -875,9 +1403,8 @@ fn unified_walk(
 
         // Render: OBB cache for visible nodes.
         if render_visible {
-            render_result
-                .discovered_obbs
-                .push((child_node.path, child_node.obb));
+            out.log
+                .push(WalkEvent::RenderVisible(child_node.path, child_node.obb));
         }
         // Physics: OBB cache + potential set + fallback-chain data requests.
         //
@@ -891,24 +1418,24 @@ fn unified_walk(
         // the collider — loads in parallel from the start.
         let child_missing = child_node.has_data
             && !ctx.lod_state.loaded_nodes.contains(&child_node.path)
-            && !ctx.lod_state.loading_nodes.contains(&child_node.path);
+            && !ctx.lod_state.is_node_loading(&child_node.path)
+            && !ctx.lod_state.is_node_backed_off(&child_node.path);
         if physics_in_range {
-            physics_result
-                .discovered_obbs
-                .push((child_node.path, child_node.obb));
-            physics_result.potential_nodes.insert(child_node.path);
+            out.log
+                .push(WalkEvent::PhysicsNode(child_node.path, child_node.obb));
             if child_missing && (physics_at_or_past_target || !physics_chain_requested) {
-                physics_result.nodes_to_load.push(child_node.clone());
+                out.log.push(WalkEvent::PhysicsLoad(child_node.clone()));
             }
         }
 
         // Render: when we descend, mark this node as a refinement parent.
         if render_should_refine && child_node.has_data {
-            render_result.potential_nodes.insert(child_node.path);
+            out.log.push(WalkEvent::RenderRefine(child_node.path));
             if !ctx.lod_state.loaded_nodes.contains(&child_node.path)
-                && !ctx.lod_state.loading_nodes.contains(&child_node.path)
+                && !ctx.lod_state.is_node_loading(&child_node.path)
+                && !ctx.lod_state.is_node_backed_off(&child_node.path)
             {
-                render_result.nodes_to_load.push(child_node.clone());
+                out.log.push(WalkEvent::RenderLoad(child_node.clone()));
             }
         }
 
@@ -952,7 +1479,7 @@ fn unified_walk(
                 child_phys_loaded,
                 0,
                 updated_phys_best,
-                physics_result,
+                &mut out.log,
             ) {
                 handled_mask |= octant_bit;
             }
@@ -966,16 +1493,20 @@ fn unified_walk(
         let physics_wants_deeper = physics_in_range && !octant_handled;
         let need_recurse = render_should_refine || physics_wants_deeper;
         if need_recurse {
-            let child_mask = unified_walk(
+            let child_old = old.and_then(|memo| memo.child(&mut memo_cursor, child_path));
+            let (child_mask, child_slack) = unified_walk(
                 ctx,
+                out,
+                child_old,
                 child_path,
-                effective_bulk_key,
-                updated_phys_best,
-                octant_handled,
-                physics_chain_requested || child_missing,
-                render_result,
-                physics_result,
+                WalkArgs {
+                    bulk_key: effective_bulk_key,
+                    physics_best_ancestor: updated_phys_best,
+                    physics_committed_above: octant_handled,
+                    physics_chain_requested: physics_chain_requested || child_missing,
+                },
             );
+            slack.merge(child_slack);
 
             if physics_wants_deeper {
                 if child_mask == 0xff {
@@ -986,7 +1517,7 @@ fn unified_walk(
                     child_phys_loaded,
                     child_mask,
                     updated_phys_best,
-                    physics_result,
+                    &mut out.log,
                 ) {
                     // Commit this node minus the octants covered below: a
                     // full collider when nothing below committed, a partial
@@ -1011,7 +1542,7 @@ fn any_children_displayed(lod_state: &LodState, path: OctreePath) -> bool {
     }
     (0u8..=7).any(|octant| {
         let child = path.push(octant);
-        lod_state.loaded_nodes.contains(&child) && lod_state.node_data.contains_key(&child)
+        lod_state.is_node_displayed(child) && lod_state.node_data.contains_key(&child)
     })
 }
 
@@ -1025,13 +1556,13 @@ fn commit_physics_collider(
     node_loaded: bool,
     octant_mask: u8,
     best_ancestor: Option<OctreePath>,
-    result: &mut PhysicsBfsResult,
+    log: &mut WalkLog,
 ) -> bool {
     if node_loaded {
-        merge_commit(&mut result.collider_paths, node_path, octant_mask);
+        log.push(WalkEvent::Commit(node_path, octant_mask));
         true
     } else if let Some(anc) = best_ancestor {
-        merge_commit(&mut result.collider_paths, anc, 0);
+        log.push(WalkEvent::Commit(anc, 0));
         true
     } else {
         // No ancestor has data loaded either: this region has no terrain
@@ -1040,7 +1571,7 @@ fn commit_physics_collider(
         // node, and physics requests have a reserved share of the load
         // slots, so the window is short — but it must be visible, not
         // silent.
-        result.uncovered_regions.insert(node_path);
+        log.push(WalkEvent::Uncovered(node_path));
         false
     }
 }
@@ -1057,6 +1588,184 @@ fn merge_commit(commits: &mut HashMap<OctreePath, u8>, path: OctreePath, mask: u
         .or_insert(mask);
 }
 
+/// On-screen size (px) of a node's texels from the camera now: the
+/// screen-space error it would cover. Nodes whose bulk was dropped have no
+/// OBB any more, and measure from their mesh `origin` instead.
+fn texel_screen_px(
+    obb: Option<&OrientedBoundingBox>,
+    origin: DVec3,
+    meters_per_texel: f32,
+    lod_metrics: &LodMetrics,
+) -> f64 {
+    let camera = lod_metrics.camera_position;
+    let distance = obb.map_or_else(
+        || origin.distance(camera),
+        |obb| effective_distance(obb, camera, DVec3::ZERO),
+    );
+    f64::from(meters_per_texel) * lod_metrics.pixels_per_meter / distance.max(1.0)
+}
+
+/// Top mip levels a tile whose texels are `texel_px` on screen can leave
+/// out of its textures (see [`LodTuning::texture_drop_texel_px`]).
+fn droppable_texture_levels(tuning: &LodTuning, texel_px: f64) -> u32 {
+    let limit = tuning.texture_drop_texel_px;
+    if limit <= 0.0 || texel_px <= 0.0 || texel_px >= limit {
+        return 0;
+    }
+    // Each level dropped doubles the texel size.
+    ((limit / texel_px).log2().floor() as u32).min(tuning.texture_max_dropped_levels)
+}
+
+/// Despawn the nodes whose textures left out mip levels the camera has since
+/// come close enough to need, once the largest kept level's texels are past
+/// twice [`LodTuning::texture_drop_texel_px`] on screen. Their decoded data
+/// stays; the next walk fetches them again, from the client's cache as a
+/// rule, and they spawn with the levels they now need. Their parents cover
+/// them meanwhile.
+fn promote_textures(
+    lod_state: &mut LodState,
+    commands: &mut Commands,
+    tile_textures: &mut TileTexturePool,
+    tuning: &LodTuning,
+    lod_metrics: &LodMetrics,
+) {
+    let limit = 2.0 * tuning.texture_drop_texel_px;
+    let promoted: Vec<OctreePath> = lod_state
+        .dropped_texture_levels
+        .iter()
+        .filter(|(path, dropped)| {
+            lod_state.node_data.get(*path).is_some_and(|data| {
+                let texel_px = texel_screen_px(
+                    lod_state.node_obbs.get(*path),
+                    data.world_position,
+                    data.meters_per_texel,
+                    lod_metrics,
+                );
+                texel_px * f64::from(1u32 << (**dropped).min(31)) > limit
+            })
+        })
+        .map(|(path, _)| *path)
+        .collect();
+    if promoted.is_empty() {
+        return;
+    }
+    tracing::debug!(
+        "LOD: respawning {} node(s) for finer textures",
+        promoted.len()
+    );
+    for path in promoted {
+        despawn_render(lod_state, commands, tile_textures, path);
+    }
+    // The walk must run again to request them.
+    lod_state.nodes_completed_version = lod_state.nodes_completed_version.wrapping_add(1);
+}
+
+/// Extend `retained`, the nodes that must stay, with the other resident
+/// nodes the residency budgets have room for (see [`crate::residency`]).
+///
+/// The must-keep set is first closed over ancestors, so no kept node loses
+/// the parent covering the rest of its area. Every other resident node is an
+/// eviction candidate, worth the screen-space error it would cover from the
+/// camera now, discounted by how long it has gone unwanted.
+fn retain_within_budget(
+    lod_state: &mut LodState,
+    retained: &mut HashSet<OctreePath>,
+    collider_bytes: u64,
+    idle_texture_bytes: u64,
+    tuning: &LodTuning,
+    lod_metrics: &LodMetrics,
+    now: f64,
+) {
+    let kept: Vec<OctreePath> = retained.iter().copied().collect();
+    for mut path in kept {
+        while let Some(parent) = path.parent() {
+            if !retained.insert(parent) {
+                break;
+            }
+            path = parent;
+        }
+    }
+
+    let used = lod_state.residency.total()
+        + Footprint {
+            cpu: collider_bytes,
+            gpu: idle_texture_bytes,
+        };
+    let budget = tuning.residency_budget();
+    let candidates: Vec<Candidate> = if used.exceeds(budget) {
+        lod_state
+            .node_data
+            .iter()
+            .filter(|(path, _)| !retained.contains(*path))
+            .map(|(path, data)| {
+                let sse_px = texel_screen_px(
+                    lod_state.node_obbs.get(path),
+                    data.world_position,
+                    data.meters_per_texel,
+                    lod_metrics,
+                );
+                let age = lod_state
+                    .node_last_seen
+                    .get(path)
+                    .map_or(f64::INFINITY, |seen| now - seen);
+                Candidate {
+                    path: *path,
+                    bytes: lod_state.residency.node(path),
+                    value: keep_value(sse_px, age, tuning.residency_recency_secs),
+                }
+            })
+            .collect()
+    } else {
+        Vec::new()
+    };
+    let evicted: HashSet<OctreePath> = plan_evictions(&candidates, used, budget)
+        .into_iter()
+        .collect();
+
+    let budget_retained: HashSet<OctreePath> = lod_state
+        .node_data
+        .keys()
+        .filter(|path| !retained.contains(*path) && !evicted.contains(*path))
+        .copied()
+        .collect();
+    // Entering or leaving the set shows or hides a tile, which the walk's
+    // WYSIWYG descent reads.
+    for path in lod_state
+        .budget_retained
+        .symmetric_difference(&budget_retained)
+    {
+        lod_state.walk_dirty.node(*path);
+    }
+    lod_state.budget_retained = budget_retained;
+    retained.extend(lod_state.budget_retained.iter().copied());
+    let stats = &mut lod_state.residency.stats;
+    stats.used = used;
+    stats.budget = budget;
+    stats.optional = lod_state.budget_retained.len();
+    stats.evicted_total += evicted.len() as u64;
+}
+
+/// Despawn a node's render entities and release their texture layers,
+/// leaving its decoded data to physics.
+fn despawn_render(
+    lod_state: &mut LodState,
+    commands: &mut Commands,
+    tile_textures: &mut TileTexturePool,
+    path: OctreePath,
+) {
+    lod_state.loaded_nodes.remove(&path);
+    lod_state.budget_retained.remove(&path);
+    lod_state.walk_dirty.node(path);
+    lod_state.residency.remove_render(path);
+    lod_state.dropped_texture_levels.remove(&path);
+    if let Some(entities) = lod_state.node_entities.remove(&path) {
+        for (entity, slot) in entities {
+            commands.entity(entity).despawn();
+            tile_textures.release(slot);
+        }
+    }
+}
+
 /// Despawn entities for nodes no longer in the retention set, and remove
 /// obsolete bulks.
 ///
@@ -1064,6 +1773,8 @@ fn merge_commit(commits: &mut HashMap<OctreePath, u8>, path: OctreePath, mask: u
 /// - paths the render BFS visited this frame
 /// - paths the physics BFS visited this frame
 /// - paths visited within the last [`LodTuning::unload_grace_period_secs`]
+/// - resident paths the residency budgets have room for (see
+///   [`retain_within_budget`])
 ///
 /// `physics_collider_paths` is passed separately so we can also keep
 /// `node_data` alive for paths the physics system is currently using as a
@@ -1072,6 +1783,7 @@ fn merge_commit(commits: &mut HashMap<OctreePath, u8>, path: OctreePath, mask: u
 fn unload_obsolete(
     lod_state: &mut LodState,
     commands: &mut Commands,
+    tile_textures: &mut TileTexturePool,
     retained_nodes: &HashSet<OctreePath>,
     retained_bulks: &HashSet<OctreePath>,
     physics_collider_paths: &HashMap<OctreePath, u8>,
@@ -1083,15 +1795,27 @@ fn unload_obsolete(
         .filter(|p| !retained_nodes.contains(*p))
         .copied()
         .collect();
-    for path in &obsolete_render_nodes {
-        lod_state.loaded_nodes.remove(path);
-        if let Some(entities) = lod_state.node_entities.remove(path) {
-            for entity in entities {
-                commands.entity(entity).despawn();
-            }
-        }
+    for path in obsolete_render_nodes {
+        despawn_render(lod_state, commands, tile_textures, path);
     }
 
+    // Queued nodes that fell out of retention are never spawned; their
+    // `node_data` goes with the rest of the unretained data below.
+    let LodState {
+        spawn_queue,
+        queued_spawns,
+        walk_dirty,
+        ..
+    } = &mut *lod_state;
+    spawn_queue.retain(|(node, _)| {
+        let keep = retained_nodes.contains(&node.path);
+        if !keep {
+            queued_spawns.remove(&node.path);
+            walk_dirty.node(node.path);
+        }
+        keep
+    });
+
     // Drop node_data for paths not retained AND not currently backing a
     // physics collider.
     let stale_node_data: Vec<OctreePath> = lod_state
@@ -1110,6 +1834,8 @@ fn unload_obsolete(
         .collect();
     for path in stale_node_data {
         lod_state.node_data.remove(&path);
+        lod_state.residency.remove_data(path);
+        lod_state.walk_dirty.node(path);
         // If a physics collider was using this node_data, remove the
         // collider entity too — it would point at no-longer-existent
         // mesh data otherwise.
@@ -1130,6 +1856,7 @@ fn unload_obsolete(
         lod_state.bulk_node_indices.remove(&path);
         lod_state.node_obbs.retain(|k, _| !k.starts_with(path));
         lod_state.failed_bulks.remove(&path);
+        lod_state.walk_dirty.bulk(path);
     }
 }
 
@@ -1182,6 +1909,13 @@ fn update_frustum(
     // -Z by convention. Used to detect "no rotation since last frame"
     // for the BFS skip optimisation.
     lod_state.view_direction = Some(rotation * Vec3::NEG_Z);
+    lod_state.view_rotation = Some(rotation_d);
+    lod_state.projection = Some([
+        perspective.fov,
+        perspective.aspect_ratio,
+        perspective.near,
+        perspective.far,
+    ]);
 
     // Update LOD metrics using high-precision camera position.
     let screen_height = windows
@@ -1214,6 +1948,8 @@ fn update_lod_requests(
     freeze: Res<FreezeLod>,
     mut snapshot_request: ResMut<LodSnapshotRequest>,
     mut snapshot: ResMut<LodSnapshot>,
+    mut tile_textures: ResMut<TileTexturePool>,
+    collider_bytes: Res<ColliderBytes>,
     spawner: TaskSpawner,
 ) {
     if loader_state.planetoid.is_none() {
@@ -1233,16 +1969,29 @@ fn update_lod_requests(
     if let std::collections::hash_map::Entry::Vacant(entry) =
         lod_state.bulks.entry(OctreePath::ROOT)
     {
-        let index = build_bulk_node_index(OctreePath::ROOT, root_bulk);
-        entry.insert(root_bulk.clone());
+        let mut bulk = root_bulk.clone();
+        let index = BulkNodeIndex::build(OctreePath::ROOT, &mut bulk);
+        entry.insert(bulk);
         lod_state.bulk_node_indices.insert(OctreePath::ROOT, index);
         lod_state.bulks_version = lod_state.bulks_version.wrapping_add(1);
+        lod_state.walk_dirty.bulk(OctreePath::ROOT);
+    }
+
+    if !freeze.0 {
+        promote_textures(
+            &mut lod_state,
+            &mut commands,
+            &mut tile_textures,
+            &tuning,
+            &lod_metrics,
+        );
     }
 
     // Compute the BFS skip signature for this frame and compare against
     // the last successful run. If everything that affects BFS output is
     // unchanged within tolerance, the cached scratch results from the
     // previous frame are still correct.
+    lod_state.expire_fetch_backoffs(time.elapsed_secs_f64(), &tuning);
     let current_signature = BfsSignature {
         camera_pos: lod_metrics.camera_position,
         view_dir: lod_state.view_direction.unwrap_or(Vec3::NEG_Z),
@@ -1270,11 +2019,14 @@ fn update_lod_requests(
             (LEGACY_PHYSICS_BANDS, 0.0)
         };
 
+    scratch.walk_time = Duration::ZERO;
     if !can_skip_bfs {
+        let walk_started = Instant::now();
         // Single walk that evaluates render's screen-space-error
         // refinement and physics's distance-banded refinement per node,
         // descending if either wants to. Halves the per-frame traversal
         // cost compared to the previous independent BFSes.
+        let dirty = std::mem::take(&mut lod_state.walk_dirty);
         unified_bfs_traversal(
             &lod_state,
             &mut scratch,
@@ -1285,9 +2037,13 @@ fn update_lod_requests(
             lod_metrics,
             lod_metrics.camera_position,
             motion.lead(),
+            lod_state.view_rotation.unwrap_or(DQuat::IDENTITY),
+            lod_state.projection.unwrap_or_default(),
+            dirty,
         );
 
         scratch.last_bfs_signature = Some(current_signature);
+        scratch.walk_time = walk_started.elapsed();
     }
 
     // Near-field collider targets mirror the loaded render set (WYSIWYG) on
@@ -1349,9 +2105,15 @@ fn update_lod_requests(
             lod_state.bulk_last_seen.insert(*path, now);
         }
 
-        // Drop expired entries from the last-seen maps.
+        // Drop expired entries from the last-seen maps, except those of
+        // resident nodes, which residency ages from when they were last seen.
         let cutoff = now - tuning.unload_grace_period_secs;
-        lod_state.node_last_seen.retain(|_, t| *t >= cutoff);
+        let LodState {
+            node_last_seen,
+            node_data,
+            ..
+        } = &mut *lod_state;
+        node_last_seen.retain(|path, t| *t >= cutoff || node_data.contains_key(path));
         lod_state.bulk_last_seen.retain(|_, t| *t >= cutoff);
 
         // Populate the diagnostics snapshot while we still hold the
@@ -1363,10 +2125,13 @@ fn update_lod_requests(
                 bfs,
                 physics_bfs,
                 &collider_targets,
+                scratch.walk_cache.stats(),
                 &motion,
                 lod_metrics.camera_position,
                 &mut snapshot,
             );
+            snapshot.counters.walk_time = scratch.walk_time;
+            snapshot.counters.texture_bytes = tile_textures.allocated_bytes();
         }
 
         // Coverage-loss transitions are logged (not just counted) because a
@@ -1389,8 +2154,13 @@ fn update_lod_requests(
 
     // Derive the retention sets: anything still inside the grace window.
     // Physics collider paths are also retained as defense in depth.
-    let mut retained_nodes: HashSet<OctreePath> =
-        lod_state.node_last_seen.keys().copied().collect();
+    let cutoff = time.elapsed_secs_f64() - tuning.unload_grace_period_secs;
+    let mut retained_nodes: HashSet<OctreePath> = lod_state
+        .node_last_seen
+        .iter()
+        .filter(|(_, t)| **t >= cutoff)
+        .map(|(path, _)| *path)
+        .collect();
     retained_nodes.extend(collider_targets.keys().copied());
     let retained_bulks: HashSet<OctreePath> = lod_state.bulk_last_seen.keys().copied().collect();
 
@@ -1398,77 +2168,96 @@ fn update_lod_requests(
     // refreshing last-seen timestamps, so without this the grace window would
     // expire and evict the whole set, defeating the freeze.
     if !freeze.0 {
+        retain_within_budget(
+            &mut lod_state,
+            &mut retained_nodes,
+            collider_bytes.0,
+            tile_textures.idle_bytes(),
+            &tuning,
+            &lod_metrics,
+            time.elapsed_secs_f64(),
+        );
+        snapshot.counters.residency = lod_state.residency.stats;
         unload_obsolete(
             &mut lod_state,
             &mut commands,
+            &mut tile_textures,
             &retained_nodes,
             &retained_bulks,
             &collider_targets,
         );
     }
 
-    // Limit concurrent loads. Bumped from the original 20 to absorb a
-    // BFS frame's worth of fine-LoD requests in one pass — at 20 we
-    // routinely dropped 40+ excess requests per frame, and only
-    // recovered them through the `nodes_completed_version` BFS re-run
-    // path which trickles in slowly.
-    let max_node_loads: usize = 64;
-    let max_bulk_loads = 16;
-
-    // Split this frame's free load slots between the two queues, with each
-    // side's unused share rolling over to the other. Physics requests are
-    // the collision safety net and must never be starved by a flood of
-    // fine render meshes; equally, a strict physics-first ordering starved
-    // render loads during movement (visible as slow tile pop-in). Drain
-    // the scratch vectors so capacity is reused next frame; HashSet insert
-    // in the filter dedupes any duplicate path either BFS produced.
-    // Disjoint mutable borrows of the two BFS result fields via
-    // destructuring so chained drains compile.
+    // Hand this traversal's requests to the fetch scheduler. Only a fresh
+    // traversal replaces the queue: on skipped frames the drained request
+    // lists are empty and the scheduler keeps working through the previous
+    // run's queue. Drain the scratch vectors so capacity is reused.
     let LodScratch {
         render_result,
         physics_result,
         ..
     } = &mut *scratch;
-    let mut seen_paths: HashSet<OctreePath> = HashSet::new();
-    let physics_nodes: Vec<NodeMetadata> = physics_result
-        .nodes_to_load
-        .drain(..)
-        .filter(|n| seen_paths.insert(n.path))
-        .collect();
-    let render_nodes: Vec<NodeMetadata> = render_result
-        .nodes_to_load
-        .drain(..)
-        .filter(|n| seen_paths.insert(n.path))
-        .collect();
+    let now = time.elapsed_secs_f64();
+    if !can_skip_bfs {
+        lod_state.fetches.replace_pending(
+            physics_result.nodes_to_load.drain(..),
+            render_result.nodes_to_load.drain(..),
+            now,
+        );
+    }
 
-    let available = max_node_loads.saturating_sub(lod_state.loading_nodes.len());
-    let physics_take = physics_nodes.len().min(available.div_ceil(2));
-    let render_take = render_nodes.len().min(available - physics_take);
-    // Roll any unused render share back to physics.
-    let physics_take = physics_nodes.len().min(available - render_take);
+    // Cancel in-flight fetches neither consumer wants any more, so stale
+    // tiles left behind by fast flight or a teleport give their slots back
+    // to the tiles now under the camera.
+    let cancelled = lod_state.fetches.cancel_unwanted(now, &tuning, |path| {
+        render_result.potential_nodes.contains(path)
+            || physics_result.potential_nodes.contains(path)
+            || collider_targets.contains_key(path)
+    });
+    if !cancelled.is_empty() {
+        tracing::debug!("LOD: cancelled {} stale node fetch(es)", cancelled.len());
+    }
+    for path in cancelled {
+        lod_state.walk_dirty.node(path);
+    }
 
-    for node_meta in physics_nodes
-        .into_iter()
-        .take(physics_take)
-        .chain(render_nodes.into_iter().take(render_take))
+    // Fill the free slots from the re-prioritised queue.
+    lod_state.fetches.tick(now, &tuning);
+    for (node_meta, source) in lod_state
+        .fetches
+        .take_ready(&tuning, &lod_metrics, motion.lead())
     {
         let path = node_meta.path;
-        lod_state.loading_nodes.insert(path);
-
         let client = Arc::clone(&loader_state.client);
+        // A missing collider is a hole in the world, so physics fetches
+        // retry hardest.
+        let priority = match source {
+            FetchSource::Physics => FetchPriority::High,
+            FetchSource::Render => FetchPriority::Normal,
+        };
         let request = NodeRequest::new(
             path,
             node_meta.epoch,
             node_meta.texture_format,
             node_meta.imagery_epoch,
-        );
+        )
+        .with_block_compressed_textures(loader_state.block_compressed_textures)
+        .with_priority(priority);
 
         let tx = channels.node_tx.clone();
-
-        spawner.spawn(async move {
-            let result = client.fetch_node(&request).await;
+        let epoch = node_meta.epoch;
+
+        let task = spawner.spawn_cancellable(async move {
+            // Convert on the task too: a burst of arrivals converted on the
+            // main thread spikes the frame.
+            let result = client
+                .fetch_node_with_info(&request)
+                .await
+                .map(|(node, info)| (prepare_node(node, epoch), info));
             let _ = tx.send((path, result)).await;
         });
+        lod_state.fetches.register(path, task, now);
+        lod_state.walk_dirty.node(path);
     }
 
     // Merge bulk load requests, dedup similarly. `render_result` /
@@ -1482,11 +2271,12 @@ fn update_lod_requests(
         .collect();
 
     for (path, epoch) in merged_bulks {
-        if lod_state.loading_bulks.len() >= max_bulk_loads {
+        if lod_state.loading_bulks.len() >= tuning.max_bulk_loads {
             break;
         }
 
         lod_state.loading_bulks.insert(path);
+        lod_state.walk_dirty.bulk(path);
 
         let client = Arc::clone(&loader_state.client);
         let request = BulkRequest::new(path, epoch);
@@ -1504,15 +2294,16 @@ fn update_lod_requests(
 fn poll_lod_bulk_tasks(mut lod_state: ResMut<LodState>, channels: Res<LodChannels>) {
     while let Ok((path, result)) = channels.bulk_rx.try_recv() {
         lod_state.loading_bulks.remove(&path);
+        lod_state.walk_dirty.bulk(path);
 
         match result {
-            Ok(bulk) => {
+            Ok(mut bulk) => {
                 tracing::debug!(
                     "LOD: Loaded bulk '{}': {} nodes",
                     bulk.path,
                     bulk.nodes.len()
                 );
-                let index = build_bulk_node_index(path, &bulk);
+                let index = BulkNodeIndex::build(path, &mut bulk);
                 lod_state.bulks.insert(path, bulk);
                 lod_state.bulk_node_indices.insert(path, index);
                 lod_state.bulks_version = lod_state.bulks_version.wrapping_add(1);
@@ -1525,141 +2316,210 @@ fn poll_lod_bulk_tasks(mut lod_state: ResMut<LodState>, channels: Res<LodChannel
     }
 }
 
-/// Build the relative-path → node-index lookup for a freshly loaded bulk.
-///
-/// `bulk_key` is the bulk's full path (used as the key in
-/// [`LodState::bulks`]); relative paths are stored without that prefix.
-fn build_bulk_node_index(bulk_key: OctreePath, bulk: &BulkMetadata) -> HashMap<OctreePath, usize> {
-    let mut index = HashMap::with_capacity(bulk.nodes.len());
-    for (i, node) in bulk.nodes.iter().enumerate() {
-        // Defensive: tolerate a node whose full path doesn't start with
-        // the bulk key (shouldn't happen, but a corrupt server response
-        // shouldn't panic the streaming system).
-        if let Some(rel) = node.path.strip_prefix(bulk_key) {
-            index.insert(rel, i);
-        }
-    }
-    index
-}
-
 /// Poll node loading results from channel and spawn meshes.
+///
+/// Results arrive already converted (see [`prepare_node`]), so this only
+/// inserts assets and spawns entities. Completed nodes join the physics cache
+/// immediately; spawning their render entities is spread across frames under
+/// [`LodTuning::node_spawn_budget_ms`].
+#[allow(clippy::too_many_arguments)]
 pub(crate) fn poll_lod_node_tasks(
     mut commands: Commands,
+    time: Res<Time>,
+    tuning: Res<LodTuning>,
     mut lod_state: ResMut<LodState>,
     mut meshes: ResMut<Assets<Mesh>>,
     mut materials: ResMut<Assets<TerrainMaterial>>,
     mut images: ResMut<Assets<Image>>,
+    mut tile_textures: ResMut<TileTexturePool>,
     channels: Res<LodChannels>,
 ) {
+    let now = time.elapsed_secs_f64();
     while let Ok((path, result)) = channels.node_rx.try_recv() {
-        lod_state.loading_nodes.remove(&path);
-        // Invalidates the BFS skip signature so requests previously
-        // dropped by the per-frame cap get re-queued on the next BFS
-        // run.
+        let info = result.as_ref().ok().map(|(_, info)| *info);
+        if !lod_state.fetches.complete(path, now, info) {
+            // The fetch was cancelled after it had already sent its result;
+            // nothing wants this node any more.
+            continue;
+        }
+        // Invalidates the BFS skip signature so the traversal re-runs and
+        // requests the next link of any physics fallback chain this node
+        // completes.
         lod_state.nodes_completed_version = lod_state.nodes_completed_version.wrapping_add(1);
+        lod_state.walk_dirty.node(path);
 
         match result {
-            Ok(node) => {
-                // Look up the real OBB from bulk metadata.
-                let obb = lod_state
-                    .node_obbs
-                    .get(&node.path)
-                    .copied()
-                    .unwrap_or(node.obb);
-
-                tracing::debug!(
-                    "LOD: Spawning node='{}' meshes={}",
-                    node.path,
-                    node.meshes.len(),
-                );
-
-                lod_state.loaded_nodes.insert(path);
-
-                let (world_position, transform) =
-                    matrix_to_world_position_and_transform(&node.matrix_globe_from_mesh);
-
-                // Cache node data for physics collider creation.
+            Ok((node, _)) => {
+                lod_state.failed_nodes.remove(&path);
+                // Cache node data for physics collider creation. The mesh
+                // `Arc` is shared, not copied.
+                lod_state.residency.insert_data(path, &node.meshes);
                 lod_state.node_data.insert(
                     path,
                     LoadedNodeData {
-                        meshes: Arc::new(node.meshes.clone()),
-                        transform,
-                        world_position: world_position.position,
+                        meshes: Arc::clone(&node.meshes),
+                        transform: node.transform,
+                        world_position: node.world_position.position,
                         meters_per_texel: node.meters_per_texel,
+                        epoch: node.epoch,
                     },
                 );
-
-                // Spawn mesh entities and track them for later despawning.
-                let entities = lod_state.node_entities.entry(path).or_default();
-                for rocktree_mesh in &node.meshes {
-                    let mesh = convert_mesh(rocktree_mesh);
-                    let texture = convert_texture(rocktree_mesh);
-
-                    let mesh_handle = meshes.add(mesh);
-                    let texture_handle = images.add(texture);
-
-                    let material = materials.add(TerrainMaterial {
-                        base: StandardMaterial {
-                            base_color_texture: Some(texture_handle),
-                            // Disable specular reflections for terrain.
-                            reflectance: 0.0,
-                            ..default()
-                        },
-                        extension: TerrainMaterialExtension {
-                            octant_mask: UVec4::ZERO,
-                        },
-                    });
-
-                    let entity = commands
-                        .spawn((
-                            Mesh3d(mesh_handle),
-                            MeshMaterial3d(material),
-                            transform,
-                            world_position.clone(),
-                            RocktreeMeshMarker {
-                                path: node.path,
-                                obb,
-                                meters_per_texel: node.meters_per_texel,
-                            },
-                            // Terrain receives shadows but doesn't cast them.
-                            NotShadowCaster,
-                        ))
-                        .id();
-                    entities.push(entity);
-                }
+                lod_state.queued_spawns.insert(path);
+                lod_state.spawn_queue.push_back((node, Instant::now()));
             }
             Err(e) => {
                 tracing::warn!("LOD: Failed to load node '{}': {}", path, e);
+                lod_state.record_fetch_failure(path, now, &tuning);
             }
         }
     }
+
+    let started = Instant::now();
+    let budget_secs = tuning.node_spawn_budget_ms / 1000.0;
+    let mut spawned = 0usize;
+    while let Some((node, arrived_at)) = lod_state.spawn_queue.pop_front() {
+        lod_state.queued_spawns.remove(&node.path);
+
+        // Look up the real OBB from bulk metadata.
+        let obb = lod_state
+            .node_obbs
+            .get(&node.path)
+            .copied()
+            .unwrap_or(node.obb);
+
+        tracing::debug!(
+            "LOD: Spawning node='{}' meshes={}",
+            node.path,
+            node.render.len(),
+        );
+
+        lod_state.loaded_nodes.insert(node.path);
+        lod_state.walk_dirty.node(node.path);
+
+        // Leave out the texture levels too fine for the camera to sample.
+        let dropped_levels = lod_state.lod_metrics.map_or(0, |lod_metrics| {
+            let texel_px = texel_screen_px(
+                Some(&obb),
+                node.world_position.position,
+                node.meters_per_texel,
+                &lod_metrics,
+            );
+            droppable_texture_levels(&tuning, texel_px)
+        });
+
+        // Spawn mesh entities and track them for later despawning.
+        let entities = lod_state.node_entities.entry(node.path).or_default();
+        let mut render_bytes = Footprint::default();
+        let mut dropped = 0;
+        for prepared in node.render {
+            let mesh_bytes = render_mesh_bytes(&prepared.mesh);
+            let mesh_handle = meshes.add(prepared.mesh);
+            let (slot, material) = tile_textures.insert(
+                prepared.texture,
+                dropped_levels,
+                tuning.tile_texture_page_layers,
+                &mut images,
+                &mut materials,
+            );
+            dropped = dropped.max(slot.dropped_levels);
+            render_bytes += Footprint {
+                cpu: mesh_bytes,
+                gpu: mesh_bytes + tile_textures.slot_bytes(slot),
+            };
+
+            let entity = commands
+                .spawn((
+                    Mesh3d(mesh_handle),
+                    MeshMaterial3d(material),
+                    tile_tag(slot.layer, 0),
+                    prepared.aabb,
+                    node.transform,
+                    node.world_position.clone(),
+                    RocktreeMeshMarker {
+                        path: node.path,
+                        obb,
+                        meters_per_texel: node.meters_per_texel,
+                    },
+                    // Terrain receives shadows but doesn't cast them.
+                    NotShadowCaster,
+                    AwaitingFirstFrame(Instant::now()),
+                ))
+                .id();
+            entities.push((entity, slot));
+        }
+        lod_state.residency.add_render(node.path, render_bytes);
+        if dropped > 0 {
+            lod_state.dropped_texture_levels.insert(node.path, dropped);
+        }
+        record_stage(
+            Stage::Upload,
+            Some(Tile::Node(node.path)),
+            arrived_at.elapsed(),
+        );
+
+        spawned += 1;
+        if started.elapsed().as_secs_f64() >= budget_secs {
+            break;
+        }
+    }
+    if spawned > 0 && !lod_state.spawn_queue.is_empty() {
+        tracing::debug!(
+            "LOD: spawned {spawned} node(s), {} deferred to the next frame",
+            lod_state.spawn_queue.len()
+        );
+    }
+}
+
+/// A tile mesh spawned at the held instant that hasn't been in view yet.
+#[derive(Component)]
+struct AwaitingFirstFrame(Instant);
+
+/// Report the [`Stage::Visible`] wait of tile meshes in view for the first
+/// time. Meshes hidden under loaded children until they despawn are never
+/// reported.
+fn report_first_visible(
+    mut commands: Commands,
+    query: Query<(
+        Entity,
+        &RocktreeMeshMarker,
+        &AwaitingFirstFrame,
+        &ViewVisibility,
+    )>,
+) {
+    for (entity, marker, awaiting, visibility) in &query {
+        if visibility.get() {
+            record_stage(
+                Stage::Visible,
+                Some(Tile::Node(marker.path)),
+                awaiting.0.elapsed(),
+            );
+            commands.entity(entity).remove::<AwaitingFirstFrame>();
+        }
+    }
 }
 
 /// Cull meshes based on frustum visibility and update per-vertex octant masks.
 ///
-/// Uses the real OBB from bulk metadata (stored on each mesh entity) for
-/// frustum culling. Updates each material's `octant_mask` uniform so the vertex
-/// shader can collapse vertices in octants that have loaded children. Fully
-/// masked parents (all 8 octants) are hidden entirely as an optimization.
+/// Updates each mesh's octant mask (in its [`tile_tag`]) so the vertex shader
+/// can collapse vertices in octants that have loaded children. Fully masked
+/// parents (all 8 octants) are hidden entirely as an optimization.
+///
+/// Frustum and occlusion culling are Bevy's, by each mesh's exact [`Aabb`]
+/// (see [`crate::mesh::mesh_aabb`]): on the GPU where the adapter supports
+/// it, writing only the surviving draws to the indirect buffers, and on the
+/// CPU otherwise.
+///
+/// [`Aabb`]: bevy::camera::primitives::Aabb
 fn cull_meshes(
     lod_state: Res<LodState>,
-    tuning: Res<LodTuning>,
-    mut materials: ResMut<Assets<TerrainMaterial>>,
-    mut query: Query<(
-        &RocktreeMeshMarker,
-        &MeshMaterial3d<TerrainMaterial>,
-        &mut Visibility,
-    )>,
+    mut query: Query<(&RocktreeMeshMarker, &mut MeshTag, &mut Visibility)>,
 ) {
-    let Some(frustum) = lod_state.frustum else {
-        return;
-    };
-
     // Build octant masks: for each loaded node, track which of its children
     // are also loaded. When all 8 children are present (mask == 0xff), the
     // parent is fully covered and should be hidden entirely.
+    // Budget-retained nodes are hidden, so they mustn't cover anything.
     let mut octant_masks: HashMap<OctreePath, u8> = HashMap::new();
-    for path in &lod_state.loaded_nodes {
+    for path in lod_state.displayed_nodes() {
         let Some(parent) = path.parent() else {
             continue;
         };
@@ -1669,30 +2529,12 @@ fn cull_meshes(
         *octant_masks.entry(parent).or_default() |= 1 << octant;
     }
 
-    // Get camera position for proximity check.
-    let camera_pos = lod_state.lod_metrics.map(|m| m.camera_position);
-
-    for (marker, material_handle, mut visibility) in &mut query {
-        // Check frustum visibility, with proximity exception.
-        let in_frustum = frustum.intersects_obb(&marker.obb);
-        let force_visible = camera_pos.is_some_and(|cam_pos| {
-            let altitude = cam_pos.length() - EARTH_RADIUS_M_F64;
-            let distance = cam_pos.distance(marker.obb.center);
-            altitude <= tuning.proximity_loading_max_altitude
-                && distance <= tuning.force_visible_radius
-        });
-
-        if !in_frustum && !force_visible {
-            if *visibility != Visibility::Hidden {
-                *visibility = Visibility::Hidden;
-            }
-            continue;
-        }
-
+    for (marker, mut tag, mut visibility) in &mut query {
         let mask = octant_masks.get(&marker.path).copied().unwrap_or(0);
 
-        // Hide parent nodes that are fully covered by children.
-        let desired = if mask == 0xff {
+        // Hide parent nodes that are fully covered by children, and nodes
+        // kept only by the budget.
+        let desired = if mask == 0xff || lod_state.budget_retained.contains(&marker.path) {
             Visibility::Hidden
         } else {
             Visibility::Inherited
@@ -1701,15 +2543,33 @@ fn cull_meshes(
             *visibility = desired;
         }
 
-        // Update the material's octant mask so the vertex shader can collapse
-        // vertices belonging to octants with loaded children.
-        // Use get() first to avoid triggering asset change detection on every
-        // material every frame (get_mut marks the asset as modified).
-        let needs_update = materials
-            .get(&material_handle.0)
-            .is_some_and(|m| m.extension.octant_mask.x != u32::from(mask));
-        if needs_update && let Some(material) = materials.get_mut(&material_handle.0) {
-            material.extension.octant_mask.x = u32::from(mask);
+        // Update the octant mask so the vertex shader can collapse vertices
+        // belonging to octants with loaded children. Compare first so the
+        // tag, and with it the mesh instance, only re-extracts on a change.
+        let desired = with_octant_mask(&tag, mask);
+        if tag.0 != desired.0 {
+            *tag = desired;
+        }
+    }
+}
+
+/// Keep the depth prepass and occlusion culling on the terrain camera in step
+/// with [`LodTuning::occlusion_culling`].
+fn configure_occlusion_culling(
+    mut commands: Commands,
+    tuning: Res<LodTuning>,
+    cameras: Query<(Entity, Has<OcclusionCulling>), (With<Camera3d>, With<FloatingOriginCamera>)>,
+) {
+    for (entity, culling) in &cameras {
+        if tuning.occlusion_culling && !culling {
+            commands
+                .entity(entity)
+                .insert((DepthPrepass, OcclusionCulling));
+        } else if !tuning.occlusion_culling && culling {
+            // Nothing else in the engine asks for the depth prepass.
+            commands
+                .entity(entity)
+                .remove::<(DepthPrepass, OcclusionCulling)>();
         }
     }
 }
@@ -1725,11 +2585,13 @@ fn cull_meshes(
 /// counters. Cost is roughly `O(union)` string-clones — small enough at
 /// typical BFS sizes (a few hundred entries) that running this every frame
 /// the diagnostics tab is open isn't a measurable hit.
+#[allow(clippy::too_many_arguments)]
 fn populate_snapshot(
     lod_state: &LodState,
     render: &BfsResult,
     physics: &PhysicsBfsResult,
     collider_targets: &HashMap<OctreePath, u8>,
+    walk: WalkStats,
     motion: &MotionTracker,
     camera_pos: DVec3,
     snapshot: &mut LodSnapshot,
@@ -1745,6 +2607,10 @@ fn populate_snapshot(
         bulks_cached: lod_state.bulks.len(),
         bulks_loading: lod_state.loading_bulks.len(),
         bulks_failed: lod_state.failed_bulks.len(),
+        nodes_failed: lod_state.failed_nodes.len(),
+        nodes_retrying: lod_state
+            .fetches
+            .count_requested(|path| lod_state.failed_nodes.contains_key(path)),
         physics_colliders: lod_state.physics_colliders.len(),
         physics_pending: collider_targets
             .keys()
@@ -1782,7 +2648,7 @@ fn populate_snapshot(
 
         let state = if lod_state.node_data.contains_key(&path) {
             SnapshotNodeState::Loaded
-        } else if lod_state.loading_nodes.contains(&path) {
+        } else if lod_state.is_node_loading(&path) {
             SnapshotNodeState::Loading
         } else {
             SnapshotNodeState::Discovered
@@ -1826,7 +2692,10 @@ fn populate_snapshot(
     }
 
     counters.render_loaded = lod_state.loaded_nodes.len();
-    counters.render_loading = lod_state.loading_nodes.len();
+    counters.render_loading = lod_state.fetches.in_flight_len();
+    counters.fetch = lod_state.fetches.stats();
+    counters.walk = walk;
+    counters.spawn_queued = lod_state.spawn_queue.len();
 
     snapshot.counters = counters;
 }
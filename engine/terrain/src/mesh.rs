@@ -1,107 +1,220 @@
 //! Mesh conversion utilities for rendering rocktree data in Bevy.
 //!
-//! Converts rocktree mesh data (packed vertices, triangle strips) to Bevy's
-//! mesh format (positions, normals, UVs, triangle lists).
+//! Converts rocktree mesh data (packed vertices, triangle strips) to Bevy
+//! meshes in the compact terrain vertex format (packed positions and octants,
+//! `unorm16` texcoords, oct-encoded normals, and `u16` triangle lists).
+//!
+//! [`prepare_node`] runs the whole conversion for a fetched node off the main
+//! thread, so the LOD system only has to insert ready-made assets.
+
+use std::sync::Arc;
 
 use bevy::{
     asset::RenderAssetUsages,
+    camera::primitives::Aabb,
     mesh::{Indices, PrimitiveTopology},
     prelude::*,
 };
-use rocktree::{Mesh as RocktreeMesh, TextureFormat};
+use rocktree::{
+    Mesh as RocktreeMesh, Node, TextureFormat,
+    stage::{Stage, Tile, stage_span},
+};
+use rocktree_decode::{OctreePath, OrientedBoundingBox, UvTransform, strip_to_triangles};
+use veldera_geo::floating_origin::WorldPosition;
+
+use crate::terrain_material::{
+    ATTRIBUTE_TERRAIN_NORMAL, ATTRIBUTE_TERRAIN_POSITION_OCTANT, ATTRIBUTE_TERRAIN_UV,
+};
+
+/// Render assets for one rocktree mesh, ready to be added to `Assets`.
+pub struct PreparedMesh {
+    /// Triangle-list mesh in the compact terrain vertex format.
+    pub mesh: Mesh,
+    /// Mesh-local bounds, which Bevy can't derive from the compact vertex.
+    pub aabb: Aabb,
+    /// The mesh's base colour texture, bound for a layer of the
+    /// [`TileTexturePool`](crate::tile_textures::TileTexturePool).
+    pub texture: Image,
+}
+
+/// A fetched node converted to render assets, plus the decoded geometry the
+/// physics cache keeps.
+pub struct PreparedNode {
+    /// The node's octree path.
+    pub path: OctreePath,
+    /// The node's own OBB, used when bulk metadata has none for it.
+    pub obb: OrientedBoundingBox,
+    /// Decoded meshes, shared with the physics cache. Texture bytes have been
+    /// moved into [`Self::render`], since nothing else reads them.
+    pub meshes: Arc<Vec<RocktreeMesh>>,
+    /// Render assets, one per entry in [`Self::meshes`].
+    pub render: Vec<PreparedMesh>,
+    /// High-precision position of the node's mesh origin.
+    pub world_position: WorldPosition,
+    /// Rotation and scale from mesh-local to globe coordinates.
+    pub transform: Transform,
+    /// Meters per texel (LOD metric).
+    pub meters_per_texel: f32,
+    /// The data epoch the node was fetched at.
+    pub epoch: u32,
+}
+
+/// Convert a fetched node, fetched at data `epoch`, into render assets.
+///
+/// Meant to run on the task that fetched the node: converting a burst of
+/// nodes on the main thread costs tens of milliseconds per frame.
+pub fn prepare_node(node: Node, epoch: u32) -> PreparedNode {
+    let _span = stage_span(Stage::Convert, Some(Tile::Node(node.path))).entered();
+    let Node {
+        path,
+        obb,
+        matrix_globe_from_mesh,
+        meters_per_texel,
+        mut meshes,
+    } = node;
+    let (world_position, transform) =
+        matrix_to_world_position_and_transform(&matrix_globe_from_mesh);
+    let render = meshes
+        .iter_mut()
+        .map(|rocktree_mesh| PreparedMesh {
+            mesh: convert_mesh(rocktree_mesh),
+            aabb: mesh_aabb(rocktree_mesh),
+            texture: convert_texture(rocktree_mesh),
+        })
+        .collect();
+
+    PreparedNode {
+        path,
+        obb,
+        meshes: Arc::new(meshes),
+        render,
+        world_position,
+        transform,
+        meters_per_texel,
+        epoch,
+    }
+}
 
-/// Convert a rocktree mesh to a Bevy mesh.
+/// Convert a rocktree mesh to a Bevy mesh in the compact terrain vertex
+/// format (see [`crate::terrain_material`]).
 ///
 /// The mesh vertices are in mesh-local coordinates (0-255 range).
 /// Apply the node's `matrix_globe_from_mesh` transform to position correctly.
+/// Texcoords have the mesh's UV transform applied (see [`texcoord_to_unorm`]),
+/// so meshes sharing a material need no per-mesh uniform.
 pub fn convert_mesh(rocktree_mesh: &RocktreeMesh) -> Mesh {
     let vertices = &rocktree_mesh.vertices;
-    let uv_transform = &rocktree_mesh.uv_transform;
 
-    // Convert packed vertices to separate position and UV arrays.
-    let positions: Vec<[f32; 3]> = vertices
+    // Per-vertex octant index (0-7) stored alongside the position. Used by
+    // the shader to mask vertices whose octant has a loaded child. When
+    // octant data is missing, use 255 as a sentinel so the shader never
+    // masks these vertices (bit 255 % 32 = bit 31 is never set in
+    // octant_mask).
+    let positions: Vec<[u8; 4]> = vertices
         .iter()
-        .map(|v| [f32::from(v.x), f32::from(v.y), f32::from(v.z)])
+        .map(|v| {
+            let octant = if rocktree_mesh.has_octant_data {
+                v.w
+            } else {
+                255
+            };
+            [v.x, v.y, v.z, octant]
+        })
         .collect();
 
-    let uvs: Vec<[f32; 2]> = vertices
+    let UvTransform { offset, scale } = rocktree_mesh.uv_transform;
+    let uvs: Vec<[u16; 2]> = vertices
         .iter()
         .map(|v| {
-            // Apply UV transform: uv = (texcoord + offset) * scale.
-            let u = (f32::from(v.u()) + uv_transform.offset.x) * uv_transform.scale.x;
-            let v_coord = (f32::from(v.v()) + uv_transform.offset.y) * uv_transform.scale.y;
-            [u, v_coord]
+            [
+                texcoord_to_unorm(v.u(), offset.x, scale.x),
+                texcoord_to_unorm(v.v(), offset.y, scale.y),
+            ]
         })
         .collect();
 
-    // Convert triangle strip indices to triangle list.
-    let triangle_indices = strip_to_triangles(&rocktree_mesh.indices);
-
-    // Per-vertex octant index (0-7) stored in the red channel of vertex color.
-    // Used by the shader to mask vertices whose octant has a loaded child.
-    // When octant data is missing, use 255 as a sentinel so the shader never
-    // masks these vertices (bit 255 % 32 = bit 31 is never set in octant_mask).
-    let octant_sentinel = if rocktree_mesh.has_octant_data {
-        None
-    } else {
-        Some(255.0)
-    };
-    let colors: Vec<[f32; 4]> = vertices
+    // Use the original normals from Google Earth data to ensure seamless
+    // lighting across tile boundaries. These normals are consistent at
+    // shared edges between adjacent tiles.
+    let normals: Vec<[i16; 2]> = rocktree_mesh
+        .normals
         .iter()
-        .map(|v| [octant_sentinel.unwrap_or(f32::from(v.w)), 0.0, 0.0, 1.0])
+        .map(|&n| oct_encode(n))
         .collect();
 
-    // Build the Bevy mesh with normals for lit rendering.
+    // Convert triangle strip indices to triangle list.
+    let triangle_indices = strip_to_triangles(&rocktree_mesh.indices);
+
     let mut mesh = Mesh::new(
         PrimitiveTopology::TriangleList,
         RenderAssetUsages::default(),
     );
-    mesh.insert_attribute(Mesh::ATTRIBUTE_POSITION, positions);
-    mesh.insert_attribute(Mesh::ATTRIBUTE_UV_0, uvs);
-    mesh.insert_attribute(Mesh::ATTRIBUTE_COLOR, colors);
-    mesh.insert_indices(Indices::U32(triangle_indices));
-
-    // Use the original normals from Google Earth data to ensure seamless
-    // lighting across tile boundaries. These normals are consistent at
-    // shared edges between adjacent tiles.
-    mesh.insert_attribute(Mesh::ATTRIBUTE_NORMAL, rocktree_mesh.normals.clone());
+    mesh.insert_attribute(ATTRIBUTE_TERRAIN_POSITION_OCTANT, positions);
+    mesh.insert_attribute(ATTRIBUTE_TERRAIN_UV, uvs);
+    mesh.insert_attribute(ATTRIBUTE_TERRAIN_NORMAL, normals);
+    mesh.insert_indices(Indices::U16(triangle_indices));
 
     mesh
 }
 
-/// Convert a triangle strip to a triangle list.
+/// Mesh-local bounds of a rocktree mesh's vertices.
 ///
-/// Handles degenerate triangles (where two or more indices are the same).
-fn strip_to_triangles(strip: &[u16]) -> Vec<u32> {
-    if strip.len() < 3 {
-        return Vec::new();
-    }
-
-    let mut triangles = Vec::with_capacity(strip.len() * 3);
-
-    for i in 0..strip.len() - 2 {
-        let a = u32::from(strip[i]);
-        let b = u32::from(strip[i + 1]);
-        let c = u32::from(strip[i + 2]);
+/// Bevy frustum- and occlusion-culls a mesh by its [`Aabb`], but only
+/// computes one from the standard position attribute, which terrain meshes
+/// don't have; without it every tile would be drawn.
+pub fn mesh_aabb(rocktree_mesh: &RocktreeMesh) -> Aabb {
+    let mut vertices = rocktree_mesh.vertices.iter();
+    let Some(first) = vertices.next() else {
+        return Aabb::default();
+    };
+    let (min, max) = vertices.fold(
+        ([first.x, first.y, first.z], [first.x, first.y, first.z]),
+        |(min, max), v| {
+            (
+                [min[0].min(v.x), min[1].min(v.y), min[2].min(v.z)],
+                [max[0].max(v.x), max[1].max(v.y), max[2].max(v.z)],
+            )
+        },
+    );
+    let corner = |[x, y, z]: [u8; 3]| Vec3::new(f32::from(x), f32::from(y), f32::from(z));
+    Aabb::from_min_max(corner(min), corner(max))
+}
 
-        // Skip degenerate triangles.
-        if a == b || b == c || a == c {
-            continue;
-        }
+/// Apply one axis of a mesh's UV transform, `uv = (texcoord + offset) *
+/// scale`, and quantise the result to `unorm16`.
+///
+/// UVs outside `[0, 1]` are clamped, which samples the same texels as the
+/// clamp-to-edge sampler the raw texcoords were drawn with; `1 / 65535`
+/// steps are finer than a texel of any rocktree texture.
+pub fn texcoord_to_unorm(texcoord: u16, offset: f32, scale: f32) -> u16 {
+    let uv = (f32::from(texcoord) + offset) * scale;
+    (uv.clamp(0.0, 1.0) * f32::from(u16::MAX)).round() as u16
+}
 
-        // Alternate winding order for triangle strips.
-        if i % 2 == 0 {
-            triangles.extend([a, b, c]);
-        } else {
-            triangles.extend([a, c, b]);
-        }
+/// Octahedral-encode a unit normal to two snorm16 components.
+///
+/// Decoded by `oct_decode` in `terrain_material.wgsl`.
+pub fn oct_encode(normal: [f32; 3]) -> [i16; 2] {
+    let [x, y, z] = normal;
+    let l1 = x.abs() + y.abs() + z.abs();
+    if l1 == 0.0 {
+        return [0, 0];
     }
-
-    triangles
+    let (mut u, mut v) = (x / l1, y / l1);
+    if z < 0.0 {
+        // Fold the lower hemisphere over the diagonals.
+        let sign = |a: f32| if a >= 0.0 { 1.0 } else { -1.0 };
+        (u, v) = ((1.0 - v.abs()) * sign(u), (1.0 - u.abs()) * sign(v));
+    }
+    let snorm = |a: f32| (a.clamp(-1.0, 1.0) * 32767.0).round() as i16;
+    [snorm(u), snorm(v)]
 }
 
-/// Create a Bevy image from rocktree texture data.
-pub fn convert_texture(rocktree_mesh: &RocktreeMesh) -> Image {
+/// Create a Bevy image, mip chain included, from rocktree texture data.
+///
+/// Moves the texture bytes out of the mesh rather than copying them, leaving
+/// `texture_data` empty.
+pub fn convert_texture(rocktree_mesh: &mut RocktreeMesh) -> Image {
     use bevy::render::render_resource::{
         Extent3d, TextureDimension, TextureFormat as BevyTextureFormat,
     };
@@ -109,45 +222,45 @@ pub fn convert_texture(rocktree_mesh: &RocktreeMesh) -> Image {
     let width = rocktree_mesh.texture_width;
     let height = rocktree_mesh.texture_height;
 
+    let texture_data = std::mem::take(&mut rocktree_mesh.texture_data);
+
     let (data, format) = match rocktree_mesh.texture_format {
         TextureFormat::Rgb => {
-            // Convert RGB to RGBA by adding alpha channel.
-            let rgb = &rocktree_mesh.texture_data;
-            let mut rgba = Vec::with_capacity((width * height * 4) as usize);
+            // Convert RGB to RGBA by adding alpha channel. The levels are
+            // contiguous, so the whole chain converts in one pass.
+            let rgb = &texture_data;
+            let mut rgba = Vec::with_capacity(rgb.len() / 3 * 4);
             for chunk in rgb.chunks(3) {
                 rgba.extend_from_slice(chunk);
                 rgba.push(255);
             }
             (rgba, BevyTextureFormat::Rgba8UnormSrgb)
         }
-        TextureFormat::Rgba => (
-            rocktree_mesh.texture_data.clone(),
-            BevyTextureFormat::Rgba8UnormSrgb,
-        ),
+        TextureFormat::Rgba => (texture_data, BevyTextureFormat::Rgba8UnormSrgb),
         TextureFormat::Dxt1 => {
             // DXT1 is BC1 in modern terminology.
-            (
-                rocktree_mesh.texture_data.clone(),
-                BevyTextureFormat::Bc1RgbaUnormSrgb,
-            )
+            (texture_data, BevyTextureFormat::Bc1RgbaUnormSrgb)
         }
     };
 
-    Image::new(
+    // `Image::new` checks the data length against a single level, which
+    // neither block formats nor mip chains match; fill an uninitialised
+    // image instead.
+    let mut image = Image::new_uninit(
         Extent3d {
             width,
             height,
             depth_or_array_layers: 1,
         },
         TextureDimension::D2,
-        data,
         format,
         RenderAssetUsages::default(),
-    )
+    );
+    image.texture_descriptor.mip_level_count = rocktree_mesh.texture_mip_levels.max(1);
+    image.data = Some(data);
+    image
 }
 
-use veldera_geo::floating_origin::WorldPosition;
-
 /// Convert a 4x4 double-precision matrix to `WorldPosition` and Transform.
 ///
 /// Returns:
@@ -180,9 +293,9 @@ pub fn matrix_to_world_position_and_transform(matrix: &glam::DMat4) -> (WorldPos
 #[derive(Component)]
 pub struct RocktreeMeshMarker {
     /// The octant path for this node.
-    pub path: rocktree_decode::OctreePath,
+    pub path: OctreePath,
     /// Oriented bounding box from the node's bulk metadata.
-    pub obb: rocktree_decode::OrientedBoundingBox,
+    pub obb: OrientedBoundingBox,
     /// Meters per texel (LOD metric) for this mesh. Stored for debugging/future use.
     #[allow(dead_code)]
     pub meters_per_texel: f32,
@@ -207,6 +320,47 @@ mod tests {
         assert_eq!(triangles, vec![0, 1, 2, 1, 3, 2]);
     }
 
+    #[test]
+    fn test_oct_encode_round_trip() {
+        // Mirrors `oct_decode` in `terrain_material.wgsl`.
+        fn oct_decode([u, v]: [i16; 2]) -> Vec3 {
+            let (x, y) = (f32::from(u) / 32767.0, f32::from(v) / 32767.0);
+            let mut n = Vec3::new(x, y, 1.0 - x.abs() - y.abs());
+            let t = (-n.z).max(0.0);
+            n.x += if n.x >= 0.0 { -t } else { t };
+            n.y += if n.y >= 0.0 { -t } else { t };
+            n.normalize()
+        }
+
+        for normal in [
+            Vec3::Z,
+            Vec3::NEG_Z,
+            Vec3::X,
+            Vec3::NEG_Y,
+            Vec3::new(1.0, 2.0, 3.0).normalize(),
+            Vec3::new(-0.3, 0.5, -0.8).normalize(),
+        ] {
+            let decoded = oct_decode(oct_encode(normal.to_array()));
+            assert!(
+                decoded.angle_between(normal) < 1e-3,
+                "{normal} decoded as {decoded}"
+            );
+        }
+    }
+
+    #[test]
+    fn test_texcoord_to_unorm() {
+        // An 8-bit texcoord range with the half-texel offset and flipped V
+        // that `rocktree` produces.
+        let scale = 1.0 / 256.0;
+        assert_eq!(texcoord_to_unorm(0, 0.5, scale), 128);
+        assert_eq!(texcoord_to_unorm(255, 0.5, scale), 65_407);
+        assert_eq!(texcoord_to_unorm(0, 0.5 - 256.0, -scale), 65_407);
+        // Out-of-range UVs clamp.
+        assert_eq!(texcoord_to_unorm(300, 0.5, scale), u16::MAX);
+        assert_eq!(texcoord_to_unorm(10, -20.0, scale), 0);
+    }
+
     #[test]
     fn test_strip_to_triangles_degenerate() {
         // Degenerate: indices 0,1,1 and 1,1,2.
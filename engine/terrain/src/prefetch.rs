@@ -0,0 +1,663 @@
+//! Speculative prefetch of tiles ahead of need.
+//!
+//! The LOD traversal in [`lod`](crate::lod) only loads what the camera needs
+//! *now*. The prefetcher warms the tile cache for where the camera is about
+//! to be: a few motion leads ahead of the camera, and wherever a gameplay
+//! system has announced it is going (a teleport publishes its destination
+//! and descent through [`PrefetchHints`] before the flight starts). When the
+//! traversal later asks for those tiles they come from the cache instead of
+//! the network.
+//!
+//! It runs beside the visible-set traversal rather than inside it, so it
+//! can't starve on-screen loads:
+//! - It has its own small concurrency cap ([`LodTuning::prefetch_max_concurrency`]).
+//! - It spends at most a fraction of the measured bandwidth
+//!   ([`LodTuning::prefetch_bandwidth_fraction`]).
+//! - Its requests go out at [`FetchPriority::Low`]. When the traversal asks
+//!   for a tile already being prefetched, the client coalesces the two, and
+//!   the traversal's higher priority takes over the retries.
+//!
+//! Prefetched nodes are only fetched into the cache, not decoded or
+//! spawned. The bulks they hang off are decoded into the prefetcher's own
+//! map, which never feeds the traversal.
+
+use std::{
+    collections::{BTreeMap, HashMap, HashSet, VecDeque},
+    sync::Arc,
+};
+
+use bevy::prelude::*;
+use glam::DVec3;
+use rocktree::{
+    BulkMetadata, BulkRequest, FetchInfo, FetchPriority, LodMetrics, NodeMetadata, NodeRequest,
+};
+use rocktree_decode::OctreePath;
+
+use veldera_async::{SpawnedTask, TaskSpawner};
+use veldera_geo::floating_origin::FloatingOriginCamera;
+use veldera_physics::MotionTracker;
+
+use crate::{
+    bulk_index::BulkNodeIndex,
+    loader::LoaderState,
+    lod::{LodSnapshot, LodState, LodTuning, effective_distance},
+};
+
+/// Hint source name for the motion-lead target.
+const LEAD_SOURCE: &str = "motion lead";
+
+/// A place the streaming system should warm the cache for: the tiles a
+/// camera at `position` would want within `radius` of it.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct PrefetchTarget {
+    /// Prospective camera position (ECEF, m).
+    pub position: DVec3,
+    /// Radius around `position` to warm (m).
+    pub radius: f64,
+}
+
+/// Prefetch targets published by gameplay systems, keyed by source so each
+/// system replaces or clears only its own.
+///
+/// Setting the same targets again doesn't count as a change, so a source
+/// may re-publish every frame without forcing a re-plan.
+#[derive(Resource, Default, Debug)]
+pub struct PrefetchHints {
+    sources: BTreeMap<&'static str, Vec<PrefetchTarget>>,
+    generation: u64,
+}
+
+impl PrefetchHints {
+    /// Replace `source`'s targets. Earlier targets are warmed first.
+    pub fn set(&mut self, source: &'static str, targets: Vec<PrefetchTarget>) {
+        if self.sources.get(source) != Some(&targets) {
+            self.sources.insert(source, targets);
+            self.generation = self.generation.wrapping_add(1);
+        }
+    }
+
+    /// Remove `source`'s targets.
+    pub fn clear(&mut self, source: &'static str) {
+        if self.sources.remove(source).is_some() {
+            self.generation = self.generation.wrapping_add(1);
+        }
+    }
+
+    /// Replace the motion-lead target, unless it is within `step` of the
+    /// current one.
+    fn set_lead(&mut self, target: PrefetchTarget, step: f64) {
+        let moved = self.sources.get(LEAD_SOURCE).is_none_or(|current| {
+            current.iter().all(|old| {
+                old.radius != target.radius || old.position.distance(target.position) > step
+            })
+        });
+        if moved {
+            self.set(LEAD_SOURCE, vec![target]);
+        }
+    }
+
+    /// Whether any source other than the motion lead has targets.
+    fn has_announced(&self) -> bool {
+        self.sources.keys().any(|source| *source != LEAD_SOURCE)
+    }
+
+    fn targets(&self) -> impl Iterator<Item = &PrefetchTarget> {
+        self.sources.values().flatten()
+    }
+}
+
+/// Prefetch counters for the diagnostics UI.
+#[derive(Debug, Clone, Copy, Default)]
+pub struct PrefetchStats {
+    /// Planned node prefetches not yet dispatched.
+    pub queued: usize,
+    /// Prefetches currently running.
+    pub in_flight: usize,
+    /// Current byte budget (bytes/s).
+    pub budget_bytes_per_sec: f64,
+    /// Nodes warmed into the cache so far.
+    pub warmed: u64,
+    /// Network bytes spent on prefetching so far.
+    pub warmed_bytes: u64,
+    /// Warmed nodes the traversal later loaded.
+    pub used: u64,
+    /// Warmed nodes the traversal never asked for before they expired.
+    pub wasted: u64,
+}
+
+impl PrefetchStats {
+    /// Fraction of settled warmed nodes that were used, if any settled yet.
+    #[must_use]
+    pub fn hit_rate(&self) -> Option<f64> {
+        let settled = self.used + self.wasted;
+        (settled > 0).then(|| self.used as f64 / settled as f64)
+    }
+}
+
+/// A byte budget refilled at a fixed rate, holding at most one second's
+/// worth so an idle spell can't bank a burst.
+#[derive(Debug, Default)]
+struct ByteBudget {
+    available: f64,
+    rate: f64,
+}
+
+impl ByteBudget {
+    fn refill(&mut self, rate: f64, dt: f64) {
+        self.rate = rate;
+        self.available = (self.available + rate * dt).min(rate);
+    }
+
+    /// Whether a fetch may start. Fetch sizes are unknown up front, so the
+    /// budget may go negative by the last fetch's size and is repaid before
+    /// the next one starts.
+    fn can_spend(&self) -> bool {
+        self.available > 0.0
+    }
+
+    fn spend(&mut self, bytes: usize) {
+        self.available -= bytes as f64;
+    }
+}
+
+/// A bulk whose last fetch failed.
+#[derive(Debug, Clone, Copy)]
+struct FailedBulk {
+    /// Failures in a row.
+    failures: u32,
+    /// When the backoff after the last failure runs out (elapsed s).
+    retry_at: f64,
+}
+
+type PrefetchNodeResult = (OctreePath, Result<FetchInfo, rocktree::Error>);
+type PrefetchBulkResult = (OctreePath, Result<BulkMetadata, rocktree::Error>);
+
+/// Prefetch planning and dispatch state; see the [module docs](self).
+#[derive(Resource)]
+pub struct Prefetcher {
+    /// Bulks decoded for planning only, with their node indices and when
+    /// they were decoded.
+    bulks: HashMap<OctreePath, (BulkMetadata, BulkNodeIndex, f64)>,
+    /// Bulks decoded so far, so a re-plan follows each new one even once
+    /// the oldest make room for it.
+    bulks_decoded: u64,
+    loading_bulks: HashSet<OctreePath>,
+    /// Bulks backed off after failed fetches. Backoff follows
+    /// [`LodTuning::fetch_retry_secs`], like the traversal's node fetches.
+    failed_bulks: HashMap<OctreePath, FailedBulk>,
+    /// Planned node prefetches, coarsest first.
+    queue: VecDeque<NodeMetadata>,
+    in_flight: HashMap<OctreePath, SpawnedTask>,
+    /// Nodes warmed into the cache, with when they were warmed.
+    warmed: HashMap<OctreePath, f64>,
+    budget: ByteBudget,
+    /// Hint generation and bulks decoded the queue was planned against.
+    planned: Option<(u64, u64)>,
+    last_plan_at: f64,
+    last_frame_at: Option<f64>,
+    stats: PrefetchStats,
+    node_tx: async_channel::Sender<PrefetchNodeResult>,
+    node_rx: async_channel::Receiver<PrefetchNodeResult>,
+    bulk_tx: async_channel::Sender<PrefetchBulkResult>,
+    bulk_rx: async_channel::Receiver<PrefetchBulkResult>,
+}
+
+impl Default for Prefetcher {
+    fn default() -> Self {
+        let (node_tx, node_rx) = async_channel::unbounded();
+        let (bulk_tx, bulk_rx) = async_channel::unbounded();
+        Self {
+            bulks: HashMap::new(),
+            bulks_decoded: 0,
+            loading_bulks: HashSet::new(),
+            failed_bulks: HashMap::new(),
+            queue: VecDeque::new(),
+            in_flight: HashMap::new(),
+            warmed: HashMap::new(),
+            budget: ByteBudget::default(),
+            planned: None,
+            last_plan_at: f64::NEG_INFINITY,
+            last_frame_at: None,
+            stats: PrefetchStats::default(),
+            node_tx,
+            node_rx,
+            bulk_tx,
+            bulk_rx,
+        }
+    }
+}
+
+impl Prefetcher {
+    /// Snapshot of the prefetch counters.
+    #[must_use]
+    pub fn stats(&self) -> PrefetchStats {
+        PrefetchStats {
+            queued: self.queue.len(),
+            in_flight: self.in_flight.len(),
+            budget_bytes_per_sec: self.budget.rate,
+            ..self.stats
+        }
+    }
+
+    /// Drop all planned and running work, keeping the counters.
+    fn reset(&mut self) {
+        self.queue.clear();
+        for (_, task) in self.in_flight.drain() {
+            task.cancel();
+        }
+        self.loading_bulks.clear();
+        self.planned = None;
+    }
+
+    fn poll(&mut self, now: f64, tuning: &LodTuning) {
+        while let Ok((path, result)) = self.node_rx.try_recv() {
+            if self.in_flight.remove(&path).is_none() {
+                continue;
+            }
+            if let Ok(info) = result {
+                if !info.cache_hit && !info.coalesced {
+                    self.budget.spend(info.bytes);
+                    self.stats.warmed_bytes += info.bytes as u64;
+                }
+                self.stats.warmed += 1;
+                self.warmed.insert(path, now);
+            }
+        }
+        while let Ok((path, result)) = self.bulk_rx.try_recv() {
+            self.loading_bulks.remove(&path);
+            match result {
+                Ok(mut bulk) => {
+                    self.failed_bulks.remove(&path);
+                    while self.bulks.len() >= tuning.prefetch_max_bulks.max(1) {
+                        let oldest = self
+                            .bulks
+                            .iter()
+                            .min_by(|a, b| a.1.2.total_cmp(&b.1.2))
+                            .map(|(path, _)| *path);
+                        let Some(oldest) = oldest else { break };
+                        self.bulks.remove(&oldest);
+                    }
+                    let index = BulkNodeIndex::build(path, &mut bulk);
+                    self.bulks.insert(path, (bulk, index, now));
+                    self.bulks_decoded += 1;
+                }
+                Err(e) => {
+                    tracing::debug!("Prefetch: failed to load bulk '{path}': {e}");
+                    self.record_bulk_failure(path, now, tuning);
+                }
+            }
+        }
+        // Forget failures nothing has retried for a full maximum backoff.
+        self.failed_bulks
+            .retain(|_, failure| now - failure.retry_at < tuning.fetch_retry_max_secs);
+    }
+
+    /// Back a bulk off after a failed fetch, for longer on each failure in a
+    /// row.
+    fn record_bulk_failure(&mut self, path: OctreePath, now: f64, tuning: &LodTuning) {
+        let failure = self.failed_bulks.entry(path).or_insert(FailedBulk {
+            failures: 0,
+            retry_at: now,
+        });
+        failure.failures += 1;
+        let delay = tuning.fetch_retry_secs * 2f64.powi(failure.failures.min(16) as i32 - 1);
+        failure.retry_at = now + delay.min(tuning.fetch_retry_max_secs);
+    }
+
+    /// Whether a bulk is still waiting out the backoff after a failed fetch.
+    fn is_bulk_backed_off(&self, path: &OctreePath, now: f64) -> bool {
+        self.failed_bulks
+            .get(path)
+            .is_some_and(|failure| failure.retry_at > now)
+    }
+
+    /// Settle warmed nodes: used once the traversal has loaded them, wasted
+    /// once they expire unasked. One the traversal is still fetching may yet
+    /// fail or be cancelled, so it stays unsettled, and doesn't age, until
+    /// the fetch ends.
+    fn settle_warmed(&mut self, lod_state: &LodState, now: f64, ttl: f64) {
+        let stats = &mut self.stats;
+        self.warmed.retain(|path, warmed_at| {
+            if lod_state.is_node_loaded(*path) {
+                stats.used += 1;
+                false
+            } else if lod_state.is_node_loading(path) {
+                *warmed_at = now;
+                true
+            } else if now - *warmed_at > ttl {
+                stats.wasted += 1;
+                false
+            } else {
+                true
+            }
+        });
+    }
+
+    /// Look up a bulk, preferring the traversal's copy.
+    fn bulk<'a>(
+        &'a self,
+        lod_state: &'a LodState,
+        path: OctreePath,
+    ) -> Option<(&'a BulkMetadata, &'a BulkNodeIndex)> {
+        lod_state
+            .bulk_with_index(path)
+            .or_else(|| self.bulks.get(&path).map(|(bulk, index, _)| (bulk, index)))
+    }
+
+    /// Re-plan the node queue for `targets`, returning bulks to fetch.
+    ///
+    /// Each target gets an equal share of `max_nodes`. Its walk descends
+    /// breadth-first from the root, so the share goes to the coarse tiles
+    /// that cover the area soonest. A node is wanted when it lies within the
+    /// target's radius and the render rule would refine it for a camera at
+    /// the target, ignoring the frustum because the view direction on
+    /// arrival is unknown.
+    fn plan<'a>(
+        &mut self,
+        lod_state: &LodState,
+        targets: impl ExactSizeIterator<Item = &'a PrefetchTarget>,
+        metrics: LodMetrics,
+        max_nodes: usize,
+        now: f64,
+    ) -> Vec<(OctreePath, u32)> {
+        let share = max_nodes / targets.len().max(1);
+        let mut queue = VecDeque::new();
+        let mut seen: HashSet<OctreePath> = HashSet::new();
+        let mut bulks_to_load = Vec::new();
+
+        for target in targets {
+            let metrics = LodMetrics {
+                camera_position: target.position,
+                ..metrics
+            };
+            let mut planned = 0;
+            let mut frontier = VecDeque::from([(OctreePath::ROOT, OctreePath::ROOT)]);
+            'walk: while let Some((path, bulk_key)) = frontier.pop_front() {
+                // Cross into the child bulk every four levels, as the
+                // traversal does.
+                let bulk_key = if !path.is_root() && path.depth().is_multiple_of(4) {
+                    let rel = path.tail(4).expect("depth >= 4 by guard above");
+                    let Some((parent, _)) = self.bulk(lod_state, bulk_key) else {
+                        continue;
+                    };
+                    let Some(&epoch) = parent.child_bulk_paths.get(&rel) else {
+                        continue;
+                    };
+                    if self.bulk(lod_state, path).is_none() {
+                        if !self.loading_bulks.contains(&path)
+                            && !self.is_bulk_backed_off(&path, now)
+                            && !bulks_to_load.iter().any(|(p, _)| *p == path)
+                        {
+                            bulks_to_load.push((path, epoch));
+                        }
+                        continue;
+                    }
+                    path
+                } else {
+                    bulk_key
+                };
+                let Some((bulk, index)) = self.bulk(lod_state, bulk_key) else {
+                    continue;
+                };
+
+                for octant in 0u8..=7 {
+                    let child_path = path.push(octant);
+                    let Some(child) = child_path
+                        .strip_prefix(bulk_key)
+                        .and_then(|rel| index.get(rel))
+                    else {
+                        continue;
+                    };
+                    let node = &bulk.nodes[child];
+                    if effective_distance(&node.obb, target.position, DVec3::ZERO) > target.radius
+                        || !metrics.should_refine(node.obb.center, node.meters_per_texel)
+                    {
+                        continue;
+                    }
+                    frontier.push_back((child_path, bulk_key));
+                    if node.has_data
+                        && !lod_state.is_node_loaded(node.path)
+                        && !lod_state.is_node_loading(&node.path)
+                        && !lod_state.is_node_backed_off(&node.path)
+                        && !self.warmed.contains_key(&node.path)
+                        && !self.in_flight.contains_key(&node.path)
+                        && seen.insert(node.path)
+                    {
+                        queue.push_back(node.clone());
+                        planned += 1;
+                        if planned >= share {
+                            break 'walk;
+                        }
+                    }
+                }
+            }
+        }
+        self.queue = queue;
+        bulks_to_load
+    }
+}
+
+/// Plan and dispatch prefetches. Runs after the traversal each frame.
+#[allow(clippy::too_many_arguments)]
+pub(crate) fn update_prefetch(
+    time: Res<Time>,
+    tuning: Res<LodTuning>,
+    lod_state: Res<LodState>,
+    loader_state: Res<LoaderState>,
+    motion: Res<MotionTracker>,
+    mut hints: ResMut<PrefetchHints>,
+    mut prefetcher: ResMut<Prefetcher>,
+    mut snapshot: ResMut<LodSnapshot>,
+    camera_query: Query<&FloatingOriginCamera>,
+    spawner: TaskSpawner,
+) {
+    let prefetcher = &mut *prefetcher;
+    let now = time.elapsed_secs_f64();
+    let dt = prefetcher.last_frame_at.map_or(0.0, |last| now - last);
+    prefetcher.last_frame_at = Some(now);
+
+    prefetcher.poll(now, &tuning);
+    prefetcher.settle_warmed(&lod_state, now, tuning.prefetch_warmed_ttl_secs);
+    snapshot.counters.prefetch = prefetcher.stats();
+
+    if tuning.prefetch_max_concurrency == 0 {
+        prefetcher.reset();
+        return;
+    }
+    let (Some(metrics), Ok(camera)) = (lod_state.lod_metrics(), camera_query.single()) else {
+        return;
+    };
+
+    // Warm a few motion leads ahead of where the traversal already looks.
+    // An announced destination beats extrapolated motion: mid-teleport the
+    // lead points wherever the flight arc happens to be heading. The lead
+    // target moves every frame the camera does, so it is only replaced once
+    // it has moved a step; the periodic re-plan covers the drift in between.
+    let lead = motion.lead();
+    if lead == DVec3::ZERO || hints.has_announced() {
+        hints.clear(LEAD_SOURCE);
+    } else {
+        let target = PrefetchTarget {
+            position: camera.position + lead * tuning.prefetch_lead_scale,
+            radius: tuning.prefetch_radius,
+        };
+        hints.set_lead(target, tuning.prefetch_lead_step);
+    }
+    if hints.targets().next().is_none() {
+        prefetcher.reset();
+        return;
+    }
+
+    let bandwidth = lod_state
+        .fetch_stats()
+        .bandwidth_bytes_per_sec
+        .unwrap_or(tuning.prefetch_fallback_bandwidth);
+    prefetcher
+        .budget
+        .refill(bandwidth * tuning.prefetch_bandwidth_fraction, dt);
+
+    // Re-plan when the targets change, when new bulks open up deeper
+    // levels, and periodically as the traversal's own loads land.
+    let planned = Some((hints.generation, prefetcher.bulks_decoded));
+    if prefetcher.planned != planned || now - prefetcher.last_plan_at >= tuning.prefetch_replan_secs
+    {
+        let targets: Vec<&PrefetchTarget> = hints.targets().collect();
+        let bulks_to_load = prefetcher.plan(
+            &lod_state,
+            targets.into_iter(),
+            metrics,
+            tuning.prefetch_max_nodes,
+            now,
+        );
+        prefetcher.planned = planned;
+        prefetcher.last_plan_at = now;
+
+        for (path, epoch) in bulks_to_load {
+            if prefetcher.loading_bulks.len() >= tuning.prefetch_max_concurrency {
+                break;
+            }
+            prefetcher.loading_bulks.insert(path);
+            let client = Arc::clone(&loader_state.client);
+            let request = BulkRequest::new(path, epoch).with_priority(FetchPriority::Low);
+            let tx = prefetcher.bulk_tx.clone();
+            spawner.spawn(async move {
+                let result = client.fetch_bulk(&request).await;
+                let _ = tx.send((path, result)).await;
+            });
+        }
+    }
+
+    while prefetcher.in_flight.len() < tuning.prefetch_max_concurrency
+        && prefetcher.budget.can_spend()
+        && let Some(node) = prefetcher.queue.pop_front()
+    {
+        // The traversal may have picked it up since the plan.
+        if lod_state.is_node_loaded(node.path) || lod_state.is_node_loading(&node.path) {
+            continue;
+        }
+        let path = node.path;
+        let client = Arc::clone(&loader_state.client);
+        let request = NodeRequest::new(path, node.epoch, node.texture_format, node.imagery_epoch)
+            .with_priority(FetchPriority::Low);
+        let tx = prefetcher.node_tx.clone();
+        let task = spawner.spawn_cancellable(async move {
+            let result = client.warm_node(&request).await;
+            let _ = tx.send((path, result)).await;
+        });
+        prefetcher.in_flight.insert(path, task);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn target(x: f64) -> PrefetchTarget {
+        PrefetchTarget {
+            position: DVec3::new(x, 0.0, 0.0),
+            radius: 100.0,
+        }
+    }
+
+    #[test]
+    fn test_hints_only_change_on_new_targets() {
+        let mut hints = PrefetchHints::default();
+        hints.set("a", vec![target(1.0)]);
+        let generation = hints.generation;
+        hints.set("a", vec![target(1.0)]);
+        assert_eq!(hints.generation, generation);
+
+        hints.set("b", vec![target(2.0)]);
+        assert_ne!(hints.generation, generation);
+        assert_eq!(hints.targets().count(), 2);
+
+        let generation = hints.generation;
+        hints.clear("missing");
+        assert_eq!(hints.generation, generation);
+        hints.clear("a");
+        assert_eq!(
+            hints.targets().copied().collect::<Vec<_>>(),
+            vec![target(2.0)]
+        );
+    }
+
+    #[test]
+    fn test_lead_target_only_changes_a_step_at_a_time() {
+        let mut hints = PrefetchHints::default();
+        hints.set_lead(target(0.0), 25.0);
+        let generation = hints.generation;
+
+        // Creeping forward a frame at a time doesn't re-plan...
+        for x in 1..=25 {
+            hints.set_lead(target(f64::from(x)), 25.0);
+        }
+        assert_eq!(hints.generation, generation);
+        assert_eq!(
+            hints.targets().copied().collect::<Vec<_>>(),
+            vec![target(0.0)]
+        );
+
+        // ...until the target is a step from where it was last set.
+        hints.set_lead(target(26.0), 25.0);
+        assert_ne!(hints.generation, generation);
+        assert_eq!(
+            hints.targets().copied().collect::<Vec<_>>(),
+            vec![target(26.0)]
+        );
+    }
+
+    #[test]
+    fn test_byte_budget_caps_burst_and_repays_overdraft() {
+        let mut budget = ByteBudget::default();
+        assert!(!budget.can_spend());
+
+        // A long idle spell banks at most one second's worth.
+        budget.refill(1000.0, 10.0);
+        assert_eq!(budget.available, 1000.0);
+        assert!(budget.can_spend());
+
+        // A large fetch overdraws; nothing starts until it's repaid.
+        budget.spend(2500);
+        assert!(!budget.can_spend());
+        budget.refill(1000.0, 1.0);
+        assert!(!budget.can_spend());
+        budget.refill(1000.0, 1.0);
+        assert!(budget.can_spend());
+    }
+
+    #[test]
+    fn test_failed_bulks_back_off_and_are_forgotten() {
+        let tuning = LodTuning {
+            fetch_retry_secs: 2.0,
+            fetch_retry_max_secs: 120.0,
+            ..Default::default()
+        };
+        let mut prefetcher = Prefetcher::default();
+        let path = OctreePath::parse("0123").unwrap();
+        prefetcher.record_bulk_failure(path, 0.0, &tuning);
+        assert!(prefetcher.is_bulk_backed_off(&path, 0.0));
+        assert!(!prefetcher.is_bulk_backed_off(&path, tuning.fetch_retry_secs));
+
+        // A second failure in a row waits twice as long.
+        let again = tuning.fetch_retry_secs;
+        prefetcher.record_bulk_failure(path, again, &tuning);
+        assert!(prefetcher.is_bulk_backed_off(&path, again + 1.5 * tuning.fetch_retry_secs));
+        assert!(!prefetcher.is_bulk_backed_off(&path, again + 2.0 * tuning.fetch_retry_secs));
+
+        // Nothing retried it for a full maximum backoff: forgotten.
+        prefetcher.poll(
+            again + 2.0 * tuning.fetch_retry_secs + tuning.fetch_retry_max_secs,
+            &tuning,
+        );
+        assert!(prefetcher.failed_bulks.is_empty());
+    }
+
+    #[test]
+    fn test_hit_rate_counts_settled_nodes() {
+        let mut stats = PrefetchStats::default();
+        assert_eq!(stats.hit_rate(), None);
+        stats.used = 3;
+        stats.wasted = 1;
+        assert_eq!(stats.hit_rate(), Some(0.75));
+    }
+}
@@ -0,0 +1,311 @@
+//! Byte-budgeted residency for streamed terrain.
+//!
+//! The octree walk decides what each frame needs; residency decides what
+//! else stays loaded. Nodes a walk wanted within
+//! [`LodTuning::unload_grace_period_secs`](crate::lod::LodTuning::unload_grace_period_secs),
+//! nodes backing colliders, and their ancestors are always kept. Every other
+//! resident node stays for as long as the CPU and GPU budgets allow; once
+//! either is exceeded, [`plan_evictions`] drops the nodes worth least per
+//! byte of the over-budget pools. A node's worth is the screen-space error it
+//! would cover from where the camera is now, discounted by how long ago a
+//! walk last wanted it (see [`keep_value`]), so the nodes most likely to be
+//! needed again soonest go last.
+//!
+//! [`Residency`] tracks each node's bytes as they load: the decoded meshes
+//! cached for physics (CPU), each render mesh (CPU for its main-world copy,
+//! GPU for the upload), and each texture's page layer (GPU). Collider bytes
+//! are reported by the active reconcile through [`ColliderBytes`]; colliders
+//! are never evicted from here, but they count against the CPU budget.
+
+use std::{
+    collections::HashMap,
+    ops::{Add, AddAssign, SubAssign},
+};
+
+use bevy::prelude::*;
+use rocktree::Mesh as RocktreeMesh;
+use rocktree_decode::OctreePath;
+
+/// Bytes held in main memory and on the GPU.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct Footprint {
+    pub cpu: u64,
+    pub gpu: u64,
+}
+
+impl Footprint {
+    /// A budget of `cpu_mib` and `gpu_mib` mebibytes.
+    pub fn from_mib(cpu_mib: f64, gpu_mib: f64) -> Self {
+        let bytes = |mib: f64| (mib.max(0.0) * 1024.0 * 1024.0) as u64;
+        Self {
+            cpu: bytes(cpu_mib),
+            gpu: bytes(gpu_mib),
+        }
+    }
+
+    /// Whether either pool is past its share of `budget`.
+    pub fn exceeds(self, budget: Self) -> bool {
+        self.cpu > budget.cpu || self.gpu > budget.gpu
+    }
+}
+
+impl Add for Footprint {
+    type Output = Self;
+
+    fn add(self, other: Self) -> Self {
+        Self {
+            cpu: self.cpu + other.cpu,
+            gpu: self.gpu + other.gpu,
+        }
+    }
+}
+
+impl AddAssign for Footprint {
+    fn add_assign(&mut self, other: Self) {
+        *self = *self + other;
+    }
+}
+
+impl SubAssign for Footprint {
+    fn sub_assign(&mut self, other: Self) {
+        self.cpu = self.cpu.saturating_sub(other.cpu);
+        self.gpu = self.gpu.saturating_sub(other.gpu);
+    }
+}
+
+/// Bytes held by the live terrain colliders, counted against the CPU budget.
+/// Written by collider reconciles that track their builds; stays zero on
+/// those that don't.
+#[derive(Resource, Default, Clone, Copy, Debug)]
+pub struct ColliderBytes(pub u64);
+
+/// Residency counters for the diagnostics UI.
+#[derive(Clone, Copy, Debug, Default)]
+pub struct ResidencyStats {
+    /// Bytes of every resident node, colliders included.
+    pub used: Footprint,
+    /// The budgets in force this frame.
+    pub budget: Footprint,
+    /// Resident nodes kept only because the budgets had room.
+    pub optional: usize,
+    /// Nodes evicted for the budgets since startup.
+    pub evicted_total: u64,
+}
+
+/// Per-node byte accounting for everything the LoD keeps loaded.
+#[derive(Default)]
+pub(crate) struct Residency {
+    /// Decoded meshes of each node in `node_data`.
+    data: HashMap<OctreePath, u64>,
+    /// Render meshes and texture layers of each spawned node.
+    render: HashMap<OctreePath, Footprint>,
+    total: Footprint,
+    pub(crate) stats: ResidencyStats,
+}
+
+impl Residency {
+    /// Record a node's decoded meshes, replacing any earlier record.
+    pub(crate) fn insert_data(&mut self, path: OctreePath, meshes: &[RocktreeMesh]) {
+        self.remove_data(path);
+        let cpu = meshes.iter().map(decoded_mesh_bytes).sum();
+        self.data.insert(path, cpu);
+        self.total.cpu += cpu;
+    }
+
+    /// Add a spawned node's render meshes and texture layers.
+    pub(crate) fn add_render(&mut self, path: OctreePath, bytes: Footprint) {
+        *self.render.entry(path).or_default() += bytes;
+        self.total += bytes;
+    }
+
+    /// Forget a node's render assets, once despawned.
+    pub(crate) fn remove_render(&mut self, path: OctreePath) {
+        if let Some(bytes) = self.render.remove(&path) {
+            self.total -= bytes;
+        }
+    }
+
+    /// Forget a node's decoded meshes, once dropped from `node_data`.
+    pub(crate) fn remove_data(&mut self, path: OctreePath) {
+        if let Some(cpu) = self.data.remove(&path) {
+            self.total.cpu = self.total.cpu.saturating_sub(cpu);
+        }
+    }
+
+    /// Everything a node holds.
+    pub(crate) fn node(&self, path: &OctreePath) -> Footprint {
+        let data = self.data.get(path).copied().unwrap_or_default();
+        let render = self.render.get(path).copied().unwrap_or_default();
+        render + Footprint { cpu: data, gpu: 0 }
+    }
+
+    /// Everything every node holds.
+    pub(crate) fn total(&self) -> Footprint {
+        self.total
+    }
+}
+
+fn decoded_mesh_bytes(mesh: &RocktreeMesh) -> u64 {
+    (size_of_val(mesh.vertices.as_slice())
+        + size_of_val(mesh.indices.as_slice())
+        + size_of_val(mesh.normals.as_slice())) as u64
+}
+
+/// Vertex and index bytes of a render mesh: held once in the main world and
+/// once on the GPU, since tile meshes keep their main-world copy.
+pub(crate) fn render_mesh_bytes(mesh: &Mesh) -> u64 {
+    (mesh.get_vertex_buffer_size() + mesh.get_index_buffer_bytes().map_or(0, <[u8]>::len)) as u64
+}
+
+/// A resident node the budgets may evict.
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct Candidate {
+    pub path: OctreePath,
+    pub bytes: Footprint,
+    /// How much keeping the node is worth (see [`keep_value`]).
+    pub value: f64,
+}
+
+/// What keeping a node is worth: `sse_px`, the screen-space error (px) it
+/// would cover from the current camera, halved once it has gone
+/// `recency_secs` unwanted, and so on hyperbolically.
+pub(crate) fn keep_value(sse_px: f64, age_secs: f64, recency_secs: f64) -> f64 {
+    sse_px / (1.0 + age_secs.max(0.0) / recency_secs.max(1e-3))
+}
+
+/// Candidates to evict, in order, until `used` fits `budget`.
+///
+/// Each candidate's value is divided by the share of the over-budget pools'
+/// budgets it frees, and a parent scores at least as high as its best child,
+/// so children always go before their parents: a parent evicted under a
+/// resident child would leave the rest of its area uncovered on return.
+/// Candidates freeing nothing in an over-budget pool are never evicted.
+pub(crate) fn plan_evictions(
+    candidates: &[Candidate],
+    used: Footprint,
+    budget: Footprint,
+) -> Vec<OctreePath> {
+    if !used.exceeds(budget) {
+        return Vec::new();
+    }
+    let (cpu_over, gpu_over) = (used.cpu > budget.cpu, used.gpu > budget.gpu);
+    let share = |bytes: u64, pool: u64| bytes as f64 / pool.max(1) as f64;
+    let cost = |bytes: Footprint| {
+        let cpu = if cpu_over {
+            share(bytes.cpu, budget.cpu)
+        } else {
+            0.0
+        };
+        let gpu = if gpu_over {
+            share(bytes.gpu, budget.gpu)
+        } else {
+            0.0
+        };
+        cpu + gpu
+    };
+
+    let mut scores: Vec<f64> = candidates
+        .iter()
+        .map(|c| {
+            let cost = cost(c.bytes);
+            if cost > 0.0 {
+                c.value / cost
+            } else {
+                f64::INFINITY
+            }
+        })
+        .collect();
+    let mut order: Vec<usize> = (0..candidates.len()).collect();
+    order.sort_by_key(|&i| std::cmp::Reverse(candidates[i].path.depth()));
+    let index: HashMap<OctreePath, usize> = candidates
+        .iter()
+        .enumerate()
+        .map(|(i, c)| (c.path, i))
+        .collect();
+    // Deepest first, so a score climbs the whole chain of candidate parents.
+    for &i in &order {
+        if let Some(&parent) = candidates[i].path.parent().and_then(|p| index.get(&p)) {
+            scores[parent] = scores[parent].max(scores[i]);
+        }
+    }
+
+    // `order` is deepest-first, so the stable sort breaks ties child-first.
+    order.sort_by(|&a, &b| scores[a].total_cmp(&scores[b]));
+    let mut used = used;
+    let mut evicted = Vec::new();
+    for i in order {
+        if !used.exceeds(budget) {
+            break;
+        }
+        if scores[i].is_infinite() {
+            continue;
+        }
+        used -= candidates[i].bytes;
+        evicted.push(candidates[i].path);
+    }
+    evicted
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn path(s: &str) -> OctreePath {
+        OctreePath::parse(s).unwrap()
+    }
+
+    fn candidate(p: &str, cpu: u64, gpu: u64, value: f64) -> Candidate {
+        Candidate {
+            path: path(p),
+            bytes: Footprint { cpu, gpu },
+            value,
+        }
+    }
+
+    #[test]
+    fn nothing_is_evicted_within_budget() {
+        let candidates = [candidate("01", 10, 10, 1.0)];
+        let used = Footprint { cpu: 10, gpu: 10 };
+        assert!(plan_evictions(&candidates, used, used).is_empty());
+    }
+
+    #[test]
+    fn evicts_least_value_per_byte_until_under_budget() {
+        let candidates = [
+            candidate("01", 50, 0, 1.0),
+            candidate("02", 10, 0, 1.0),
+            candidate("03", 50, 0, 6.0),
+        ];
+        let used = Footprint { cpu: 200, gpu: 0 };
+        let budget = Footprint { cpu: 140, gpu: 0 };
+        // "01" is worth least per byte, but dropping it leaves 150 of 140,
+        // so the next least goes too.
+        assert_eq!(
+            plan_evictions(&candidates, used, budget),
+            [path("01"), path("02")]
+        );
+    }
+
+    #[test]
+    fn children_go_before_parents_and_free_pools_are_ignored() {
+        let candidates = [
+            candidate("0", 0, 10, 0.1),
+            candidate("01", 0, 10, 9.0),
+            // Frees only CPU, which is under budget.
+            candidate("2", 10, 0, 0.0),
+        ];
+        let used = Footprint { cpu: 10, gpu: 30 };
+        let budget = Footprint { cpu: 100, gpu: 5 };
+        assert_eq!(
+            plan_evictions(&candidates, used, budget),
+            [path("01"), path("0")]
+        );
+    }
+
+    #[test]
+    fn value_fades_with_time_unwanted() {
+        assert_eq!(keep_value(4.0, 0.0, 10.0), 4.0);
+        assert_eq!(keep_value(4.0, 10.0, 10.0), 2.0);
+        assert_eq!(keep_value(4.0, f64::INFINITY, 10.0), 0.0);
+    }
+}
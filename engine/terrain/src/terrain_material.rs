@@ -2,38 +2,93 @@
 //!
 //! Extends `StandardMaterial` with per-vertex octant masking to hide vertices
 //! in octants that have loaded children, enabling seamless LOD transitions.
+//!
+//! Terrain meshes use a compact 12-byte vertex instead of Bevy's standard
+//! attributes: the rocktree position and octant as `u8x4`, texcoords as
+//! `unorm16x2`, and an oct-encoded normal as `snorm16x2`. Indices are `u16`
+//! triangle lists.
+//!
+//! One material draws every tile whose texture shares a page of the
+//! [`TileTexturePool`](crate::tile_textures::TileTexturePool): what differs per tile (its octant mask and its
+//! texture's layer) travels in the tile's [`MeshTag`], part of the
+//! per-instance data Bevy already uploads. Tiles sharing a page share a
+//! bind group and batch (into multi-draw-indirect calls where the adapter
+//! supports them), and updating a mask touches no material asset.
+//!
+//! The material has its own prepass vertex shader, so terrain writes the
+//! depth prepass that occlusion culling builds its depth pyramid from (see
+//! [`crate::lod::LodTuning::occlusion_culling`]).
 
 use bevy::{
     asset::embedded_asset,
-    mesh::MeshVertexBufferLayoutRef,
+    mesh::{MeshTag, MeshVertexAttribute, MeshVertexBufferLayoutRef},
     pbr::{ExtendedMaterial, MaterialExtension, MaterialExtensionKey, MaterialExtensionPipeline},
     prelude::*,
     render::render_resource::{
-        AsBindGroup, RenderPipelineDescriptor, SpecializedMeshPipelineError,
+        AsBindGroup, RenderPipelineDescriptor, SpecializedMeshPipelineError, VertexFormat,
     },
-    shader::ShaderRef,
+    shader::{ShaderRef, load_shader_library},
 };
 
+use crate::tile_textures::TileTexturePlugin;
+
+/// Mesh-local position (`xyz`, 0-255) and octant index (`w`; 255 = never
+/// masked) of a terrain vertex, straight from the rocktree packed vertex.
+pub const ATTRIBUTE_TERRAIN_POSITION_OCTANT: MeshVertexAttribute =
+    MeshVertexAttribute::new("TerrainPositionOctant", 0x7e77_a100, VertexFormat::Uint8x4);
+
+/// Texcoords with the mesh's UV transform applied (see
+/// [`crate::mesh::convert_mesh`]).
+pub const ATTRIBUTE_TERRAIN_UV: MeshVertexAttribute =
+    MeshVertexAttribute::new("TerrainUv", 0x7e77_a101, VertexFormat::Unorm16x2);
+
+/// Octahedral-encoded unit normal (see [`crate::mesh::oct_encode`]).
+pub const ATTRIBUTE_TERRAIN_NORMAL: MeshVertexAttribute =
+    MeshVertexAttribute::new("TerrainNormal", 0x7e77_a102, VertexFormat::Snorm16x2);
+
 /// Plugin that registers the terrain material.
 pub struct TerrainMaterialPlugin;
 
 impl Plugin for TerrainMaterialPlugin {
     fn build(&self, app: &mut App) {
+        load_shader_library!(app, "terrain_vertex.wgsl");
         embedded_asset!(app, "terrain_material.wgsl");
-        app.add_plugins(MaterialPlugin::<TerrainMaterial>::default());
+        embedded_asset!(app, "terrain_prepass.wgsl");
+        app.add_plugins((
+            MaterialPlugin::<TerrainMaterial>::default(),
+            TileTexturePlugin,
+        ));
     }
 }
 
 /// Terrain material: StandardMaterial extended with octant masking.
 pub type TerrainMaterial = ExtendedMaterial<StandardMaterial, TerrainMaterialExtension>;
 
-/// Extension to StandardMaterial that adds octant masking for LOD transitions.
+/// Extension to StandardMaterial that adds octant masking for LOD transitions
+/// and samples the base colour from a page of tile textures.
 #[derive(Asset, AsBindGroup, TypePath, Debug, Clone, Default)]
 pub struct TerrainMaterialExtension {
-    /// Bitmask of octants to hide (bit `i` set = octant `i` has a loaded child).
-    /// Stored in `.x`; padded to 16 bytes for WebGL compatibility.
-    #[uniform(100)]
-    pub octant_mask: UVec4,
+    /// The page's texture array; each tile reads the layer in its tag.
+    #[texture(100, dimension = "2d_array")]
+    #[sampler(101)]
+    pub tiles: Handle<Image>,
+}
+
+/// The [`MeshTag`] of a terrain mesh: bits 0-7 are the octant mask (bit `i`
+/// set = octant `i` has a loaded child), the bits above are the layer of
+/// the mesh's texture in its page. Read by `terrain_material.wgsl`.
+pub fn tile_tag(layer: u16, octant_mask: u8) -> MeshTag {
+    MeshTag(u32::from(layer) << 8 | u32::from(octant_mask))
+}
+
+/// The octant mask in a [`tile_tag`].
+pub fn tile_tag_octant_mask(tag: &MeshTag) -> u8 {
+    tag.0 as u8
+}
+
+/// `tag` with its octant mask replaced by `octant_mask`.
+pub fn with_octant_mask(tag: &MeshTag, octant_mask: u8) -> MeshTag {
+    MeshTag(tag.0 & !0xff | u32::from(octant_mask))
 }
 
 impl MaterialExtension for TerrainMaterialExtension {
@@ -42,18 +97,43 @@ impl MaterialExtension for TerrainMaterialExtension {
     }
 
     fn fragment_shader() -> ShaderRef {
-        // Use the default PBR fragment shader.
-        ShaderRef::Default
+        "embedded://veldera_terrain/terrain_material.wgsl".into()
+    }
+
+    fn prepass_vertex_shader() -> ShaderRef {
+        "embedded://veldera_terrain/terrain_prepass.wgsl".into()
     }
 
     fn specialize(
         _pipeline: &MaterialExtensionPipeline,
         descriptor: &mut RenderPipelineDescriptor,
-        _layout: &MeshVertexBufferLayoutRef,
+        layout: &MeshVertexBufferLayoutRef,
         _key: MaterialExtensionKey<Self>,
     ) -> Result<(), SpecializedMeshPipelineError> {
         // Disable face culling: rocktree mesh winding may differ from Bevy's default.
         descriptor.primitive.cull_mode = None;
+
+        descriptor.vertex.buffers = vec![layout.0.get_layout(&[
+            ATTRIBUTE_TERRAIN_POSITION_OCTANT.at_shader_location(0),
+            ATTRIBUTE_TERRAIN_UV.at_shader_location(1),
+            ATTRIBUTE_TERRAIN_NORMAL.at_shader_location(2),
+        ])?];
+
+        // The mesh pipeline derives these from the standard attributes, which
+        // terrain meshes don't have; without them the PBR shaders would drop
+        // the normal and the UVs. The fragment stage reads the tile's
+        // texture layer from its tag.
+        for def in [
+            "VERTEX_NORMALS",
+            "VERTEX_UVS",
+            "VERTEX_UVS_A",
+            "VERTEX_OUTPUT_INSTANCE_INDEX",
+        ] {
+            descriptor.vertex.shader_defs.push(def.into());
+            if let Some(fragment) = descriptor.fragment.as_mut() {
+                fragment.shader_defs.push(def.into());
+            }
+        }
         Ok(())
     }
 }
@@ -1,32 +1,27 @@
 #import bevy_pbr::{
     pbr_fragment::pbr_input_from_standard_material,
-    pbr_functions::alpha_discard,
+    pbr_functions::{alpha_discard, apply_pbr_lighting, main_pass_post_lighting_processing},
     mesh_view_bindings::view,
-    forward_io::{Vertex, VertexOutput},
+    forward_io::{VertexOutput, FragmentOutput},
     mesh_functions,
     view_transformations::position_world_to_clip,
 }
+#import veldera_terrain::vertex::{TerrainVertex, oct_decode, octant_keep}
 
-// Octant mask uniform (binding 100 to avoid conflicts with StandardMaterial bindings).
-// Padded to vec4 for WebGL 16-byte uniform alignment.
-@group(#{MATERIAL_BIND_GROUP}) @binding(100) var<uniform> octant_mask: vec4<u32>;
+// The page of tile textures this material draws from (binding 100 to avoid
+// conflicts with StandardMaterial bindings); each tile samples its own layer.
+@group(#{MATERIAL_BIND_GROUP}) @binding(100) var tiles: texture_2d_array<f32>;
+@group(#{MATERIAL_BIND_GROUP}) @binding(101) var tiles_sampler: sampler;
 
 @vertex
-fn vertex(vertex: Vertex) -> VertexOutput {
+fn vertex(vertex: TerrainVertex) -> VertexOutput {
     var out: VertexOutput;
 
     let world_from_local = mesh_functions::get_world_from_local(vertex.instance_index);
 
-    // Per-vertex octant masking: the octant index (0-7) is stored in vertex color R.
-    // If the corresponding bit is set in octant_mask, collapse the vertex to the
-    // origin so the triangle degenerates and is not rasterized.
-    // Vertices with octant >= 8 (e.g. sentinel value 255) are never masked.
-    let octant = u32(vertex.color.r + 0.5);
-    let is_masked = (octant_mask.x >> octant) & 1u;
-    let mask = select(1.0, 0.0, is_masked != 0u);
-
-    // Apply mask to position - masked vertices collapse to local origin.
-    let masked_position = vertex.position * mask;
+    // Masked vertices collapse to the local origin; see `octant_keep`.
+    let mask = octant_keep(vertex);
+    let masked_position = vec3<f32>(vertex.position_octant.xyz) * mask;
 
     out.world_position = mesh_functions::mesh_position_local_to_world(
         world_from_local, vec4(masked_position, 1.0));
@@ -35,37 +30,34 @@ fn vertex(vertex: Vertex) -> VertexOutput {
     // Transform normal to world space for lighting.
 #ifdef VERTEX_NORMALS
     out.world_normal = mesh_functions::mesh_normal_local_to_world(
-        vertex.normal,
+        oct_decode(vertex.normal),
         vertex.instance_index
     );
 #endif
 
-    // Pass through UVs (masked vertices get zero UVs).
+    // Masked vertices get zero UVs.
 #ifdef VERTEX_UVS_A
     out.uv = vertex.uv * mask;
 #endif
 
-#ifdef VERTEX_UVS_B
-    out.uv_b = vertex.uv_b * mask;
+#ifdef VERTEX_OUTPUT_INSTANCE_INDEX
+    out.instance_index = vertex.instance_index;
 #endif
 
-#ifdef VERTEX_TANGENTS
-    out.world_tangent = mesh_functions::mesh_tangent_local_to_world(
-        world_from_local,
-        vertex.tangent,
-        vertex.instance_index
-    );
-#endif
+    return out;
+}
 
-#ifdef VERTEX_COLORS
-    // Override vertex color to white - the red channel contains octant data,
-    // not actual color. We've already used it for masking above.
-    out.color = vec4(1.0, 1.0, 1.0, 1.0);
-#endif
+@fragment
+fn fragment(in: VertexOutput, @builtin(front_facing) is_front: bool) -> FragmentOutput {
+    var pbr_input = pbr_input_from_standard_material(in, is_front);
 
-#ifdef VERTEX_OUTPUT_INSTANCE_INDEX
-    out.instance_index = vertex.instance_index;
-#endif
+    // The tile's layer in the page sits above the octant mask in its tag.
+    let layer = mesh_functions::get_tag(in.instance_index) >> 8u;
+    pbr_input.material.base_color *= textureSample(tiles, tiles_sampler, in.uv, layer);
+    pbr_input.material.base_color = alpha_discard(pbr_input.material, pbr_input.material.base_color);
 
+    var out: FragmentOutput;
+    out.color = apply_pbr_lighting(pbr_input);
+    out.color = main_pass_post_lighting_processing(pbr_input, out.color);
     return out;
 }
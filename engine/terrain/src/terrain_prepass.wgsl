@@ -0,0 +1,51 @@
+#import bevy_pbr::{
+    prepass_io::VertexOutput,
+    mesh_functions,
+    view_transformations::position_world_to_clip,
+}
+#import veldera_terrain::vertex::{TerrainVertex, oct_decode, octant_keep}
+
+// Prepass (depth, and normals or motion vectors when a camera asks for them)
+// for the compact terrain vertex. Without it terrain would be missing from
+// the depth prepass, and with it from the depth pyramid occlusion culling
+// tests against.
+@vertex
+fn vertex(vertex: TerrainVertex) -> VertexOutput {
+    var out: VertexOutput;
+
+    let world_from_local = mesh_functions::get_world_from_local(vertex.instance_index);
+    let keep = octant_keep(vertex);
+    let local_position = vec4(vec3<f32>(vertex.position_octant.xyz) * keep, 1.0);
+
+    out.world_position = mesh_functions::mesh_position_local_to_world(
+        world_from_local, local_position);
+    out.position = position_world_to_clip(out.world_position.xyz);
+#ifdef UNCLIPPED_DEPTH_ORTHO_EMULATION
+    out.unclipped_depth = out.position.z;
+    out.position.z = min(out.position.z, 1.0);
+#endif
+
+#ifdef VERTEX_UVS_A
+    out.uv = vertex.uv * keep;
+#endif
+
+#ifdef NORMAL_PREPASS_OR_DEFERRED_PREPASS
+    out.world_normal = mesh_functions::mesh_normal_local_to_world(
+        oct_decode(vertex.normal),
+        vertex.instance_index
+    );
+#endif
+
+#ifdef MOTION_VECTOR_PREPASS
+    let previous_world_from_local =
+        mesh_functions::get_previous_world_from_local(vertex.instance_index);
+    out.previous_world_position = mesh_functions::mesh_position_local_to_world(
+        previous_world_from_local, local_position);
+#endif
+
+#ifdef VERTEX_OUTPUT_INSTANCE_INDEX
+    out.instance_index = vertex.instance_index;
+#endif
+
+    return out;
+}
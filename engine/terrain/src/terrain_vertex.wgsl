@@ -0,0 +1,37 @@
+#define_import_path veldera_terrain::vertex
+
+#import bevy_pbr::mesh_functions
+
+// Compact terrain vertex (12 bytes); see `terrain_material.rs`.
+struct TerrainVertex {
+    @builtin(instance_index) instance_index: u32,
+    // Mesh-local position (0-255) in xyz, octant index in w.
+    @location(0) position_octant: vec4<u32>,
+    // Texcoords, UV transform already applied.
+    @location(1) uv: vec2<f32>,
+    // Octahedral-encoded normal.
+    @location(2) normal: vec2<f32>,
+};
+
+// Decode an octahedral-encoded unit vector.
+fn oct_decode(e: vec2<f32>) -> vec3<f32> {
+    var n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    let t = max(-n.z, 0.0);
+    n.x += select(t, -t, n.x >= 0.0);
+    n.y += select(t, -t, n.y >= 0.0);
+    return normalize(n);
+}
+
+// Per-vertex octant masking: 0.0 if the bit for the vertex's octant (0-7) is
+// set in the octant mask (the low byte of the mesh tag), else 1.0. Scaling
+// the position by it collapses the vertex to the origin, so the triangle
+// degenerates and is not rasterized. Vertices with octant >= 8 (e.g. sentinel
+// value 255) are never masked: the shift wraps to a bit above the mask.
+//
+// Shared by the main and prepass vertex shaders so depth, and the occlusion
+// culling built from it, sees exactly the triangles the main pass draws.
+fn octant_keep(vertex: TerrainVertex) -> f32 {
+    let octant_mask = mesh_functions::get_tag(vertex.instance_index) & 0xffu;
+    let is_masked = (octant_mask >> vertex.position_octant.w) & 1u;
+    return select(1.0, 0.0, is_masked != 0u);
+}
@@ -0,0 +1,538 @@
+//! Pooled tile textures, so terrain meshes can share materials.
+//!
+//! Giving every rocktree mesh its own `Image` and material made every tile
+//! its own draw with its own bind group. [`TileTexturePool`] instead packs
+//! tile textures into the layers of a few texture arrays ("pages"), one per
+//! format and size as needed, with one [`TerrainMaterial`] per page. A tile
+//! finds its layer through its [`tile_tag`](crate::terrain_material::tile_tag),
+//! so every tile on a page draws with the same bind group; the vertex and
+//! index data of the meshes already share slabs in Bevy's mesh allocator.
+//!
+//! Pages are allocated uninitialised. A tile's texels are written straight
+//! into its layer by the render world instead of through the page's `Image`
+//! asset, since changing the asset would re-upload the whole page.
+//!
+//! Tile textures arrive with their mip chains, and pages hold whole chains
+//! and sample them trilinearly. A tile far enough away that its top levels
+//! would never be sampled can leave them out ([`TileTexturePool::insert`]'s
+//! `dropped_levels`): it goes to a page of the next level's size, a quarter
+//! of the memory per level dropped.
+//!
+//! A page is allocated whole, so a format only a few tiles use would
+//! otherwise hold a full page of idle layers. Pages of a format instead grow:
+//! the first holds [`FIRST_PAGE_LAYERS`], and each further one twice as many
+//! as the last, up to the configured page size. A page whose last tile is
+//! released is freed.
+
+use bevy::{
+    asset::RenderAssetUsages,
+    image::ImageSampler,
+    prelude::*,
+    render::{
+        ExtractSchedule, MainWorld, Render, RenderApp, RenderSystems,
+        render_asset::RenderAssets,
+        render_resource::{
+            Extent3d, Origin3d, TexelCopyBufferLayout, TexelCopyTextureInfo, TextureAspect,
+            TextureDimension, TextureFormat, TextureViewDescriptor, TextureViewDimension,
+        },
+        renderer::RenderQueue,
+        texture::GpuImage,
+    },
+};
+
+use crate::terrain_material::{TerrainMaterial, TerrainMaterialExtension};
+
+/// Most layers a page holds: the array-layer limit every backend guarantees,
+/// WebGL 2 included.
+pub const MAX_PAGE_LAYERS: u16 = 256;
+
+/// Layers of the first page of a format; see the [module docs](self).
+pub const FIRST_PAGE_LAYERS: u16 = 8;
+
+/// Registers the [`TileTexturePool`] and the render-world upload of its
+/// texels. Added by [`TerrainMaterialPlugin`](crate::terrain_material::TerrainMaterialPlugin).
+pub struct TileTexturePlugin;
+
+impl Plugin for TileTexturePlugin {
+    fn build(&self, app: &mut App) {
+        app.init_resource::<TileTexturePool>();
+        let Some(render_app) = app.get_sub_app_mut(RenderApp) else {
+            return;
+        };
+        render_app
+            .init_resource::<PendingTileUploads>()
+            .add_systems(ExtractSchedule, extract_tile_uploads)
+            .add_systems(
+                Render,
+                write_tile_uploads.in_set(RenderSystems::PrepareResources),
+            );
+    }
+}
+
+/// Where a tile's texture lives in the [`TileTexturePool`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct TileSlot {
+    page: u32,
+    /// The texture's layer in its page.
+    pub layer: u16,
+    /// Top mip levels of the texture left out of its layer.
+    pub dropped_levels: u32,
+}
+
+/// The texture arrays holding every spawned tile's texture.
+#[derive(Resource, Default)]
+pub struct TileTexturePool {
+    /// Indexed by [`TileSlot::page`]; freed pages leave a hole for the next.
+    pages: Vec<Option<Page>>,
+    /// Texels waiting to be written into their layers; moved to the render
+    /// world every extract.
+    uploads: Vec<TileUpload>,
+    /// Images of pages freed since the last extract, whose uploads still
+    /// queued in the render world are dropped.
+    freed: Vec<AssetId<Image>>,
+}
+
+/// One texture array and the material drawing from it.
+struct Page {
+    format: PageFormat,
+    image: Handle<Image>,
+    material: Handle<TerrainMaterial>,
+    layers: u16,
+    /// Layers handed out so far; those below it are in use unless in `free`.
+    used: u16,
+    /// Released layers, reused before new ones.
+    free: Vec<u16>,
+}
+
+/// What tiles must share to share a page.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+struct PageFormat {
+    format: TextureFormat,
+    /// Size of the top level held.
+    width: u32,
+    height: u32,
+    mip_levels: u32,
+}
+
+/// One tile's texels bound for their layer.
+struct TileUpload {
+    page: AssetId<Image>,
+    layer: u32,
+    format: PageFormat,
+    data: Vec<u8>,
+}
+
+impl TileTexturePool {
+    /// Store a tile's texture in a free layer, less its first
+    /// `dropped_levels` mip levels (always keeping the last), opening a page
+    /// when every page of its format and size is full. Pages of a format
+    /// grow from [`FIRST_PAGE_LAYERS`] to `page_layers` (at most
+    /// [`MAX_PAGE_LAYERS`]). Returns the layer and the material
+    /// drawing from its page; [`Self::release`] the slot when the tile
+    /// despawns.
+    pub fn insert(
+        &mut self,
+        texture: Image,
+        dropped_levels: u32,
+        page_layers: u16,
+        images: &mut Assets<Image>,
+        materials: &mut Assets<TerrainMaterial>,
+    ) -> (TileSlot, Handle<TerrainMaterial>) {
+        let full = PageFormat {
+            format: texture.texture_descriptor.format,
+            width: texture.width(),
+            height: texture.height(),
+            mip_levels: texture.texture_descriptor.mip_level_count.max(1),
+        };
+        let dropped = dropped_levels.min(full.mip_levels - 1);
+        let format = PageFormat {
+            width: (full.width >> dropped).max(1),
+            height: (full.height >> dropped).max(1),
+            mip_levels: full.mip_levels - dropped,
+            ..full
+        };
+        let index = match self.pages.iter().position(|page| {
+            page.as_ref()
+                .is_some_and(|page| page.format == format && page.has_room())
+        }) {
+            Some(index) => index,
+            None => {
+                let siblings = self.pages().filter(|page| page.format == format).count();
+                let layers = (u32::from(FIRST_PAGE_LAYERS) << siblings.min(16))
+                    .min(u32::from(page_layers)) as u16;
+                let page = Some(Page::new(format, layers, images, materials));
+                match self.pages.iter().position(Option::is_none) {
+                    Some(hole) => {
+                        self.pages[hole] = page;
+                        hole
+                    }
+                    None => {
+                        self.pages.push(page);
+                        self.pages.len() - 1
+                    }
+                }
+            }
+        };
+        let page = self.pages[index].as_mut().expect("found or opened above");
+        let layer = page.free.pop().unwrap_or_else(|| {
+            page.used += 1;
+            page.used - 1
+        });
+        if let Some(mut data) = texture.data {
+            let skipped: u64 = (0..dropped).map(|level| full.level_bytes(level)).sum();
+            data.drain(..(skipped as usize).min(data.len()));
+            self.uploads.push(TileUpload {
+                page: page.image.id(),
+                layer: u32::from(layer),
+                format,
+                data,
+            });
+        }
+        (
+            TileSlot {
+                page: index as u32,
+                layer,
+                dropped_levels: dropped,
+            },
+            page.material.clone(),
+        )
+    }
+
+    /// Free a slot from [`Self::insert`] for the next tile, and its page
+    /// once no tile is left on it.
+    pub fn release(&mut self, slot: TileSlot) {
+        let entry = &mut self.pages[slot.page as usize];
+        let page = entry.as_mut().expect("slot of a live page");
+        page.free.push(slot.layer);
+        if page.free.len() == usize::from(page.used) {
+            let id = page.image.id();
+            *entry = None;
+            self.uploads.retain(|upload| upload.page != id);
+            self.freed.push(id);
+        }
+    }
+
+    /// Bytes of the layer a slot holds.
+    pub fn slot_bytes(&self, slot: TileSlot) -> u64 {
+        self.page(slot).format.layer_bytes()
+    }
+
+    /// Pages allocated, and layers in use across them.
+    pub fn usage(&self) -> (usize, usize) {
+        let layers = self
+            .pages()
+            .map(|page| usize::from(page.used) - page.free.len())
+            .sum();
+        (self.pages().count(), layers)
+    }
+
+    /// Bytes of texels in allocated layers no tile holds: free-listed
+    /// layers, and those of a page's capacity not yet handed out.
+    pub fn idle_bytes(&self) -> u64 {
+        self.pages()
+            .map(|page| {
+                let idle = u64::from(page.layers) - u64::from(page.used) + page.free.len() as u64;
+                page.format.layer_bytes() * idle
+            })
+            .sum()
+    }
+
+    /// Bytes of texels across every allocated page, used layers or not.
+    pub fn allocated_bytes(&self) -> u64 {
+        self.pages()
+            .map(|page| page.format.layer_bytes() * u64::from(page.layers))
+            .sum()
+    }
+
+    fn pages(&self) -> impl Iterator<Item = &Page> {
+        self.pages.iter().flatten()
+    }
+
+    fn page(&self, slot: TileSlot) -> &Page {
+        self.pages[slot.page as usize]
+            .as_ref()
+            .expect("slot of a live page")
+    }
+}
+
+impl PageFormat {
+    /// Size of a mip level, in texels.
+    fn level_size(&self, level: u32) -> (u32, u32) {
+        ((self.width >> level).max(1), (self.height >> level).max(1))
+    }
+
+    /// Bytes per row of blocks and rows of blocks of a mip level.
+    fn level_rows(&self, level: u32) -> (u32, u32) {
+        let (width, height) = self.level_size(level);
+        let (block_width, block_height) = self.format.block_dimensions();
+        let block_size = self.format.block_copy_size(None).unwrap_or(4);
+        (
+            width.div_ceil(block_width) * block_size,
+            height.div_ceil(block_height),
+        )
+    }
+
+    /// Bytes of a mip level's texels.
+    fn level_bytes(&self, level: u32) -> u64 {
+        let (bytes_per_row, rows) = self.level_rows(level);
+        u64::from(bytes_per_row) * u64::from(rows)
+    }
+
+    /// Bytes of one layer's texels, every mip level included.
+    fn layer_bytes(&self) -> u64 {
+        (0..self.mip_levels)
+            .map(|level| self.level_bytes(level))
+            .sum()
+    }
+}
+
+impl Page {
+    fn new(
+        format: PageFormat,
+        layers: u16,
+        images: &mut Assets<Image>,
+        materials: &mut Assets<TerrainMaterial>,
+    ) -> Self {
+        let layers = layers.clamp(1, MAX_PAGE_LAYERS);
+        let mut image = Image::new_uninit(
+            Extent3d {
+                width: format.width,
+                height: format.height,
+                depth_or_array_layers: u32::from(layers),
+            },
+            TextureDimension::D2,
+            format.format,
+            // Kept in the main world too: a render-world-only image without
+            // data would never be prepared.
+            RenderAssetUsages::default(),
+        );
+        image.texture_descriptor.mip_level_count = format.mip_levels;
+        // Trilinear, so distant tiles read their small levels.
+        image.sampler = ImageSampler::linear();
+        // A one-layer page would otherwise get a plain 2D view.
+        image.texture_view_descriptor = Some(TextureViewDescriptor {
+            dimension: Some(TextureViewDimension::D2Array),
+            ..default()
+        });
+        let image = images.add(image);
+        let material = materials.add(TerrainMaterial {
+            base: StandardMaterial {
+                // Disable specular reflections for terrain.
+                reflectance: 0.0,
+                ..default()
+            },
+            extension: TerrainMaterialExtension {
+                tiles: image.clone(),
+            },
+        });
+        Self {
+            format,
+            image,
+            material,
+            layers,
+            used: 0,
+            free: Vec::new(),
+        }
+    }
+
+    fn has_room(&self) -> bool {
+        !self.free.is_empty() || self.used < self.layers
+    }
+}
+
+/// Render-world queue of uploads whose page isn't on the GPU yet.
+#[derive(Resource, Default)]
+struct PendingTileUploads(Vec<TileUpload>);
+
+fn extract_tile_uploads(
+    mut main_world: ResMut<MainWorld>,
+    mut pending: ResMut<PendingTileUploads>,
+) {
+    let Some(mut pool) = main_world.get_resource_mut::<TileTexturePool>() else {
+        return;
+    };
+    // A freed page will never be prepared, so its uploads would block every
+    // later one.
+    if !pool.freed.is_empty() {
+        let freed = std::mem::take(&mut pool.freed);
+        pending.0.retain(|upload| !freed.contains(&upload.page));
+    }
+    if !pool.uploads.is_empty() {
+        pending.0.append(&mut pool.uploads);
+    }
+}
+
+/// Write queued texels into their layers, in the order they were queued, so
+/// a reused layer ends up with its latest tile.
+fn write_tile_uploads(
+    mut pending: ResMut<PendingTileUploads>,
+    gpu_images: Res<RenderAssets<GpuImage>>,
+    queue: Res<RenderQueue>,
+) {
+    let mut blocked = false;
+    pending.0.retain(|upload| {
+        // A page added this frame may not be prepared yet; later uploads wait
+        // with it to keep the order.
+        let page = gpu_images.get(upload.page).filter(|_| !blocked);
+        let Some(page) = page else {
+            blocked = true;
+            return true;
+        };
+        let format = upload.format;
+        if (upload.data.len() as u64) < format.layer_bytes() {
+            tracing::warn!(
+                "Terrain tile texture has {} bytes, expected {} for {}x{} {:?} with {} mip(s)",
+                upload.data.len(),
+                format.layer_bytes(),
+                format.width,
+                format.height,
+                format.format,
+                format.mip_levels,
+            );
+            return false;
+        }
+        let (block_width, block_height) = format.format.block_dimensions();
+        let mut offset = 0;
+        for level in 0..format.mip_levels {
+            let (width, height) = format.level_size(level);
+            let (bytes_per_row, rows) = format.level_rows(level);
+            let len = (bytes_per_row * rows) as usize;
+            queue.write_texture(
+                TexelCopyTextureInfo {
+                    texture: &page.texture,
+                    mip_level: level,
+                    origin: Origin3d {
+                        x: 0,
+                        y: 0,
+                        z: upload.layer,
+                    },
+                    aspect: TextureAspect::All,
+                },
+                &upload.data[offset..offset + len],
+                TexelCopyBufferLayout {
+                    offset: 0,
+                    bytes_per_row: Some(bytes_per_row),
+                    rows_per_image: Some(rows),
+                },
+                // Block formats copy whole blocks, even past a small level's
+                // edge.
+                Extent3d {
+                    width: width.next_multiple_of(block_width),
+                    height: height.next_multiple_of(block_height),
+                    depth_or_array_layers: 1,
+                },
+            );
+            offset += len;
+        }
+        false
+    });
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn texture(size: u32) -> Image {
+        Image::new_fill(
+            Extent3d {
+                width: size,
+                height: size,
+                depth_or_array_layers: 1,
+            },
+            TextureDimension::D2,
+            &[255; 4],
+            TextureFormat::Rgba8UnormSrgb,
+            RenderAssetUsages::default(),
+        )
+    }
+
+    #[test]
+    fn tiles_share_pages_by_format_and_reuse_released_layers() {
+        let mut pool = TileTexturePool::default();
+        let mut images = Assets::<Image>::default();
+        let mut materials = Assets::<TerrainMaterial>::default();
+        let mut insert = |pool: &mut TileTexturePool, size| {
+            pool.insert(texture(size), 0, 2, &mut images, &mut materials)
+        };
+
+        let (a, material_a) = insert(&mut pool, 256);
+        let (b, material_b) = insert(&mut pool, 256);
+        assert_eq!(material_a, material_b);
+        assert_ne!(a.layer, b.layer);
+
+        // A full page and a different size each open a new page.
+        let (_, material_c) = insert(&mut pool, 256);
+        let (_, material_d) = insert(&mut pool, 128);
+        assert_ne!(material_c, material_a);
+        assert_ne!(material_d, material_c);
+        assert_eq!(pool.usage(), (3, 4));
+        // The second 256 page and the 128 page each have a layer to spare.
+        let layer_256 = 256 * 256 * 4;
+        assert_eq!(pool.idle_bytes(), layer_256 + 128 * 128 * 4);
+
+        pool.release(a);
+        assert_eq!(pool.idle_bytes(), 2 * layer_256 + 128 * 128 * 4);
+        let (e, material_e) = insert(&mut pool, 256);
+        assert_eq!((e, material_e), (a, material_a));
+        assert_eq!(pool.usage(), (3, 4));
+        assert_eq!(pool.uploads.len(), 5);
+    }
+
+    #[test]
+    fn pages_grow_per_format_and_are_freed_once_empty() {
+        let mut pool = TileTexturePool::default();
+        let mut images = Assets::<Image>::default();
+        let mut materials = Assets::<TerrainMaterial>::default();
+        let layer = 32 * 32 * 4;
+        let slots: Vec<TileSlot> = (0..=FIRST_PAGE_LAYERS)
+            .map(|_| {
+                pool.insert(texture(32), 0, 64, &mut images, &mut materials)
+                    .0
+            })
+            .collect();
+        // A full first page, then one twice its size.
+        assert_eq!(pool.usage(), (2, usize::from(FIRST_PAGE_LAYERS) + 1));
+        assert_eq!(
+            pool.allocated_bytes(),
+            3 * u64::from(FIRST_PAGE_LAYERS) * layer
+        );
+
+        // Releasing the second page's only tile frees it, upload and all.
+        let last = *slots.last().unwrap();
+        pool.release(last);
+        assert_eq!(pool.usage(), (1, usize::from(FIRST_PAGE_LAYERS)));
+        assert_eq!(pool.allocated_bytes(), u64::from(FIRST_PAGE_LAYERS) * layer);
+        assert_eq!(pool.uploads.len(), usize::from(FIRST_PAGE_LAYERS));
+        assert_eq!(pool.freed.len(), 1);
+
+        // The next page takes the freed one's place.
+        let (slot, _) = pool.insert(texture(32), 0, 64, &mut images, &mut materials);
+        assert_eq!(slot.page, last.page);
+        assert_eq!(
+            pool.allocated_bytes(),
+            3 * u64::from(FIRST_PAGE_LAYERS) * layer
+        );
+    }
+
+    #[test]
+    fn dropped_levels_move_tiles_to_smaller_pages() {
+        let mut pool = TileTexturePool::default();
+        let mut images = Assets::<Image>::default();
+        let mut materials = Assets::<TerrainMaterial>::default();
+        // An 8x8 chain: 8, 4, 2 and 1 texels square.
+        let mut chained = texture(8);
+        chained.texture_descriptor.mip_level_count = 4;
+        chained.data = Some(vec![0; (64 + 16 + 4 + 1) * 4]);
+
+        let (slot, _) = pool.insert(chained.clone(), 2, 2, &mut images, &mut materials);
+        assert_eq!(slot.dropped_levels, 2);
+        assert_eq!(pool.slot_bytes(slot), (4 + 1) * 4);
+        assert_eq!(pool.uploads[0].data.len(), (4 + 1) * 4);
+
+        // The last level always stays.
+        let (slot, _) = pool.insert(chained, 9, 2, &mut images, &mut materials);
+        assert_eq!(slot.dropped_levels, 3);
+        assert_eq!(pool.slot_bytes(slot), 4);
+        assert_eq!(pool.usage(), (2, 2));
+    }
+}
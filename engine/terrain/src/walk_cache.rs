@@ -0,0 +1,680 @@
+//! Frame-to-frame reuse of the LoD octree walk.
+//!
+//! The walk in [`crate::lod`] visits thousands of nodes, and most of its
+//! decisions are the same from one frame to the next: a small camera motion
+//! flips the refinement of a handful of nodes on the refine/collapse front,
+//! and a completed load changes the inputs of one subtree. [`WalkCache`]
+//! memoises every recursive call of the walk, so the next walk only
+//! re-evaluates the calls whose outcome could have changed and replays the
+//! outputs of the rest.
+//!
+//! A call's memo is reusable when three things hold:
+//!
+//! - **Same inherited arguments.** The parent passed the same bulk key,
+//!   physics fallback ancestor and commit flags ([`WalkArgs`]).
+//! - **No state change below it.** Nothing under the call's path changed
+//!   load state (loaded, in flight, queued, node data, bulk availability)
+//!   since it was evaluated. The LoD systems report every such change
+//!   through [`WalkDirty`].
+//! - **The camera hasn't moved far enough to flip a decision.** Every
+//!   decision in the subtree (frustum test, screen-space error, retention
+//!   radius, physics band) contributes a margin when evaluated, and the
+//!   subtree's [`Slack`] bounds the camera translation and rotation it
+//!   tolerates. A reused subtree's slack is charged for the motion since it
+//!   was evaluated, so drift across many small steps is caught too.
+//!
+//! Outputs are logged as [`WalkEvent`]s. Each memo holds its call's outputs
+//! and its child calls' memos in visit order, behind an [`Arc`], so replaying
+//! a subtree shares the previous walk's memo instead of copying it: a walk
+//! costs the calls it re-evaluates, and only the memos they replace are
+//! dropped. The same property lets subtrees be walked concurrently, each into
+//! its own [`WalkLog`], and spliced in afterwards.
+
+use std::{collections::HashSet, sync::Arc};
+
+use glam::{DQuat, DVec3};
+use rocktree::NodeMetadata;
+use rocktree_decode::{OctreePath, OrientedBoundingBox};
+
+/// One output of the walk. Folded into the render and physics results after
+/// the walk; logged rather than written directly so a subtree's outputs can
+/// be replayed on a later frame.
+#[derive(Clone, Debug)]
+pub(crate) enum WalkEvent {
+    /// The render rule found this node visible; caches its OBB.
+    RenderVisible(OctreePath, OrientedBoundingBox),
+    /// The render rule refines into this node.
+    RenderRefine(OctreePath),
+    /// The render rule wants this node's data.
+    RenderLoad(NodeMetadata),
+    /// The node is within physics range; joins the physics potential set.
+    PhysicsNode(OctreePath, OrientedBoundingBox),
+    /// The physics rule wants this node's data.
+    PhysicsLoad(NodeMetadata),
+    /// The walk passed through this bulk.
+    Bulk(OctreePath),
+    /// The walk needs this bulk, which isn't cached yet.
+    BulkLoad(OctreePath, u32),
+    /// A collider commit with its octant-coverage mask.
+    Commit(OctreePath, u8),
+    /// An in-range region with no loaded collider data on its chain.
+    Uncovered(OctreePath),
+}
+
+/// Arguments a walk call inherits from its parent. A memo applies only to a
+/// call with identical arguments.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub(crate) struct WalkArgs {
+    pub bulk_key: OctreePath,
+    pub physics_best_ancestor: Option<OctreePath>,
+    pub physics_committed_above: bool,
+    pub physics_chain_requested: bool,
+}
+
+/// The camera pose a walk evaluated its decisions at.
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct WalkPose {
+    pub camera: DVec3,
+    pub rotation: DQuat,
+    pub lead: DVec3,
+}
+
+impl WalkPose {
+    /// Translation (m, camera plus lead) and rotation (rad) from `earlier`.
+    fn motion_since(&self, earlier: &Self) -> (f64, f64) {
+        let distance = self.camera.distance(earlier.camera) + self.lead.distance(earlier.lead);
+        let angle = self.rotation.angle_between(earlier.rotation);
+        (distance, angle)
+    }
+}
+
+/// Inputs shared by every decision in a walk. Any change invalidates all
+/// memos, since the margins don't account for them.
+#[derive(Clone, Debug, PartialEq)]
+pub(crate) struct WalkGlobals {
+    pub keep_loaded_radius: f64,
+    pub is_low_altitude: bool,
+    pub pixels_per_meter: f64,
+    pub error_threshold: f64,
+    pub physics_bands: Vec<(f64, usize)>,
+    pub wysiwyg_radius: f64,
+    /// Perspective field of view, aspect ratio, near and far planes.
+    pub projection: [f32; 4],
+}
+
+/// How far the camera can move before a decision under a memo could flip.
+///
+/// A decision with distance margin `m` at reach `r` from the camera survives
+/// a translation `d` and rotation `a` while `d + r·a <= m`. Every decision
+/// in a subtree holds while `d / distance + a / angle <= 1` with `distance`
+/// the smallest margin and `angle` the smallest margin-to-reach ratio, so two
+/// numbers bound a whole subtree.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub(crate) struct Slack {
+    distance: f64,
+    angle: f64,
+}
+
+impl Slack {
+    /// No decisions yet: any motion is tolerated.
+    pub(crate) const UNBOUNDED: Self = Self {
+        distance: f64::INFINITY,
+        angle: f64::INFINITY,
+    };
+
+    /// Add a decision that depends only on the camera's position.
+    pub(crate) fn bound_distance(&mut self, margin: f64) {
+        self.distance = self.distance.min(margin);
+    }
+
+    /// Add a decision that also depends on the view direction: a frustum test
+    /// with `margin` on a box reaching `reach` metres from the camera.
+    pub(crate) fn bound_view(&mut self, margin: f64, reach: f64) {
+        self.distance = self.distance.min(margin);
+        self.angle = self.angle.min(margin / reach.max(f64::MIN_POSITIVE));
+    }
+
+    /// Combine with a child's slack.
+    pub(crate) fn merge(&mut self, other: Self) {
+        self.distance = self.distance.min(other.distance);
+        self.angle = self.angle.min(other.angle);
+    }
+
+    /// What is left after a translation `distance` and rotation `angle`, or
+    /// `None` if some decision may have flipped.
+    fn after(self, distance: f64, angle: f64) -> Option<Self> {
+        fn ratio(moved: f64, slack: f64) -> f64 {
+            // Exactly zero motion keeps even zero-slack decisions valid.
+            if moved == 0.0 { 0.0 } else { moved / slack }
+        }
+        // Unbounded stays unbounded (and `inf * 0` would be NaN).
+        fn scale(slack: f64, left: f64) -> f64 {
+            if slack.is_infinite() {
+                slack
+            } else {
+                slack * left
+            }
+        }
+        let left = 1.0 - ratio(distance, self.distance) - ratio(angle, self.angle);
+        (left >= 0.0).then_some(Self {
+            distance: scale(self.distance, left),
+            angle: scale(self.angle, left),
+        })
+    }
+}
+
+/// State changes since the last walk that may change its decisions, reported
+/// by the LoD systems as they happen.
+#[derive(Default, Debug)]
+pub(crate) struct WalkDirty {
+    /// Nodes or bulks whose load state changed.
+    paths: Vec<OctreePath>,
+    /// Bulks inserted or evicted, whose nodes every call inside them reads.
+    bulks: Vec<OctreePath>,
+}
+
+impl WalkDirty {
+    /// A node's load state changed: loaded, unloaded, dispatched, cancelled,
+    /// completed, queued for spawn, or its node data came or went.
+    pub(crate) fn node(&mut self, path: OctreePath) {
+        self.paths.push(path);
+    }
+
+    /// A bulk was inserted, evicted, started loading, or failed.
+    pub(crate) fn bulk(&mut self, path: OctreePath) {
+        self.paths.push(path);
+        self.bulks.push(path);
+    }
+}
+
+/// Reuse counters for the diagnostics UI.
+#[derive(Default, Clone, Copy, Debug)]
+pub struct WalkStats {
+    /// Walk calls evaluated in the last walk.
+    pub evaluated: usize,
+    /// Subtrees replayed from the previous walk.
+    pub reused_subtrees: usize,
+    /// Walk calls inside the replayed subtrees.
+    pub reused_calls: usize,
+    /// Whether the last walk started from scratch (first walk, or a change
+    /// to [`WalkGlobals`]).
+    pub full: bool,
+}
+
+/// A memoised walk call, shared by every later walk that replays it.
+#[derive(Debug)]
+pub(crate) struct WalkMemo {
+    path: OctreePath,
+    args: WalkArgs,
+    /// The call's returned coverage mask.
+    mask: u8,
+    pose: WalkPose,
+    /// Slack relative to `pose`.
+    slack: Slack,
+    /// The call's outputs and child calls, in visit order.
+    items: Vec<WalkItem>,
+    /// Calls in this call's subtree, itself included.
+    len: usize,
+}
+
+/// An entry of a walk or a call: an output, or a child call's memo.
+#[derive(Debug)]
+enum WalkItem {
+    Event(WalkEvent),
+    Call(Arc<WalkMemo>),
+}
+
+impl WalkMemo {
+    /// The memo for the child call `path`. Children are visited in octant
+    /// order, so `cursor` (start it at `None`) lets successive lookups resume
+    /// where the last stopped.
+    pub(crate) fn child(&self, cursor: &mut Option<usize>, path: OctreePath) -> Option<&Arc<Self>> {
+        let level = path.depth().checked_sub(1)?;
+        let mut i = cursor.unwrap_or(0);
+        while let Some(item) = self.items.get(i) {
+            if let WalkItem::Call(memo) = item {
+                if memo.path == path {
+                    *cursor = Some(i + 1);
+                    return Some(memo);
+                }
+                // A later octant: this child wasn't called last time.
+                if memo.path.octant_at(level) > path.octant_at(level) {
+                    break;
+                }
+            }
+            i += 1;
+        }
+        *cursor = Some(i);
+        None
+    }
+}
+
+/// Memoised walk calls and their logged outputs, carried across frames.
+///
+/// Read-only while a walk runs, so subtrees can be walked concurrently: each
+/// writes its own [`WalkLog`], and the logs are spliced in in visit order.
+#[derive(Default)]
+pub(crate) struct WalkCache {
+    /// The previous walk's top-level entries: the root call's memo.
+    top: Vec<WalkItem>,
+    globals: Option<WalkGlobals>,
+    pose: Option<WalkPose>,
+    /// `dirty.paths` and all their ancestors: a call is dirty if its path is
+    /// in here.
+    dirty_prefixes: HashSet<OctreePath>,
+    dirty_bulks: HashSet<OctreePath>,
+    /// Whether the walk in progress started from scratch.
+    full: bool,
+    stats: WalkStats,
+}
+
+/// The memos and outputs of a walk, or of one subtree of it, being written.
+pub(crate) struct WalkLog {
+    /// The log's top-level entries.
+    top: Vec<WalkItem>,
+    /// The calls in progress, innermost last, with their entries so far.
+    open: Vec<WalkMemo>,
+    pose: WalkPose,
+    stats: WalkStats,
+}
+
+/// A call in progress, from [`WalkLog::begin`].
+pub(crate) struct CallSlot(usize);
+
+/// The outputs of a walk in visit order, from [`WalkCache::end`].
+pub(crate) struct WalkEvents<'a> {
+    /// The entries left at each level of the memo tree being read.
+    stack: Vec<std::slice::Iter<'a, WalkItem>>,
+}
+
+impl<'a> Iterator for WalkEvents<'a> {
+    type Item = &'a WalkEvent;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        loop {
+            match self.stack.last_mut()?.next() {
+                Some(WalkItem::Event(event)) => return Some(event),
+                Some(WalkItem::Call(memo)) => self.stack.push(memo.items.iter()),
+                None => {
+                    self.stack.pop();
+                }
+            }
+        }
+    }
+}
+
+impl WalkCache {
+    /// Start a walk at `pose`, dropping every memo if `globals` changed or
+    /// reuse is disabled, and folding in the state changes since the last.
+    /// Returns the log to write the walk into.
+    pub(crate) fn start(
+        &mut self,
+        pose: WalkPose,
+        globals: WalkGlobals,
+        dirty: WalkDirty,
+        reuse: bool,
+    ) -> WalkLog {
+        self.full = !reuse || self.globals.as_ref() != Some(&globals);
+        if self.full {
+            self.top.clear();
+        }
+        self.globals = Some(globals);
+        self.pose = Some(pose);
+
+        self.dirty_prefixes.clear();
+        for path in dirty.paths {
+            let mut p = Some(path);
+            while let Some(q) = p {
+                // Ancestors of a present path are present already.
+                if !self.dirty_prefixes.insert(q) {
+                    break;
+                }
+                p = q.parent();
+            }
+        }
+        self.dirty_bulks.clear();
+        self.dirty_bulks.extend(dirty.bulks);
+
+        self.log()
+    }
+
+    /// An empty log for a subtree of the walk in progress, to be appended to
+    /// the walk's log with [`WalkLog::append`].
+    pub(crate) fn log(&self) -> WalkLog {
+        WalkLog {
+            top: Vec::new(),
+            open: Vec::new(),
+            pose: self.pose.expect("walk started"),
+            stats: WalkStats::default(),
+        }
+    }
+
+    /// The previous walk's memo for the root call, if any.
+    pub(crate) fn root_memo(&self) -> Option<&Arc<WalkMemo>> {
+        self.top.iter().find_map(|item| match item {
+            WalkItem::Call(memo) if memo.path.is_root() => Some(memo),
+            _ => None,
+        })
+    }
+
+    /// Replay the memo `old` into `log` if it still holds for a call with
+    /// `args`, returning the call's mask and its slack at the current pose.
+    pub(crate) fn try_replay(
+        &self,
+        log: &mut WalkLog,
+        old: Option<&Arc<WalkMemo>>,
+        path: OctreePath,
+        args: WalkArgs,
+    ) -> Option<(u8, Slack)> {
+        let memo = old?;
+        if memo.path != path
+            || memo.args != args
+            || self.dirty_prefixes.contains(&path)
+            || self.dirty_bulks.contains(&args.bulk_key)
+        {
+            return None;
+        }
+        let (distance, angle) = log.pose.motion_since(&memo.pose);
+        let slack = memo.slack.after(distance, angle)?;
+
+        log.add(WalkItem::Call(Arc::clone(memo)));
+        log.stats.reused_subtrees += 1;
+        log.stats.reused_calls += memo.len;
+        Some((memo.mask, slack))
+    }
+
+    /// End the walk written to `log`, making its memos the ones the next
+    /// walk reuses, and return its outputs in visit order.
+    pub(crate) fn end(&mut self, log: WalkLog) -> WalkEvents<'_> {
+        debug_assert!(log.open.is_empty(), "every call finished");
+        self.stats = WalkStats {
+            full: self.full,
+            ..log.stats
+        };
+        self.top = log.top;
+        WalkEvents {
+            stack: vec![self.top.iter()],
+        }
+    }
+
+    /// Reuse counters from the last walk.
+    pub(crate) fn stats(&self) -> WalkStats {
+        self.stats
+    }
+}
+
+impl WalkLog {
+    /// Drop everything written so far.
+    pub(crate) fn clear(&mut self) {
+        self.top.clear();
+        self.open.clear();
+        self.stats = WalkStats::default();
+    }
+
+    /// Begin evaluating a call; its outputs go through [`Self::push`] and it
+    /// ends with [`Self::finish`].
+    pub(crate) fn begin(&mut self, path: OctreePath, args: WalkArgs) -> CallSlot {
+        self.open.push(WalkMemo {
+            path,
+            args,
+            mask: 0,
+            pose: self.pose,
+            slack: Slack::UNBOUNDED,
+            items: Vec::new(),
+            len: 1,
+        });
+        self.stats.evaluated += 1;
+        CallSlot(self.open.len())
+    }
+
+    /// Log an output of the call in progress.
+    pub(crate) fn push(&mut self, event: WalkEvent) {
+        self.add(WalkItem::Event(event));
+    }
+
+    /// Finish a call begun with [`Self::begin`], recording its result.
+    pub(crate) fn finish(&mut self, slot: CallSlot, mask: u8, slack: Slack) {
+        debug_assert_eq!(slot.0, self.open.len(), "calls finish innermost first");
+        let mut memo = self.open.pop().expect("a call in progress");
+        memo.mask = mask;
+        memo.slack = slack;
+        self.add(WalkItem::Call(Arc::new(memo)));
+    }
+
+    /// Splice in a subtree's log, written at the same pose, as if its calls
+    /// had been made on this one.
+    pub(crate) fn append(&mut self, other: Self) {
+        debug_assert!(other.open.is_empty(), "every call finished");
+        for item in other.top {
+            self.add(item);
+        }
+        self.stats.evaluated += other.stats.evaluated;
+        self.stats.reused_subtrees += other.stats.reused_subtrees;
+        self.stats.reused_calls += other.stats.reused_calls;
+    }
+
+    /// Add an entry to the call in progress, or to the top level.
+    fn add(&mut self, item: WalkItem) {
+        match self.open.last_mut() {
+            Some(call) => {
+                if let WalkItem::Call(memo) = &item {
+                    call.len += memo.len;
+                }
+                call.items.push(item);
+            }
+            None => self.top.push(item),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn pose(x: f64, yaw: f64) -> WalkPose {
+        WalkPose {
+            camera: DVec3::new(x, 0.0, 0.0),
+            rotation: DQuat::from_rotation_y(yaw),
+            lead: DVec3::ZERO,
+        }
+    }
+
+    fn globals() -> WalkGlobals {
+        WalkGlobals {
+            keep_loaded_radius: 100.0,
+            is_low_altitude: true,
+            pixels_per_meter: 1000.0,
+            error_threshold: 0.6,
+            physics_bands: vec![(50.0, 0)],
+            wysiwyg_radius: 0.0,
+            projection: [1.0, 1.5, 0.1, 1e7],
+        }
+    }
+
+    fn args() -> WalkArgs {
+        WalkArgs {
+            bulk_key: OctreePath::ROOT,
+            physics_best_ancestor: None,
+            physics_committed_above: false,
+            physics_chain_requested: false,
+        }
+    }
+
+    fn path(s: &str) -> OctreePath {
+        OctreePath::parse(s).unwrap()
+    }
+
+    /// Walk a root with two children, each logging a commit of its path,
+    /// into a log that ends the walk started with it.
+    fn walk(cache: &mut WalkCache, mut log: WalkLog, slack: Slack) -> (usize, Vec<OctreePath>) {
+        let root = OctreePath::ROOT;
+        let old_root = cache.root_memo();
+        if cache.try_replay(&mut log, old_root, root, args()).is_none() {
+            let slot = log.begin(root, args());
+            let mut cursor = None;
+            for child in [path("0"), path("3")] {
+                let old = old_root.and_then(|memo| memo.child(&mut cursor, child));
+                if cache.try_replay(&mut log, old, child, args()).is_none() {
+                    let child_slot = log.begin(child, args());
+                    log.push(WalkEvent::Commit(child, 0));
+                    log.finish(child_slot, 0, slack);
+                }
+            }
+            log.finish(slot, 0, slack);
+        }
+        commits(cache, log)
+    }
+
+    /// End the walk, returning its evaluated-call count and commits.
+    fn commits(cache: &mut WalkCache, log: WalkLog) -> (usize, Vec<OctreePath>) {
+        let evaluated = log.stats.evaluated;
+        let commits = cache
+            .end(log)
+            .filter_map(|e| match e {
+                WalkEvent::Commit(p, _) => Some(*p),
+                _ => None,
+            })
+            .collect();
+        (evaluated, commits)
+    }
+
+    #[test]
+    fn unchanged_walk_replays_the_whole_tree() {
+        let mut slack = Slack::UNBOUNDED;
+        slack.bound_distance(10.0);
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        assert_eq!(
+            walk(&mut cache, log, slack),
+            (3, vec![path("0"), path("3")])
+        );
+
+        let log = cache.start(pose(5.0, 0.0), globals(), WalkDirty::default(), true);
+        assert_eq!(
+            walk(&mut cache, log, slack),
+            (0, vec![path("0"), path("3")])
+        );
+        assert_eq!(cache.stats().reused_calls, 3);
+    }
+
+    #[test]
+    fn dirty_path_re_evaluates_only_its_chain() {
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, Slack::UNBOUNDED);
+        let child = |cache: &WalkCache, octant: &str| {
+            let root = cache.root_memo().unwrap();
+            Arc::clone(root.child(&mut None, path(octant)).unwrap())
+        };
+        let clean = child(&cache, "0");
+
+        let mut dirty = WalkDirty::default();
+        dirty.node(path("31"));
+        let log = cache.start(pose(0.0, 0.0), globals(), dirty, true);
+        // The root and child 3 re-run; child 0 is replayed.
+        assert_eq!(
+            walk(&mut cache, log, Slack::UNBOUNDED),
+            (2, vec![path("0"), path("3")])
+        );
+        assert_eq!(cache.stats().reused_subtrees, 1);
+        // The replayed child is the previous walk's memo, not a copy.
+        assert!(Arc::ptr_eq(&clean, &child(&cache, "0")));
+    }
+
+    #[test]
+    fn slack_is_charged_across_frames() {
+        let mut slack = Slack::UNBOUNDED;
+        slack.bound_distance(10.0);
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, slack);
+
+        // Two 6 m steps: each within the slack, the sum beyond it.
+        let log = cache.start(pose(6.0, 0.0), globals(), WalkDirty::default(), true);
+        assert_eq!(walk(&mut cache, log, slack).0, 0);
+        let log = cache.start(pose(12.0, 0.0), globals(), WalkDirty::default(), true);
+        assert_eq!(walk(&mut cache, log, slack).0, 3);
+    }
+
+    #[test]
+    fn rotation_uses_the_angular_slack() {
+        let mut slack = Slack::UNBOUNDED;
+        // 10 m of margin on a box 1 km out: ~0.01 rad of rotation.
+        slack.bound_view(10.0, 1000.0);
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, slack);
+
+        let log = cache.start(pose(0.0, 0.005), globals(), WalkDirty::default(), true);
+        assert_eq!(walk(&mut cache, log, slack).0, 0);
+        let log = cache.start(pose(0.0, 0.02), globals(), WalkDirty::default(), true);
+        assert_eq!(walk(&mut cache, log, slack).0, 3);
+    }
+
+    #[test]
+    fn changed_globals_start_from_scratch() {
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, Slack::UNBOUNDED);
+
+        let mut changed = globals();
+        changed.keep_loaded_radius = 200.0;
+        let log = cache.start(pose(0.0, 0.0), changed, WalkDirty::default(), true);
+        assert_eq!(walk(&mut cache, log, Slack::UNBOUNDED).0, 3);
+        assert!(cache.stats().full);
+    }
+
+    #[test]
+    fn replayed_subtrees_keep_their_outputs() {
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, Slack::UNBOUNDED);
+
+        // Child 0 re-runs and child 3 is replayed after it, under a new root
+        // memo; again and again, child 3's shared memo keeps its commit.
+        for _ in 0..3 {
+            let mut dirty = WalkDirty::default();
+            dirty.node(path("0"));
+            let log = cache.start(pose(0.0, 0.0), globals(), dirty, true);
+            assert_eq!(
+                walk(&mut cache, log, Slack::UNBOUNDED).1,
+                vec![path("0"), path("3")]
+            );
+        }
+    }
+
+    #[test]
+    fn appended_subtree_logs_match_a_single_walk() {
+        let mut cache = WalkCache::default();
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        walk(&mut cache, log, Slack::UNBOUNDED);
+
+        // Walk the root inline and its children into logs of their own, as
+        // a fanned-out walk does; child 3 replays from the first walk.
+        let mut dirty = WalkDirty::default();
+        dirty.node(path("0"));
+        let mut log = cache.start(pose(0.0, 0.0), globals(), dirty, true);
+        let old_root = cache.root_memo();
+        let slot = log.begin(OctreePath::ROOT, args());
+        let mut cursor = None;
+        for child in [path("0"), path("3")] {
+            let old = old_root.and_then(|memo| memo.child(&mut cursor, child));
+            let mut sub = cache.log();
+            if cache.try_replay(&mut sub, old, child, args()).is_none() {
+                let child_slot = sub.begin(child, args());
+                sub.push(WalkEvent::Commit(child, 0));
+                sub.finish(child_slot, 0, Slack::UNBOUNDED);
+            }
+            log.append(sub);
+        }
+        log.finish(slot, 0, Slack::UNBOUNDED);
+        assert_eq!(commits(&mut cache, log), (2, vec![path("0"), path("3")]));
+
+        // The appended memos replay like any others.
+        let log = cache.start(pose(0.0, 0.0), globals(), WalkDirty::default(), true);
+        assert_eq!(
+            walk(&mut cache, log, Slack::UNBOUNDED),
+            (0, vec![path("0"), path("3")])
+        );
+    }
+}
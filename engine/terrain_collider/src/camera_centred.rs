@@ -0,0 +1,70 @@
+//! The settings the camera-centred collider
+//! (`veldera_terrain::collider::camera_centred`) extracts its surface with.
+//!
+//! They live here, beside the extractors, rather than in the engine so that
+//! fuse-lab's offline benches build exactly the surface the game does: both
+//! import these instead of keeping copies that drift apart.
+
+use crate::{heightfield::HeightfieldSettings, octree3d::Octree3dSettings};
+
+/// Settings for the camera-centred 2.5D drivable-height surface: a quadtree
+/// over the ground, `near_voxel` fine near the camera, coarsening to `far_voxel`
+/// (one doubling per `ring_m`) out to `radius`. The reach is sized toward the
+/// leap-arc's `max_range_m` — a fully-charged yeet launches at 150 m/s and the
+/// leap-preview arc collide-and-slides against this collider to find its landing,
+/// so it predicts (and the player lands) wrong past wherever the collider stops.
+/// `percentile` is the overhead-clutter-rejection dial (low keeps the road under a
+/// sign). Each chunk builds with its own copy, at the single leaf size its ring
+/// calls for. A compile-time table for now; a follow-up lifts it into the
+/// hot-reloadable streaming config.
+pub const HEIGHTFIELD: HeightfieldSettings = HeightfieldSettings {
+    near_voxel: 0.3,
+    radius: 500.0,
+    // Resolution coarsens one step per 40 m out, capped at 8 m. Kept relatively
+    // fine far out (a doubling every 40 m, not 30, and an 8 m floor, not 18) so
+    // distant buildings aren't staircased — the flatness merge keeps that
+    // affordable by collapsing the far *flat* ground regardless. ~580 ms / 350k
+    // tris over 700 m of dense urban; coarsen these if the build cost bites.
+    ring_m: 40.0,
+    far_voxel: 8.0,
+    percentile: 0.3,
+    // Building footprints (tall regions ≥ 150 m²) take the roof height for a solid
+    // plateau; smaller tall regions (signs, poles, lone trees) stay ground.
+    building_percentile: 0.9,
+    building_min_area_m2: 150.0,
+    skirt_depth: 2.0,
+    // Flat ground collapses to large cells; surfaces deviating > 20 cm keep
+    // refining (curbs, bumps, building edges).
+    flatness_tolerance: 0.2,
+};
+
+/// Octree knobs for the camera-centred 3D octree surface. Near voxel 0.5 m
+/// (cubic cell-count → ~9× cheaper than 0.3 m, and 0.5 m is fine collider detail
+/// for driving), coarsening to 8 m by `ring_m`, out to [`HEIGHTFIELD`]'s reach.
+/// `seal_cells` opens thin air pockets; off here.
+pub const OCTREE: Octree3dSettings = Octree3dSettings {
+    near_voxel: 0.5,
+    ring_m: 40.0,
+    far_voxel: 8.0,
+    band_cells: 0.0,
+    seal_cells: 0,
+};
+
+/// QEF residual bound under which the octree surface merges coplanar cells.
+pub const OCTREE_COLLAPSE_ERROR: f32 = 0.05;
+
+/// Skirt depth (cells) of the octree surface, plugging LoD-boundary cracks on
+/// thin sheets.
+pub const OCTREE_SKIRT_CELLS: f32 = 2.0;
+
+/// Laplacian passes, and their step fraction, that take the per-cell jitter off
+/// the octree surface.
+pub const OCTREE_SMOOTH_ITERS: u32 = 1;
+pub const OCTREE_SMOOTH_LAMBDA: f32 = 0.5;
+
+/// How far (m) past the surface's reach fuse-lab keeps the soup, so the
+/// extractors see the geometry just outside their square (building footprints
+/// straddling it, the background fill) the same way a neighbouring square does.
+/// The game reads its margin from the `chunk_soup_margin` streaming config key,
+/// which ships with this value.
+pub const SOUP_MARGIN: f32 = 16.0;
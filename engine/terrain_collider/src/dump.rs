@@ -61,6 +61,7 @@ impl DumpMesh {
             texture_format: rocktree::TextureFormat::Rgb,
             texture_width: 0,
             texture_height: 0,
+            texture_mip_levels: 1,
             has_octant_data: self.has_octant_data,
         }
     }
@@ -0,0 +1,255 @@
+//! Keys and a compact binary form for caching built collider geometry.
+//!
+//! Every collider build is a pure function of epoch-versioned rocktree tiles
+//! and the build settings, so a build seen once can be stored and read back
+//! instead of recomputed when its area is revisited. This module names a
+//! build ([`GeometryKey`]: the source tiles by path, epoch and octant mask,
+//! plus a [`StableHasher`] digest of the settings and anything else the
+//! output depends on) and packs its triangle soup into bytes
+//! ([`encode_soup`]/[`decode_soup`]). Where the bytes are stored is the
+//! caller's business; the engine keeps them in a `rocktree`
+//! `FilesystemCache` next to the tile cache.
+
+use std::{fmt, hash::Hasher};
+
+use glam::Vec3;
+use rocktree_decode::OctreePath;
+
+/// Leading bytes of every encoded soup. The last byte is the format version;
+/// bump it whenever the encoding or what a build produces changes, so stale
+/// entries read as misses.
+const MAGIC: [u8; 4] = *b"VCG\x01";
+
+/// Header bytes: magic, vertex count, triangle count.
+const HEADER_LEN: usize = 12;
+
+/// 64-bit FNV-1a. Cache keys outlive the process, and std's hasher makes no
+/// promise of giving the same digest across toolchains.
+#[derive(Clone, Copy, Debug)]
+pub struct StableHasher(u64);
+
+impl StableHasher {
+    #[must_use]
+    pub fn new() -> Self {
+        Self(0xcbf2_9ce4_8422_2325)
+    }
+
+    /// Hash a float by its bits, so `0.0` and `-0.0` (and every NaN) differ.
+    pub fn write_f32(&mut self, value: f32) {
+        self.write_u32(value.to_bits());
+    }
+}
+
+impl Default for StableHasher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Hasher for StableHasher {
+    fn write(&mut self, bytes: &[u8]) {
+        for &byte in bytes {
+            self.0 = (self.0 ^ u64::from(byte)).wrapping_mul(0x0000_0100_0000_01b3);
+        }
+    }
+
+    fn finish(&self) -> u64 {
+        self.0
+    }
+}
+
+/// One source tile of a cached build.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct TileKey {
+    pub path: OctreePath,
+    /// The data epoch the tile's meshes were fetched at.
+    pub epoch: u32,
+    pub octant_mask: u8,
+}
+
+/// Names one build in a geometry cache. Its [`Display`](fmt::Display) form
+/// spells out every tile, so a cache that verifies keys on read never serves
+/// one build's geometry for another.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct GeometryKey {
+    /// Which extractor built the geometry, e.g. `"octree"`.
+    extractor: &'static str,
+    /// [`StableHasher`] digest of the settings and placement.
+    settings: u64,
+    /// Sorted, so the gather order doesn't matter.
+    tiles: Vec<TileKey>,
+}
+
+impl GeometryKey {
+    #[must_use]
+    pub fn new(
+        extractor: &'static str,
+        settings: u64,
+        tiles: impl IntoIterator<Item = TileKey>,
+    ) -> Self {
+        let mut tiles: Vec<TileKey> = tiles.into_iter().collect();
+        tiles.sort_unstable();
+        tiles.dedup();
+        Self {
+            extractor,
+            settings,
+            tiles,
+        }
+    }
+}
+
+impl fmt::Display for GeometryKey {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "collider/v{}/{}/{:016x}/",
+            MAGIC[3], self.extractor, self.settings
+        )?;
+        for (i, tile) in self.tiles.iter().enumerate() {
+            let separator = if i == 0 { "" } else { "," };
+            write!(
+                f,
+                "{separator}{}:{}:{:02x}",
+                tile.path, tile.epoch, tile.octant_mask
+            )?;
+        }
+        Ok(())
+    }
+}
+
+/// Pack a triangle soup: a header, the vertices as little-endian `f32`s and
+/// the indices as `u16`s when every vertex fits in one (most chunk and tile
+/// builds), `u32`s otherwise. Vertices are kept exact; a collider read back
+/// is the collider that was built.
+#[must_use]
+pub fn encode_soup(vertices: &[Vec3], triangles: &[[u32; 3]]) -> Vec<u8> {
+    let wide = wide_indices(vertices.len());
+    let index_size = if wide { 4 } else { 2 };
+    let mut bytes =
+        Vec::with_capacity(HEADER_LEN + vertices.len() * 12 + triangles.len() * 3 * index_size);
+    bytes.extend_from_slice(&MAGIC);
+    bytes.extend_from_slice(&(vertices.len() as u32).to_le_bytes());
+    bytes.extend_from_slice(&(triangles.len() as u32).to_le_bytes());
+    for v in vertices {
+        for c in v.to_array() {
+            bytes.extend_from_slice(&c.to_le_bytes());
+        }
+    }
+    for &i in triangles.as_flattened() {
+        if wide {
+            bytes.extend_from_slice(&i.to_le_bytes());
+        } else {
+            bytes.extend_from_slice(&(i as u16).to_le_bytes());
+        }
+    }
+    bytes
+}
+
+/// Unpack a soup from [`encode_soup`]. `None` for anything else: another
+/// format version, a truncated entry, or an index past the vertices.
+#[must_use]
+pub fn decode_soup(bytes: &[u8]) -> Option<(Vec<Vec3>, Vec<[u32; 3]>)> {
+    let (header, body) = bytes.split_first_chunk::<HEADER_LEN>()?;
+    if header[..4] != MAGIC {
+        return None;
+    }
+    let read_u32 = |at: usize| u32::from_le_bytes(header[at..at + 4].try_into().unwrap());
+    let (vertex_count, triangle_count) = (read_u32(4) as usize, read_u32(8) as usize);
+    let index_size = if wide_indices(vertex_count) { 4 } else { 2 };
+    let vertex_bytes = vertex_count.checked_mul(12)?;
+    if body.len() != vertex_bytes.checked_add(triangle_count.checked_mul(3 * index_size)?)? {
+        return None;
+    }
+    let (vertex_bytes, index_bytes) = body.split_at(vertex_bytes);
+
+    let vertices = vertex_bytes
+        .chunks_exact(12)
+        .map(|v| {
+            let c = |at: usize| f32::from_le_bytes(v[at..at + 4].try_into().unwrap());
+            Vec3::new(c(0), c(4), c(8))
+        })
+        .collect();
+    let indices: Vec<u32> = index_bytes
+        .chunks_exact(index_size)
+        .map(|i| match *i {
+            [a, b] => u32::from(u16::from_le_bytes([a, b])),
+            [a, b, c, d] => u32::from_le_bytes([a, b, c, d]),
+            _ => unreachable!("index chunks are 2 or 4 bytes"),
+        })
+        .collect();
+    if indices.iter().any(|&i| i as usize >= vertex_count) {
+        return None;
+    }
+    let triangles = indices
+        .chunks_exact(3)
+        .map(|t| [t[0], t[1], t[2]])
+        .collect();
+    Some((vertices, triangles))
+}
+
+/// Whether a soup of `vertex_count` vertices needs `u32` indices.
+fn wide_indices(vertex_count: usize) -> bool {
+    vertex_count > usize::from(u16::MAX) + 1
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn soup(vertex_count: u32) -> (Vec<Vec3>, Vec<[u32; 3]>) {
+        let vertices = (0..vertex_count)
+            .map(|i| Vec3::new(i as f32, -0.5 * i as f32, 1e-3))
+            .collect();
+        let triangles = (0..vertex_count.saturating_sub(2))
+            .map(|i| [i, i + 1, i + 2])
+            .collect();
+        (vertices, triangles)
+    }
+
+    #[test]
+    fn soups_round_trip_at_both_index_widths() {
+        for count in [0, 3, 70_000] {
+            let (vertices, triangles) = soup(count);
+            let bytes = encode_soup(&vertices, &triangles);
+            assert_eq!(decode_soup(&bytes), Some((vertices, triangles)));
+        }
+        // Below the limit the indices pack into two bytes.
+        assert_eq!(
+            encode_soup(&soup(3).0, &soup(3).1).len(),
+            HEADER_LEN + 36 + 6
+        );
+    }
+
+    #[test]
+    fn damaged_entries_decode_as_misses() {
+        let (vertices, triangles) = soup(5);
+        let bytes = encode_soup(&vertices, &triangles);
+        assert_eq!(decode_soup(&bytes[..bytes.len() - 1]), None);
+
+        let mut version = bytes.clone();
+        version[3] += 1;
+        assert_eq!(decode_soup(&version), None);
+
+        let mut index = bytes;
+        let last = index.len() - 2;
+        index[last] = 5;
+        assert_eq!(decode_soup(&index), None);
+    }
+
+    #[test]
+    fn keys_ignore_tile_order_but_not_epochs_or_settings() {
+        let tile = |path: &str, epoch| TileKey {
+            path: OctreePath::parse(path).unwrap(),
+            epoch,
+            octant_mask: 0x0f,
+        };
+        let key =
+            |settings, tiles: [TileKey; 2]| GeometryKey::new("octree", settings, tiles).to_string();
+
+        let a = key(1, [tile("0123", 7), tile("0124", 7)]);
+        assert_eq!(a, key(1, [tile("0124", 7), tile("0123", 7)]));
+        assert_ne!(a, key(1, [tile("0123", 8), tile("0124", 7)]));
+        assert_ne!(a, key(2, [tile("0123", 7), tile("0124", 7)]));
+        assert!(a.ends_with("/0123:7:0f,0124:7:0f"));
+    }
+}
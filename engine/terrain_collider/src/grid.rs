@@ -0,0 +1,177 @@
+//! A flat uniform grid over 2D footprints, for vertical-line queries.
+//!
+//! Surface sampling asks "which triangles could lie under this point?" for
+//! every rim vertex of every build. [`FootprintGrid`] answers from two flat
+//! arrays in compressed-sparse-row form: `offsets` per cell, row-major, and
+//! one `items` array holding each cell's footprint indices back to back. A
+//! query's cells in one grid row are adjacent in `items`, so it reads one
+//! contiguous run per row instead of one heap bucket per cell.
+
+use glam::Vec2;
+
+/// Most cells along either axis. Bounds the grid's memory however far an
+/// outlier stretches the footprints; the cell size grows to fit instead.
+const MAX_CELLS_PER_AXIS: usize = 1024;
+
+/// Footprints bucketed into the cells of a uniform grid, built once by
+/// [`Self::new`] and then only queried.
+#[derive(Clone, Debug)]
+pub struct FootprintGrid {
+    origin: Vec2,
+    cell_size: f32,
+    /// Cells along x and y.
+    dims: [usize; 2],
+    /// `items[offsets[c]..offsets[c + 1]]` overlap cell `c`, for the cells in
+    /// row-major order.
+    offsets: Vec<u32>,
+    items: Vec<u32>,
+}
+
+impl FootprintGrid {
+    /// Bucket each footprint, an axis-aligned `(min, max)` box, into every cell
+    /// of side `cell_size` it overlaps. Footprint `i` is reported as item `i`.
+    #[must_use]
+    pub fn new(footprints: &[(Vec2, Vec2)], cell_size: f32) -> Self {
+        let (min, max) = footprints.iter().fold(
+            (Vec2::splat(f32::INFINITY), Vec2::splat(f32::NEG_INFINITY)),
+            |(lo, hi), &(a, b)| (lo.min(a), hi.max(b)),
+        );
+        let (min, max) = if footprints.is_empty() {
+            (Vec2::ZERO, Vec2::ZERO)
+        } else {
+            (min, max)
+        };
+        let span = (max - min).max(Vec2::splat(1e-3));
+        let cell_size = cell_size.max(span.max_element() / MAX_CELLS_PER_AXIS as f32);
+        let cells_along = |extent: f32| ((extent / cell_size) as usize + 1).min(MAX_CELLS_PER_AXIS);
+        let mut grid = Self {
+            origin: min,
+            cell_size,
+            dims: [cells_along(span.x), cells_along(span.y)],
+            offsets: Vec::new(),
+            items: Vec::new(),
+        };
+
+        // Count, prefix-sum into offsets, then fill through a cursor per cell.
+        let mut counts = vec![0u32; grid.dims[0] * grid.dims[1] + 1];
+        for &(lo, hi) in footprints {
+            grid.for_each_cell(lo, hi, |cell| counts[cell] += 1);
+        }
+        let mut total = 0;
+        for count in &mut counts {
+            let here = *count;
+            *count = total;
+            total += here;
+        }
+        let mut cursor = counts.clone();
+        let mut items = vec![0; total as usize];
+        for (index, &(lo, hi)) in footprints.iter().enumerate() {
+            grid.for_each_cell(lo, hi, |cell| {
+                items[cursor[cell] as usize] = index as u32;
+                cursor[cell] += 1;
+            });
+        }
+        grid.offsets = counts;
+        grid.items = items;
+        grid
+    }
+
+    /// The side of a cell; at least the size asked for, larger when the
+    /// footprints spread too far for that many cells.
+    #[must_use]
+    pub fn cell_size(&self) -> f32 {
+        self.cell_size
+    }
+
+    /// The footprints in the cells the box `[lo, hi]` overlaps: every
+    /// footprint overlapping the box, and possibly some near it. One
+    /// spanning several of the cells comes up once per cell.
+    pub fn candidates(&self, lo: Vec2, hi: Vec2) -> impl Iterator<Item = u32> + '_ {
+        self.cell_range(lo, hi)
+            .into_iter()
+            .flat_map(move |([x0, y0], [x1, y1])| {
+                (y0..=y1).flat_map(move |y| {
+                    let row = y * self.dims[0];
+                    let run = self.offsets[row + x0] as usize..self.offsets[row + x1 + 1] as usize;
+                    self.items[run].iter().copied()
+                })
+            })
+    }
+
+    /// The inclusive cell range the box `[lo, hi]` overlaps, clamped to the
+    /// grid, or `None` when the box misses it.
+    fn cell_range(&self, lo: Vec2, hi: Vec2) -> Option<([usize; 2], [usize; 2])> {
+        let to_cell = |p: Vec2| ((p - self.origin) / self.cell_size).floor();
+        let (lo, hi) = (to_cell(lo), to_cell(hi));
+        let last = Vec2::new((self.dims[0] - 1) as f32, (self.dims[1] - 1) as f32);
+        // Written to reject NaN as well as boxes off the grid.
+        if !(hi.x >= 0.0 && hi.y >= 0.0 && lo.x <= last.x && lo.y <= last.y) {
+            return None;
+        }
+        let (lo, hi) = (lo.max(Vec2::ZERO), hi.min(last));
+        Some((
+            [lo.x as usize, lo.y as usize],
+            [hi.x as usize, hi.y as usize],
+        ))
+    }
+
+    fn for_each_cell(&self, lo: Vec2, hi: Vec2, mut f: impl FnMut(usize)) {
+        let Some(([x0, y0], [x1, y1])) = self.cell_range(lo, hi) else {
+            return;
+        };
+        for y in y0..=y1 {
+            for x in x0..=x1 {
+                f(y * self.dims[0] + x);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn queries_find_exactly_the_footprints_in_their_cells() {
+        let footprints = [
+            (Vec2::new(0.0, 0.0), Vec2::new(1.0, 1.0)),
+            (Vec2::new(8.5, 0.5), Vec2::new(9.5, 9.5)),
+            (Vec2::new(0.0, 4.0), Vec2::new(9.9, 4.5)),
+        ];
+        let grid = FootprintGrid::new(&footprints, 2.0);
+        let found = |lo: Vec2, hi: Vec2| {
+            let mut items: Vec<u32> = grid.candidates(lo, hi).collect();
+            items.sort_unstable();
+            items.dedup();
+            items
+        };
+
+        assert_eq!(found(Vec2::splat(0.5), Vec2::splat(0.5)), vec![0]);
+        assert_eq!(found(Vec2::new(9.0, 4.2), Vec2::new(9.0, 4.2)), vec![1, 2]);
+        assert_eq!(
+            found(Vec2::new(4.0, 8.0), Vec2::new(5.0, 9.0)),
+            Vec::<u32>::new()
+        );
+        assert_eq!(found(Vec2::splat(-1.0), Vec2::splat(11.0)), vec![0, 1, 2]);
+        assert_eq!(
+            found(Vec2::splat(20.0), Vec2::splat(21.0)),
+            Vec::<u32>::new()
+        );
+        assert_eq!(found(Vec2::NAN, Vec2::NAN), Vec::<u32>::new());
+    }
+
+    #[test]
+    fn outliers_coarsen_the_cells_instead_of_growing_the_grid() {
+        let footprints = [
+            (Vec2::ZERO, Vec2::ONE),
+            (Vec2::splat(1e6), Vec2::splat(1e6 + 1.0)),
+        ];
+        let grid = FootprintGrid::new(&footprints, 1.0);
+        assert!(grid.offsets.len() <= MAX_CELLS_PER_AXIS * MAX_CELLS_PER_AXIS + 1);
+        assert!(grid.cell_size() >= 1e6 / MAX_CELLS_PER_AXIS as f32);
+        assert_eq!(
+            grid.candidates(Vec2::ZERO, Vec2::ZERO).collect::<Vec<_>>(),
+            vec![0]
+        );
+    }
+}
@@ -22,6 +22,8 @@ use std::{cell::RefCell, collections::HashMap};
 
 use glam::Vec3;
 
+use crate::geometry_cache::StableHasher;
+
 /// Minimum `normal·up` for a triangle to count as a drivable (roughly horizontal)
 /// surface and contribute to a height sample. Steeper faces (walls) are excluded
 /// and instead become cliffs between samples.
@@ -81,6 +83,37 @@ pub struct HeightfieldSettings {
     pub flatness_tolerance: f32,
 }
 
+impl HeightfieldSettings {
+    /// Feed every knob into a geometry-cache key (see
+    /// [`crate::geometry_cache`]).
+    pub fn hash_into(&self, hasher: &mut StableHasher) {
+        let Self {
+            near_voxel,
+            radius,
+            ring_m,
+            far_voxel,
+            percentile,
+            building_percentile,
+            building_min_area_m2,
+            skirt_depth,
+            flatness_tolerance,
+        } = *self;
+        for value in [
+            near_voxel,
+            radius,
+            ring_m,
+            far_voxel,
+            percentile,
+            building_percentile,
+            building_min_area_m2,
+            skirt_depth,
+            flatness_tolerance,
+        ] {
+            hasher.write_f32(value);
+        }
+    }
+}
+
 /// Build a distance-graded 2.5D height surface from a triangle soup already in a
 /// camera-relative frame. `up` is the local up. Returns camera-relative vertices
 /// and triangles; genuine exterior (no surface even after hole-filling) is left
@@ -210,7 +243,9 @@ pub fn build_height_quadtree(
         push(p[0], p[1], p[2], &mut out_verts, &mut out_tris);
         push(p[0], p[2], p[3], &mut out_verts, &mut out_tris);
         // Skirts only on edges bordering a differently-sized leaf (an LOD
-        // boundary): same-size neighbours share corner samples exactly.
+        // boundary): same-size neighbours share corner samples exactly. The
+        // root's own border gets one too, since a surface built beside this one
+        // may meet it at another size.
         let drop = up * skirt;
         let eps = near_voxel * 0.5;
         let (cx, cy) = (x0 + size * 0.5, y0 + size * 0.5);
@@ -221,7 +256,9 @@ pub fn build_height_quadtree(
             (x0 - eps, cy),
         ];
         for e in 0..4 {
-            if (leaf_size_at(outward[e].0, outward[e].1) - size).abs() < eps {
+            let (ox, oy) = outward[e];
+            let outside = ox.abs() > radius || oy.abs() > radius;
+            if !outside && (leaf_size_at(ox, oy) - size).abs() < eps {
                 continue;
             }
             let (a, b) = (p[e], p[(e + 1) % 4]);
@@ -23,10 +23,14 @@
 //! dependencies: `glam` math over `rocktree` mesh data. The Bevy/Avian
 //! integration lives in `veldera_physics::terrain`.
 
-use std::collections::{HashMap, HashSet};
+use std::collections::HashMap;
 
 use glam::{Quat, Vec2, Vec3};
 use rocktree::Mesh as RocktreeMesh;
+use rocktree_decode::strip_to_triangle_list;
+use serde::Serialize;
+
+use crate::grid::FootprintGrid;
 
 /// Octant midplane in the mesh-local 0-255 vertex space.
 const OCTANT_MIDPOINT: f32 = 127.5;
@@ -99,8 +103,30 @@ pub struct BuildSettings {
     pub simplify_tolerance: f32,
 }
 
+impl BuildSettings {
+    /// Feed every knob into a geometry-cache key (see [`geometry_cache`]).
+    pub fn hash_into(&self, hasher: &mut geometry_cache::StableHasher) {
+        let Self {
+            min_triangle_height,
+            skirt_depth,
+            skirt_slope,
+            fusion_range,
+            simplify_tolerance,
+        } = *self;
+        for value in [
+            min_triangle_height,
+            skirt_depth,
+            skirt_slope,
+            fusion_range,
+            simplify_tolerance,
+        ] {
+            hasher.write_f32(value);
+        }
+    }
+}
+
 /// Counters describing one build, for streaming diagnostics.
-#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq, Serialize)]
 pub struct BuildStats {
     /// Meshes where at least one varying octant bit could not be mapped to
     /// an axis and was classified per vertex from the decoded tags instead.
@@ -111,6 +137,22 @@ pub struct BuildStats {
     pub fused_vertices: usize,
 }
 
+/// The phases of a tile build, in the order [`build_tile_geometry_staged`]
+/// reports them.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum BuildStage {
+    /// Decoding the source meshes and vertex-clustering them
+    /// ([`BuildSettings::simplify_tolerance`]).
+    Cluster,
+    /// Octant-mask clipping, sub-octant carving, and the sliver filter.
+    Clip,
+    /// Border fusion against the neighbours' surfaces (instant when fusion
+    /// is off or there are no neighbours).
+    Fuse,
+    /// Boundary skirts and aprons.
+    Skirts,
+}
+
 /// A built collider geometry: a triangle soup in the build tile's baked
 /// space, ready to hand to a physics engine.
 #[derive(Clone, Debug)]
@@ -149,7 +191,9 @@ pub struct BuiltGeometry {
 ///
 /// `down` is the planet-centre direction in baked space; `neighbours` are
 /// the laterally adjacent tiles of the current selection (no ancestors or
-/// descendants of the build tile).
+/// descendants of the build tile). Their surfaces are probed for this build
+/// only; callers building many tiles of one selection should keep a
+/// [`SurfaceProbe`] per tile and use [`build_tile_geometry_with_surfaces`].
 pub fn build_tile_geometry(
     tile: &TileMeshes,
     octant_mask: u8,
@@ -157,17 +201,76 @@ pub fn build_tile_geometry(
     neighbours: &[TileMeshes],
     down: Vec3,
     settings: &BuildSettings,
+) -> Option<BuiltGeometry> {
+    let probes: Vec<SurfaceProbe> = if settings.fusion_range > 0.0 {
+        neighbours
+            .iter()
+            .map(|n| SurfaceProbe::from_tile(n, down))
+            .collect()
+    } else {
+        Vec::new()
+    };
+    let surfaces: Vec<NeighbourSurface> = probes
+        .iter()
+        .map(|probe| NeighbourSurface {
+            probe,
+            offset: Vec3::ZERO,
+        })
+        .collect();
+    build_tile_geometry_with_surfaces(tile, octant_mask, sub_cut, &surfaces, down, settings)
+}
+
+/// [`build_tile_geometry`] with the neighbours' surfaces already probed, so a
+/// tile's [`SurfaceProbe`] is built once and shared by every build along its
+/// borders.
+pub fn build_tile_geometry_with_surfaces(
+    tile: &TileMeshes,
+    octant_mask: u8,
+    sub_cut: u64,
+    neighbours: &[NeighbourSurface],
+    down: Vec3,
+    settings: &BuildSettings,
+) -> Option<BuiltGeometry> {
+    build_tile_geometry_staged(
+        tile,
+        octant_mask,
+        sub_cut,
+        neighbours,
+        down,
+        settings,
+        &mut |_| {},
+    )
+}
+
+/// [`build_tile_geometry_with_surfaces`], calling `on_stage` as each
+/// [`BuildStage`] finishes, in order (a build that comes out empty stops
+/// after [`Clip`](BuildStage::Clip)). The crate keeps no clock of its own —
+/// `std::time::Instant` is unavailable on the web — so a caller that wants
+/// per-stage timings reads one in the callback.
+pub fn build_tile_geometry_staged(
+    tile: &TileMeshes,
+    octant_mask: u8,
+    sub_cut: u64,
+    neighbours: &[NeighbourSurface],
+    down: Vec3,
+    settings: &BuildSettings,
+    on_stage: &mut dyn FnMut(BuildStage),
 ) -> Option<BuiltGeometry> {
     let mut stats = BuildStats::default();
-    let (mut vertices, mut triangles, border) = merge_meshes(
+    let prepared = prepare_meshes(tile, settings.simplify_tolerance);
+    on_stage(BuildStage::Cluster);
+    let (mut vertices, mut triangles, border) = merge_prepared(
         tile,
+        &prepared,
         settings.min_triangle_height,
-        settings.simplify_tolerance,
         octant_mask,
         sub_cut,
         down,
         &mut stats,
     );
+    // Free the decoded meshes before fusion and skirts grow the soup.
+    drop(prepared);
+    on_stage(BuildStage::Clip);
     if triangles.is_empty() {
         return None;
     }
@@ -183,6 +286,7 @@ pub fn build_tile_geometry(
             &mut fusion_samples,
         );
     }
+    on_stage(BuildStage::Fuse);
 
     add_skirts(
         &mut vertices,
@@ -191,6 +295,7 @@ pub fn build_tile_geometry(
         settings.skirt_depth,
         settings.skirt_slope,
     );
+    on_stage(BuildStage::Skirts);
 
     let mut border = border;
     border.resize(vertices.len(), false);
@@ -204,14 +309,30 @@ pub fn build_tile_geometry(
     })
 }
 
-/// A height probe over an arbitrary triangle soup (e.g. a [`BuiltGeometry`]),
-/// using the same sheet-aware sampling as border fusion: the query returns
-/// the surface sheet nearest to the query point's own height, so folds and
-/// terraces measure as zero where the geometries genuinely agree. Built for
-/// offline tooling that measures rim agreement between adjacent builds.
+/// A height probe over a triangle soup, queryable by vertical line, using
+/// sheet-aware sampling: a query returns the surface sheet nearest to the
+/// query point's own height, so folds and terraces measure as zero where the
+/// geometries genuinely agree. Border fusion probes each neighbour tile
+/// through one; offline tooling probes built geometry to measure rim
+/// agreement between adjacent builds.
+///
+/// The triangles are bucketed into a [`FootprintGrid`] over the horizontal
+/// plane, built once with the probe.
 pub struct SurfaceProbe {
     frame: HorizontalFrame,
-    sampler: SurfaceSampler,
+    /// Triangle corners as (horizontal, height) pairs.
+    triangles: Vec<[(Vec2, f32); 3]>,
+    grid: FootprintGrid,
+}
+
+/// A neighbour's [`SurfaceProbe`], placed relative to the tile being built.
+#[derive(Clone, Copy)]
+pub struct NeighbourSurface<'a> {
+    /// The neighbour's surface, in its own baked space and frame.
+    pub probe: &'a SurfaceProbe,
+    /// Translation of the neighbour's origin relative to the tile being
+    /// built (zero when the probe was built in the build tile's space).
+    pub offset: Vec3,
 }
 
 impl SurfaceProbe {
@@ -234,9 +355,51 @@ impl SurfaceProbe {
                 ]
             })
             .collect();
+        Self::from_corners(frame, soup)
+    }
+
+    /// Build a probe over a tile's source meshes, in its baked space
+    /// (`tile.offset` applied); `down` is the planet-centre direction there.
+    #[must_use]
+    pub fn from_tile(tile: &TileMeshes, down: Vec3) -> Self {
+        let frame = HorizontalFrame::new(down);
+        let mut triangles: Vec<[(Vec2, f32); 3]> = Vec::new();
+        for mesh in tile.meshes {
+            let corners: Vec<(Vec2, f32)> = mesh
+                .vertices
+                .iter()
+                .map(|v| {
+                    let local = Vec3::new(f32::from(v.x), f32::from(v.y), f32::from(v.z));
+                    let baked = tile.to_baked(local);
+                    (frame.horizontal(baked), frame.height(baked))
+                })
+                .collect();
+            for [a, b, c] in strip_to_triangle_list(&mesh.indices) {
+                triangles.push([
+                    corners[a as usize],
+                    corners[b as usize],
+                    corners[c as usize],
+                ]);
+            }
+        }
+        Self::from_corners(frame, triangles)
+    }
+
+    fn from_corners(frame: HorizontalFrame, triangles: Vec<[(Vec2, f32); 3]>) -> Self {
+        let footprints: Vec<(Vec2, Vec2)> = triangles
+            .iter()
+            .map(|[(a, _), (b, _), (c, _)]| (a.min(*b).min(*c), a.max(*b).max(*c)))
+            .collect();
+        let (min, max) = footprints.iter().fold(
+            (Vec2::splat(f32::INFINITY), Vec2::splat(f32::NEG_INFINITY)),
+            |(lo, hi), &(a, b)| (lo.min(a), hi.max(b)),
+        );
+        let span = (max - min).max(Vec2::splat(1e-3));
+        let grid = FootprintGrid::new(&footprints, span.max_element() / SAMPLE_GRID_CELLS as f32);
         Self {
             frame,
-            sampler: SurfaceSampler::from_triangles(soup),
+            triangles,
+            grid,
         }
     }
 
@@ -245,19 +408,58 @@ impl SurfaceProbe {
     /// surface lies within the horizontal sampling slack.
     #[must_use]
     pub fn sample_near(&self, point: Vec3, range: f32) -> Option<f32> {
-        self.sampler.sample(
+        self.sample(
             self.frame.horizontal(point),
             self.frame.height(point),
             range,
         )
     }
 
+    /// [`Self::sample_near`] for every point at once, writing each height to
+    /// the matching slot of `heights` (NaN where there is no surface).
+    ///
+    /// # Panics
+    ///
+    /// If `heights` is shorter than `points`.
+    pub fn sample_heights(&self, points: &[Vec3], range: f32, heights: &mut [f32]) {
+        assert!(heights.len() >= points.len(), "one height slot per point");
+        for (&point, height) in points.iter().zip(heights) {
+            *height = self.sample_near(point, range).unwrap_or(f32::NAN);
+        }
+    }
+
     /// The height of `point` along the probe's up axis, for comparing
     /// against [`Self::sample_near`].
     #[must_use]
     pub fn height_of(&self, point: Vec3) -> f32 {
         self.frame.height(point)
     }
+
+    /// The surface height at `position`, restricted to samples within
+    /// `range` of `reference_height`. Points inside a triangle's footprint
+    /// sample it exactly; points within [`SAMPLE_HORIZONTAL_SLACK`] of one
+    /// clamp to its nearest edge (adjacent tiles' rims don't overlap, so
+    /// border queries land just outside the footprint). The horizontally
+    /// nearest hit wins, then height closeness breaks ties.
+    fn sample(&self, position: Vec2, reference_height: f32, range: f32) -> Option<f32> {
+        let slack = Vec2::splat(SAMPLE_HORIZONTAL_SLACK);
+        // (horizontal distance, |height - reference|) lexicographic best. A
+        // triangle spanning several cells is seen once per cell; only a
+        // strictly better hit replaces the best, so repeats change nothing.
+        let mut best: Option<(f32, f32, f32)> = None;
+        for index in self.grid.candidates(position - slack, position + slack) {
+            let tri = &self.triangles[index as usize];
+            let (distance, height) = triangle_nearest_height(tri, position);
+            let height_error = (height - reference_height).abs();
+            if distance > SAMPLE_HORIZONTAL_SLACK || height_error > range {
+                continue;
+            }
+            if best.is_none_or(|(bd, be, _)| (distance, height_error) < (bd, be)) {
+                best = Some((distance, height_error, height));
+            }
+        }
+        best.map(|(_, _, height)| height)
+    }
 }
 
 // ============================================================================
@@ -298,6 +500,39 @@ fn merge_meshes(
     sub_cut: u64,
     down: Vec3,
     stats: &mut BuildStats,
+) -> (Vec<Vec3>, Vec<[u32; 3]>, Vec<bool>) {
+    let prepared = prepare_meshes(tile, simplify_tolerance);
+    merge_prepared(
+        tile,
+        &prepared,
+        min_triangle_height,
+        octant_mask,
+        sub_cut,
+        down,
+        stats,
+    )
+}
+
+/// Decode (and optionally decimate) every mesh of `tile` up front, so the
+/// border extremes in [`merge_prepared`] see the geometry the build will
+/// actually use.
+fn prepare_meshes(tile: &TileMeshes, simplify_tolerance: f32) -> Vec<PreparedMesh> {
+    tile.meshes
+        .iter()
+        .map(|mesh| cluster_mesh_vertices(mesh, tile.scale, simplify_tolerance))
+        .collect()
+}
+
+/// The clip half of [`merge_meshes`], over meshes already run through
+/// [`prepare_meshes`].
+fn merge_prepared(
+    tile: &TileMeshes,
+    prepared: &[PreparedMesh],
+    min_triangle_height: f32,
+    octant_mask: u8,
+    sub_cut: u64,
+    down: Vec3,
+    stats: &mut BuildStats,
 ) -> (Vec<Vec3>, Vec<[u32; 3]>, Vec<bool>) {
     let total_vertices: usize = tile.meshes.iter().map(|m| m.vertices.len()).sum();
     let mut vertices: Vec<Vec3> = Vec::with_capacity(total_vertices);
@@ -311,20 +546,12 @@ fn merge_meshes(
         .max_by(|&i, &j| local_down[i].abs().total_cmp(&local_down[j].abs()))
         .expect("three axes");
 
-    // Decode (and optionally decimate) every mesh up front, so the border
-    // extremes below see the geometry the build will actually use.
-    let prepared: Vec<PreparedMesh> = tile
-        .meshes
-        .iter()
-        .map(|mesh| cluster_mesh_vertices(mesh, tile.scale, simplify_tolerance))
-        .collect();
-
     // The tile's own horizontal extremes across all of its meshes: the rim
     // is wherever the geometry ends, not at the lattice box (real tiles
     // are inset).
     let mut lo = Vec3::splat(f32::INFINITY);
     let mut hi = Vec3::splat(f32::NEG_INFINITY);
-    for (locals, _, _) in &prepared {
+    for (locals, _, _) in prepared {
         for &p in locals {
             lo = lo.min(p);
             hi = hi.max(p);
@@ -339,7 +566,7 @@ fn merge_meshes(
         })
     };
 
-    for (mesh, (locals, tags, tris)) in tile.meshes.iter().zip(&prepared) {
+    for (mesh, (locals, tags, tris)) in tile.meshes.iter().zip(prepared) {
         let base = vertices.len() as u32;
         let apply_octant_mask = (octant_mask != 0 || sub_cut != 0) && mesh.has_octant_data;
         let axes = apply_octant_mask.then(|| derive_octant_axes(mesh));
@@ -464,7 +691,7 @@ fn cluster_mesh_vertices(mesh: &RocktreeMesh, scale: Vec3, tolerance: f32) -> Pr
         .map(|v| Vec3::new(f32::from(v.x), f32::from(v.y), f32::from(v.z)))
         .collect();
     let tags: Vec<u8> = mesh.vertices.iter().map(|v| v.w).collect();
-    let triangles = strip_to_triangles(&mesh.indices);
+    let triangles = strip_to_triangle_list(&mesh.indices);
     if tolerance <= 0.0 {
         return (locals, tags, triangles);
     }
@@ -815,44 +1042,51 @@ fn split_polygon(poly: &[Vec3], axis: usize, value: f32) -> (Vec<Vec3>, Vec<Vec3
 /// same curve independently: tile A averaging {A, B} equals tile B
 /// averaging {B, A}. The two rims sample that curve at different stations,
 /// leaving only second-order chord gaps for the skirts to seal.
+///
+/// Each neighbour is sampled along its own up axis and the vertical offset
+/// applied along this tile's; adjacent tiles' radial downs differ by far
+/// less than a millimetre's worth over a rim.
 fn fuse_borders(
     vertices: &mut [Vec3],
     border: &[bool],
-    neighbours: &[TileMeshes],
+    neighbours: &[NeighbourSurface],
     down: Vec3,
     fusion_range: f32,
     fusion_samples: &mut [u8],
 ) -> usize {
     let frame = HorizontalFrame::new(down);
-    let samplers: Vec<SurfaceSampler> = neighbours
+    let rim: Vec<usize> = border
         .iter()
-        .map(|n| SurfaceSampler::new(n, &frame))
+        .enumerate()
+        .filter_map(|(i, &is_border)| is_border.then_some(i))
         .collect();
-
-    let mut fused = 0;
-    for ((vertex, &is_border), samples) in vertices
-        .iter_mut()
-        .zip(border)
-        .zip(fusion_samples.iter_mut())
-    {
-        if !is_border {
-            continue;
-        }
-        let own_height = frame.height(*vertex);
-        let position = frame.horizontal(*vertex);
-
-        let mut sum = own_height;
-        let mut count = 1.0f32;
-        for sampler in &samplers {
-            if let Some(height) = sampler.sample(position, own_height, fusion_range) {
-                sum += height;
-                count += 1.0;
-                *samples = samples.saturating_add(1);
+    let own: Vec<f32> = rim.iter().map(|&i| frame.height(vertices[i])).collect();
+    let mut sums = own.clone();
+    let mut counts = vec![1u32; rim.len()];
+
+    let mut points: Vec<Vec3> = Vec::with_capacity(rim.len());
+    let mut heights = vec![0.0f32; rim.len()];
+    for neighbour in neighbours {
+        points.clear();
+        points.extend(rim.iter().map(|&i| vertices[i] - neighbour.offset));
+        neighbour
+            .probe
+            .sample_heights(&points, fusion_range, &mut heights);
+        for (k, (&height, &point)) in heights.iter().zip(&points).enumerate() {
+            if height.is_nan() {
+                continue;
             }
+            sums[k] += own[k] + (height - neighbour.probe.height_of(point));
+            counts[k] += 1;
+            fusion_samples[rim[k]] = fusion_samples[rim[k]].saturating_add(1);
         }
-        if count > 1.0 {
-            let target = sum / count;
-            *vertex += frame.up * (target - own_height);
+    }
+
+    let mut fused = 0;
+    for (k, &i) in rim.iter().enumerate() {
+        if counts[k] > 1 {
+            let target = sums[k] / counts[k] as f32;
+            vertices[i] += frame.up * (target - own[k]);
             fused += 1;
         }
     }
@@ -885,122 +1119,6 @@ impl HorizontalFrame {
     }
 }
 
-/// A neighbour tile's surface, queryable by vertical line: triangles are
-/// bucketed into a uniform 2D grid over the horizontal plane.
-struct SurfaceSampler {
-    /// Triangle corners as (horizontal, height) pairs.
-    triangles: Vec<[(Vec2, f32); 3]>,
-    /// Grid cell → indices into `triangles`.
-    grid: HashMap<(i32, i32), Vec<u32>>,
-    cell_size: f32,
-    origin: Vec2,
-}
-
-impl SurfaceSampler {
-    fn new(tile: &TileMeshes, frame: &HorizontalFrame) -> Self {
-        let mut triangles: Vec<[(Vec2, f32); 3]> = Vec::new();
-        for mesh in tile.meshes {
-            let corners: Vec<(Vec2, f32)> = mesh
-                .vertices
-                .iter()
-                .map(|v| {
-                    let local = Vec3::new(f32::from(v.x), f32::from(v.y), f32::from(v.z));
-                    let baked = tile.to_baked(local);
-                    (frame.horizontal(baked), frame.height(baked))
-                })
-                .collect();
-            for [a, b, c] in strip_to_triangles(&mesh.indices) {
-                triangles.push([
-                    corners[a as usize],
-                    corners[b as usize],
-                    corners[c as usize],
-                ]);
-            }
-        }
-        Self::from_triangles(triangles)
-    }
-
-    fn from_triangles(triangles: Vec<[(Vec2, f32); 3]>) -> Self {
-        let mut min = Vec2::splat(f32::INFINITY);
-        let mut max = Vec2::splat(f32::NEG_INFINITY);
-        for tri in &triangles {
-            for (h, _) in tri {
-                min = min.min(*h);
-                max = max.max(*h);
-            }
-        }
-
-        let span = (max - min).max(Vec2::splat(1e-3));
-        let cell_size = span.max_element() / SAMPLE_GRID_CELLS as f32;
-        let mut grid: HashMap<(i32, i32), Vec<u32>> = HashMap::new();
-        let cell_of = |p: Vec2| {
-            (
-                ((p.x - min.x) / cell_size).floor() as i32,
-                ((p.y - min.y) / cell_size).floor() as i32,
-            )
-        };
-        for (index, tri) in triangles.iter().enumerate() {
-            let lo = cell_of(tri[0].0.min(tri[1].0).min(tri[2].0));
-            let hi = cell_of(tri[0].0.max(tri[1].0).max(tri[2].0));
-            for cx in lo.0..=hi.0 {
-                for cy in lo.1..=hi.1 {
-                    grid.entry((cx, cy)).or_default().push(index as u32);
-                }
-            }
-        }
-
-        Self {
-            triangles,
-            grid,
-            cell_size,
-            origin: min,
-        }
-    }
-
-    /// The surface height at `position`, restricted to samples within
-    /// `range` of `reference_height`. Points inside a triangle's footprint
-    /// sample it exactly; points within [`SAMPLE_HORIZONTAL_SLACK`] of one
-    /// clamp to its nearest edge (adjacent tiles' rims don't overlap, so
-    /// border queries land just outside the footprint). The horizontally
-    /// nearest hit wins, then height closeness breaks ties.
-    fn sample(&self, position: Vec2, reference_height: f32, range: f32) -> Option<f32> {
-        let cell_of = |p: Vec2| {
-            (
-                ((p.x - self.origin.x) / self.cell_size).floor() as i32,
-                ((p.y - self.origin.y) / self.cell_size).floor() as i32,
-            )
-        };
-        let lo = cell_of(position - Vec2::splat(SAMPLE_HORIZONTAL_SLACK));
-        let hi = cell_of(position + Vec2::splat(SAMPLE_HORIZONTAL_SLACK));
-
-        // (horizontal distance, |height - reference|) lexicographic best.
-        let mut best: Option<(f32, f32, f32)> = None;
-        let mut visited: HashSet<u32> = HashSet::new();
-        for cx in lo.0..=hi.0 {
-            for cy in lo.1..=hi.1 {
-                let Some(indices) = self.grid.get(&(cx, cy)) else {
-                    continue;
-                };
-                for &index in indices {
-                    if !visited.insert(index) {
-                        continue;
-                    }
-                    let tri = &self.triangles[index as usize];
-                    let (distance, height) = triangle_nearest_height(tri, position);
-                    let height_error = (height - reference_height).abs();
-                    if distance > SAMPLE_HORIZONTAL_SLACK || height_error > range {
-                        continue;
-                    }
-                    if best.is_none_or(|(bd, be, _)| (distance, height_error) < (bd, be)) {
-                        best = Some((distance, height_error, height));
-                    }
-                }
-            }
-        }
-        best.map(|(_, _, height)| height)
-    }
-}
-
 /// The horizontal distance from `p` to a triangle's footprint and the
 /// surface height at the nearest footprint point: `(0, interpolated)` for
 /// points inside, otherwise the closest point on the nearest edge.
@@ -1136,43 +1254,15 @@ fn is_sliver(a: Vec3, b: Vec3, c: Vec3, min_height: f32) -> bool {
     double_area / longest < min_height
 }
 
-/// Convert a triangle strip to a list of triangle index tuples.
-///
-/// Handles degenerate triangles (where two or more indices are the same).
-fn strip_to_triangles(strip: &[u16]) -> Vec<[u32; 3]> {
-    if strip.len() < 3 {
-        return Vec::new();
-    }
-
-    let mut triangles = Vec::with_capacity(strip.len());
-
-    for i in 0..strip.len() - 2 {
-        let a = u32::from(strip[i]);
-        let b = u32::from(strip[i + 1]);
-        let c = u32::from(strip[i + 2]);
-
-        // Skip degenerate triangles.
-        if a == b || b == c || a == c {
-            continue;
-        }
-
-        // Alternate winding order for triangle strips.
-        if i % 2 == 0 {
-            triangles.push([a, b, c]);
-        } else {
-            triangles.push([a, c, b]);
-        }
-    }
-
-    triangles
-}
-
 #[cfg(test)]
 mod tests;
 
 pub mod adaptive_dc;
+pub mod camera_centred;
 pub mod clip;
 pub mod dump;
+pub mod geometry_cache;
+pub mod grid;
 pub mod health;
 pub mod heightfield;
 pub mod octree3d;
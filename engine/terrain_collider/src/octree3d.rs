@@ -13,6 +13,14 @@
 //! fact. This module builds the octree, floods it, and (for now) emits the blocky
 //! exterior boundary so the sign and any flood leaks are visible; adaptive Dual
 //! Contouring replaces the blocky extraction once the sign is trusted.
+//!
+//! The build runs in parallel natively: the top levels fan the subdivision out
+//! into independent subtrees, each filling its own node arena, and the flood,
+//! seal and corner passes run over a [`LeafGraph`] — the leaves in Morton order
+//! with their face neighbours resolved once to indices — instead of re-walking
+//! the hashed tree for every neighbour on every pass.
+
+use std::hash::Hasher;
 
 #[cfg(not(target_arch = "wasm32"))]
 use rayon::prelude::*;
@@ -20,6 +28,8 @@ use rayon::prelude::*;
 use glam::{Mat3, Vec3};
 use rustc_hash::FxHashMap;
 
+use crate::geometry_cache::StableHasher;
+
 /// Octree build/flood settings.
 #[derive(Debug, Clone, Copy)]
 pub struct Octree3dSettings {
@@ -40,6 +50,24 @@ pub struct Octree3dSettings {
     pub seal_cells: u32,
 }
 
+impl Octree3dSettings {
+    /// Feed every knob into a geometry-cache key (see
+    /// [`crate::geometry_cache`]).
+    pub fn hash_into(&self, hasher: &mut StableHasher) {
+        let Self {
+            near_voxel,
+            ring_m,
+            far_voxel,
+            band_cells,
+            seal_cells,
+        } = *self;
+        for value in [near_voxel, ring_m, far_voxel, band_cells] {
+            hasher.write_f32(value);
+        }
+        hasher.write_u32(seal_cells);
+    }
+}
+
 /// A built, flooded octree.
 pub struct Octree3d {
     pub frame: Frame,
@@ -47,6 +75,9 @@ pub struct Octree3d {
     pub root_size: f32,
     near_voxel: f32,
     nodes: FxHashMap<Key, Node>,
+    /// The leaves and their face adjacency, valid until a collapse reshapes the
+    /// tree; see [`LeafGraph`].
+    graph: Option<LeafGraph>,
     /// Frame-space triangles, kept for Hermite data during extraction.
     ftris: Vec<[Vec3; 3]>,
     /// The soup's horizontal (xy) footprint. The cube root is taller than this
@@ -92,6 +123,20 @@ impl Frame {
 /// has size `root_size / 2^L`.
 type Key = (u8, u32, u32, u32);
 
+/// Deepest level a cell may reach; also the Morton grid's resolution.
+const MAX_LEVEL: u8 = 20;
+
+/// Levels above this subdivide their children in parallel (up to `8^L`
+/// independent subtrees); below it each subtree recurses serially into its own
+/// arena.
+#[cfg(not(target_arch = "wasm32"))]
+const PAR_SPLIT_LEVEL: u8 = 2;
+
+/// Frontiers smaller than this expand serially: a flood round that touches a
+/// few cells isn't worth a fork-join.
+#[cfg(not(target_arch = "wasm32"))]
+const PAR_MIN_FRONTIER: usize = 512;
+
 struct Node {
     /// `true` if subdivided (has 8 children); `false` for a leaf.
     internal: bool,
@@ -125,6 +170,24 @@ impl Default for Node {
     }
 }
 
+impl Node {
+    fn internal() -> Self {
+        Node {
+            internal: true,
+            ..Node::default()
+        }
+    }
+
+    /// A leaf overlapping the triangles `tris`; a surface leaf unless empty.
+    fn leaf(tris: Vec<u32>) -> Self {
+        Node {
+            has_surface: !tris.is_empty(),
+            tris,
+            ..Node::default()
+        }
+    }
+}
+
 impl Octree3d {
     /// Build and flood the octree from a triangle soup (camera-relative world
     /// space). `up` is the local up; the camera sits at the frame origin.
@@ -170,6 +233,7 @@ impl Octree3d {
             root_size,
             near_voxel: settings.near_voxel,
             nodes: FxHashMap::default(),
+            graph: None,
             ftris: Vec::new(),
             foot_min,
             foot_max,
@@ -177,105 +241,89 @@ impl Octree3d {
         };
         // Recursive subdivide, partitioning triangle indices down the tree.
         let all: Vec<u32> = (0..ftris.len() as u32).collect();
-        octree.subdivide((0, 0, 0, 0), &ftris, &all, settings);
+        let root = Root {
+            min: root_min,
+            size: root_size,
+        };
+        let nodes = subdivide_par(root, (0, 0, 0, 0), &ftris, &all, settings);
+        // The subdivision emits nodes depth-first in octant order, which puts
+        // the leaves in Morton order already.
+        let graph = LeafGraph::new(
+            nodes
+                .iter()
+                .filter(|(_, n)| !n.internal)
+                .map(|&(k, _)| k)
+                .collect(),
+        );
+        octree.nodes.reserve(nodes.len());
+        octree.nodes.extend(nodes);
         octree.compute_floor();
-        octree.flood();
+        let mut exterior = octree.flood(&graph);
         if settings.seal_cells > 0 {
-            octree.seal(settings.seal_cells);
+            octree.seal(&graph, &mut exterior, settings.seal_cells);
         }
+        for (key, exterior) in graph.keys.iter().zip(exterior) {
+            octree.nodes.get_mut(key).unwrap().exterior = exterior;
+        }
+        octree.graph = Some(graph);
         octree.ftris = ftris;
         octree
     }
 
     fn cell_box(&self, key: Key) -> (Vec3, f32) {
-        let (l, i, j, k) = key;
-        let size = self.root_size / (1u32 << l) as f32;
-        let min = self.root_min + Vec3::new(i as f32, j as f32, k as f32) * size;
-        (min, size)
-    }
-
-    fn subdivide(&mut self, key: Key, ftris: &[[Vec3; 3]], tri_idx: &[u32], s: &Octree3dSettings) {
-        let (min, size) = self.cell_box(key);
-        let centre = min + Vec3::splat(size * 0.5);
-        // Triangles whose bbox overlaps this cell expanded by the subdivision band.
-        let band = s.band_cells * size;
-        let cmin = min - Vec3::splat(band);
-        let cmax = min + Vec3::splat(size + band);
-        let here: Vec<u32> = tri_idx
-            .iter()
-            .copied()
-            .filter(|&ti| tri_bbox_overlaps(&ftris[ti as usize], cmin, cmax))
-            .collect();
-        let exact: Vec<u32> = here
-            .iter()
-            .copied()
-            .filter(|&ti| tri_bbox_overlaps(&ftris[ti as usize], min, min + Vec3::splat(size)))
-            .collect();
-
-        // Distance-graded target size (horizontal distance from the camera origin).
-        let d = (centre.x * centre.x + centre.y * centre.y).sqrt();
-        let doublings = (d / s.ring_m.max(1e-3)).floor().max(0.0);
-        let target = (s.near_voxel * 2f32.powf(doublings)).clamp(s.near_voxel, s.far_voxel);
-
-        let subdivide = size > target && size > s.near_voxel && !here.is_empty() && key.0 < 20;
-        if subdivide {
-            self.nodes.insert(
-                key,
-                Node {
-                    internal: true,
-                    ..Node::default()
-                },
-            );
-            let (l, i, j, k) = key;
-            for (di, dj, dk) in OCTANTS {
-                self.subdivide((l + 1, 2 * i + di, 2 * j + dj, 2 * k + dk), ftris, &here, s);
-            }
-        } else {
-            self.nodes.insert(
-                key,
-                Node {
-                    has_surface: !exact.is_empty(),
-                    tris: exact,
-                    ..Node::default()
-                },
-            );
+        Root {
+            min: self.root_min,
+            size: self.root_size,
         }
+        .cell_box(key)
     }
 
     /// Sky-flood: empty leaves reachable from the root's top (+z) face are exterior.
     /// Surface leaves are barriers, as are cells outside the soup footprint (so the
     /// flood can't pour down the empty margins and under the terrain); everything
-    /// unreached is interior (solid).
-    fn flood(&mut self) {
-        let leaves: Vec<Key> = self
-            .nodes
-            .iter()
-            .filter(|(_, n)| !n.internal)
-            .map(|(&k, _)| k)
-            .collect();
-        // Seed: floodable leaves on the top face.
-        let mut queue: Vec<Key> = Vec::new();
-        for &key in &leaves {
+    /// unreached is interior (solid). Returns each of `graph`'s leaves' flag.
+    ///
+    /// Level-synchronous: each round expands the whole frontier at once (in
+    /// parallel when it is large) and marks the new cells after, so the result is
+    /// the same reachable set a serial walk finds.
+    fn flood(&self, graph: &LeafGraph) -> Vec<bool> {
+        let top = self.root_min.z + self.root_size - 1e-3;
+        let seeds = |i: usize| {
+            let key = graph.keys[i];
             let (min, size) = self.cell_box(key);
-            let top = min.z + size;
-            if self.floodable(key) && top >= self.root_min.z + self.root_size - 1e-3 {
-                queue.push(key);
-            }
-        }
-        for key in &queue {
-            self.nodes.get_mut(key).unwrap().exterior = true;
+            (self.floodable(key) && min.z + size >= top).then_some(i as u32)
+        };
+        #[cfg(not(target_arch = "wasm32"))]
+        let floodable: Vec<bool> = graph.keys.par_iter().map(|&k| self.floodable(k)).collect();
+        #[cfg(target_arch = "wasm32")]
+        let floodable: Vec<bool> = graph.keys.iter().map(|&k| self.floodable(k)).collect();
+        #[cfg(not(target_arch = "wasm32"))]
+        let mut frontier: Vec<u32> = (0..graph.len()).into_par_iter().filter_map(seeds).collect();
+        #[cfg(target_arch = "wasm32")]
+        let mut frontier: Vec<u32> = (0..graph.len()).filter_map(seeds).collect();
+
+        let mut exterior = vec![false; graph.len()];
+        for &i in &frontier {
+            exterior[i as usize] = true;
         }
-        while let Some(key) = queue.pop() {
-            for face in 0..6 {
-                for nb in self.face_neighbours(key, face) {
-                    if self.nodes[&nb].exterior || !self.floodable(nb) {
-                        continue;
-                    }
-                    self.nodes.get_mut(&nb).unwrap().exterior = true;
-                    queue.push(nb);
-                }
+        while !frontier.is_empty() {
+            let mut next = expand_frontier(&frontier, |i, out| {
+                out.extend(
+                    graph
+                        .all_neighbours(i as usize)
+                        .iter()
+                        .copied()
+                        .filter(|&nb| !exterior[nb as usize] && floodable[nb as usize]),
+                );
+            });
+            next.sort_unstable();
+            next.dedup();
+            for &i in &next {
+                exterior[i as usize] = true;
             }
+            frontier = next;
         }
+        exterior
     }
 
     /// Morphological opening of the exterior by `r` cells (erode then dilate), to
@@ -283,50 +331,49 @@ impl Octree3d {
     /// — so the surface is solid below the ground rather than a doubled shell. Big
     /// open air erodes then dilates back unchanged; a pocket ≤ 2r cells thick erodes
     /// away and has no seed to dilate back, so it stays solid.
-    fn seal(&mut self, r: u32) {
+    fn seal(&self, graph: &LeafGraph, exterior: &mut [bool], r: u32) {
         // Only the finest air cells take part: a thin pocket is made of fine cells
         // (they subdivided because a surface is near), while open air is coarse
         // leaves — eroding one of those as a single unit would eat a huge chunk of
         // sky. So a coarse air leaf is left exterior throughout.
-        let fine = |me: &Self, k: Key| me.cell_box(k).1 <= me.near_voxel * 1.5;
+        let fine: Vec<bool> = graph
+            .keys
+            .iter()
+            .map(|&k| self.cell_box(k).1 <= self.near_voxel * 1.5)
+            .collect();
+        let surface: Vec<bool> = graph
+            .keys
+            .iter()
+            .map(|k| self.nodes[k].has_surface)
+            .collect();
+        // Each round selects against `exterior` as it stood before the round.
         // Erode: a fine exterior leaf bordering any non-exterior leaf becomes interior.
         for _ in 0..r {
-            let clear: Vec<Key> = self
-                .nodes
-                .iter()
-                .filter(|(_, n)| !n.internal && n.exterior)
-                .map(|(&k, _)| k)
-                .filter(|&k| fine(self, k))
-                .filter(|&k| {
-                    (0..6).any(|f| {
-                        self.face_neighbours(k, f)
-                            .iter()
-                            .any(|nb| !self.nodes[nb].exterior)
-                    })
-                })
-                .collect();
-            for key in clear {
-                self.nodes.get_mut(&key).unwrap().exterior = false;
+            let clear = select_leaves(graph.len(), |i| {
+                exterior[i]
+                    && fine[i]
+                    && graph
+                        .all_neighbours(i)
+                        .iter()
+                        .any(|&nb| !exterior[nb as usize])
+            });
+            for i in clear {
+                exterior[i as usize] = false;
             }
         }
         // Dilate: a fine empty interior leaf bordering exterior becomes exterior again.
         for _ in 0..r {
-            let set: Vec<Key> = self
-                .nodes
-                .iter()
-                .filter(|(_, n)| !n.internal && !n.exterior && !n.has_surface)
-                .map(|(&k, _)| k)
-                .filter(|&k| fine(self, k))
-                .filter(|&k| {
-                    (0..6).any(|f| {
-                        self.face_neighbours(k, f)
-                            .iter()
-                            .any(|nb| self.nodes[nb].exterior)
-                    })
-                })
-                .collect();
-            for key in set {
-                self.nodes.get_mut(&key).unwrap().exterior = true;
+            let set = select_leaves(graph.len(), |i| {
+                !exterior[i]
+                    && !surface[i]
+                    && fine[i]
+                    && graph
+                        .all_neighbours(i)
+                        .iter()
+                        .any(|&nb| exterior[nb as usize])
+            });
+            for i in set {
+                exterior[i as usize] = true;
             }
         }
     }
@@ -368,6 +415,8 @@ impl Octree3d {
 
     /// Record the lowest surface height per xy column: for every surface leaf,
     /// stamp its bottom z into the floor map over its footprint, keeping the min.
+    /// Natively each worker stamps its share of the leaves into its own map and
+    /// the maps are merged by the same min.
     fn compute_floor(&mut self) {
         let surface: Vec<(Vec3, f32)> = self
             .nodes
@@ -375,16 +424,32 @@ impl Octree3d {
             .filter(|(_, n)| !n.internal && n.has_surface)
             .map(|(&k, _)| self.cell_box(k))
             .collect();
-        for (min, size) in surface {
+        let stamp = |mut floor: FxHashMap<(i32, i32), f32>, &(min, size): &(Vec3, f32)| {
             let (kx0, ky0) = self.floor_key(min.x, min.y);
             let (kx1, ky1) = self.floor_key(min.x + size, min.y + size);
             for ky in ky0..=ky1 {
                 for kx in kx0..=kx1 {
-                    let e = self.floor_z.entry((kx, ky)).or_insert(f32::INFINITY);
+                    let e = floor.entry((kx, ky)).or_insert(f32::INFINITY);
                     *e = e.min(min.z);
                 }
             }
-        }
+            floor
+        };
+        #[cfg(not(target_arch = "wasm32"))]
+        let floor = surface.par_iter().fold(FxHashMap::default, stamp).reduce(
+            FxHashMap::default,
+            |a, b| {
+                // Fold the smaller map into the larger.
+                if a.len() < b.len() {
+                    merge_floor(b, a)
+                } else {
+                    merge_floor(a, b)
+                }
+            },
+        );
+        #[cfg(target_arch = "wasm32")]
+        let floor = surface.iter().fold(FxHashMap::default(), stamp);
+        self.floor_z = floor;
     }
 
     /// Leaf neighbours across a face (0:-x 1:+x 2:-y 3:+y 4:-z 5:+z), at any size.
@@ -653,7 +718,20 @@ impl Octree3d {
         collapse_error: f32,
         skirt_cells: f32,
     ) -> (Vec<Vec3>, Vec<[u32; 3]>) {
-        let corner_ext = self.corner_ext_map();
+        let graph = match self.graph.take() {
+            Some(graph) => graph,
+            None => {
+                let mut keys: Vec<Key> = self
+                    .nodes
+                    .iter()
+                    .filter(|(_, n)| !n.internal)
+                    .map(|(&k, _)| k)
+                    .collect();
+                keys.sort_unstable_by_key(|&k| morton(k));
+                LeafGraph::new(keys)
+            }
+        };
+        let corner_ext = self.corner_ext_map(&graph);
         let q = self.near_voxel * 0.25;
         let ckey = |p: Vec3| {
             (
@@ -719,8 +797,12 @@ impl Octree3d {
         //    are all surface leaves merges their QEFs; if the merged vertex's
         //    residual error is under tolerance it becomes a leaf carrying the merged
         //    QEF, the union of triangle indices, and the parent's own corner signs.
+        // A collapse turns internal nodes into leaves, so the graph only
+        // survives without one.
         if collapse_error > 0.0 {
             self.collapse(collapse_error, &corner_ext, &ckey);
+        } else {
+            self.graph = Some(graph);
         }
 
         // 3. Crack-free connection via the proc traversal. Collect leaf vertices and
@@ -754,7 +836,7 @@ impl Octree3d {
     /// Build the corner inside/outside map exactly as `dual_contour` does: a
     /// surface leaf's face that borders an exterior empty leaf has its (fine)
     /// corners stamped exterior; corners not stamped default interior (solid).
-    fn corner_ext_map(&self) -> FxHashMap<(i64, i64, i64), bool> {
+    fn corner_ext_map(&self, graph: &LeafGraph) -> FxHashMap<(i64, i64, i64), bool> {
         let q = self.near_voxel * 0.25;
         let ckey = |p: Vec3| {
             (
@@ -763,23 +845,33 @@ impl Octree3d {
                 (p.z / q).round() as i64,
             )
         };
-        let mut corner_ext: FxHashMap<(i64, i64, i64), bool> = FxHashMap::default();
-        for (&key, node) in &self.nodes {
-            if node.internal || !node.exterior {
-                continue;
+        let stamp = |i: usize| {
+            let mut out = Vec::new();
+            if !self.nodes[&graph.keys[i]].exterior {
+                return out;
             }
             for face in 0..6 {
-                for nb in self.face_neighbours(key, face) {
+                for &nb in graph.neighbours(i, face) {
+                    let nb = graph.keys[nb as usize];
                     if !self.nodes[&nb].has_surface {
                         continue;
                     }
                     let (nmin, nsize) = self.cell_box(nb);
-                    for p in face_corners(nmin, nsize, opposite(face)) {
-                        corner_ext.insert(ckey(p), true);
-                    }
+                    out.extend(face_corners(nmin, nsize, opposite(face)).map(ckey));
                 }
             }
-        }
+            out
+        };
+        #[cfg(not(target_arch = "wasm32"))]
+        let corners: Vec<(i64, i64, i64)> = (0..graph.len())
+            .into_par_iter()
+            .flat_map_iter(stamp)
+            .collect();
+        #[cfg(target_arch = "wasm32")]
+        let corners: Vec<(i64, i64, i64)> = (0..graph.len()).flat_map(stamp).collect();
+        let mut corner_ext: FxHashMap<(i64, i64, i64), bool> = FxHashMap::default();
+        corner_ext.reserve(corners.len());
+        corner_ext.extend(corners.into_iter().map(|c| (c, true)));
         corner_ext
     }
 
@@ -1154,6 +1246,317 @@ impl Octree3d {
     }
 }
 
+/// The root cube, all a node's box depends on.
+#[derive(Clone, Copy)]
+struct Root {
+    min: Vec3,
+    size: f32,
+}
+
+impl Root {
+    fn cell_box(self, key: Key) -> (Vec3, f32) {
+        let (l, i, j, k) = key;
+        let size = self.size / (1u32 << l) as f32;
+        let min = self.min + Vec3::new(i as f32, j as f32, k as f32) * size;
+        (min, size)
+    }
+}
+
+/// A cell's fate in the subdivision: split into eight (carrying the triangles
+/// that may reach its children), or a leaf (carrying the triangles it overlaps).
+enum Split {
+    Internal(Vec<u32>),
+    Leaf(Vec<u32>),
+}
+
+/// Decide whether `key` subdivides, partitioning `tri_idx` down to it.
+fn classify(
+    root: Root,
+    key: Key,
+    ftris: &[[Vec3; 3]],
+    tri_idx: &[u32],
+    s: &Octree3dSettings,
+) -> Split {
+    let (min, size) = root.cell_box(key);
+    let centre = min + Vec3::splat(size * 0.5);
+    // Triangles whose bbox overlaps this cell expanded by the subdivision band.
+    let band = s.band_cells * size;
+    let cmin = min - Vec3::splat(band);
+    let cmax = min + Vec3::splat(size + band);
+    let here: Vec<u32> = tri_idx
+        .iter()
+        .copied()
+        .filter(|&ti| tri_bbox_overlaps(&ftris[ti as usize], cmin, cmax))
+        .collect();
+    let exact: Vec<u32> = here
+        .iter()
+        .copied()
+        .filter(|&ti| tri_bbox_overlaps(&ftris[ti as usize], min, min + Vec3::splat(size)))
+        .collect();
+
+    // Distance-graded target size (horizontal distance from the camera origin).
+    let d = (centre.x * centre.x + centre.y * centre.y).sqrt();
+    let doublings = (d / s.ring_m.max(1e-3)).floor().max(0.0);
+    let target = (s.near_voxel * 2f32.powf(doublings)).clamp(s.near_voxel, s.far_voxel);
+
+    let subdivide = size > target && size > s.near_voxel && !here.is_empty() && key.0 < MAX_LEVEL;
+    if subdivide {
+        Split::Internal(here)
+    } else {
+        Split::Leaf(exact)
+    }
+}
+
+fn child_key(key: Key, (di, dj, dk): (u32, u32, u32)) -> Key {
+    let (l, i, j, k) = key;
+    (l + 1, 2 * i + di, 2 * j + dj, 2 * k + dk)
+}
+
+/// Subdivide the subtree under `key` into `out`, serially.
+fn subdivide(
+    root: Root,
+    key: Key,
+    ftris: &[[Vec3; 3]],
+    tri_idx: &[u32],
+    s: &Octree3dSettings,
+    out: &mut Vec<(Key, Node)>,
+) {
+    match classify(root, key, ftris, tri_idx, s) {
+        Split::Internal(here) => {
+            out.push((key, Node::internal()));
+            for octant in OCTANTS {
+                subdivide(root, child_key(key, octant), ftris, &here, s, out);
+            }
+        }
+        Split::Leaf(exact) => out.push((key, Node::leaf(exact))),
+    }
+}
+
+/// Subdivide the subtree under `key`, fanning the children of the top
+/// [`PAR_SPLIT_LEVEL`] levels out across threads. The subtrees are disjoint, so
+/// each fills its own arena with no shared state; the arenas are concatenated.
+fn subdivide_par(
+    root: Root,
+    key: Key,
+    ftris: &[[Vec3; 3]],
+    tri_idx: &[u32],
+    s: &Octree3dSettings,
+) -> Vec<(Key, Node)> {
+    #[cfg(not(target_arch = "wasm32"))]
+    if key.0 < PAR_SPLIT_LEVEL {
+        return match classify(root, key, ftris, tri_idx, s) {
+            Split::Internal(here) => {
+                let arenas: Vec<Vec<(Key, Node)>> = OCTANTS
+                    .par_iter()
+                    .map(|&octant| subdivide_par(root, child_key(key, octant), ftris, &here, s))
+                    .collect();
+                let mut out = Vec::with_capacity(1 + arenas.iter().map(Vec::len).sum::<usize>());
+                out.push((key, Node::internal()));
+                for arena in arenas {
+                    out.extend(arena);
+                }
+                out
+            }
+            Split::Leaf(exact) => vec![(key, Node::leaf(exact))],
+        };
+    }
+    let mut out = Vec::new();
+    subdivide(root, key, ftris, tri_idx, s, &mut out);
+    out
+}
+
+/// Merge two partial floor maps, keeping the lower floor per column.
+#[cfg(not(target_arch = "wasm32"))]
+fn merge_floor(
+    mut into: FxHashMap<(i32, i32), f32>,
+    from: FxHashMap<(i32, i32), f32>,
+) -> FxHashMap<(i32, i32), f32> {
+    for (column, z) in from {
+        let e = into.entry(column).or_insert(f32::INFINITY);
+        *e = e.min(z);
+    }
+    into
+}
+
+/// The octree's leaves as a flat array in Morton order, with every leaf's face
+/// neighbours (at any size) resolved to indices into it. The leaves tile the
+/// root, so in Morton order each covers a contiguous run of finest-grid codes
+/// and the leaf containing a point is the last one starting at or before its
+/// code — a neighbour lookup is a binary search, not a walk of the hashed
+/// tree. Each leaf looks up only its same-size-or-larger neighbours; a smaller
+/// neighbour finds the leaf itself, and the relation is mirrored. The flood,
+/// the seal rounds and the corner map then index arrays, and a flood frontier
+/// stays close in memory.
+struct LeafGraph {
+    keys: Vec<Key>,
+    /// `neighbours[offsets[6 * i + face]..offsets[6 * i + face + 1]]` are leaf
+    /// `i`'s neighbours across `face`.
+    offsets: Vec<u32>,
+    neighbours: Vec<u32>,
+}
+
+impl LeafGraph {
+    /// Link the leaves `keys`, given in Morton order.
+    fn new(keys: Vec<Key>) -> Self {
+        let codes: Vec<u64> = keys.iter().map(|&k| morton(k)).collect();
+        debug_assert!(codes.is_sorted());
+
+        // Per leaf and face, the same-size-or-larger neighbour, if any.
+        let lookup = |(at, &key): (usize, &Key)| -> [Option<u32>; 6] {
+            let (l, i, j, k) = key;
+            let span = 1i64 << l;
+            std::array::from_fn(|face| {
+                let (di, dj, dk) = FACE_DIR[face];
+                let (ni, nj, nk) = (i64::from(i) + di, i64::from(j) + dj, i64::from(k) + dk);
+                if ni < 0 || nj < 0 || nk < 0 || ni >= span || nj >= span || nk >= span {
+                    return None;
+                }
+                let nb = containing_leaf(&codes, at, morton((l, ni as u32, nj as u32, nk as u32)));
+                (keys[nb].0 <= l).then_some(nb as u32)
+            })
+        };
+        #[cfg(not(target_arch = "wasm32"))]
+        let direct: Vec<[Option<u32>; 6]> = keys.par_iter().enumerate().map(lookup).collect();
+        #[cfg(target_arch = "wasm32")]
+        let direct: Vec<[Option<u32>; 6]> = keys.iter().enumerate().map(lookup).collect();
+
+        // Each direct link, plus its mirror when the neighbour is larger (a
+        // same-size neighbour finds this leaf itself).
+        let (keys_ref, direct_ref) = (&keys, &direct);
+        let links = move || {
+            direct_ref.iter().enumerate().flat_map(move |(i, faces)| {
+                faces
+                    .iter()
+                    .enumerate()
+                    .filter_map(move |(face, nb)| {
+                        let nb = (*nb)?;
+                        let larger = keys_ref[nb as usize].0 < keys_ref[i].0;
+                        let mirror = larger.then_some((nb, opposite(face), i as u32));
+                        Some(std::iter::once((i as u32, face, nb)).chain(mirror))
+                    })
+                    .flatten()
+            })
+        };
+        let mut offsets = vec![0u32; keys.len() * 6 + 1];
+        for (from, face, _) in links() {
+            offsets[6 * from as usize + face + 1] += 1;
+        }
+        for slot in 1..offsets.len() {
+            offsets[slot] += offsets[slot - 1];
+        }
+        let mut fill = offsets.clone();
+        let mut neighbours = vec![0u32; offsets[offsets.len() - 1] as usize];
+        for (from, face, to) in links() {
+            let slot = &mut fill[6 * from as usize + face];
+            neighbours[*slot as usize] = to;
+            *slot += 1;
+        }
+        Self {
+            keys,
+            offsets,
+            neighbours,
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.keys.len()
+    }
+
+    /// Leaf `i`'s neighbours across `face`.
+    fn neighbours(&self, i: usize, face: usize) -> &[u32] {
+        let slot = 6 * i + face;
+        &self.neighbours[self.offsets[slot] as usize..self.offsets[slot + 1] as usize]
+    }
+
+    /// Leaf `i`'s neighbours across all six faces.
+    fn all_neighbours(&self, i: usize) -> &[u32] {
+        &self.neighbours[self.offsets[6 * i] as usize..self.offsets[6 * i + 6] as usize]
+    }
+}
+
+/// Index of the leaf containing the finest-grid cell `code`: the last leaf
+/// starting at or before it. Neighbours sit close in Morton order, so the
+/// search gallops out from `near`, a leaf next to the cell.
+fn containing_leaf(codes: &[u64], near: usize, code: u64) -> usize {
+    let (mut lo, mut hi) = if codes[near] <= code {
+        let mut step = 1;
+        while near + step < codes.len() && codes[near + step] <= code {
+            step *= 2;
+        }
+        (near + step / 2, (near + step).min(codes.len()))
+    } else {
+        let mut step = 1;
+        while step <= near && codes[near - step] > code {
+            step *= 2;
+        }
+        (near.saturating_sub(step), near - step / 2)
+    };
+    // Invariant: codes[lo] <= code, and code < codes[hi] when hi is in range.
+    while hi - lo > 1 {
+        let mid = lo + (hi - lo) / 2;
+        if codes[mid] <= code {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    lo
+}
+
+/// Morton code of a cell's min corner on the [`MAX_LEVEL`] grid: 21 bits per
+/// axis, interleaved.
+fn morton(key: Key) -> u64 {
+    let (l, i, j, k) = key;
+    let shift = MAX_LEVEL - l;
+    let spread = |v: u32| {
+        let mut x = u64::from(v << shift) & 0x1f_ffff;
+        x = (x | x << 32) & 0x1f_0000_0000_ffff;
+        x = (x | x << 16) & 0x1f_0000_ff00_00ff;
+        x = (x | x << 8) & 0x100f_00f0_0f00_f00f;
+        x = (x | x << 4) & 0x10c3_0c30_c30c_30c3;
+        (x | x << 2) & 0x1249_2492_4924_9249
+    };
+    spread(i) | spread(j) << 1 | spread(k) << 2
+}
+
+/// Expand each frontier cell with `f`, in parallel when the frontier is large.
+fn expand_frontier(frontier: &[u32], f: impl Fn(u32, &mut Vec<u32>) + Sync) -> Vec<u32> {
+    #[cfg(not(target_arch = "wasm32"))]
+    if frontier.len() >= PAR_MIN_FRONTIER {
+        return frontier
+            .par_chunks(PAR_MIN_FRONTIER / 4)
+            .flat_map_iter(|chunk| {
+                let mut out = Vec::new();
+                for &i in chunk {
+                    f(i, &mut out);
+                }
+                out
+            })
+            .collect();
+    }
+    let mut out = Vec::new();
+    for &i in frontier {
+        f(i, &mut out);
+    }
+    out
+}
+
+/// The indices below `n` that satisfy `pred`, in parallel natively.
+#[cfg(not(target_arch = "wasm32"))]
+fn select_leaves(n: usize, pred: impl Fn(usize) -> bool + Sync + Send) -> Vec<u32> {
+    (0..n)
+        .into_par_iter()
+        .filter(|&i| pred(i))
+        .map(|i| i as u32)
+        .collect()
+}
+
+/// The indices below `n` that satisfy `pred`; wasm lacks threads.
+#[cfg(target_arch = "wasm32")]
+fn select_leaves(n: usize, pred: impl Fn(usize) -> bool) -> Vec<u32> {
+    (0..n).filter(|&i| pred(i)).map(|i| i as u32).collect()
+}
+
 /// Corner `i` offset, with `i = x + 2y + 4z`.
 const CORNER_OFFSETS: [Vec3; 8] = [
     Vec3::new(0.0, 0.0, 0.0),
@@ -1585,3 +1988,78 @@ fn add_skirts(verts: &mut Vec<Vec3>, tris: &mut Vec<[u32; 3]>, drop: Vec3) {
         tris.push([a, bb, ba]);
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A gently sloped ground sheet with a box standing on it, so the octree
+    /// has fine cells against coarse ones across every face direction.
+    fn ground_and_box() -> (Vec<Vec3>, Vec<[u32; 3]>) {
+        let mut verts = Vec::new();
+        let mut tris = Vec::new();
+        let n = 12u32;
+        for y in 0..=n {
+            for x in 0..=n {
+                let (fx, fy) = (x as f32 * 2.0 - 12.0, y as f32 * 2.0 - 12.0);
+                verts.push(Vec3::new(fx, fy, fx * 0.05));
+            }
+        }
+        for y in 0..n {
+            for x in 0..n {
+                let i = y * (n + 1) + x;
+                tris.push([i, i + 1, i + n + 2]);
+                tris.push([i, i + n + 2, i + n + 1]);
+            }
+        }
+        let base = verts.len() as u32;
+        for c in 0..8u32 {
+            verts.push(Vec3::new(
+                if c & 1 == 0 { -3.0 } else { 3.0 },
+                if c & 2 == 0 { -2.0 } else { 2.0 },
+                if c & 4 == 0 { 0.0 } else { 6.0 },
+            ));
+        }
+        for [a, b, c, d] in [
+            [0, 1, 3, 2],
+            [4, 6, 7, 5],
+            [0, 4, 5, 1],
+            [2, 3, 7, 6],
+            [0, 2, 6, 4],
+            [1, 5, 7, 3],
+        ] {
+            tris.push([base + a, base + b, base + c]);
+            tris.push([base + a, base + c, base + d]);
+        }
+        (verts, tris)
+    }
+
+    #[test]
+    fn leaf_graph_matches_tree_neighbours() {
+        let (verts, tris) = ground_and_box();
+        let settings = Octree3dSettings {
+            near_voxel: 0.5,
+            ring_m: 4.0,
+            far_voxel: 4.0,
+            band_cells: 0.0,
+            seal_cells: 1,
+        };
+        let octree = Octree3d::build(&verts, &tris, Vec3::Z, &settings);
+        let graph = octree.graph.as_ref().unwrap();
+        assert_eq!(graph.len(), octree.stats().0);
+
+        for (i, &key) in graph.keys.iter().enumerate() {
+            for face in 0..6 {
+                let mut linked: Vec<Key> = graph
+                    .neighbours(i, face)
+                    .iter()
+                    .map(|&nb| graph.keys[nb as usize])
+                    .collect();
+                let mut walked = octree.face_neighbours(key, face);
+                linked.sort_unstable();
+                walked.sort_unstable();
+                assert_eq!(linked, walked, "leaf {key:?} face {face}");
+            }
+        }
+    }
+}
@@ -24,7 +24,8 @@
 use glam::{DVec3, Vec2, Vec3};
 
 use crate::{
-    BuildSettings, BuiltGeometry, HorizontalFrame, SurfaceProbe, TileMeshes, build_tile_geometry,
+    BuildSettings, BuiltGeometry, HorizontalFrame, NeighbourSurface, SurfaceProbe, TileMeshes,
+    build_tile_geometry_with_surfaces,
 };
 
 /// Vertical window (m) for the ribbon-ownership probe: a presence test, so it
@@ -240,7 +241,7 @@ impl RoadRibbon {
 }
 
 /// Build one tile's collider and overlay the road ribbons that intersect it:
-/// the base geometry ([`build_tile_geometry`]) with its corridor carved and
+/// the base geometry ([`build_tile_geometry_with_surfaces`]) with its corridor carved and
 /// each ribbon's surface emitted where this tile owns it.
 ///
 /// Ownership is decided by probing the tile's *own* surface (mask and sub-cut
@@ -260,13 +261,14 @@ pub fn build_tile_geometry_with_roads(
     tile: &TileMeshes,
     octant_mask: u8,
     sub_cut: u64,
-    neighbours: &[TileMeshes],
+    neighbours: &[NeighbourSurface],
     down: Vec3,
     settings: &BuildSettings,
     ribbons: &[RoadRibbon],
     carve: &CarveSettings,
 ) -> Option<BuiltGeometry> {
-    let mut built = build_tile_geometry(tile, octant_mask, sub_cut, neighbours, down, settings)?;
+    let mut built =
+        build_tile_geometry_with_surfaces(tile, octant_mask, sub_cut, neighbours, down, settings)?;
     if ribbons.is_empty() {
         return Some(built);
     }
@@ -299,11 +301,10 @@ pub fn build_tile_geometry_with_roads(
 /// finds a surface under, extending each run by one station into its
 /// neighbours so owned pieces meet without a gap.
 fn owned_pieces(ribbon: &RoadRibbon, ownership: &SurfaceProbe) -> Vec<RoadRibbon> {
-    let owned: Vec<bool> = ribbon
-        .stations
-        .iter()
-        .map(|s| ownership.sample_near(s.position, OWNERSHIP_RANGE).is_some())
-        .collect();
+    let positions: Vec<Vec3> = ribbon.stations.iter().map(|s| s.position).collect();
+    let mut heights = vec![0.0; positions.len()];
+    ownership.sample_heights(&positions, OWNERSHIP_RANGE, &mut heights);
+    let owned: Vec<bool> = heights.iter().map(|h| !h.is_nan()).collect();
     let mut pieces = Vec::new();
     let mut i = 0;
     while i < owned.len() {
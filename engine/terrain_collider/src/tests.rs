@@ -51,6 +51,7 @@ fn test_mesh_with_octants(
         texture_format: TextureFormat::Rgb,
         texture_width: 0,
         texture_height: 0,
+        texture_mip_levels: 1,
         has_octant_data,
     }
 }
@@ -131,6 +132,43 @@ fn build_covers_all_meshes() {
     assert!(build_tile_geometry(&tile(&meshes[..1]), 0, 0, &[], Vec3::NEG_Z, &RAW).is_none());
 }
 
+#[test]
+fn staged_build_reports_every_stage_in_order() {
+    let meshes = vec![flat_quad()];
+    let mut stages = Vec::new();
+    let staged =
+        build_tile_geometry_staged(&tile(&meshes), 0, 0, &[], Vec3::NEG_Z, &RAW, &mut |stage| {
+            stages.push(stage)
+        })
+        .unwrap();
+    assert_eq!(
+        stages,
+        [
+            BuildStage::Cluster,
+            BuildStage::Clip,
+            BuildStage::Fuse,
+            BuildStage::Skirts
+        ]
+    );
+    let plain = build_tile_geometry(&tile(&meshes), 0, 0, &[], Vec3::NEG_Z, &RAW).unwrap();
+    assert_eq!(staged.vertices, plain.vertices);
+    assert_eq!(staged.triangles, plain.triangles);
+
+    // An empty build stops once clipping has left nothing.
+    let mut stages = Vec::new();
+    let empty = build_tile_geometry_staged(
+        &tile(&meshes[..0]),
+        0,
+        0,
+        &[],
+        Vec3::NEG_Z,
+        &RAW,
+        &mut |stage| stages.push(stage),
+    );
+    assert!(empty.is_none());
+    assert_eq!(stages, [BuildStage::Cluster, BuildStage::Clip]);
+}
+
 #[test]
 fn build_is_deterministic() {
     let meshes = vec![flat_quad()];
@@ -724,14 +762,14 @@ fn merge_drops_slivers() {
 
 #[test]
 fn strip_to_triangles_empty() {
-    assert!(strip_to_triangles(&[]).is_empty());
-    assert!(strip_to_triangles(&[0, 1]).is_empty());
+    assert!(strip_to_triangle_list(&[]).is_empty());
+    assert!(strip_to_triangle_list(&[0, 1]).is_empty());
 }
 
 #[test]
 fn strip_to_triangles_simple() {
     let strip = vec![0, 1, 2, 3];
-    let triangles = strip_to_triangles(&strip);
+    let triangles = strip_to_triangle_list(&strip);
     // First triangle: [0, 1, 2]. Second: [1, 3, 2] (reversed winding).
     assert_eq!(triangles, vec![[0, 1, 2], [1, 3, 2]]);
 }
@@ -1,35 +1,79 @@
-//! Disk cache for fetched road way-sets (native only).
+//! Disk store for fetched road way-sets (native only).
 //!
-//! Each entry is the JSON-serialized set of [`RoadWay`]s for one quantized
-//! region cell, written atomically (temp file + rename) so a crash mid-write
-//! never leaves a torn entry. Entries carry a fetch timestamp and expire after
-//! [`TTL`], because OSM road data drifts slowly but is not epoch-versioned the
-//! way rocktree tiles are.
+//! Ways are bucketed into fixed [`TILE_DEGREES`] lat/lon tiles, one binary
+//! file per tile, each way kept in every tile it crosses.
+//! Alongside its ways a tile records the boxes that fetches covered inside it
+//! (each with a fetch timestamp, expiring after [`TTL`] because OSM road data
+//! drifts slowly but is not epoch-versioned the way rocktree tiles are). A
+//! query is served whenever live fetches jointly cover it — an exact repeat, a
+//! sub-box, or a box stitched from several earlier fetches — and
+//! [`RoadCache::missing`] names the part that is not covered, so a caller can
+//! fetch only that.
 //!
-//! The cache shares the `<cache dir>/veldera` root with the rest of the project
+//! A tile file is a fixed little-endian layout — header, coverage boxes, way
+//! records, vertices, node ids, each section 8-byte aligned at an offset the
+//! header's counts determine — so a query checks the counts and then decodes
+//! only the ways whose bounds it touches, straight out of the file's bytes (a
+//! memory-mapped view reads the same way). Files are written atomically (temp
+//! file + rename), so a crash mid-write never leaves a torn tile.
+//!
+//! The store shares the `<cache dir>/veldera` root with the rest of the project
 //! (see [`RoadCache::veldera`]) but keeps its own `roads` subdirectory and its
 //! own type — nothing is shared with the rocktree cache but the root path.
 
-use std::time::{Duration, SystemTime, UNIX_EPOCH};
-
-use serde::{Deserialize, Serialize};
+use std::{
+    collections::HashSet,
+    time::{Duration, SystemTime, UNIX_EPOCH},
+};
 
-use crate::{Error, GeoBbox, Result, RoadWay};
+use crate::{Error, GeoBbox, LatLon, Result, RoadClass, RoadWay};
 
-/// The cell size used to quantize a region into a cache key, in degrees.
+/// The side of a store tile, in degrees (roughly 2 km of latitude).
 ///
-/// A region's southwest corner is floored to a multiple of this size, so all
-/// requests landing in the same ≈0.02° cell (roughly 2 km of latitude) share a
-/// cache entry. Callers requesting aligned cells get exact hits; this is a
-/// coarse key, not a spatial index, so an overlapping-but-unaligned request is
-/// a miss rather than a partial hit.
-const CELL_DEGREES: f64 = 0.02;
-
-/// How long a cached entry stays valid before it is treated as a miss.
+/// Small enough that a query reads only the few tiles around it, large enough
+/// that a typical fetch touches a handful of files rather than hundreds.
+const TILE_DEGREES: f64 = 0.02;
+
+/// How long a fetched box stays valid before it stops covering queries.
 const TTL: Duration = Duration::from_secs(4 * 7 * 24 * 60 * 60);
 
-/// A disk-backed cache of fetched road way-sets, keyed by quantized region cell
-/// (native only).
+/// The most coverage boxes a tile keeps; the oldest are dropped beyond this,
+/// which bounds the coverage test's cost on tiles fetched many times over.
+const MAX_COVERAGE_BOXES: usize = 32;
+
+/// Leading bytes of a tile file.
+const MAGIC: [u8; 4] = *b"VRDT";
+
+/// Format version; a file with any other version degrades to a miss.
+const VERSION: u32 = 1;
+
+const HEADER_BYTES: usize = 32;
+const COVERAGE_BYTES: usize = 40;
+const WAY_BYTES: usize = 64;
+const POINT_BYTES: usize = 16;
+const NODE_BYTES: usize = 8;
+
+const FLAG_BRIDGE: u8 = 1 << 0;
+const FLAG_TUNNEL: u8 = 1 << 1;
+
+/// Every [`RoadClass`], indexed by its on-disk code.
+const CLASSES: [RoadClass; 12] = [
+    RoadClass::Motorway,
+    RoadClass::MotorwayLink,
+    RoadClass::Trunk,
+    RoadClass::TrunkLink,
+    RoadClass::Primary,
+    RoadClass::PrimaryLink,
+    RoadClass::Secondary,
+    RoadClass::SecondaryLink,
+    RoadClass::Tertiary,
+    RoadClass::TertiaryLink,
+    RoadClass::Residential,
+    RoadClass::Unclassified,
+];
+
+/// A disk-backed, spatially bucketed store of fetched road way-sets (native
+/// only).
 #[derive(Debug, Clone)]
 pub struct RoadCache {
     dir: std::path::PathBuf,
@@ -62,75 +106,533 @@ impl RoadCache {
         self
     }
 
-    /// Fetch the cached way-set for `region`'s cell, or `None` on a miss or an
-    /// expired entry.
+    /// The ways crossing `region` — what an Overpass fetch of `region`
+    /// returns — or `None` unless live fetches cover all of it.
     pub fn get(&self, region: GeoBbox) -> Result<Option<Vec<RoadWay>>> {
-        let path = self.path_for(region);
-        let bytes = match std::fs::read(&path) {
-            Ok(bytes) => bytes,
-            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(None),
-            Err(e) => {
-                return Err(Error::Cache {
-                    operation: "read",
-                    message: e.to_string(),
-                });
+        let now = now_unix_secs();
+        let mut ways = Vec::new();
+        let mut seen = HashSet::new();
+        for key in tile_keys(region) {
+            let Some(query) = intersection(region, tile_bounds(key)) else {
+                continue;
+            };
+            let Some(bytes) = self.read(key)? else {
+                return Ok(None);
+            };
+            let Some(tile) = TileView::parse(&bytes) else {
+                return Ok(None);
+            };
+            if uncovered(query, &tile.live_coverage(self.ttl, now)).is_some() {
+                return Ok(None);
             }
-        };
-
-        let entry: CacheEntry = match serde_json::from_slice(&bytes) {
-            Ok(entry) => entry,
-            // A corrupt or foreign file degrades to a miss.
-            Err(_) => return Ok(None),
-        };
+            for index in 0..tile.way_count {
+                if intersection(tile.way_bounds(index), region).is_none() {
+                    continue;
+                }
+                let way = tile.way(index);
+                // A way spanning several tiles is stored in each of them.
+                if crosses(region, &way.points)
+                    && (way.node_ids.is_empty() || seen.insert(way.node_ids.clone()))
+                {
+                    ways.push(way);
+                }
+            }
+        }
+        Ok(Some(ways))
+    }
 
-        if entry.is_expired(self.ttl) {
-            return Ok(None);
+    /// The bounding box of the part of `region` no live fetch covers, or
+    /// `None` when [`get`](Self::get) would serve all of it.
+    pub fn missing(&self, region: GeoBbox) -> Result<Option<GeoBbox>> {
+        let now = now_unix_secs();
+        let mut missing = None;
+        for key in tile_keys(region) {
+            let Some(query) = intersection(region, tile_bounds(key)) else {
+                continue;
+            };
+            let coverage = match self.read(key)? {
+                Some(bytes) => TileView::parse(&bytes)
+                    .map(|tile| tile.live_coverage(self.ttl, now))
+                    .unwrap_or_default(),
+                None => Vec::new(),
+            };
+            if let Some(gap) = uncovered(query, &coverage) {
+                missing = Some(union(missing, gap));
+            }
         }
-        Ok(Some(entry.ways))
+        Ok(missing)
     }
 
-    /// Store `ways` for `region`'s cell, stamped with the current time.
+    /// Store `ways`, the result of fetching `region`, stamped with the current
+    /// time. Inside `region` the fetch replaces what the store held; elsewhere
+    /// in the touched tiles earlier fetches stay live.
     pub fn put(&self, region: GeoBbox, ways: &[RoadWay]) -> Result<()> {
-        let entry = CacheEntry {
-            fetched_at_unix_secs: now_unix_secs(),
-            ways: ways.to_vec(),
-        };
-        let bytes = serde_json::to_vec(&entry).map_err(|e| Error::Cache {
-            operation: "serialize",
-            message: e.to_string(),
-        })?;
-        write_atomic(&self.dir, &self.path_for(region), &bytes)
+        let now = now_unix_secs();
+        let fresh_ids: HashSet<&[i64]> = ways
+            .iter()
+            .filter(|w| !w.node_ids.is_empty())
+            .map(|w| w.node_ids.as_slice())
+            .collect();
+        for key in tile_keys(region) {
+            let Some(fetched) = intersection(region, tile_bounds(key)) else {
+                continue;
+            };
+            let (mut coverage, mut stored) = match self.read(key)? {
+                Some(bytes) => TileView::parse(&bytes)
+                    .map(|tile| tile.decode())
+                    .unwrap_or_default(),
+                None => Default::default(),
+            };
+
+            coverage.retain(|c| !c.is_expired(self.ttl, now) && !encloses(fetched, c.bbox));
+            coverage.push(Coverage {
+                bbox: fetched,
+                fetched_at_unix_secs: now,
+            });
+            if coverage.len() > MAX_COVERAGE_BOXES {
+                // Boxes are appended as they are fetched, so the front is oldest.
+                coverage.drain(..coverage.len() - MAX_COVERAGE_BOXES);
+            }
+
+            // The fetch is authoritative inside its box: anything it would have
+            // returned but did not is gone from OSM, and anything it did return
+            // supersedes the stored copy.
+            stored.retain(|w| {
+                !crosses(fetched, &w.points) && !fresh_ids.contains(w.node_ids.as_slice())
+            });
+            stored.extend(
+                ways.iter()
+                    .filter(|w| crosses(tile_bounds(key), &w.points))
+                    .cloned(),
+            );
+            // A way no live box vouches for can never be served again.
+            stored.retain(|w| coverage.iter().any(|c| crosses(c.bbox, &w.points)));
+
+            write_atomic(&self.dir, &self.path_for(key), &encode(&coverage, &stored))?;
+        }
+        Ok(())
+    }
+
+    /// Read a tile's file, or `None` when it has never been written.
+    fn read(&self, key: (i64, i64)) -> Result<Option<Vec<u8>>> {
+        match std::fs::read(self.path_for(key)) {
+            Ok(bytes) => Ok(Some(bytes)),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(None),
+            Err(e) => Err(Error::Cache {
+                operation: "read",
+                message: e.to_string(),
+            }),
+        }
+    }
+
+    /// The on-disk path for a tile.
+    fn path_for(&self, (lat, lon): (i64, i64)) -> std::path::PathBuf {
+        self.dir.join(format!("{lat}_{lon}.roads"))
+    }
+}
+
+/// The tile holding a point: the integer multiples of [`TILE_DEGREES`] at or
+/// below it. Signed indices, so the key is filename-safe and reversible.
+fn tile_of(point: LatLon) -> (i64, i64) {
+    (
+        (point.lat / TILE_DEGREES).floor() as i64,
+        (point.lon / TILE_DEGREES).floor() as i64,
+    )
+}
+
+/// Every tile `region` touches, row by row.
+fn tile_keys(region: GeoBbox) -> impl Iterator<Item = (i64, i64)> {
+    let (south, west) = tile_of(LatLon {
+        lat: region.south,
+        lon: region.west,
+    });
+    let (north, east) = tile_of(LatLon {
+        lat: region.north,
+        lon: region.east,
+    });
+    (south..=north).flat_map(move |lat| (west..=east).map(move |lon| (lat, lon)))
+}
+
+fn tile_bounds((lat, lon): (i64, i64)) -> GeoBbox {
+    GeoBbox::new(
+        lat as f64 * TILE_DEGREES,
+        lon as f64 * TILE_DEGREES,
+        (lat + 1) as f64 * TILE_DEGREES,
+        (lon + 1) as f64 * TILE_DEGREES,
+    )
+}
+
+/// The overlap of two closed boxes, which may be degenerate (a shared edge),
+/// or `None` when they are disjoint.
+fn intersection(a: GeoBbox, b: GeoBbox) -> Option<GeoBbox> {
+    let overlap = GeoBbox::new(
+        a.south.max(b.south),
+        a.west.max(b.west),
+        a.north.min(b.north),
+        a.east.min(b.east),
+    );
+    (overlap.south <= overlap.north && overlap.west <= overlap.east).then_some(overlap)
+}
+
+fn union(a: Option<GeoBbox>, b: GeoBbox) -> GeoBbox {
+    a.map_or(b, |a| {
+        GeoBbox::new(
+            a.south.min(b.south),
+            a.west.min(b.west),
+            a.north.max(b.north),
+            a.east.max(b.east),
+        )
+    })
+}
+
+fn contains(bbox: GeoBbox, point: LatLon) -> bool {
+    (bbox.south..=bbox.north).contains(&point.lat) && (bbox.west..=bbox.east).contains(&point.lon)
+}
+
+/// Whether the polyline through `points` touches `bbox` — the test Overpass
+/// applies to a way when fetching a box.
+fn crosses(bbox: GeoBbox, points: &[LatLon]) -> bool {
+    match points {
+        [point] => contains(bbox, *point),
+        _ => points.windows(2).any(|w| segment_crosses(bbox, w[0], w[1])),
     }
+}
 
-    /// The on-disk path for a region's cell entry.
-    fn path_for(&self, region: GeoBbox) -> std::path::PathBuf {
-        let (cell_lat, cell_lon) = cell_key(region);
-        self.dir.join(format!("{cell_lat}_{cell_lon}.json"))
+/// Whether the segment `from`–`to` touches `bbox`, by clipping its parameter
+/// range against each axis's slab (Liang–Barsky).
+fn segment_crosses(bbox: GeoBbox, from: LatLon, to: LatLon) -> bool {
+    let (mut enter, mut exit) = (0.0f64, 1.0f64);
+    for (start, delta, lo, hi) in [
+        (from.lat, to.lat - from.lat, bbox.south, bbox.north),
+        (from.lon, to.lon - from.lon, bbox.west, bbox.east),
+    ] {
+        if delta == 0.0 {
+            if start < lo || start > hi {
+                return false;
+            }
+            continue;
+        }
+        let (a, b) = ((lo - start) / delta, (hi - start) / delta);
+        enter = enter.max(a.min(b));
+        exit = exit.min(a.max(b));
+        if enter > exit {
+            return false;
+        }
     }
+    true
+}
+
+/// Whether `outer` contains all of `inner`.
+fn encloses(outer: GeoBbox, inner: GeoBbox) -> bool {
+    outer.south <= inner.south
+        && outer.west <= inner.west
+        && outer.north >= inner.north
+        && outer.east >= inner.east
 }
 
-/// Quantize a region to its cell key: the integer multiples of [`CELL_DEGREES`]
-/// at or below the southwest corner. Returned as signed cell indices so the key
-/// is filename-safe and reversible.
-fn cell_key(region: GeoBbox) -> (i64, i64) {
-    let lat = (region.south / CELL_DEGREES).floor() as i64;
-    let lon = (region.west / CELL_DEGREES).floor() as i64;
-    (lat, lon)
+/// The bounding box of the part of `query` that no box in `coverage` covers,
+/// or `None` when they cover all of it.
+///
+/// The box edges inside `query` split it into a grid of cells, each either
+/// wholly inside a coverage box or wholly outside every one of them, so
+/// testing each cell's centre decides the whole cell.
+fn uncovered(query: GeoBbox, coverage: &[Coverage]) -> Option<GeoBbox> {
+    let spans = |lo: f64, hi: f64, edges: &mut dyn Iterator<Item = f64>| {
+        let mut cuts: Vec<f64> = edges.filter(|e| lo < *e && *e < hi).collect();
+        cuts.push(lo);
+        cuts.push(hi);
+        cuts.sort_by(f64::total_cmp);
+        cuts.dedup();
+        if cuts.len() == 1 {
+            // A degenerate query is a line (or point); test it directly.
+            return vec![(lo, hi, lo)];
+        }
+        cuts.windows(2)
+            .map(|w| (w[0], w[1], 0.5 * (w[0] + w[1])))
+            .collect::<Vec<_>>()
+    };
+    let lats = spans(
+        query.south,
+        query.north,
+        &mut coverage.iter().flat_map(|c| [c.bbox.south, c.bbox.north]),
+    );
+    let lons = spans(
+        query.west,
+        query.east,
+        &mut coverage.iter().flat_map(|c| [c.bbox.west, c.bbox.east]),
+    );
+
+    let mut missing = None;
+    for &(south, north, lat) in &lats {
+        for &(west, east, lon) in &lons {
+            let centre = LatLon { lat, lon };
+            if !coverage.iter().any(|c| contains(c.bbox, centre)) {
+                missing = Some(union(missing, GeoBbox::new(south, west, north, east)));
+            }
+        }
+    }
+    missing
 }
 
-/// A stored cache entry: the way-set plus the time it was fetched.
-#[derive(Debug, Serialize, Deserialize)]
-struct CacheEntry {
+/// One fetched box within a tile.
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Coverage {
+    bbox: GeoBbox,
     fetched_at_unix_secs: u64,
-    ways: Vec<RoadWay>,
 }
 
-impl CacheEntry {
-    /// Whether the entry has reached or exceeded `ttl` in age. The boundary is
-    /// inclusive so a zero TTL expires every entry immediately.
-    fn is_expired(&self, ttl: Duration) -> bool {
-        now_unix_secs().saturating_sub(self.fetched_at_unix_secs) >= ttl.as_secs()
+impl Coverage {
+    /// Whether the box has reached or exceeded `ttl` in age. The boundary is
+    /// inclusive so a zero TTL expires every box immediately.
+    fn is_expired(&self, ttl: Duration, now: u64) -> bool {
+        now.saturating_sub(self.fetched_at_unix_secs) >= ttl.as_secs()
+    }
+}
+
+/// A validated tile file, read in place.
+///
+/// Layout (all little-endian, every section starting 8-byte aligned):
+///
+/// ```text
+/// header    magic "VRDT", version u32, coverage/way/point/node counts u32,
+///           8 reserved bytes                                    (32 bytes)
+/// coverage  south, west, north, east f64, fetched-at u64        (40 bytes each)
+/// ways      first point, point count, first node, node count u32,
+///           layer i32, width f32, lanes f32 (NaN when untagged),
+///           class u8, flags u8, 2 reserved bytes,
+///           vertex bounds south, west, north, east f64          (64 bytes each)
+/// points    lat, lon f64                                        (16 bytes each)
+/// nodes     OSM node id i64                                     (8 bytes each)
+/// ```
+struct TileView<'a> {
+    bytes: &'a [u8],
+    coverage_count: usize,
+    way_count: usize,
+    point_count: usize,
+}
+
+impl<'a> TileView<'a> {
+    /// Validate `bytes` as a tile file, or `None` if it is corrupt, foreign or
+    /// from another format version (which degrades to a miss).
+    fn parse(bytes: &'a [u8]) -> Option<Self> {
+        if bytes.len() < HEADER_BYTES || bytes[..4] != MAGIC || u32_at(bytes, 4) != VERSION {
+            return None;
+        }
+        let count = |at| u32_at(bytes, at) as usize;
+        let view = Self {
+            bytes,
+            coverage_count: count(8),
+            way_count: count(12),
+            point_count: count(16),
+        };
+        let node_count = count(20);
+        let len = view
+            .nodes_at()
+            .checked_add(node_count.checked_mul(NODE_BYTES)?)?;
+        if bytes.len() != len {
+            return None;
+        }
+        for index in 0..view.way_count {
+            let at = view.way_at(index);
+            let (first_point, points) = (count(at), count(at + 4));
+            let (first_node, nodes) = (count(at + 8), count(at + 12));
+            if first_point.checked_add(points)? > view.point_count
+                || first_node.checked_add(nodes)? > node_count
+                || usize::from(bytes[at + 28]) >= CLASSES.len()
+            {
+                return None;
+            }
+        }
+        Some(view)
+    }
+
+    fn ways_at(&self) -> usize {
+        HEADER_BYTES + self.coverage_count * COVERAGE_BYTES
+    }
+
+    fn way_at(&self, index: usize) -> usize {
+        self.ways_at() + index * WAY_BYTES
+    }
+
+    fn points_at(&self) -> usize {
+        self.ways_at() + self.way_count * WAY_BYTES
+    }
+
+    fn nodes_at(&self) -> usize {
+        self.points_at() + self.point_count * POINT_BYTES
+    }
+
+    fn coverage(&self, index: usize) -> Coverage {
+        let at = HEADER_BYTES + index * COVERAGE_BYTES;
+        Coverage {
+            bbox: bbox_at(self.bytes, at),
+            fetched_at_unix_secs: u64::from_le_bytes(self.array(at + 32)),
+        }
+    }
+
+    fn live_coverage(&self, ttl: Duration, now: u64) -> Vec<Coverage> {
+        (0..self.coverage_count)
+            .map(|i| self.coverage(i))
+            .filter(|c| !c.is_expired(ttl, now))
+            .collect()
+    }
+
+    fn way_bounds(&self, index: usize) -> GeoBbox {
+        bbox_at(self.bytes, self.way_at(index) + 32)
+    }
+
+    fn way(&self, index: usize) -> RoadWay {
+        let at = self.way_at(index);
+        let count = |at| u32_at(self.bytes, at) as usize;
+        let (first_point, points) = (count(at), count(at + 4));
+        let (first_node, nodes) = (count(at + 8), count(at + 12));
+        let tag = |at| Some(f32::from_le_bytes(self.array(at))).filter(|v| !v.is_nan());
+        let flags = self.bytes[at + 29];
+        RoadWay {
+            node_ids: (first_node..first_node + nodes)
+                .map(|i| i64::from_le_bytes(self.array(self.nodes_at() + i * NODE_BYTES)))
+                .collect(),
+            points: (first_point..first_point + points)
+                .map(|i| {
+                    let at = self.points_at() + i * POINT_BYTES;
+                    LatLon {
+                        lat: f64_at(self.bytes, at),
+                        lon: f64_at(self.bytes, at + 8),
+                    }
+                })
+                .collect(),
+            class: CLASSES[usize::from(self.bytes[at + 28])],
+            bridge: flags & FLAG_BRIDGE != 0,
+            tunnel: flags & FLAG_TUNNEL != 0,
+            layer: i32::from_le_bytes(self.array(at + 16)),
+            width: tag(at + 20),
+            lanes: tag(at + 24),
+        }
+    }
+
+    /// Everything in the tile, for rewriting it.
+    fn decode(&self) -> (Vec<Coverage>, Vec<RoadWay>) {
+        (
+            (0..self.coverage_count).map(|i| self.coverage(i)).collect(),
+            (0..self.way_count).map(|i| self.way(i)).collect(),
+        )
+    }
+
+    fn array<const N: usize>(&self, at: usize) -> [u8; N] {
+        array_at(self.bytes, at)
+    }
+}
+
+fn array_at<const N: usize>(bytes: &[u8], at: usize) -> [u8; N] {
+    bytes[at..at + N]
+        .try_into()
+        .expect("slice length matches the array length")
+}
+
+fn u32_at(bytes: &[u8], at: usize) -> u32 {
+    u32::from_le_bytes(array_at(bytes, at))
+}
+
+fn f64_at(bytes: &[u8], at: usize) -> f64 {
+    f64::from_le_bytes(array_at(bytes, at))
+}
+
+fn bbox_at(bytes: &[u8], at: usize) -> GeoBbox {
+    GeoBbox::new(
+        f64_at(bytes, at),
+        f64_at(bytes, at + 8),
+        f64_at(bytes, at + 16),
+        f64_at(bytes, at + 24),
+    )
+}
+
+/// Serialize a tile in the [`TileView`] layout. Ways without vertices are
+/// dropped: no query can ever return them.
+fn encode(coverage: &[Coverage], ways: &[RoadWay]) -> Vec<u8> {
+    let ways: Vec<&RoadWay> = ways.iter().filter(|w| !w.points.is_empty()).collect();
+    let point_count: usize = ways.iter().map(|w| w.points.len()).sum();
+    let node_count: usize = ways.iter().map(|w| w.node_ids.len()).sum();
+
+    let mut out = Vec::with_capacity(
+        HEADER_BYTES
+            + coverage.len() * COVERAGE_BYTES
+            + ways.len() * WAY_BYTES
+            + point_count * POINT_BYTES
+            + node_count * NODE_BYTES,
+    );
+    let put_bbox = |out: &mut Vec<u8>, bbox: GeoBbox| {
+        for value in [bbox.south, bbox.west, bbox.north, bbox.east] {
+            out.extend_from_slice(&value.to_le_bytes());
+        }
+    };
+
+    out.extend_from_slice(&MAGIC);
+    for value in [
+        VERSION,
+        coverage.len() as u32,
+        ways.len() as u32,
+        point_count as u32,
+        node_count as u32,
+        0,
+        0,
+    ] {
+        out.extend_from_slice(&value.to_le_bytes());
+    }
+
+    for c in coverage {
+        put_bbox(&mut out, c.bbox);
+        out.extend_from_slice(&c.fetched_at_unix_secs.to_le_bytes());
+    }
+
+    let (mut first_point, mut first_node) = (0u32, 0u32);
+    for way in &ways {
+        let bounds = way.points.iter().fold(
+            GeoBbox::new(
+                f64::INFINITY,
+                f64::INFINITY,
+                f64::NEG_INFINITY,
+                f64::NEG_INFINITY,
+            ),
+            |b, p| {
+                GeoBbox::new(
+                    b.south.min(p.lat),
+                    b.west.min(p.lon),
+                    b.north.max(p.lat),
+                    b.east.max(p.lon),
+                )
+            },
+        );
+        let class = CLASSES
+            .iter()
+            .position(|c| *c == way.class)
+            .expect("CLASSES lists every road class") as u8;
+        let flags =
+            if way.bridge { FLAG_BRIDGE } else { 0 } | if way.tunnel { FLAG_TUNNEL } else { 0 };
+        for value in [
+            first_point,
+            way.points.len() as u32,
+            first_node,
+            way.node_ids.len() as u32,
+        ] {
+            out.extend_from_slice(&value.to_le_bytes());
+        }
+        out.extend_from_slice(&way.layer.to_le_bytes());
+        out.extend_from_slice(&way.width.unwrap_or(f32::NAN).to_le_bytes());
+        out.extend_from_slice(&way.lanes.unwrap_or(f32::NAN).to_le_bytes());
+        out.extend_from_slice(&[class, flags, 0, 0]);
+        put_bbox(&mut out, bounds);
+        first_point += way.points.len() as u32;
+        first_node += way.node_ids.len() as u32;
     }
+
+    for point in ways.iter().flat_map(|w| &w.points) {
+        out.extend_from_slice(&point.lat.to_le_bytes());
+        out.extend_from_slice(&point.lon.to_le_bytes());
+    }
+    for id in ways.iter().flat_map(|w| &w.node_ids) {
+        out.extend_from_slice(&id.to_le_bytes());
+    }
+    out
 }
 
 /// The current Unix time in whole seconds, or `0` if the clock is before the
@@ -179,7 +681,6 @@ fn write_atomic(dir: &std::path::Path, path: &std::path::Path, bytes: &[u8]) ->
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::{LatLon, RoadClass};
 
     fn temp_dir() -> std::path::PathBuf {
         use std::sync::atomic::{AtomicU64, Ordering};
@@ -191,47 +692,75 @@ mod tests {
         ))
     }
 
-    fn sample_way() -> RoadWay {
+    fn way(node_ids: [i64; 2], from: (f64, f64), to: (f64, f64)) -> RoadWay {
         RoadWay {
-            node_ids: vec![1, 2],
+            node_ids: node_ids.to_vec(),
             points: vec![
                 LatLon {
-                    lat: 40.7,
-                    lon: -74.0,
+                    lat: from.0,
+                    lon: from.1,
                 },
                 LatLon {
-                    lat: 40.71,
-                    lon: -74.01,
+                    lat: to.0,
+                    lon: to.1,
                 },
             ],
             class: RoadClass::Residential,
             bridge: false,
-            tunnel: false,
-            layer: 0,
+            tunnel: true,
+            layer: -1,
             width: Some(3.5),
-            lanes: Some(2.0),
+            lanes: None,
         }
     }
 
+    fn sample_way() -> RoadWay {
+        way([1, 2], (40.7, -74.0), (40.71, -74.01))
+    }
+
     #[test]
-    fn cell_key_floors_to_the_grid() {
+    fn tile_of_floors_to_the_grid() {
         // 40.715 / 0.02 = 2035.75 -> floor 2035; -74.013 / 0.02 = -3700.65 ->
         // floor -3701.
         assert_eq!(
-            cell_key(GeoBbox::new(40.715, -74.013, 40.74, -74.0)),
+            tile_of(LatLon {
+                lat: 40.715,
+                lon: -74.013
+            }),
             (2035, -3701)
         );
-        // Two regions sharing the same southwest cell map to the same key.
+        // A box straddling a tile corner touches all four tiles around it.
+        let keys: Vec<_> = tile_keys(GeoBbox::new(40.71, -74.01, 40.73, -73.99)).collect();
         assert_eq!(
-            cell_key(GeoBbox::new(40.710, -74.019, 41.0, -73.0)),
-            cell_key(GeoBbox::new(40.719, -74.001, 40.8, -73.5))
+            keys,
+            [(2035, -3701), (2035, -3700), (2036, -3701), (2036, -3700)]
         );
     }
 
+    #[test]
+    fn tiles_roundtrip_through_the_binary_layout() {
+        let coverage = [Coverage {
+            bbox: GeoBbox::new(40.70, -74.02, 40.72, -74.0),
+            fetched_at_unix_secs: 1234,
+        }];
+        let ways = [
+            sample_way(),
+            way([3, 4], (40.701, -74.001), (40.702, -74.002)),
+        ];
+        let bytes = encode(&coverage, &ways);
+        assert_eq!(bytes.len() % 8, 0);
+        let tile = TileView::parse(&bytes).unwrap();
+        assert_eq!(tile.decode(), (coverage.to_vec(), ways.to_vec()));
+
+        // Truncation and foreign bytes are rejected rather than misread.
+        assert!(TileView::parse(&bytes[..bytes.len() - 8]).is_none());
+        assert!(TileView::parse(b"{\"fetched_at_unix_secs\":0,\"ways\":[]}").is_none());
+    }
+
     #[test]
     fn roundtrip_and_ttl_expiry() {
         let dir = temp_dir();
-        let region = GeoBbox::new(40.71, -74.05, 40.73, -74.03);
+        let region = GeoBbox::new(40.69, -74.05, 40.73, -73.99);
         let ways = vec![sample_way()];
 
         // Fresh cache (long TTL): miss, store, hit.
@@ -239,15 +768,69 @@ mod tests {
         assert_eq!(cache.get(region).unwrap(), None);
         cache.put(region, &ways).unwrap();
         assert_eq!(cache.get(region).unwrap(), Some(ways.clone()));
+        assert_eq!(cache.missing(region).unwrap(), None);
 
-        // A zero TTL treats the just-written entry as expired.
+        // A zero TTL treats the just-written fetch as expired.
         let expired = RoadCache::new(&dir).with_ttl(Duration::from_secs(0));
         assert_eq!(expired.get(region).unwrap(), None);
+        assert_eq!(expired.missing(region).unwrap(), Some(region));
 
-        // An unaligned, non-overlapping region is a separate cell and misses.
+        // A region elsewhere was never fetched and misses.
         let other = GeoBbox::new(41.50, -73.00, 41.52, -72.98);
         assert_eq!(cache.get(other).unwrap(), None);
 
         std::fs::remove_dir_all(&dir).unwrap();
     }
+
+    #[test]
+    fn covered_queries_are_served_and_gaps_named() {
+        let dir = temp_dir();
+        let cache = RoadCache::new(&dir);
+        let west = GeoBbox::new(40.695, -74.035, 40.715, -74.005);
+        let inside = way([1, 2], (40.70, -74.03), (40.701, -74.031));
+        let crossing = way([3, 4], (40.71, -74.01), (40.71, -73.99));
+        cache
+            .put(west, &[inside.clone(), crossing.clone()])
+            .unwrap();
+
+        // A sub-box is served, with only the ways that have a vertex in it.
+        let sub = GeoBbox::new(40.698, -74.032, 40.702, -74.028);
+        assert_eq!(cache.get(sub).unwrap(), Some(vec![inside.clone()]));
+
+        // So is one the crossing way passes through between its vertices.
+        let between = GeoBbox::new(40.709, -74.008, 40.711, -74.006);
+        assert_eq!(cache.get(between).unwrap(), Some(vec![crossing.clone()]));
+
+        // A box reaching past the fetch misses, and names just the gap.
+        let wide = GeoBbox::new(40.695, -74.035, 40.715, -73.985);
+        assert_eq!(cache.get(wide).unwrap(), None);
+        let gap = cache.missing(wide).unwrap().unwrap();
+        assert!((gap.west - west.east).abs() < 1e-12, "{gap:?}");
+        assert_eq!(
+            (gap.south, gap.north, gap.east),
+            (wide.south, wide.north, wide.east)
+        );
+
+        // Fetching the gap completes the cover; the way both fetches returned
+        // comes back once.
+        let east = way([5, 6], (40.705, -73.99), (40.706, -73.991));
+        cache.put(gap, &[crossing.clone(), east.clone()]).unwrap();
+        let mut served = cache.get(wide).unwrap().unwrap();
+        served.sort_by_key(|w| w.node_ids[0]);
+        assert_eq!(served, vec![inside, crossing, east]);
+
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
+
+    #[test]
+    fn a_refetch_drops_ways_it_no_longer_returns() {
+        let dir = temp_dir();
+        let cache = RoadCache::new(&dir);
+        let region = GeoBbox::new(40.695, -74.035, 40.715, -74.005);
+        cache.put(region, &[sample_way()]).unwrap();
+        cache.put(region, &[]).unwrap();
+        assert_eq!(cache.get(region).unwrap(), Some(Vec::new()));
+
+        std::fs::remove_dir_all(&dir).unwrap();
+    }
 }
@@ -2,9 +2,10 @@
 //!
 //! Builds an Overpass QL query for a region, POSTs it to the public Overpass
 //! endpoint, parses the returned JSON into [`RoadWay`]s, and (on native targets)
-//! caches the result on disk. Politeness is enforced by a single in-flight
-//! request guard and exponential backoff on the transient `429`/`504` statuses
-//! Overpass uses for rate limiting and gateway timeouts.
+//! caches the result on disk, fetching only the part of a region the cache does
+//! not already cover. Politeness is enforced by a single in-flight request
+//! guard and exponential backoff on the transient `429`/`504` statuses Overpass
+//! uses for rate limiting and gateway timeouts.
 
 use std::{future::Future, sync::Arc};
 
@@ -71,10 +72,22 @@ impl OverpassRoadSource {
     /// Fetch road ways for `region`, consulting and populating the cache.
     async fn fetch_region(&self, region: GeoBbox) -> Result<Vec<RoadWay>> {
         #[cfg(not(target_family = "wasm"))]
-        if let Some(cache) = &self.cache
-            && let Some(ways) = cache.get(region)?
-        {
-            return Ok(ways);
+        if let Some(cache) = &self.cache {
+            if let Some(ways) = cache.get(region)? {
+                return Ok(ways);
+            }
+            // Earlier fetches may cover most of the region; query Overpass for
+            // only the rest, then serve the whole region from the cache.
+            if let Some(missing) = cache.missing(region)?
+                && missing != region
+            {
+                let _guard = self.in_flight.lock().await;
+                let ways = self.post_with_backoff(&query_for(missing)).await?;
+                cache.put(missing, &ways)?;
+                if let Some(ways) = cache.get(region)? {
+                    return Ok(ways);
+                }
+            }
         }
 
         // Serialize network access so only one Overpass query is ever in
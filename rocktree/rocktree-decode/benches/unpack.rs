@@ -0,0 +1,379 @@
+//! Per-stage throughput of the decode pipeline.
+//!
+//! Replays the raw `NodeData` responses recorded by the `record_fixtures`
+//! example (see `rocktree/rocktree/examples`), grouped into bulk-sized depth
+//! bands since small near-root tiles and dense leaf tiles stress different
+//! paths. Without a corpus a synthetic one covers the geometry stages, so
+//! the suite always runs.
+//!
+//! ```text
+//! cargo bench -p rocktree-decode --bench unpack
+//! ```
+
+use std::{hint::black_box, path::PathBuf};
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use prost::Message;
+use rocktree_decode::{
+    Vertex, strip_to_triangles, texture, unpack_indices, unpack_normals,
+    unpack_octant_mask_and_layer_bounds, unpack_tex_coords, unpack_vertices,
+};
+use rocktree_proto as proto;
+
+/// Packed buffers of one mesh, plus the node-level normal table.
+struct MeshInput {
+    vertices: Vec<u8>,
+    indices: Vec<u8>,
+    texcoords: Vec<u8>,
+    octants: Vec<u8>,
+    normals: Vec<u8>,
+    normal_lookup: Vec<u8>,
+    texture: Option<(Vec<u8>, i32)>,
+}
+
+/// Meshes from one depth band.
+struct Band {
+    label: String,
+    meshes: Vec<MeshInput>,
+}
+
+/// Load the recorded corpus, or `None` if there isn't one.
+fn load_fixtures() -> Option<Vec<Band>> {
+    let dir = std::env::var_os("ROCKTREE_FIXTURES").map_or_else(
+        || PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("../fixtures"),
+        PathBuf::from,
+    );
+    let mut bands: Vec<Band> = Vec::new();
+    for entry in std::fs::read_dir(dir).ok()?.flatten() {
+        let name = entry.file_name();
+        let Some(path) = name
+            .to_str()
+            .and_then(|n| n.strip_prefix("node-")?.strip_suffix(".pb"))
+        else {
+            continue;
+        };
+        let Ok(data) = std::fs::read(entry.path()) else {
+            continue;
+        };
+        let Ok(node) = proto::NodeData::decode(&data[..]) else {
+            continue;
+        };
+
+        // Bands follow the bulk boundaries: depths 1-4, 5-8, ...
+        let first = path.len().saturating_sub(1) / 4 * 4 + 1;
+        let label = format!("depth {first:02}-{:02}", first + 3);
+        let index = match bands.iter().position(|b| b.label == label) {
+            Some(index) => index,
+            None => {
+                bands.push(Band {
+                    label,
+                    meshes: Vec::new(),
+                });
+                bands.len() - 1
+            }
+        };
+        let normal_lookup = node
+            .for_normals
+            .as_deref()
+            .and_then(|data| rocktree_decode::unpack_for_normals(data).ok())
+            .unwrap_or_default();
+        bands[index]
+            .meshes
+            .extend(node.meshes.into_iter().map(|mesh| MeshInput {
+                vertices: mesh.vertices.unwrap_or_default(),
+                indices: mesh.indices.unwrap_or_default(),
+                texcoords: mesh.texture_coordinates.unwrap_or_default(),
+                octants: mesh.layer_and_octant_counts.unwrap_or_default(),
+                normals: mesh.normals.unwrap_or_default(),
+                normal_lookup: normal_lookup.clone(),
+                texture: mesh.texture.into_iter().next().and_then(|t| {
+                    let format = t.format.unwrap_or(proto::texture::Format::Jpg as i32);
+                    Some((t.data.into_iter().next()?, format))
+                }),
+            }));
+    }
+    bands.sort_by(|a, b| a.label.cmp(&b.label));
+    (!bands.is_empty()).then_some(bands)
+}
+
+/// A deterministic stand-in corpus: leaf-sized meshes with realistic strip
+/// statistics (mostly fresh vertices, short back-references).
+fn synthetic() -> Vec<Band> {
+    let mut state = 0x9E37_79B9_u32;
+    let mut next = move || {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        state
+    };
+    let meshes = (0..16)
+        .map(|_| {
+            let vertex_count = 4000;
+            let vertices = (0..vertex_count * 3).map(|_| next() as u8).collect();
+
+            let strip_len: u32 = 12_000;
+            let mut indices = Vec::new();
+            let mut zeros = 0;
+            push_varint(&mut indices, strip_len);
+            for _ in 0..strip_len {
+                let back = if zeros == 0 || next() % 3 == 0 {
+                    0
+                } else {
+                    1 + next() % zeros.min(24)
+                };
+                zeros += u32::from(back == 0);
+                push_varint(&mut indices, back);
+            }
+
+            MeshInput {
+                vertices,
+                indices,
+                texcoords: Vec::new(),
+                octants: Vec::new(),
+                normals: Vec::new(),
+                normal_lookup: Vec::new(),
+                texture: None,
+            }
+        })
+        .collect();
+    vec![Band {
+        label: "synthetic".to_string(),
+        meshes,
+    }]
+}
+
+fn push_varint(out: &mut Vec<u8>, mut value: u32) {
+    while value >= 0x80 {
+        out.push((value as u8) | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+/// Sum of a per-mesh byte count.
+fn bytes(meshes: &[&MeshInput], f: impl Fn(&MeshInput) -> usize) -> Throughput {
+    Throughput::Bytes(meshes.iter().map(|&m| f(m)).sum::<usize>() as u64)
+}
+
+fn stages(c: &mut Criterion) {
+    let bands = load_fixtures().unwrap_or_else(|| {
+        eprintln!("No rocktree fixtures found; benchmarking a synthetic corpus");
+        synthetic()
+    });
+
+    for band in &bands {
+        let all: Vec<&MeshInput> = band.meshes.iter().collect();
+        let id = || BenchmarkId::from_parameter(&band.label);
+        let decoded: Vec<(Vec<Vertex>, Vec<u16>)> = all
+            .iter()
+            .map(|m| {
+                (
+                    unpack_vertices(&m.vertices).unwrap_or_default(),
+                    unpack_indices(&m.indices).unwrap_or_default(),
+                )
+            })
+            .collect();
+
+        let mut group = c.benchmark_group("vertices");
+        group.throughput(bytes(&all, |m| m.vertices.len()));
+        group.bench_function(id(), |b| {
+            b.iter(|| {
+                for m in &all {
+                    black_box(unpack_vertices(black_box(&m.vertices)).ok());
+                }
+            });
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("indices");
+        group.throughput(bytes(&all, |m| m.indices.len()));
+        group.bench_function(id(), |b| {
+            b.iter(|| {
+                for m in &all {
+                    black_box(unpack_indices(black_box(&m.indices)).ok());
+                }
+            });
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("strip_to_triangles");
+        group.throughput(Throughput::Bytes(
+            decoded.iter().map(|(_, i)| i.len() as u64 * 2).sum(),
+        ));
+        group.bench_function(id(), |b| {
+            b.iter(|| {
+                for (_, strip) in &decoded {
+                    black_box(strip_to_triangles(black_box(strip)));
+                }
+            });
+        });
+        group.finish();
+
+        // The in-place stages mutate vertices, so each iteration works on a
+        // fresh copy; the copy is excluded from the timing.
+        let uv: Vec<_> = all
+            .iter()
+            .zip(&decoded)
+            .filter(|(m, (v, _))| !m.texcoords.is_empty() && !v.is_empty())
+            .collect();
+        if !uv.is_empty() {
+            let mut group = c.benchmark_group("texcoords");
+            group.throughput(Throughput::Bytes(
+                uv.iter().map(|(m, _)| m.texcoords.len() as u64).sum(),
+            ));
+            group.bench_function(id(), |b| {
+                b.iter_batched_ref(
+                    || uv.iter().map(|(_, (v, _))| v.clone()).collect::<Vec<_>>(),
+                    |vertices| {
+                        for ((m, _), v) in uv.iter().zip(vertices) {
+                            black_box(unpack_tex_coords(&m.texcoords, v).ok());
+                        }
+                    },
+                    criterion::BatchSize::LargeInput,
+                );
+            });
+            group.finish();
+        }
+
+        let octants: Vec<_> = all
+            .iter()
+            .zip(&decoded)
+            .filter(|(m, (v, i))| !m.octants.is_empty() && !v.is_empty() && !i.is_empty())
+            .collect();
+        if !octants.is_empty() {
+            let mut group = c.benchmark_group("octant_masks");
+            group.throughput(Throughput::Bytes(
+                octants.iter().map(|(m, _)| m.octants.len() as u64).sum(),
+            ));
+            group.bench_function(id(), |b| {
+                b.iter_batched_ref(
+                    || {
+                        octants
+                            .iter()
+                            .map(|(_, (v, _))| v.clone())
+                            .collect::<Vec<_>>()
+                    },
+                    |vertices| {
+                        for ((m, (_, i)), v) in octants.iter().zip(vertices) {
+                            black_box(unpack_octant_mask_and_layer_bounds(&m.octants, i, v).ok());
+                        }
+                    },
+                    criterion::BatchSize::LargeInput,
+                );
+            });
+            group.finish();
+        }
+
+        let normals: Vec<_> = all
+            .iter()
+            .zip(&decoded)
+            .filter(|(m, _)| !m.normals.is_empty() && !m.normal_lookup.is_empty())
+            .collect();
+        if !normals.is_empty() {
+            let mut group = c.benchmark_group("normals");
+            group.throughput(Throughput::Bytes(
+                normals.iter().map(|(m, _)| m.normals.len() as u64).sum(),
+            ));
+            group.bench_function(id(), |b| {
+                b.iter(|| {
+                    for (m, (v, _)) in &normals {
+                        black_box(
+                            unpack_normals(
+                                Some(&m.normals[..]),
+                                Some(&m.normal_lookup[..]),
+                                v.len(),
+                            )
+                            .ok(),
+                        );
+                    }
+                });
+            });
+            group.finish();
+        }
+
+        textures(c, &all, &band.label);
+
+        // The geometry chain the client runs per mesh, as meshes/s.
+        let mut group = c.benchmark_group("mesh_geometry");
+        group.throughput(Throughput::Elements(all.len() as u64));
+        group.bench_function(id(), |b| {
+            b.iter(|| {
+                for m in &all {
+                    let Ok(mut vertices) = unpack_vertices(&m.vertices) else {
+                        continue;
+                    };
+                    let indices = unpack_indices(&m.indices).unwrap_or_default();
+                    if !m.texcoords.is_empty() && !vertices.is_empty() {
+                        black_box(unpack_tex_coords(&m.texcoords, &mut vertices).ok());
+                    }
+                    if !m.octants.is_empty() && !vertices.is_empty() && !indices.is_empty() {
+                        black_box(
+                            unpack_octant_mask_and_layer_bounds(
+                                &m.octants,
+                                &indices,
+                                &mut vertices,
+                            )
+                            .ok(),
+                        );
+                    }
+                    black_box(strip_to_triangles(&indices));
+                    black_box(vertices);
+                }
+            });
+        });
+        group.finish();
+    }
+}
+
+type Decoder = fn(&[u8]) -> rocktree_decode::DecodeResult<texture::DecodedTexture>;
+
+/// Texture decoders, throughput in compressed bytes.
+fn textures(c: &mut Criterion, meshes: &[&MeshInput], label: &str) {
+    let of_format = |format: proto::texture::Format| -> Vec<&[u8]> {
+        meshes
+            .iter()
+            .filter_map(|m| m.texture.as_ref())
+            .filter(|(_, f)| *f == format as i32)
+            .map(|(data, _)| data.as_slice())
+            .collect()
+    };
+    let decoders: [(&str, Vec<&[u8]>, Decoder); 3] = [
+        (
+            "texture_jpeg",
+            of_format(proto::texture::Format::Jpg),
+            texture::decode_jpeg_to_rgba,
+        ),
+        (
+            "texture_crn_rgba",
+            of_format(proto::texture::Format::CrnDxt1),
+            texture::decode_crn_to_rgba,
+        ),
+        (
+            "texture_crn_bc1",
+            of_format(proto::texture::Format::CrnDxt1),
+            texture::decode_crn_to_bc1,
+        ),
+    ];
+    for (name, inputs, decode) in decoders {
+        if inputs.is_empty() {
+            continue;
+        }
+        let mut group = c.benchmark_group(name);
+        // Textures are large and slow; fewer samples keep the suite short.
+        group.sample_size(20);
+        group.throughput(Throughput::Bytes(
+            inputs.iter().map(|d| d.len() as u64).sum(),
+        ));
+        group.bench_function(BenchmarkId::from_parameter(label), |b| {
+            b.iter(|| {
+                for data in &inputs {
+                    black_box(decode(black_box(data)).ok());
+                }
+            });
+        });
+        group.finish();
+    }
+}
+
+criterion_group!(benches, stages);
+criterion_main!(benches);
@@ -1,6 +1,6 @@
 //! Index unpacking.
 
-use crate::{error::DecodeResult, varint::read_varint};
+use crate::{error::DecodeResult, simd, varint::read_varint};
 
 /// Unpack varint-encoded triangle strip indices.
 ///
@@ -30,14 +30,24 @@ pub fn unpack_indices(packed: &[u8]) -> DecodeResult<Vec<u16>> {
     let mut triangle_strip = Vec::with_capacity(strip_len);
     let mut zeros: u32 = 0;
 
-    for _ in 0..strip_len {
-        let val = read_varint(packed, &mut offset)?;
-        // Index is zeros - val. Both are u32, result fits in u16.
-        let index = zeros.wrapping_sub(val) as u16;
-        triangle_strip.push(index);
-
-        if val == 0 {
-            zeros += 1;
+    while triangle_strip.len() < strip_len {
+        // Nearly every value is a single-byte varint; decode runs of them
+        // without the general varint loop.
+        let remaining = strip_len - triangle_strip.len();
+        let run = simd::single_byte_run(&packed[offset..]).min(remaining);
+        for &val in &packed[offset..offset + run] {
+            // Index is zeros - val; the result fits in u16.
+            triangle_strip.push(zeros.wrapping_sub(u32::from(val)) as u16);
+            zeros += u32::from(val == 0);
+        }
+        offset += run;
+
+        if triangle_strip.len() < strip_len {
+            let val = read_varint(packed, &mut offset)?;
+            triangle_strip.push(zeros.wrapping_sub(val) as u16);
+            if val == 0 {
+                zeros += 1;
+            }
         }
     }
 
@@ -52,34 +62,22 @@ pub fn unpack_indices(packed: &[u8]) -> DecodeResult<Vec<u16>> {
 /// Degenerate triangles (where any two vertices are the same) are skipped.
 #[must_use]
 pub fn strip_to_triangles(strip: &[u16]) -> Vec<u16> {
-    if strip.len() < 3 {
-        return Vec::new();
-    }
-
-    let mut triangles = Vec::with_capacity(strip.len() * 3);
-
-    for (i, window) in strip.windows(3).enumerate() {
-        let a = window[0];
-        let b = window[1];
-        let c = window[2];
-
-        // Skip degenerate triangles.
-        if a == b || a == c || b == c {
-            continue;
-        }
-
-        // Alternate winding order for each triangle.
-        if i % 2 == 0 {
-            triangles.push(a);
-            triangles.push(b);
-            triangles.push(c);
-        } else {
-            triangles.push(a);
-            triangles.push(c);
-            triangles.push(b);
-        }
-    }
+    let mut triangles = Vec::with_capacity(strip.len().saturating_sub(2) * 3);
+    simd::for_each_strip_triangle(strip, |triangle| triangles.extend(triangle));
+    triangles
+}
 
+/// Convert triangle strip to a list of triangles with `u32` indices, as
+/// collision trimeshes take them.
+///
+/// The triangles are the same, in the same order, as
+/// [`strip_to_triangles`].
+#[must_use]
+pub fn strip_to_triangle_list(strip: &[u16]) -> Vec<[u32; 3]> {
+    let mut triangles = Vec::with_capacity(strip.len().saturating_sub(2));
+    simd::for_each_strip_triangle(strip, |[a, b, c]| {
+        triangles.push([u32::from(a), u32::from(b), u32::from(c)]);
+    });
     triangles
 }
 
@@ -153,4 +151,33 @@ mod tests {
         let triangles = strip_to_triangles(&strip);
         assert!(triangles.is_empty());
     }
+
+    #[test]
+    fn test_unpack_indices_multi_byte_varint() {
+        // Length = 4, values = [0, 0, 300, 0]; 300 is the two-byte varint
+        // [0xAC, 0x02], breaking the single-byte run.
+        // i=2: val=300, index=2-300 wraps to 65238.
+        let packed = [4, 0, 0, 0xAC, 0x02, 0];
+        let result = unpack_indices(&packed).unwrap();
+        assert_eq!(result, vec![0, 1, 65238, 2]);
+    }
+
+    #[test]
+    fn test_unpack_indices_truncated() {
+        // Length = 3 but only two values follow.
+        assert!(unpack_indices(&[3, 0, 0]).is_err());
+        assert!(unpack_indices(&[3, 0, 0, 0x80]).is_err());
+    }
+
+    #[test]
+    fn test_strip_to_triangle_list_matches_flat() {
+        let strip = vec![0, 1, 2, 2, 3, 4, 5, 5, 6, 7, 8, 9, 10, 11, 12];
+        let flat = strip_to_triangles(&strip);
+        let list: Vec<u16> = strip_to_triangle_list(&strip)
+            .into_iter()
+            .flatten()
+            .map(|i| i as u16)
+            .collect();
+        assert_eq!(list, flat);
+    }
 }
@@ -10,17 +10,23 @@
 //! - **Synchronous**: No async, no threading primitives
 //! - **User-controlled parallelism**: Client decides how to parallelize
 //! - **Web-compatible**: Compiles to WASM
+//! - **Vectorised where it counts**: the delta-decode and strip-expansion
+//!   loops have SSE2/AVX2, NEON and wasm simd128 kernels, bit-exact with
+//!   their scalar versions
 //!
 //! # Key functions
 //!
 //! - [`unpack_vertices`]: Delta-decode XYZ vertex positions
 //! - [`unpack_tex_coords`]: Unpack UV texture coordinates
 //! - [`unpack_indices`]: Decode varint-encoded triangle strip indices
+//! - [`strip_to_triangles`]: Expand a triangle strip into a triangle list
 //! - [`unpack_obb`]: Decode oriented bounding box from 15 bytes
 //! - [`unpack_path_and_flags`]: Extract octant path and flags from metadata
 //! - [`texture::decode_texture`]: Decode JPEG or CRN textures to RGBA
+//! - [`texture::decode_texture_compressed`]: Decode textures, keeping CRN as BC1
 
 mod error;
+mod simd;
 mod varint;
 
 pub mod indices;
@@ -34,7 +40,7 @@ pub mod texture;
 pub mod vertices;
 
 pub use error::{DecodeError, DecodeResult};
-pub use indices::{strip_to_triangles, unpack_indices};
+pub use indices::{strip_to_triangle_list, strip_to_triangles, unpack_indices};
 pub use normals::{unpack_for_normals, unpack_normals};
 pub use obb::unpack_obb;
 pub use octants::unpack_octant_mask_and_layer_bounds;
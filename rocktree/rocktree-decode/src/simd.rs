@@ -0,0 +1,516 @@
+//! SIMD kernels for the mesh-decoding hot loops.
+//!
+//! Each kernel has a scalar reference implementation and vector versions
+//! for the instruction sets this crate ships on:
+//! - x86_64: SSE2, which every x86_64 CPU has, upgraded to AVX2 at runtime
+//!   where the CPU supports it.
+//! - aarch64: NEON, which every aarch64 CPU has.
+//! - wasm32: simd128 when the build enables it. WebAssembly has no runtime
+//!   feature detection, so this is chosen at compile time.
+//!
+//! Every kernel is bit-exact with its scalar version; the tests check them
+//! against each other.
+
+#[cfg(target_arch = "aarch64")]
+use neon as imp;
+#[cfg(not(any(
+    target_arch = "x86_64",
+    target_arch = "aarch64",
+    all(target_arch = "wasm32", target_feature = "simd128")
+)))]
+use scalar::fallback as imp;
+#[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+use simd128 as imp;
+#[cfg(target_arch = "x86_64")]
+use x86 as imp;
+
+/// Replace each byte with the wrapping sum of itself and every byte before
+/// it, undoing per-plane delta encoding.
+pub(crate) fn prefix_sum_u8(bytes: &mut [u8]) {
+    imp::prefix_sum_u8(bytes);
+}
+
+/// Number of leading bytes with the high bit clear, i.e. the run of
+/// single-byte varints at the start of `bytes`.
+pub(crate) fn single_byte_run(bytes: &[u8]) -> usize {
+    imp::single_byte_run(bytes)
+}
+
+/// Call `emit` with each non-degenerate triangle of a triangle strip, in
+/// strip order, with the winding alternated as strips require.
+///
+/// Degenerate triangles (two or more equal indices) are how strips restart,
+/// so most strips have a few; the vector kernels find them for a block of
+/// windows at once and emit the rest.
+pub(crate) fn for_each_strip_triangle(strip: &[u16], mut emit: impl FnMut([u16; 3])) {
+    let start = imp::strip_blocks(strip, &mut emit);
+    scalar::strip_triangles(strip, start, &mut emit);
+}
+
+/// Emit the triangles of whole `width`-window blocks of `strip`, using
+/// `mask` to find each block's degenerates, and return where the blocks
+/// ended. A block spans `width + 2` indices; the caller finishes the tail.
+///
+/// `mask` takes a block and sets bit `j` when its window `j` is degenerate.
+#[cfg_attr(
+    not(any(
+        target_arch = "x86_64",
+        target_arch = "aarch64",
+        all(target_arch = "wasm32", target_feature = "simd128")
+    )),
+    allow(dead_code)
+)]
+#[inline(always)]
+fn blocks_with_mask(
+    strip: &[u16],
+    width: usize,
+    mask: impl Fn(&[u16]) -> u32,
+    emit: &mut impl FnMut([u16; 3]),
+) -> usize {
+    let mut start = 0;
+    while start + width + 2 <= strip.len() {
+        let block = &strip[start..start + width + 2];
+        let degenerate = mask(block);
+        for j in 0..width {
+            if degenerate & (1 << j) == 0 {
+                emit(scalar::oriented(
+                    block[j],
+                    block[j + 1],
+                    block[j + 2],
+                    start + j,
+                ));
+            }
+        }
+        start += width;
+    }
+    start
+}
+
+/// Scalar reference kernels, also used for the tails the vector kernels
+/// leave over.
+mod scalar {
+    pub(super) fn prefix_sum_u8(bytes: &mut [u8], mut sum: u8) {
+        for byte in bytes {
+            sum = sum.wrapping_add(*byte);
+            *byte = sum;
+        }
+    }
+
+    pub(super) fn single_byte_run(bytes: &[u8]) -> usize {
+        bytes
+            .iter()
+            .position(|b| b & 0x80 != 0)
+            .unwrap_or(bytes.len())
+    }
+
+    /// Emit the triangles of the windows from `start` on.
+    pub(super) fn strip_triangles(strip: &[u16], start: usize, emit: &mut impl FnMut([u16; 3])) {
+        for i in start..strip.len().saturating_sub(2) {
+            let (a, b, c) = (strip[i], strip[i + 1], strip[i + 2]);
+            if a != b && b != c && a != c {
+                emit(oriented(a, b, c, i));
+            }
+        }
+    }
+
+    /// Window `i` of a strip, with odd windows flipped so every triangle
+    /// has the same winding.
+    #[inline(always)]
+    pub(super) fn oriented(a: u16, b: u16, c: u16, i: usize) -> [u16; 3] {
+        if i.is_multiple_of(2) {
+            [a, b, c]
+        } else {
+            [a, c, b]
+        }
+    }
+
+    /// The kernels for targets without a vector implementation.
+    #[cfg(not(any(
+        target_arch = "x86_64",
+        target_arch = "aarch64",
+        all(target_arch = "wasm32", target_feature = "simd128")
+    )))]
+    pub(super) mod fallback {
+        pub(in crate::simd) fn prefix_sum_u8(bytes: &mut [u8]) {
+            super::prefix_sum_u8(bytes, 0);
+        }
+
+        pub(in crate::simd) fn single_byte_run(bytes: &[u8]) -> usize {
+            super::single_byte_run(bytes)
+        }
+
+        pub(in crate::simd) fn strip_blocks(
+            _strip: &[u16],
+            _emit: &mut impl FnMut([u16; 3]),
+        ) -> usize {
+            0
+        }
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+#[allow(unsafe_code)]
+mod x86 {
+    use std::arch::x86_64::{
+        __m128i, __m256i, _mm_add_epi8, _mm_cmpeq_epi16, _mm_loadu_si128, _mm_movemask_epi8,
+        _mm_or_si128, _mm_packs_epi16, _mm_set1_epi8, _mm_setzero_si128, _mm_slli_si128,
+        _mm_storeu_si128, _mm256_cmpeq_epi16, _mm256_loadu_si256, _mm256_movemask_epi8,
+        _mm256_or_si256, _mm256_packs_epi16, _mm256_permute4x64_epi64, _mm256_setzero_si256,
+    };
+
+    use super::{blocks_with_mask, scalar};
+
+    pub(super) fn prefix_sum_u8(bytes: &mut [u8]) {
+        let mut sum = 0u8;
+        let mut chunks = bytes.chunks_exact_mut(16);
+        for chunk in &mut chunks {
+            let ptr = chunk.as_mut_ptr().cast::<__m128i>();
+            // SAFETY: `chunk` is 16 bytes, and SSE2 is part of the x86_64
+            // baseline. The load and store are unaligned.
+            unsafe {
+                // Log-step scan within the register, then carry in the sum
+                // of the chunks before.
+                let mut x = _mm_loadu_si128(ptr);
+                x = _mm_add_epi8(x, _mm_slli_si128::<1>(x));
+                x = _mm_add_epi8(x, _mm_slli_si128::<2>(x));
+                x = _mm_add_epi8(x, _mm_slli_si128::<4>(x));
+                x = _mm_add_epi8(x, _mm_slli_si128::<8>(x));
+                x = _mm_add_epi8(x, _mm_set1_epi8(sum as i8));
+                _mm_storeu_si128(ptr, x);
+            }
+            sum = chunk[15];
+        }
+        scalar::prefix_sum_u8(chunks.into_remainder(), sum);
+    }
+
+    pub(super) fn single_byte_run(bytes: &[u8]) -> usize {
+        let mut run = 0;
+        for chunk in bytes.chunks_exact(16) {
+            // SAFETY: `chunk` is 16 bytes; the load is unaligned.
+            let high_bits =
+                unsafe { _mm_movemask_epi8(_mm_loadu_si128(chunk.as_ptr().cast::<__m128i>())) };
+            if high_bits != 0 {
+                return run + high_bits.trailing_zeros() as usize;
+            }
+            run += 16;
+        }
+        run + scalar::single_byte_run(&bytes[run..])
+    }
+
+    pub(super) fn strip_blocks(strip: &[u16], emit: &mut impl FnMut([u16; 3])) -> usize {
+        if std::is_x86_feature_detected!("avx2") {
+            // SAFETY: AVX2 support was just checked.
+            unsafe { strip_blocks_avx2(strip, emit) }
+        } else {
+            blocks_with_mask(strip, 8, degenerate_mask_sse2, emit)
+        }
+    }
+
+    /// Degenerate mask for the 8 windows of a 10-index block.
+    pub(super) fn degenerate_mask_sse2(block: &[u16]) -> u32 {
+        assert!(block.len() >= 10);
+        let ptr = block.as_ptr();
+        // SAFETY: `block` holds at least 10 indices, so the 8-index loads at
+        // offsets 0, 1 and 2 are in bounds. They are unaligned.
+        unsafe {
+            let a = _mm_loadu_si128(ptr.cast::<__m128i>());
+            let b = _mm_loadu_si128(ptr.add(1).cast::<__m128i>());
+            let c = _mm_loadu_si128(ptr.add(2).cast::<__m128i>());
+            let degenerate = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi16(a, b), _mm_cmpeq_epi16(b, c)),
+                _mm_cmpeq_epi16(a, c),
+            );
+            // Narrow the 16-bit lanes to bytes so the movemask has one bit
+            // per window.
+            _mm_movemask_epi8(_mm_packs_epi16(degenerate, _mm_setzero_si128())) as u32
+        }
+    }
+
+    /// [`blocks_with_mask`] over 16-window blocks, compiled for AVX2 so the
+    /// mask inlines.
+    ///
+    /// # Safety
+    ///
+    /// The CPU must support AVX2.
+    #[target_feature(enable = "avx2")]
+    unsafe fn strip_blocks_avx2(strip: &[u16], emit: &mut impl FnMut([u16; 3])) -> usize {
+        blocks_with_mask(
+            strip,
+            16,
+            // SAFETY: this function only runs where AVX2 is available.
+            |block| unsafe { degenerate_mask_avx2(block) },
+            emit,
+        )
+    }
+
+    /// Degenerate mask for the 16 windows of an 18-index block.
+    ///
+    /// # Safety
+    ///
+    /// The CPU must support AVX2.
+    #[target_feature(enable = "avx2")]
+    unsafe fn degenerate_mask_avx2(block: &[u16]) -> u32 {
+        assert!(block.len() >= 18);
+        let ptr = block.as_ptr();
+        // SAFETY: `block` holds at least 18 indices, so the 16-index loads at
+        // offsets 0, 1 and 2 are in bounds. They are unaligned.
+        unsafe {
+            let a = _mm256_loadu_si256(ptr.cast::<__m256i>());
+            let b = _mm256_loadu_si256(ptr.add(1).cast::<__m256i>());
+            let c = _mm256_loadu_si256(ptr.add(2).cast::<__m256i>());
+            let degenerate = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi16(a, b), _mm256_cmpeq_epi16(b, c)),
+                _mm256_cmpeq_epi16(a, c),
+            );
+            // Packing works per 128-bit half, leaving windows 0-7 and 8-15 in
+            // the first and third quadwords; gather those into the low half.
+            let packed = _mm256_packs_epi16(degenerate, _mm256_setzero_si256());
+            let ordered = _mm256_permute4x64_epi64::<0b11_01_10_00>(packed);
+            (_mm256_movemask_epi8(ordered) as u32) & 0xffff
+        }
+    }
+}
+
+#[cfg(target_arch = "aarch64")]
+#[allow(unsafe_code)]
+mod neon {
+    use std::arch::aarch64::{
+        vaddq_u8, vaddvq_u16, vandq_u16, vceqq_u16, vdupq_n_u8, vextq_u8, vld1q_u8, vld1q_u16,
+        vmaxvq_u8, vorrq_u16, vst1q_u8,
+    };
+
+    use super::{blocks_with_mask, scalar};
+
+    pub(super) fn prefix_sum_u8(bytes: &mut [u8]) {
+        let mut sum = 0u8;
+        let mut chunks = bytes.chunks_exact_mut(16);
+        for chunk in &mut chunks {
+            let ptr = chunk.as_mut_ptr();
+            // SAFETY: `chunk` is 16 bytes, and NEON is part of the aarch64
+            // baseline.
+            unsafe {
+                // `vextq_u8::<16 - k>(zero, x)` shifts `x` up by `k` lanes.
+                let zero = vdupq_n_u8(0);
+                let mut x = vld1q_u8(ptr);
+                x = vaddq_u8(x, vextq_u8::<15>(zero, x));
+                x = vaddq_u8(x, vextq_u8::<14>(zero, x));
+                x = vaddq_u8(x, vextq_u8::<12>(zero, x));
+                x = vaddq_u8(x, vextq_u8::<8>(zero, x));
+                x = vaddq_u8(x, vdupq_n_u8(sum));
+                vst1q_u8(ptr, x);
+            }
+            sum = chunk[15];
+        }
+        scalar::prefix_sum_u8(chunks.into_remainder(), sum);
+    }
+
+    pub(super) fn single_byte_run(bytes: &[u8]) -> usize {
+        let mut run = 0;
+        for chunk in bytes.chunks_exact(16) {
+            // SAFETY: `chunk` is 16 bytes.
+            if unsafe { vmaxvq_u8(vld1q_u8(chunk.as_ptr())) } & 0x80 != 0 {
+                break;
+            }
+            run += 16;
+        }
+        run + scalar::single_byte_run(&bytes[run..])
+    }
+
+    pub(super) fn strip_blocks(strip: &[u16], emit: &mut impl FnMut([u16; 3])) -> usize {
+        blocks_with_mask(strip, 8, degenerate_mask, emit)
+    }
+
+    /// Degenerate mask for the 8 windows of a 10-index block.
+    fn degenerate_mask(block: &[u16]) -> u32 {
+        const BITS: [u16; 8] = [1, 2, 4, 8, 16, 32, 64, 128];
+        assert!(block.len() >= 10);
+        let ptr = block.as_ptr();
+        // SAFETY: `block` holds at least 10 indices, so the 8-index loads at
+        // offsets 0, 1 and 2 are in bounds.
+        unsafe {
+            let a = vld1q_u16(ptr);
+            let b = vld1q_u16(ptr.add(1));
+            let c = vld1q_u16(ptr.add(2));
+            let degenerate =
+                vorrq_u16(vorrq_u16(vceqq_u16(a, b), vceqq_u16(b, c)), vceqq_u16(a, c));
+            // NEON has no movemask: keep one distinct bit per lane and sum.
+            u32::from(vaddvq_u16(vandq_u16(degenerate, vld1q_u16(BITS.as_ptr()))))
+        }
+    }
+}
+
+#[cfg(all(target_arch = "wasm32", target_feature = "simd128"))]
+#[allow(unsafe_code)]
+mod simd128 {
+    use std::arch::wasm32::{
+        i8x16_shuffle, u8x16_add, u8x16_bitmask, u8x16_splat, u16x8_bitmask, u16x8_eq, v128,
+        v128_load, v128_or, v128_store,
+    };
+
+    use super::{blocks_with_mask, scalar};
+
+    pub(super) fn prefix_sum_u8(bytes: &mut [u8]) {
+        let zero = u8x16_splat(0);
+        let mut sum = 0u8;
+        let mut chunks = bytes.chunks_exact_mut(16);
+        for chunk in &mut chunks {
+            let ptr = chunk.as_mut_ptr().cast::<v128>();
+            // SAFETY: `chunk` is 16 bytes; wasm loads are unaligned.
+            let mut x = unsafe { v128_load(ptr) };
+            // Lanes 0-15 pick from `zero` and 16-31 from `x`, so these shift
+            // `x` up by 1, 2, 4 and 8 lanes.
+            x = u8x16_add(
+                x,
+                i8x16_shuffle::<0, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30>(
+                    zero, x,
+                ),
+            );
+            x = u8x16_add(
+                x,
+                i8x16_shuffle::<0, 0, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29>(
+                    zero, x,
+                ),
+            );
+            x = u8x16_add(
+                x,
+                i8x16_shuffle::<0, 0, 0, 0, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27>(
+                    zero, x,
+                ),
+            );
+            x = u8x16_add(
+                x,
+                i8x16_shuffle::<0, 0, 0, 0, 0, 0, 0, 0, 16, 17, 18, 19, 20, 21, 22, 23>(zero, x),
+            );
+            x = u8x16_add(x, u8x16_splat(sum));
+            // SAFETY: as above; wasm stores are unaligned.
+            unsafe { v128_store(ptr, x) };
+            sum = chunk[15];
+        }
+        scalar::prefix_sum_u8(chunks.into_remainder(), sum);
+    }
+
+    pub(super) fn single_byte_run(bytes: &[u8]) -> usize {
+        let mut run = 0;
+        for chunk in bytes.chunks_exact(16) {
+            // SAFETY: `chunk` is 16 bytes; wasm loads are unaligned.
+            let high_bits = u8x16_bitmask(unsafe { v128_load(chunk.as_ptr().cast::<v128>()) });
+            if high_bits != 0 {
+                return run + high_bits.trailing_zeros() as usize;
+            }
+            run += 16;
+        }
+        run + scalar::single_byte_run(&bytes[run..])
+    }
+
+    pub(super) fn strip_blocks(strip: &[u16], emit: &mut impl FnMut([u16; 3])) -> usize {
+        blocks_with_mask(strip, 8, degenerate_mask, emit)
+    }
+
+    /// Degenerate mask for the 8 windows of a 10-index block.
+    fn degenerate_mask(block: &[u16]) -> u32 {
+        assert!(block.len() >= 10);
+        let ptr = block.as_ptr();
+        // SAFETY: `block` holds at least 10 indices, so the 8-index loads at
+        // offsets 0, 1 and 2 are in bounds; wasm loads are unaligned.
+        let (a, b, c) = unsafe {
+            (
+                v128_load(ptr.cast::<v128>()),
+                v128_load(ptr.add(1).cast::<v128>()),
+                v128_load(ptr.add(2).cast::<v128>()),
+            )
+        };
+        let degenerate = v128_or(v128_or(u16x8_eq(a, b), u16x8_eq(b, c)), u16x8_eq(a, c));
+        u32::from(u16x8_bitmask(degenerate))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Deterministic xorshift bytes, so failures reproduce.
+    fn random_bytes(len: usize, mut seed: u64) -> Vec<u8> {
+        (0..len)
+            .map(|_| {
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                (seed >> 32) as u8
+            })
+            .collect()
+    }
+
+    /// A strip over few distinct indices, so degenerate windows are common.
+    fn random_strip(len: usize, seed: u64) -> Vec<u16> {
+        random_bytes(len, seed)
+            .into_iter()
+            .map(|b| u16::from(b % 6) * 1000)
+            .collect()
+    }
+
+    fn strip_triangles(strip: &[u16]) -> Vec<[u16; 3]> {
+        let mut triangles = Vec::new();
+        for_each_strip_triangle(strip, |t| triangles.push(t));
+        triangles
+    }
+
+    fn scalar_strip_triangles(strip: &[u16]) -> Vec<[u16; 3]> {
+        let mut triangles = Vec::new();
+        scalar::strip_triangles(strip, 0, &mut |t| triangles.push(t));
+        triangles
+    }
+
+    #[test]
+    fn test_prefix_sum_matches_scalar() {
+        // Lengths around the vector width exercise the tails.
+        for len in [0, 1, 15, 16, 17, 31, 32, 33, 100, 1000] {
+            let input = random_bytes(len, len as u64 + 1);
+            let mut expected = input.clone();
+            scalar::prefix_sum_u8(&mut expected, 0);
+            let mut actual = input;
+            prefix_sum_u8(&mut actual);
+            assert_eq!(actual, expected, "len {len}");
+        }
+    }
+
+    #[test]
+    fn test_single_byte_run_matches_scalar() {
+        for len in [0, 5, 16, 40] {
+            for high in [None, Some(0), Some(3), Some(15), Some(16), Some(39)] {
+                let mut bytes = vec![0x7f; len];
+                if let Some(i) = high.filter(|&i| i < len) {
+                    bytes[i] = 0x80;
+                }
+                assert_eq!(
+                    single_byte_run(&bytes),
+                    scalar::single_byte_run(&bytes),
+                    "len {len}, high bit at {high:?}"
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn test_strip_triangles_match_scalar() {
+        for len in [0, 2, 3, 9, 10, 11, 17, 18, 19, 35, 500] {
+            let strip = random_strip(len, len as u64 + 7);
+            assert_eq!(
+                strip_triangles(&strip),
+                scalar_strip_triangles(&strip),
+                "len {len}"
+            );
+        }
+    }
+
+    #[cfg(target_arch = "x86_64")]
+    #[test]
+    fn test_strip_triangles_baseline_kernel_matches_scalar() {
+        // The dispatch prefers AVX2 where available; cover SSE2 directly.
+        let strip = random_strip(500, 3);
+        let mut triangles = Vec::new();
+        let mut emit = |t| triangles.push(t);
+        let start = blocks_with_mask(&strip, 8, x86::degenerate_mask_sse2, &mut emit);
+        scalar::strip_triangles(&strip, start, &mut emit);
+        assert_eq!(triangles, scalar_strip_triangles(&strip));
+    }
+}
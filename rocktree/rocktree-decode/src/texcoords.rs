@@ -70,8 +70,8 @@ pub fn unpack_tex_coords(packed: &[u8], vertices: &mut [Vertex]) -> DecodeResult
         let u_high = u32::from(data[count * 2 + i]);
         let v_high = u32::from(data[count * 3 + i]);
 
-        u = (u + u_low + (u_high << 8)) % u_mod;
-        v = (v + v_low + (v_high << 8)) % v_mod;
+        u = add_mod(u, u_low + (u_high << 8), u_mod);
+        v = add_mod(v, v_low + (v_high << 8), v_mod);
 
         // u and v are always < u_mod/v_mod which are at most 65536, so they fit in u16.
         {
@@ -88,6 +88,21 @@ pub fn unpack_tex_coords(packed: &[u8], vertices: &mut [Vertex]) -> DecodeResult
     })
 }
 
+/// `(acc + delta) % modulus` for `acc < modulus`.
+///
+/// The running sum is serial, so it can't be vectorised, but the common
+/// case (a delta below the modulus) needs only a compare and subtract
+/// rather than a division.
+#[inline(always)]
+fn add_mod(acc: u32, delta: u32, modulus: u32) -> u32 {
+    if delta < modulus {
+        let sum = acc + delta;
+        if sum >= modulus { sum - modulus } else { sum }
+    } else {
+        (acc + delta) % modulus
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -175,4 +190,19 @@ mod tests {
             Err(DecodeError::InvalidFormat { .. })
         ));
     }
+
+    #[test]
+    fn test_add_mod_matches_remainder() {
+        for modulus in [1, 2, 255, 1000, 65535, 65536] {
+            for acc in [0, modulus / 2, modulus - 1] {
+                for delta in [0, 1, modulus - 1, modulus, modulus + 1, 65535] {
+                    assert_eq!(
+                        add_mod(acc, delta, modulus),
+                        (acc + delta) % modulus,
+                        "acc {acc}, delta {delta}, modulus {modulus}"
+                    );
+                }
+            }
+        }
+    }
 }
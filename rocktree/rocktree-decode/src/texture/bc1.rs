@@ -0,0 +1,255 @@
+//! BC1 (DXT1) block packing for pixels decoded from BC1 data.
+//!
+//! `texture2ddecoder` only exposes CRN decoding all the way down to pixels, so
+//! the block-compressed path decodes to pixels and then recovers each block's
+//! endpoints and indices. Whenever a block's pixels include both of its
+//! endpoint colours (nearly always for real imagery) the packed block decodes
+//! to exactly the same pixels as the original; otherwise the closest encoding
+//! among a few endpoint candidates is used.
+
+/// Bytes per 4x4 BC1 block.
+pub const BC1_BLOCK_BYTES: usize = 8;
+
+/// An 8-bit-per-channel RGB colour, widened for arithmetic.
+type Rgb = [i32; 3];
+
+/// Opaque black, the fourth palette entry in three-colour mode.
+const BLACK: Rgb = [0, 0, 0];
+
+/// Pack BGRA pixels (as produced by `texture2ddecoder`) into BC1 blocks.
+///
+/// `width` and `height` must be multiples of 4. Alpha is ignored: the result
+/// is opaque BC1, matching how the CRN textures are authored.
+pub(crate) fn pack_bc1(pixels: &[u32], width: usize, height: usize) -> Vec<u8> {
+    debug_assert!(width.is_multiple_of(4) && height.is_multiple_of(4));
+    debug_assert_eq!(pixels.len(), width * height);
+
+    let blocks_x = width / 4;
+    let blocks_y = height / 4;
+    let mut out = Vec::with_capacity(blocks_x * blocks_y * BC1_BLOCK_BYTES);
+    let mut texels = [BLACK; 16];
+    for by in 0..blocks_y {
+        for bx in 0..blocks_x {
+            for (i, texel) in texels.iter_mut().enumerate() {
+                let pixel = pixels[(by * 4 + i / 4) * width + bx * 4 + i % 4];
+                *texel = bgra_to_rgb(pixel);
+            }
+            out.extend_from_slice(&encode_block(&texels));
+        }
+    }
+    out
+}
+
+/// A candidate encoding of one block and its squared error.
+struct Encoding {
+    bytes: [u8; BC1_BLOCK_BYTES],
+    error: i32,
+}
+
+/// Encode one 4x4 block, trying endpoint candidates from cheapest to most
+/// speculative and stopping at the first exact match.
+fn encode_block(texels: &[Rgb; 16]) -> [u8; BC1_BLOCK_BYTES] {
+    // Both endpoints present: the extremes are the endpoints.
+    let (a, b) = extremes(texels.iter());
+    let mut best = encode_with_endpoints(texels, a, b);
+    if best.error == 0 {
+        return best.bytes;
+    }
+
+    // Three-colour block using its black entry: black isn't an endpoint.
+    if texels.contains(&BLACK)
+        && let Some((a, b)) = non_black_extremes(texels)
+    {
+        let candidate = encode_with_endpoints(texels, a, b);
+        if candidate.error < best.error {
+            best = candidate;
+        }
+        if best.error == 0 {
+            return best.bytes;
+        }
+    }
+
+    // Only the interpolated entries present: extrapolate the endpoints.
+    let extrapolate =
+        |p: Rgb, q: Rgb| -> Rgb { std::array::from_fn(|c| (2 * p[c] - q[c]).clamp(0, 255)) };
+    let candidate = encode_with_endpoints(texels, extrapolate(a, b), extrapolate(b, a));
+    if candidate.error < best.error {
+        best = candidate;
+    }
+    best.bytes
+}
+
+/// The pair of colours furthest apart, or `(c, c)` for a solid block.
+fn extremes<'a>(colours: impl Iterator<Item = &'a Rgb> + Clone) -> (Rgb, Rgb) {
+    let mut best = (BLACK, BLACK);
+    let mut best_distance = -1;
+    for (i, p) in colours.clone().enumerate() {
+        for q in colours.clone().skip(i) {
+            let distance = distance_sq(*p, *q);
+            if distance > best_distance {
+                best_distance = distance;
+                best = (*p, *q);
+            }
+        }
+    }
+    best
+}
+
+/// [`extremes`] over the non-black texels, if there are any.
+fn non_black_extremes(texels: &[Rgb; 16]) -> Option<(Rgb, Rgb)> {
+    let colours = texels.iter().filter(|t| **t != BLACK);
+    colours.clone().next()?;
+    Some(extremes(colours))
+}
+
+/// Encode a block with the given endpoints, in whichever of the four- and
+/// three-colour modes fits it better.
+fn encode_with_endpoints(texels: &[Rgb; 16], a: Rgb, b: Rgb) -> Encoding {
+    let (qa, qb) = (rgb_to_565(a), rgb_to_565(b));
+    let (lo, hi) = (qa.min(qb), qa.max(qb));
+
+    // Three-colour mode is selected by `c0 <= c1`, and is the only option
+    // when both endpoints quantise to the same colour.
+    let three = encode_with_palette(texels, lo, hi, palette(lo, hi));
+    if lo == hi {
+        return three;
+    }
+    let four = encode_with_palette(texels, hi, lo, palette(hi, lo));
+    if four.error <= three.error {
+        four
+    } else {
+        three
+    }
+}
+
+/// Assign each texel its nearest palette entry.
+fn encode_with_palette(texels: &[Rgb; 16], c0: u16, c1: u16, palette: [Rgb; 4]) -> Encoding {
+    let mut indices = 0u32;
+    let mut error = 0;
+    for (i, texel) in texels.iter().enumerate() {
+        let (index, distance) = palette
+            .iter()
+            .enumerate()
+            .map(|(index, entry)| (index, distance_sq(*texel, *entry)))
+            .min_by_key(|&(_, distance)| distance)
+            .expect("palette is non-empty");
+        indices |= (index as u32) << (i * 2);
+        error += distance;
+    }
+
+    let mut bytes = [0; BC1_BLOCK_BYTES];
+    bytes[0..2].copy_from_slice(&c0.to_le_bytes());
+    bytes[2..4].copy_from_slice(&c1.to_le_bytes());
+    bytes[4..8].copy_from_slice(&indices.to_le_bytes());
+    Encoding { bytes, error }
+}
+
+/// The decoded palette for a block's endpoints, using the same integer
+/// interpolation as the decoder.
+fn palette(c0: u16, c1: u16) -> [Rgb; 4] {
+    let (p, q) = (rgb_from_565(c0), rgb_from_565(c1));
+    if c0 > c1 {
+        [
+            p,
+            q,
+            std::array::from_fn(|c| (2 * p[c] + q[c]) / 3),
+            std::array::from_fn(|c| (p[c] + 2 * q[c]) / 3),
+        ]
+    } else {
+        [p, q, std::array::from_fn(|c| (p[c] + q[c]) / 2), BLACK]
+    }
+}
+
+/// Quantise to RGB565. Exact for colours expanded from RGB565, since the
+/// expansion replicates the high bits into the low ones.
+fn rgb_to_565([r, g, b]: Rgb) -> u16 {
+    ((r as u16 >> 3) << 11) | ((g as u16 >> 2) << 5) | (b as u16 >> 3)
+}
+
+/// Expand RGB565 to 8 bits per channel by bit replication.
+fn rgb_from_565(c: u16) -> Rgb {
+    let r = i32::from((c >> 11) & 0x1f);
+    let g = i32::from((c >> 5) & 0x3f);
+    let b = i32::from(c & 0x1f);
+    [
+        (r << 3) | (r >> 2),
+        (g << 2) | (g >> 4),
+        (b << 3) | (b >> 2),
+    ]
+}
+
+/// Unpack a `texture2ddecoder` pixel (`0xAARRGGBB`).
+fn bgra_to_rgb(pixel: u32) -> Rgb {
+    let [b, g, r, _] = pixel.to_le_bytes();
+    [i32::from(r), i32::from(g), i32::from(b)]
+}
+
+fn distance_sq(p: Rgb, q: Rgb) -> i32 {
+    (0..3).map(|c| (p[c] - q[c]).pow(2)).sum()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Build a BC1 block from endpoints and per-texel indices.
+    fn block(c0: u16, c1: u16, indices: [u32; 16]) -> Vec<u8> {
+        let packed = indices
+            .iter()
+            .enumerate()
+            .fold(0u32, |acc, (i, index)| acc | (index << (i * 2)));
+        let mut bytes = Vec::with_capacity(BC1_BLOCK_BYTES);
+        bytes.extend_from_slice(&c0.to_le_bytes());
+        bytes.extend_from_slice(&c1.to_le_bytes());
+        bytes.extend_from_slice(&packed.to_le_bytes());
+        bytes
+    }
+
+    fn decode(data: &[u8], width: usize, height: usize) -> Vec<u32> {
+        let mut pixels = vec![0u32; width * height];
+        texture2ddecoder::decode_bc1(data, width, height, &mut pixels).unwrap();
+        pixels
+    }
+
+    /// Packing the decoded pixels must reproduce them exactly.
+    fn assert_round_trips(data: &[u8], width: usize, height: usize) {
+        let pixels = decode(data, width, height);
+        let packed = pack_bc1(&pixels, width, height);
+        assert_eq!(packed.len(), data.len());
+        assert_eq!(decode(&packed, width, height), pixels);
+    }
+
+    const INDICES: [u32; 16] = [0, 1, 2, 3, 3, 2, 1, 0, 0, 0, 1, 1, 2, 2, 3, 3];
+
+    #[test]
+    fn test_pack_bc1_four_colour_block() {
+        assert_round_trips(&block(0xf81f, 0x07e0, INDICES), 4, 4);
+        assert_round_trips(&block(0x8410, 0x2104, INDICES), 4, 4);
+    }
+
+    #[test]
+    fn test_pack_bc1_three_colour_block() {
+        // c0 <= c1 selects three-colour mode, with index 3 decoding to black.
+        assert_round_trips(&block(0x2104, 0x8410, INDICES), 4, 4);
+    }
+
+    #[test]
+    fn test_pack_bc1_solid_block() {
+        assert_round_trips(&block(0x1234, 0x1234, [0; 16]), 4, 4);
+    }
+
+    #[test]
+    fn test_pack_bc1_block_order() {
+        // Two blocks side by side: block order is row-major.
+        let mut data = block(0xf800, 0x001f, INDICES);
+        data.extend(block(0x07e0, 0xffff, INDICES));
+        assert_round_trips(&data, 8, 4);
+    }
+
+    #[test]
+    fn test_rgb565_round_trip() {
+        for c in [0x0000, 0xffff, 0x1234, 0xf81f, 0x07e0] {
+            assert_eq!(rgb_to_565(rgb_from_565(c)), c);
+        }
+    }
+}
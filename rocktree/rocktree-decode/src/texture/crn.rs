@@ -1,11 +1,12 @@
 //! Crunch (CRN) texture decoding.
 //!
 //! CRN is a compressed texture format that stores DXT1-encoded data
-//! in a highly compressed form. This module decodes CRN to RGBA pixels.
+//! in a highly compressed form. This module decodes CRN to RGBA pixels, or
+//! to BC1 blocks for direct GPU upload.
 
 use crate::{
     error::{DecodeError, DecodeResult},
-    texture::DecodedTexture,
+    texture::{DecodedTexture, bc1},
 };
 use texture2ddecoder::CrnTextureInfo;
 
@@ -27,6 +28,42 @@ use texture2ddecoder::CrnTextureInfo;
 ///
 /// Returns an error if CRN decoding fails.
 pub fn decode_crn_to_rgba(data: &[u8]) -> DecodeResult<DecodedTexture> {
+    let (pixels, width, height) = decode_crn_pixels(data)?;
+
+    // Convert BGRA u32 to RGBA byte array.
+    let rgba_bytes = bgra_u32_to_rgba_bytes(pixels);
+
+    Ok(DecodedTexture::new(rgba_bytes, width, height))
+}
+
+/// Decode CRN (Crunch) data to BC1 blocks.
+///
+/// The decoder only exposes CRN decoding down to pixels, so the pixels are
+/// packed back into BC1; see the `bc1` module for how exact that is. Textures
+/// whose dimensions aren't multiples of 4 can't be BC1, and decode to RGBA
+/// instead.
+///
+/// # Errors
+///
+/// Returns an error if CRN decoding fails.
+pub fn decode_crn_to_bc1(data: &[u8]) -> DecodeResult<DecodedTexture> {
+    let (pixels, width, height) = decode_crn_pixels(data)?;
+
+    if !width.is_multiple_of(4) || !height.is_multiple_of(4) {
+        return Ok(DecodedTexture::new(
+            bgra_u32_to_rgba_bytes(pixels),
+            width,
+            height,
+        ));
+    }
+
+    let blocks = bc1::pack_bc1(&pixels, width as usize, height as usize);
+    Ok(DecodedTexture::bc1(blocks, width, height))
+}
+
+/// Decode CRN data to packed BGRA pixels, returning them with the texture's
+/// dimensions.
+fn decode_crn_pixels(data: &[u8]) -> DecodeResult<(Vec<u32>, u32, u32)> {
     // Get texture info from CRN header.
     let mut info = CrnTextureInfo::default();
 
@@ -44,23 +81,18 @@ pub fn decode_crn_to_rgba(data: &[u8]) -> DecodeResult<DecodedTexture> {
     let width = info.width;
     let height = info.height;
 
-    // Allocate output buffer for RGBA data (4 bytes per pixel).
-    // texture2ddecoder outputs as packed u32 (RGBA).
+    // texture2ddecoder outputs as packed u32 (BGRA).
     let pixel_count = (width as usize) * (height as usize);
-    let mut rgba_u32 = vec![0u32; pixel_count];
+    let mut pixels = vec![0u32; pixel_count];
 
-    // Decode CRN directly to RGBA.
-    texture2ddecoder::decode_crunch(data, width as usize, height as usize, &mut rgba_u32).map_err(
+    texture2ddecoder::decode_crunch(data, width as usize, height as usize, &mut pixels).map_err(
         |e| DecodeError::InvalidFormat {
             context: "crn",
             detail: format!("failed to decode CRN: {e}"),
         },
     )?;
 
-    // Convert BGRA u32 to RGBA byte array.
-    let rgba_bytes = bgra_u32_to_rgba_bytes(rgba_u32);
-
-    Ok(DecodedTexture::new(rgba_bytes, width, height))
+    Ok((pixels, width, height))
 }
 
 /// Convert packed BGRA u32 values to RGBA byte array.
@@ -85,6 +117,8 @@ mod tests {
         let invalid = [0x00, 0x01, 0x02, 0x03];
         let result = decode_crn_to_rgba(&invalid);
         assert!(matches!(result, Err(DecodeError::InvalidFormat { .. })));
+        let result = decode_crn_to_bc1(&invalid);
+        assert!(matches!(result, Err(DecodeError::InvalidFormat { .. })));
     }
 
     #[test]
@@ -0,0 +1,182 @@
+//! Mip chains for decoded textures.
+//!
+//! Terrain tiles are seen from every distance, so a single-level texture
+//! aliases in the far field and makes the GPU fetch far more texels than land
+//! on screen. [`with_mip_chain`] appends the levels below the top one, each a
+//! 2x2 box filter of the last, averaged in linear light: averaging the sRGB
+//! bytes directly would darken every distant tile.
+//!
+//! BC1 levels are decoded, filtered and packed again, down to the smallest
+//! level that is still whole 4x4 blocks; the GPU clamps to the last level
+//! below that.
+
+use std::sync::LazyLock;
+
+use crate::texture::{BC1_BLOCK_BYTES, DecodedFormat, DecodedTexture, bc1};
+
+/// Linear-light value of each sRGB byte.
+static SRGB_TO_LINEAR: LazyLock<[f32; 256]> = LazyLock::new(|| {
+    std::array::from_fn(|byte| {
+        let c = byte as f32 / 255.0;
+        if c <= 0.040_45 {
+            c / 12.92
+        } else {
+            ((c + 0.055) / 1.055).powf(2.4)
+        }
+    })
+});
+
+fn linear_to_srgb(linear: f32) -> u8 {
+    let c = if linear <= 0.003_130_8 {
+        linear * 12.92
+    } else {
+        1.055 * linear.powf(1.0 / 2.4) - 0.055
+    };
+    (c * 255.0).round().clamp(0.0, 255.0) as u8
+}
+
+/// Size of mip `level` of a `width` x `height` texture, as the GPU sizes it.
+#[must_use]
+pub fn mip_level_size(width: u32, height: u32, level: u32) -> (u32, u32) {
+    ((width >> level).max(1), (height >> level).max(1))
+}
+
+/// Levels [`with_mip_chain`] builds for a texture: down to 1x1 for RGBA, and
+/// while both sides stay multiples of 4 for BC1.
+#[must_use]
+pub fn mip_level_count(format: DecodedFormat, width: u32, height: u32) -> u32 {
+    match format {
+        DecodedFormat::Rgba8 => 32 - width.max(height).max(1).leading_zeros(),
+        DecodedFormat::Bc1 => {
+            let mut levels = 1;
+            while (width >> levels).is_multiple_of(4)
+                && (height >> levels).is_multiple_of(4)
+                && (width >> levels) >= 4
+                && (height >> levels) >= 4
+            {
+                levels += 1;
+            }
+            levels
+        }
+    }
+}
+
+/// Bytes of mip `level` of a texture.
+#[must_use]
+pub fn mip_level_len(format: DecodedFormat, width: u32, height: u32, level: u32) -> usize {
+    let (width, height) = mip_level_size(width, height, level);
+    match format {
+        DecodedFormat::Rgba8 => width as usize * height as usize * 4,
+        DecodedFormat::Bc1 => {
+            width.div_ceil(4) as usize * height.div_ceil(4) as usize * BC1_BLOCK_BYTES
+        }
+    }
+}
+
+/// Append the mip chain to a single-level texture. Textures that already
+/// have one, or whose data doesn't fit their size, are returned unchanged.
+#[must_use]
+pub fn with_mip_chain(mut texture: DecodedTexture) -> DecodedTexture {
+    let levels = mip_level_count(texture.format, texture.width, texture.height);
+    if texture.mip_levels != 1 || levels == 1 || !texture.is_valid() {
+        return texture;
+    }
+    let (width, height) = (texture.width as usize, texture.height as usize);
+    let mut pixels: Vec<[u8; 4]> = match texture.format {
+        DecodedFormat::Rgba8 => texture.data.as_chunks::<4>().0.to_vec(),
+        DecodedFormat::Bc1 => {
+            let mut bgra = vec![0u32; width * height];
+            if texture2ddecoder::decode_bc1(&texture.data, width, height, &mut bgra).is_err() {
+                return texture;
+            }
+            bgra.into_iter().map(u32::to_le_bytes).collect()
+        }
+    };
+
+    let total: usize = (0..levels)
+        .map(|level| mip_level_len(texture.format, texture.width, texture.height, level))
+        .sum();
+    texture.data.reserve_exact(total - texture.data.len());
+    let (mut w, mut h) = (width, height);
+    for _ in 1..levels {
+        pixels = downsample(&pixels, w, h);
+        (w, h) = ((w / 2).max(1), (h / 2).max(1));
+        match texture.format {
+            DecodedFormat::Rgba8 => texture.data.extend_from_slice(pixels.as_flattened()),
+            DecodedFormat::Bc1 => {
+                // The alpha byte sits last in both layouts.
+                let bgra: Vec<u32> = pixels.iter().map(|p| u32::from_le_bytes(*p)).collect();
+                texture.data.extend(bc1::pack_bc1(&bgra, w, h));
+            }
+        }
+    }
+    texture.mip_levels = levels;
+    texture
+}
+
+/// Halve a level with a 2x2 box filter. An odd last row or column is dropped,
+/// matching how the GPU sizes the next level.
+fn downsample(pixels: &[[u8; 4]], width: usize, height: usize) -> Vec<[u8; 4]> {
+    let to_linear = &*SRGB_TO_LINEAR;
+    let (out_width, out_height) = ((width / 2).max(1), (height / 2).max(1));
+    let mut out = Vec::with_capacity(out_width * out_height);
+    for y in 0..out_height {
+        let rows = [(2 * y).min(height - 1), (2 * y + 1).min(height - 1)];
+        for x in 0..out_width {
+            let columns = [(2 * x).min(width - 1), (2 * x + 1).min(width - 1)];
+            let mut sum = [0.0f32; 4];
+            for row in rows {
+                for column in columns {
+                    let texel = pixels[row * width + column];
+                    for (sum, &channel) in sum.iter_mut().zip(&texel[..3]) {
+                        *sum += to_linear[usize::from(channel)];
+                    }
+                    sum[3] += f32::from(texel[3]);
+                }
+            }
+            out.push([
+                linear_to_srgb(sum[0] / 4.0),
+                linear_to_srgb(sum[1] / 4.0),
+                linear_to_srgb(sum[2] / 4.0),
+                (sum[3] / 4.0).round() as u8,
+            ]);
+        }
+    }
+    out
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn level_counts_follow_the_format() {
+        assert_eq!(mip_level_count(DecodedFormat::Rgba8, 256, 256), 9);
+        assert_eq!(mip_level_count(DecodedFormat::Rgba8, 256, 64), 9);
+        assert_eq!(mip_level_count(DecodedFormat::Rgba8, 1, 1), 1);
+        // 256 -> 128 -> 64 -> 32 -> 16 -> 8 -> 4.
+        assert_eq!(mip_level_count(DecodedFormat::Bc1, 256, 256), 7);
+        // 12 halves to 6, which isn't whole blocks.
+        assert_eq!(mip_level_count(DecodedFormat::Bc1, 12, 8), 1);
+    }
+
+    #[test]
+    fn rgba_chains_average_in_linear_light() {
+        // A 2x2 checker of black and white.
+        let data = [[0, 0, 0, 255], [255; 4], [255; 4], [0, 0, 0, 255]].concat();
+        let texture = with_mip_chain(DecodedTexture::new(data, 2, 2));
+        assert_eq!(texture.mip_levels, 2);
+        assert!(texture.is_valid());
+        // Half the light is sRGB 188, not the byte average of 128.
+        assert_eq!(&texture.data[16..], &[188, 188, 188, 255]);
+    }
+
+    #[test]
+    fn bc1_chains_stop_at_whole_blocks() {
+        let texture = DecodedTexture::bc1(vec![0; 4 * BC1_BLOCK_BYTES], 8, 8);
+        let texture = with_mip_chain(texture);
+        assert_eq!(texture.mip_levels, 2);
+        assert_eq!(texture.data.len(), 5 * BC1_BLOCK_BYTES);
+        assert!(texture.is_valid());
+    }
+}
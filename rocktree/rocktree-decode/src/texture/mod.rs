@@ -4,13 +4,20 @@
 //! - JPEG: Standard lossy image format
 //! - CRN-DXT1: Crunch-compressed DXT1 textures
 //!
-//! Both formats produce RGBA pixel data suitable for GPU upload.
+//! Both formats decode to RGBA pixel data suitable for GPU upload. CRN can
+//! instead stop at BC1 blocks ([`decode_texture_compressed`]) for GPUs that
+//! sample BC formats natively, at an eighth of the memory. Either can then
+//! carry its mip chain ([`with_mip_chain`]).
 
+mod bc1;
 mod crn;
 mod jpeg;
+mod mips;
 
-pub use crn::decode_crn_to_rgba;
+pub use bc1::BC1_BLOCK_BYTES;
+pub use crn::{decode_crn_to_bc1, decode_crn_to_rgba};
 pub use jpeg::decode_jpeg_to_rgba;
+pub use mips::{mip_level_count, mip_level_len, mip_level_size, with_mip_chain};
 
 use crate::error::{DecodeError, DecodeResult};
 
@@ -23,32 +30,72 @@ pub enum TextureFormat {
     CrnDxt1,
 }
 
+/// Layout of [`DecodedTexture::data`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DecodedFormat {
+    /// RGBA pixels (4 bytes per pixel).
+    Rgba8,
+    /// Opaque BC1 (DXT1) blocks (8 bytes per 4x4 block).
+    Bc1,
+}
+
 /// Decoded texture data.
 #[derive(Debug, Clone)]
 pub struct DecodedTexture {
-    /// RGBA pixel data (4 bytes per pixel).
+    /// Pixel or block data, laid out as described by [`Self::format`], one
+    /// mip level after another from the largest.
     pub data: Vec<u8>,
+    /// Layout of [`Self::data`].
+    pub format: DecodedFormat,
     /// Texture width in pixels.
     pub width: u32,
     /// Texture height in pixels.
     pub height: u32,
+    /// Mip levels in [`Self::data`], at least 1.
+    pub mip_levels: u32,
 }
 
 impl DecodedTexture {
-    /// Create a new decoded texture.
+    /// Create a new decoded RGBA texture.
     #[must_use]
     pub fn new(data: Vec<u8>, width: u32, height: u32) -> Self {
         Self {
             data,
+            format: DecodedFormat::Rgba8,
+            width,
+            height,
+            mip_levels: 1,
+        }
+    }
+
+    /// Create a new decoded BC1 texture. Both dimensions must be multiples
+    /// of 4.
+    #[must_use]
+    pub fn bc1(data: Vec<u8>, width: u32, height: u32) -> Self {
+        Self {
+            data,
+            format: DecodedFormat::Bc1,
             width,
             height,
+            mip_levels: 1,
         }
     }
 
     /// Check if the texture data size is valid.
     #[must_use]
     pub fn is_valid(&self) -> bool {
-        self.data.len() == (self.width as usize) * (self.height as usize) * 4
+        let (width, height) = (self.width, self.height);
+        if self.format == DecodedFormat::Bc1
+            && (!width.is_multiple_of(4) || !height.is_multiple_of(4))
+        {
+            return false;
+        }
+        let levels = self.mip_levels;
+        let expected: usize = (0..levels)
+            .map(|level| mip_level_len(self.format, width, height, level))
+            .sum();
+        (1..=mip_level_count(self.format, width, height)).contains(&levels)
+            && self.data.len() == expected
     }
 }
 
@@ -75,6 +122,26 @@ pub fn decode_texture(data: &[u8], format: TextureFormat) -> DecodeResult<Decode
     }
 }
 
+/// Decode a texture from compressed data, keeping block compression where
+/// the source has it.
+///
+/// CRN-DXT1 decodes to BC1 blocks when both dimensions are multiples of 4,
+/// and to RGBA otherwise; JPEG always decodes to RGBA. Check
+/// [`DecodedTexture::format`] for the result.
+///
+/// # Errors
+///
+/// Returns an error if decoding fails.
+pub fn decode_texture_compressed(
+    data: &[u8],
+    format: TextureFormat,
+) -> DecodeResult<DecodedTexture> {
+    match format {
+        TextureFormat::Jpeg => decode_jpeg_to_rgba(data),
+        TextureFormat::CrnDxt1 => decode_crn_to_bc1(data),
+    }
+}
+
 /// Detect texture format from data signature.
 ///
 /// # Arguments
@@ -149,4 +216,13 @@ mod tests {
         let invalid = DecodedTexture::new(vec![0; 15], 2, 2);
         assert!(!invalid.is_valid());
     }
+
+    #[test]
+    fn test_decoded_bc1_texture_is_valid() {
+        let texture = DecodedTexture::bc1(vec![0; 4 * BC1_BLOCK_BYTES], 8, 8);
+        assert!(texture.is_valid());
+
+        let unaligned = DecodedTexture::bc1(vec![0; BC1_BLOCK_BYTES], 2, 2);
+        assert!(!unaligned.is_valid());
+    }
 }
@@ -3,6 +3,7 @@
 use crate::{
     Vertex,
     error::{DecodeError, DecodeResult},
+    simd,
 };
 
 /// Unpack delta-encoded vertex positions.
@@ -24,23 +25,29 @@ pub fn unpack_vertices(packed: &[u8]) -> DecodeResult<Vec<Vertex>> {
     }
 
     let count = packed.len() / 3;
-    let mut vertices = vec![Vertex::default(); count];
-
-    // Delta-decode each component plane.
-    // The data is arranged as [X0..Xn, Y0..Yn, Z0..Zn].
-    let mut x: u8 = 0;
-    let mut y: u8 = 0;
-    let mut z: u8 = 0;
-
-    for i in 0..count {
-        x = x.wrapping_add(packed[i]);
-        y = y.wrapping_add(packed[count + i]);
-        z = z.wrapping_add(packed[count * 2 + i]);
+    if count == 0 {
+        return Ok(Vec::new());
+    }
 
-        vertices[i].x = x;
-        vertices[i].y = y;
-        vertices[i].z = z;
+    // Delta-decode each component plane in place, then interleave. The data
+    // is arranged as [X0..Xn, Y0..Yn, Z0..Zn].
+    let mut planes = packed.to_vec();
+    for plane in planes.chunks_exact_mut(count) {
+        simd::prefix_sum_u8(plane);
     }
+    let (xs, rest) = planes.split_at(count);
+    let (ys, zs) = rest.split_at(count);
+    let vertices = xs
+        .iter()
+        .zip(ys)
+        .zip(zs)
+        .map(|((&x, &y), &z)| Vertex {
+            x,
+            y,
+            z,
+            ..Vertex::default()
+        })
+        .collect();
 
     Ok(vertices)
 }
@@ -0,0 +1,29 @@
+// Module worker running the rocktree-worker decoder (see rocktree::workers).
+//
+// Each message carries one NodeData response, transferred from the page:
+// {id, path, blockCompressed, data}. The answer, {id, node} or {id, error},
+// transfers the packed node back. If the decoder fails to load, the worker
+// posts {initError} once instead, and the pool retires it and decodes its
+// jobs on the page.
+import init, { decode_node } from "./rocktree_worker.js";
+
+const ready = init();
+ready.catch((error) => {
+  self.postMessage({ initError: error?.message ?? String(error) });
+});
+
+self.onmessage = async (event) => {
+  const { id, path, blockCompressed, data } = event.data;
+  try {
+    await ready;
+  } catch {
+    // Already reported as {initError}; the pool answers this job itself.
+    return;
+  }
+  try {
+    const node = decode_node(path, new Uint8Array(data), blockCompressed);
+    self.postMessage({ id, node: node.buffer }, [node.buffer]);
+  } catch (error) {
+    self.postMessage({ id, error: error?.message ?? String(error) });
+  }
+};
@@ -0,0 +1,30 @@
+//! Decoder for the web build's decode workers (see `rocktree::workers`).
+//!
+//! Built to its own wasm module and loaded by `decode_worker.js`, one instance
+//! per worker. Each job is a `NodeData` response from the page; the answer is
+//! the decoded node packed by [`rocktree::wire`], whose buffer the script
+//! transfers back. Empty outside wasm.
+
+#![cfg(target_family = "wasm")]
+
+use rocktree_decode::OctreePath;
+use wasm_bindgen::prelude::*;
+
+/// Decode a `NodeData` response for the node at `path` (its octant digits),
+/// keeping CRN textures block-compressed if `block_compressed_textures` is
+/// set, and pack it for the page.
+///
+/// # Errors
+///
+/// Throws if the path or the response cannot be decoded.
+#[wasm_bindgen]
+pub fn decode_node(
+    path: &str,
+    data: &[u8],
+    block_compressed_textures: bool,
+) -> Result<Vec<u8>, JsError> {
+    let path = OctreePath::parse(path).map_err(|e| JsError::new(&e.to_string()))?;
+    let node = rocktree::decode_node(path, data, block_compressed_textures)
+        .map_err(|e| JsError::new(&e.to_string()))?;
+    Ok(rocktree::wire::encode_node(&node))
+}
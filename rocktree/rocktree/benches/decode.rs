@@ -0,0 +1,163 @@
+//! End-to-end decode throughput: a raw response in, a decoded node out.
+//!
+//! Replays the corpus recorded by the `record_fixtures` example, one
+//! benchmark per bulk-sized depth band, reporting both MB/s of response and
+//! meshes/s. The per-stage breakdown lives in `rocktree-decode`'s `unpack`
+//! bench.
+//!
+//! ```text
+//! cargo run --release -p rocktree --example record_fixtures
+//! cargo bench -p rocktree --bench decode
+//! ```
+
+use std::{hint::black_box, path::PathBuf};
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use rocktree::{decode_bulk, decode_node};
+use rocktree_decode::OctreePath;
+
+/// A recorded response and the path it was requested for.
+struct Fixture {
+    path: OctreePath,
+    data: Vec<u8>,
+}
+
+/// Fixtures of one kind in one depth band.
+struct Band {
+    label: String,
+    fixtures: Vec<Fixture>,
+    /// Meshes across the band's nodes, for the meshes/s measure; zero for
+    /// bulks.
+    meshes: u64,
+}
+
+impl Band {
+    fn bytes(&self) -> Throughput {
+        Throughput::Bytes(self.fixtures.iter().map(|f| f.data.len() as u64).sum())
+    }
+}
+
+/// Load the recorded `<prefix>-<path>.pb` files, grouped into depth bands.
+fn load(prefix: &str) -> Vec<Band> {
+    let dir = std::env::var_os("ROCKTREE_FIXTURES").map_or_else(
+        || PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("../fixtures"),
+        PathBuf::from,
+    );
+    let Ok(entries) = std::fs::read_dir(dir) else {
+        return Vec::new();
+    };
+
+    let mut bands: Vec<Band> = Vec::new();
+    for entry in entries.flatten() {
+        let name = entry.file_name();
+        let Some(stem) = name.to_str().and_then(|n| {
+            n.strip_prefix(prefix)?
+                .strip_prefix('-')?
+                .strip_suffix(".pb")
+        }) else {
+            continue;
+        };
+        let path = if stem == "root" {
+            OctreePath::ROOT
+        } else {
+            let Ok(path) = OctreePath::parse(stem) else {
+                continue;
+            };
+            path
+        };
+        let Ok(data) = std::fs::read(entry.path()) else {
+            continue;
+        };
+        let (meshes, label) = if prefix == "node" {
+            let Ok(node) = decode_node(path, &data, false) else {
+                continue;
+            };
+            // Node bands follow the bulk boundaries: depths 1-4, 5-8, ...
+            let first = path.depth().saturating_sub(1) / 4 * 4 + 1;
+            (
+                node.meshes.len() as u64,
+                format!("depth {first:02}-{:02}", first + 3),
+            )
+        } else {
+            (0, format!("depth {:02}", path.depth()))
+        };
+        let index = match bands.iter().position(|b| b.label == label) {
+            Some(index) => index,
+            None => {
+                bands.push(Band {
+                    label,
+                    fixtures: Vec::new(),
+                    meshes: 0,
+                });
+                bands.len() - 1
+            }
+        };
+        bands[index].fixtures.push(Fixture { path, data });
+        bands[index].meshes += meshes;
+    }
+    bands.sort_by(|a, b| a.label.cmp(&b.label));
+    bands
+}
+
+fn nodes(c: &mut Criterion) {
+    let bands = load("node");
+    if bands.is_empty() {
+        eprintln!(
+            "No rocktree fixtures found; record some with \
+             `cargo run --release -p rocktree --example record_fixtures`"
+        );
+        return;
+    }
+
+    for (name, block_compressed) in [("decode_node_rgba", false), ("decode_node_bc1", true)] {
+        let mut group = c.benchmark_group(name);
+        group.sample_size(20);
+        for band in &bands {
+            group.throughput(band.bytes());
+            group.bench_function(BenchmarkId::new("bytes", &band.label), |b| {
+                b.iter(|| {
+                    for f in &band.fixtures {
+                        black_box(decode_node(f.path, black_box(&f.data), block_compressed).ok());
+                    }
+                });
+            });
+            // Criterion reports one throughput per benchmark, so meshes/s
+            // is a second run of the same loop; once per band is enough.
+            if block_compressed {
+                continue;
+            }
+            group.throughput(Throughput::Elements(band.meshes));
+            group.bench_function(BenchmarkId::new("meshes", &band.label), |b| {
+                b.iter(|| {
+                    for f in &band.fixtures {
+                        black_box(decode_node(f.path, black_box(&f.data), false).ok());
+                    }
+                });
+            });
+        }
+        group.finish();
+    }
+}
+
+fn bulks(c: &mut Criterion) {
+    let bands = load("bulk");
+    if bands.is_empty() {
+        return;
+    }
+
+    let mut group = c.benchmark_group("decode_bulk");
+    for band in &bands {
+        group.throughput(band.bytes());
+        group.bench_function(BenchmarkId::from_parameter(&band.label), |b| {
+            b.iter(|| {
+                for f in &band.fixtures {
+                    black_box(decode_bulk(f.path, black_box(&f.data)).ok());
+                }
+            });
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, nodes, bulks);
+criterion_main!(benches);
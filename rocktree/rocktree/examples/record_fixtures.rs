@@ -0,0 +1,132 @@
+//! Record a corpus of raw rocktree responses for the decode benchmarks.
+//!
+//! Descends the octree towards a point, saving the bulks it passes through
+//! and the nodes nearest the point at every depth, so the corpus spans the
+//! whole range of tile sizes the streamer sees:
+//!
+//! ```text
+//! cargo run --release -p rocktree --example record_fixtures -- [lat] [lon] [max_depth] [per_depth]
+//! ```
+//!
+//! Files are written to `rocktree/fixtures` (or `$ROCKTREE_FIXTURES`) as
+//! `bulk-<path>.pb` and `node-<path>.pb`, with the root bulk as
+//! `bulk-root.pb`. The benchmarks in `rocktree` and `rocktree-decode` replay
+//! them.
+
+use std::path::PathBuf;
+
+use glam::DVec3;
+use rocktree::{BulkMetadata, BulkRequest, Client, NodeRequest, decode_bulk};
+use rocktree_decode::OctreePath;
+
+/// Mean Earth radius (m); precise enough to pick the nodes nearest a point.
+const EARTH_RADIUS_M: f64 = 6_371_000.0;
+
+#[tokio::main]
+async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let args: Vec<String> = std::env::args().skip(1).collect();
+    let arg = |i: usize, default: f64| -> Result<f64, Box<dyn std::error::Error>> {
+        Ok(args
+            .get(i)
+            .map(|a| a.parse())
+            .transpose()?
+            .unwrap_or(default))
+    };
+    // Central Zurich by default: dense photogrammetry down to the leaves.
+    let (lat, lon) = (arg(0, 47.3769)?, arg(1, 8.5417)?);
+    let max_depth = arg(2, 20.0)? as usize;
+    let per_depth = arg(3, 3.0)? as usize;
+
+    let dir = std::env::var_os("ROCKTREE_FIXTURES").map_or_else(
+        || PathBuf::from(env!("CARGO_MANIFEST_DIR")).join("../fixtures"),
+        PathBuf::from,
+    );
+    std::fs::create_dir_all(&dir)?;
+
+    let (lat, lon) = (lat.to_radians(), lon.to_radians());
+    let target =
+        DVec3::new(lat.cos() * lon.cos(), lat.cos() * lon.sin(), lat.sin()) * EARTH_RADIUS_M;
+
+    let client = Client::new();
+    let planetoid = client.fetch_planetoid().await?;
+    let root = fetch_bulk(&client, &dir, BulkRequest::root(planetoid.root_epoch)).await?;
+
+    let mut bulks = vec![root];
+    let mut recorded = 0;
+    while !bulks.is_empty() {
+        // Record the nodes nearest the target at each depth these bulks span.
+        let mut nodes: Vec<_> = bulks
+            .iter()
+            .flat_map(|bulk| &bulk.nodes)
+            .filter(|node| node.has_data && node.path.depth() <= max_depth)
+            .collect();
+        nodes.sort_by(|a, b| {
+            (a.path.depth(), a.obb.center.distance(target))
+                .partial_cmp(&(b.path.depth(), b.obb.center.distance(target)))
+                .expect("distances are finite")
+        });
+        let mut depth_count = (0, 0);
+        for node in nodes {
+            if depth_count.0 != node.path.depth() {
+                depth_count = (node.path.depth(), 0);
+            }
+            if depth_count.1 == per_depth {
+                continue;
+            }
+            depth_count.1 += 1;
+
+            let request = NodeRequest::new(
+                node.path,
+                node.epoch,
+                node.texture_format,
+                node.imagery_epoch,
+            );
+            let data = client
+                .fetch_bytes_from_url(&client.node_url(&request))
+                .await?;
+            std::fs::write(dir.join(format!("node-{}.pb", node.path)), &data)?;
+            recorded += 1;
+        }
+
+        // Descend into the child bulks nearest the target.
+        let mut children: Vec<(OctreePath, u32, f64)> = bulks
+            .iter()
+            .flat_map(|bulk| {
+                bulk.child_bulk_paths.iter().filter_map(|(rel, &epoch)| {
+                    let path = bulk.path.extend(*rel);
+                    let node = bulk.nodes.iter().find(|n| n.path == path)?;
+                    Some((path, epoch, node.obb.center.distance(target)))
+                })
+            })
+            .filter(|(path, _, _)| path.depth() < max_depth)
+            .collect();
+        children.sort_by(|a, b| a.2.partial_cmp(&b.2).expect("distances are finite"));
+        children.truncate(per_depth);
+
+        bulks = Vec::with_capacity(children.len());
+        for (path, epoch, _) in children {
+            bulks.push(fetch_bulk(&client, &dir, BulkRequest::new(path, epoch)).await?);
+        }
+    }
+
+    println!("Recorded {recorded} nodes to {}", dir.display());
+    Ok(())
+}
+
+/// Fetch a bulk, saving its raw response.
+async fn fetch_bulk(
+    client: &Client,
+    dir: &std::path::Path,
+    request: BulkRequest,
+) -> Result<BulkMetadata, Box<dyn std::error::Error>> {
+    let data = client
+        .fetch_bytes_from_url(&client.bulk_url(&request))
+        .await?;
+    let name = if request.path.is_root() {
+        "root".to_string()
+    } else {
+        request.path.to_string()
+    };
+    std::fs::write(dir.join(format!("bulk-{name}.pb")), &data)?;
+    Ok(decode_bulk(request.path, &data)?)
+}
@@ -0,0 +1,1062 @@
+//! Cache abstractions for storing fetched data.
+//!
+//! This module provides a `Cache` trait and implementations for caching
+//! downloaded data to reduce network requests.
+//!
+//! # Implementations
+//!
+//! - [`MemoryCache`]: Sharded in-memory LRU cache with optional size limits
+//! - [`FilesystemCache`]: Disk-based cache, one file per URL (native only)
+//! - [`PackCache`]: Disk-based cache in memory-mapped pack segments (native only)
+//! - [`NoCache`]: Passthrough implementation that caches nothing
+
+#[cfg(not(target_family = "wasm"))]
+mod pack;
+
+#[cfg(not(target_family = "wasm"))]
+pub use pack::PackCache;
+
+#[cfg(not(target_family = "wasm"))]
+use crate::error::Error;
+use crate::error::Result;
+use std::{
+    collections::HashMap,
+    fmt,
+    future::Future,
+    ops::Deref,
+    pin::Pin,
+    sync::{
+        Arc, Mutex,
+        atomic::{AtomicU64, Ordering},
+    },
+};
+
+/// Future type for cache get operations.
+pub type GetFuture<'a> = Pin<Box<dyn Future<Output = Result<Option<Blob>>> + Send + 'a>>;
+
+/// Future type for cache put/remove operations.
+pub type CacheFuture<'a> = Pin<Box<dyn Future<Output = Result<()>> + Send + 'a>>;
+
+/// Future type for cache contains operations.
+pub type ContainsFuture<'a> = Pin<Box<dyn Future<Output = Result<bool>> + Send + 'a>>;
+
+/// Cached bytes returned by [`Cache::get`], shared rather than copied.
+///
+/// Dereferences to `[u8]`. Backed either by an `Arc<[u8]>` or, for
+/// [`PackCache`], by a range of a memory-mapped pack segment.
+#[derive(Clone)]
+pub struct Blob(BlobInner);
+
+#[derive(Clone)]
+enum BlobInner {
+    Shared(Arc<[u8]>),
+    #[cfg(not(target_family = "wasm"))]
+    Mapped {
+        map: Arc<memmap2::Mmap>,
+        range: std::ops::Range<usize>,
+    },
+}
+
+impl Blob {
+    /// A blob viewing `range` of a mapped segment.
+    #[cfg(not(target_family = "wasm"))]
+    fn mapped(map: Arc<memmap2::Mmap>, range: std::ops::Range<usize>) -> Self {
+        debug_assert!(range.end <= map.len());
+        Self(BlobInner::Mapped { map, range })
+    }
+}
+
+impl Deref for Blob {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        match &self.0 {
+            BlobInner::Shared(data) => data,
+            #[cfg(not(target_family = "wasm"))]
+            BlobInner::Mapped { map, range } => &map[range.clone()],
+        }
+    }
+}
+
+impl AsRef<[u8]> for Blob {
+    fn as_ref(&self) -> &[u8] {
+        self
+    }
+}
+
+impl From<Arc<[u8]>> for Blob {
+    fn from(data: Arc<[u8]>) -> Self {
+        Self(BlobInner::Shared(data))
+    }
+}
+
+impl From<Vec<u8>> for Blob {
+    fn from(data: Vec<u8>) -> Self {
+        Self(BlobInner::Shared(data.into()))
+    }
+}
+
+impl fmt::Debug for Blob {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("Blob").field("len", &self.len()).finish()
+    }
+}
+
+/// A cache for storing fetched data.
+///
+/// The cache is keyed by URL and stores raw bytes. Implementations may
+/// choose to store data in memory, on disk, or in any other persistent
+/// storage. Data goes in as `Arc<[u8]>` and comes out as a [`Blob`], so
+/// in-memory and memory-mapped implementations can hand it out without
+/// copying.
+pub trait Cache: Send + Sync {
+    /// Get data from the cache.
+    ///
+    /// Returns `Ok(Some(data))` if the data is cached, `Ok(None)` if not cached,
+    /// or an error if the cache operation failed.
+    fn get(&self, url: &str) -> GetFuture<'_>;
+
+    /// Store data in the cache.
+    ///
+    /// The data is associated with the given URL for later retrieval.
+    fn put(&self, url: &str, data: Arc<[u8]>) -> CacheFuture<'_>;
+
+    /// Check if data exists in the cache without retrieving it.
+    fn contains(&self, url: &str) -> ContainsFuture<'_>;
+
+    /// Remove data from the cache.
+    fn remove(&self, url: &str) -> CacheFuture<'_>;
+
+    /// Clear all cached data.
+    fn clear(&self) -> CacheFuture<'_>;
+}
+
+/// A cache that stores nothing (passthrough).
+///
+/// This is useful when caching is not desired or for testing.
+#[derive(Debug, Clone, Default)]
+pub struct NoCache;
+
+impl NoCache {
+    /// Create a new no-op cache.
+    #[must_use]
+    pub fn new() -> Self {
+        Self
+    }
+}
+
+impl Cache for NoCache {
+    fn get(&self, _url: &str) -> GetFuture<'_> {
+        Box::pin(async { Ok(None) })
+    }
+
+    fn put(&self, _url: &str, _data: Arc<[u8]>) -> CacheFuture<'_> {
+        Box::pin(async { Ok(()) })
+    }
+
+    fn contains(&self, _url: &str) -> ContainsFuture<'_> {
+        Box::pin(async { Ok(false) })
+    }
+
+    fn remove(&self, _url: &str) -> CacheFuture<'_> {
+        Box::pin(async { Ok(()) })
+    }
+
+    fn clear(&self) -> CacheFuture<'_> {
+        Box::pin(async { Ok(()) })
+    }
+}
+
+/// An in-memory LRU cache.
+///
+/// Entries are spread over independently locked shards by URL hash, so
+/// concurrent fetches on different tiles rarely contend; each shard keeps
+/// its own O(1) LRU list. Data is stored as `Arc<[u8]>` and handed out
+/// without copying.
+///
+/// The cache has an optional maximum size in bytes, split evenly across the
+/// shards. When a shard exceeds its share, its least recently used entries
+/// are evicted, so eviction order is LRU per shard rather than globally.
+/// Small caches use fewer shards so each share still holds whole tiles.
+#[derive(Debug)]
+pub struct MemoryCache {
+    shards: Arc<[Mutex<LruShard>]>,
+    /// Byte budget per shard.
+    max_shard_size: Option<usize>,
+    counters: Arc<MemoryCacheCounters>,
+}
+
+/// Number of shards for an unbounded cache, or the most for a bounded one.
+const MAX_SHARDS: usize = 16;
+
+/// Smallest per-shard budget worth sharding for; below this a bounded cache
+/// uses fewer shards (down to one).
+const MIN_SHARD_BYTES: usize = 1 << 20;
+
+/// Hit, miss, and eviction counts for a [`MemoryCache`], plus its current
+/// occupancy, for sizing it.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct MemoryCacheStats {
+    /// `get` calls that found their entry.
+    pub hits: u64,
+    /// `get` calls that didn't.
+    pub misses: u64,
+    /// Entries evicted to stay within the size limit.
+    pub evictions: u64,
+    /// Number of cached entries.
+    pub entries: usize,
+    /// Total size of cached data in bytes.
+    pub bytes: usize,
+}
+
+#[derive(Debug, Default)]
+struct MemoryCacheCounters {
+    hits: AtomicU64,
+    misses: AtomicU64,
+    evictions: AtomicU64,
+}
+
+/// Sentinel slot index terminating the LRU list.
+const NIL: usize = usize::MAX;
+
+/// One shard: a slab of entries threaded onto a doubly linked recency list
+/// (head = most recently used), with a map from URL to slot.
+#[derive(Debug)]
+struct LruShard {
+    index: HashMap<Arc<str>, usize>,
+    slots: Vec<Option<LruEntry>>,
+    free: Vec<usize>,
+    head: usize,
+    tail: usize,
+    size: usize,
+}
+
+#[derive(Debug)]
+struct LruEntry {
+    url: Arc<str>,
+    data: Arc<[u8]>,
+    prev: usize,
+    next: usize,
+}
+
+impl Default for LruShard {
+    fn default() -> Self {
+        Self {
+            index: HashMap::new(),
+            slots: Vec::new(),
+            free: Vec::new(),
+            head: NIL,
+            tail: NIL,
+            size: 0,
+        }
+    }
+}
+
+impl LruShard {
+    fn entry(&mut self, slot: usize) -> &mut LruEntry {
+        self.slots[slot].as_mut().expect("linked slot is occupied")
+    }
+
+    /// Look up an entry, marking it most recently used.
+    fn get(&mut self, url: &str) -> Option<Arc<[u8]>> {
+        let slot = *self.index.get(url)?;
+        self.unlink(slot);
+        self.push_front(slot);
+        Some(Arc::clone(&self.entry(slot).data))
+    }
+
+    /// Insert or replace an entry, then evict from the tail until the shard
+    /// fits `max_size`. Returns the number of entries evicted.
+    fn insert(&mut self, url: &str, data: Arc<[u8]>, max_size: Option<usize>) -> u64 {
+        self.remove(url);
+
+        let mut evicted = 0;
+        if let Some(max_size) = max_size {
+            while self.size + data.len() > max_size && self.tail != NIL {
+                let url = Arc::clone(&self.entry(self.tail).url);
+                self.remove(&url);
+                evicted += 1;
+            }
+        }
+
+        self.size += data.len();
+        let url: Arc<str> = Arc::from(url);
+        let entry = LruEntry {
+            url: Arc::clone(&url),
+            data,
+            prev: NIL,
+            next: NIL,
+        };
+        let slot = if let Some(slot) = self.free.pop() {
+            self.slots[slot] = Some(entry);
+            slot
+        } else {
+            self.slots.push(Some(entry));
+            self.slots.len() - 1
+        };
+        self.index.insert(url, slot);
+        self.push_front(slot);
+        evicted
+    }
+
+    fn remove(&mut self, url: &str) -> bool {
+        let Some(slot) = self.index.remove(url) else {
+            return false;
+        };
+        self.unlink(slot);
+        let entry = self.slots[slot].take().expect("indexed slot is occupied");
+        self.size -= entry.data.len();
+        self.free.push(slot);
+        true
+    }
+
+    fn clear(&mut self) {
+        *self = Self::default();
+    }
+
+    fn unlink(&mut self, slot: usize) {
+        let (prev, next) = {
+            let entry = self.entry(slot);
+            (entry.prev, entry.next)
+        };
+        if prev == NIL {
+            self.head = next;
+        } else {
+            self.entry(prev).next = next;
+        }
+        if next == NIL {
+            self.tail = prev;
+        } else {
+            self.entry(next).prev = prev;
+        }
+    }
+
+    fn push_front(&mut self, slot: usize) {
+        let head = self.head;
+        {
+            let entry = self.entry(slot);
+            entry.prev = NIL;
+            entry.next = head;
+        }
+        if head == NIL {
+            self.tail = slot;
+        } else {
+            self.entry(head).prev = slot;
+        }
+        self.head = slot;
+    }
+}
+
+impl MemoryCache {
+    /// Create a new memory cache with no size limit.
+    #[must_use]
+    pub fn new() -> Self {
+        Self::with_shards(MAX_SHARDS, None)
+    }
+
+    /// Create a new memory cache with a maximum size in bytes.
+    #[must_use]
+    pub fn with_max_size(max_size: usize) -> Self {
+        let shards = (max_size / MIN_SHARD_BYTES).clamp(1, MAX_SHARDS);
+        Self::with_shards(shards, Some(max_size / shards))
+    }
+
+    fn with_shards(shards: usize, max_shard_size: Option<usize>) -> Self {
+        Self {
+            shards: (0..shards).map(|_| Mutex::default()).collect(),
+            max_shard_size,
+            counters: Arc::default(),
+        }
+    }
+
+    fn shard(&self, url: &str) -> &Mutex<LruShard> {
+        &self.shards[(fnv1a(url.as_bytes()) % self.shards.len() as u64) as usize]
+    }
+
+    /// Get the current size of cached data in bytes.
+    #[must_use]
+    pub fn size(&self) -> usize {
+        self.shards.iter().map(|s| s.lock().unwrap().size).sum()
+    }
+
+    /// Get the number of cached entries.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.shards
+            .iter()
+            .map(|s| s.lock().unwrap().index.len())
+            .sum()
+    }
+
+    /// Check if the cache is empty.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Hit, miss, and eviction counts since creation, and current occupancy.
+    #[must_use]
+    pub fn stats(&self) -> MemoryCacheStats {
+        let (entries, bytes) = self.shards.iter().fold((0, 0), |(entries, bytes), shard| {
+            let shard = shard.lock().unwrap();
+            (entries + shard.index.len(), bytes + shard.size)
+        });
+        MemoryCacheStats {
+            hits: self.counters.hits.load(Ordering::Relaxed),
+            misses: self.counters.misses.load(Ordering::Relaxed),
+            evictions: self.counters.evictions.load(Ordering::Relaxed),
+            entries,
+            bytes,
+        }
+    }
+}
+
+impl Default for MemoryCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Clone for MemoryCache {
+    fn clone(&self) -> Self {
+        Self {
+            shards: Arc::clone(&self.shards),
+            max_shard_size: self.max_shard_size,
+            counters: Arc::clone(&self.counters),
+        }
+    }
+}
+
+impl Cache for MemoryCache {
+    fn get(&self, url: &str) -> GetFuture<'_> {
+        let result = self.shard(url).lock().unwrap().get(url).map(Blob::from);
+        let counter = if result.is_some() {
+            &self.counters.hits
+        } else {
+            &self.counters.misses
+        };
+        counter.fetch_add(1, Ordering::Relaxed);
+        Box::pin(async move { Ok(result) })
+    }
+
+    fn put(&self, url: &str, data: Arc<[u8]>) -> CacheFuture<'_> {
+        let evicted = self
+            .shard(url)
+            .lock()
+            .unwrap()
+            .insert(url, data, self.max_shard_size);
+        if evicted > 0 {
+            self.counters
+                .evictions
+                .fetch_add(evicted, Ordering::Relaxed);
+        }
+        Box::pin(async { Ok(()) })
+    }
+
+    fn contains(&self, url: &str) -> ContainsFuture<'_> {
+        let result = self.shard(url).lock().unwrap().index.contains_key(url);
+        Box::pin(async move { Ok(result) })
+    }
+
+    fn remove(&self, url: &str) -> CacheFuture<'_> {
+        self.shard(url).lock().unwrap().remove(url);
+        Box::pin(async { Ok(()) })
+    }
+
+    fn clear(&self) -> CacheFuture<'_> {
+        for shard in self.shards.iter() {
+            shard.lock().unwrap().clear();
+        }
+        Box::pin(async { Ok(()) })
+    }
+}
+
+/// A disk-backed cache storing one file per URL (native only).
+///
+/// Each entry is `[u32 LE url length][url bytes][data bytes]`, so a hash
+/// collision on the filename degrades to a cache miss (the stored URL is
+/// verified on read) rather than serving the wrong tile. Writes are atomic
+/// (temp file + rename), so a crash mid-write never leaves a torn entry.
+///
+/// No TTL: rocktree data is epoch-versioned and the epoch is part of the URL,
+/// so a superseded entry is simply never requested again. Tiles themselves
+/// live in a [`PackCache`]; this serves data derived from them under the
+/// shared `<cache dir>/veldera` root (see [`FilesystemCache::veldera_subdir`]).
+///
+/// An optional size limit evicts the least recently used entries. Their sizes
+/// and recency are read from the directory on first use, and a hit touches
+/// its file's modification time, so the order carries over between runs.
+///
+/// I/O is synchronous (small reads/writes wrapped in ready futures, like
+/// [`MemoryCache`]), keeping the crate runtime-agnostic.
+#[cfg(not(target_family = "wasm"))]
+#[derive(Debug, Clone)]
+pub struct FilesystemCache {
+    dir: std::path::PathBuf,
+    /// Shared by clones, so they evict from one index.
+    limit: Option<Arc<SizeLimit>>,
+}
+
+/// A [`FilesystemCache`] size limit and the index enforcing it.
+#[cfg(not(target_family = "wasm"))]
+#[derive(Debug)]
+struct SizeLimit {
+    max_size: u64,
+    /// `None` until the directory is first scanned.
+    index: Mutex<Option<DiskIndex>>,
+}
+
+/// Sizes and recency of a size-limited [`FilesystemCache`]'s entries.
+#[cfg(not(target_family = "wasm"))]
+#[derive(Debug, Default)]
+struct DiskIndex {
+    /// Entry file name (its URL hash) to its size and last-use tick.
+    entries: HashMap<u64, (u64, u64)>,
+    total: u64,
+    tick: u64,
+}
+
+#[cfg(not(target_family = "wasm"))]
+impl DiskIndex {
+    /// Index the entries in `dir`, oldest modification first.
+    fn scan(dir: &std::path::Path) -> Self {
+        let mut found: Vec<(std::time::SystemTime, u64, u64)> = std::fs::read_dir(dir)
+            .into_iter()
+            .flatten()
+            .filter_map(|entry| {
+                let entry = entry.ok()?;
+                let name = entry.file_name();
+                let name = name.to_str().filter(|name| name.len() == 16)?;
+                let hash = u64::from_str_radix(name, 16).ok()?;
+                let meta = entry.metadata().ok().filter(std::fs::Metadata::is_file)?;
+                Some((meta.modified().ok()?, hash, meta.len()))
+            })
+            .collect();
+        found.sort_unstable();
+        let mut index = Self::default();
+        for (_, hash, size) in found {
+            index.insert(hash, size);
+        }
+        index
+    }
+
+    fn touch(&mut self, hash: u64) {
+        self.tick += 1;
+        if let Some(entry) = self.entries.get_mut(&hash) {
+            entry.1 = self.tick;
+        }
+    }
+
+    fn insert(&mut self, hash: u64, size: u64) {
+        self.tick += 1;
+        if let Some((old, _)) = self.entries.insert(hash, (size, self.tick)) {
+            self.total -= old;
+        }
+        self.total += size;
+    }
+
+    fn remove(&mut self, hash: u64) {
+        if let Some((size, _)) = self.entries.remove(&hash) {
+            self.total -= size;
+        }
+    }
+
+    /// Drop the least recently used entries, sparing `keep`, until the total
+    /// is an eighth under `max_size`, so eviction runs in batches rather than
+    /// on every write. Returns the dropped entries.
+    fn evict(&mut self, max_size: u64, keep: u64) -> Vec<u64> {
+        if self.total <= max_size {
+            return Vec::new();
+        }
+        let target = max_size - max_size / 8;
+        let mut by_age: Vec<(u64, u64)> = self
+            .entries
+            .iter()
+            .filter(|&(&hash, _)| hash != keep)
+            .map(|(&hash, &(_, tick))| (tick, hash))
+            .collect();
+        by_age.sort_unstable();
+        let mut evicted = Vec::new();
+        for (_, hash) in by_age {
+            if self.total <= target {
+                break;
+            }
+            self.remove(hash);
+            evicted.push(hash);
+        }
+        evicted
+    }
+}
+
+#[cfg(not(target_family = "wasm"))]
+impl FilesystemCache {
+    /// Create a cache storing its files directly in `dir`.
+    #[must_use]
+    pub fn new(dir: impl Into<std::path::PathBuf>) -> Self {
+        Self {
+            dir: dir.into(),
+            limit: None,
+        }
+    }
+
+    /// Create a cache in `dir` that keeps its total size under `max_size`
+    /// bytes by evicting the least recently used entries.
+    #[must_use]
+    pub fn with_max_size(dir: impl Into<std::path::PathBuf>, max_size: u64) -> Self {
+        Self {
+            dir: dir.into(),
+            limit: Some(Arc::new(SizeLimit {
+                max_size,
+                index: Mutex::new(None),
+            })),
+        }
+    }
+
+    /// Create a cache under `<OS cache dir>/veldera/<name>`, limited to
+    /// `max_size` bytes, for data derived from tiles (built colliders, say)
+    /// that is keyed by their epochs and so needs no TTL either. Returns
+    /// `None` when the OS cache directory cannot be resolved.
+    #[must_use]
+    pub fn veldera_subdir(name: &str, max_size: u64) -> Option<Self> {
+        Some(Self::with_max_size(
+            dirs::cache_dir()?.join("veldera").join(name),
+            max_size,
+        ))
+    }
+
+    /// The on-disk path for an entry.
+    fn path_for(&self, hash: u64) -> std::path::PathBuf {
+        self.dir.join(format!("{hash:016x}"))
+    }
+
+    /// Run `f` on the size limit's index, scanning the directory first if
+    /// this is its first use. Returns `None` for an unlimited cache.
+    fn with_index<R>(&self, f: impl FnOnce(u64, &mut DiskIndex) -> R) -> Option<R> {
+        let limit = self.limit.as_ref()?;
+        let mut index = limit.index.lock().unwrap();
+        let index = index.get_or_insert_with(|| DiskIndex::scan(&self.dir));
+        Some(f(limit.max_size, index))
+    }
+
+    /// Read the entry at `path`, returning its data only if the stored URL
+    /// matches `url` (guarding against the rare filename-hash collision).
+    fn read_verified(path: &std::path::Path, url: &str) -> Result<Option<Blob>> {
+        let bytes = match std::fs::read(path) {
+            Ok(bytes) => bytes,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(None),
+            Err(e) => {
+                return Err(Error::Cache {
+                    operation: "read",
+                    message: e.to_string(),
+                });
+            }
+        };
+        let Some((stored_url, data)) = split_entry(&bytes) else {
+            // Truncated or foreign file: treat as a miss.
+            return Ok(None);
+        };
+        if stored_url == url.as_bytes() {
+            Ok(Some(Blob::from(Arc::<[u8]>::from(data))))
+        } else {
+            Ok(None)
+        }
+    }
+}
+
+#[cfg(not(target_family = "wasm"))]
+impl Cache for FilesystemCache {
+    fn get(&self, url: &str) -> GetFuture<'_> {
+        let hash = fnv1a(url.as_bytes());
+        let path = self.path_for(hash);
+        let result = Self::read_verified(&path, url);
+        if let Ok(Some(_)) = &result
+            && self.with_index(|_, index| index.touch(hash)).is_some()
+        {
+            // Best effort: a stale time only ages the entry on the next scan.
+            let _ = std::fs::File::options()
+                .write(true)
+                .open(&path)
+                .and_then(|file| file.set_modified(std::time::SystemTime::now()));
+        }
+        Box::pin(async move { result })
+    }
+
+    fn put(&self, url: &str, data: Arc<[u8]>) -> CacheFuture<'_> {
+        let hash = fnv1a(url.as_bytes());
+        let result = write_entry(&self.dir, &self.path_for(hash), url, &data);
+        if result.is_ok() {
+            let size = (4 + url.len() + data.len()) as u64;
+            let evicted = self
+                .with_index(|max_size, index| {
+                    index.insert(hash, size);
+                    index.evict(max_size, hash)
+                })
+                .unwrap_or_default();
+            for hash in evicted {
+                let _ = std::fs::remove_file(self.path_for(hash));
+            }
+        }
+        Box::pin(async move { result })
+    }
+
+    fn contains(&self, url: &str) -> ContainsFuture<'_> {
+        let path = self.path_for(fnv1a(url.as_bytes()));
+        let result = Self::read_verified(&path, url).map(|d| d.is_some());
+        Box::pin(async move { result })
+    }
+
+    fn remove(&self, url: &str) -> CacheFuture<'_> {
+        let hash = fnv1a(url.as_bytes());
+        self.with_index(|_, index| index.remove(hash));
+        let result = match std::fs::remove_file(self.path_for(hash)) {
+            Ok(()) => Ok(()),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(()),
+            Err(e) => Err(Error::Cache {
+                operation: "remove",
+                message: e.to_string(),
+            }),
+        };
+        Box::pin(async move { result })
+    }
+
+    fn clear(&self) -> CacheFuture<'_> {
+        if let Some(limit) = &self.limit {
+            *limit.index.lock().unwrap() = Some(DiskIndex::default());
+        }
+        let result = match std::fs::remove_dir_all(&self.dir) {
+            Ok(()) => Ok(()),
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Ok(()),
+            Err(e) => Err(Error::Cache {
+                operation: "clear",
+                message: e.to_string(),
+            }),
+        };
+        Box::pin(async move { result })
+    }
+}
+
+/// Split a stored entry into its URL and data halves, or `None` if the buffer
+/// is too short or its declared URL length overruns it.
+#[cfg(not(target_family = "wasm"))]
+fn split_entry(bytes: &[u8]) -> Option<(&[u8], &[u8])> {
+    let (len_bytes, rest) = bytes.split_first_chunk::<4>()?;
+    let url_len = u32::from_le_bytes(*len_bytes) as usize;
+    if rest.len() < url_len {
+        return None;
+    }
+    Some(rest.split_at(url_len))
+}
+
+/// Write a URL/data entry to `path` atomically (temp file + rename), creating
+/// `dir` if needed.
+#[cfg(not(target_family = "wasm"))]
+fn write_entry(
+    dir: &std::path::Path,
+    path: &std::path::Path,
+    url: &str,
+    data: &[u8],
+) -> Result<()> {
+    use std::io::Write;
+    static NONCE: AtomicU64 = AtomicU64::new(0);
+
+    std::fs::create_dir_all(dir).map_err(|e| Error::Cache {
+        operation: "create dir",
+        message: e.to_string(),
+    })?;
+
+    let tmp = path.with_extension(format!(
+        "tmp.{}.{}",
+        std::process::id(),
+        NONCE.fetch_add(1, Ordering::Relaxed)
+    ));
+    let write = || -> std::io::Result<()> {
+        let mut file = std::fs::File::create(&tmp)?;
+        file.write_all(&(url.len() as u32).to_le_bytes())?;
+        file.write_all(url.as_bytes())?;
+        file.write_all(data)?;
+        file.sync_all()?;
+        std::fs::rename(&tmp, path)
+    };
+    write().map_err(|e| {
+        let _ = std::fs::remove_file(&tmp);
+        Error::Cache {
+            operation: "write",
+            message: e.to_string(),
+        }
+    })
+}
+
+/// FNV-1a 64-bit hash, used to pick a [`MemoryCache`] shard, to derive a
+/// filesystem-safe filename from a URL, and to key [`PackCache`] entries.
+/// Stable across runs (collisions are caught by the stored-URL checks).
+fn fnv1a(bytes: &[u8]) -> u64 {
+    let mut hash = 0xcbf2_9ce4_8422_2325u64;
+    for &byte in bytes {
+        hash ^= u64::from(byte);
+        hash = hash.wrapping_mul(0x0000_0100_0000_01b3);
+    }
+    hash
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    pub(super) fn block_on<F: Future>(f: F) -> F::Output {
+        // Simple parking executor for tests: the in-memory caches are ready
+        // on the first poll, and `PackCache` wakes its futures from its own
+        // threads.
+        use std::task::{Context, Poll, Wake, Waker};
+
+        struct Unpark(std::thread::Thread);
+
+        impl Wake for Unpark {
+            fn wake(self: Arc<Self>) {
+                self.0.unpark();
+            }
+        }
+
+        let waker = Waker::from(Arc::new(Unpark(std::thread::current())));
+        let mut cx = Context::from_waker(&waker);
+        let mut f = std::pin::pin!(f);
+        loop {
+            if let Poll::Ready(result) = f.as_mut().poll(&mut cx) {
+                return result;
+            }
+            std::thread::park();
+        }
+    }
+
+    /// Fetch an entry as an owned vector, for easy comparison.
+    fn get(cache: &impl Cache, url: &str) -> Option<Vec<u8>> {
+        block_on(cache.get(url))
+            .unwrap()
+            .as_deref()
+            .map(<[u8]>::to_vec)
+    }
+
+    #[test]
+    fn test_no_cache() {
+        let cache = NoCache::new();
+
+        // Put should succeed but not store anything.
+        block_on(cache.put("http://example.com", Arc::from([1, 2, 3]))).unwrap();
+
+        // Get should return None.
+        let result = get(&cache, "http://example.com");
+        assert!(result.is_none());
+
+        // Contains should return false.
+        let contains = block_on(cache.contains("http://example.com")).unwrap();
+        assert!(!contains);
+    }
+
+    #[test]
+    fn test_memory_cache_basic() {
+        let cache = MemoryCache::new();
+
+        // Initially empty.
+        assert!(cache.is_empty());
+        assert_eq!(cache.size(), 0);
+
+        // Put data.
+        block_on(cache.put("http://example.com/a", Arc::from([1, 2, 3]))).unwrap();
+        assert!(!cache.is_empty());
+        assert_eq!(cache.len(), 1);
+        assert_eq!(cache.size(), 3);
+
+        // Get data.
+        let result = get(&cache, "http://example.com/a");
+        assert_eq!(result, Some(vec![1, 2, 3]));
+
+        // Contains.
+        assert!(block_on(cache.contains("http://example.com/a")).unwrap());
+        assert!(!block_on(cache.contains("http://example.com/b")).unwrap());
+
+        // Remove.
+        block_on(cache.remove("http://example.com/a")).unwrap();
+        assert!(cache.is_empty());
+        assert_eq!(cache.size(), 0);
+    }
+
+    #[test]
+    fn test_memory_cache_eviction() {
+        // Cache with 10-byte limit.
+        let cache = MemoryCache::with_max_size(10);
+
+        // Add 5 bytes.
+        block_on(cache.put("http://a", Arc::from([1, 2, 3, 4, 5]))).unwrap();
+        assert_eq!(cache.size(), 5);
+        assert!(block_on(cache.contains("http://a")).unwrap());
+
+        // Add 5 more bytes.
+        block_on(cache.put("http://b", Arc::from([6, 7, 8, 9, 10]))).unwrap();
+        assert_eq!(cache.size(), 10);
+
+        // Add 3 more bytes, which should evict "http://a".
+        block_on(cache.put("http://c", Arc::from([11, 12, 13]))).unwrap();
+        assert_eq!(cache.size(), 8); // 5 + 3.
+        assert!(!block_on(cache.contains("http://a")).unwrap());
+        assert!(block_on(cache.contains("http://b")).unwrap());
+        assert!(block_on(cache.contains("http://c")).unwrap());
+    }
+
+    #[test]
+    fn test_memory_cache_lru_order() {
+        let cache = MemoryCache::with_max_size(10);
+        block_on(cache.put("http://a", Arc::from([1, 2, 3, 4]))).unwrap();
+        block_on(cache.put("http://b", Arc::from([5, 6, 7, 8]))).unwrap();
+
+        // Reading "a" makes "b" the least recently used, so it goes first.
+        assert!(get(&cache, "http://a").is_some());
+        block_on(cache.put("http://c", Arc::from([9, 10, 11, 12]))).unwrap();
+        assert!(block_on(cache.contains("http://a")).unwrap());
+        assert!(!block_on(cache.contains("http://b")).unwrap());
+        assert!(block_on(cache.contains("http://c")).unwrap());
+    }
+
+    #[test]
+    fn test_memory_cache_shares_data() {
+        let cache = MemoryCache::new();
+        let data: Arc<[u8]> = Arc::from([1, 2, 3]);
+        block_on(cache.put("http://a", Arc::clone(&data))).unwrap();
+
+        let hit = block_on(cache.get("http://a")).unwrap().unwrap();
+        assert_eq!(hit.as_ptr(), data.as_ptr());
+    }
+
+    #[test]
+    fn test_memory_cache_stats() {
+        let cache = MemoryCache::with_max_size(4);
+        block_on(cache.put("http://a", Arc::from([1, 2, 3]))).unwrap();
+        assert!(get(&cache, "http://a").is_some());
+        assert!(get(&cache, "http://b").is_none());
+        block_on(cache.put("http://b", Arc::from([4, 5]))).unwrap();
+
+        assert_eq!(
+            cache.stats(),
+            MemoryCacheStats {
+                hits: 1,
+                misses: 1,
+                evictions: 1,
+                entries: 1,
+                bytes: 2,
+            }
+        );
+    }
+
+    #[test]
+    fn test_memory_cache_sharded_budget() {
+        // Large enough to shard; every shard stays within its share.
+        let max_size = 4 * MIN_SHARD_BYTES;
+        let cache = MemoryCache::with_max_size(max_size);
+        assert_eq!(cache.shards.len(), 4);
+
+        let entry_size = 64 * 1024;
+        for i in 0..256 {
+            block_on(cache.put(&format!("http://tile/{i}"), vec![0; entry_size].into())).unwrap();
+        }
+        assert!(cache.size() <= max_size);
+        assert!(cache.stats().evictions > 0);
+        for shard in cache.shards.iter() {
+            assert!(shard.lock().unwrap().size <= MIN_SHARD_BYTES);
+        }
+    }
+
+    #[test]
+    fn test_memory_cache_clear() {
+        let cache = MemoryCache::new();
+
+        block_on(cache.put("http://a", Arc::from([1, 2, 3]))).unwrap();
+        block_on(cache.put("http://b", Arc::from([4, 5, 6]))).unwrap();
+        assert_eq!(cache.len(), 2);
+
+        block_on(cache.clear()).unwrap();
+        assert!(cache.is_empty());
+        assert_eq!(cache.size(), 0);
+    }
+
+    #[cfg(not(target_family = "wasm"))]
+    #[test]
+    fn test_filesystem_cache_roundtrip_and_collision_guard() {
+        use std::sync::atomic::{AtomicU64, Ordering};
+        static COUNTER: AtomicU64 = AtomicU64::new(0);
+        let dir = std::env::temp_dir().join(format!(
+            "veldera_fscache_test_{}_{}",
+            std::process::id(),
+            COUNTER.fetch_add(1, Ordering::Relaxed)
+        ));
+        let cache = FilesystemCache::new(&dir);
+
+        // Miss, store, hit.
+        assert_eq!(get(&cache, "https://x/a"), None);
+        block_on(cache.put("https://x/a", Arc::from([1, 2, 3]))).unwrap();
+        assert_eq!(get(&cache, "https://x/a"), Some(vec![1, 2, 3]));
+        assert!(block_on(cache.contains("https://x/a")).unwrap());
+
+        // A different URL that lands on the same file would be caught by the
+        // stored-URL check; directly, distinct URLs simply don't collide here.
+        block_on(cache.put("https://x/b", Arc::from([9]))).unwrap();
+        assert_eq!(get(&cache, "https://x/b"), Some(vec![9]));
+        assert_eq!(get(&cache, "https://x/a"), Some(vec![1, 2, 3]));
+
+        // Forged collision: write an entry under a's filename but b's URL, and
+        // confirm a read for a treats it as a miss rather than returning b.
+        let path = cache.path_for(fnv1a(b"https://x/a"));
+        super::write_entry(&dir, &path, "https://x/b", &[7, 7]).unwrap();
+        assert_eq!(get(&cache, "https://x/a"), None);
+
+        block_on(cache.remove("https://x/b")).unwrap();
+        assert!(!block_on(cache.contains("https://x/b")).unwrap());
+        block_on(cache.clear()).unwrap();
+        assert!(!dir.exists());
+    }
+
+    #[cfg(not(target_family = "wasm"))]
+    #[test]
+    fn test_filesystem_cache_evicts_least_recently_used() {
+        let dir =
+            std::env::temp_dir().join(format!("veldera_fscache_lru_test_{}", std::process::id()));
+        let _ = std::fs::remove_dir_all(&dir);
+        // Each entry is 40 bytes: the length prefix, an 11-byte URL, 25 of data.
+        let put = |cache: &FilesystemCache, url: &str| {
+            block_on(cache.put(url, Arc::from([0; 25]))).unwrap();
+        };
+        let cache = FilesystemCache::with_max_size(&dir, 100);
+        put(&cache, "https://x/a");
+        put(&cache, "https://x/b");
+        assert!(get(&cache, "https://x/a").is_some());
+
+        // Over the limit: b is the least recently used, and dropping it is enough.
+        put(&cache, "https://x/c");
+        assert_eq!(get(&cache, "https://x/b"), None);
+        assert!(get(&cache, "https://x/a").is_some());
+        assert!(get(&cache, "https://x/c").is_some());
+
+        // A reopened cache finds what's on disk and counts it against its limit.
+        let reopened = FilesystemCache::with_max_size(&dir, 50);
+        put(&reopened, "https://x/d");
+        assert_eq!(get(&reopened, "https://x/a"), None);
+        assert_eq!(get(&reopened, "https://x/c"), None);
+        assert!(get(&reopened, "https://x/d").is_some());
+
+        block_on(reopened.clear()).unwrap();
+    }
+
+    #[test]
+    fn test_memory_cache_update() {
+        let cache = MemoryCache::new();
+
+        // Add initial data.
+        block_on(cache.put("http://a", Arc::from([1, 2, 3]))).unwrap();
+        assert_eq!(cache.size(), 3);
+
+        // Update with larger data.
+        block_on(cache.put("http://a", Arc::from([1, 2, 3, 4, 5]))).unwrap();
+        assert_eq!(cache.size(), 5);
+        assert_eq!(cache.len(), 1);
+
+        let result = get(&cache, "http://a");
+        assert_eq!(result, Some(vec![1, 2, 3, 4, 5]));
+    }
+}
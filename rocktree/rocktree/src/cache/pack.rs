@@ -0,0 +1,1622 @@
+//! A disk cache packed into a few large, memory-mapped segment files.
+//!
+//! [`FilesystemCache`](super::FilesystemCache) stores one file per URL, which
+//! means an `open`/`read`/`close` (and a full copy) per lookup, and a
+//! directory that grows to hundreds of thousands of entries. This keeps the
+//! same contract but appends entries to size-bounded segments instead:
+//!
+//! - `NNNNNNNN.dat` holds the raw records, `[url bytes][data bytes]`.
+//! - `NNNNNNNN.idx` holds one fixed-size [`IndexEntry`] per put or removal.
+//!
+//! On open the index files are replayed in segment order into an in-memory
+//! hash table, so a lookup is a hash probe plus a slice of a mapped segment,
+//! with no copies once the segment is mapped. Overwritten and removed entries
+//! leave dead bytes behind; segments that are mostly dead are rewritten while
+//! the cache is otherwise idle.
+//!
+//! No file I/O happens on the caller or under the index lock. Lookups run on
+//! a reader thread, which is the only one to touch mapped record bytes, and
+//! writes on a writer thread, which owns the active segment's files and takes
+//! the lock only to publish what it wrote. The futures [`PackCache`] returns
+//! are woken by those threads, so any executor can await them.
+//!
+//! The writer commits in batches: records are appended and fsynced, then the
+//! index entries pointing at them are appended and fsynced, and only then do
+//! the entries become visible. Each entry carries a checksum of itself and
+//! one of its record's data; the data checksum and the stored URL are checked
+//! the first time a record is read. A crash or a bad sector therefore loses
+//! entries rather than serving a torn or wrong one.
+
+use super::{Blob, Cache, CacheFuture, ContainsFuture, GetFuture, fnv1a};
+use crate::error::{Error, Result};
+use std::{
+    collections::{BTreeMap, HashMap},
+    fs::File,
+    future::Future,
+    io::{self, Write},
+    path::{Path, PathBuf},
+    pin::Pin,
+    sync::{
+        Arc, Mutex,
+        mpsc::{self, Receiver, Sender, TryRecvError},
+    },
+    task::{Context, Poll, Waker},
+    thread::JoinHandle,
+};
+
+/// Default size at which the active segment is closed and a new one started.
+const SEGMENT_BYTES: u64 = 256 * 1024 * 1024;
+
+/// A closed segment is compacted once at least this fraction of it is dead.
+const COMPACT_DEAD_RATIO: f64 = 0.5;
+
+/// Live records a compaction step copies before the writer checks for new
+/// writes again.
+const COMPACT_STEP: usize = 64;
+
+/// Most writes committed under one pair of fsyncs.
+const MAX_BATCH: usize = 64;
+
+/// Name of the lock file that keeps two processes out of one pack directory.
+const LOCK_FILE: &str = "lock";
+
+/// Size of one serialized [`IndexEntry`].
+const ENTRY_BYTES: usize = 36;
+
+/// The kind of an index entry.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum EntryKind {
+    /// A record was appended to the segment's data file.
+    Put = 0,
+    /// The URL with this hash was removed.
+    Remove = 1,
+}
+
+/// One record in a segment's `.idx` file.
+///
+/// Layout (little endian): hash `u64`, offset `u64`, URL length `u32`, data
+/// length `u32`, kind `u32`, the low 32 bits of the FNV-1a hash of the
+/// record's data, and the low 32 bits of the FNV-1a hash of the preceding 32
+/// bytes.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct IndexEntry {
+    kind: EntryKind,
+    hash: u64,
+    offset: u64,
+    url_len: u32,
+    data_len: u32,
+    checksum: u32,
+}
+
+impl IndexEntry {
+    /// The entry recording a removal of `hash`.
+    fn removal(hash: u64) -> Self {
+        Self {
+            kind: EntryKind::Remove,
+            hash,
+            offset: 0,
+            url_len: 0,
+            data_len: 0,
+            checksum: 0,
+        }
+    }
+
+    fn encode(&self) -> [u8; ENTRY_BYTES] {
+        let mut bytes = [0; ENTRY_BYTES];
+        bytes[0..8].copy_from_slice(&self.hash.to_le_bytes());
+        bytes[8..16].copy_from_slice(&self.offset.to_le_bytes());
+        bytes[16..20].copy_from_slice(&self.url_len.to_le_bytes());
+        bytes[20..24].copy_from_slice(&self.data_len.to_le_bytes());
+        bytes[24..28].copy_from_slice(&(self.kind as u32).to_le_bytes());
+        bytes[28..32].copy_from_slice(&self.checksum.to_le_bytes());
+        let checksum = fnv1a(&bytes[..32]) as u32;
+        bytes[32..36].copy_from_slice(&checksum.to_le_bytes());
+        bytes
+    }
+
+    /// Decode an entry, or `None` if it is torn or corrupt.
+    fn decode(bytes: &[u8; ENTRY_BYTES]) -> Option<Self> {
+        let u32_at = |i: usize| u32::from_le_bytes(bytes[i..i + 4].try_into().unwrap());
+        let u64_at = |i: usize| u64::from_le_bytes(bytes[i..i + 8].try_into().unwrap());
+        if u32_at(32) != fnv1a(&bytes[..32]) as u32 {
+            return None;
+        }
+        let kind = match u32_at(24) {
+            0 => EntryKind::Put,
+            1 => EntryKind::Remove,
+            _ => return None,
+        };
+        Some(Self {
+            kind,
+            hash: u64_at(0),
+            offset: u64_at(8),
+            url_len: u32_at(16),
+            data_len: u32_at(20),
+            checksum: u32_at(28),
+        })
+    }
+
+    fn end(&self) -> u64 {
+        self.offset + u64::from(self.url_len) + u64::from(self.data_len)
+    }
+}
+
+/// Checksum of a record's data, as stored in its [`IndexEntry`].
+fn record_checksum(data: &[u8]) -> u32 {
+    fnv1a(data) as u32
+}
+
+/// Where a live entry's record is stored.
+#[derive(Debug, Clone, Copy)]
+struct Location {
+    segment: u32,
+    offset: u64,
+    url_len: u32,
+    data_len: u32,
+    checksum: u32,
+    /// Whether the record's data has been checked against `checksum` since
+    /// the cache was opened. Records written by this process start out
+    /// verified.
+    verified: bool,
+}
+
+impl Location {
+    fn len(&self) -> u64 {
+        u64::from(self.url_len) + u64::from(self.data_len)
+    }
+
+    /// Byte ranges of the stored URL and data within the segment.
+    fn ranges(&self) -> (std::ops::Range<usize>, std::ops::Range<usize>) {
+        let url_start = self.offset as usize;
+        let data_start = url_start + self.url_len as usize;
+        let data_end = data_start + self.data_len as usize;
+        (url_start..data_start, data_start..data_end)
+    }
+}
+
+/// One segment's mapping and bookkeeping.
+struct Segment {
+    /// Mapping of the data file's published bytes, replaced by the writer
+    /// after each commit to the segment. Readers keep old mappings alive
+    /// through [`Blob`]. `None` while the segment is empty.
+    map: Option<Arc<memmap2::Mmap>>,
+    /// Published bytes of the data file, live or dead.
+    len: u64,
+    /// Bytes of records still referenced by the index.
+    live: u64,
+    /// Hashes removed by this segment's index, which must outlive it if the
+    /// segment is compacted while older segments still hold the URL.
+    removed: Vec<u64>,
+}
+
+impl Segment {
+    fn dead_ratio(&self) -> f64 {
+        if self.len == 0 {
+            0.0
+        } else {
+            1.0 - self.live as f64 / self.len as f64
+        }
+    }
+}
+
+/// The published index, guarded by [`Shared::state`]. Only ever held for
+/// in-memory updates; every file operation happens outside it.
+struct PackState {
+    segments: BTreeMap<u32, Segment>,
+    entries: HashMap<u64, Location>,
+    /// The segment the writer appends to.
+    active: Option<u32>,
+    /// Total published size of all data files.
+    bytes: u64,
+}
+
+/// What the pack's threads share with each other and the cache handles.
+struct Shared {
+    dir: PathBuf,
+    max_size: Option<u64>,
+    segment_bytes: u64,
+    background_compaction: bool,
+    state: Mutex<PackState>,
+}
+
+/// A thread serving jobs from a channel, joined on drop.
+struct Worker<J> {
+    jobs: Option<Sender<J>>,
+    thread: Option<JoinHandle<()>>,
+}
+
+impl<J: Send + 'static> Worker<J> {
+    fn spawn(name: &str, run: impl FnOnce(Receiver<J>) + Send + 'static) -> io::Result<Self> {
+        let (jobs, rx) = mpsc::channel();
+        let thread = std::thread::Builder::new()
+            .name(name.into())
+            .spawn(move || run(rx))?;
+        Ok(Self {
+            jobs: Some(jobs),
+            thread: Some(thread),
+        })
+    }
+
+    /// Queue a job. A job that can't be queued is dropped, which fails its
+    /// reply.
+    fn send(&self, job: J) {
+        if let Some(jobs) = &self.jobs {
+            let _ = jobs.send(job);
+        }
+    }
+
+    /// Close the channel and wait for the thread to finish its queue.
+    fn stop(&mut self) {
+        self.jobs = None;
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+struct PackInner {
+    shared: Arc<Shared>,
+    reader: Worker<ReadJob>,
+    /// `None` for a read-only pack.
+    writer: Option<Worker<WriteJob>>,
+    /// Held for the cache's lifetime; the OS releases the lock on close. A
+    /// read-only pack takes no lock.
+    _lock: Option<File>,
+}
+
+impl Drop for PackInner {
+    fn drop(&mut self) {
+        // The reader holds a sender to the writer, so it goes first; the
+        // writer then drains its queue before the lock is released.
+        self.reader.stop();
+        if let Some(writer) = &mut self.writer {
+            writer.stop();
+        }
+    }
+}
+
+/// A job for the reader thread.
+struct ReadJob {
+    url: String,
+    reply: Replier<Option<Blob>>,
+}
+
+/// A job for the writer thread.
+enum WriteJob {
+    Put {
+        url: String,
+        data: Arc<[u8]>,
+        reply: Replier<()>,
+    },
+    Remove {
+        hash: u64,
+        reply: Replier<()>,
+    },
+    /// Forget the record at `location` if `hash` still points at it: the
+    /// reader found it corrupt.
+    Discard {
+        hash: u64,
+        location: Location,
+    },
+    Clear {
+        reply: Replier<()>,
+    },
+    /// Compact every candidate segment now, rather than while idle.
+    #[cfg(test)]
+    Compact {
+        reply: Replier<()>,
+    },
+}
+
+/// The future side of a job's reply.
+struct Reply<T> {
+    slot: Arc<Mutex<ReplySlot<T>>>,
+}
+
+struct ReplySlot<T> {
+    result: Option<Result<T>>,
+    waker: Option<Waker>,
+}
+
+/// The sending side of a job's reply. Dropped unsent — its thread died, or
+/// never got the job — it fails the reply rather than leave it pending.
+struct Replier<T> {
+    slot: Option<Arc<Mutex<ReplySlot<T>>>>,
+}
+
+fn reply<T>() -> (Replier<T>, Reply<T>) {
+    let slot = Arc::new(Mutex::new(ReplySlot {
+        result: None,
+        waker: None,
+    }));
+    (
+        Replier {
+            slot: Some(Arc::clone(&slot)),
+        },
+        Reply { slot },
+    )
+}
+
+impl<T> Replier<T> {
+    fn send(mut self, result: Result<T>) {
+        self.settle(result);
+    }
+
+    fn settle(&mut self, result: Result<T>) {
+        let Some(slot) = self.slot.take() else {
+            return;
+        };
+        let waker = {
+            let mut slot = slot.lock().unwrap();
+            slot.result = Some(result);
+            slot.waker.take()
+        };
+        if let Some(waker) = waker {
+            waker.wake();
+        }
+    }
+}
+
+impl<T> Drop for Replier<T> {
+    fn drop(&mut self) {
+        self.settle(Err(Error::Cache {
+            operation: "io",
+            message: "pack cache I/O thread stopped".into(),
+        }));
+    }
+}
+
+impl<T> Future for Reply<T> {
+    type Output = Result<T>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut slot = self.slot.lock().unwrap();
+        match slot.result.take() {
+            Some(result) => Poll::Ready(result),
+            None => {
+                slot.waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        }
+    }
+}
+
+/// A disk-backed cache storing entries in memory-mapped pack segments
+/// (native only).
+///
+/// A drop-in alternative to [`FilesystemCache`](super::FilesystemCache) for
+/// large caches: lookups return [`Blob`]s borrowing the mapped segment
+/// instead of reading and copying a file per URL. Entries are appended to
+/// data segments of up to 256 MiB, each with a small index file replayed on
+/// open.
+///
+/// Like [`FilesystemCache`](super::FilesystemCache) there is no TTL. Reads
+/// and writes run on two threads of the cache's own, so its futures never
+/// block the executor polling them. An optional size limit evicts whole
+/// segments, oldest first. Only one process may use a pack directory at a
+/// time; [`open`] fails if another holds it.
+///
+/// [`open`]: PackCache::open
+#[derive(Clone)]
+pub struct PackCache {
+    inner: Arc<PackInner>,
+}
+
+impl PackCache {
+    /// Size limit of the shared [`veldera`](Self::veldera) pack: a few
+    /// continents of flights at street level.
+    pub const VELDERA_MAX_SIZE: u64 = 8 << 30;
+
+    /// Open (or create) a pack cache in `dir` with no size limit.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the directory cannot be created or read, if
+    /// another process has it open, or if its threads cannot be started.
+    pub fn open(dir: impl Into<PathBuf>) -> Result<Self> {
+        Self::open_with(dir.into(), None, SEGMENT_BYTES, true)
+    }
+
+    /// Open (or create) a pack cache in `dir` that keeps its total size
+    /// around `max_size` bytes by evicting the oldest segments.
+    ///
+    /// # Errors
+    ///
+    /// See [`PackCache::open`].
+    pub fn with_max_size(dir: impl Into<PathBuf>, max_size: u64) -> Result<Self> {
+        Self::open_with(dir.into(), Some(max_size), SEGMENT_BYTES, true)
+    }
+
+    /// Open a pack cache under the shared project cache root,
+    /// `<OS cache dir>/veldera/rocktree-pack`, limited to
+    /// [`VELDERA_MAX_SIZE`](Self::VELDERA_MAX_SIZE). Returns `None` when the
+    /// OS cache directory cannot be resolved.
+    ///
+    /// Leaves the one-file-per-URL cache that used to live beside it, in
+    /// `veldera/rocktree`, alone; see
+    /// [`remove_legacy_veldera_cache`](Self::remove_legacy_veldera_cache).
+    ///
+    /// # Errors
+    ///
+    /// See [`PackCache::open`].
+    pub fn veldera() -> Option<Result<Self>> {
+        let root = dirs::cache_dir()?.join("veldera");
+        Some(Self::with_max_size(
+            root.join("rocktree-pack"),
+            Self::VELDERA_MAX_SIZE,
+        ))
+    }
+
+    /// Delete the one-file-per-URL tile cache the [`veldera`](Self::veldera)
+    /// pack replaced, `<OS cache dir>/veldera/rocktree`, in the background
+    /// (it may hold hundreds of thousands of files). A migration for the app
+    /// to run once it holds the pack: an older build may still be using the
+    /// directory, so nothing here does it implicitly. Returns whether there
+    /// was a directory to delete.
+    pub fn remove_legacy_veldera_cache() -> bool {
+        let Some(dir) = dirs::cache_dir().map(|dir| dir.join("veldera").join("rocktree")) else {
+            return false;
+        };
+        if !dir.is_dir() {
+            return false;
+        }
+        tracing::info!("Removing superseded tile cache {}", dir.display());
+        let spawned = std::thread::Builder::new()
+            .name("rocktree-cache-cleanup".into())
+            .spawn(move || match std::fs::remove_dir_all(&dir) {
+                Ok(()) => tracing::info!("Removed superseded tile cache {}", dir.display()),
+                Err(e) => tracing::warn!("Failed to remove old tile cache {}: {e}", dir.display()),
+            });
+        if let Err(e) = spawned {
+            tracing::warn!("Failed to start tile cache cleanup: {e}");
+        }
+        true
+    }
+
+    /// Open the pack cache in `dir` for lookups only, leaving every file in
+    /// it untouched: nothing is locked, truncated, discarded, or compacted,
+    /// and puts, removals, and clears fail. For pinned snapshots, such as
+    /// benchmark fixtures; nothing may write to `dir` while it is open.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the directory cannot be read, or if its reader
+    /// thread cannot be started.
+    pub fn open_read_only(dir: impl Into<PathBuf>) -> Result<Self> {
+        let dir = dir.into();
+        let (state, _, _) = replay(&dir, true).map_err(|e| cache_error("open", &e))?;
+        let shared = Arc::new(Shared {
+            dir,
+            max_size: None,
+            segment_bytes: SEGMENT_BYTES,
+            background_compaction: false,
+            state: Mutex::new(state),
+        });
+        let reader = {
+            let shared = Arc::clone(&shared);
+            Worker::spawn("rocktree-pack-read", move |jobs| {
+                read_loop(&shared, &jobs, None);
+            })
+            .map_err(|e| cache_error("spawn", &e))?
+        };
+        Ok(Self {
+            inner: Arc::new(PackInner {
+                shared,
+                reader,
+                writer: None,
+                _lock: None,
+            }),
+        })
+    }
+
+    fn open_with(
+        dir: PathBuf,
+        max_size: Option<u64>,
+        segment_bytes: u64,
+        background_compaction: bool,
+    ) -> Result<Self> {
+        std::fs::create_dir_all(&dir).map_err(|e| cache_error("create dir", &e))?;
+        let lock = File::create(dir.join(LOCK_FILE)).map_err(|e| cache_error("lock", &e))?;
+        lock.try_lock().map_err(|e| Error::Cache {
+            operation: "lock",
+            message: format!("{}: {e}", dir.display()),
+        })?;
+
+        let (state, active, next_segment) =
+            replay(&dir, false).map_err(|e| cache_error("open", &e))?;
+        let shared = Arc::new(Shared {
+            dir,
+            max_size,
+            segment_bytes,
+            background_compaction,
+            state: Mutex::new(state),
+        });
+        let mut writer = Writer {
+            shared: Arc::clone(&shared),
+            active,
+            next_segment,
+            batch: Batch::default(),
+            compaction_paused: false,
+        };
+        let writer = Worker::spawn("rocktree-pack-write", move |jobs| writer.run(&jobs))
+            .map_err(|e| cache_error("spawn", &e))?;
+        let reader = {
+            let shared = Arc::clone(&shared);
+            let discards = writer.jobs.clone().expect("writer was just spawned");
+            Worker::spawn("rocktree-pack-read", move |jobs| {
+                read_loop(&shared, &jobs, Some(&discards));
+            })
+            .map_err(|e| cache_error("spawn", &e))?
+        };
+        Ok(Self {
+            inner: Arc::new(PackInner {
+                shared,
+                reader,
+                writer: Some(writer),
+                _lock: Some(lock),
+            }),
+        })
+    }
+
+    /// Number of live entries.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.inner.shared.state.lock().unwrap().entries.len()
+    }
+
+    /// Whether the cache holds no entries.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Total size of the segment files on disk, including dead bytes.
+    #[must_use]
+    pub fn disk_size(&self) -> u64 {
+        self.inner.shared.state.lock().unwrap().bytes
+    }
+
+    fn lookup(&self, url: &str) -> Reply<Option<Blob>> {
+        let (replier, reply) = reply();
+        self.inner.reader.send(ReadJob {
+            url: url.to_owned(),
+            reply: replier,
+        });
+        reply
+    }
+
+    fn write(&self, job: impl FnOnce(Replier<()>) -> WriteJob) -> Reply<()> {
+        let (replier, reply) = reply();
+        match &self.inner.writer {
+            Some(writer) => writer.send(job(replier)),
+            None => replier.send(Err(Error::Cache {
+                operation: "write",
+                message: format!("{} is open read-only", self.inner.shared.dir.display()),
+            })),
+        }
+        reply
+    }
+
+    /// Compact every mostly-dead segment before replying.
+    #[cfg(test)]
+    fn compact(&self) -> Reply<()> {
+        self.write(|reply| WriteJob::Compact { reply })
+    }
+}
+
+impl std::fmt::Debug for PackCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("PackCache")
+            .field("dir", &self.inner.shared.dir)
+            .field("max_size", &self.inner.shared.max_size)
+            .finish_non_exhaustive()
+    }
+}
+
+impl Cache for PackCache {
+    fn get(&self, url: &str) -> GetFuture<'_> {
+        Box::pin(self.lookup(url))
+    }
+
+    fn put(&self, url: &str, data: Arc<[u8]>) -> CacheFuture<'_> {
+        let url = url.to_owned();
+        Box::pin(self.write(|reply| WriteJob::Put { url, data, reply }))
+    }
+
+    fn contains(&self, url: &str) -> ContainsFuture<'_> {
+        let lookup = self.lookup(url);
+        Box::pin(async move { lookup.await.map(|data| data.is_some()) })
+    }
+
+    fn remove(&self, url: &str) -> CacheFuture<'_> {
+        let hash = fnv1a(url.as_bytes());
+        Box::pin(self.write(|reply| WriteJob::Remove { hash, reply }))
+    }
+
+    fn clear(&self) -> CacheFuture<'_> {
+        Box::pin(self.write(|reply| WriteJob::Clear { reply }))
+    }
+}
+
+/// Serve lookups until the cache is dropped.
+fn read_loop(shared: &Shared, jobs: &Receiver<ReadJob>, discards: Option<&Sender<WriteJob>>) {
+    for ReadJob { url, reply } in jobs {
+        reply.send(Ok(read(shared, &url, discards)));
+    }
+}
+
+/// Look `url` up, verifying its record the first time it is read. Corrupt
+/// records are reported to the writer through `discards`, if there is one.
+fn read(shared: &Shared, url: &str, discards: Option<&Sender<WriteJob>>) -> Option<Blob> {
+    let hash = fnv1a(url.as_bytes());
+    let (location, map) = {
+        let state = shared.state.lock().unwrap();
+        let location = state.entries.get(&hash).copied()?;
+        let map = state.segments[&location.segment]
+            .map
+            .clone()
+            .expect("published records are mapped");
+        (location, map)
+    };
+
+    let (url_range, data_range) = location.ranges();
+    if &map[url_range] != url.as_bytes() {
+        // Hash collision with a different URL.
+        return None;
+    }
+    if !location.verified {
+        if record_checksum(&map[data_range.clone()]) != location.checksum {
+            tracing::warn!("Pack cache record for {url} is corrupt; dropping it");
+            if let Some(discards) = discards {
+                let _ = discards.send(WriteJob::Discard { hash, location });
+            }
+            return None;
+        }
+        let mut state = shared.state.lock().unwrap();
+        if let Some(current) = state.entries.get_mut(&hash)
+            && current.segment == location.segment
+            && current.offset == location.offset
+        {
+            current.verified = true;
+        }
+    }
+    Some(Blob::mapped(map, data_range))
+}
+
+/// The segment the writer appends to.
+struct ActiveSegment {
+    id: u32,
+    data: File,
+    index: File,
+    /// Bytes written to the data file, committed or not.
+    len: u64,
+}
+
+/// A change to the published index, applied once its batch is durable.
+enum Update {
+    Put(u64, Location),
+    Remove {
+        hash: u64,
+        segment: u32,
+    },
+    /// Drop `hash` from the index without recording it (its record is
+    /// corrupt, and its segment is leaving anyway or will fail the check
+    /// again after a reopen).
+    Forget(u64),
+}
+
+/// Writes staged since the last commit.
+#[derive(Default)]
+struct Batch {
+    /// Serialized index entries for the active segment.
+    index: Vec<u8>,
+    updates: Vec<Update>,
+    replies: Vec<Replier<()>>,
+}
+
+/// The writer thread's state: the only owner of the active segment's files.
+struct Writer {
+    shared: Arc<Shared>,
+    active: Option<ActiveSegment>,
+    next_segment: u32,
+    batch: Batch,
+    /// Set when idle compaction fails, so a persistent error (a full disk,
+    /// say) doesn't spin; the next write retries it.
+    compaction_paused: bool,
+}
+
+impl Writer {
+    /// Serve writes until the cache is dropped, compacting while idle.
+    fn run(&mut self, jobs: &Receiver<WriteJob>) {
+        loop {
+            let job = if self.idle_compaction() {
+                match jobs.try_recv() {
+                    Ok(job) => job,
+                    Err(TryRecvError::Empty) => {
+                        if let Err(e) = self.compact_step() {
+                            tracing::warn!("Pack cache compaction failed: {e}");
+                            self.compaction_paused = true;
+                        }
+                        self.commit();
+                        continue;
+                    }
+                    Err(TryRecvError::Disconnected) => break,
+                }
+            } else {
+                match jobs.recv() {
+                    Ok(job) => job,
+                    Err(_) => break,
+                }
+            };
+            self.apply(job);
+            for job in jobs.try_iter().take(MAX_BATCH - 1) {
+                self.apply(job);
+            }
+            self.commit();
+        }
+    }
+
+    fn apply(&mut self, job: WriteJob) {
+        self.compaction_paused = false;
+        match job {
+            WriteJob::Put { url, data, reply } => match self.stage_put(url.as_bytes(), &data) {
+                Ok(()) => self.batch.replies.push(reply),
+                Err(e) => reply.send(Err(cache_error("write", &e))),
+            },
+            WriteJob::Remove { hash, reply } => {
+                if !self.is_live(hash) {
+                    reply.send(Ok(()));
+                    return;
+                }
+                match self.stage_removal(hash) {
+                    Ok(()) => self.batch.replies.push(reply),
+                    Err(e) => reply.send(Err(cache_error("remove", &e))),
+                }
+            }
+            WriteJob::Discard { hash, location } => {
+                let current = self
+                    .shared
+                    .state
+                    .lock()
+                    .unwrap()
+                    .entries
+                    .get(&hash)
+                    .copied();
+                if current.is_some_and(|current| {
+                    current.segment == location.segment && current.offset == location.offset
+                }) && let Err(e) = self.stage_removal(hash)
+                {
+                    tracing::warn!("Failed to drop corrupt pack cache record: {e}");
+                }
+            }
+            WriteJob::Clear { reply } => {
+                self.commit();
+                self.clear();
+                reply.send(Ok(()));
+            }
+            #[cfg(test)]
+            WriteJob::Compact { reply } => {
+                self.commit();
+                let mut result = Ok(());
+                while result.is_ok() && compaction_candidate(&self.shared.state()).is_some() {
+                    result = self.compact_step();
+                    self.commit();
+                }
+                reply.send(result.map_err(|e| cache_error("compact", &e)));
+            }
+        }
+    }
+
+    /// Whether `hash` has a live entry, counting staged writes.
+    fn is_live(&self, hash: u64) -> bool {
+        let staged = self
+            .batch
+            .updates
+            .iter()
+            .rev()
+            .find_map(|update| match update {
+                Update::Put(h, _) => (*h == hash).then_some(true),
+                Update::Remove { hash: h, .. } | Update::Forget(h) => (*h == hash).then_some(false),
+            });
+        staged.unwrap_or_else(|| self.shared.state().entries.contains_key(&hash))
+    }
+
+    /// The active segment with room for a record of `len` bytes, committing
+    /// and rolling over to a new segment if the current one would grow past
+    /// the segment size.
+    fn active_for(&mut self, len: u64) -> io::Result<&mut ActiveSegment> {
+        let full = self
+            .active
+            .as_ref()
+            .is_none_or(|active| active.len > 0 && active.len + len > self.shared.segment_bytes);
+        if full {
+            // Staged entries belong in the old segment's index.
+            self.commit();
+            let id = self.next_segment;
+            let open = |extension| {
+                File::options()
+                    .create(true)
+                    .append(true)
+                    .read(true)
+                    .open(segment_path(&self.shared.dir, id, extension))
+            };
+            let data = open("dat")?;
+            let index = open("idx")?;
+            {
+                let mut state = self.shared.state();
+                state.segments.insert(
+                    id,
+                    Segment {
+                        map: None,
+                        len: 0,
+                        live: 0,
+                        removed: Vec::new(),
+                    },
+                );
+                state.active = Some(id);
+            }
+            self.next_segment += 1;
+            self.active = Some(ActiveSegment {
+                id,
+                data,
+                index,
+                len: 0,
+            });
+        }
+        Ok(self.active.as_mut().expect("segment was just opened"))
+    }
+
+    /// Append a record for `url` to the active segment, to be indexed on
+    /// the next commit.
+    fn stage_put(&mut self, url: &[u8], data: &[u8]) -> io::Result<()> {
+        let (Ok(url_len), Ok(data_len)) = (u32::try_from(url.len()), u32::try_from(data.len()))
+        else {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "entry too large for pack cache",
+            ));
+        };
+        let len = u64::from(url_len) + u64::from(data_len);
+        let active = self.active_for(len)?;
+        let offset = active.len;
+        let written = active
+            .data
+            .write_all(url)
+            .and_then(|()| active.data.write_all(data));
+        if let Err(e) = written {
+            self.retire_active();
+            return Err(e);
+        }
+        active.len += len;
+        let segment = active.id;
+
+        let entry = IndexEntry {
+            kind: EntryKind::Put,
+            hash: fnv1a(url),
+            offset,
+            url_len,
+            data_len,
+            checksum: record_checksum(data),
+        };
+        self.batch.index.extend_from_slice(&entry.encode());
+        self.batch.updates.push(Update::Put(
+            entry.hash,
+            Location {
+                segment,
+                offset,
+                url_len,
+                data_len,
+                checksum: entry.checksum,
+                verified: true,
+            },
+        ));
+        Ok(())
+    }
+
+    /// Record a removal of `hash` in the active segment's index, live or
+    /// not, to be applied on the next commit.
+    fn stage_removal(&mut self, hash: u64) -> io::Result<()> {
+        let segment = self.active_for(0)?.id;
+        self.batch
+            .index
+            .extend_from_slice(&IndexEntry::removal(hash).encode());
+        self.batch.updates.push(Update::Remove { hash, segment });
+        Ok(())
+    }
+
+    /// Stop appending to the active segment after a failed write, whose
+    /// partial bytes would otherwise shift every later record. Staged
+    /// writes before it are committed first.
+    fn retire_active(&mut self) {
+        self.commit();
+        self.active = None;
+    }
+
+    /// Make the staged writes durable, then publish them and reply.
+    ///
+    /// Records are fsynced before the index entries pointing at them are
+    /// written, so a durable entry never points at bytes that may be lost.
+    fn commit(&mut self) {
+        let batch = std::mem::take(&mut self.batch);
+        if batch.updates.is_empty() {
+            return;
+        }
+        let synced = match &mut self.active {
+            Some(active) => sync(active, &batch.index),
+            // Only forgotten records, which need nothing written.
+            None if batch.index.is_empty() => Ok(None),
+            None => Err(io::Error::other("no active segment")),
+        };
+        let map = match synced {
+            Ok(map) => map,
+            Err(e) => {
+                // The entries may be torn now; start afresh in a new segment.
+                self.active = None;
+                for reply in batch.replies {
+                    reply.send(Err(cache_error("write", &e)));
+                }
+                return;
+            }
+        };
+
+        let evicted = {
+            let mut guard = self.shared.state();
+            let state = &mut *guard;
+            if let Some(active) = &self.active
+                && let Some(segment) = state.segments.get_mut(&active.id)
+            {
+                state.bytes += active.len - segment.len;
+                segment.len = active.len;
+                if map.is_some() {
+                    segment.map = map;
+                }
+            }
+            for update in batch.updates {
+                match update {
+                    Update::Put(hash, location) => state.relocate(hash, Some(location)),
+                    Update::Remove { hash, segment } => {
+                        state.relocate(hash, None);
+                        if let Some(segment) = state.segments.get_mut(&segment) {
+                            segment.removed.push(hash);
+                        }
+                    }
+                    Update::Forget(hash) => state.relocate(hash, None),
+                }
+            }
+            state.evict(self.shared.max_size)
+        };
+        for id in evicted {
+            delete_segment_files(&self.shared.dir, id);
+        }
+        for reply in batch.replies {
+            reply.send(Ok(()));
+        }
+    }
+
+    /// Drop every segment.
+    fn clear(&mut self) {
+        self.active = None;
+        let ids: Vec<u32> = {
+            let mut state = self.shared.state();
+            state.entries.clear();
+            state.active = None;
+            state.bytes = 0;
+            std::mem::take(&mut state.segments).into_keys().collect()
+        };
+        for id in ids {
+            delete_segment_files(&self.shared.dir, id);
+        }
+    }
+
+    /// Whether the writer should compact instead of waiting for writes.
+    fn idle_compaction(&self) -> bool {
+        self.shared.background_compaction
+            && !self.compaction_paused
+            && compaction_candidate(&self.shared.state()).is_some()
+    }
+
+    /// Copy up to [`COMPACT_STEP`] live records out of the most-dead closed
+    /// segment into the active one, dropping the segment once none are
+    /// left. The caller commits.
+    fn compact_step(&mut self) -> io::Result<()> {
+        let (id, records, map) = {
+            let state = self.shared.state();
+            let Some(id) = compaction_candidate(&state) else {
+                return Ok(());
+            };
+            let records: Vec<(u64, Location)> = state
+                .entries
+                .iter()
+                .filter(|(_, location)| location.segment == id)
+                .take(COMPACT_STEP)
+                .map(|(&hash, &location)| (hash, location))
+                .collect();
+            (id, records, state.segments[&id].map.clone())
+        };
+
+        if records.is_empty() {
+            return self.drop_compacted(id);
+        }
+        let map = map.expect("a segment with live records is mapped");
+        for (hash, location) in records {
+            let (url, data) = location.ranges();
+            let (url, data) = (&map[url], &map[data]);
+            if fnv1a(url) != hash
+                || (!location.verified && record_checksum(data) != location.checksum)
+            {
+                // The record no longer matches its entry (it was torn by a
+                // crash, or the disk went bad); drop it rather than carry it
+                // forward.
+                self.batch.updates.push(Update::Forget(hash));
+                continue;
+            }
+            self.stage_put(url, data)?;
+        }
+        Ok(())
+    }
+
+    /// Drop a compacted segment, carrying forward removals that still
+    /// shadow an entry in an older segment so it isn't resurrected on
+    /// reopen.
+    fn drop_compacted(&mut self, id: u32) -> io::Result<()> {
+        let (removed, has_older) = {
+            let mut state = self.shared.state();
+            let removed = state
+                .segments
+                .get_mut(&id)
+                .map(|segment| std::mem::take(&mut segment.removed))
+                .unwrap_or_default();
+            let has_older = state
+                .segments
+                .keys()
+                .next()
+                .is_some_and(|&first| first < id);
+            (removed, has_older)
+        };
+        if has_older {
+            for hash in removed {
+                if !self.is_live(hash) {
+                    self.stage_removal(hash)?;
+                }
+            }
+            // The carried removals must be durable before the segment goes.
+            self.commit();
+        }
+        self.shared.state().forget_segment(id);
+        delete_segment_files(&self.shared.dir, id);
+        Ok(())
+    }
+}
+
+/// Fsync a segment's new records, append and fsync their index entries, and
+/// map the data file's new length.
+fn sync(active: &mut ActiveSegment, index: &[u8]) -> io::Result<Option<Arc<memmap2::Mmap>>> {
+    active.data.sync_data()?;
+    active.index.write_all(index)?;
+    active.index.sync_data()?;
+    if active.len == 0 {
+        return Ok(None);
+    }
+    map_segment(&active.data).map(Some)
+}
+
+fn map_segment(file: &File) -> io::Result<Arc<memmap2::Mmap>> {
+    // SAFETY: segment files are only ever appended to, and only by the
+    // process holding the pack directory's lock, so the mapped bytes are
+    // never modified while mapped. Dropped segments are unlinked rather
+    // than truncated, which leaves existing mappings valid.
+    #[allow(unsafe_code)]
+    let map = unsafe { memmap2::Mmap::map(file)? };
+    Ok(Arc::new(map))
+}
+
+impl Shared {
+    fn state(&self) -> std::sync::MutexGuard<'_, PackState> {
+        self.state.lock().unwrap()
+    }
+}
+
+impl PackState {
+    /// Point `hash` at `location` (or nowhere), keeping the per-segment live
+    /// byte counts in step.
+    fn relocate(&mut self, hash: u64, location: Option<Location>) {
+        let old = match location {
+            Some(location) => {
+                if let Some(segment) = self.segments.get_mut(&location.segment) {
+                    segment.live += location.len();
+                }
+                self.entries.insert(hash, location)
+            }
+            None => self.entries.remove(&hash),
+        };
+        if let Some(old) = old
+            && let Some(segment) = self.segments.get_mut(&old.segment)
+        {
+            segment.live -= old.len();
+        }
+    }
+
+    /// Forget the oldest closed segments until the pack fits its size limit,
+    /// returning them for their files to be deleted.
+    fn evict(&mut self, max_size: Option<u64>) -> Vec<u32> {
+        let Some(max_size) = max_size else {
+            return Vec::new();
+        };
+        let mut evicted = Vec::new();
+        while self.bytes > max_size {
+            let Some(&oldest) = self.segments.keys().next() else {
+                break;
+            };
+            if Some(oldest) == self.active {
+                break;
+            }
+            self.entries
+                .retain(|_, location| location.segment != oldest);
+            self.forget_segment(oldest);
+            evicted.push(oldest);
+        }
+        evicted
+    }
+
+    /// Forget a segment, leaving its files to [`delete_segment_files`].
+    fn forget_segment(&mut self, id: u32) {
+        if let Some(segment) = self.segments.remove(&id) {
+            self.bytes -= segment.len;
+        }
+        if self.active == Some(id) {
+            self.active = None;
+        }
+    }
+}
+
+/// Delete a forgotten segment's files.
+///
+/// The index is truncated before the files are removed, so a segment whose
+/// data file outlives it (still mapped on Windows, say) replays as empty and
+/// is cleaned up on the next open.
+fn delete_segment_files(dir: &Path, id: u32) {
+    let index = segment_path(dir, id, "idx");
+    match File::options().write(true).open(&index) {
+        Ok(file) => {
+            if let Err(e) = file.set_len(0) {
+                tracing::warn!("Failed to truncate pack segment {id}: {e}");
+            }
+        }
+        Err(e) if e.kind() == io::ErrorKind::NotFound => {}
+        Err(e) => tracing::warn!("Failed to open pack segment {id} for deletion: {e}"),
+    }
+    let _ = std::fs::remove_file(segment_path(dir, id, "dat"));
+    let _ = std::fs::remove_file(index);
+}
+
+/// The most-dead closed segment past the compaction threshold, if any.
+fn compaction_candidate(state: &PackState) -> Option<u32> {
+    state
+        .segments
+        .iter()
+        .filter(|&(&id, segment)| {
+            Some(id) != state.active && segment.dead_ratio() >= COMPACT_DEAD_RATIO
+        })
+        .max_by(|(_, a), (_, b)| a.dead_ratio().total_cmp(&b.dead_ratio()))
+        .map(|(&id, _)| id)
+}
+
+/// Rebuild the pack state from the segment files in `dir`, along with the
+/// segment to resume appending to and the next segment id.
+///
+/// Each segment's index is replayed up to its first torn or out-of-range
+/// entry. The newest segment becomes the active one again, with any torn
+/// tail truncated away; segments left with nothing live are deleted.
+///
+/// With `read_only`, no file is created, truncated, or deleted: torn tails
+/// are only skipped, and there is no active segment.
+fn replay(dir: &Path, read_only: bool) -> io::Result<(PackState, Option<ActiveSegment>, u32)> {
+    let mut ids: Vec<u32> = std::fs::read_dir(dir)?
+        .filter_map(|entry| {
+            let name = entry.ok()?.file_name();
+            let (stem, extension) = name.to_str()?.split_once('.')?;
+            matches!(extension, "dat" | "idx")
+                .then(|| stem.parse().ok())
+                .flatten()
+        })
+        .collect();
+    ids.sort_unstable();
+    ids.dedup();
+
+    let mut state = PackState {
+        segments: BTreeMap::new(),
+        entries: HashMap::new(),
+        active: None,
+        bytes: 0,
+    };
+    let mut active = None;
+
+    let newest = ids.last().copied();
+    for &id in &ids {
+        let data_path = segment_path(dir, id, "dat");
+        let index_path = segment_path(dir, id, "idx");
+        let file = if read_only {
+            match File::open(&data_path) {
+                Ok(file) => Some(file),
+                // An index without data can still hold removals.
+                Err(e) if e.kind() == io::ErrorKind::NotFound => None,
+                Err(e) => return Err(e),
+            }
+        } else {
+            let file = File::options()
+                .create(true)
+                .append(true)
+                .read(true)
+                .open(&data_path)?;
+            Some(file)
+        };
+        let mut len = match &file {
+            Some(file) => file.metadata()?.len(),
+            None => 0,
+        };
+        let index = match std::fs::read(&index_path) {
+            Ok(index) => index,
+            Err(e) if e.kind() == io::ErrorKind::NotFound => Vec::new(),
+            Err(e) => return Err(e),
+        };
+
+        state.segments.insert(
+            id,
+            Segment {
+                map: None,
+                len,
+                live: 0,
+                removed: Vec::new(),
+            },
+        );
+
+        let mut valid = 0;
+        let mut records_end = 0;
+        for chunk in index.chunks_exact(ENTRY_BYTES) {
+            let Some(entry) = IndexEntry::decode(chunk.try_into().unwrap()) else {
+                break;
+            };
+            match entry.kind {
+                EntryKind::Put => {
+                    if entry.end() > len {
+                        break;
+                    }
+                    records_end = records_end.max(entry.end());
+                    state.relocate(
+                        entry.hash,
+                        Some(Location {
+                            segment: id,
+                            offset: entry.offset,
+                            url_len: entry.url_len,
+                            data_len: entry.data_len,
+                            checksum: entry.checksum,
+                            verified: false,
+                        }),
+                    );
+                }
+                EntryKind::Remove => {
+                    state.relocate(entry.hash, None);
+                    let segment = state.segments.get_mut(&id).expect("segment just inserted");
+                    segment.removed.push(entry.hash);
+                }
+            }
+            valid += ENTRY_BYTES;
+        }
+
+        if Some(id) == newest
+            && !read_only
+            && let Some(file) = &file
+        {
+            // Resume appending right after the last indexed record.
+            let index = File::options()
+                .create(true)
+                .append(true)
+                .open(&index_path)?;
+            index.set_len(valid as u64)?;
+            file.set_len(records_end)?;
+            len = records_end;
+            state.active = Some(id);
+            active = Some(ActiveSegment {
+                id,
+                data: file.try_clone()?,
+                index,
+                len,
+            });
+        }
+
+        let segment = state.segments.get_mut(&id).expect("segment just inserted");
+        segment.len = len;
+        if len > 0
+            && let Some(file) = &file
+        {
+            segment.map = Some(map_segment(file)?);
+        }
+        state.bytes += len;
+    }
+
+    // Segments fully superseded by later ones hold nothing worth keeping.
+    let empty: Vec<u32> = state
+        .segments
+        .iter()
+        .filter(|&(&id, segment)| {
+            Some(id) != newest && segment.live == 0 && segment.removed.is_empty()
+        })
+        .map(|(&id, _)| id)
+        .collect();
+    for id in empty {
+        state.forget_segment(id);
+        if !read_only {
+            delete_segment_files(dir, id);
+        }
+    }
+    Ok((state, active, newest.map_or(0, |id| id + 1)))
+}
+
+fn segment_path(dir: &Path, id: u32, extension: &str) -> PathBuf {
+    dir.join(format!("{id:08}.{extension}"))
+}
+
+fn cache_error(operation: &'static str, e: &io::Error) -> Error {
+    Error::Cache {
+        operation,
+        message: e.to_string(),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{super::tests::block_on, *};
+
+    /// A fresh, unique directory under the system temp dir.
+    fn temp_dir(name: &str) -> PathBuf {
+        let dir =
+            std::env::temp_dir().join(format!("rocktree-pack-test-{name}-{}", std::process::id()));
+        let _ = std::fs::remove_dir_all(&dir);
+        dir
+    }
+
+    /// A pack with small segments and synchronous compaction.
+    fn open_small(dir: &Path, max_size: Option<u64>) -> PackCache {
+        PackCache::open_with(dir.to_path_buf(), max_size, 64, false).unwrap()
+    }
+
+    fn get(cache: &PackCache, url: &str) -> Option<Vec<u8>> {
+        block_on(cache.get(url))
+            .unwrap()
+            .as_deref()
+            .map(<[u8]>::to_vec)
+    }
+
+    fn put(cache: &PackCache, url: &str, data: &[u8]) {
+        block_on(cache.put(url, Arc::from(data))).unwrap();
+    }
+
+    #[test]
+    fn test_index_entry_round_trip() {
+        let entry = IndexEntry {
+            kind: EntryKind::Put,
+            hash: 0x0123_4567_89ab_cdef,
+            offset: 1 << 40,
+            url_len: 17,
+            data_len: 123_456,
+            checksum: 0x89ab_cdef,
+        };
+        let mut bytes = entry.encode();
+        assert_eq!(IndexEntry::decode(&bytes), Some(entry));
+        bytes[9] ^= 1;
+        assert_eq!(IndexEntry::decode(&bytes), None);
+    }
+
+    #[test]
+    fn test_pack_cache_round_trip_and_reopen() {
+        let dir = temp_dir("reopen");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1, 2, 3]);
+            put(&cache, "http://b", &[4, 5]);
+            put(&cache, "http://a", &[6]);
+            assert_eq!(get(&cache, "http://a"), Some(vec![6]));
+            assert_eq!(get(&cache, "http://b"), Some(vec![4, 5]));
+            assert_eq!(get(&cache, "http://c"), None);
+        }
+        let cache = open_small(&dir, None);
+        assert_eq!(cache.len(), 2);
+        assert_eq!(get(&cache, "http://a"), Some(vec![6]));
+        assert_eq!(get(&cache, "http://b"), Some(vec![4, 5]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_is_exclusive() {
+        let dir = temp_dir("exclusive");
+        let cache = open_small(&dir, None);
+        assert!(PackCache::open(&dir).is_err());
+        drop(cache);
+        assert!(PackCache::open(&dir).is_ok());
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_remove_persists() {
+        let dir = temp_dir("remove");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1; 40]);
+            // Roll over so the removal lands in a later segment.
+            put(&cache, "http://b", &[2; 40]);
+            block_on(cache.remove("http://a")).unwrap();
+            assert!(!block_on(cache.contains("http://a")).unwrap());
+        }
+        let cache = open_small(&dir, None);
+        assert_eq!(get(&cache, "http://a"), None);
+        assert_eq!(get(&cache, "http://b"), Some(vec![2; 40]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_compaction() {
+        let dir = temp_dir("compact");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1; 40]);
+            put(&cache, "http://b", &[2; 8]);
+            put(&cache, "http://c", &[3; 40]);
+            // Overwriting `a` leaves the first segment mostly dead.
+            put(&cache, "http://a", &[4; 40]);
+            let held = block_on(cache.get("http://b")).unwrap().unwrap();
+            let before = cache.disk_size();
+
+            block_on(cache.compact()).unwrap();
+            assert!(cache.disk_size() < before);
+            assert_eq!(get(&cache, "http://a"), Some(vec![4; 40]));
+            assert_eq!(get(&cache, "http://b"), Some(vec![2; 8]));
+            // Blobs taken before compaction stay readable.
+            assert_eq!(&held[..], &[2; 8]);
+        }
+        let cache = open_small(&dir, None);
+        assert_eq!(cache.len(), 3);
+        assert_eq!(get(&cache, "http://b"), Some(vec![2; 8]));
+        assert_eq!(get(&cache, "http://c"), Some(vec![3; 40]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_evicts_oldest_segments() {
+        let dir = temp_dir("evict");
+        let cache = open_small(&dir, Some(100));
+        for i in 0..5 {
+            put(&cache, &format!("http://{i}"), &[i; 50]);
+        }
+        assert!(cache.disk_size() <= 100);
+        assert_eq!(get(&cache, "http://0"), None);
+        assert_eq!(get(&cache, "http://4"), Some(vec![4; 50]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_ignores_torn_tail() {
+        let dir = temp_dir("torn");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1, 2, 3]);
+            put(&cache, "http://b", &[4, 5, 6]);
+        }
+        // Tear the last index entry, as a crash mid-write might.
+        let index = segment_path(&dir, 0, "idx");
+        let len = std::fs::metadata(&index).unwrap().len();
+        File::options()
+            .write(true)
+            .open(&index)
+            .unwrap()
+            .set_len(len - 5)
+            .unwrap();
+
+        let cache = open_small(&dir, None);
+        assert_eq!(get(&cache, "http://a"), Some(vec![1, 2, 3]));
+        assert_eq!(get(&cache, "http://b"), None);
+        put(&cache, "http://c", &[7]);
+        drop(cache);
+
+        let cache = open_small(&dir, None);
+        assert_eq!(get(&cache, "http://a"), Some(vec![1, 2, 3]));
+        assert_eq!(get(&cache, "http://c"), Some(vec![7]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    /// Every file in `dir` and its contents.
+    fn snapshot(dir: &Path) -> BTreeMap<PathBuf, Vec<u8>> {
+        std::fs::read_dir(dir)
+            .unwrap()
+            .map(|entry| {
+                let path = entry.unwrap().path();
+                let bytes = std::fs::read(&path).unwrap();
+                (path, bytes)
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_pack_cache_read_only_leaves_files_untouched() {
+        let dir = temp_dir("read-only");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1; 40]);
+            put(&cache, "http://b", &[2; 40]);
+            // Leaves the first segment entirely dead.
+            put(&cache, "http://a", &[3; 40]);
+            put(&cache, "http://c", &[4, 5, 6]);
+            // Rolls over into the newest segment, 3.
+            put(&cache, "http://d", &[7; 8]);
+        }
+        // Tear the last index entry and corrupt `c`, so that a writable open
+        // would truncate, discard, and delete.
+        let index = segment_path(&dir, 3, "idx");
+        let len = std::fs::metadata(&index).unwrap().len();
+        File::options()
+            .write(true)
+            .open(&index)
+            .unwrap()
+            .set_len(len - 5)
+            .unwrap();
+        let data = segment_path(&dir, 2, "dat");
+        let mut bytes = std::fs::read(&data).unwrap();
+        // `c` is the segment's last record.
+        *bytes.last_mut().unwrap() ^= 0xff;
+        std::fs::write(&data, bytes).unwrap();
+        let before = snapshot(&dir);
+        {
+            let cache = PackCache::open_read_only(&dir).unwrap();
+            assert_eq!(get(&cache, "http://a"), Some(vec![3; 40]));
+            assert_eq!(get(&cache, "http://b"), Some(vec![2; 40]));
+            assert_eq!(get(&cache, "http://c"), None);
+            assert_eq!(get(&cache, "http://d"), None);
+            assert!(block_on(cache.put("http://e", Arc::from(&[8][..]))).is_err());
+            assert!(block_on(cache.remove("http://a")).is_err());
+            assert!(block_on(cache.clear()).is_err());
+        }
+        assert_eq!(snapshot(&dir), before);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_rejects_corrupt_records() {
+        let dir = temp_dir("corrupt");
+        {
+            let cache = open_small(&dir, None);
+            put(&cache, "http://a", &[1, 2, 3]);
+            put(&cache, "http://b", &[4, 5, 6]);
+        }
+        // Flip a data byte of `a`, as a bad sector might; its index entry
+        // stays intact.
+        let data = segment_path(&dir, 0, "dat");
+        let mut bytes = std::fs::read(&data).unwrap();
+        bytes["http://a".len()] ^= 0xff;
+        std::fs::write(&data, bytes).unwrap();
+
+        let cache = open_small(&dir, None);
+        assert_eq!(get(&cache, "http://a"), None);
+        assert_eq!(get(&cache, "http://b"), Some(vec![4, 5, 6]));
+        // The corrupt record is dropped for good.
+        drop(cache);
+        let cache = open_small(&dir, None);
+        assert_eq!(cache.len(), 1);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_pack_cache_clear() {
+        let dir = temp_dir("clear");
+        let cache = open_small(&dir, None);
+        put(&cache, "http://a", &[1]);
+        block_on(cache.clear()).unwrap();
+        assert!(cache.is_empty());
+        assert_eq!(get(&cache, "http://a"), None);
+        put(&cache, "http://b", &[2]);
+        drop(cache);
+
+        let cache = open_small(&dir, None);
+        assert_eq!(get(&cache, "http://a"), None);
+        assert_eq!(get(&cache, "http://b"), Some(vec![2]));
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+}
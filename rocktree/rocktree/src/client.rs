@@ -4,26 +4,113 @@
 //! bulk metadata, and node data from Google Earth's servers.
 
 use crate::{
-    cache::{Cache, NoCache},
+    cache::{Blob, Cache, NoCache},
     error::{Error, Result},
+    inflight::{InFlight, Join},
+    retry::RetryPolicy,
+    stage::{Stage, Tile, stage_span},
+    timer,
     types::{
-        BulkMetadata, BulkRequest, Mesh, Node, NodeMetadata, NodeRequest, Planetoid, TextureFormat,
+        BulkMetadata, BulkRequest, FetchInfo, FetchPriority, Mesh, Node, NodeMetadata, NodeRequest,
+        Planetoid, TextureFormat,
     },
 };
 use glam::{DMat4, Vec3};
 use prost::Message;
-use rocktree_decode::{OctreePath, OrientedBoundingBox};
+use rocktree_decode::{
+    OctreePath, OrientedBoundingBox,
+    texture::{DecodedFormat, with_mip_chain},
+};
 use rocktree_proto as proto;
 use std::sync::Arc;
+use tracing::Instrument;
 
 /// Base URL for Google Earth's rocktree API.
 const BASE_URL: &str = "https://kh.google.com/rt/earth/";
 
+/// A finished network fetch, as shared with every coalesced caller along
+/// with the priority it was fetched at.
+type SharedFetch = (Result<(Blob, FetchInfo)>, FetchPriority);
+
+/// A mesh texture as decoded: its bytes (every mip level), format, width,
+/// height and mip level count.
+type DecodedTexture = (Vec<u8>, TextureFormat, u32, u32, u32);
+
+/// Build the default HTTP client.
+///
+/// The rocktree servers speak HTTP/2, so every request multiplexes over one
+/// connection per host; the adaptive flow-control window keeps that one
+/// connection from capping throughput on long fat links, and keep-alive
+/// pings notice a dead connection before a burst of requests queues on it.
+/// The idle pool covers HTTP/1.1 fallbacks (proxies, test servers) without
+/// reconnecting. The request timeout turns a stalled transfer into a
+/// transient error the retry policy can recover from.
+fn default_http_client() -> reqwest::Client {
+    #[cfg(not(target_family = "wasm"))]
+    {
+        use std::time::Duration;
+        reqwest::Client::builder()
+            .pool_max_idle_per_host(32)
+            .pool_idle_timeout(Duration::from_secs(90))
+            .tcp_nodelay(true)
+            .connect_timeout(Duration::from_secs(10))
+            .timeout(Duration::from_secs(30))
+            .http2_adaptive_window(true)
+            .http2_keep_alive_interval(Duration::from_secs(30))
+            .http2_keep_alive_while_idle(true)
+            .build()
+            .expect("failed to create HTTP client")
+    }
+    // The browser's fetch manages connections itself.
+    #[cfg(target_family = "wasm")]
+    reqwest::Client::new()
+}
+
+/// Decode a `BulkMetadata` response body for the bulk at `path`.
+///
+/// [`Client::fetch_bulk`] fetches and decodes in one go; this is for callers
+/// that have the raw response already, such as benchmarks replaying recorded
+/// responses.
+///
+/// # Errors
+///
+/// Returns an error if the response cannot be decoded.
+pub fn decode_bulk(path: OctreePath, data: &[u8]) -> Result<BulkMetadata> {
+    let proto = proto::BulkMetadata::decode(data).map_err(|e| Error::Protobuf {
+        context: "bulk metadata",
+        message: e.to_string(),
+    })?;
+    Client::<NoCache>::decode_bulk_metadata(path, &proto)
+}
+
+/// Decode a `NodeData` response body for the node at `path`, keeping CRN
+/// textures block-compressed if `block_compressed_textures` is set.
+///
+/// The raw-response counterpart of [`Client::fetch_node`], like
+/// [`decode_bulk`].
+///
+/// # Errors
+///
+/// Returns an error if the response cannot be decoded.
+pub fn decode_node(path: OctreePath, data: &[u8], block_compressed_textures: bool) -> Result<Node> {
+    let proto = stage_span(Stage::Protobuf, Some(Tile::Node(path))).in_scope(|| {
+        proto::NodeData::decode(data).map_err(|e| Error::Protobuf {
+            context: "node data",
+            message: e.to_string(),
+        })
+    })?;
+    Client::<NoCache>::decode_node_data(path, &proto, block_compressed_textures)
+}
+
 /// HTTP client for fetching Google Earth mesh data.
 ///
 /// The client handles HTTP requests, caching, and protobuf decoding. It is
 /// designed to be runtime-agnostic and works with any async executor.
 ///
+/// Concurrent fetches of the same URL are coalesced into one request, and
+/// transient failures are retried per the client's [`RetryPolicy`], scaled
+/// by each request's [`FetchPriority`].
+///
 /// # Example
 ///
 /// ```ignore
@@ -34,17 +121,15 @@ pub struct Client<C: Cache = NoCache> {
     http: reqwest::Client,
     cache: Arc<C>,
     base_url: String,
+    retry: RetryPolicy,
+    in_flight: InFlight<SharedFetch>,
 }
 
 impl Client<NoCache> {
     /// Create a new client with default settings and no caching.
     #[must_use]
     pub fn new() -> Self {
-        Self {
-            http: reqwest::Client::new(),
-            cache: Arc::new(NoCache),
-            base_url: BASE_URL.to_string(),
-        }
+        Self::with_cache(NoCache)
     }
 }
 
@@ -58,11 +143,7 @@ impl<C: Cache> Client<C> {
     /// Create a new client with a custom cache.
     #[must_use]
     pub fn with_cache(cache: C) -> Self {
-        Self {
-            http: reqwest::Client::new(),
-            cache: Arc::new(cache),
-            base_url: BASE_URL.to_string(),
-        }
+        Self::with_http_and_cache(default_http_client(), cache)
     }
 
     /// Create a new client with a custom HTTP client and cache.
@@ -72,9 +153,18 @@ impl<C: Cache> Client<C> {
             http,
             cache: Arc::new(cache),
             base_url: BASE_URL.to_string(),
+            retry: RetryPolicy::default(),
+            in_flight: InFlight::new(),
         }
     }
 
+    /// Set how transient failures are retried.
+    #[must_use]
+    pub fn with_retry_policy(mut self, retry: RetryPolicy) -> Self {
+        self.retry = retry;
+        self
+    }
+
     /// Set a custom base URL for testing.
     #[must_use]
     pub fn with_base_url(mut self, base_url: String) -> Self {
@@ -92,13 +182,12 @@ impl<C: Cache> Client<C> {
     /// Returns an error if the HTTP request fails or the response cannot be decoded.
     pub async fn fetch_planetoid(&self) -> Result<Planetoid> {
         let url = format!("{}PlanetoidMetadata", self.base_url);
-        let data = self.fetch_bytes(&url).await?;
+        let data = self.fetch_bytes(&url, FetchPriority::High, None).await?;
 
-        let proto =
-            proto::PlanetoidMetadata::decode(data.as_slice()).map_err(|e| Error::Protobuf {
-                context: "planetoid metadata",
-                message: e.to_string(),
-            })?;
+        let proto = proto::PlanetoidMetadata::decode(&data[..]).map_err(|e| Error::Protobuf {
+            context: "planetoid metadata",
+            message: e.to_string(),
+        })?;
 
         let root_epoch = proto
             .root_node_metadata
@@ -120,18 +209,11 @@ impl<C: Cache> Client<C> {
     ///
     /// Returns an error if the HTTP request fails or the response cannot be decoded.
     pub async fn fetch_bulk(&self, request: &BulkRequest) -> Result<BulkMetadata> {
-        let url = format!(
-            "{}BulkMetadata/pb=!1m2!1s{}!2u{}",
-            self.base_url, request.path, request.epoch
-        );
-        let data = self.fetch_bytes(&url).await?;
-
-        let proto = proto::BulkMetadata::decode(data.as_slice()).map_err(|e| Error::Protobuf {
-            context: "bulk metadata",
-            message: e.to_string(),
-        })?;
-
-        Self::decode_bulk_metadata(request.path, &proto)
+        let url = self.bulk_url(request);
+        let data = self
+            .fetch_bytes(&url, request.priority, Some(Tile::Bulk(request.path)))
+            .await?;
+        decode_bulk(request.path, &data)
     }
 
     /// Fetch node data for a given request.
@@ -142,25 +224,52 @@ impl<C: Cache> Client<C> {
     ///
     /// Returns an error if the HTTP request fails or the response cannot be decoded.
     pub async fn fetch_node(&self, request: &NodeRequest) -> Result<Node> {
-        let url = if let Some(imagery_epoch) = request.imagery_epoch {
-            format!(
-                "{}NodeData/pb=!1m2!1s{}!2u{}!2e{}!3u{}!4b0",
-                self.base_url, request.path, request.epoch, request.texture_format, imagery_epoch
-            )
-        } else {
-            format!(
-                "{}NodeData/pb=!1m2!1s{}!2u{}!2e{}!4b0",
-                self.base_url, request.path, request.epoch, request.texture_format
-            )
-        };
-        let data = self.fetch_bytes(&url).await?;
+        self.fetch_node_with_info(request)
+            .await
+            .map(|(node, _)| node)
+    }
 
-        let proto = proto::NodeData::decode(data.as_slice()).map_err(|e| Error::Protobuf {
-            context: "node data",
-            message: e.to_string(),
-        })?;
+    /// Fetch node data for a given request, along with the transfer
+    /// statistics of the underlying fetch.
+    ///
+    /// Like [`fetch_node`](Self::fetch_node), but also reports the encoded
+    /// response size and whether it was a cache hit, so schedulers can size
+    /// their concurrency from measured bandwidth without re-fetching.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the HTTP request fails or the response cannot be decoded.
+    pub async fn fetch_node_with_info(&self, request: &NodeRequest) -> Result<(Node, FetchInfo)> {
+        let url = self.node_url(request);
+        let tile = Some(Tile::Node(request.path));
+        let (data, info) = self
+            .fetch_bytes_with_info(&url, request.priority, tile)
+            .await?;
+        // In the browser, a running worker pool decodes off the page.
+        #[cfg(target_family = "wasm")]
+        if let Some(node) =
+            crate::workers::decode(request.path, &data, request.block_compressed_textures).await
+        {
+            return Ok((node?, info));
+        }
+        let node = decode_node(request.path, &data, request.block_compressed_textures)?;
+        Ok((node, info))
+    }
 
-        Self::decode_node_data(request.path, &proto)
+    /// Fetch a node's data into the cache without decoding it.
+    ///
+    /// For prefetching: a later [`fetch_node`](Self::fetch_node) for the same
+    /// request is then served from the cache, or joins this fetch if it is
+    /// still in flight.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the HTTP request fails.
+    pub async fn warm_node(&self, request: &NodeRequest) -> Result<FetchInfo> {
+        let url = self.node_url(request);
+        self.fetch_bytes_with_info(&url, request.priority, Some(Tile::Node(request.path)))
+            .await
+            .map(|(_, info)| info)
     }
 
     /// Fetch raw bytes from a URL, using cache if available.
@@ -168,7 +277,9 @@ impl<C: Cache> Client<C> {
     /// This is exposed for test vector generation - it allows saving raw
     /// protobuf responses to disk.
     pub async fn fetch_bytes_from_url(&self, url: &str) -> Result<Vec<u8>> {
-        self.fetch_bytes(url).await
+        self.fetch_bytes(url, FetchPriority::Normal, None)
+            .await
+            .map(|data| data.to_vec())
     }
 
     /// Build the URL for fetching bulk metadata.
@@ -202,17 +313,133 @@ impl<C: Cache> Client<C> {
         format!("{}PlanetoidMetadata", self.base_url)
     }
 
-    /// Fetch raw bytes from a URL, using cache if available.
-    async fn fetch_bytes(&self, url: &str) -> Result<Vec<u8>> {
-        // Check cache first.
-        if let Some(data) = self.cache.get(url).await? {
-            tracing::debug!(url, "cache hit");
-            return Ok(data);
+    /// Fetch raw bytes from a URL, using cache if available. Its stages are
+    /// attributed to `tile`, if the URL is one.
+    async fn fetch_bytes(
+        &self,
+        url: &str,
+        priority: FetchPriority,
+        tile: Option<Tile>,
+    ) -> Result<Blob> {
+        self.fetch_bytes_with_info(url, priority, tile)
+            .await
+            .map(|(data, _)| data)
+    }
+
+    /// Fetch raw bytes from a URL, using cache if available, and report the
+    /// body size and whether the cache served it.
+    ///
+    /// Concurrent callers for one URL share a single network request. A
+    /// caller that outranks the one it waited on doesn't accept that
+    /// caller's transient failure: it retries under its own, more generous,
+    /// budget.
+    async fn fetch_bytes_with_info(
+        &self,
+        url: &str,
+        priority: FetchPriority,
+        tile: Option<Tile>,
+    ) -> Result<(Blob, FetchInfo)> {
+        loop {
+            match self.in_flight.join(url) {
+                Join::Leader(leader) => {
+                    // Only the leader checks the cache. A request that just
+                    // finished has stored its response before releasing its
+                    // slot, so looking here rather than before joining means
+                    // a caller arriving just as it finishes reads the stored
+                    // copy instead of fetching again.
+                    let result = match self.cache_lookup(url, tile).await {
+                        Ok(Some(data)) => {
+                            tracing::debug!(url, "cache hit");
+                            let info = FetchInfo {
+                                bytes: data.len(),
+                                cache_hit: true,
+                                ..FetchInfo::default()
+                            };
+                            Ok((data, info))
+                        }
+                        Ok(None) => self.fetch_network(url, priority, tile).await,
+                        Err(e) => Err(e),
+                    };
+                    leader.complete((result.clone(), priority));
+                    return result;
+                }
+                Join::Follower(follower) => {
+                    tracing::debug!(url, "coalesced with in-flight request");
+                    match follower.await {
+                        Some((Ok((data, info)), _)) => {
+                            let info = FetchInfo {
+                                coalesced: true,
+                                ..info
+                            };
+                            return Ok((data, info));
+                        }
+                        Some((Err(e), leader_priority))
+                            if !e.is_transient() || leader_priority >= priority =>
+                        {
+                            return Err(e);
+                        }
+                        // The leader was cancelled, or gave up sooner than
+                        // we would: fetch it ourselves.
+                        _ => {}
+                    }
+                }
+            }
+        }
+    }
+
+    /// Look `url` up in the cache. The span starts as a miss and is
+    /// relabelled once the lookup finds the entry.
+    async fn cache_lookup(&self, url: &str, tile: Option<Tile>) -> Result<Option<Blob>> {
+        let lookup = stage_span(Stage::CacheMiss, tile);
+        let cached = self.cache.get(url).instrument(lookup.clone()).await?;
+        if cached.is_some() {
+            lookup.record("stage", Stage::CacheHit.name());
+        }
+        Ok(cached)
+    }
+
+    /// Fetch a URL from the network and store it in the cache, retrying
+    /// transient failures with backoff.
+    async fn fetch_network(
+        &self,
+        url: &str,
+        priority: FetchPriority,
+        tile: Option<Tile>,
+    ) -> Result<(Blob, FetchInfo)> {
+        let max_retries = self.retry.retries_for(priority);
+        let mut retries = 0;
+        loop {
+            match self
+                .fetch_once(url)
+                .instrument(stage_span(Stage::Http, tile))
+                .await
+            {
+                Ok(data) => {
+                    // Store in cache; the cache shares the allocation.
+                    self.cache.put(url, Arc::clone(&data)).await?;
+                    let info = FetchInfo {
+                        bytes: data.len(),
+                        cache_hit: false,
+                        coalesced: false,
+                        retries,
+                    };
+                    return Ok((data.into(), info));
+                }
+                Err(e) if e.is_transient() && retries < max_retries => {
+                    let delay = self.retry.delay(retries, priority);
+                    tracing::debug!(url, retries, ?delay, "retrying after {e}");
+                    timer::sleep(delay).await;
+                    retries += 1;
+                }
+                Err(e) => return Err(e),
+            }
         }
+    }
 
+    /// Issue a single GET for a URL.
+    async fn fetch_once(&self, url: &str) -> Result<Arc<[u8]>> {
         tracing::debug!(url, "fetching");
 
-        // Fetch from network.
         let response = self.http.get(url).send().await.map_err(|e| Error::Http {
             url: url.to_string(),
             message: e.to_string(),
@@ -230,12 +457,7 @@ impl<C: Cache> Client<C> {
             url: url.to_string(),
             message: e.to_string(),
         })?;
-        let data = data.to_vec();
-
-        // Store in cache.
-        self.cache.put(url, data.clone()).await?;
-
-        Ok(data)
+        Ok(Arc::from(&data[..]))
     }
 
     /// Decode bulk metadata from protobuf.
@@ -345,7 +567,11 @@ impl<C: Cache> Client<C> {
     }
 
     /// Decode node data from protobuf.
-    fn decode_node_data(path: OctreePath, proto: &proto::NodeData) -> Result<Node> {
+    fn decode_node_data(
+        path: OctreePath,
+        proto: &proto::NodeData,
+        block_compressed_textures: bool,
+    ) -> Result<Node> {
         let matrix_data: &[f64] = &proto.matrix_globe_from_mesh;
         let matrix_globe_from_mesh = if matrix_data.len() == 16 {
             DMat4::from_cols_array(matrix_data.try_into().unwrap_or(&[0.0; 16]))
@@ -360,12 +586,24 @@ impl<C: Cache> Client<C> {
             .filter(|d| !d.is_empty())
             .and_then(|data| rocktree_decode::unpack_for_normals(data).ok());
 
-        let mut meshes = Vec::new();
-
-        for mesh_proto in &proto.meshes {
-            let mesh = Self::decode_mesh(mesh_proto, normal_lookup.as_deref())?;
-            meshes.push(mesh);
-        }
+        // Textures first, as a stage of their own, then the geometry.
+        let textures = stage_span(Stage::TextureDecode, Some(Tile::Node(path))).in_scope(|| {
+            proto
+                .meshes
+                .iter()
+                .map(|mesh_proto| Self::decode_texture(mesh_proto, block_compressed_textures))
+                .collect::<Result<Vec<_>>>()
+        })?;
+        let meshes = stage_span(Stage::MeshDecode, Some(Tile::Node(path))).in_scope(|| {
+            proto
+                .meshes
+                .iter()
+                .zip(textures)
+                .map(|(mesh_proto, texture)| {
+                    Self::decode_mesh(mesh_proto, normal_lookup.as_deref(), texture)
+                })
+                .collect::<Result<Vec<_>>>()
+        })?;
 
         // Get OBB from first mesh if available (or create a default).
         let obb = OrientedBoundingBox {
@@ -383,8 +621,16 @@ impl<C: Cache> Client<C> {
         })
     }
 
-    /// Decode a mesh from protobuf.
-    fn decode_mesh(proto: &proto::Mesh, normal_lookup: Option<&[u8]>) -> Result<Mesh> {
+    /// Decode a mesh from protobuf, given its texture from
+    /// [`Self::decode_texture`].
+    fn decode_mesh(
+        proto: &proto::Mesh,
+        normal_lookup: Option<&[u8]>,
+        texture: DecodedTexture,
+    ) -> Result<Mesh> {
+        let (texture_data, texture_format, texture_width, texture_height, texture_mip_levels) =
+            texture;
+
         // Unpack vertices.
         let vertices_data = proto.vertices.as_deref().unwrap_or(&[]);
         let mut vertices = rocktree_decode::unpack_vertices(vertices_data)?;
@@ -439,10 +685,6 @@ impl<C: Cache> Client<C> {
         // Decode per-vertex normals from the mesh's normal indices and the node's lookup table.
         let normals = Self::decode_normals(proto, normal_lookup, vertices.len());
 
-        // Decode texture.
-        let (texture_data, texture_format, texture_width, texture_height) =
-            Self::decode_texture(proto)?;
-
         Ok(Mesh {
             vertices,
             indices,
@@ -452,6 +694,7 @@ impl<C: Cache> Client<C> {
             texture_format,
             texture_width,
             texture_height,
+            texture_mip_levels,
             has_octant_data,
         })
     }
@@ -491,7 +734,12 @@ impl<C: Cache> Client<C> {
     }
 
     /// Decode texture data from a mesh.
-    fn decode_texture(mesh: &proto::Mesh) -> Result<(Vec<u8>, TextureFormat, u32, u32)> {
+    ///
+    /// With `block_compressed`, CRN-DXT1 textures stay as BC1 blocks
+    /// ([`TextureFormat::Dxt1`]) where their dimensions allow it. Either way
+    /// the texture comes with its mip chain, built here so no frame pays for
+    /// it.
+    fn decode_texture(mesh: &proto::Mesh, block_compressed: bool) -> Result<DecodedTexture> {
         let textures = &mesh.texture;
         if textures.is_empty() {
             return Err(Error::InvalidData {
@@ -512,23 +760,34 @@ impl<C: Cache> Client<C> {
         let format = texture.format.unwrap_or(proto::texture::Format::Jpg as i32);
         match format {
             f if f == proto::texture::Format::Jpg as i32 => {
-                let decoded = rocktree_decode::texture::decode_jpeg_to_rgba(tex_data)?;
+                let decoded =
+                    with_mip_chain(rocktree_decode::texture::decode_jpeg_to_rgba(tex_data)?);
                 // Return as RGBA since we fully decode JPEG.
                 Ok((
                     decoded.data,
                     TextureFormat::Rgba,
                     decoded.width,
                     decoded.height,
+                    decoded.mip_levels,
                 ))
             }
             f if f == proto::texture::Format::CrnDxt1 as i32 => {
-                let decoded = rocktree_decode::texture::decode_crn_to_rgba(tex_data)?;
-                // Return as RGBA since we fully decode CRN.
+                let decoded = if block_compressed {
+                    rocktree_decode::texture::decode_crn_to_bc1(tex_data)?
+                } else {
+                    rocktree_decode::texture::decode_crn_to_rgba(tex_data)?
+                };
+                let decoded = with_mip_chain(decoded);
+                let format = match decoded.format {
+                    DecodedFormat::Rgba8 => TextureFormat::Rgba,
+                    DecodedFormat::Bc1 => TextureFormat::Dxt1,
+                };
                 Ok((
                     decoded.data,
-                    TextureFormat::Rgba,
+                    format,
                     decoded.width,
                     decoded.height,
+                    decoded.mip_levels,
                 ))
             }
             other => Err(Error::InvalidData {
@@ -6,7 +6,10 @@ use std::fmt;
 pub type Result<T> = std::result::Result<T, Error>;
 
 /// Errors that can occur in rocktree operations.
-#[derive(Debug)]
+///
+/// `Clone` so one failed fetch can be reported to every caller that was
+/// waiting on it.
+#[derive(Debug, Clone)]
 pub enum Error {
     /// HTTP request failed.
     Http {
@@ -70,6 +73,19 @@ impl fmt::Display for Error {
     }
 }
 
+impl Error {
+    /// Whether the failure may succeed on retry: a network error, a rate
+    /// limit, or a server-side (`5xx`) status.
+    #[must_use]
+    pub fn is_transient(&self) -> bool {
+        match self {
+            Error::Http { .. } => true,
+            Error::HttpStatus { status, .. } => *status == 429 || (500..600).contains(status),
+            _ => false,
+        }
+    }
+}
+
 impl std::error::Error for Error {
     fn source(&self) -> Option<&(dyn std::error::Error + 'static)> {
         match self {
@@ -0,0 +1,197 @@
+//! In-flight request coalescing.
+//!
+//! When several callers want the same URL at once (the render and physics
+//! traversals often select the same node, and overlapping bulks share
+//! children), only the first does the work; the rest wait for its result.
+//! Runtime-agnostic: waiters are woken directly, with no channel or timer.
+
+use std::{
+    collections::HashMap,
+    future::Future,
+    pin::Pin,
+    sync::{Arc, Mutex},
+    task::{Context, Poll, Waker},
+};
+
+/// Tracks the requests currently in flight, by key.
+pub(crate) struct InFlight<T> {
+    slots: Mutex<HashMap<String, Arc<Slot<T>>>>,
+}
+
+struct Slot<T> {
+    state: Mutex<SlotState<T>>,
+}
+
+enum SlotState<T> {
+    /// The leader is still working; these waiters want its result.
+    Pending(Vec<Waker>),
+    /// The leader finished.
+    Done(T),
+    /// The leader was dropped (its task cancelled) before finishing.
+    Abandoned,
+}
+
+/// The outcome of [`InFlight::join`].
+pub(crate) enum Join<'a, T: Clone> {
+    /// No request for the key was in flight: the caller must do the work and
+    /// hand its result to [`Leader::complete`].
+    Leader(Leader<'a, T>),
+    /// Another caller is already doing the work.
+    Follower(Follow<T>),
+}
+
+impl<T: Clone> InFlight<T> {
+    pub(crate) fn new() -> Self {
+        Self {
+            slots: Mutex::new(HashMap::new()),
+        }
+    }
+
+    /// Join the request for `key`, becoming its leader if none is in flight.
+    pub(crate) fn join(&self, key: &str) -> Join<'_, T> {
+        let mut slots = self.slots.lock().unwrap();
+        if let Some(slot) = slots.get(key) {
+            return Join::Follower(Follow {
+                slot: Arc::clone(slot),
+            });
+        }
+        let slot = Arc::new(Slot {
+            state: Mutex::new(SlotState::Pending(Vec::new())),
+        });
+        slots.insert(key.to_string(), Arc::clone(&slot));
+        Join::Leader(Leader {
+            inflight: self,
+            key: key.to_string(),
+            slot,
+            finished: false,
+        })
+    }
+
+    /// Number of distinct requests in flight.
+    #[cfg(test)]
+    fn len(&self) -> usize {
+        self.slots.lock().unwrap().len()
+    }
+
+    /// Settle a slot, wake its waiters, and stop routing new callers to it.
+    fn settle(&self, key: &str, slot: &Arc<Slot<T>>, state: SlotState<T>) {
+        {
+            let mut slots = self.slots.lock().unwrap();
+            if slots.get(key).is_some_and(|s| Arc::ptr_eq(s, slot)) {
+                slots.remove(key);
+            }
+        }
+        let previous = std::mem::replace(&mut *slot.state.lock().unwrap(), state);
+        if let SlotState::Pending(wakers) = previous {
+            for waker in wakers {
+                waker.wake();
+            }
+        }
+    }
+}
+
+/// The caller doing the work for a key. Dropping it unfinished (for example
+/// when its task is cancelled) releases the waiters to retry on their own.
+pub(crate) struct Leader<'a, T: Clone> {
+    inflight: &'a InFlight<T>,
+    key: String,
+    slot: Arc<Slot<T>>,
+    finished: bool,
+}
+
+impl<T: Clone> Leader<'_, T> {
+    /// Publish the result to every waiter.
+    pub(crate) fn complete(mut self, value: T) {
+        self.finished = true;
+        self.inflight
+            .settle(&self.key, &self.slot, SlotState::Done(value));
+    }
+}
+
+impl<T: Clone> Drop for Leader<'_, T> {
+    fn drop(&mut self) {
+        if !self.finished {
+            self.inflight
+                .settle(&self.key, &self.slot, SlotState::Abandoned);
+        }
+    }
+}
+
+/// Waits for a leader's result: `Some(result)`, or `None` if the leader was
+/// abandoned.
+pub(crate) struct Follow<T> {
+    slot: Arc<Slot<T>>,
+}
+
+impl<T: Clone> Future for Follow<T> {
+    type Output = Option<T>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Option<T>> {
+        match &mut *self.slot.state.lock().unwrap() {
+            SlotState::Pending(wakers) => {
+                if !wakers.iter().any(|w| w.will_wake(cx.waker())) {
+                    wakers.push(cx.waker().clone());
+                }
+                Poll::Pending
+            }
+            SlotState::Done(value) => Poll::Ready(Some(value.clone())),
+            SlotState::Abandoned => Poll::Ready(None),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::task::Wake;
+
+    struct CountingWaker(std::sync::atomic::AtomicUsize);
+
+    impl Wake for CountingWaker {
+        fn wake(self: Arc<Self>) {
+            self.0.fetch_add(1, std::sync::atomic::Ordering::Relaxed);
+        }
+    }
+
+    fn poll<T: Clone>(follow: &mut Follow<T>, waker: &Waker) -> Poll<Option<T>> {
+        Pin::new(follow).poll(&mut Context::from_waker(waker))
+    }
+
+    #[test]
+    fn test_followers_share_leader_result() {
+        let inflight = InFlight::<u32>::new();
+        let Join::Leader(leader) = inflight.join("a") else {
+            panic!("first caller leads");
+        };
+        let Join::Follower(mut follower) = inflight.join("a") else {
+            panic!("second caller follows");
+        };
+        // Other keys are independent.
+        assert!(matches!(inflight.join("b"), Join::Leader(_)));
+
+        let counter = Arc::new(CountingWaker(0.into()));
+        let waker = Waker::from(Arc::clone(&counter));
+        assert_eq!(poll(&mut follower, &waker), Poll::Pending);
+
+        leader.complete(7);
+        assert_eq!(counter.0.load(std::sync::atomic::Ordering::Relaxed), 1);
+        assert_eq!(poll(&mut follower, &waker), Poll::Ready(Some(7)));
+
+        // The key is free again once settled.
+        assert_eq!(inflight.len(), 0);
+        assert!(matches!(inflight.join("a"), Join::Leader(_)));
+    }
+
+    #[test]
+    fn test_dropped_leader_releases_followers() {
+        let inflight = InFlight::<u32>::new();
+        let leader = inflight.join("a");
+        let Join::Follower(mut follower) = inflight.join("a") else {
+            panic!("second caller follows");
+        };
+        drop(leader);
+        let waker = Waker::from(Arc::new(CountingWaker(0.into())));
+        assert_eq!(poll(&mut follower, &waker), Poll::Ready(None));
+        assert_eq!(inflight.len(), 0);
+    }
+}
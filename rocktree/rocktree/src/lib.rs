@@ -9,6 +9,8 @@
 //! - **Web-compatible**: Works on desktop and WASM via reqwest
 //! - **Runtime-agnostic**: Returns `impl Future`, works with any executor
 //! - **Sync decoding**: Decode functions are synchronous; client parallelizes
+//!   (in the browser, on a pool of decode workers when one is started; see
+//!   `workers`)
 //!
 //! # Example
 //!
@@ -28,16 +30,24 @@
 pub mod cache;
 mod client;
 mod error;
+mod inflight;
+mod retry;
+pub mod stage;
+mod timer;
 pub mod types;
+pub mod wire;
+#[cfg(target_family = "wasm")]
+pub mod workers;
 
+pub use cache::{Blob, Cache, MemoryCache, MemoryCacheStats, NoCache};
 #[cfg(not(target_family = "wasm"))]
-pub use cache::FilesystemCache;
-pub use cache::{Cache, MemoryCache, NoCache};
-pub use client::Client;
+pub use cache::{FilesystemCache, PackCache};
+pub use client::{Client, decode_bulk, decode_node};
 pub use error::{Error, Result};
+pub use retry::RetryPolicy;
 pub use types::{
-    BulkMetadata, BulkRequest, Frustum, LodMetrics, Mesh, Node, NodeMetadata, NodeRequest,
-    Planetoid, TextureFormat,
+    BulkMetadata, BulkRequest, FetchInfo, FetchPriority, Frustum, LodMetrics, Mesh, Node,
+    NodeMetadata, NodeRequest, Planetoid, TextureFormat,
 };
 
 // Re-export decode types for convenience.
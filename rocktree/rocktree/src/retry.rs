@@ -0,0 +1,111 @@
+//! Retry policy for transient fetch failures.
+//!
+//! Retries use exponential backoff with jitter, so a burst of failures (a
+//! dropped connection fails every multiplexed request at once) doesn't come
+//! back as a synchronized burst of retries. Delays scale with the caller's
+//! [`FetchPriority`]: urgent requests retry soonest, speculative ones barely
+//! retry at all and leave the slot to work that is needed now.
+
+use crate::types::FetchPriority;
+use std::{hash::BuildHasher, time::Duration};
+
+/// How a [`Client`](crate::Client) retries transient failures: network
+/// errors and `429`/`5xx` statuses.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct RetryPolicy {
+    /// Retries after the first attempt for [`FetchPriority::High`] and
+    /// [`FetchPriority::Normal`] requests. [`FetchPriority::Low`] requests
+    /// retry at most once.
+    pub max_retries: u32,
+    /// Backoff before the first retry of a high-priority request, doubled on
+    /// each retry and for each step down in priority.
+    pub base_delay: Duration,
+    /// Upper bound on any single backoff.
+    pub max_delay: Duration,
+}
+
+impl RetryPolicy {
+    /// Never retry.
+    #[must_use]
+    pub const fn none() -> Self {
+        Self {
+            max_retries: 0,
+            base_delay: Duration::ZERO,
+            max_delay: Duration::ZERO,
+        }
+    }
+
+    /// Retries allowed for a request of the given priority.
+    #[must_use]
+    pub fn retries_for(&self, priority: FetchPriority) -> u32 {
+        match priority {
+            FetchPriority::High | FetchPriority::Normal => self.max_retries,
+            FetchPriority::Low => self.max_retries.min(1),
+        }
+    }
+
+    /// Backoff before retry number `retry` (0-based) of a request.
+    ///
+    /// Uses "equal jitter": half the exponential delay is fixed and the other
+    /// half random, which spreads retries out while still guaranteeing a
+    /// minimum wait.
+    #[must_use]
+    pub fn delay(&self, retry: u32, priority: FetchPriority) -> Duration {
+        let steps = retry + priority_steps(priority);
+        let exponential = self
+            .base_delay
+            .saturating_mul(1u32 << steps.min(16))
+            .min(self.max_delay);
+        let half = exponential / 2;
+        let jitter = std::collections::hash_map::RandomState::new().hash_one(retry);
+        half + half.mul_f64((jitter >> 11) as f64 / (1u64 << 53) as f64)
+    }
+}
+
+impl Default for RetryPolicy {
+    /// Three retries starting at 200 ms, capped at 5 s.
+    fn default() -> Self {
+        Self {
+            max_retries: 3,
+            base_delay: Duration::from_millis(200),
+            max_delay: Duration::from_secs(5),
+        }
+    }
+}
+
+/// Extra doublings of the backoff for lower-priority requests.
+fn priority_steps(priority: FetchPriority) -> u32 {
+    match priority {
+        FetchPriority::High => 0,
+        FetchPriority::Normal => 1,
+        FetchPriority::Low => 2,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_retry_delay_grows_and_is_capped() {
+        let policy = RetryPolicy::default();
+        for retry in 0..8 {
+            let delay = policy.delay(retry, FetchPriority::High);
+            let exponential = (policy.base_delay * (1u32 << retry)).min(policy.max_delay);
+            assert!(delay >= exponential / 2, "retry {retry}: {delay:?}");
+            assert!(delay <= exponential, "retry {retry}: {delay:?}");
+        }
+    }
+
+    #[test]
+    fn test_lower_priority_backs_off_longer() {
+        let policy = RetryPolicy::default();
+        // The fixed half of a low-priority delay exceeds the whole of a
+        // high-priority one.
+        let high = policy.delay(0, FetchPriority::High);
+        let low = policy.delay(0, FetchPriority::Low);
+        assert!(low > high);
+        assert_eq!(policy.retries_for(FetchPriority::Low), 1);
+        assert_eq!(RetryPolicy::none().retries_for(FetchPriority::High), 0);
+    }
+}
@@ -0,0 +1,150 @@
+//! Tile lifecycle stages, reported as `tracing` spans.
+//!
+//! The client marks each stage of a node fetch (cache lookup, HTTP, protobuf,
+//! mesh and texture decode) with a span named [`STAGE_SPAN`], and the engine
+//! streaming the node adds the stages after it (queue wait, conversion,
+//! upload, first visible frame). A subscriber layer that wants per-stage
+//! latencies times those spans; without one they cost a callsite check.
+//!
+//! A span measures its stage from creation to close, so one instrumenting a
+//! future covers the whole wait rather than just its polls. Stages measured
+//! across frames, where nothing is open for the duration, are reported
+//! after the fact with [`record_stage`], whose span carries the elapsed time
+//! in its `micros` field instead.
+//!
+//! Fetches of different tiles interleave on the same threads, so stage spans
+//! carry the [`Tile`] they work on in their `tile` field: a trace viewer can
+//! then lay each tile's stages out on a track of its own.
+
+use std::{fmt, time::Duration};
+
+use rocktree_decode::OctreePath;
+use tracing::{Span, field::display};
+
+/// Name of every stage span. Its `stage` field holds [`Stage::name`], and its
+/// `tile` field, if any, the [`Tile`] the stage works on.
+pub const STAGE_SPAN: &str = "tile_stage";
+
+/// The octree tile a stage works on.
+///
+/// Bulk metadata and node data live at the same paths, so the kind is part
+/// of the identity.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Tile {
+    /// Bulk metadata at a path.
+    Bulk(OctreePath),
+    /// Node data at a path.
+    Node(OctreePath),
+}
+
+impl fmt::Display for Tile {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Bulk(path) => write!(f, "bulk:{path}"),
+            Self::Node(path) => write!(f, "node:{path}"),
+        }
+    }
+}
+
+/// One step of a tile's way from request to screen.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Stage {
+    /// Waiting in the fetch queue for a free slot.
+    Queue,
+    /// A cache lookup that found the response.
+    CacheHit,
+    /// A cache lookup that didn't, before going to the network.
+    CacheMiss,
+    /// One HTTP request, retries apart.
+    Http,
+    /// Parsing the response protobuf.
+    Protobuf,
+    /// Unpacking mesh geometry: vertices, indices, UVs, octants, normals.
+    MeshDecode,
+    /// Decoding mesh textures.
+    TextureDecode,
+    /// Converting decoded meshes to render assets.
+    Convert,
+    /// From the converted node reaching the main thread to its render
+    /// entities spawned with their textures queued.
+    Upload,
+    /// From spawning to the first frame a tile mesh is in view.
+    Visible,
+}
+
+impl Stage {
+    /// Every stage, in lifecycle order.
+    pub const ALL: [Self; 10] = [
+        Self::Queue,
+        Self::CacheHit,
+        Self::CacheMiss,
+        Self::Http,
+        Self::Protobuf,
+        Self::MeshDecode,
+        Self::TextureDecode,
+        Self::Convert,
+        Self::Upload,
+        Self::Visible,
+    ];
+
+    /// The stage's `stage` field value.
+    #[must_use]
+    pub fn name(self) -> &'static str {
+        match self {
+            Self::Queue => "queue",
+            Self::CacheHit => "cache_hit",
+            Self::CacheMiss => "cache_miss",
+            Self::Http => "http",
+            Self::Protobuf => "protobuf",
+            Self::MeshDecode => "mesh_decode",
+            Self::TextureDecode => "texture_decode",
+            Self::Convert => "convert",
+            Self::Upload => "upload",
+            Self::Visible => "visible",
+        }
+    }
+
+    /// The stage named `name`, as [`Self::name`] spells it.
+    #[must_use]
+    pub fn from_name(name: &str) -> Option<Self> {
+        Self::ALL.into_iter().find(|stage| stage.name() == name)
+    }
+}
+
+/// A span timing `stage` of `tile` from now until it closes. Enter it
+/// around synchronous work, or instrument a future with it.
+#[must_use]
+pub fn stage_span(stage: Stage, tile: Option<Tile>) -> Span {
+    tracing::info_span!("tile_stage", stage = stage.name(), tile = tile.map(display))
+}
+
+/// Report a stage of `tile` that took `elapsed` and has already finished.
+pub fn record_stage(stage: Stage, tile: Option<Tile>, elapsed: Duration) {
+    let micros = u64::try_from(elapsed.as_micros()).unwrap_or(u64::MAX);
+    drop(tracing::info_span!(
+        "tile_stage",
+        stage = stage.name(),
+        tile = tile.map(display),
+        micros
+    ));
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn stage_names_round_trip() {
+        for stage in Stage::ALL {
+            assert_eq!(Stage::from_name(stage.name()), Some(stage));
+        }
+        assert_eq!(Stage::from_name("tile_stage"), None);
+    }
+
+    #[test]
+    fn tiles_at_one_path_stay_distinct() {
+        let path = OctreePath::parse("0123").unwrap();
+        assert_eq!(Tile::Node(path).to_string(), "node:0123");
+        assert_eq!(Tile::Bulk(path).to_string(), "bulk:0123");
+    }
+}
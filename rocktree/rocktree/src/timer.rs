@@ -0,0 +1,245 @@
+//! Runtime-agnostic timers, for retry backoff and worker timeouts.
+//!
+//! The crate doesn't pick an async runtime for its callers, so it can't use
+//! one's timer. On native a single shared thread keeps every pending
+//! deadline in a heap and wakes each task when its deadline passes; in the
+//! browser the event loop's `setTimeout` does.
+
+use std::time::Duration;
+
+/// Wait for `duration`. Returns `false` at once, without waiting, if there
+/// is no timer to wait on: the timer thread couldn't be spawned, or the
+/// global scope has no `setTimeout`.
+pub(crate) async fn sleep(duration: Duration) -> bool {
+    if duration.is_zero() {
+        return true;
+    }
+    imp::sleep(duration).await
+}
+
+#[cfg(not(target_family = "wasm"))]
+mod imp {
+    use std::{
+        cmp::Reverse,
+        collections::BinaryHeap,
+        future::Future,
+        pin::Pin,
+        sync::{Arc, Condvar, Mutex, OnceLock, Weak},
+        task::{Context, Poll, Waker},
+        time::{Duration, Instant},
+    };
+
+    /// Whether a sleep's deadline has passed, and the task to wake when it
+    /// does.
+    #[derive(Default)]
+    struct Entry {
+        state: Mutex<(bool, Option<Waker>)>,
+    }
+
+    impl Entry {
+        fn fire(&self) {
+            let mut state = self.state.lock().unwrap();
+            state.0 = true;
+            if let Some(waker) = state.1.take() {
+                waker.wake();
+            }
+        }
+    }
+
+    /// A pending deadline. Orders by deadline, then by registration, so the
+    /// heap needs nothing from the entry itself.
+    struct Deadline {
+        at: Instant,
+        seq: u64,
+        /// Dropped sleeps leave their deadline behind; it lapses unnoticed.
+        entry: Weak<Entry>,
+    }
+
+    impl PartialEq for Deadline {
+        fn eq(&self, other: &Self) -> bool {
+            (self.at, self.seq) == (other.at, other.seq)
+        }
+    }
+
+    impl Eq for Deadline {}
+
+    impl PartialOrd for Deadline {
+        fn partial_cmp(&self, other: &Self) -> Option<std::cmp::Ordering> {
+            Some(self.cmp(other))
+        }
+    }
+
+    impl Ord for Deadline {
+        fn cmp(&self, other: &Self) -> std::cmp::Ordering {
+            (self.at, self.seq).cmp(&(other.at, other.seq))
+        }
+    }
+
+    #[derive(Default)]
+    struct Queue {
+        deadlines: BinaryHeap<Reverse<Deadline>>,
+        next_seq: u64,
+    }
+
+    /// The shared timer thread's queue, and the condvar it waits on for an
+    /// earlier deadline.
+    #[derive(Default)]
+    struct Timer {
+        queue: Mutex<Queue>,
+        changed: Condvar,
+    }
+
+    impl Timer {
+        /// The process-wide timer, spawning its thread on first use. `None`
+        /// if the thread couldn't be spawned.
+        fn get() -> Option<&'static Self> {
+            static TIMER: OnceLock<Option<Arc<Timer>>> = OnceLock::new();
+            TIMER
+                .get_or_init(|| {
+                    let timer = Arc::new(Self::default());
+                    let run = Arc::clone(&timer);
+                    std::thread::Builder::new()
+                        .name("rocktree-timer".into())
+                        .spawn(move || run.run())
+                        .ok()
+                        .map(|_| timer)
+                })
+                .as_deref()
+        }
+
+        fn add(&self, at: Instant, entry: &Arc<Entry>) {
+            let mut queue = self.queue.lock().unwrap();
+            let seq = queue.next_seq;
+            queue.next_seq += 1;
+            let earliest = queue
+                .deadlines
+                .peek()
+                .is_none_or(|Reverse(first)| at < first.at);
+            queue.deadlines.push(Reverse(Deadline {
+                at,
+                seq,
+                entry: Arc::downgrade(entry),
+            }));
+            if earliest {
+                self.changed.notify_one();
+            }
+        }
+
+        fn run(&self) {
+            let mut queue = self.queue.lock().unwrap();
+            loop {
+                let now = Instant::now();
+                match queue.deadlines.peek() {
+                    None => queue = self.changed.wait(queue).unwrap(),
+                    Some(Reverse(first)) if first.at > now => {
+                        let wait = first.at - now;
+                        queue = self.changed.wait_timeout(queue, wait).unwrap().0;
+                    }
+                    Some(_) => {
+                        let Reverse(due) = queue.deadlines.pop().expect("peeked above");
+                        if let Some(entry) = due.entry.upgrade() {
+                            entry.fire();
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    pub(super) async fn sleep(duration: Duration) -> bool {
+        let Some(timer) = Timer::get() else {
+            return false;
+        };
+        Sleep {
+            at: Instant::now() + duration,
+            timer,
+            entry: None,
+        }
+        .await;
+        true
+    }
+
+    /// Future behind [`sleep`], registered with the timer on first poll.
+    struct Sleep {
+        at: Instant,
+        timer: &'static Timer,
+        entry: Option<Arc<Entry>>,
+    }
+
+    impl Future for Sleep {
+        type Output = ();
+
+        fn poll(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<()> {
+            if Instant::now() >= self.at {
+                return Poll::Ready(());
+            }
+            let Some(entry) = self.entry.clone() else {
+                let entry = Arc::new(Entry::default());
+                // Set the waker before the timer can fire.
+                entry.state.lock().unwrap().1 = Some(cx.waker().clone());
+                self.timer.add(self.at, &entry);
+                self.entry = Some(entry);
+                return Poll::Pending;
+            };
+            let mut state = entry.state.lock().unwrap();
+            if state.0 {
+                return Poll::Ready(());
+            }
+            match &mut state.1 {
+                Some(waker) => waker.clone_from(cx.waker()),
+                None => state.1 = Some(cx.waker().clone()),
+            }
+            Poll::Pending
+        }
+    }
+}
+
+#[cfg(target_family = "wasm")]
+mod imp {
+    use std::time::Duration;
+
+    use js_sys::{Function, Reflect};
+    use wasm_bindgen::{JsCast, JsValue, closure::Closure};
+
+    pub(super) async fn sleep(duration: Duration) -> bool {
+        let (tx, rx) = async_channel::bounded::<()>(1);
+        let callback = Closure::once_into_js(move || {
+            let _ = tx.try_send(());
+        });
+        let scheduled = Reflect::get(&js_sys::global(), &JsValue::from_str("setTimeout"))
+            .ok()
+            .and_then(|set_timeout| set_timeout.dyn_into::<Function>().ok())
+            .is_some_and(|set_timeout| {
+                let millis = JsValue::from(duration.as_millis() as f64);
+                set_timeout
+                    .call2(&JsValue::UNDEFINED, &callback, &millis)
+                    .is_ok()
+            });
+        scheduled && rx.recv().await.is_ok()
+    }
+}
+
+#[cfg(all(test, not(target_family = "wasm")))]
+mod tests {
+    use std::time::{Duration, Instant};
+
+    use super::sleep;
+
+    #[tokio::test(flavor = "multi_thread")]
+    async fn test_sleeps_wake_in_deadline_order() {
+        let start = Instant::now();
+        let (long, short) = tokio::join!(
+            async {
+                assert!(sleep(Duration::from_millis(60)).await);
+                start.elapsed()
+            },
+            async {
+                assert!(sleep(Duration::from_millis(20)).await);
+                start.elapsed()
+            },
+        );
+        assert!(short >= Duration::from_millis(20), "{short:?}");
+        assert!(long >= Duration::from_millis(60), "{long:?}");
+        assert!(short < long);
+    }
+}
@@ -19,6 +19,35 @@ pub enum TextureFormat {
     Dxt1,
 }
 
+/// Transfer statistics for a single fetch, for callers that pace or
+/// instrument their request stream.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct FetchInfo {
+    /// Size of the encoded response body in bytes (before protobuf decoding).
+    pub bytes: usize,
+    /// Whether the response was served from the cache rather than the network.
+    pub cache_hit: bool,
+    /// Whether the response was shared from another caller's identical
+    /// request already in flight, so this caller added no traffic.
+    pub coalesced: bool,
+    /// Transient failures retried before the fetch succeeded.
+    pub retries: u32,
+}
+
+/// How urgently a request is needed, which decides how hard the client
+/// retries it (see [`RetryPolicy`](crate::RetryPolicy)).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum FetchPriority {
+    /// Speculative work (prefetching): retried at most once, with the
+    /// longest backoff.
+    Low,
+    /// Ordinary streaming.
+    #[default]
+    Normal,
+    /// Needed now (collision coverage, bootstrap metadata): retried soonest.
+    High,
+}
+
 /// A decoded mesh ready for rendering.
 #[derive(Debug, Clone)]
 pub struct Mesh {
@@ -32,7 +61,7 @@ pub struct Mesh {
     /// These are the original normals from Google Earth, ensuring seamless
     /// lighting across tile boundaries.
     pub normals: Vec<[f32; 3]>,
-    /// Texture pixel data.
+    /// Texture pixel data: every mip level, largest first.
     pub texture_data: Vec<u8>,
     /// Texture format.
     pub texture_format: TextureFormat,
@@ -40,6 +69,8 @@ pub struct Mesh {
     pub texture_width: u32,
     /// Texture height in pixels.
     pub texture_height: u32,
+    /// Mip levels in [`Self::texture_data`], at least 1.
+    pub texture_mip_levels: u32,
     /// Whether per-vertex octant data (`Vertex::w`) was populated from the protobuf.
     /// When false, all vertices have `w = 0` and per-vertex octant masking should
     /// not be applied (it would incorrectly collapse all vertices).
@@ -113,23 +144,38 @@ pub struct BulkRequest {
     pub path: OctreePath,
     /// The epoch for this bulk.
     pub epoch: u32,
+    /// How hard to retry the request on transient failures.
+    pub priority: FetchPriority,
 }
 
 impl BulkRequest {
     /// Create a new bulk request.
     #[must_use]
     pub fn new(path: OctreePath, epoch: u32) -> Self {
-        Self { path, epoch }
+        Self {
+            path,
+            epoch,
+            priority: FetchPriority::Normal,
+        }
     }
 
-    /// Create a request for the root bulk.
+    /// Create a request for the root bulk. Everything else hangs off it,
+    /// so it is fetched at [`FetchPriority::High`].
     #[must_use]
     pub fn root(epoch: u32) -> Self {
         Self {
             path: OctreePath::ROOT,
             epoch,
+            priority: FetchPriority::High,
         }
     }
+
+    /// Set the request's priority.
+    #[must_use]
+    pub fn with_priority(mut self, priority: FetchPriority) -> Self {
+        self.priority = priority;
+        self
+    }
 }
 
 /// Request parameters for fetching node data.
@@ -143,6 +189,13 @@ pub struct NodeRequest {
     pub texture_format: i32,
     /// Imagery epoch (optional).
     pub imagery_epoch: Option<u32>,
+    /// Keep CRN-DXT1 textures block-compressed ([`TextureFormat::Dxt1`])
+    /// instead of expanding them to RGBA. Only set this when the GPU can
+    /// sample BC1. Doesn't affect the request URL, so cached responses are
+    /// shared either way.
+    pub block_compressed_textures: bool,
+    /// How hard to retry the request on transient failures.
+    pub priority: FetchPriority,
 }
 
 impl NodeRequest {
@@ -159,8 +212,24 @@ impl NodeRequest {
             epoch,
             texture_format,
             imagery_epoch,
+            block_compressed_textures: false,
+            priority: FetchPriority::Normal,
         }
     }
+
+    /// Set whether CRN-DXT1 textures stay block-compressed.
+    #[must_use]
+    pub fn with_block_compressed_textures(mut self, enabled: bool) -> Self {
+        self.block_compressed_textures = enabled;
+        self
+    }
+
+    /// Set the request's priority.
+    #[must_use]
+    pub fn with_priority(mut self, priority: FetchPriority) -> Self {
+        self.priority = priority;
+        self
+    }
 }
 
 /// A frustum for culling nodes based on their OBBs.
@@ -249,6 +318,35 @@ impl Frustum {
         }
         true
     }
+
+    /// How far the OBB is from flipping [`Self::intersects_obb`], as the
+    /// smallest change in plane distance (m) that could do it.
+    ///
+    /// For a box that passes, the slack on its tightest plane; for one that
+    /// fails, how far it sits behind the plane it fails worst, since every
+    /// failing plane must be cleared before it passes. Callers caching the
+    /// test across frames compare this against how far the planes have moved.
+    #[must_use]
+    pub fn obb_margin(&self, obb: &OrientedBoundingBox) -> f64 {
+        let mut inside_slack = f64::INFINITY;
+        let mut outside_depth = 0.0_f64;
+        for &(normal, distance) in &self.planes {
+            let r = obb.extents.x * (obb.orientation.col(0).dot(normal)).abs()
+                + obb.extents.y * (obb.orientation.col(1).dot(normal)).abs()
+                + obb.extents.z * (obb.orientation.col(2).dot(normal)).abs();
+            let slack = normal.dot(obb.center) + distance + r;
+            if slack < 0.0 {
+                outside_depth = outside_depth.max(-slack);
+            } else {
+                inside_slack = inside_slack.min(slack);
+            }
+        }
+        if outside_depth > 0.0 {
+            outside_depth
+        } else {
+            inside_slack
+        }
+    }
 }
 
 /// Screen-space error metric for LOD decisions.
@@ -289,6 +387,14 @@ impl LodMetrics {
         let error = f64::from(meters_per_texel) * self.pixels_per_meter / distance;
         error > self.error_threshold
     }
+
+    /// Camera distance (m) below which [`Self::should_refine`] holds for a
+    /// node of this texel size. How far a node's distance is from this is
+    /// how far the camera must move before its refinement decision flips.
+    #[must_use]
+    pub fn refine_distance(&self, meters_per_texel: f32) -> f64 {
+        f64::from(meters_per_texel) * self.pixels_per_meter / self.error_threshold
+    }
 }
 
 #[cfg(test)]
@@ -336,4 +442,39 @@ mod tests {
         // Far node with small texels should not refine.
         assert!(!metrics.should_refine(DVec3::new(100000.0, 0.0, 0.0), 0.1));
     }
+
+    #[test]
+    fn test_lod_refine_distance_matches_should_refine() {
+        let metrics = LodMetrics::new(DVec3::ZERO, std::f64::consts::FRAC_PI_2, 1080.0);
+        let d = metrics.refine_distance(2.0);
+        assert!(metrics.should_refine(DVec3::new(d * 0.99, 0.0, 0.0), 2.0));
+        assert!(!metrics.should_refine(DVec3::new(d * 1.01, 0.0, 0.0), 2.0));
+    }
+
+    #[test]
+    fn test_frustum_obb_margin() {
+        // Looking down -Z from the origin with a 90° frustum.
+        let proj = DMat4::perspective_rh(std::f64::consts::FRAC_PI_2, 1.0, 0.1, 1000.0);
+        let frustum = Frustum::from_matrix(proj);
+        let obb = |z: f64, x: f64| OrientedBoundingBox {
+            center: DVec3::new(x, 0.0, z),
+            extents: DVec3::ONE,
+            orientation: glam::DMat3::IDENTITY,
+        };
+
+        // Well inside: visible with slack on every plane.
+        let inside = obb(-100.0, 0.0);
+        assert!(frustum.intersects_obb(&inside));
+        assert!(frustum.obb_margin(&inside) > 1.0);
+
+        // Behind the camera: invisible, by about its distance behind.
+        let behind = obb(50.0, 0.0);
+        assert!(!frustum.intersects_obb(&behind));
+        assert!(frustum.obb_margin(&behind) > 40.0);
+
+        // Straddling the left plane: visible but with little slack.
+        let edge = obb(-100.0, -100.0 - 1.0);
+        assert!(frustum.intersects_obb(&edge));
+        assert!(frustum.obb_margin(&edge) < 2.0);
+    }
 }
@@ -0,0 +1,290 @@
+//! A flat binary layout for decoded nodes, so a node decoded in one place can
+//! be handed to another as a single byte buffer.
+//!
+//! Used by the web build's decode workers (see `crate::workers`), whose
+//! results cross back to the page as one transferable `ArrayBuffer` each.
+//! Everything is little-endian; texture bytes are copied verbatim, so
+//! unpacking a node costs about one copy of it.
+
+use glam::{DMat3, DMat4, DVec3, Vec2};
+use rocktree_decode::{OctreePath, OrientedBoundingBox, UvTransform, Vertex};
+
+use crate::types::{Mesh, Node, TextureFormat};
+
+/// Layout tag and version.
+const MAGIC: [u8; 4] = *b"RTN\x02";
+
+/// Pack a node for [`decode_node`].
+#[must_use]
+pub fn encode_node(node: &Node) -> Vec<u8> {
+    let body: usize = node
+        .meshes
+        .iter()
+        .map(|m| {
+            MESH_HEADER_LEN
+                + m.vertices.len() * 8
+                + m.indices.len() * 2
+                + m.normals.len() * 12
+                + m.texture_data.len()
+        })
+        .sum();
+    let mut bytes = Vec::with_capacity(NODE_HEADER_LEN + body);
+    bytes.extend_from_slice(&MAGIC);
+    let path = node.path.to_string();
+    bytes.push(path.len() as u8);
+    bytes.extend_from_slice(path.as_bytes());
+    for c in node.matrix_globe_from_mesh.to_cols_array() {
+        bytes.extend_from_slice(&c.to_le_bytes());
+    }
+    bytes.extend_from_slice(&node.meters_per_texel.to_le_bytes());
+    let obb = &node.obb;
+    for c in obb
+        .center
+        .to_array()
+        .into_iter()
+        .chain(obb.extents.to_array())
+        .chain(obb.orientation.to_cols_array())
+    {
+        bytes.extend_from_slice(&c.to_le_bytes());
+    }
+    bytes.extend_from_slice(&(node.meshes.len() as u32).to_le_bytes());
+
+    for mesh in &node.meshes {
+        for n in [
+            mesh.vertices.len(),
+            mesh.indices.len(),
+            mesh.normals.len(),
+            mesh.texture_data.len(),
+        ] {
+            bytes.extend_from_slice(&(n as u32).to_le_bytes());
+        }
+        bytes.push(match mesh.texture_format {
+            TextureFormat::Rgb => 0,
+            TextureFormat::Rgba => 1,
+            TextureFormat::Dxt1 => 2,
+        });
+        bytes.push(u8::from(mesh.has_octant_data));
+        bytes.extend_from_slice(&mesh.texture_width.to_le_bytes());
+        bytes.extend_from_slice(&mesh.texture_height.to_le_bytes());
+        bytes.extend_from_slice(&mesh.texture_mip_levels.to_le_bytes());
+        let uv = &mesh.uv_transform;
+        for c in uv.offset.to_array().into_iter().chain(uv.scale.to_array()) {
+            bytes.extend_from_slice(&c.to_le_bytes());
+        }
+        for v in &mesh.vertices {
+            bytes.extend_from_slice(&[v.x, v.y, v.z, v.w]);
+            bytes.extend_from_slice(&v.u().to_le_bytes());
+            bytes.extend_from_slice(&v.v().to_le_bytes());
+        }
+        for i in &mesh.indices {
+            bytes.extend_from_slice(&i.to_le_bytes());
+        }
+        for c in mesh.normals.as_flattened() {
+            bytes.extend_from_slice(&c.to_le_bytes());
+        }
+        bytes.extend_from_slice(&mesh.texture_data);
+    }
+    bytes
+}
+
+/// Fixed part of a node: magic, path length, matrix, texel size, OBB, mesh
+/// count (the path's digits follow its length).
+const NODE_HEADER_LEN: usize = 4 + 1 + 16 * 8 + 4 + 15 * 8 + 4;
+/// Fixed part of a mesh: four counts, format, octant flag, texture size and
+/// mip level count, and the UV transform.
+const MESH_HEADER_LEN: usize = 4 * 4 + 2 + 3 * 4 + 4 * 4;
+
+/// Unpack a node from [`encode_node`]. `None` for anything else: another
+/// layout version, a truncated buffer, or trailing bytes.
+#[must_use]
+pub fn decode_node(bytes: &[u8]) -> Option<Node> {
+    let mut r = Reader(bytes);
+    if r.take(4)? != MAGIC {
+        return None;
+    }
+    let path_len = usize::from(r.u8()?);
+    let path = OctreePath::parse(std::str::from_utf8(r.take(path_len)?).ok()?).ok()?;
+    let matrix_globe_from_mesh = DMat4::from_cols_array(&r.f64s()?);
+    let meters_per_texel = r.f32()?;
+    let [center, extents] = [r.f64s::<3>()?, r.f64s::<3>()?].map(DVec3::from_array);
+    let orientation = DMat3::from_cols_array(&r.f64s()?);
+    let mesh_count = r.u32()? as usize;
+
+    // Every mesh needs its header at least, so a bogus count fails here
+    // rather than reserving for it.
+    let mut meshes = Vec::with_capacity(mesh_count.min(r.0.len() / MESH_HEADER_LEN));
+    for _ in 0..mesh_count {
+        let [vertices, indices, normals, texture] = [r.u32()?, r.u32()?, r.u32()?, r.u32()?];
+        let texture_format = match r.u8()? {
+            0 => TextureFormat::Rgb,
+            1 => TextureFormat::Rgba,
+            2 => TextureFormat::Dxt1,
+            _ => return None,
+        };
+        let has_octant_data = r.u8()? != 0;
+        let (texture_width, texture_height) = (r.u32()?, r.u32()?);
+        let texture_mip_levels = r.u32()?;
+        let [ox, oy, sx, sy] = [r.f32()?, r.f32()?, r.f32()?, r.f32()?];
+        let vertices = r
+            .take((vertices as usize).checked_mul(8)?)?
+            .chunks_exact(8)
+            .map(|v| Vertex {
+                x: v[0],
+                y: v[1],
+                z: v[2],
+                w: v[3],
+                u: u16::from_le_bytes([v[4], v[5]]),
+                v: u16::from_le_bytes([v[6], v[7]]),
+            })
+            .collect();
+        let indices = r
+            .take((indices as usize).checked_mul(2)?)?
+            .chunks_exact(2)
+            .map(|i| u16::from_le_bytes([i[0], i[1]]))
+            .collect();
+        let normals = r
+            .take((normals as usize).checked_mul(12)?)?
+            .chunks_exact(12)
+            .map(|n| {
+                let c = |at: usize| f32::from_le_bytes(n[at..at + 4].try_into().unwrap());
+                [c(0), c(4), c(8)]
+            })
+            .collect();
+        let texture_data = r.take(texture as usize)?.to_vec();
+        meshes.push(Mesh {
+            vertices,
+            indices,
+            uv_transform: UvTransform {
+                offset: Vec2::new(ox, oy),
+                scale: Vec2::new(sx, sy),
+            },
+            normals,
+            texture_data,
+            texture_format,
+            texture_width,
+            texture_height,
+            texture_mip_levels,
+            has_octant_data,
+        });
+    }
+    if !r.0.is_empty() {
+        return None;
+    }
+    Some(Node {
+        path,
+        matrix_globe_from_mesh,
+        meters_per_texel,
+        obb: OrientedBoundingBox {
+            center,
+            extents,
+            orientation,
+        },
+        meshes,
+    })
+}
+
+/// Reads little-endian fields off the front of a buffer.
+struct Reader<'a>(&'a [u8]);
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, n: usize) -> Option<&'a [u8]> {
+        let (head, rest) = self.0.split_at_checked(n)?;
+        self.0 = rest;
+        Some(head)
+    }
+
+    fn u8(&mut self) -> Option<u8> {
+        Some(self.take(1)?[0])
+    }
+
+    fn u32(&mut self) -> Option<u32> {
+        Some(u32::from_le_bytes(self.take(4)?.try_into().ok()?))
+    }
+
+    fn f32(&mut self) -> Option<f32> {
+        Some(f32::from_le_bytes(self.take(4)?.try_into().ok()?))
+    }
+
+    fn f64s<const N: usize>(&mut self) -> Option<[f64; N]> {
+        let bytes = self.take(N * 8)?;
+        Some(std::array::from_fn(|i| {
+            f64::from_le_bytes(bytes[i * 8..i * 8 + 8].try_into().unwrap())
+        }))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn node() -> Node {
+        let mesh = Mesh {
+            vertices: vec![
+                Vertex {
+                    x: 1,
+                    y: 2,
+                    z: 3,
+                    w: 4,
+                    u: 500,
+                    v: 60000,
+                };
+                3
+            ],
+            indices: vec![0, 1, 2],
+            uv_transform: UvTransform {
+                offset: Vec2::new(0.5, 0.25),
+                scale: Vec2::new(2.0, 4.0),
+            },
+            normals: vec![[0.0, 0.0, 1.0]; 3],
+            texture_data: vec![7; 48],
+            texture_format: TextureFormat::Rgb,
+            texture_width: 4,
+            texture_height: 4,
+            texture_mip_levels: 1,
+            has_octant_data: true,
+        };
+        Node {
+            path: OctreePath::parse("30604").unwrap(),
+            matrix_globe_from_mesh: DMat4::from_translation(DVec3::new(1.0, 2.0, 3.0)),
+            meters_per_texel: 1.5,
+            obb: OrientedBoundingBox {
+                center: DVec3::new(6.0e6, 1.0, -2.0),
+                extents: DVec3::splat(10.0),
+                orientation: DMat3::IDENTITY,
+            },
+            meshes: vec![mesh.clone(), mesh],
+        }
+    }
+
+    #[test]
+    fn nodes_round_trip() {
+        let original = node();
+        let decoded = decode_node(&encode_node(&original)).unwrap();
+        assert_eq!(decoded.path, original.path);
+        assert_eq!(
+            decoded.matrix_globe_from_mesh,
+            original.matrix_globe_from_mesh
+        );
+        assert_eq!(decoded.obb.center, original.obb.center);
+        assert_eq!(decoded.meshes.len(), 2);
+        let (a, b) = (&decoded.meshes[1], &original.meshes[1]);
+        assert_eq!(a.vertices, b.vertices);
+        assert_eq!(a.indices, b.indices);
+        assert_eq!(a.normals, b.normals);
+        assert_eq!(a.texture_data, b.texture_data);
+        assert_eq!(a.uv_transform.scale, b.uv_transform.scale);
+        assert!(a.has_octant_data);
+    }
+
+    #[test]
+    fn damaged_buffers_are_rejected() {
+        let bytes = encode_node(&node());
+        assert!(decode_node(&bytes[..bytes.len() - 1]).is_none());
+        let mut longer = bytes.clone();
+        longer.push(0);
+        assert!(decode_node(&longer).is_none());
+        let mut other = bytes;
+        other[3] = 1;
+        assert!(decode_node(&other).is_none());
+    }
+}
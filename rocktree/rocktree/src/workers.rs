@@ -0,0 +1,266 @@
+//! Decode workers for the web build.
+//!
+//! The browser runs the app on its main thread, so decoding a node's
+//! protobuf, textures and meshes there stalls frames. [`start`] spawns a pool
+//! of module workers, each running its own instance of the `rocktree-worker`
+//! decoder, and [`Client::fetch_node`](crate::Client::fetch_node) hands every
+//! fetched response to the least busy one. The response goes to the worker
+//! and the decoded node (packed by [`crate::wire`]) comes back as transferred
+//! `ArrayBuffer`s, so neither crossing copies between threads; each costs one
+//! copy between the buffer and wasm memory.
+//!
+//! Fetching stays on the page: the browser's fetch already runs off the main
+//! thread, and the client's cache, retries and request coalescing live here.
+//! Without a pool, or once its workers have failed (say, a dev server that
+//! doesn't serve the worker script, a decoder that fails to instantiate, or
+//! a job that hangs past [`JOB_TIMEOUT`]), nodes are decoded on the page as
+//! before.
+
+use std::{
+    cell::RefCell, collections::HashMap, future::Future, pin::pin, task::Poll, time::Duration,
+};
+
+use js_sys::{Array, ArrayBuffer, Object, Reflect, Uint8Array};
+use rocktree_decode::OctreePath;
+use wasm_bindgen::{JsCast, JsValue, closure::Closure};
+use web_sys::{Event, MessageEvent, Worker, WorkerOptions, WorkerType};
+
+use crate::{
+    error::{Error, Result},
+    timer,
+    types::Node,
+    wire,
+};
+
+/// What a job resolves to: the decoded node or the worker's decode error, or
+/// `None` when the worker went away and the caller should decode itself.
+type Outcome = Option<Result<Node>>;
+
+/// How long a job may wait for its worker before the worker is taken for
+/// hung and retired. Decodes take milliseconds, so this only trips on a
+/// wedged worker, never on a slow tile.
+const JOB_TIMEOUT: Duration = Duration::from_secs(10);
+
+thread_local! {
+    static POOL: RefCell<Option<Pool>> = const { RefCell::new(None) };
+}
+
+struct Pool {
+    workers: Vec<PoolWorker>,
+    /// Jobs posted and not yet answered, by id, with the worker holding them.
+    pending: HashMap<u32, (usize, async_channel::Sender<Outcome>)>,
+    next_id: u32,
+}
+
+struct PoolWorker {
+    worker: Worker,
+    /// Jobs posted to this worker and not yet answered.
+    busy: usize,
+    /// Cleared once the worker fails to load or crashes.
+    alive: bool,
+    // The worker's event handlers, which must outlive it.
+    _on_message: Closure<dyn FnMut(MessageEvent)>,
+    _on_error: Closure<dyn FnMut(Event)>,
+}
+
+/// Start `count` decode workers from the module script at `script_url`,
+/// which loads `rocktree-worker` (`decode_worker.js` in the web build). Does
+/// nothing if a pool is already running.
+///
+/// # Errors
+///
+/// Returns an error if the browser refuses to create a worker.
+pub fn start(script_url: &str, count: usize) -> Result<()> {
+    if POOL.with_borrow(Option::is_some) {
+        return Ok(());
+    }
+    let options = WorkerOptions::new();
+    options.set_type(WorkerType::Module);
+    let mut workers: Vec<PoolWorker> = Vec::with_capacity(count.max(1));
+    for index in 0..count.max(1) {
+        let worker = match Worker::new_with_options(script_url, &options) {
+            Ok(worker) => worker,
+            Err(e) => {
+                for started in &workers {
+                    started.worker.terminate();
+                }
+                return Err(Error::InvalidData {
+                    context: "decode worker",
+                    detail: format!("{e:?}"),
+                });
+            }
+        };
+        let on_message = Closure::<dyn FnMut(MessageEvent)>::new(move |event: MessageEvent| {
+            finish(index, &event.data());
+        });
+        let on_error = Closure::<dyn FnMut(Event)>::new(move |_: Event| fail(index));
+        worker.set_onmessage(Some(on_message.as_ref().unchecked_ref()));
+        worker.set_onerror(Some(on_error.as_ref().unchecked_ref()));
+        workers.push(PoolWorker {
+            worker,
+            busy: 0,
+            alive: true,
+            _on_message: on_message,
+            _on_error: on_error,
+        });
+    }
+    tracing::info!("started {} decode worker(s)", workers.len());
+    POOL.set(Some(Pool {
+        workers,
+        pending: HashMap::new(),
+        next_id: 0,
+    }));
+    Ok(())
+}
+
+/// Workers worth starting on this device: one per core beyond the page's
+/// own, between one and four.
+#[must_use]
+pub fn default_count() -> usize {
+    let cores = web_sys::window().map_or(2.0, |window| window.navigator().hardware_concurrency());
+    (cores as usize).saturating_sub(1).clamp(1, 4)
+}
+
+/// Decode a `NodeData` response on a worker, or `None` when no worker can,
+/// leaving it to the caller.
+pub(crate) async fn decode(
+    path: OctreePath,
+    data: &[u8],
+    block_compressed_textures: bool,
+) -> Option<Result<Node>> {
+    let (id, rx) =
+        POOL.with_borrow_mut(|pool| pool.as_mut()?.post(path, data, block_compressed_textures))?;
+    let mut answer = pin!(rx.recv());
+    // No timer means no timeout, which beats an instant one.
+    let mut timeout = pin!(async {
+        if !timer::sleep(JOB_TIMEOUT).await {
+            std::future::pending::<()>().await;
+        }
+    });
+    let answered = std::future::poll_fn(|cx| {
+        if let Poll::Ready(outcome) = answer.as_mut().poll(cx) {
+            return Poll::Ready(Some(outcome.ok().flatten()));
+        }
+        timeout.as_mut().poll(cx).map(|()| None)
+    })
+    .await;
+    match answered {
+        Some(outcome) => outcome,
+        None => {
+            // The worker is stuck on this job or one queued before it, so
+            // the rest of its queue is stuck too: retire it, which hands
+            // every job it holds (this one included) back to the page.
+            let index = POOL.with_borrow(|pool| Some(pool.as_ref()?.pending.get(&id)?.0));
+            if let Some(index) = index {
+                tracing::warn!("decode of {path} timed out after {JOB_TIMEOUT:?}");
+                fail(index);
+            }
+            None
+        }
+    }
+}
+
+impl Pool {
+    /// Post a job to the least busy live worker.
+    fn post(
+        &mut self,
+        path: OctreePath,
+        data: &[u8],
+        block_compressed_textures: bool,
+    ) -> Option<(u32, async_channel::Receiver<Outcome>)> {
+        let (index, slot) = self
+            .workers
+            .iter_mut()
+            .enumerate()
+            .filter(|(_, slot)| slot.alive)
+            .min_by_key(|(_, slot)| slot.busy)?;
+        let id = self.next_id;
+        let buffer = Uint8Array::from(data).buffer();
+        let message = Object::new();
+        for (key, value) in [
+            ("id", JsValue::from(id)),
+            ("path", JsValue::from(path.to_string())),
+            ("blockCompressed", JsValue::from(block_compressed_textures)),
+            ("data", buffer.clone().into()),
+        ] {
+            Reflect::set(&message, &JsValue::from_str(key), &value).ok()?;
+        }
+        slot.worker
+            .post_message_with_transfer(&message, &Array::of1(&buffer))
+            .ok()?;
+        slot.busy += 1;
+        self.next_id = id.wrapping_add(1);
+        let (tx, rx) = async_channel::bounded(1);
+        self.pending.insert(id, (index, tx));
+        Some((id, rx))
+    }
+}
+
+/// Hand a worker's answer to the job waiting on it, or retire the worker if
+/// it reports that its decoder failed to load.
+fn finish(index: usize, data: &JsValue) {
+    let field = |key: &str| Reflect::get(data, &JsValue::from_str(key)).ok();
+    if let Some(error) = field("initError").filter(|error| !error.is_undefined()) {
+        tracing::warn!(
+            "decode worker {index} failed to load its decoder: {}",
+            error.as_string().unwrap_or_default()
+        );
+        fail(index);
+        return;
+    }
+    let Some(id) = field("id").and_then(|id| id.as_f64()) else {
+        return;
+    };
+    let outcome = match field("node").and_then(|node| node.dyn_into::<ArrayBuffer>().ok()) {
+        // An unreadable buffer is the transport's fault, not the node's.
+        Some(node) => wire::decode_node(&Uint8Array::new(&node).to_vec()).map(Ok),
+        None => Some(Err(Error::InvalidData {
+            context: "node data",
+            detail: field("error")
+                .and_then(|e| e.as_string())
+                .unwrap_or_default(),
+        })),
+    };
+    // Send outside the borrow: waking the receiver may run its task.
+    let sender = POOL.with_borrow_mut(|pool| {
+        let pool = pool.as_mut()?;
+        let (_, tx) = pool.pending.remove(&(id as u32))?;
+        let slot = &mut pool.workers[index];
+        slot.busy = slot.busy.saturating_sub(1);
+        Some(tx)
+    });
+    if let Some(tx) = sender {
+        let _ = tx.try_send(outcome);
+    }
+}
+
+/// Retire a worker that failed to load or crashed, handing its jobs back to
+/// their callers to decode themselves.
+fn fail(index: usize) {
+    let senders: Vec<_> = POOL.with_borrow_mut(|pool| {
+        let Some(pool) = pool.as_mut() else {
+            return Vec::new();
+        };
+        let slot = &mut pool.workers[index];
+        if !slot.alive {
+            return Vec::new();
+        }
+        slot.alive = false;
+        slot.busy = 0;
+        slot.worker.terminate();
+        tracing::warn!("decode worker {index} failed; decoding its share on the page");
+        let ids: Vec<u32> = pool
+            .pending
+            .iter()
+            .filter(|(_, (worker, _))| *worker == index)
+            .map(|(id, _)| *id)
+            .collect();
+        ids.iter()
+            .filter_map(|id| pool.pending.remove(id))
+            .map(|(_, tx)| tx)
+            .collect()
+    });
+    for tx in senders {
+        let _ = tx.try_send(None);
+    }
+}
@@ -0,0 +1,68 @@
+#!/bin/sh
+# Compare the rocktree decode benchmarks against a saved baseline.
+#
+#   scripts/bench_decode.sh save <name>     # record a baseline
+#   scripts/bench_decode.sh compare <name>  # report changes against it
+#
+# Both replay the fixture corpus in rocktree/fixtures (or
+# $ROCKTREE_FIXTURES); record one first with
+# `cargo run --release -p rocktree --example record_fixtures`.
+#
+# The comparison only reports: on shared CI runners a real regression and
+# a noisy neighbour look alike, so it lists what criterion flagged (also to
+# $GITHUB_STEP_SUMMARY in CI) and leaves the call to the reviewer. It fails
+# only if the benchmarks themselves do.
+set -e
+mode="$1"
+name="${2:-base}"
+# Only flag changes well above the runners' noise.
+args="--noplot --noise-threshold 0.05"
+
+# Name the bench targets so the library test harnesses don't see the
+# criterion flags.
+bench() {
+    cargo bench -p rocktree-decode --bench unpack -- $args "$@"
+    cargo bench -p rocktree --bench decode -- $args "$@"
+}
+
+# The benchmarks criterion flagged as "regressed" or "improved", one per
+# line. A result's name is the last unindented line before it.
+flagged() {
+    awk -v verdict="$1" '
+        /^[^ \t]/ && !/^(Benchmarking|Found|Warning|Gnuplot)/ { name = $1 }
+        $0 ~ "Performance has " verdict { print "- " name }
+    ' bench_output.txt
+}
+
+case "$mode" in
+save)
+    bench --save-baseline "$name"
+    ;;
+compare)
+    status=0
+    # Lenient: a benchmark the baseline lacks (new, or a base branch without
+    # these benchmarks) is reported without a change rather than failing.
+    bench --baseline-lenient "$name" > bench_output.txt 2>&1 || status=$?
+    cat bench_output.txt
+    [ "$status" -eq 0 ] || exit "$status"
+    {
+        echo "### Decode benchmarks against '$name'"
+        echo
+        echo "Report only: shared runners are noisy, so rerun before reading much into a change."
+        echo
+        echo "Regressed:"
+        flagged regressed
+        echo
+        echo "Improved:"
+        flagged improved
+    } > bench_summary.md
+    cat bench_summary.md
+    if [ -n "$GITHUB_STEP_SUMMARY" ]; then
+        cat bench_summary.md >> "$GITHUB_STEP_SUMMARY"
+    fi
+    ;;
+*)
+    echo "usage: $0 save|compare [baseline]" >&2
+    exit 2
+    ;;
+esac
@@ -8,9 +8,21 @@ wasm-bindgen \
     --out-name "veldera" \
     ./target/wasm32-unknown-unknown/release/veldera.wasm
 
+# The decode workers' module and their bootstrap script, loaded from next to
+# index.html (see rocktree::workers). Without them the page decodes tiles itself.
+cargo build --release -p rocktree-worker --target wasm32-unknown-unknown
+wasm-bindgen \
+    --no-typescript \
+    --target web \
+    --out-dir ./build/ \
+    --out-name "rocktree_worker" \
+    ./target/wasm32-unknown-unknown/release/rocktree_worker.wasm
+cp rocktree/rocktree-worker/decode_worker.js build/
+
 # Optimize WASM if wasm-opt is available.
 if command -v wasm-opt > /dev/null 2>&1; then
     wasm-opt -Oz -o build/veldera_bg.wasm build/veldera_bg.wasm
+    wasm-opt -O3 -o build/rocktree_worker_bg.wasm build/rocktree_worker_bg.wasm
 fi
 
 # Copy runtime assets next to the page. Bevy fetches assets over HTTP from
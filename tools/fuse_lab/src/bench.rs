@@ -0,0 +1,663 @@
+//! `--bench` mode: run every collider algorithm over a directory of tile dumps
+//! and report what each costs, so a change to any of them can be A/B'd offline
+//! (in-game, `veldera_terrain::collider::COLLIDER` is a compile-time constant)
+//! and tracked across commits.
+//!
+//! ```text
+//! fuse-lab --bench <dump_dir> <report.json>
+//! ```
+//!
+//! Every `*.json` dump in the directory is decoded up front; then each
+//! algorithm in turn builds the whole corpus, in parallel over dumps and tiles.
+//! The algorithms run one after another so each one's wall time and peak
+//! resident memory are its own. Per algorithm and dump it records the time
+//! spent in each stage (summed over the parallel builds, so CPU time rather
+//! than wall time), the output triangle and vertex counts, and the summed
+//! [`BuildStats`]; the same numbers go to `<report.json>` for scripts to diff.
+//!
+//! The algorithms mirror the engine's `ColliderAlgorithm` with its current
+//! settings, built from the pure crate alone:
+//!
+//! - `raw_tiles`: each tile's octant-masked soup plus skirts — no fusion,
+//!   simplification, or carving.
+//! - `osm_roads`: the captured settings in full — clustering, sub-octant
+//!   carving, and fusion against the lateral neighbours. The road
+//!   carve-and-emit layer is left out: it depends on the fitted ribbons, not
+//!   on the tile build.
+//! - `voxel_wrap`: each tile's base soup with its same-depth halo, wrapped
+//!   ([`wrap_soup`]) at the default [`WrapSettings`].
+//! - `height_field` / `octree`: the tiles around the captured camera gathered
+//!   into one soup and extracted whole, reach and voxels as the engine's
+//!   camera-centred tables. The engine cuts the same reach into chunks
+//!   rebuilt as the camera moves; one whole build is the cost of a cold
+//!   start.
+//!
+//! Stages: `cluster` (decode and vertex clustering), `clip` (octant clipping,
+//! carving, sliver filter), `fuse` (surface probes and border fusion),
+//! `contour` (the voxel wrap or the camera-centred extractor, including the
+//! octree's flood, collapse and smoothing and the skirts they grow), and
+//! `skirts` (the per-tile skirts).
+
+use std::{
+    collections::HashMap,
+    error::Error,
+    path::{Path, PathBuf},
+    time::{Duration, Instant},
+};
+
+use glam::{DVec3, Vec2, Vec3};
+use rayon::prelude::*;
+use rocktree::Mesh as RocktreeMesh;
+use serde::Serialize;
+use veldera_terrain_collider::{
+    BuildSettings, BuildStage, BuildStats, BuiltGeometry, NeighbourSurface, SurfaceProbe,
+    TileMeshes, build_tile_geometry_staged,
+    camera_centred::{
+        HEIGHTFIELD, OCTREE, OCTREE_COLLAPSE_ERROR, OCTREE_SKIRT_CELLS, OCTREE_SMOOTH_ITERS,
+        OCTREE_SMOOTH_LAMBDA, SOUP_MARGIN,
+    },
+    dump::{DumpTile, TileSetDump},
+    heightfield::build_height_quadtree,
+    octree3d::{Frame, Octree3d, smooth_mesh},
+    wrap::{WrapInput, WrapSettings, wrap_soup},
+};
+
+use crate::wrap::cell_centre;
+
+/// The engine's collider algorithms, in `ColliderAlgorithm` order.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+enum Algorithm {
+    RawTiles,
+    OsmRoads,
+    VoxelWrap,
+    HeightField,
+    Octree,
+}
+
+impl Algorithm {
+    /// The name the report uses.
+    fn name(self) -> &'static str {
+        match self {
+            Self::RawTiles => "raw_tiles",
+            Self::OsmRoads => "osm_roads",
+            Self::VoxelWrap => "voxel_wrap",
+            Self::HeightField => "height_field",
+            Self::Octree => "octree",
+        }
+    }
+}
+
+const ALGORITHMS: [Algorithm; 5] = [
+    Algorithm::RawTiles,
+    Algorithm::OsmRoads,
+    Algorithm::VoxelWrap,
+    Algorithm::HeightField,
+    Algorithm::Octree,
+];
+
+/// Base-soup settings for the wrap and the camera-centred gather: octant
+/// clipping only, as `veldera_physics::terrain_v3`/`terrain_v4` build it.
+const BASE_SETTINGS: BuildSettings = BuildSettings {
+    min_triangle_height: 0.0,
+    skirt_depth: 0.0,
+    skirt_slope: 0.0,
+    fusion_range: 0.0,
+    simplify_tolerance: 0.0,
+};
+
+/// Milliseconds spent in each build stage.
+#[derive(Clone, Copy, Debug, Default, Serialize)]
+struct StageTimes {
+    cluster: f64,
+    clip: f64,
+    fuse: f64,
+    contour: f64,
+    skirts: f64,
+}
+
+impl StageTimes {
+    fn record(&mut self, stage: BuildStage, spent: Duration) {
+        let ms = spent.as_secs_f64() * 1000.0;
+        match stage {
+            BuildStage::Cluster => self.cluster += ms,
+            BuildStage::Clip => self.clip += ms,
+            BuildStage::Fuse => self.fuse += ms,
+            BuildStage::Skirts => self.skirts += ms,
+        }
+    }
+
+    fn add(&mut self, other: &Self) {
+        self.cluster += other.cluster;
+        self.clip += other.clip;
+        self.fuse += other.fuse;
+        self.contour += other.contour;
+        self.skirts += other.skirts;
+    }
+}
+
+/// What one algorithm's builds over some set of tiles came to.
+#[derive(Clone, Copy, Debug, Default, Serialize)]
+struct Totals {
+    /// Builds that produced geometry.
+    builds: usize,
+    /// Builds that came out empty (everything masked, nothing in reach).
+    empty: usize,
+    stages_ms: StageTimes,
+    triangles: usize,
+    vertices: usize,
+    stats: BuildStats,
+}
+
+impl Totals {
+    fn add(&mut self, other: &Self) {
+        self.builds += other.builds;
+        self.empty += other.empty;
+        self.stages_ms.add(&other.stages_ms);
+        self.triangles += other.triangles;
+        self.vertices += other.vertices;
+        self.stats.octant_axis_fallbacks += other.stats.octant_axis_fallbacks;
+        self.stats.fused_vertices += other.stats.fused_vertices;
+    }
+
+    /// One build's totals: `times` spent, ending in `output` (or nothing).
+    fn build(times: StageTimes, output: Option<(usize, usize)>, stats: BuildStats) -> Self {
+        let (vertices, triangles) = output.unwrap_or_default();
+        Self {
+            builds: usize::from(output.is_some()),
+            empty: usize::from(output.is_none()),
+            stages_ms: times,
+            triangles,
+            vertices,
+            stats,
+        }
+    }
+}
+
+#[derive(Serialize)]
+struct DumpReport {
+    dump: String,
+    #[serde(flatten)]
+    totals: Totals,
+}
+
+#[derive(Serialize)]
+struct AlgorithmReport {
+    algorithm: &'static str,
+    wall_ms: f64,
+    /// Peak resident memory while the algorithm ran, and how far it rose
+    /// above the resident memory it started from (decoded corpus included in
+    /// the former only). Absent off Linux.
+    peak_rss_bytes: Option<u64>,
+    peak_rss_growth_bytes: Option<u64>,
+    totals: Totals,
+    dumps: Vec<DumpReport>,
+}
+
+#[derive(Serialize)]
+struct BenchReport {
+    /// `git rev-parse HEAD` of the working directory, when it is a checkout.
+    revision: Option<String>,
+    threads: usize,
+    dumps: Vec<String>,
+    algorithms: Vec<AlgorithmReport>,
+}
+
+/// One decoded dump of the corpus.
+struct Corpus<'a> {
+    name: &'a str,
+    dump: &'a TileSetDump,
+    tiles: HashMap<&'a str, &'a DumpTile>,
+    meshes: HashMap<&'a str, Vec<RocktreeMesh>>,
+}
+
+/// Run the benchmark over every dump in `dir` and write the report to
+/// `report_path`.
+pub fn run(dir: &str, report_path: &str) -> Result<(), Box<dyn Error>> {
+    let mut paths: Vec<PathBuf> = std::fs::read_dir(dir)?
+        .filter_map(|entry| entry.ok().map(|e| e.path()))
+        .filter(|path| path.extension().is_some_and(|ext| ext == "json"))
+        .collect();
+    paths.sort();
+    if paths.is_empty() {
+        return Err(format!("--bench: no *.json dumps in {dir}").into());
+    }
+
+    let loaded: Vec<(String, TileSetDump)> = paths
+        .par_iter()
+        .map(|path| -> Result<_, String> {
+            let file = std::fs::File::open(path).map_err(|e| format!("{}: {e}", path.display()))?;
+            let dump: TileSetDump = serde_json::from_reader(std::io::BufReader::new(file))
+                .map_err(|e| format!("{}: {e}", path.display()))?;
+            Ok((file_name(path), dump))
+        })
+        .collect::<Result<_, _>>()?;
+    let corpus: Vec<Corpus> = loaded
+        .par_iter()
+        .map(|(name, dump)| Corpus {
+            name,
+            dump,
+            tiles: dump.tiles.iter().map(|t| (t.path.as_str(), t)).collect(),
+            meshes: dump
+                .tiles
+                .iter()
+                .map(|t| {
+                    (
+                        t.path.as_str(),
+                        t.meshes.iter().map(|m| m.to_mesh()).collect(),
+                    )
+                })
+                .collect(),
+        })
+        .collect();
+    let tile_count: usize = corpus.iter().map(|c| c.dump.tiles.len()).sum();
+    println!(
+        "bench: {} dumps, {tile_count} tiles, {} threads",
+        corpus.len(),
+        rayon::current_num_threads()
+    );
+    println!(
+        "\n  {:<12} {:>6} {:>5} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>8}",
+        "algorithm",
+        "builds",
+        "empty",
+        "wall ms",
+        "cluster",
+        "clip",
+        "fuse",
+        "contour",
+        "skirts",
+        "tris",
+        "verts",
+        "peak MB",
+    );
+
+    let mut algorithms = Vec::new();
+    for algorithm in ALGORITHMS {
+        reset_peak_rss();
+        let start_rss = resident_bytes();
+        let start = Instant::now();
+        let dumps: Vec<Totals> = match algorithm {
+            Algorithm::RawTiles | Algorithm::OsmRoads | Algorithm::VoxelWrap => {
+                let jobs: Vec<(usize, &DumpTile)> = corpus
+                    .iter()
+                    .enumerate()
+                    .flat_map(|(i, c)| c.dump.tiles.iter().map(move |t| (i, t)))
+                    .collect();
+                let builds: Vec<(usize, Totals)> = jobs
+                    .par_iter()
+                    .map(|&(i, tile)| (i, build_tile(algorithm, &corpus[i], tile)))
+                    .collect();
+                let mut dumps = vec![Totals::default(); corpus.len()];
+                for (i, totals) in &builds {
+                    dumps[*i].add(totals);
+                }
+                dumps
+            }
+            Algorithm::HeightField | Algorithm::Octree => corpus
+                .par_iter()
+                .map(|c| build_camera_centred(algorithm, c))
+                .collect(),
+        };
+        let wall_ms = start.elapsed().as_secs_f64() * 1000.0;
+        let peak = peak_rss_bytes();
+
+        let mut totals = Totals::default();
+        for dump in &dumps {
+            totals.add(dump);
+        }
+        let s = &totals.stages_ms;
+        println!(
+            "  {:<12} {:>6} {:>5} {wall_ms:>9.1} {:>9.1} {:>9.1} {:>9.1} {:>9.1} {:>9.1} {:>9} {:>9} {:>8}",
+            algorithm.name(),
+            totals.builds,
+            totals.empty,
+            s.cluster,
+            s.clip,
+            s.fuse,
+            s.contour,
+            s.skirts,
+            totals.triangles,
+            totals.vertices,
+            peak.map_or("-".to_string(), |b| format!(
+                "{:.0}",
+                b as f64 / (1024.0 * 1024.0)
+            )),
+        );
+        algorithms.push(AlgorithmReport {
+            algorithm: algorithm.name(),
+            wall_ms,
+            peak_rss_bytes: peak,
+            peak_rss_growth_bytes: peak.zip(start_rss).map(|(p, s)| p.saturating_sub(s)),
+            totals,
+            dumps: corpus
+                .iter()
+                .zip(dumps)
+                .map(|(c, totals)| DumpReport {
+                    dump: c.name.to_string(),
+                    totals,
+                })
+                .collect(),
+        });
+    }
+    println!("  (stage columns are ms summed over parallel builds; wall ms is elapsed)");
+
+    let report = BenchReport {
+        revision: git_revision(),
+        threads: rayon::current_num_threads(),
+        dumps: corpus.iter().map(|c| c.name.to_string()).collect(),
+        algorithms,
+    };
+    let out = std::io::BufWriter::new(std::fs::File::create(report_path)?);
+    serde_json::to_writer_pretty(out, &report)?;
+    println!("\nwrote {report_path}");
+    Ok(())
+}
+
+/// One tile's build through a per-tile algorithm.
+fn build_tile(algorithm: Algorithm, corpus: &Corpus, tile: &DumpTile) -> Totals {
+    let mut times = StageTimes::default();
+    let down = tile.down();
+    let tile_meshes = tile.tile_meshes(&corpus.meshes[tile.path.as_str()], tile.world_position);
+    let neighbours = || {
+        tile.laterals
+            .iter()
+            .filter_map(|l| corpus.tiles.get(l.as_str()))
+            .map(|n| {
+                (
+                    *n,
+                    n.tile_meshes(&corpus.meshes[n.path.as_str()], tile.world_position),
+                )
+            })
+    };
+    let output = |g: &BuiltGeometry| (g.vertices.len(), g.triangles.len());
+
+    match algorithm {
+        Algorithm::RawTiles => {
+            let settings = BuildSettings {
+                fusion_range: 0.0,
+                simplify_tolerance: 0.0,
+                skirt_slope: 0.0,
+                ..corpus.dump.settings.build_settings()
+            };
+            let built = timed_build(
+                &tile_meshes,
+                tile.octant_mask,
+                0,
+                &[],
+                down,
+                &settings,
+                &mut times,
+            );
+            let stats = built.as_ref().map(|g| g.stats).unwrap_or_default();
+            Totals::build(times, built.as_ref().map(output), stats)
+        }
+        Algorithm::OsmRoads => {
+            let settings = corpus.dump.settings.build_settings();
+            let start = Instant::now();
+            let probes: Vec<SurfaceProbe> = if settings.fusion_range > 0.0 {
+                neighbours()
+                    .map(|(_, n)| SurfaceProbe::from_tile(&n, down))
+                    .collect()
+            } else {
+                Vec::new()
+            };
+            times.record(BuildStage::Fuse, start.elapsed());
+            let surfaces: Vec<NeighbourSurface> = probes
+                .iter()
+                .map(|probe| NeighbourSurface {
+                    probe,
+                    offset: Vec3::ZERO,
+                })
+                .collect();
+            let built = timed_build(
+                &tile_meshes,
+                tile.octant_mask,
+                tile.sub_cut,
+                &surfaces,
+                down,
+                &settings,
+                &mut times,
+            );
+            let stats = built.as_ref().map(|g| g.stats).unwrap_or_default();
+            Totals::build(times, built.as_ref().map(output), stats)
+        }
+        Algorithm::VoxelWrap => {
+            let Some(base) = timed_build(
+                &tile_meshes,
+                tile.octant_mask,
+                tile.sub_cut,
+                &[],
+                down,
+                &BASE_SETTINGS,
+                &mut times,
+            ) else {
+                return Totals::build(times, None, BuildStats::default());
+            };
+            let mut stats = base.stats;
+            let mut halo_vertices: Vec<Vec3> = Vec::new();
+            let mut halo_triangles: Vec<[u32; 3]> = Vec::new();
+            let mut neighbour_centres: Vec<Vec3> = Vec::new();
+            for (neighbour, meshes) in neighbours().filter(|(n, _)| n.depth == tile.depth) {
+                let Some(soup) = timed_build(
+                    &meshes,
+                    neighbour.octant_mask,
+                    0,
+                    &[],
+                    down,
+                    &BASE_SETTINGS,
+                    &mut times,
+                ) else {
+                    continue;
+                };
+                stats.octant_axis_fallbacks += soup.stats.octant_axis_fallbacks;
+                neighbour_centres.push(cell_centre(neighbour) + meshes.offset);
+                let base_index = halo_vertices.len() as u32;
+                halo_vertices.extend(soup.vertices);
+                halo_triangles.extend(
+                    soup.triangles
+                        .iter()
+                        .map(|&[a, b, c]| [a + base_index, b + base_index, c + base_index]),
+                );
+            }
+            let start = Instant::now();
+            let wrapped = wrap_soup(
+                &WrapInput {
+                    vertices: &base.vertices,
+                    triangles: &base.triangles,
+                    halo_vertices: &halo_vertices,
+                    halo_triangles: &halo_triangles,
+                    down,
+                    world_position: DVec3::from_array(tile.world_position),
+                    cell_centre: cell_centre(tile),
+                    neighbour_centres: &neighbour_centres,
+                },
+                &WrapSettings::default(),
+            );
+            times.contour += start.elapsed().as_secs_f64() * 1000.0;
+            let output = (!wrapped.triangles.is_empty())
+                .then(|| (wrapped.vertices.len(), wrapped.triangles.len()));
+            Totals::build(times, output, stats)
+        }
+        Algorithm::HeightField | Algorithm::Octree => {
+            unreachable!("camera-centred algorithms build per dump")
+        }
+    }
+}
+
+/// One dump's camera-centred surface: gather the tiles in reach into one
+/// camera-frame soup, in parallel, then extract it.
+fn build_camera_centred(algorithm: Algorithm, corpus: &Corpus) -> Totals {
+    let camera = corpus.dump.camera_position;
+    let down = -DVec3::from_array(camera).normalize_or_zero().as_vec3();
+    let up = -down;
+    let reach = HEIGHTFIELD.radius;
+    let keep = reach + SOUP_MARGIN;
+    let frame = Frame::new(up);
+
+    let gathered: Vec<(StageTimes, Option<BuiltGeometry>)> = corpus
+        .dump
+        .tiles
+        .par_iter()
+        .filter(|tile| {
+            // Bounding sphere against the kept square's circumcircle; the
+            // per-triangle filter below does the exact cut.
+            let offset = DVec3::from_array(tile.world_position) - DVec3::from_array(camera);
+            let half = (Vec3::from_array(tile.scale) * 127.5).length();
+            (offset.as_vec3() + cell_centre(tile)).length() - half
+                <= keep * std::f32::consts::SQRT_2
+        })
+        .map(|tile| {
+            let mut times = StageTimes::default();
+            let meshes = tile.tile_meshes(&corpus.meshes[tile.path.as_str()], camera);
+            let built = timed_build(
+                &meshes,
+                tile.octant_mask,
+                0,
+                &[],
+                down,
+                &BASE_SETTINGS,
+                &mut times,
+            );
+            (times, built)
+        })
+        .collect();
+
+    let mut times = StageTimes::default();
+    let mut stats = BuildStats::default();
+    let mut soup_vertices: Vec<Vec3> = Vec::new();
+    let mut soup_triangles: Vec<[u32; 3]> = Vec::new();
+    for (tile_times, built) in gathered {
+        times.add(&tile_times);
+        let Some(soup) = built else {
+            continue;
+        };
+        stats.octant_axis_fallbacks += soup.stats.octant_axis_fallbacks;
+        let base_index = soup_vertices.len() as u32;
+        let reaches_in = |&[a, b, c]: &[u32; 3]| {
+            let (lo, hi) =
+                [a, b, c]
+                    .iter()
+                    .fold((Vec2::INFINITY, Vec2::NEG_INFINITY), |(lo, hi), &i| {
+                        let p = frame.to_frame(soup.vertices[i as usize]).truncate();
+                        (lo.min(p), hi.max(p))
+                    });
+            lo.cmple(Vec2::splat(keep)).all() && hi.cmpge(Vec2::splat(-keep)).all()
+        };
+        soup_triangles.extend(
+            soup.triangles
+                .iter()
+                .filter(|t| reaches_in(t))
+                .map(|&[a, b, c]| [a + base_index, b + base_index, c + base_index]),
+        );
+        soup_vertices.extend(soup.vertices);
+    }
+    if soup_triangles.is_empty() {
+        return Totals::build(times, None, stats);
+    }
+
+    let start = Instant::now();
+    let (vertices, triangles) = match algorithm {
+        Algorithm::HeightField => {
+            build_height_quadtree(&soup_vertices, &soup_triangles, up, &HEIGHTFIELD)
+        }
+        _ => {
+            let mut octree = Octree3d::build(&soup_vertices, &soup_triangles, up, &OCTREE);
+            let (vertices, triangles) =
+                octree.dual_contour_collapsed(OCTREE_COLLAPSE_ERROR, OCTREE_SKIRT_CELLS);
+            let vertices = smooth_mesh(
+                &vertices,
+                &triangles,
+                OCTREE_SMOOTH_ITERS,
+                OCTREE_SMOOTH_LAMBDA,
+            );
+            let keep = reach + OCTREE.far_voxel;
+            let triangles: Vec<[u32; 3]> = triangles
+                .into_iter()
+                .filter(|&[a, b, c]| {
+                    let centroid =
+                        (vertices[a as usize] + vertices[b as usize] + vertices[c as usize]) / 3.0;
+                    let p = frame.to_frame(centroid).truncate();
+                    p.x.abs() <= keep && p.y.abs() <= keep
+                })
+                .collect();
+            (vertices, triangles)
+        }
+    };
+    times.contour += start.elapsed().as_secs_f64() * 1000.0;
+    let output = (!triangles.is_empty()).then(|| (vertices.len(), triangles.len()));
+    Totals::build(times, output, stats)
+}
+
+/// [`build_tile_geometry_staged`] with each stage's time added to `times`.
+fn timed_build(
+    tile: &TileMeshes,
+    octant_mask: u8,
+    sub_cut: u64,
+    neighbours: &[NeighbourSurface],
+    down: Vec3,
+    settings: &BuildSettings,
+    times: &mut StageTimes,
+) -> Option<BuiltGeometry> {
+    let mut last = Instant::now();
+    build_tile_geometry_staged(
+        tile,
+        octant_mask,
+        sub_cut,
+        neighbours,
+        down,
+        settings,
+        &mut |stage| {
+            let now = Instant::now();
+            times.record(stage, now - last);
+            last = now;
+        },
+    )
+}
+
+fn file_name(path: &Path) -> String {
+    path.file_name().map_or_else(
+        || path.display().to_string(),
+        |n| n.to_string_lossy().into_owned(),
+    )
+}
+
+/// The checked-out commit, for lining reports up against history.
+fn git_revision() -> Option<String> {
+    let output = std::process::Command::new("git")
+        .args(["rev-parse", "HEAD"])
+        .output()
+        .ok()?;
+    output
+        .status
+        .success()
+        .then(|| String::from_utf8_lossy(&output.stdout).trim().to_string())
+}
+
+/// Reset the process's peak-RSS mark to its current RSS, so the next
+/// [`peak_rss_bytes`] covers only what ran since (Linux; a no-op elsewhere).
+fn reset_peak_rss() {
+    let _ = std::fs::write("/proc/self/clear_refs", "5");
+}
+
+/// Peak resident memory since the last [`reset_peak_rss`] (`VmHWM`).
+fn peak_rss_bytes() -> Option<u64> {
+    proc_status_kib("VmHWM:").map(|kib| kib * 1024)
+}
+
+/// Current resident memory (`VmRSS`).
+fn resident_bytes() -> Option<u64> {
+    proc_status_kib("VmRSS:").map(|kib| kib * 1024)
+}
+
+/// A `kB` field of `/proc/self/status`.
+fn proc_status_kib(field: &str) -> Option<u64> {
+    let status = std::fs::read_to_string("/proc/self/status").ok()?;
+    status
+        .lines()
+        .find_map(|line| line.strip_prefix(field))?
+        .trim()
+        .trim_end_matches("kB")
+        .trim()
+        .parse()
+        .ok()
+}
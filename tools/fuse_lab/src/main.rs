@@ -27,6 +27,10 @@
 //! one vertically (both built raw: no masks, no fusion, no skirts) — the
 //! cost, in metres of collider-vs-display error, of running physics at a
 //! coarser LoD than the render.
+//!
+//! `fuse-lab --bench <dump_dir> <report.json>` runs instead over a whole
+//! directory of dumps, timing every collider algorithm stage by stage and
+//! writing the numbers as JSON (see [`bench`]).
 
 use std::{
     collections::{BTreeMap, HashMap},
@@ -42,6 +46,7 @@ use veldera_terrain_collider::{
     dump::{DumpTile, TileSetDump},
 };
 
+mod bench;
 mod planarize;
 mod render;
 mod roads;
@@ -79,6 +84,7 @@ fn main() -> Result<(), Box<dyn Error>> {
     let mut adaptive: Option<(f32, f64, f32, String)> = None;
     let mut heightfield: Option<(f32, f64, String)> = None;
     let mut octree3d: Option<(f32, f64, String)> = None;
+    let mut bench: Option<(String, String)> = None;
     let mut i = 1;
     while i < args.len() {
         match args[i].as_str() {
@@ -233,6 +239,13 @@ fn main() -> Result<(), Box<dyn Error>> {
                 octree3d = Some((voxel.parse()?, radius.parse()?, out.clone()));
                 i += 4;
             }
+            "--bench" => {
+                let need = "--bench needs <dump_dir> <report.json>";
+                let dir = args.get(i + 1).ok_or(need)?;
+                let out = args.get(i + 2).ok_or(need)?;
+                bench = Some((dir.clone(), out.clone()));
+                i += 3;
+            }
             "--winding" => {
                 let voxel = args
                     .get(i + 1)
@@ -253,6 +266,9 @@ fn main() -> Result<(), Box<dyn Error>> {
             other => return Err(format!("unexpected argument: {other}").into()),
         }
     }
+    if let Some((dir, out)) = &bench {
+        return bench::run(dir, out);
+    }
     let dump_path =
         dump_path.ok_or("usage: fuse-lab <dump.json> [--fusion-range <m>] [--obj <dir>]")?;
 
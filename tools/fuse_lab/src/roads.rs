@@ -22,7 +22,7 @@ use rocktree::Mesh as RocktreeMesh;
 use serde::Deserialize;
 use veldera_geo::coords::lat_lon_to_ecef;
 use veldera_terrain_collider::{
-    BuildSettings, BuiltGeometry, SurfaceProbe, build_tile_geometry,
+    BuildSettings, BuiltGeometry, NeighbourSurface, SurfaceProbe, build_tile_geometry,
     dump::{DumpTile, TileSetDump},
     roads::{
         CarveSettings, FitParams, FitSettings, FitWay, FittedRibbon, RibbonStation, RoadRibbon,
@@ -458,13 +458,25 @@ fn build_base(
         .laterals
         .iter()
         .filter_map(|l| tiles.get(l.as_str()))
-        .map(|n| n.tile_meshes(&meshes[n.path.as_str()], tile.world_position))
+        .map(|n| {
+            SurfaceProbe::from_tile(
+                &n.tile_meshes(&meshes[n.path.as_str()], tile.world_position),
+                tile.down(),
+            )
+        })
+        .collect();
+    let surfaces: Vec<NeighbourSurface> = neighbours
+        .iter()
+        .map(|probe| NeighbourSurface {
+            probe,
+            offset: Vec3::ZERO,
+        })
         .collect();
     build_tile_geometry_with_roads(
         &tile_meshes,
         tile.octant_mask,
         tile.sub_cut,
-        &neighbours,
+        &surfaces,
         tile.down(),
         settings,
         roads,
@@ -0,0 +1,479 @@
+//! Headless terrain streaming benchmark.
+//!
+//! Runs the terrain stack ([`DataLoaderPlugin`](veldera_terrain::loader::DataLoaderPlugin),
+//! [`LodPlugin`](veldera_terrain::lod::LodPlugin) and the physics integration
+//! the LoD walk feeds) without a window, replays a camera path against a
+//! frozen copy of the client's tile cache, and reports how long streaming
+//! takes to settle at full detail.
+//!
+//! ```text
+//! stream-bench --cache <pack dir> [--path <path.json>] [--fps 60] [--unpaced] [--json <out>] [--trace]
+//! ```
+//!
+//! The network is out of the loop: the client points at an unreachable host
+//! and never retries, so a tile the snapshot lacks fails at once (and counts
+//! as a cache miss in the stage table) instead of being downloaded. Nothing
+//! is put into the snapshot, which is opened read-only (no replay repairs,
+//! discards, or compaction either), so runs over it stay comparable. Copy the
+//! client's `<OS cache dir>/veldera/rocktree-pack` after flying the route
+//! once; the client must not hold it while the benchmark runs.
+//!
+//! Frames advance the simulated clock by a fixed `1 / fps`, so the camera
+//! visits the same poses on the same frames every run. By default each frame
+//! is also paced to that rate in real time, as in the client; `--unpaced`
+//! runs flat out, which stresses decode throughput instead.
+//!
+//! Each segment (the whole flight, or one teleport stop) ends once streaming
+//! has settled — nothing queued, fetching, spawning or loading bulks, bar
+//! retries of tiles the snapshot lacks — for [`SETTLE_FRAMES`] frames in a
+//! row after the camera stops, or at the timeout. Per segment it reports the time to full detail, peak resident
+//! tiles and bytes, octree-walk time and frame-time percentiles; the run
+//! ends with the tile stage latencies from the profiler.
+
+mod path;
+
+use std::{
+    error::Error,
+    path::PathBuf,
+    time::{Duration, Instant},
+};
+
+use bevy::{
+    app::PluginsState, asset::AssetMetaCheck, log::LogPlugin, mesh::Indices, prelude::*,
+    time::TimeUpdateStrategy, window::ExitCondition,
+};
+use clap::Parser;
+use rocktree::{Client, PackCache, RetryPolicy};
+use serde::Serialize;
+use veldera_engine::{
+    profiler::{self, StageProfile, TraceCapture},
+    world_camera_bundle,
+};
+use veldera_geo::floating_origin::{FloatingOriginCamera, FloatingOriginPlugin};
+use veldera_physics::PhysicsIntegrationPlugin;
+use veldera_terrain::{
+    TerrainPlugins,
+    loader::LoaderState,
+    lod::{LodSnapshot, LodSnapshotRequest, SnapshotCounters},
+};
+
+use crate::path::{CameraPath, Keyframe, Pose, sample};
+
+/// Consecutive settled frames that end a segment, so a frame between one
+/// load finishing and the walk requesting the next doesn't count as done.
+const SETTLE_FRAMES: usize = 30;
+
+/// Base URL every cache miss is sent to: a port nothing listens on, so the
+/// request is refused immediately.
+const OFFLINE_BASE_URL: &str = "http://127.0.0.1:9/";
+
+/// Vertical field of view (degrees), the client's default.
+const FOV_DEG: f32 = 75.0;
+
+#[derive(Parser)]
+#[command(about = "Replay a camera path against a frozen tile cache and time streaming")]
+struct Args {
+    /// Pack cache directory to serve every tile from. Opened read-only, so
+    /// its files are left byte for byte as they were.
+    #[arg(long)]
+    cache: PathBuf,
+    /// Camera path JSON (see `path.rs`); tours the built-in presets if omitted.
+    #[arg(long)]
+    path: Option<PathBuf>,
+    /// Simulated frames per second.
+    #[arg(long, default_value_t = 60.0)]
+    fps: f64,
+    /// Run frames back to back instead of pacing them to `--fps`.
+    #[arg(long)]
+    unpaced: bool,
+    /// Simulated seconds a segment may take to settle after the camera stops.
+    #[arg(long, default_value_t = 120.0)]
+    timeout: f64,
+    /// Viewport the LoD metric sizes tiles against.
+    #[arg(long, default_value_t = 1920)]
+    width: u32,
+    #[arg(long, default_value_t = 1080)]
+    height: u32,
+    /// Also write the report to this file as JSON.
+    #[arg(long)]
+    json: Option<PathBuf>,
+    /// Record a Chrome trace of the run and save it under `traces/`.
+    #[arg(long)]
+    trace: bool,
+}
+
+/// One stretch of the benchmark, measured on its own.
+enum Segment {
+    Flight(Vec<Keyframe>),
+    Stop(String, Pose),
+}
+
+impl Segment {
+    fn name(&self) -> &str {
+        match self {
+            Self::Flight(_) => "flight",
+            Self::Stop(name, _) => name,
+        }
+    }
+
+    /// The camera pose `t` simulated seconds into the segment.
+    fn pose(&self, t: f64) -> Pose {
+        match self {
+            Self::Flight(keyframes) => sample(keyframes, t),
+            Self::Stop(_, pose) => *pose,
+        }
+    }
+
+    /// Seconds until the camera comes to rest.
+    fn motion_secs(&self) -> f64 {
+        match self {
+            Self::Flight(keyframes) => keyframes.last().map_or(0.0, |key| key.t),
+            Self::Stop(..) => 0.0,
+        }
+    }
+}
+
+/// Percentiles of a set of durations, in milliseconds.
+#[derive(Serialize, Default)]
+struct Percentiles {
+    samples: usize,
+    p50_ms: f64,
+    p95_ms: f64,
+    p99_ms: f64,
+    max_ms: f64,
+}
+
+impl Percentiles {
+    fn of(mut samples: Vec<Duration>) -> Self {
+        if samples.is_empty() {
+            return Self::default();
+        }
+        samples.sort_unstable();
+        let ms = |q: f64| {
+            let rank = ((q * samples.len() as f64).ceil() as usize).clamp(1, samples.len());
+            samples[rank - 1].as_secs_f64() * 1000.0
+        };
+        Self {
+            samples: samples.len(),
+            p50_ms: ms(0.5),
+            p95_ms: ms(0.95),
+            p99_ms: ms(0.99),
+            max_ms: ms(1.0),
+        }
+    }
+}
+
+#[derive(Serialize)]
+struct SegmentReport {
+    name: String,
+    /// Wall-clock seconds from the segment's start to the first frame of
+    /// the settled run; `None` if it timed out.
+    time_to_full_detail_secs: Option<f64>,
+    frames_to_full_detail: Option<usize>,
+    frames: usize,
+    peak_resident_tiles: usize,
+    /// Tile meshes plus allocated tile-texture pages.
+    peak_resident_bytes: u64,
+    /// Tiles whose fetch failed (missing from the snapshot) when the
+    /// segment ended.
+    failed_tiles: usize,
+    /// Octree walk time on the frames that walked.
+    walk: Percentiles,
+    frame_time: Percentiles,
+}
+
+#[derive(Serialize)]
+struct StageReport {
+    stage: &'static str,
+    count: u64,
+    mean_ms: f64,
+    p50_ms: f64,
+    p95_ms: f64,
+    p99_ms: f64,
+}
+
+#[derive(Serialize)]
+struct Report {
+    fps: f64,
+    paced: bool,
+    segments: Vec<SegmentReport>,
+    stages: Vec<StageReport>,
+}
+
+fn main() -> Result<(), Box<dyn Error>> {
+    let args = Args::parse();
+    let camera_path = match &args.path {
+        Some(path) => CameraPath::load(path)?,
+        None => CameraPath::presets(),
+    };
+    let segments: Vec<Segment> = match camera_path {
+        CameraPath::Keyframes(keyframes) => vec![Segment::Flight(keyframes)],
+        CameraPath::Teleports(stops) => stops
+            .into_iter()
+            .map(|stop| Segment::Stop(stop.name, stop.pose))
+            .collect(),
+    };
+
+    let cache = PackCache::open_read_only(&args.cache)?;
+    println!("Tile cache: {} entries", cache.len());
+    let client = Client::with_cache(cache)
+        .with_base_url(OFFLINE_BASE_URL.to_string())
+        .with_retry_policy(RetryPolicy::none());
+
+    let mut app = build_app(&args, client);
+    let (position, direction, up) = segments[0].pose(0.0).placement();
+    app.world_mut()
+        .spawn(world_camera_bundle(position, direction, up, FOV_DEG));
+    if args.trace {
+        app.world_mut().resource_mut::<TraceCapture>().start();
+    }
+
+    let dt = 1.0 / args.fps;
+    let reports: Vec<SegmentReport> = segments
+        .iter()
+        .map(|segment| run_segment(&mut app, segment, &args, dt))
+        .collect();
+
+    let stages = app
+        .world()
+        .resource::<StageProfile>()
+        .summaries()
+        .into_iter()
+        .map(|summary| {
+            let ms = |d: Duration| d.as_secs_f64() * 1000.0;
+            StageReport {
+                stage: summary.stage.name(),
+                count: summary.count,
+                mean_ms: ms(summary.mean),
+                p50_ms: ms(summary.p50),
+                p95_ms: ms(summary.p95),
+                p99_ms: ms(summary.p99),
+            }
+        })
+        .collect();
+    let report = Report {
+        fps: args.fps,
+        paced: !args.unpaced,
+        segments: reports,
+        stages,
+    };
+    print_report(&report);
+
+    if args.trace {
+        let mut capture = app.world_mut().resource_mut::<TraceCapture>();
+        capture.stop();
+        println!("Trace: {}", capture.save()?.display());
+    }
+    if let Some(path) = &args.json {
+        std::fs::write(path, serde_json::to_string_pretty(&report)?)?;
+        println!("Report: {}", path.display());
+    }
+    Ok(())
+}
+
+/// The windowless app: the client's terrain and physics stack over `client`,
+/// on a fixed simulated timestep. A primary window entity is kept, without
+/// a backend to open it, so the LoD metric and camera see the viewport size.
+fn build_app(args: &Args, client: Client<PackCache>) -> App {
+    let mut app = App::new();
+    app.add_plugins(
+        DefaultPlugins
+            .set(WindowPlugin {
+                primary_window: Some(Window {
+                    resolution: (args.width, args.height).into(),
+                    ..default()
+                }),
+                exit_condition: ExitCondition::DontExit,
+                close_when_requested: false,
+                ..default()
+            })
+            .set(AssetPlugin {
+                meta_check: AssetMetaCheck::Never,
+                ..default()
+            })
+            .set(LogPlugin {
+                // Times the tile stage spans into `StageProfile`.
+                custom_layer: profiler::install_layer,
+                ..default()
+            }),
+    )
+    .add_plugins(veldera_async::AsyncRuntimePlugin)
+    .add_plugins(profiler::ProfilerPlugin)
+    .add_plugins(FloatingOriginPlugin)
+    // Inserted before `DataLoaderPlugin` initialises its default.
+    .insert_resource(LoaderState {
+        client: client.into(),
+        planetoid: None,
+        root_bulk: None,
+        block_compressed_textures: false,
+    })
+    .add_plugins(TerrainPlugins)
+    // The LoD walk reads the physics streaming config and motion tracker.
+    .add_plugins(PhysicsIntegrationPlugin::default())
+    .insert_resource(TimeUpdateStrategy::ManualDuration(Duration::from_secs_f64(
+        1.0 / args.fps,
+    )));
+
+    // What `App::run` would do before its first update.
+    while app.plugins_state() == PluginsState::Adding {
+        bevy::tasks::tick_global_task_pools_on_main_thread();
+    }
+    app.finish();
+    app.cleanup();
+    app
+}
+
+/// Replay one segment until streaming settles or it times out.
+fn run_segment(app: &mut App, segment: &Segment, args: &Args, dt: f64) -> SegmentReport {
+    let started = Instant::now();
+    let mut report = SegmentReport {
+        name: segment.name().to_string(),
+        time_to_full_detail_secs: None,
+        frames_to_full_detail: None,
+        frames: 0,
+        peak_resident_tiles: 0,
+        peak_resident_bytes: 0,
+        failed_tiles: 0,
+        walk: Percentiles::default(),
+        frame_time: Percentiles::default(),
+    };
+    let mut frame_times = Vec::new();
+    let mut walk_times = Vec::new();
+    let mut settled_since: Option<(usize, f64)> = None;
+    let deadline = segment.motion_secs() + args.timeout;
+
+    loop {
+        let t = report.frames as f64 * dt;
+        place_camera(app.world_mut(), &segment.pose(t));
+        app.world_mut().resource_mut::<LodSnapshotRequest>().wanted = true;
+
+        let frame_started = Instant::now();
+        app.update();
+        let frame_time = frame_started.elapsed();
+        frame_times.push(frame_time);
+        report.frames += 1;
+
+        let world = app.world();
+        let counters = &world.resource::<LodSnapshot>().counters;
+        if counters.walk_time > Duration::ZERO {
+            walk_times.push(counters.walk_time);
+        }
+        report.peak_resident_tiles = report.peak_resident_tiles.max(counters.render_loaded);
+        let bytes = counters.texture_bytes + mesh_bytes(world.resource::<Assets<Mesh>>());
+        report.peak_resident_bytes = report.peak_resident_bytes.max(bytes);
+        report.failed_tiles = counters.nodes_failed;
+
+        let at_rest = t >= segment.motion_secs();
+        let loaded = world.resource::<LoaderState>().root_bulk.is_some();
+        if at_rest && loaded && is_settled(counters) {
+            let (since_frame, since_secs) =
+                *settled_since.get_or_insert((report.frames, started.elapsed().as_secs_f64()));
+            if report.frames - since_frame + 1 >= SETTLE_FRAMES {
+                report.frames_to_full_detail = Some(since_frame);
+                report.time_to_full_detail_secs = Some(since_secs);
+                break;
+            }
+        } else {
+            settled_since = None;
+        }
+        if t >= deadline {
+            break;
+        }
+
+        if !args.unpaced {
+            let budget = Duration::from_secs_f64(dt);
+            if let Some(rest) = budget.checked_sub(frame_started.elapsed()) {
+                std::thread::sleep(rest);
+            }
+        }
+    }
+
+    report.walk = Percentiles::of(walk_times);
+    report.frame_time = Percentiles::of(frame_times);
+    report
+}
+
+/// Whether every tile the walk wants is resident: nothing pending, in
+/// flight, waiting to spawn, or waiting on bulk metadata. Tiles the snapshot
+/// lacks count as settled: their fetches fail and back off, and a retry
+/// after the backoff doesn't unsettle the segment.
+fn is_settled(counters: &SnapshotCounters) -> bool {
+    counters.render_loaded > 0
+        && counters.fetch.pending + counters.fetch.in_flight == counters.nodes_retrying
+        && counters.spawn_queued == 0
+        && counters.bulks_loading == 0
+}
+
+fn place_camera(world: &mut World, pose: &Pose) {
+    let (position, direction, up) = pose.placement();
+    let mut cameras = world.query::<(&mut FloatingOriginCamera, &mut Transform)>();
+    for (mut camera, mut transform) in cameras.iter_mut(world) {
+        camera.position = position;
+        transform.look_to(direction, up);
+    }
+}
+
+/// Bytes of vertex and index data across every mesh asset.
+fn mesh_bytes(meshes: &Assets<Mesh>) -> u64 {
+    meshes
+        .iter()
+        .map(|(_, mesh)| {
+            let vertices = mesh.count_vertices() as u64 * mesh.get_vertex_size();
+            let indices = match mesh.indices() {
+                Some(Indices::U16(indices)) => indices.len() as u64 * 2,
+                Some(Indices::U32(indices)) => indices.len() as u64 * 4,
+                None => 0,
+            };
+            vertices + indices
+        })
+        .sum()
+}
+
+fn print_report(report: &Report) {
+    let pacing = if report.paced { "paced" } else { "unpaced" };
+    println!("\n{} fps, {pacing}", report.fps);
+    for segment in &report.segments {
+        println!("\n[{}] {} frames", segment.name, segment.frames);
+        match (
+            segment.time_to_full_detail_secs,
+            segment.frames_to_full_detail,
+        ) {
+            (Some(secs), Some(frames)) => {
+                println!("  full detail after {secs:.2} s ({frames} frames)");
+            }
+            _ => println!("  did not settle before the timeout"),
+        }
+        println!(
+            "  peak resident: {} tiles, {:.1} MiB",
+            segment.peak_resident_tiles,
+            segment.peak_resident_bytes as f64 / (1024.0 * 1024.0)
+        );
+        if segment.failed_tiles > 0 {
+            println!(
+                "  {} tile(s) missing from the snapshot",
+                segment.failed_tiles
+            );
+        }
+        print_percentiles("walk", &segment.walk);
+        print_percentiles("frame", &segment.frame_time);
+    }
+
+    println!("\nStage           count   mean ms    p50 ms    p95 ms    p99 ms");
+    for stage in &report.stages {
+        println!(
+            "{:<14} {:>6} {:>9.2} {:>9.2} {:>9.2} {:>9.2}",
+            stage.stage, stage.count, stage.mean_ms, stage.p50_ms, stage.p95_ms, stage.p99_ms
+        );
+    }
+}
+
+fn print_percentiles(label: &str, percentiles: &Percentiles) {
+    println!(
+        "  {label:<5} ms: p50 {:.2}  p95 {:.2}  p99 {:.2}  max {:.2}  ({} samples)",
+        percentiles.p50_ms,
+        percentiles.p95_ms,
+        percentiles.p99_ms,
+        percentiles.max_ms,
+        percentiles.samples
+    );
+}
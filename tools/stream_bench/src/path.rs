@@ -0,0 +1,239 @@
+//! Camera paths the benchmark replays.
+//!
+//! A path is either a flight, keyframes the camera moves through on the
+//! simulated clock, or a list of teleport stops, each held until streaming
+//! settles. Both are read from JSON:
+//!
+//! ```json
+//! {"keyframes": [{"t": 0, "lat": 40.71, "lon": -74.01, "altitude": 3000, "heading": 0, "pitch": -25}, ...]}
+//! {"teleports": [{"name": "nyc", "lat": 40.71, "lon": -74.01, "altitude": 3000, "heading": 0, "pitch": -25}, ...]}
+//! ```
+//!
+//! Without a file the benchmark teleports between [`PRESETS`].
+
+use std::{error::Error, fmt, path::Path};
+
+use bevy::math::{DVec3, Vec3};
+use serde::Deserialize;
+use veldera_constants::EARTH_RADIUS_M_F64;
+use veldera_geo::coords::{enu_look_direction, lat_lon_to_ecef};
+
+/// A camera placement: position above the spherical Earth the client spawns
+/// on, and a compass heading and pitch in degrees.
+#[derive(Clone, Copy, Debug, Deserialize)]
+pub struct Pose {
+    pub lat: f64,
+    pub lon: f64,
+    /// Metres above sea level.
+    pub altitude: f64,
+    #[serde(default)]
+    pub heading: f64,
+    #[serde(default)]
+    pub pitch: f64,
+}
+
+impl Pose {
+    /// ECEF position, view direction and local up, as the camera takes them.
+    pub fn placement(&self) -> (DVec3, Vec3, Vec3) {
+        let position = lat_lon_to_ecef(self.lat, self.lon, EARTH_RADIUS_M_F64 + self.altitude);
+        let (direction, up) = enu_look_direction(position, self.heading as f32, self.pitch as f32);
+        (position, direction, up)
+    }
+
+    /// The pose a fraction `t` of the way from `self` to `other`, blending
+    /// heading the short way round.
+    fn lerp(&self, other: &Self, t: f64) -> Self {
+        let mix = |a: f64, b: f64| a + (b - a) * t;
+        let turn = (other.heading - self.heading + 540.0).rem_euclid(360.0) - 180.0;
+        Self {
+            lat: mix(self.lat, other.lat),
+            lon: mix(self.lon, other.lon),
+            altitude: mix(self.altitude, other.altitude),
+            heading: self.heading + turn * t,
+            pitch: mix(self.pitch, other.pitch),
+        }
+    }
+}
+
+/// A flight keyframe: where the camera is `t` simulated seconds in.
+#[derive(Clone, Copy, Debug, Deserialize)]
+pub struct Keyframe {
+    pub t: f64,
+    #[serde(flatten)]
+    pub pose: Pose,
+}
+
+/// A teleport destination.
+#[derive(Clone, Debug, Deserialize)]
+pub struct Stop {
+    pub name: String,
+    #[serde(flatten)]
+    pub pose: Pose,
+}
+
+/// What the benchmark replays.
+#[derive(Clone, Debug, Deserialize)]
+#[serde(rename_all = "snake_case")]
+pub enum CameraPath {
+    /// Fly through the keyframes, sorted by time, then hold the last.
+    Keyframes(Vec<Keyframe>),
+    /// Jump to each stop in turn, waiting for streaming to settle.
+    Teleports(Vec<Stop>),
+}
+
+/// Teleport stops used without a path file: dense cities, a coastline and
+/// open terrain, far enough apart that nothing carries over between them.
+pub const PRESETS: &[(&str, Pose)] = &[
+    (
+        "new_york",
+        Pose {
+            lat: 40.7128,
+            lon: -74.006,
+            altitude: 3000.0,
+            heading: 0.0,
+            pitch: -25.0,
+        },
+    ),
+    (
+        "san_francisco",
+        Pose {
+            lat: 37.8199,
+            lon: -122.4783,
+            altitude: 800.0,
+            heading: 120.0,
+            pitch: -15.0,
+        },
+    ),
+    (
+        "grand_canyon",
+        Pose {
+            lat: 36.0544,
+            lon: -112.1401,
+            altitude: 3500.0,
+            heading: 0.0,
+            pitch: -20.0,
+        },
+    ),
+    (
+        "tokyo",
+        Pose {
+            lat: 35.6586,
+            lon: 139.7454,
+            altitude: 1500.0,
+            heading: 300.0,
+            pitch: -30.0,
+        },
+    ),
+];
+
+/// Why a path file couldn't be used.
+#[derive(Debug)]
+pub enum PathError {
+    Read(std::io::Error),
+    Parse(serde_json::Error),
+    Empty,
+}
+
+impl fmt::Display for PathError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::Read(e) => write!(f, "failed to read camera path: {e}"),
+            Self::Parse(e) => write!(f, "failed to parse camera path: {e}"),
+            Self::Empty => write!(f, "camera path has no keyframes or stops"),
+        }
+    }
+}
+
+impl Error for PathError {}
+
+impl CameraPath {
+    /// The built-in teleport tour over [`PRESETS`].
+    pub fn presets() -> Self {
+        Self::Teleports(
+            PRESETS
+                .iter()
+                .map(|&(name, pose)| Stop {
+                    name: name.to_string(),
+                    pose,
+                })
+                .collect(),
+        )
+    }
+
+    /// Load a path from a JSON file.
+    pub fn load(path: &Path) -> Result<Self, PathError> {
+        let text = std::fs::read_to_string(path).map_err(PathError::Read)?;
+        let mut camera_path: Self = serde_json::from_str(&text).map_err(PathError::Parse)?;
+        match &mut camera_path {
+            Self::Keyframes(keyframes) => {
+                keyframes.sort_by(|a, b| a.t.total_cmp(&b.t));
+                if keyframes.is_empty() {
+                    return Err(PathError::Empty);
+                }
+            }
+            Self::Teleports(stops) => {
+                if stops.is_empty() {
+                    return Err(PathError::Empty);
+                }
+            }
+        }
+        Ok(camera_path)
+    }
+}
+
+/// The pose `t` seconds into a flight, holding the ends outside it.
+/// `keyframes` is sorted by time and non-empty.
+pub fn sample(keyframes: &[Keyframe], t: f64) -> Pose {
+    let next = keyframes.partition_point(|key| key.t <= t);
+    match (next.checked_sub(1), keyframes.get(next)) {
+        (Some(prev), Some(next)) => {
+            let (a, b) = (&keyframes[prev], next);
+            let span = b.t - a.t;
+            let frac = if span > 0.0 { (t - a.t) / span } else { 1.0 };
+            a.pose.lerp(&b.pose, frac)
+        }
+        (Some(prev), None) => keyframes[prev].pose,
+        (None, _) => keyframes[0].pose,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn key(t: f64, lat: f64, heading: f64) -> Keyframe {
+        Keyframe {
+            t,
+            pose: Pose {
+                lat,
+                lon: 0.0,
+                altitude: 100.0,
+                heading,
+                pitch: 0.0,
+            },
+        }
+    }
+
+    #[test]
+    fn flights_interpolate_between_and_hold_outside_keyframes() {
+        let keyframes = [key(1.0, 10.0, 350.0), key(3.0, 20.0, 10.0)];
+        assert_eq!(sample(&keyframes, 0.0).lat, 10.0);
+        assert_eq!(sample(&keyframes, 2.0).lat, 15.0);
+        assert_eq!(sample(&keyframes, 9.0).lat, 20.0);
+        // Heading turns through north, not back round through south.
+        assert!((sample(&keyframes, 2.0).heading.rem_euclid(360.0) - 0.0).abs() < 1e-9);
+    }
+
+    #[test]
+    fn paths_parse_both_shapes() {
+        let flight: CameraPath =
+            serde_json::from_str(r#"{"keyframes": [{"t": 0, "lat": 1, "lon": 2, "altitude": 3}]}"#)
+                .unwrap();
+        assert!(matches!(flight, CameraPath::Keyframes(k) if k.len() == 1));
+        let tour: CameraPath = serde_json::from_str(
+            r#"{"teleports": [{"name": "a", "lat": 1, "lon": 2, "altitude": 3, "pitch": -10}]}"#,
+        )
+        .unwrap();
+        assert!(matches!(tour, CameraPath::Teleports(s) if s[0].pose.pitch == -10.0));
+    }
+}